@@ -54,6 +54,7 @@ if test "$PHP_GRPC" != "no"; then
     src/core/lib/support/env_linux.c \
     src/core/lib/support/env_posix.c \
     src/core/lib/support/env_windows.c \
+    src/core/lib/support/epoch.c \
     src/core/lib/support/histogram.c \
     src/core/lib/support/host_port.c \
     src/core/lib/support/log.c \
@@ -116,6 +117,7 @@ if test "$PHP_GRPC" != "no"; then
     src/core/lib/iomgr/ev_epollsig_linux.c \
     src/core/lib/iomgr/ev_poll_posix.c \
     src/core/lib/iomgr/ev_posix.c \
+    src/core/lib/iomgr/ev_uring_linux.c \
     src/core/lib/iomgr/ev_windows.c \
     src/core/lib/iomgr/exec_ctx.c \
     src/core/lib/iomgr/executor.c \
@@ -159,6 +161,7 @@ if test "$PHP_GRPC" != "no"; then
     src/core/lib/iomgr/tcp_server_utils_posix_noifaddrs.c \
     src/core/lib/iomgr/tcp_server_uv.c \
     src/core/lib/iomgr/tcp_server_windows.c \
+    src/core/lib/iomgr/tcp_uring_linux.c \
     src/core/lib/iomgr/tcp_uv.c \
     src/core/lib/iomgr/tcp_windows.c \
     src/core/lib/iomgr/time_averaged_stats.c \
@@ -166,6 +169,7 @@ if test "$PHP_GRPC" != "no"; then
     src/core/lib/iomgr/timer_heap.c \
     src/core/lib/iomgr/timer_manager.c \
     src/core/lib/iomgr/timer_uv.c \
+    src/core/lib/iomgr/timer_wheel.c \
     src/core/lib/iomgr/udp_server.c \
     src/core/lib/iomgr/unix_sockets_posix.c \
     src/core/lib/iomgr/unix_sockets_posix_noop.c \
@@ -184,9 +188,12 @@ if test "$PHP_GRPC" != "no"; then
     src/core/lib/slice/slice_buffer.c \
     src/core/lib/slice/slice_hash_table.c \
     src/core/lib/slice/slice_intern.c \
+    src/core/lib/slice/slice_mmap.c \
+    src/core/lib/slice/slice_pool.c \
     src/core/lib/slice/slice_string_helpers.c \
     src/core/lib/surface/alarm.c \
     src/core/lib/surface/api_trace.c \
+    src/core/lib/surface/arena_pool.c \
     src/core/lib/surface/byte_buffer.c \
     src/core/lib/surface/byte_buffer_reader.c \
     src/core/lib/surface/call.c \
@@ -201,6 +208,7 @@ if test "$PHP_GRPC" != "no"; then
     src/core/lib/surface/event_string.c \
     src/core/lib/surface/lame_client.cc \
     src/core/lib/surface/metadata_array.c \
+    src/core/lib/surface/method_table.c \
     src/core/lib/surface/server.c \
     src/core/lib/surface/validate_metadata.c \
     src/core/lib/surface/version.c \
@@ -208,6 +216,7 @@ if test "$PHP_GRPC" != "no"; then
     src/core/lib/transport/byte_stream.c \
     src/core/lib/transport/connectivity_state.c \
     src/core/lib/transport/error_utils.c \
+    src/core/lib/transport/load_report_encoding.c \
     src/core/lib/transport/metadata.c \
     src/core/lib/transport/metadata_batch.c \
     src/core/lib/transport/pid_controller.c \
@@ -317,7 +326,13 @@ if test "$PHP_GRPC" != "no"; then
     third_party/nanopb/pb_encode.c \
     src/core/ext/filters/client_channel/resolver/fake/fake_resolver.c \
     src/core/ext/filters/client_channel/lb_policy/pick_first/pick_first.c \
+    src/core/ext/filters/client_channel/lb_policy/subchannel_list.c \
     src/core/ext/filters/client_channel/lb_policy/round_robin/round_robin.c \
+    src/core/ext/filters/client_channel/lb_policy/weighted_round_robin/backend_weight.c \
+    src/core/ext/filters/client_channel/lb_policy/weighted_round_robin/load_report_filter.c \
+    src/core/ext/filters/client_channel/lb_policy/weighted_round_robin/weighted_round_robin.c \
+    src/core/ext/filters/client_channel/lb_policy/ring_hash/ring_hash.c \
+    src/core/ext/filters/client_channel/lb_policy/least_request/least_request.c \
     src/core/ext/filters/client_channel/resolver/dns/c_ares/dns_resolver_ares.c \
     src/core/ext/filters/client_channel/resolver/dns/c_ares/grpc_ares_ev_driver_posix.c \
     src/core/ext/filters/client_channel/resolver/dns/c_ares/grpc_ares_wrapper.c \
@@ -662,8 +677,11 @@ if test "$PHP_GRPC" != "no"; then
   PHP_ADD_BUILD_DIR($ext_builddir/src/core/ext/filters/client_channel)
   PHP_ADD_BUILD_DIR($ext_builddir/src/core/ext/filters/client_channel/lb_policy/grpclb)
   PHP_ADD_BUILD_DIR($ext_builddir/src/core/ext/filters/client_channel/lb_policy/grpclb/proto/grpc/lb/v1)
+  PHP_ADD_BUILD_DIR($ext_builddir/src/core/ext/filters/client_channel/lb_policy/least_request)
   PHP_ADD_BUILD_DIR($ext_builddir/src/core/ext/filters/client_channel/lb_policy/pick_first)
+  PHP_ADD_BUILD_DIR($ext_builddir/src/core/ext/filters/client_channel/lb_policy/ring_hash)
   PHP_ADD_BUILD_DIR($ext_builddir/src/core/ext/filters/client_channel/lb_policy/round_robin)
+  PHP_ADD_BUILD_DIR($ext_builddir/src/core/ext/filters/client_channel/lb_policy/weighted_round_robin)
   PHP_ADD_BUILD_DIR($ext_builddir/src/core/ext/filters/client_channel/resolver/dns/c_ares)
   PHP_ADD_BUILD_DIR($ext_builddir/src/core/ext/filters/client_channel/resolver/dns/native)
   PHP_ADD_BUILD_DIR($ext_builddir/src/core/ext/filters/client_channel/resolver/fake)
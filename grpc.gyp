@@ -172,6 +172,7 @@
         'src/core/lib/support/env_linux.c',
         'src/core/lib/support/env_posix.c',
         'src/core/lib/support/env_windows.c',
+        'src/core/lib/support/epoch.c',
         'src/core/lib/support/histogram.c',
         'src/core/lib/support/host_port.c',
         'src/core/lib/support/log.c',
@@ -253,6 +254,7 @@
         'src/core/lib/iomgr/ev_epollsig_linux.c',
         'src/core/lib/iomgr/ev_poll_posix.c',
         'src/core/lib/iomgr/ev_posix.c',
+        'src/core/lib/iomgr/ev_uring_linux.c',
         'src/core/lib/iomgr/ev_windows.c',
         'src/core/lib/iomgr/exec_ctx.c',
         'src/core/lib/iomgr/executor.c',
@@ -296,6 +298,7 @@
         'src/core/lib/iomgr/tcp_server_utils_posix_noifaddrs.c',
         'src/core/lib/iomgr/tcp_server_uv.c',
         'src/core/lib/iomgr/tcp_server_windows.c',
+        'src/core/lib/iomgr/tcp_uring_linux.c',
         'src/core/lib/iomgr/tcp_uv.c',
         'src/core/lib/iomgr/tcp_windows.c',
         'src/core/lib/iomgr/time_averaged_stats.c',
@@ -303,6 +306,7 @@
         'src/core/lib/iomgr/timer_heap.c',
         'src/core/lib/iomgr/timer_manager.c',
         'src/core/lib/iomgr/timer_uv.c',
+        'src/core/lib/iomgr/timer_wheel.c',
         'src/core/lib/iomgr/udp_server.c',
         'src/core/lib/iomgr/unix_sockets_posix.c',
         'src/core/lib/iomgr/unix_sockets_posix_noop.c',
@@ -321,9 +325,12 @@
         'src/core/lib/slice/slice_buffer.c',
         'src/core/lib/slice/slice_hash_table.c',
         'src/core/lib/slice/slice_intern.c',
+        'src/core/lib/slice/slice_mmap.c',
+        'src/core/lib/slice/slice_pool.c',
         'src/core/lib/slice/slice_string_helpers.c',
         'src/core/lib/surface/alarm.c',
         'src/core/lib/surface/api_trace.c',
+        'src/core/lib/surface/arena_pool.c',
         'src/core/lib/surface/byte_buffer.c',
         'src/core/lib/surface/byte_buffer_reader.c',
         'src/core/lib/surface/call.c',
@@ -338,6 +345,7 @@
         'src/core/lib/surface/event_string.c',
         'src/core/lib/surface/lame_client.cc',
         'src/core/lib/surface/metadata_array.c',
+        'src/core/lib/surface/method_table.c',
         'src/core/lib/surface/server.c',
         'src/core/lib/surface/validate_metadata.c',
         'src/core/lib/surface/version.c',
@@ -345,6 +353,7 @@
         'src/core/lib/transport/byte_stream.c',
         'src/core/lib/transport/connectivity_state.c',
         'src/core/lib/transport/error_utils.c',
+        'src/core/lib/transport/load_report_encoding.c',
         'src/core/lib/transport/metadata.c',
         'src/core/lib/transport/metadata_batch.c',
         'src/core/lib/transport/pid_controller.c',
@@ -454,7 +463,13 @@
         'third_party/nanopb/pb_encode.c',
         'src/core/ext/filters/client_channel/resolver/fake/fake_resolver.c',
         'src/core/ext/filters/client_channel/lb_policy/pick_first/pick_first.c',
+        'src/core/ext/filters/client_channel/lb_policy/subchannel_list.c',
         'src/core/ext/filters/client_channel/lb_policy/round_robin/round_robin.c',
+        'src/core/ext/filters/client_channel/lb_policy/weighted_round_robin/backend_weight.c',
+        'src/core/ext/filters/client_channel/lb_policy/weighted_round_robin/load_report_filter.c',
+        'src/core/ext/filters/client_channel/lb_policy/weighted_round_robin/weighted_round_robin.c',
+        'src/core/ext/filters/client_channel/lb_policy/ring_hash/ring_hash.c',
+        'src/core/ext/filters/client_channel/lb_policy/least_request/least_request.c',
         'src/core/ext/filters/client_channel/resolver/dns/c_ares/dns_resolver_ares.c',
         'src/core/ext/filters/client_channel/resolver/dns/c_ares/grpc_ares_ev_driver_posix.c',
         'src/core/ext/filters/client_channel/resolver/dns/c_ares/grpc_ares_wrapper.c',
@@ -554,6 +569,7 @@
         'src/core/lib/iomgr/ev_epollsig_linux.c',
         'src/core/lib/iomgr/ev_poll_posix.c',
         'src/core/lib/iomgr/ev_posix.c',
+        'src/core/lib/iomgr/ev_uring_linux.c',
         'src/core/lib/iomgr/ev_windows.c',
         'src/core/lib/iomgr/exec_ctx.c',
         'src/core/lib/iomgr/executor.c',
@@ -597,6 +613,7 @@
         'src/core/lib/iomgr/tcp_server_utils_posix_noifaddrs.c',
         'src/core/lib/iomgr/tcp_server_uv.c',
         'src/core/lib/iomgr/tcp_server_windows.c',
+        'src/core/lib/iomgr/tcp_uring_linux.c',
         'src/core/lib/iomgr/tcp_uv.c',
         'src/core/lib/iomgr/tcp_windows.c',
         'src/core/lib/iomgr/time_averaged_stats.c',
@@ -604,6 +621,7 @@
         'src/core/lib/iomgr/timer_heap.c',
         'src/core/lib/iomgr/timer_manager.c',
         'src/core/lib/iomgr/timer_uv.c',
+        'src/core/lib/iomgr/timer_wheel.c',
         'src/core/lib/iomgr/udp_server.c',
         'src/core/lib/iomgr/unix_sockets_posix.c',
         'src/core/lib/iomgr/unix_sockets_posix_noop.c',
@@ -622,9 +640,12 @@
         'src/core/lib/slice/slice_buffer.c',
         'src/core/lib/slice/slice_hash_table.c',
         'src/core/lib/slice/slice_intern.c',
+        'src/core/lib/slice/slice_mmap.c',
+        'src/core/lib/slice/slice_pool.c',
         'src/core/lib/slice/slice_string_helpers.c',
         'src/core/lib/surface/alarm.c',
         'src/core/lib/surface/api_trace.c',
+        'src/core/lib/surface/arena_pool.c',
         'src/core/lib/surface/byte_buffer.c',
         'src/core/lib/surface/byte_buffer_reader.c',
         'src/core/lib/surface/call.c',
@@ -639,6 +660,7 @@
         'src/core/lib/surface/event_string.c',
         'src/core/lib/surface/lame_client.cc',
         'src/core/lib/surface/metadata_array.c',
+        'src/core/lib/surface/method_table.c',
         'src/core/lib/surface/server.c',
         'src/core/lib/surface/validate_metadata.c',
         'src/core/lib/surface/version.c',
@@ -646,6 +668,7 @@
         'src/core/lib/transport/byte_stream.c',
         'src/core/lib/transport/connectivity_state.c',
         'src/core/lib/transport/error_utils.c',
+        'src/core/lib/transport/load_report_encoding.c',
         'src/core/lib/transport/metadata.c',
         'src/core/lib/transport/metadata_batch.c',
         'src/core/lib/transport/pid_controller.c',
@@ -760,6 +783,7 @@
         'src/core/lib/iomgr/ev_epollsig_linux.c',
         'src/core/lib/iomgr/ev_poll_posix.c',
         'src/core/lib/iomgr/ev_posix.c',
+        'src/core/lib/iomgr/ev_uring_linux.c',
         'src/core/lib/iomgr/ev_windows.c',
         'src/core/lib/iomgr/exec_ctx.c',
         'src/core/lib/iomgr/executor.c',
@@ -803,6 +827,7 @@
         'src/core/lib/iomgr/tcp_server_utils_posix_noifaddrs.c',
         'src/core/lib/iomgr/tcp_server_uv.c',
         'src/core/lib/iomgr/tcp_server_windows.c',
+        'src/core/lib/iomgr/tcp_uring_linux.c',
         'src/core/lib/iomgr/tcp_uv.c',
         'src/core/lib/iomgr/tcp_windows.c',
         'src/core/lib/iomgr/time_averaged_stats.c',
@@ -810,6 +835,7 @@
         'src/core/lib/iomgr/timer_heap.c',
         'src/core/lib/iomgr/timer_manager.c',
         'src/core/lib/iomgr/timer_uv.c',
+        'src/core/lib/iomgr/timer_wheel.c',
         'src/core/lib/iomgr/udp_server.c',
         'src/core/lib/iomgr/unix_sockets_posix.c',
         'src/core/lib/iomgr/unix_sockets_posix_noop.c',
@@ -828,9 +854,12 @@
         'src/core/lib/slice/slice_buffer.c',
         'src/core/lib/slice/slice_hash_table.c',
         'src/core/lib/slice/slice_intern.c',
+        'src/core/lib/slice/slice_mmap.c',
+        'src/core/lib/slice/slice_pool.c',
         'src/core/lib/slice/slice_string_helpers.c',
         'src/core/lib/surface/alarm.c',
         'src/core/lib/surface/api_trace.c',
+        'src/core/lib/surface/arena_pool.c',
         'src/core/lib/surface/byte_buffer.c',
         'src/core/lib/surface/byte_buffer_reader.c',
         'src/core/lib/surface/call.c',
@@ -845,6 +874,7 @@
         'src/core/lib/surface/event_string.c',
         'src/core/lib/surface/lame_client.cc',
         'src/core/lib/surface/metadata_array.c',
+        'src/core/lib/surface/method_table.c',
         'src/core/lib/surface/server.c',
         'src/core/lib/surface/validate_metadata.c',
         'src/core/lib/surface/version.c',
@@ -852,6 +882,7 @@
         'src/core/lib/transport/byte_stream.c',
         'src/core/lib/transport/connectivity_state.c',
         'src/core/lib/transport/error_utils.c',
+        'src/core/lib/transport/load_report_encoding.c',
         'src/core/lib/transport/metadata.c',
         'src/core/lib/transport/metadata_batch.c',
         'src/core/lib/transport/pid_controller.c',
@@ -951,6 +982,7 @@
         'src/core/lib/iomgr/ev_epollsig_linux.c',
         'src/core/lib/iomgr/ev_poll_posix.c',
         'src/core/lib/iomgr/ev_posix.c',
+        'src/core/lib/iomgr/ev_uring_linux.c',
         'src/core/lib/iomgr/ev_windows.c',
         'src/core/lib/iomgr/exec_ctx.c',
         'src/core/lib/iomgr/executor.c',
@@ -994,6 +1026,7 @@
         'src/core/lib/iomgr/tcp_server_utils_posix_noifaddrs.c',
         'src/core/lib/iomgr/tcp_server_uv.c',
         'src/core/lib/iomgr/tcp_server_windows.c',
+        'src/core/lib/iomgr/tcp_uring_linux.c',
         'src/core/lib/iomgr/tcp_uv.c',
         'src/core/lib/iomgr/tcp_windows.c',
         'src/core/lib/iomgr/time_averaged_stats.c',
@@ -1001,6 +1034,7 @@
         'src/core/lib/iomgr/timer_heap.c',
         'src/core/lib/iomgr/timer_manager.c',
         'src/core/lib/iomgr/timer_uv.c',
+        'src/core/lib/iomgr/timer_wheel.c',
         'src/core/lib/iomgr/udp_server.c',
         'src/core/lib/iomgr/unix_sockets_posix.c',
         'src/core/lib/iomgr/unix_sockets_posix_noop.c',
@@ -1019,9 +1053,12 @@
         'src/core/lib/slice/slice_buffer.c',
         'src/core/lib/slice/slice_hash_table.c',
         'src/core/lib/slice/slice_intern.c',
+        'src/core/lib/slice/slice_mmap.c',
+        'src/core/lib/slice/slice_pool.c',
         'src/core/lib/slice/slice_string_helpers.c',
         'src/core/lib/surface/alarm.c',
         'src/core/lib/surface/api_trace.c',
+        'src/core/lib/surface/arena_pool.c',
         'src/core/lib/surface/byte_buffer.c',
         'src/core/lib/surface/byte_buffer_reader.c',
         'src/core/lib/surface/call.c',
@@ -1036,6 +1073,7 @@
         'src/core/lib/surface/event_string.c',
         'src/core/lib/surface/lame_client.cc',
         'src/core/lib/surface/metadata_array.c',
+        'src/core/lib/surface/method_table.c',
         'src/core/lib/surface/server.c',
         'src/core/lib/surface/validate_metadata.c',
         'src/core/lib/surface/version.c',
@@ -1043,6 +1081,7 @@
         'src/core/lib/transport/byte_stream.c',
         'src/core/lib/transport/connectivity_state.c',
         'src/core/lib/transport/error_utils.c',
+        'src/core/lib/transport/load_report_encoding.c',
         'src/core/lib/transport/metadata.c',
         'src/core/lib/transport/metadata_batch.c',
         'src/core/lib/transport/pid_controller.c',
@@ -1128,7 +1167,13 @@
         'third_party/nanopb/pb_decode.c',
         'third_party/nanopb/pb_encode.c',
         'src/core/ext/filters/client_channel/lb_policy/pick_first/pick_first.c',
+        'src/core/ext/filters/client_channel/lb_policy/subchannel_list.c',
         'src/core/ext/filters/client_channel/lb_policy/round_robin/round_robin.c',
+        'src/core/ext/filters/client_channel/lb_policy/weighted_round_robin/backend_weight.c',
+        'src/core/ext/filters/client_channel/lb_policy/weighted_round_robin/load_report_filter.c',
+        'src/core/ext/filters/client_channel/lb_policy/weighted_round_robin/weighted_round_robin.c',
+        'src/core/ext/filters/client_channel/lb_policy/ring_hash/ring_hash.c',
+        'src/core/ext/filters/client_channel/lb_policy/least_request/least_request.c',
         'src/core/ext/census/base_resources.c',
         'src/core/ext/census/context.c',
         'src/core/ext/census/gen/census.pb.c',
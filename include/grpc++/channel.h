@@ -20,6 +20,7 @@
 #define GRPCXX_CHANNEL_H
 
 #include <memory>
+#include <mutex>
 
 #include <grpc++/impl/call.h>
 #include <grpc++/impl/codegen/channel_interface.h>
@@ -70,9 +71,14 @@ class Channel final : public ChannelInterface,
                                void* tag) override;
   bool WaitForStateChangeImpl(grpc_connectivity_state last_observed,
                               gpr_timespec deadline) override;
+  CompletionQueue* CallbackCQ() override;
 
   const grpc::string host_;
   grpc_channel* const c_channel_;  // owned
+
+  // Created on first use by a callback-based call
+  std::mutex callback_cq_mu_;
+  std::unique_ptr<CompletionQueue> callback_cq_;
 };
 
 }  // namespace grpc
@@ -76,6 +76,10 @@ class ClientAsyncReaderWriter;
 template <class R>
 class ClientAsyncResponseReader;
 class ServerContext;
+namespace internal {
+template <class InputMessage, class OutputMessage>
+class CallbackUnaryCallImpl;
+}  // namespace internal
 
 /// Options for \a ClientContext::FromServerContext specifying which traits from
 /// the \a ServerContext to propagate (copy) from it into a new \a
@@ -368,6 +372,8 @@ class ClientContext {
                                   ClientContext* context,
                                   const InputMessage& request,
                                   OutputMessage* result);
+  template <class InputMessage, class OutputMessage>
+  friend class ::grpc::internal::CallbackUnaryCallImpl;
 
   grpc_call* call() const { return call_; }
   void set_call(grpc_call* call, const std::shared_ptr<Channel>& channel);
@@ -19,6 +19,8 @@
 #ifndef GRPCXX_IMPL_CODEGEN_CLIENT_UNARY_CALL_H
 #define GRPCXX_IMPL_CODEGEN_CLIENT_UNARY_CALL_H
 
+#include <functional>
+
 #include <grpc++/impl/codegen/call.h>
 #include <grpc++/impl/codegen/channel_interface.h>
 #include <grpc++/impl/codegen/config.h>
@@ -39,7 +41,7 @@ Status BlockingUnaryCall(ChannelInterface* channel, const RpcMethod& method,
                          OutputMessage* result) {
   CompletionQueue cq(grpc_completion_queue_attributes{
       GRPC_CQ_CURRENT_VERSION, GRPC_CQ_PLUCK,
-      GRPC_CQ_DEFAULT_POLLING});  // Pluckable completion queue
+      GRPC_CQ_DEFAULT_POLLING, nullptr});  // Pluckable completion queue
   Call call(channel->CreateCall(method, context, &cq));
   CallOpSet<CallOpSendInitialMetadata, CallOpSendMessage,
             CallOpRecvInitialMetadata, CallOpRecvMessage<OutputMessage>,
@@ -67,6 +69,81 @@ Status BlockingUnaryCall(ChannelInterface* channel, const RpcMethod& method,
   return status;
 }
 
+namespace internal {
+
+template <class InputMessage, class OutputMessage>
+class CallbackUnaryCallImpl final : public experimental::CompletionCallback {
+ public:
+  static void Start(ChannelInterface* channel, const RpcMethod& method,
+                    ClientContext* context, const InputMessage& request,
+                    OutputMessage* result,
+                    std::function<void(Status)> on_completion) {
+    CompletionQueue* cq = channel->CallbackCQ();
+    GPR_CODEGEN_ASSERT(cq != nullptr);
+    Call call(channel->CreateCall(method, context, cq));
+    auto* self = new CallbackUnaryCallImpl(std::move(on_completion));
+    Status status = self->ops_.SendMessage(request);
+    if (!status.ok()) {
+      self->Finish(status);
+      return;
+    }
+    self->ops_.SendInitialMetadata(context->send_initial_metadata_,
+                                   context->initial_metadata_flags());
+    self->ops_.RecvInitialMetadata(context);
+    self->ops_.RecvMessage(result);
+    self->ops_.ClientSendClose();
+    self->ops_.ClientRecvStatus(context, &self->status_);
+    self->ops_.set_output_tag(
+        static_cast<experimental::CompletionCallback*>(self));
+    call.PerformOps(&self->ops_);
+  }
+
+  void Run(bool ok) override {
+    if (ok && !ops_.got_message && status_.ok()) {
+      status_ = Status(StatusCode::UNIMPLEMENTED,
+                       "No message returned for unary request");
+    }
+    GPR_CODEGEN_ASSERT(ok || !status_.ok());
+    Finish(status_);
+  }
+
+ private:
+  explicit CallbackUnaryCallImpl(std::function<void(Status)> on_completion)
+      : on_completion_(std::move(on_completion)) {}
+
+  void Finish(Status status) {
+    auto on_completion = std::move(on_completion_);
+    delete this;
+    on_completion(std::move(status));
+  }
+
+  CallOpSet<CallOpSendInitialMetadata, CallOpSendMessage,
+            CallOpRecvInitialMetadata, CallOpRecvMessage<OutputMessage>,
+            CallOpClientSendClose, CallOpClientRecvStatus>
+      ops_;
+  Status status_;
+  std::function<void(Status)> on_completion_;
+};
+
+}  // namespace internal
+
+namespace experimental {
+
+/// EXPERIMENTAL: Wrapper that starts a unary call on the callback completion
+/// queue of \a channel. \a on_completion is invoked with the status of the
+/// call once it is done, from the thread that completed it; it must not
+/// block. \a context, \a result and \a channel must outlive the call.
+template <class InputMessage, class OutputMessage>
+void CallbackUnaryCall(ChannelInterface* channel, const RpcMethod& method,
+                       ClientContext* context, const InputMessage& request,
+                       OutputMessage* result,
+                       std::function<void(Status)> on_completion) {
+  internal::CallbackUnaryCallImpl<InputMessage, OutputMessage>::Start(
+      channel, method, context, request, result, std::move(on_completion));
+}
+
+}  // namespace experimental
+
 }  // namespace grpc
 
 #endif  // GRPCXX_IMPL_CODEGEN_CLIENT_UNARY_CALL_H
@@ -76,6 +76,7 @@ class RpcMethod;
 class Server;
 class ServerBuilder;
 class ServerContext;
+class ServerInterface;
 
 extern CoreCodegenInterface* g_core_codegen_interface;
 
@@ -89,7 +90,8 @@ class CompletionQueue : private GrpcLibraryCodegen {
   /// instance.
   CompletionQueue()
       : CompletionQueue(grpc_completion_queue_attributes{
-            GRPC_CQ_CURRENT_VERSION, GRPC_CQ_NEXT, GRPC_CQ_DEFAULT_POLLING}) {}
+            GRPC_CQ_CURRENT_VERSION, GRPC_CQ_NEXT, GRPC_CQ_DEFAULT_POLLING,
+            nullptr}) {}
 
   /// Wrap \a take, taking ownership of the instance.
   ///
@@ -137,6 +139,22 @@ class CompletionQueue : private GrpcLibraryCodegen {
                                            GPR_CLOCK_REALTIME)) != SHUTDOWN);
   }
 
+  /// Read up to \a max_events events from the queue, blocking until at least
+  /// one is available or the queue is shutting down. Events that are already
+  /// available when the first one is read are returned together, amortizing
+  /// the cost of polling the queue across them.
+  ///
+  /// \param tags[out] Updated to point to the read events' tags.
+  /// \param oks[out] For each event read, true if it was a regular event.
+  /// \param max_events[in] Capacity of \a tags and \a oks; must be positive.
+  ///
+  /// \return The number of events read, or 0 if the queue is shutting down.
+  size_t NextBatch(void** tags, bool* oks, size_t max_events) {
+    return NextBatchInternal(
+        tags, oks, max_events,
+        g_core_codegen_interface->gpr_inf_future(GPR_CLOCK_REALTIME));
+  }
+
   /// Request the shutdown of the queue.
   ///
   /// \warning This method must be called at some point if this completion queue
@@ -206,6 +224,8 @@ class CompletionQueue : private GrpcLibraryCodegen {
   friend class UnknownMethodHandler;
   friend class ::grpc::Server;
   friend class ::grpc::ServerContext;
+  friend class ::grpc::ServerInterface;
+  friend class ::grpc::Channel;
   template <class InputMessage, class OutputMessage>
   friend Status BlockingUnaryCall(ChannelInterface* channel,
                                   const RpcMethod& method,
@@ -214,6 +234,14 @@ class CompletionQueue : private GrpcLibraryCodegen {
                                   OutputMessage* result);
 
   NextStatus AsyncNextInternal(void** tag, bool* ok, gpr_timespec deadline);
+  size_t NextBatchInternal(void** tags, bool* oks, size_t max_events,
+                           gpr_timespec deadline);
+
+  /// Returns the tag to hand to the core for an operation completing \a tag
+  /// on this queue: \a tag itself, or, on a callback completion queue, a
+  /// functor that finalizes \a tag and runs the resulting
+  /// \a experimental::CompletionCallback.
+  void* CoreCqTag(CompletionQueueTag* tag);
 
   /// Wraps \a grpc_completion_queue_pluck.
   /// \warning Must not be mixed with calls to \a Next.
@@ -285,8 +313,11 @@ class ServerCompletionQueue : public CompletionQueue {
   /// AsyncNext()). By default all server completion queues are assumed to be
   /// frequently polled.
   ServerCompletionQueue(grpc_cq_polling_type polling_type)
+      : ServerCompletionQueue(GRPC_CQ_NEXT, polling_type) {}
+  ServerCompletionQueue(grpc_cq_completion_type completion_type,
+                        grpc_cq_polling_type polling_type)
       : CompletionQueue(grpc_completion_queue_attributes{
-            GRPC_CQ_CURRENT_VERSION, GRPC_CQ_NEXT, polling_type}),
+            GRPC_CQ_CURRENT_VERSION, completion_type, polling_type, nullptr}),
         polling_type_(polling_type) {}
 };
 
@@ -32,6 +32,22 @@ class CompletionQueueTag {
   virtual bool FinalizeResult(void** tag, bool* status) = 0;
 };
 
+namespace experimental {
+
+/// EXPERIMENTAL: The tag type of callback completion queues (see
+/// \a ServerBuilder::AddCallbackCompletionQueue). Every tag handed to an
+/// operation on such a queue must be a pointer to a CompletionCallback (not
+/// to a subclass of it): rather than being returned from a polling call, its
+/// \a Run method is invoked with the status of the operation by the thread
+/// that completed it, so \a Run must not block.
+class CompletionCallback {
+ public:
+  virtual ~CompletionCallback() {}
+  virtual void Run(bool ok) = 0;
+};
+
+}  // namespace experimental
+
 }  // namespace grpc
 
 #endif  // GRPCXX_IMPL_CODEGEN_COMPLETION_QUEUE_TAG_H
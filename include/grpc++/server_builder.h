@@ -123,6 +123,16 @@ class ServerBuilder {
   /// Only useful if this is a Synchronous server.
   ServerBuilder& SetSyncServerOption(SyncServerOption option, int value);
 
+  /// EXPERIMENTAL: Keep each connection on a single core (see
+  /// \a GRPC_ARG_PER_CORE_LISTENERS): every listening port gets one
+  /// CPU-steered listener per listening completion queue, and the i-th queue
+  /// (synchronous server queues first, then those of \a AddCompletionQueue)
+  /// receives the connections of CPU i. A synchronous server then uses one
+  /// completion queue per core, served by threads bound to that core; the
+  /// threads polling queues returned by \a AddCompletionQueue should be bound
+  /// the same way (see \a gpr_cpu_set_affinity).
+  ServerBuilder& SetPerCoreListeners(bool enabled);
+
   /// Add a channel argument (an escape hatch to tuning core library parameters
   /// directly)
   template <class T>
@@ -180,6 +190,15 @@ class ServerBuilder {
   std::unique_ptr<ServerCompletionQueue> AddCompletionQueue(
       bool is_frequently_polled = true);
 
+  /// EXPERIMENTAL: Add a callback completion queue. Instead of being polled
+  /// with Next(), it polls on an internal thread and runs the
+  /// \a experimental::CompletionCallback passed as the tag of each operation
+  /// as soon as that operation completes, so every tag used with it (including
+  /// those of RequestAsync* calls) must be a CompletionCallback pointer.
+  /// Like the queues returned by \a AddCompletionQueue, it must be shut down
+  /// after the server.
+  std::unique_ptr<ServerCompletionQueue> AddCallbackCompletionQueue();
+
   /// Return a running server which is ready for processing calls.
   std::unique_ptr<Server> BuildAndStart();
 
@@ -236,6 +255,7 @@ class ServerBuilder {
   std::vector<Port> ports_;
 
   SyncServerSettings sync_server_settings_;
+  bool per_core_listeners_;
 
   /// List of completion queues added via \a AddCompletionQueue method.
   std::vector<ServerCompletionQueue*> cqs_;
@@ -21,6 +21,16 @@
 
 #include <grpc++/impl/codegen/slice.h>
 #include <grpc++/support/config.h>
+#include <grpc++/support/status.h>
 #include <grpc/slice.h>
 
+namespace grpc {
+
+/// Map \a length bytes of the open file \a fd, starting at \a offset, into
+/// \a slice rather than copying them (see \a grpc_slice_map_file). A
+/// ByteBuffer built from such slices is sent without copying the file data.
+Status MapFileSlice(int fd, uint64_t offset, size_t length, Slice* slice);
+
+}  // namespace grpc
+
 #endif  // GRPCXX_SUPPORT_SLICE_H
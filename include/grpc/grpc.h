@@ -94,6 +94,17 @@ GRPCAPI grpc_completion_queue *grpc_completion_queue_create_for_next(
 GRPCAPI grpc_completion_queue *grpc_completion_queue_create_for_pluck(
     void *reserved);
 
+/** EXPERIMENTAL: Helper function to create a completion queue with
+    grpc_cq_completion_type of GRPC_CQ_CALLBACK and grpc_cq_polling_type of
+    GRPC_CQ_DEFAULT_POLLING. Tags passed along with operations on this queue
+    must be grpc_experimental_completion_queue_functor pointers; the queue
+    polls for I/O on a thread of its own. shutdown_callback (which may be NULL)
+    is invoked once the queue has been shut down and all of its operations
+    have completed. */
+GRPCAPI grpc_completion_queue *grpc_completion_queue_create_for_callback(
+    grpc_experimental_completion_queue_functor *shutdown_callback,
+    void *reserved);
+
 /** Create a completion queue */
 GRPCAPI grpc_completion_queue *grpc_completion_queue_create(
     const grpc_completion_queue_factory *factory,
@@ -111,6 +122,22 @@ GRPCAPI grpc_event grpc_completion_queue_next(grpc_completion_queue *cq,
                                               gpr_timespec deadline,
                                               void *reserved);
 
+/** Like grpc_completion_queue_next, but once an event is available also
+    returns up to max_events - 1 further events that are ready, without
+    polling again.
+
+    Returns the number of events written to events, which is always at least
+    one. On timeout or shutdown, events[0] has type GRPC_QUEUE_TIMEOUT or
+    GRPC_QUEUE_SHUTDOWN and 1 is returned.
+
+    Callers must not call grpc_completion_queue_next_batch and
+    grpc_completion_queue_pluck simultaneously on the same completion queue. */
+GRPCAPI size_t grpc_completion_queue_next_batch(grpc_completion_queue *cq,
+                                                grpc_event *events,
+                                                size_t max_events,
+                                                gpr_timespec deadline,
+                                                void *reserved);
+
 /** Blocks until an event with tag 'tag' is available, the completion queue is
     being shutdown or deadline is reached.
 
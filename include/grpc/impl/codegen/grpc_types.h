@@ -240,6 +240,19 @@ typedef struct {
 /** The time between the first and second connection attempts, in ms */
 #define GRPC_ARG_INITIAL_RECONNECT_BACKOFF_MS \
   "grpc.initial_reconnect_backoff_ms"
+/** Maximum number of connections a subchannel may open to its address.
+    Calls are spread over the connections by active stream count, and another
+    connection is opened only when every open one has reached
+    GRPC_ARG_SUBCHANNEL_CONNECTION_STREAM_LIMIT active streams. Int valued,
+    defaults to 1. */
+#define GRPC_ARG_MAX_CONNECTIONS_PER_SUBCHANNEL \
+  "grpc.max_connections_per_subchannel"
+/** Number of active streams on each of a subchannel's connections at which
+    another connection is opened (see GRPC_ARG_MAX_CONNECTIONS_PER_SUBCHANNEL).
+    Usually set to the server's MAX_CONCURRENT_STREAMS. Int valued, defaults
+    to 100. */
+#define GRPC_ARG_SUBCHANNEL_CONNECTION_STREAM_LIMIT \
+  "grpc.subchannel_connection_stream_limit"
 /** This *should* be used for testing only.
     The caller of the secure_channel_create functions may override the target
     name used for SSL host name checking using this channel argument which is of
@@ -253,6 +266,14 @@ typedef struct {
 #define GRPC_ARG_MAX_METADATA_SIZE "grpc.max_metadata_size"
 /** If non-zero, allow the use of SO_REUSEPORT if it's available (default 1) */
 #define GRPC_ARG_ALLOW_REUSEPORT "grpc.so_reuseport"
+/** If non-zero, and SO_REUSEPORT is in use, each listening TCP port gets one
+ * listener socket per listening completion queue of the server, and the
+ * kernel steers every new connection to the socket of the CPU processing its
+ * packets (SO_INCOMING_CPU, or a reuseport BPF program where available): the
+ * i-th queue receives the connections of CPU i (modulo the number of
+ * queues), and all of their calls. Pair with one completion queue per core,
+ * each polled by threads bound to its CPU (default 0) */
+#define GRPC_ARG_PER_CORE_LISTENERS "grpc.per_core_listeners"
 /** If non-zero, a pointer to a buffer pool (a pointer of type
  * grpc_resource_quota*). (use grpc_resource_quota_arg_vtable() to fetch an
  * appropriate pointer arg vtable) */
@@ -267,6 +288,14 @@ typedef struct {
   "grpc.service_config_disable_resolution"
 /** LB policy name. */
 #define GRPC_ARG_LB_POLICY_NAME "grpc.lb_policy_name"
+/** Name of the request header whose value the ring_hash LB policy hashes to
+    choose a backend. Calls without it go to a random backend. A string. */
+#define GRPC_ARG_RING_HASH_HEADER "grpc.ring_hash_header"
+/** How long, in milliseconds, the weighted_round_robin LB policy weighs a
+    backend by its last load report before falling back to the mean weight.
+    Int valued, defaults to 10000. */
+#define GRPC_ARG_WEIGHTED_ROUND_ROBIN_WEIGHT_EXPIRATION_MS \
+  "grpc.weighted_round_robin_weight_expiration_ms"
 /** The grpc_socket_mutator instance that set the socket options. A pointer. */
 #define GRPC_ARG_SOCKET_MUTATOR "grpc.socket_mutator"
 /** The grpc_socket_factory instance to create and bind sockets. A pointer. */
@@ -286,6 +315,48 @@ typedef struct {
   "grpc.experimental.tcp_min_read_chunk_size"
 #define GRPC_ARG_TCP_MAX_READ_CHUNK_SIZE \
   "grpc.experimental.tcp_max_read_chunk_size"
+/** If non-zero, TCP endpoints will try to send large writes with
+ * MSG_ZEROCOPY (Linux 4.14+), keeping the written slices alive until the
+ * kernel reports it is done with them. Falls back to copying writes when
+ * the socket does not support it. */
+#define GRPC_ARG_TCP_TX_ZEROCOPY_ENABLED \
+  "grpc.experimental.tcp_tx_zerocopy_enabled"
+/** Channel arg (integer): minimum number of bytes in a single sendmsg for it
+ * to be sent with MSG_ZEROCOPY; smaller writes are always copied. */
+#define GRPC_ARG_TCP_TX_ZEROCOPY_SEND_BYTES_THRESHOLD \
+  "grpc.experimental.tcp_tx_zerocopy_send_bytes_threshold"
+/** Note this is not a "channel arg" key. This is the default value used for
+ * GRPC_ARG_TCP_TX_ZEROCOPY_SEND_BYTES_THRESHOLD when it is unspecified. */
+#define GRPC_TCP_DEFAULT_TX_ZEROCOPY_SEND_BYTES_THRESHOLD (16 * 1024)
+/** If non-zero, TCP endpoints send writes that the transport knows will be
+ * followed by another write with MSG_MORE (Linux only), letting small frames
+ * from back to back writes share packets. The held back tail is pushed out by
+ * the following write, or after GRPC_ARG_TCP_WRITE_COALESCING_BUDGET_US. */
+#define GRPC_ARG_TCP_WRITE_COALESCING "grpc.experimental.tcp_write_coalescing"
+/** Channel arg (integer, microseconds): the longest a coalesced write may be
+ * held back waiting for the write that was announced to follow it. */
+#define GRPC_ARG_TCP_WRITE_COALESCING_BUDGET_US \
+  "grpc.experimental.tcp_write_coalescing_budget_us"
+/** Note this is not a "channel arg" key. This is the default value used for
+ * GRPC_ARG_TCP_WRITE_COALESCING_BUDGET_US when it is unspecified. */
+#define GRPC_TCP_DEFAULT_WRITE_COALESCING_BUDGET_US 200
+/** Channel arg (integer, microseconds): if non-zero, completion queues used
+ * by this channel (or server) busy poll in grpc_completion_queue_next(),
+ * repeatedly polling with a zero timeout for up to this long before blocking.
+ * The spin window adapts between zero and this bound depending on whether
+ * spinning recently paid off. Also sets SO_BUSY_POLL on the TCP sockets where
+ * supported. Trades CPU for latency: meant for latency critical deployments
+ * only. Defaults to 0 (disabled). */
+#define GRPC_ARG_BUSY_POLL_US "grpc.experimental.busy_poll_us"
+/** Channel arg (integer, milliseconds): if non-zero, connections keep as
+ * little memory as they can while idle, for processes holding many mostly
+ * idle connections. TCP endpoints drop the buffer of a read that has waited
+ * this long for data, and HTTP/2 transports release their stream map, HPACK
+ * state and write buffers after no reads or writes for this long. Everything is
+ * reallocated on the next activity; memory pressure on the resource quota
+ * releases it early. Defaults to 0 (disabled). */
+#define GRPC_ARG_IDLE_CONNECTION_MEMORY_RELEASE_MS \
+  "grpc.experimental.idle_connection_memory_release_ms"
 /* Timeout in milliseconds to use for calls to the grpclb load balancer.
    If 0 or unset, the balancer calls will have no deadline. */
 #define GRPC_ARG_GRPCLB_CALL_TIMEOUT_MS "grpc.grpclb_call_timeout_ms"
@@ -611,10 +682,32 @@ typedef enum {
   GRPC_CQ_NEXT,
 
   /** Events are popped out by calling grpc_completion_queue_pluck() API ONLY*/
-  GRPC_CQ_PLUCK
+  GRPC_CQ_PLUCK,
+
+  /** EXPERIMENTAL: Events are not popped out at all: each tag is a
+      grpc_experimental_completion_queue_functor, which is invoked when its
+      operation completes */
+  GRPC_CQ_CALLBACK
 } grpc_cq_completion_type;
 
-#define GRPC_CQ_CURRENT_VERSION 1
+/** EXPERIMENTAL: The tag type of completion queues whose completion type is
+    GRPC_CQ_CALLBACK. It can be embedded as the first member of a struct in C,
+    or used as a base class in C++. */
+typedef struct grpc_experimental_completion_queue_functor {
+  /** Invoked with this functor and whether the operation succeeded (non-zero)
+      or failed (zero) once the operation the functor was passed as the tag for
+      completes */
+  void (*functor_run)(struct grpc_experimental_completion_queue_functor *,
+                      int);
+
+  /** If non-zero, functor_run is invoked by the thread that completed the
+      operation, once that thread is no longer holding any gRPC locks. Such
+      functors must not block. Otherwise functor_run is invoked on a gRPC
+      executor thread */
+  int inlineable;
+} grpc_experimental_completion_queue_functor;
+
+#define GRPC_CQ_CURRENT_VERSION 2
 typedef struct grpc_completion_queue_attributes {
   /** The version number of this structure. More fields might be added to this
      structure in future. */
@@ -623,6 +716,15 @@ typedef struct grpc_completion_queue_attributes {
   grpc_cq_completion_type cq_completion_type;
 
   grpc_cq_polling_type cq_polling_type;
+
+  /* END OF VERSION 1 CQ ATTRIBUTES */
+
+  /** For completion queues of type GRPC_CQ_CALLBACK: invoked once the queue
+      has been shut down and all of its operations have completed (may be
+      NULL) */
+  grpc_experimental_completion_queue_functor *cq_shutdown_cb;
+
+  /* END OF VERSION 2 CQ ATTRIBUTES */
 } grpc_completion_queue_attributes;
 
 /** The completion queue factory structure is opaque to the callers of grpc */
@@ -67,6 +67,17 @@ GPRAPI grpc_slice grpc_slice_malloc_large(size_t length);
 
 #define GRPC_SLICE_MALLOC(len) grpc_slice_malloc(len)
 
+/** Create a slice referencing length bytes of the open file fd, starting at
+   offset, by mapping them read only into memory rather than copying them.
+   The mapping lasts until the slice, and every slice derived from it, is
+   unreferenced; fd may be closed as soon as this returns, but the file must
+   not be truncated while mapped. Refcounted slices are sent without being
+   copied, so these let large files be served without reading them.
+   Returns 1 and sets *slice on success, or returns 0 if the range cannot be
+   mapped (always, on platforms without mmap). */
+GPRAPI int grpc_slice_map_file(int fd, uint64_t offset, size_t length,
+                               grpc_slice *slice);
+
 /** Intern a slice:
 
    The return value for two invocations of this function with  the same sequence
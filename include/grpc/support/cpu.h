@@ -37,6 +37,11 @@ GPRAPI unsigned gpr_cpu_num_cores(void);
    [0, gpr_cpu_num_cores() - 1] */
 GPRAPI unsigned gpr_cpu_current_cpu(void);
 
+/** Restrict the calling thread to run only on CPU \a cpu (in range
+   [0, gpr_cpu_num_cores() - 1]). Returns 1 on success, or 0 if the platform
+   does not support thread affinity or the request failed. */
+GPRAPI int gpr_cpu_set_affinity(unsigned cpu);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -542,6 +542,20 @@ void PrintHeaderClientMethod(grpc_generator::Printer *printer,
   }
 }
 
+void PrintHeaderClientMethodCallback(
+    grpc_generator::Printer *printer, const grpc_generator::Method *method,
+    std::map<grpc::string, grpc::string> *vars) {
+  (*vars)["Method"] = method->name();
+  (*vars)["Request"] = method->input_type_name();
+  (*vars)["Response"] = method->output_type_name();
+  if (method->NoStreaming()) {
+    printer->Print(*vars,
+                   "void $Method$(::grpc::ClientContext* context, "
+                   "const $Request$* request, $Response$* response, "
+                   "std::function<void(::grpc::Status)>);\n");
+  }
+}
+
 void PrintHeaderClientMethodData(grpc_generator::Printer *printer,
                                  const grpc_generator::Method *method,
                                  std::map<grpc::string, grpc::string> *vars) {
@@ -918,10 +932,26 @@ void PrintHeaderService(grpc_generator::Printer *printer,
   for (int i = 0; i < service->method_count(); ++i) {
     PrintHeaderClientMethod(printer, service->method(i).get(), vars, true);
   }
+  printer->Print("class experimental_async final {\n public:\n");
+  printer->Indent();
+  for (int i = 0; i < service->method_count(); ++i) {
+    PrintHeaderClientMethodCallback(printer, service->method(i).get(), vars);
+  }
+  printer->Outdent();
+  printer->Print(
+      " private:\n"
+      "  friend class Stub;\n"
+      "  explicit experimental_async(Stub* stub): stub_(stub) { }\n"
+      "  Stub* stub_;\n"
+      "};\n");
+  printer->Print(
+      "class experimental_async* experimental_async() "
+      "{ return &async_stub_; }\n");
   printer->Outdent();
   printer->Print("\n private:\n");
   printer->Indent();
   printer->Print("std::shared_ptr< ::grpc::ChannelInterface> channel_;\n");
+  printer->Print("class experimental_async async_stub_{this};\n");
   for (int i = 0; i < service->method_count(); ++i) {
     PrintHeaderClientMethod(printer, service->method(i).get(), vars, false);
   }
@@ -1189,6 +1219,17 @@ void PrintSourceClientMethod(grpc_generator::Printer *printer,
                    "rpcmethod_$Method$_, "
                    "context, request, response);\n"
                    "}\n\n");
+    printer->Print(*vars,
+                   "void $ns$$Service$::"
+                   "Stub::experimental_async::$Method$("
+                   "::grpc::ClientContext* context, "
+                   "const $Request$* request, $Response$* response, "
+                   "std::function<void(::grpc::Status)> f) {\n");
+    printer->Print(*vars,
+                   "  ::grpc::experimental::CallbackUnaryCall("
+                   "stub_->channel_.get(), stub_->rpcmethod_$Method$_, "
+                   "context, *request, response, std::move(f));\n"
+                   "}\n\n");
     for (auto async_prefix : async_prefixes) {
       (*vars)["AsyncPrefix"] = async_prefix.prefix;
       (*vars)["AsyncStart"] = async_prefix.start;
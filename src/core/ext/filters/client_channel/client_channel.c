@@ -42,6 +42,7 @@
 #include "src/core/lib/iomgr/polling_entity.h"
 #include "src/core/lib/profiling/timers.h"
 #include "src/core/lib/slice/slice_internal.h"
+#include "src/core/lib/support/epoch.h"
 #include "src/core/lib/support/string.h"
 #include "src/core/lib/surface/channel.h"
 #include "src/core/lib/transport/connectivity_state.h"
@@ -162,6 +163,22 @@ struct external_connectivity_watcher;
  * CHANNEL-WIDE FUNCTIONS
  */
 
+/** What a call needs to pick without entering the combiner: the connected
+    subchannels the LB policy picks from while READY, and the service config
+    to apply to the call. Immutable once published, except for the cursor and
+    the refcount. */
+typedef struct {
+  /** one for the channel while published, one for each call picking; the
+      refs held below are dropped when this reaches zero */
+  gpr_atm refs;
+  /** picks take turns over subchannels */
+  gpr_atm next_subchannel;
+  grpc_server_retry_throttle_data *retry_throttle_data;
+  grpc_slice_hash_table *method_params_table;
+  size_t num_subchannels;
+  grpc_connected_subchannel *subchannels[];
+} fast_pick_snapshot;
+
 typedef struct client_channel_channel_data {
   /** resolver for this channel */
   grpc_resolver *resolver;
@@ -206,6 +223,16 @@ typedef struct client_channel_channel_data {
   char *info_lb_policy_name;
   /** service config in JSON form */
   char *info_service_config_json;
+
+  /** fast_pick_snapshot*: what calls pick from outside the combiner, or NULL
+      when they must pick under it (see FAST PICK). Only written under the
+      combiner */
+  gpr_atm fast_pick_snapshot;
+  /** snapshots replaced under the combiner, freed once no call can still be
+      reading them */
+  gpr_epoch_limbo fast_pick_limbo;
+  /** run by lb_policy when the subchannels it is READY on change */
+  grpc_closure on_ready_subchannels_changed;
 } channel_data;
 
 /** We create one watcher for each new lb_policy that is returned from a
@@ -222,6 +249,137 @@ static void watch_lb_policy_locked(grpc_exec_ctx *exec_ctx, channel_data *chand,
                                    grpc_lb_policy *lb_policy,
                                    grpc_connectivity_state current_state);
 
+/*************************************************************************
+ * FAST PICK
+ *
+ * While the channel is READY and its LB policy has published the subchannels
+ * it picks from, calls pick from a snapshot of them (and of the service
+ * config) without entering the combiner. The combiner replaces the snapshot
+ * whenever any of that changes.
+ *
+ * Calls load the snapshot pointer and pick from it inside an epoch critical
+ * section (see gpr_epoch_enter), taking no lock. The combiner publishes with
+ * a release store and retires the snapshot it replaces into fast_pick_limbo,
+ * which frees it once no call can still be reading it.
+ *
+ * What a snapshot refers to (subchannels, throttle data, method config) is
+ * released with its last ref, which may come before its memory goes. Calls
+ * only take a ref on a snapshot whose count has not yet reached zero, so they
+ * never reach released objects through a replaced one.
+ */
+
+// Takes a ref on \a snapshot unless its refs are already gone. Must be called
+// inside an epoch critical section.
+static bool fast_pick_snapshot_ref_if_live(fast_pick_snapshot *snapshot) {
+  gpr_atm refs;
+  do {
+    refs = gpr_atm_no_barrier_load(&snapshot->refs);
+    if (refs == 0) return false;
+  } while (!gpr_atm_no_barrier_cas(&snapshot->refs, refs, refs + 1));
+  return true;
+}
+
+// Drops a ref on \a snapshot. Its memory is freed by fast_pick_limbo.
+static void fast_pick_snapshot_unref(grpc_exec_ctx *exec_ctx,
+                                     fast_pick_snapshot *snapshot) {
+  if (gpr_atm_full_fetch_add(&snapshot->refs, -1) != 1) return;
+  for (size_t i = 0; i < snapshot->num_subchannels; i++) {
+    GRPC_CONNECTED_SUBCHANNEL_UNREF(exec_ctx, snapshot->subchannels[i],
+                                    "fast_pick_snapshot");
+  }
+  if (snapshot->retry_throttle_data != NULL) {
+    grpc_server_retry_throttle_data_unref(snapshot->retry_throttle_data);
+  }
+  if (snapshot->method_params_table != NULL) {
+    grpc_slice_hash_table_unref(exec_ctx, snapshot->method_params_table);
+  }
+}
+
+static void fast_pick_publish_locked(grpc_exec_ctx *exec_ctx,
+                                     channel_data *chand,
+                                     fast_pick_snapshot *snapshot) {
+  fast_pick_snapshot *old = (fast_pick_snapshot *)gpr_atm_no_barrier_load(
+      &chand->fast_pick_snapshot);
+  gpr_atm_rel_store(&chand->fast_pick_snapshot, (gpr_atm)snapshot);
+  if (old != NULL) {
+    fast_pick_snapshot_unref(exec_ctx, old);
+    gpr_epoch_retire(&chand->fast_pick_limbo, old);
+  }
+}
+
+static void update_fast_pick_locked(grpc_exec_ctx *exec_ctx,
+                                    channel_data *chand) {
+  fast_pick_snapshot *snapshot = NULL;
+  if (chand->lb_policy != NULL &&
+      chand->lb_policy->num_ready_subchannels > 0 &&
+      grpc_connectivity_state_check(&chand->state_tracker) ==
+          GRPC_CHANNEL_READY) {
+    grpc_lb_policy *lb_policy = chand->lb_policy;
+    snapshot = (fast_pick_snapshot *)gpr_zalloc(
+        sizeof(*snapshot) + sizeof(*snapshot->subchannels) *
+                                lb_policy->num_ready_subchannels);
+    gpr_atm_no_barrier_store(&snapshot->refs, 1);
+    snapshot->num_subchannels = lb_policy->num_ready_subchannels;
+    for (size_t i = 0; i < snapshot->num_subchannels; i++) {
+      snapshot->subchannels[i] = GRPC_CONNECTED_SUBCHANNEL_REF(
+          lb_policy->ready_subchannels[i], "fast_pick_snapshot");
+    }
+    if (chand->retry_throttle_data != NULL) {
+      snapshot->retry_throttle_data =
+          grpc_server_retry_throttle_data_ref(chand->retry_throttle_data);
+    }
+    if (chand->method_params_table != NULL) {
+      snapshot->method_params_table =
+          grpc_slice_hash_table_ref(chand->method_params_table);
+    }
+    // Carry on after the subchannel picked last, so that replacing the
+    // snapshot does not restart the order of picks. Only the combiner writes
+    // the snapshot pointer, and the channel's ref keeps the old one alive.
+    fast_pick_snapshot *old = (fast_pick_snapshot *)gpr_atm_no_barrier_load(
+        &chand->fast_pick_snapshot);
+    size_t num_picks = 0;
+    if (old != NULL) {
+      num_picks = (size_t)gpr_atm_no_barrier_load(&old->next_subchannel);
+    }
+    if (num_picks > 0) {
+      grpc_connected_subchannel *last =
+          old->subchannels[(num_picks - 1) % old->num_subchannels];
+      for (size_t i = 0; i < snapshot->num_subchannels; i++) {
+        if (snapshot->subchannels[i] == last) {
+          gpr_atm_no_barrier_store(&snapshot->next_subchannel, (gpr_atm)i + 1);
+          break;
+        }
+      }
+    }
+  }
+  if (GRPC_TRACER_ON(grpc_client_channel_trace)) {
+    gpr_log(GPR_DEBUG, "chand=%p: fast pick over %" PRIuPTR " subchannels",
+            chand, snapshot == NULL ? 0 : snapshot->num_subchannels);
+  }
+  fast_pick_publish_locked(exec_ctx, chand, snapshot);
+}
+
+static void on_ready_subchannels_changed_locked(grpc_exec_ctx *exec_ctx,
+                                                void *arg, grpc_error *error) {
+  update_fast_pick_locked(exec_ctx, (channel_data *)arg);
+}
+
+// Replaces chand->lb_policy, moving the ready subchannel notifications over
+// to the new policy. Refs are up to the caller.
+static void set_lb_policy_locked(grpc_exec_ctx *exec_ctx, channel_data *chand,
+                                 grpc_lb_policy *lb_policy) {
+  if (chand->lb_policy != NULL) {
+    grpc_lb_policy_set_on_ready_subchannels_changed_locked(chand->lb_policy,
+                                                           NULL);
+  }
+  chand->lb_policy = lb_policy;
+  if (lb_policy != NULL) {
+    grpc_lb_policy_set_on_ready_subchannels_changed_locked(
+        lb_policy, &chand->on_ready_subchannels_changed);
+  }
+  update_fast_pick_locked(exec_ctx, chand);
+}
+
 static void set_channel_connectivity_state_locked(grpc_exec_ctx *exec_ctx,
                                                   channel_data *chand,
                                                   grpc_connectivity_state state,
@@ -251,6 +409,7 @@ static void set_channel_connectivity_state_locked(grpc_exec_ctx *exec_ctx,
   }
   grpc_connectivity_state_set(exec_ctx, &chand->state_tracker, state, error,
                               reason);
+  update_fast_pick_locked(exec_ctx, chand);
 }
 
 static void on_lb_policy_state_changed_locked(grpc_exec_ctx *exec_ctx,
@@ -266,8 +425,9 @@ static void on_lb_policy_state_changed_locked(grpc_exec_ctx *exec_ctx,
     if (publish_state == GRPC_CHANNEL_SHUTDOWN && w->chand->resolver != NULL) {
       publish_state = GRPC_CHANNEL_TRANSIENT_FAILURE;
       grpc_resolver_channel_saw_error_locked(exec_ctx, w->chand->resolver);
-      GRPC_LB_POLICY_UNREF(exec_ctx, w->chand->lb_policy, "channel");
-      w->chand->lb_policy = NULL;
+      grpc_lb_policy *lb_policy = w->chand->lb_policy;
+      set_lb_policy_locked(exec_ctx, w->chand, NULL);
+      GRPC_LB_POLICY_UNREF(exec_ctx, lb_policy, "channel");
     }
     set_channel_connectivity_state_locked(exec_ctx, w->chand, publish_state,
                                           GRPC_ERROR_REF(error), "lb_changed");
@@ -518,17 +678,21 @@ static void on_resolver_result_changed_locked(grpc_exec_ctx *exec_ctx,
   // which case we want to continue using the most recent one we had).
   if (new_lb_policy != NULL || error != GRPC_ERROR_NONE ||
       chand->resolver == NULL) {
-    if (chand->lb_policy != NULL) {
+    grpc_lb_policy *old_lb_policy = chand->lb_policy;
+    set_lb_policy_locked(exec_ctx, chand, new_lb_policy);
+    if (old_lb_policy != NULL) {
       if (GRPC_TRACER_ON(grpc_client_channel_trace)) {
         gpr_log(GPR_DEBUG, "chand=%p: unreffing lb_policy=%p", chand,
-                chand->lb_policy);
+                old_lb_policy);
       }
       grpc_pollset_set_del_pollset_set(exec_ctx,
-                                       chand->lb_policy->interested_parties,
+                                       old_lb_policy->interested_parties,
                                        chand->interested_parties);
-      GRPC_LB_POLICY_UNREF(exec_ctx, chand->lb_policy, "channel");
+      GRPC_LB_POLICY_UNREF(exec_ctx, old_lb_policy, "channel");
     }
-    chand->lb_policy = new_lb_policy;
+  } else {
+    // The service config may have changed.
+    update_fast_pick_locked(exec_ctx, chand);
   }
   // Now that we've swapped out the relevant fields of chand, check for
   // error or shutdown.
@@ -631,11 +795,12 @@ static void start_transport_op_locked(grpc_exec_ctx *exec_ctx, void *arg,
                                 &chand->waiting_for_resolver_result_closures);
       }
       if (chand->lb_policy != NULL) {
+        grpc_lb_policy *lb_policy = chand->lb_policy;
+        set_lb_policy_locked(exec_ctx, chand, NULL);
         grpc_pollset_set_del_pollset_set(exec_ctx,
-                                         chand->lb_policy->interested_parties,
+                                         lb_policy->interested_parties,
                                          chand->interested_parties);
-        GRPC_LB_POLICY_UNREF(exec_ctx, chand->lb_policy, "channel");
-        chand->lb_policy = NULL;
+        GRPC_LB_POLICY_UNREF(exec_ctx, lb_policy, "channel");
       }
     }
     GRPC_ERROR_UNREF(op->disconnect_with_error);
@@ -704,6 +869,11 @@ static grpc_error *cc_init_channel_elem(grpc_exec_ctx *exec_ctx,
   GRPC_CLOSURE_INIT(&chand->on_resolver_result_changed,
                     on_resolver_result_changed_locked, chand,
                     grpc_combiner_scheduler(chand->combiner));
+  gpr_atm_no_barrier_store(&chand->fast_pick_snapshot, (gpr_atm)NULL);
+  gpr_epoch_limbo_init(&chand->fast_pick_limbo);
+  GRPC_CLOSURE_INIT(&chand->on_ready_subchannels_changed,
+                    on_ready_subchannels_changed_locked, chand,
+                    grpc_schedule_on_exec_ctx);
   chand->interested_parties = grpc_pollset_set_create();
   grpc_connectivity_state_init(&chand->state_tracker, GRPC_CHANNEL_IDLE,
                                "client_channel");
@@ -772,11 +942,15 @@ static void cc_destroy_channel_elem(grpc_exec_ctx *exec_ctx,
     grpc_client_channel_factory_unref(exec_ctx, chand->client_channel_factory);
   }
   if (chand->lb_policy != NULL) {
+    grpc_lb_policy_set_on_ready_subchannels_changed_locked(chand->lb_policy,
+                                                           NULL);
     grpc_pollset_set_del_pollset_set(exec_ctx,
                                      chand->lb_policy->interested_parties,
                                      chand->interested_parties);
     GRPC_LB_POLICY_UNREF(exec_ctx, chand->lb_policy, "channel");
   }
+  fast_pick_publish_locked(exec_ctx, chand, NULL);
+  gpr_epoch_limbo_destroy(&chand->fast_pick_limbo);
   gpr_free(chand->info_lb_policy_name);
   gpr_free(chand->info_service_config_json);
   if (chand->retry_throttle_data != NULL) {
@@ -954,23 +1128,24 @@ static void waiting_for_pick_batches_resume(grpc_exec_ctx *exec_ctx,
                                   calld->initial_metadata_batch);
 }
 
-// Applies service config to the call.  Must be invoked once we know
-// that the resolver has returned results to the channel.
-static void apply_service_config_to_call_locked(grpc_exec_ctx *exec_ctx,
-                                                grpc_call_element *elem) {
+// Applies service config to the call.
+static void apply_service_config_to_call(
+    grpc_exec_ctx *exec_ctx, grpc_call_element *elem,
+    grpc_server_retry_throttle_data *retry_throttle_data,
+    grpc_slice_hash_table *method_params_table) {
   channel_data *chand = (channel_data *)elem->channel_data;
   call_data *calld = (call_data *)elem->call_data;
   if (GRPC_TRACER_ON(grpc_client_channel_trace)) {
     gpr_log(GPR_DEBUG, "chand=%p calld=%p: applying service config to call",
             chand, calld);
   }
-  if (chand->retry_throttle_data != NULL) {
+  if (retry_throttle_data != NULL) {
     calld->retry_throttle_data =
-        grpc_server_retry_throttle_data_ref(chand->retry_throttle_data);
+        grpc_server_retry_throttle_data_ref(retry_throttle_data);
   }
-  if (chand->method_params_table != NULL) {
+  if (method_params_table != NULL) {
     calld->method_params = (method_parameters *)grpc_method_config_table_get(
-        exec_ctx, chand->method_params_table, calld->path);
+        exec_ctx, method_params_table, calld->path);
     if (calld->method_params != NULL) {
       method_parameters_ref(calld->method_params);
       // If the deadline from the service config is shorter than the one
@@ -989,6 +1164,15 @@ static void apply_service_config_to_call_locked(grpc_exec_ctx *exec_ctx,
   }
 }
 
+// Applies the channel's service config to the call.  Must be invoked once
+// we know that the resolver has returned results to the channel.
+static void apply_service_config_to_call_locked(grpc_exec_ctx *exec_ctx,
+                                                grpc_call_element *elem) {
+  channel_data *chand = (channel_data *)elem->channel_data;
+  apply_service_config_to_call(exec_ctx, elem, chand->retry_throttle_data,
+                               chand->method_params_table);
+}
+
 static void create_subchannel_call_locked(grpc_exec_ctx *exec_ctx,
                                           grpc_call_element *elem,
                                           grpc_error *error) {
@@ -1127,7 +1311,7 @@ static bool pick_callback_start_locked(grpc_exec_ctx *exec_ctx,
   const grpc_lb_policy_pick_args inputs = {
       calld->initial_metadata_batch->payload->send_initial_metadata
           .send_initial_metadata,
-      initial_metadata_flags, &calld->lb_token_mdelem};
+      initial_metadata_flags, &calld->lb_token_mdelem, calld->arena};
   // Keep a ref to the LB policy in calld while the pick is pending.
   GRPC_LB_POLICY_REF(chand->lb_policy, "pick_subchannel");
   calld->lb_policy = chand->lb_policy;
@@ -1155,6 +1339,61 @@ static bool pick_callback_start_locked(grpc_exec_ctx *exec_ctx,
   return pick_done;
 }
 
+// Picks from chand->fast_pick_snapshot and creates the subchannel call,
+// without entering the channel combiner or taking any lock.  Returns false,
+// having done nothing, if the channel is not READY, there is no snapshot to
+// pick from, or lock free reads are unavailable on this thread.
+// This is called via the call combiner, so access to calld is synchronized.
+static bool fast_pick(grpc_exec_ctx *exec_ctx, grpc_call_element *elem) {
+  channel_data *chand = (channel_data *)elem->channel_data;
+  call_data *calld = (call_data *)elem->call_data;
+  if (grpc_connectivity_state_check(&chand->state_tracker) !=
+      GRPC_CHANNEL_READY) {
+    return false;
+  }
+  if (!gpr_epoch_enter()) return false;
+  fast_pick_snapshot *snapshot =
+      (fast_pick_snapshot *)gpr_atm_acq_load(&chand->fast_pick_snapshot);
+  if (snapshot == NULL || !fast_pick_snapshot_ref_if_live(snapshot)) {
+    gpr_epoch_exit();
+    return false;
+  }
+  const size_t index =
+      (size_t)gpr_atm_no_barrier_fetch_add(&snapshot->next_subchannel, 1) %
+      snapshot->num_subchannels;
+  calld->connected_subchannel = GRPC_CONNECTED_SUBCHANNEL_REF(
+      snapshot->subchannels[index], "picked");
+  // Keep the service config alive past the critical section, which applying
+  // it need not hold up.
+  grpc_server_retry_throttle_data *retry_throttle_data = NULL;
+  if (snapshot->retry_throttle_data != NULL) {
+    retry_throttle_data =
+        grpc_server_retry_throttle_data_ref(snapshot->retry_throttle_data);
+  }
+  grpc_slice_hash_table *method_params_table = NULL;
+  if (snapshot->method_params_table != NULL) {
+    method_params_table =
+        grpc_slice_hash_table_ref(snapshot->method_params_table);
+  }
+  fast_pick_snapshot_unref(exec_ctx, snapshot);
+  gpr_epoch_exit();
+  if (GRPC_TRACER_ON(grpc_client_channel_trace)) {
+    gpr_log(GPR_DEBUG,
+            "chand=%p calld=%p: fast pick of connected_subchannel=%p", chand,
+            calld, calld->connected_subchannel);
+  }
+  apply_service_config_to_call(exec_ctx, elem, retry_throttle_data,
+                               method_params_table);
+  if (retry_throttle_data != NULL) {
+    grpc_server_retry_throttle_data_unref(retry_throttle_data);
+  }
+  if (method_params_table != NULL) {
+    grpc_slice_hash_table_unref(exec_ctx, method_params_table);
+  }
+  create_subchannel_call_locked(exec_ctx, elem, GRPC_ERROR_NONE);
+  return true;
+}
+
 typedef struct {
   grpc_call_element *elem;
   bool finished;
@@ -1267,6 +1506,9 @@ static void start_pick_locked(grpc_exec_ctx *exec_ctx, void *arg,
   call_data *calld = (call_data *)elem->call_data;
   channel_data *chand = (channel_data *)elem->channel_data;
   GPR_ASSERT(calld->connected_subchannel == NULL);
+  // The channel may have become READY since the call looked.  Picks from the
+  // snapshot must not interleave with the LB policy's own while it exists.
+  if (fast_pick(exec_ctx, elem)) return;
   if (chand->lb_policy != NULL) {
     // We already have an LB policy, so ask it for a pick.
     if (pick_callback_start_locked(exec_ctx, elem)) {
@@ -1383,9 +1625,10 @@ static void cc_start_transport_stream_op_batch(
   // We do not yet have a subchannel call.
   // Add the batch to the waiting-for-pick list.
   waiting_for_pick_batches_add(calld, batch);
-  // For batches containing a send_initial_metadata op, enter the channel
-  // combiner to start a pick.
+  // For batches containing a send_initial_metadata op, pick without the
+  // channel combiner if we can, and otherwise enter it to start a pick.
   if (batch->send_initial_metadata) {
+    if (fast_pick(exec_ctx, elem)) goto done;
     if (GRPC_TRACER_ON(grpc_client_channel_trace)) {
       gpr_log(GPR_DEBUG, "chand=%p calld=%p: entering client_channel combiner",
               chand, calld);
@@ -17,6 +17,11 @@
  */
 
 #include "src/core/ext/filters/client_channel/lb_policy.h"
+
+#include <string.h>
+
+#include <grpc/support/alloc.h>
+
 #include "src/core/lib/iomgr/combiner.h"
 
 #define WEAK_REF_BITS 16
@@ -33,6 +38,20 @@ void grpc_lb_policy_init(grpc_lb_policy *policy,
   gpr_atm_no_barrier_store(&policy->ref_pair, 1 << WEAK_REF_BITS);
   policy->interested_parties = grpc_pollset_set_create();
   policy->combiner = GRPC_COMBINER_REF(combiner, "lb_policy");
+  policy->ready_subchannels = NULL;
+  policy->num_ready_subchannels = 0;
+  policy->on_ready_subchannels_changed = NULL;
+}
+
+static void unref_ready_subchannels(grpc_exec_ctx *exec_ctx,
+                                    grpc_lb_policy *policy) {
+  for (size_t i = 0; i < policy->num_ready_subchannels; i++) {
+    GRPC_CONNECTED_SUBCHANNEL_UNREF(exec_ctx, policy->ready_subchannels[i],
+                                    "lb_policy_ready");
+  }
+  gpr_free(policy->ready_subchannels);
+  policy->ready_subchannels = NULL;
+  policy->num_ready_subchannels = 0;
 }
 
 #ifndef NDEBUG
@@ -100,6 +119,7 @@ void grpc_lb_policy_weak_unref(grpc_exec_ctx *exec_ctx,
       ref_mutate(policy, -(gpr_atm)1, 1 REF_MUTATE_PASS_ARGS("WEAK_UNREF"));
   if (old_val == 1) {
     grpc_pollset_set_destroy(exec_ctx, policy->interested_parties);
+    unref_ready_subchannels(exec_ctx, policy);
     grpc_combiner *combiner = policy->combiner;
     policy->vtable->destroy(exec_ctx, policy);
     GRPC_COMBINER_UNREF(exec_ctx, combiner, "lb_policy");
@@ -162,3 +182,33 @@ void grpc_lb_policy_update_locked(grpc_exec_ctx *exec_ctx,
                                   const grpc_lb_policy_args *lb_policy_args) {
   policy->vtable->update_locked(exec_ctx, policy, lb_policy_args);
 }
+
+void grpc_lb_policy_set_ready_subchannels_locked(
+    grpc_exec_ctx *exec_ctx, grpc_lb_policy *policy,
+    grpc_connected_subchannel **subchannels, size_t num_subchannels) {
+  if (num_subchannels == policy->num_ready_subchannels &&
+      (num_subchannels == 0 ||
+       memcmp(subchannels, policy->ready_subchannels,
+              sizeof(*subchannels) * num_subchannels) == 0)) {
+    return;
+  }
+  unref_ready_subchannels(exec_ctx, policy);
+  if (num_subchannels > 0) {
+    policy->ready_subchannels = (grpc_connected_subchannel **)gpr_malloc(
+        sizeof(*subchannels) * num_subchannels);
+    for (size_t i = 0; i < num_subchannels; i++) {
+      policy->ready_subchannels[i] =
+          GRPC_CONNECTED_SUBCHANNEL_REF(subchannels[i], "lb_policy_ready");
+    }
+    policy->num_ready_subchannels = num_subchannels;
+  }
+  if (policy->on_ready_subchannels_changed != NULL) {
+    GRPC_CLOSURE_RUN(exec_ctx, policy->on_ready_subchannels_changed,
+                     GRPC_ERROR_NONE);
+  }
+}
+
+void grpc_lb_policy_set_on_ready_subchannels_changed_locked(
+    grpc_lb_policy *policy, grpc_closure *closure) {
+  policy->on_ready_subchannels_changed = closure;
+}
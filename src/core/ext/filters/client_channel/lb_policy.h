@@ -21,6 +21,7 @@
 
 #include "src/core/ext/filters/client_channel/subchannel.h"
 #include "src/core/lib/iomgr/polling_entity.h"
+#include "src/core/lib/support/arena.h"
 #include "src/core/lib/transport/connectivity_state.h"
 
 /** A load balancing policy: specified by a vtable and a struct (which
@@ -40,6 +41,12 @@ struct grpc_lb_policy {
   grpc_pollset_set *interested_parties;
   /* combiner under which lb_policy actions take place */
   grpc_combiner *combiner;
+  /* connected subchannels last passed to
+     grpc_lb_policy_set_ready_subchannels_locked (owned refs) */
+  grpc_connected_subchannel **ready_subchannels;
+  size_t num_ready_subchannels;
+  /* run under the combiner when ready_subchannels changes; may be NULL */
+  grpc_closure *on_ready_subchannels_changed;
 };
 
 /** Extra arguments for an LB pick */
@@ -52,6 +59,9 @@ typedef struct grpc_lb_policy_pick_args {
   uint32_t initial_metadata_flags;
   /** Storage for LB token in \a initial_metadata, or NULL if not used */
   grpc_linked_mdelem *lb_token_mdelem_storage;
+  /** Arena of the picking call, for state that lives as long as the call, or
+   * NULL */
+  gpr_arena *arena;
 } grpc_lb_policy_pick_args;
 
 struct grpc_lb_policy_vtable {
@@ -199,6 +209,23 @@ grpc_connectivity_state grpc_lb_policy_check_connectivity_locked(
     grpc_exec_ctx *exec_ctx, grpc_lb_policy *policy,
     grpc_error **connectivity_error);
 
+/** Publish the connected subchannels \a policy currently picks from: called
+    by policies whose picks are an even choice among their READY subchannels,
+    whenever that set changes (with \a num_subchannels zero when nothing is
+    READY or the policy shuts down). The channel may then pick from the set
+    without entering the combiner, so policies whose picks depend on the call
+    (its metadata, LB tokens, or per call state) must not publish. Refs are
+    taken on \a subchannels; the array is not retained. */
+void grpc_lb_policy_set_ready_subchannels_locked(
+    grpc_exec_ctx *exec_ctx, grpc_lb_policy *policy,
+    grpc_connected_subchannel **subchannels, size_t num_subchannels);
+
+/** Run \a closure (under the combiner, synchronously) whenever the ready
+    subchannels of \a policy change. NULL stops the notifications; this must
+    be done before the last strong ref to \a policy is released. */
+void grpc_lb_policy_set_on_ready_subchannels_changed_locked(
+    grpc_lb_policy *policy, grpc_closure *closure);
+
 /** Update \a policy with \a lb_policy_args. */
 void grpc_lb_policy_update_locked(grpc_exec_ctx *exec_ctx,
                                   grpc_lb_policy *policy,
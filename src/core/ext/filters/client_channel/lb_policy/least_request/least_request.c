@@ -0,0 +1,791 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/** Least Request Policy.
+ *
+ * Every pick draws two READY subchannels at random and takes the one with
+ * fewer outstanding calls ("the power of two choices"). A call is outstanding
+ * from the moment it is picked until the client channel destroys it, which it
+ * learns of through the GRPC_CONTEXT_LB_CALL_TRACKER context element. Ties go
+ * to the subchannel with the lower moving average of call latency, once both
+ * have one.
+ *
+ * Subchannel list management follows round_robin. Counts follow a subchannel
+ * across updates that keep it. */
+
+#include <string.h>
+
+#include <grpc/support/alloc.h>
+
+#include "src/core/ext/filters/client_channel/lb_policy/subchannel_list.h"
+#include "src/core/ext/filters/client_channel/lb_policy_registry.h"
+#include "src/core/ext/filters/client_channel/subchannel.h"
+#include "src/core/ext/filters/client_channel/subchannel_index.h"
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/debug/trace.h"
+#include "src/core/lib/transport/connectivity_state.h"
+
+grpc_tracer_flag grpc_lb_least_request_trace =
+    GRPC_TRACER_INITIALIZER(false, "least_request");
+
+/** Weight of a new latency sample in the moving average, as a shift: each
+ * sample moves the average 1/8 of the way towards it. */
+#define LATENCY_EWMA_SHIFT 3
+
+/** Load of one subchannel, shared by the calls picked for it, which may
+ * outlive the subchannel list. Updated outside the combiner. */
+typedef struct {
+  gpr_refcount refs;
+  /** calls picked for the subchannel and not yet destroyed */
+  gpr_atm outstanding_calls;
+  /** moving average of call latency in microseconds, or 0 before the first
+   * call ends */
+  gpr_atm latency_ewma_us;
+} lr_subchannel_load;
+
+/** Call tracker set in the call context of each pick, allocated in the arena
+ * of the call. */
+typedef struct {
+  lr_subchannel_load *load;
+  gpr_timespec start_time;
+} lr_call_tracker;
+
+static lr_subchannel_load *lr_subchannel_load_create(void) {
+  lr_subchannel_load *load = (lr_subchannel_load *)gpr_zalloc(sizeof(*load));
+  gpr_ref_init(&load->refs, 1);
+  return load;
+}
+
+static lr_subchannel_load *lr_subchannel_load_ref(lr_subchannel_load *load) {
+  gpr_ref_non_zero(&load->refs);
+  return load;
+}
+
+static void lr_subchannel_load_unref(lr_subchannel_load *load) {
+  if (gpr_unref(&load->refs)) {
+    gpr_free(load);
+  }
+}
+
+static void lr_subchannel_load_record_latency(lr_subchannel_load *load,
+                                              gpr_atm latency_us) {
+  // Losing a race to another call's update only drops one sample.
+  const gpr_atm old = gpr_atm_no_barrier_load(&load->latency_ewma_us);
+  const gpr_atm ewma =
+      old == 0 ? latency_us
+               : old + (latency_us - old) / (1 << LATENCY_EWMA_SHIFT);
+  gpr_atm_no_barrier_cas(&load->latency_ewma_us, old, GPR_MAX(ewma, 1));
+}
+
+/** Destroy function of the GRPC_CONTEXT_LB_CALL_TRACKER context element. */
+static void lr_call_tracker_destroy(void *arg) {
+  lr_call_tracker *tracker = (lr_call_tracker *)arg;
+  const gpr_timespec elapsed =
+      gpr_time_sub(gpr_now(GPR_CLOCK_MONOTONIC), tracker->start_time);
+  lr_subchannel_load_record_latency(
+      tracker->load, (gpr_atm)elapsed.tv_sec * GPR_US_PER_SEC +
+                         elapsed.tv_nsec / GPR_NS_PER_US);
+  gpr_atm_full_fetch_add(&tracker->load->outstanding_calls, -1);
+  lr_subchannel_load_unref(tracker->load);
+}
+
+/** Counts a call as outstanding on \a load until the client channel destroys
+ * \a context. */
+static void lr_track_call(lr_subchannel_load *load,
+                          grpc_call_context_element *context,
+                          gpr_arena *arena) {
+  // Without a context nothing would tell us when the call ends.
+  if (context == NULL || arena == NULL) return;
+  gpr_atm_no_barrier_fetch_add(&load->outstanding_calls, 1);
+  lr_call_tracker *tracker =
+      (lr_call_tracker *)gpr_arena_alloc(arena, sizeof(*tracker));
+  tracker->load = lr_subchannel_load_ref(load);
+  tracker->start_time = gpr_now(GPR_CLOCK_MONOTONIC);
+  context[GRPC_CONTEXT_LB_CALL_TRACKER].value = tracker;
+  context[GRPC_CONTEXT_LB_CALL_TRACKER].destroy = lr_call_tracker_destroy;
+}
+
+/** List of entities waiting for a pick.
+ *
+ * Once a pick is available, \a target is updated and \a on_complete called. */
+typedef struct pending_pick {
+  struct pending_pick *next;
+
+  /* output argument where to store the pick()ed user_data. It'll be NULL if no
+   * such data is present or there's an error (the definite test for errors is
+   * \a target being NULL). */
+  void **user_data;
+
+  /* bitmask passed to pick() and used for selective cancelling. See
+   * grpc_lb_policy_cancel_picks() */
+  uint32_t initial_metadata_flags;
+
+  /* output argument where to store the pick()ed connected subchannel, or NULL
+   * upon error. */
+  grpc_connected_subchannel **target;
+
+  /* call context of the pick, where the call tracker goes */
+  grpc_call_context_element *context;
+
+  /* arena of the picking call, where the call tracker is allocated */
+  gpr_arena *arena;
+
+  /* to be invoked once the pick() has completed (regardless of success) */
+  grpc_closure *on_complete;
+} pending_pick;
+
+typedef struct least_request_lb_policy {
+  /** base policy: must be first */
+  grpc_lb_policy base;
+
+  grpc_lb_subchannel_list *subchannel_list;
+
+  /** have we started picking? */
+  bool started_picking;
+  /** are we shutting down? */
+  bool shutdown;
+  /** List of picks that are waiting on connectivity */
+  pending_pick *pending_picks;
+
+  /** our connectivity state tracker */
+  grpc_connectivity_state_tracker state_tracker;
+
+  /** Latest version of the subchannel list.
+   * Subchannel connectivity callbacks will only promote updated subchannel
+   * lists if they equal \a latest_pending_subchannel_list. In other words,
+   * racing callbacks that reference outdated subchannel lists won't perform any
+   * update. */
+  grpc_lb_subchannel_list *latest_pending_subchannel_list;
+
+  /** state of the generator drawing the subchannels of a pick */
+  uint64_t rand_state;
+} least_request_lb_policy;
+
+/** Marks a subchannel out of \a lr_subchannel_list_data.ready. */
+#define NOT_READY ((size_t)-1)
+
+/** State least_request keeps per subchannel list. */
+typedef struct {
+  /** load of each subchannel of the list, by index */
+  lr_subchannel_load **loads;
+  size_t num_subchannels;
+  /** indices of the READY subchannels of the list, in no particular order */
+  size_t *ready;
+  size_t num_ready;
+  /** position in \a ready of each subchannel of the list, or NOT_READY */
+  size_t *ready_positions;
+} lr_subchannel_list_data;
+
+static void lr_subchannel_list_data_destroy(void *arg) {
+  lr_subchannel_list_data *data = (lr_subchannel_list_data *)arg;
+  for (size_t i = 0; i < data->num_subchannels; i++) {
+    lr_subchannel_load_unref(data->loads[i]);
+  }
+  gpr_free(data->loads);
+  gpr_free(data->ready);
+  gpr_free(data->ready_positions);
+  gpr_free(data);
+}
+
+static lr_subchannel_list_data *list_data(
+    const grpc_lb_subchannel_list *subchannel_list) {
+  return (lr_subchannel_list_data *)subchannel_list->policy_data;
+}
+
+static size_t subchannel_index(const grpc_lb_subchannel_data *sd) {
+  return (size_t)(sd - sd->subchannel_list->subchannels);
+}
+
+static lr_subchannel_load *subchannel_load(const grpc_lb_subchannel_data *sd) {
+  return list_data(sd->subchannel_list)->loads[subchannel_index(sd)];
+}
+
+/** Adds \a sd to or removes it from the READY subchannels of its list,
+ * according to its current connectivity state. */
+static void update_ready_set_locked(grpc_lb_subchannel_data *sd) {
+  lr_subchannel_list_data *data = list_data(sd->subchannel_list);
+  const size_t index = subchannel_index(sd);
+  const size_t position = data->ready_positions[index];
+  if (sd->curr_connectivity_state == GRPC_CHANNEL_READY) {
+    if (position == NOT_READY) {
+      data->ready_positions[index] = data->num_ready;
+      data->ready[data->num_ready++] = index;
+    }
+  } else if (position != NOT_READY) {
+    // Move the last READY subchannel into the hole.
+    const size_t last = data->ready[--data->num_ready];
+    data->ready[position] = last;
+    data->ready_positions[last] = position;
+    data->ready_positions[index] = NOT_READY;
+  }
+}
+
+/** Returns a pseudo-random number below \a n. Picks run in the combiner, so
+ * unlike rand() the generator takes no lock. */
+static size_t lr_rand_locked(least_request_lb_policy *p, size_t n) {
+  // xorshift64*
+  p->rand_state ^= p->rand_state >> 12;
+  p->rand_state ^= p->rand_state << 25;
+  p->rand_state ^= p->rand_state >> 27;
+  return (size_t)((p->rand_state * UINT64_C(2685821657736338717)) >> 32) % n;
+}
+
+/** Returns the less loaded of two distinct READY subchannels drawn at random,
+ * or NULL if no subchannel is READY. */
+static grpc_lb_subchannel_data *pick_subchannel_locked(
+    least_request_lb_policy *p) {
+  grpc_lb_subchannel_list *subchannel_list = p->subchannel_list;
+  if (subchannel_list == NULL) return NULL;
+  const lr_subchannel_list_data *data = list_data(subchannel_list);
+  const size_t num_ready = data->num_ready;
+  if (num_ready == 0) return NULL;
+  const size_t first = lr_rand_locked(p, num_ready);
+  grpc_lb_subchannel_data *sd =
+      &subchannel_list->subchannels[data->ready[first]];
+  if (num_ready == 1) return sd;
+  size_t second = lr_rand_locked(p, num_ready - 1);
+  if (second >= first) second++;
+  grpc_lb_subchannel_data *other =
+      &subchannel_list->subchannels[data->ready[second]];
+  const lr_subchannel_load *sd_load = subchannel_load(sd);
+  const lr_subchannel_load *other_load = subchannel_load(other);
+  const gpr_atm sd_calls = gpr_atm_no_barrier_load(&sd_load->outstanding_calls);
+  const gpr_atm other_calls =
+      gpr_atm_no_barrier_load(&other_load->outstanding_calls);
+  if (other_calls < sd_calls) return other;
+  if (other_calls == sd_calls) {
+    const gpr_atm sd_latency =
+        gpr_atm_no_barrier_load(&sd_load->latency_ewma_us);
+    const gpr_atm other_latency =
+        gpr_atm_no_barrier_load(&other_load->latency_ewma_us);
+    if (sd_latency != 0 && other_latency != 0 && other_latency < sd_latency) {
+      return other;
+    }
+  }
+  return sd;
+}
+
+static void lr_destroy(grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol) {
+  least_request_lb_policy *p = (least_request_lb_policy *)pol;
+  if (GRPC_TRACER_ON(grpc_lb_least_request_trace)) {
+    gpr_log(GPR_DEBUG, "[LR %p] Destroying Least Request policy at %p",
+            (void *)pol, (void *)pol);
+  }
+  grpc_connectivity_state_destroy(exec_ctx, &p->state_tracker);
+  grpc_subchannel_index_unref();
+  gpr_free(p);
+}
+
+static void lr_shutdown_locked(grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol) {
+  least_request_lb_policy *p = (least_request_lb_policy *)pol;
+  if (GRPC_TRACER_ON(grpc_lb_least_request_trace)) {
+    gpr_log(GPR_DEBUG, "[LR %p] Shutting down Least Request policy at %p",
+            (void *)pol, (void *)pol);
+  }
+  p->shutdown = true;
+  pending_pick *pp;
+  while ((pp = p->pending_picks)) {
+    p->pending_picks = pp->next;
+    *pp->target = NULL;
+    GRPC_CLOSURE_SCHED(
+        exec_ctx, pp->on_complete,
+        GRPC_ERROR_CREATE_FROM_STATIC_STRING("Channel Shutdown"));
+    gpr_free(pp);
+  }
+  grpc_connectivity_state_set(
+      exec_ctx, &p->state_tracker, GRPC_CHANNEL_SHUTDOWN,
+      GRPC_ERROR_CREATE_FROM_STATIC_STRING("Channel Shutdown"), "lr_shutdown");
+  const bool latest_is_current =
+      p->subchannel_list == p->latest_pending_subchannel_list;
+  grpc_lb_subchannel_list_shutdown_and_unref(exec_ctx, p->subchannel_list,
+                                             "sl_shutdown_lr_shutdown");
+  p->subchannel_list = NULL;
+  if (!latest_is_current && p->latest_pending_subchannel_list != NULL &&
+      !p->latest_pending_subchannel_list->shutting_down) {
+    grpc_lb_subchannel_list_shutdown_and_unref(
+        exec_ctx, p->latest_pending_subchannel_list,
+        "sl_shutdown_pending_lr_shutdown");
+    p->latest_pending_subchannel_list = NULL;
+  }
+}
+
+static void lr_cancel_pick_locked(grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol,
+                                  grpc_connected_subchannel **target,
+                                  grpc_error *error) {
+  least_request_lb_policy *p = (least_request_lb_policy *)pol;
+  pending_pick *pp = p->pending_picks;
+  p->pending_picks = NULL;
+  while (pp != NULL) {
+    pending_pick *next = pp->next;
+    if (pp->target == target) {
+      *target = NULL;
+      GRPC_CLOSURE_SCHED(exec_ctx, pp->on_complete,
+                         GRPC_ERROR_CREATE_REFERENCING_FROM_STATIC_STRING(
+                             "Pick cancelled", &error, 1));
+      gpr_free(pp);
+    } else {
+      pp->next = p->pending_picks;
+      p->pending_picks = pp;
+    }
+    pp = next;
+  }
+  GRPC_ERROR_UNREF(error);
+}
+
+static void lr_cancel_picks_locked(grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol,
+                                   uint32_t initial_metadata_flags_mask,
+                                   uint32_t initial_metadata_flags_eq,
+                                   grpc_error *error) {
+  least_request_lb_policy *p = (least_request_lb_policy *)pol;
+  pending_pick *pp = p->pending_picks;
+  p->pending_picks = NULL;
+  while (pp != NULL) {
+    pending_pick *next = pp->next;
+    if ((pp->initial_metadata_flags & initial_metadata_flags_mask) ==
+        initial_metadata_flags_eq) {
+      *pp->target = NULL;
+      GRPC_CLOSURE_SCHED(exec_ctx, pp->on_complete,
+                         GRPC_ERROR_CREATE_REFERENCING_FROM_STATIC_STRING(
+                             "Pick cancelled", &error, 1));
+      gpr_free(pp);
+    } else {
+      pp->next = p->pending_picks;
+      p->pending_picks = pp;
+    }
+    pp = next;
+  }
+  GRPC_ERROR_UNREF(error);
+}
+
+static void start_picking_locked(grpc_exec_ctx *exec_ctx,
+                                 least_request_lb_policy *p) {
+  p->started_picking = true;
+  for (size_t i = 0; i < p->subchannel_list->num_subchannels; i++) {
+    grpc_lb_subchannel_data *sd = &p->subchannel_list->subchannels[i];
+    grpc_lb_subchannel_list_ref_for_connectivity_watch(sd->subchannel_list,
+                                                       "connectivity_watch");
+    grpc_lb_subchannel_data_start_connectivity_watch(exec_ctx, sd);
+  }
+}
+
+static void lr_exit_idle_locked(grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol) {
+  least_request_lb_policy *p = (least_request_lb_policy *)pol;
+  if (!p->started_picking) {
+    start_picking_locked(exec_ctx, p);
+  }
+}
+
+/** Completes a pick of \a sd into \a target, \a context and \a user_data. */
+static void fill_pick_locked(least_request_lb_policy *p,
+                             grpc_lb_subchannel_data *sd,
+                             grpc_connected_subchannel **target,
+                             grpc_call_context_element *context,
+                             gpr_arena *arena, void **user_data) {
+  lr_subchannel_load *load = subchannel_load(sd);
+  *target = GRPC_CONNECTED_SUBCHANNEL_REF(
+      grpc_subchannel_get_connected_subchannel(sd->subchannel), "lr_picked");
+  if (user_data != NULL) {
+    *user_data = sd->user_data;
+  }
+  lr_track_call(load, context, arena);
+  if (GRPC_TRACER_ON(grpc_lb_least_request_trace)) {
+    gpr_log(GPR_DEBUG,
+            "[LR %p] Picked target <-- Subchannel %p (connected %p) (sl %p, "
+            "outstanding calls %ld)",
+            (void *)p, (void *)sd->subchannel, (void *)*target,
+            (void *)sd->subchannel_list,
+            (long)gpr_atm_no_barrier_load(&load->outstanding_calls));
+  }
+}
+
+static int lr_pick_locked(grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol,
+                          const grpc_lb_policy_pick_args *pick_args,
+                          grpc_connected_subchannel **target,
+                          grpc_call_context_element *context, void **user_data,
+                          grpc_closure *on_complete) {
+  least_request_lb_policy *p = (least_request_lb_policy *)pol;
+  GPR_ASSERT(!p->shutdown);
+  if (GRPC_TRACER_ON(grpc_lb_least_request_trace)) {
+    gpr_log(GPR_INFO, "[LR %p] Trying to pick", (void *)pol);
+  }
+  grpc_lb_subchannel_data *sd = pick_subchannel_locked(p);
+  if (sd != NULL) {
+    /* readily available, report right away */
+    fill_pick_locked(p, sd, target, context, pick_args->arena, user_data);
+    return 1;
+  }
+  /* no pick currently available. Save for later in list of pending picks */
+  if (!p->started_picking) {
+    start_picking_locked(exec_ctx, p);
+  }
+  pending_pick *pp = (pending_pick *)gpr_malloc(sizeof(*pp));
+  pp->next = p->pending_picks;
+  pp->target = target;
+  pp->context = context;
+  pp->arena = pick_args->arena;
+  pp->on_complete = on_complete;
+  pp->initial_metadata_flags = pick_args->initial_metadata_flags;
+  pp->user_data = user_data;
+  p->pending_picks = pp;
+  return 0;
+}
+
+/** Sets the policy's connectivity status based on that of the passed-in \a sd
+ * and the subchannel list \a sd belongs to, with the same rules as
+ * round_robin. \a error will only be used upon policy transition to
+ * TRANSIENT_FAILURE or SHUTDOWN. Returns the connectivity status set. */
+static grpc_connectivity_state update_lb_connectivity_status_locked(
+    grpc_exec_ctx *exec_ctx, grpc_lb_subchannel_data *sd, grpc_error *error) {
+  grpc_connectivity_state new_state = sd->curr_connectivity_state;
+  grpc_lb_subchannel_list *subchannel_list = sd->subchannel_list;
+  least_request_lb_policy *p =
+      (least_request_lb_policy *)subchannel_list->policy;
+  if (subchannel_list->num_ready > 0) { /* 1) READY */
+    grpc_connectivity_state_set(exec_ctx, &p->state_tracker, GRPC_CHANNEL_READY,
+                                GRPC_ERROR_NONE, "lr_ready");
+    new_state = GRPC_CHANNEL_READY;
+  } else if (sd->curr_connectivity_state ==
+             GRPC_CHANNEL_CONNECTING) { /* 2) CONNECTING */
+    grpc_connectivity_state_set(exec_ctx, &p->state_tracker,
+                                GRPC_CHANNEL_CONNECTING, GRPC_ERROR_NONE,
+                                "lr_connecting");
+    new_state = GRPC_CHANNEL_CONNECTING;
+  } else if (p->subchannel_list->num_shutdown ==
+             p->subchannel_list->num_subchannels) { /* 3) SHUTDOWN */
+    grpc_connectivity_state_set(exec_ctx, &p->state_tracker,
+                                GRPC_CHANNEL_SHUTDOWN, GRPC_ERROR_REF(error),
+                                "lr_shutdown");
+    p->shutdown = true;
+    new_state = GRPC_CHANNEL_SHUTDOWN;
+  } else if (subchannel_list->num_transient_failures ==
+             p->subchannel_list->num_subchannels) { /* 4) TRANSIENT_FAILURE */
+    grpc_connectivity_state_set(exec_ctx, &p->state_tracker,
+                                GRPC_CHANNEL_TRANSIENT_FAILURE,
+                                GRPC_ERROR_REF(error), "lr_transient_failure");
+    new_state = GRPC_CHANNEL_TRANSIENT_FAILURE;
+  } else if (subchannel_list->num_idle ==
+             p->subchannel_list->num_subchannels) { /* 5) IDLE */
+    grpc_connectivity_state_set(exec_ctx, &p->state_tracker, GRPC_CHANNEL_IDLE,
+                                GRPC_ERROR_NONE, "lr_idle");
+    new_state = GRPC_CHANNEL_IDLE;
+  }
+  GRPC_ERROR_UNREF(error);
+  return new_state;
+}
+
+static void lr_connectivity_changed_locked(grpc_exec_ctx *exec_ctx, void *arg,
+                                           grpc_error *error) {
+  grpc_lb_subchannel_data *sd = (grpc_lb_subchannel_data *)arg;
+  least_request_lb_policy *p =
+      (least_request_lb_policy *)sd->subchannel_list->policy;
+  if (GRPC_TRACER_ON(grpc_lb_least_request_trace)) {
+    gpr_log(
+        GPR_DEBUG,
+        "[LR %p] connectivity changed for subchannel %p, subchannel_list %p: "
+        "prev_state=%s new_state=%s p->shutdown=%d "
+        "sd->subchannel_list->shutting_down=%d error=%s",
+        (void *)p, (void *)sd->subchannel, (void *)sd->subchannel_list,
+        grpc_connectivity_state_name(sd->prev_connectivity_state),
+        grpc_connectivity_state_name(sd->pending_connectivity_state_unsafe),
+        p->shutdown, sd->subchannel_list->shutting_down,
+        grpc_error_string(error));
+  }
+  // If the policy is shutting down, unref and return.
+  if (p->shutdown) {
+    grpc_lb_subchannel_list_unref_for_connectivity_watch(
+        exec_ctx, sd->subchannel_list, "pol_shutdown");
+    return;
+  }
+  if (sd->subchannel_list->shutting_down && error == GRPC_ERROR_CANCELLED) {
+    // the subchannel list associated with sd has been discarded. This callback
+    // corresponds to the unsubscription. The unrefs correspond to the picking
+    // ref (start_picking_locked or update_started_picking).
+    grpc_lb_subchannel_list_unref_for_connectivity_watch(
+        exec_ctx, sd->subchannel_list, "sl_shutdown");
+    return;
+  }
+  // Dispose of outdated subchannel lists.
+  if (sd->subchannel_list != p->subchannel_list &&
+      sd->subchannel_list != p->latest_pending_subchannel_list) {
+    if (!sd->subchannel_list->shutting_down) {
+      grpc_lb_subchannel_list_shutdown_and_unref(exec_ctx, sd->subchannel_list,
+                                                 "sl_outdated");
+    }
+    grpc_lb_subchannel_list_unref_for_connectivity_watch(
+        exec_ctx, sd->subchannel_list, "sl_outdated");
+    return;
+  }
+  // Update state counters and determine new overall state.
+  grpc_lb_subchannel_data_update_connectivity_state_locked(sd);
+  update_ready_set_locked(sd);
+  const grpc_connectivity_state new_policy_connectivity_state =
+      update_lb_connectivity_status_locked(exec_ctx, sd, GRPC_ERROR_REF(error));
+  // If the sd's new state is SHUTDOWN, unref the subchannel, and if the new
+  // policy's state is SHUTDOWN, clean up.
+  if (sd->curr_connectivity_state == GRPC_CHANNEL_SHUTDOWN) {
+    grpc_lb_subchannel_data_unref_subchannel(exec_ctx, sd,
+                                             "lr_subchannel_shutdown");
+    if (new_policy_connectivity_state == GRPC_CHANNEL_SHUTDOWN) {
+      // the policy is shutting down. Flush all the pending picks...
+      pending_pick *pp;
+      while ((pp = p->pending_picks)) {
+        p->pending_picks = pp->next;
+        *pp->target = NULL;
+        GRPC_CLOSURE_SCHED(exec_ctx, pp->on_complete, GRPC_ERROR_NONE);
+        gpr_free(pp);
+      }
+    }
+    grpc_lb_subchannel_list_unref_for_connectivity_watch(
+        exec_ctx, sd->subchannel_list, "sd_shutdown");
+  } else {  // sd not in SHUTDOWN
+    if (sd->curr_connectivity_state == GRPC_CHANNEL_READY) {
+      if (sd->subchannel_list != p->subchannel_list) {
+        // promote sd->subchannel_list to p->subchannel_list.
+        // sd->subchannel_list must be equal to
+        // p->latest_pending_subchannel_list because we have already filtered
+        // for sds belonging to outdated subchannel lists.
+        GPR_ASSERT(sd->subchannel_list == p->latest_pending_subchannel_list);
+        GPR_ASSERT(!sd->subchannel_list->shutting_down);
+        if (GRPC_TRACER_ON(grpc_lb_least_request_trace)) {
+          gpr_log(GPR_DEBUG,
+                  "[LR %p] phasing out subchannel list %p in favor of %p",
+                  (void *)p, (void *)p->subchannel_list,
+                  (void *)sd->subchannel_list);
+        }
+        if (p->subchannel_list != NULL) {
+          // dispose of the current subchannel_list
+          grpc_lb_subchannel_list_shutdown_and_unref(
+              exec_ctx, p->subchannel_list, "sl_phase_out_shutdown");
+        }
+        p->subchannel_list = p->latest_pending_subchannel_list;
+        p->latest_pending_subchannel_list = NULL;
+      }
+      /* at this point we know there's at least one suitable subchannel.
+       * Serve the pending picks, each one picking as lr_pick() would, so that
+       * they spread by load too. */
+      pending_pick *pp;
+      while ((pp = p->pending_picks)) {
+        p->pending_picks = pp->next;
+        grpc_lb_subchannel_data *selected = pick_subchannel_locked(p);
+        GPR_ASSERT(selected != NULL);
+        fill_pick_locked(p, selected, pp->target, pp->context, pp->arena,
+                         pp->user_data);
+        GRPC_CLOSURE_SCHED(exec_ctx, pp->on_complete, GRPC_ERROR_NONE);
+        gpr_free(pp);
+      }
+    }
+    /* renew notification: reuses the connectivity watch refs on the policy
+     * and on sd->subchannel_list. */
+    grpc_lb_subchannel_data_start_connectivity_watch(exec_ctx, sd);
+  }
+}
+
+static grpc_connectivity_state lr_check_connectivity_locked(
+    grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol, grpc_error **error) {
+  least_request_lb_policy *p = (least_request_lb_policy *)pol;
+  return grpc_connectivity_state_get(&p->state_tracker, error);
+}
+
+static void lr_notify_on_state_change_locked(grpc_exec_ctx *exec_ctx,
+                                             grpc_lb_policy *pol,
+                                             grpc_connectivity_state *current,
+                                             grpc_closure *notify) {
+  least_request_lb_policy *p = (least_request_lb_policy *)pol;
+  grpc_connectivity_state_notify_on_state_change(exec_ctx, &p->state_tracker,
+                                                 current, notify);
+}
+
+static void lr_ping_one_locked(grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol,
+                               grpc_closure *closure) {
+  least_request_lb_policy *p = (least_request_lb_policy *)pol;
+  grpc_lb_subchannel_data *selected = pick_subchannel_locked(p);
+  if (selected != NULL) {
+    grpc_connected_subchannel *target = GRPC_CONNECTED_SUBCHANNEL_REF(
+        grpc_subchannel_get_connected_subchannel(selected->subchannel),
+        "lr_picked");
+    grpc_connected_subchannel_ping(exec_ctx, target, closure);
+    GRPC_CONNECTED_SUBCHANNEL_UNREF(exec_ctx, target, "lr_picked");
+  } else {
+    GRPC_CLOSURE_SCHED(exec_ctx, closure, GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+                                              "Least Request not connected"));
+  }
+}
+
+/** Returns the load of \a subchannel in \a subchannel_list, or NULL if it is
+ * not there. */
+static lr_subchannel_load *find_load_locked(
+    grpc_lb_subchannel_list *subchannel_list, grpc_subchannel *subchannel) {
+  if (subchannel_list == NULL) return NULL;
+  for (size_t i = 0; i < subchannel_list->num_subchannels; i++) {
+    if (subchannel_list->subchannels[i].subchannel == subchannel) {
+      return list_data(subchannel_list)->loads[i];
+    }
+  }
+  return NULL;
+}
+
+static void lr_update_locked(grpc_exec_ctx *exec_ctx, grpc_lb_policy *policy,
+                             const grpc_lb_policy_args *args) {
+  least_request_lb_policy *p = (least_request_lb_policy *)policy;
+  const grpc_arg *arg =
+      grpc_channel_args_find(args->args, GRPC_ARG_LB_ADDRESSES);
+  if (arg == NULL || arg->type != GRPC_ARG_POINTER) {
+    if (p->subchannel_list == NULL) {
+      // If we don't have a current subchannel list, go into TRANSIENT FAILURE.
+      grpc_connectivity_state_set(
+          exec_ctx, &p->state_tracker, GRPC_CHANNEL_TRANSIENT_FAILURE,
+          GRPC_ERROR_CREATE_FROM_STATIC_STRING("Missing update in args"),
+          "lr_update_missing");
+    } else {
+      // otherwise, keep using the current subchannel list (ignore this update).
+      gpr_log(GPR_ERROR,
+              "[LR %p] No valid LB addresses channel arg for update, ignoring.",
+              (void *)p);
+    }
+    return;
+  }
+  grpc_lb_addresses *addresses = (grpc_lb_addresses *)arg->value.pointer.p;
+  grpc_lb_subchannel_list *subchannel_list = grpc_lb_subchannel_list_create(
+      exec_ctx, &p->base, &grpc_lb_least_request_trace, addresses, args,
+      lr_connectivity_changed_locked);
+  const size_t num_subchannels = subchannel_list->num_subchannels;
+  lr_subchannel_list_data *data =
+      (lr_subchannel_list_data *)gpr_zalloc(sizeof(*data));
+  data->loads = (lr_subchannel_load **)gpr_malloc(sizeof(*data->loads) *
+                                                  num_subchannels);
+  data->num_subchannels = num_subchannels;
+  data->ready = (size_t *)gpr_malloc(sizeof(*data->ready) * num_subchannels);
+  data->ready_positions =
+      (size_t *)gpr_malloc(sizeof(*data->ready_positions) * num_subchannels);
+  for (size_t i = 0; i < num_subchannels; i++) {
+    // Subchannels are shared through the subchannel index, so a subchannel
+    // the previous list had keeps counting the calls already on it.
+    lr_subchannel_load *load = find_load_locked(
+        p->subchannel_list, subchannel_list->subchannels[i].subchannel);
+    data->loads[i] = load != NULL ? lr_subchannel_load_ref(load)
+                                  : lr_subchannel_load_create();
+    data->ready_positions[i] = NOT_READY;
+  }
+  subchannel_list->policy_data = data;
+  subchannel_list->destroy_policy_data = lr_subchannel_list_data_destroy;
+  if (num_subchannels == 0) {
+    grpc_connectivity_state_set(
+        exec_ctx, &p->state_tracker, GRPC_CHANNEL_TRANSIENT_FAILURE,
+        GRPC_ERROR_CREATE_FROM_STATIC_STRING("Empty update"),
+        "lr_update_empty");
+    if (p->subchannel_list != NULL) {
+      grpc_lb_subchannel_list_shutdown_and_unref(exec_ctx, p->subchannel_list,
+                                                 "sl_shutdown_empty_update");
+    }
+    p->subchannel_list = subchannel_list;  // empty list
+    return;
+  }
+  if (p->started_picking) {
+    if (p->latest_pending_subchannel_list != NULL) {
+      if (GRPC_TRACER_ON(grpc_lb_least_request_trace)) {
+        gpr_log(GPR_DEBUG,
+                "[LR %p] Shutting down latest pending subchannel list %p, "
+                "about to be replaced by newer latest %p",
+                (void *)p, (void *)p->latest_pending_subchannel_list,
+                (void *)subchannel_list);
+      }
+      grpc_lb_subchannel_list_shutdown_and_unref(
+          exec_ctx, p->latest_pending_subchannel_list,
+          "sl_outdated_dont_smash");
+    }
+    p->latest_pending_subchannel_list = subchannel_list;
+    for (size_t i = 0; i < num_subchannels; i++) {
+      /* Watch every new subchannel. A subchannel list becomes active the
+       * moment one of its subchannels is READY. At that moment, we swap
+       * p->subchannel_list for sd->subchannel_list, provided the subchannel
+       * list is still valid (ie, isn't shutting down) */
+      grpc_lb_subchannel_list_ref_for_connectivity_watch(subchannel_list,
+                                                         "connectivity_watch");
+      grpc_lb_subchannel_data_start_connectivity_watch(
+          exec_ctx, &subchannel_list->subchannels[i]);
+    }
+  } else {
+    // The policy isn't picking yet. Save the update for later, disposing of
+    // previous version if any.
+    if (p->subchannel_list != NULL) {
+      grpc_lb_subchannel_list_shutdown_and_unref(
+          exec_ctx, p->subchannel_list, "lr_update_before_started_picking");
+    }
+    p->subchannel_list = subchannel_list;
+  }
+}
+
+static const grpc_lb_policy_vtable least_request_lb_policy_vtable = {
+    lr_destroy,
+    lr_shutdown_locked,
+    lr_pick_locked,
+    lr_cancel_pick_locked,
+    lr_cancel_picks_locked,
+    lr_ping_one_locked,
+    lr_exit_idle_locked,
+    lr_check_connectivity_locked,
+    lr_notify_on_state_change_locked,
+    lr_update_locked};
+
+static void least_request_factory_ref(grpc_lb_policy_factory *factory) {}
+
+static void least_request_factory_unref(grpc_lb_policy_factory *factory) {}
+
+static grpc_lb_policy *least_request_create(grpc_exec_ctx *exec_ctx,
+                                            grpc_lb_policy_factory *factory,
+                                            grpc_lb_policy_args *args) {
+  GPR_ASSERT(args->client_channel_factory != NULL);
+  least_request_lb_policy *p =
+      (least_request_lb_policy *)gpr_zalloc(sizeof(*p));
+  grpc_lb_policy_init(&p->base, &least_request_lb_policy_vtable,
+                      args->combiner);
+  grpc_subchannel_index_ref();
+  grpc_connectivity_state_init(&p->state_tracker, GRPC_CHANNEL_IDLE,
+                               "least_request");
+  const gpr_timespec now = gpr_now(GPR_CLOCK_MONOTONIC);
+  // Any seed but 0 will do.
+  p->rand_state = ((uint64_t)now.tv_sec << 32) ^ (uint64_t)now.tv_nsec ^
+                  (uint64_t)(uintptr_t)p;
+  if (p->rand_state == 0) p->rand_state = 1;
+  lr_update_locked(exec_ctx, &p->base, args);
+  if (GRPC_TRACER_ON(grpc_lb_least_request_trace)) {
+    gpr_log(GPR_DEBUG, "[LR %p] Created with %lu subchannels", (void *)p,
+            (unsigned long)p->subchannel_list->num_subchannels);
+  }
+  return &p->base;
+}
+
+static const grpc_lb_policy_factory_vtable least_request_factory_vtable = {
+    least_request_factory_ref, least_request_factory_unref,
+    least_request_create, "least_request"};
+
+static grpc_lb_policy_factory least_request_lb_policy_factory = {
+    &least_request_factory_vtable};
+
+static grpc_lb_policy_factory *least_request_lb_factory_create() {
+  return &least_request_lb_policy_factory;
+}
+
+/* Plugin registration */
+
+void grpc_lb_policy_least_request_init() {
+  grpc_register_lb_policy(least_request_lb_factory_create());
+  grpc_register_tracer(&grpc_lb_least_request_trace);
+}
+
+void grpc_lb_policy_least_request_shutdown() {}
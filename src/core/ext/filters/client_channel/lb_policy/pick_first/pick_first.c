@@ -16,6 +16,7 @@
  *
  */
 
+#include <limits.h>
 #include <string.h>
 
 #include <grpc/support/alloc.h>
@@ -53,6 +54,12 @@ typedef struct {
 
   /** the selected channel */
   grpc_connected_subchannel *selected;
+  /** the subchannel \a selected belongs to, kept open while \a selected is
+      usable so that it can add connections, or NULL if it may open only one
+      (see GRPC_ARG_MAX_CONNECTIONS_PER_SUBCHANNEL) */
+  grpc_subchannel *selected_subchannel;
+  /** do our subchannels open more than one connection? */
+  bool multiple_connections;
 
   /** the subchannel key for \a selected, or NULL if \a selected not set */
   const grpc_subchannel_key *selected_key;
@@ -88,6 +95,10 @@ static void pf_destroy(grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol) {
     GRPC_CONNECTED_SUBCHANNEL_UNREF(exec_ctx, p->selected,
                                     "picked_first_destroy");
   }
+  if (p->selected_subchannel != NULL) {
+    GRPC_SUBCHANNEL_UNREF(exec_ctx, p->selected_subchannel,
+                          "picked_first_destroy");
+  }
   grpc_connectivity_state_destroy(exec_ctx, &p->state_tracker);
   grpc_subchannel_index_unref();
   if (p->pending_update_args != NULL) {
@@ -102,10 +113,24 @@ static void pf_destroy(grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol) {
   }
 }
 
+/* publish the selected subchannel, which every pick returns, while it is
+   READY */
+static void update_ready_subchannels_locked(grpc_exec_ctx *exec_ctx,
+                                            pick_first_lb_policy *p,
+                                            bool selected_ready) {
+  if (p->selected != NULL && selected_ready) {
+    grpc_lb_policy_set_ready_subchannels_locked(exec_ctx, &p->base,
+                                                &p->selected, 1);
+  } else {
+    grpc_lb_policy_set_ready_subchannels_locked(exec_ctx, &p->base, NULL, 0);
+  }
+}
+
 static void pf_shutdown_locked(grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol) {
   pick_first_lb_policy *p = (pick_first_lb_policy *)pol;
   pending_pick *pp;
   p->shutdown = true;
+  update_ready_subchannels_locked(exec_ctx, p, false);
   pp = p->pending_picks;
   p->pending_picks = NULL;
   grpc_connectivity_state_set(
@@ -287,6 +312,7 @@ static void stop_connectivity_watchers(grpc_exec_ctx *exec_ctx,
               "Pick First %p unsubscribing from selected subchannel %p",
               (void *)p, (void *)p->selected);
     }
+    update_ready_subchannels_locked(exec_ctx, p, false);
     grpc_connected_subchannel_notify_on_state_change(
         exec_ctx, p->selected, NULL, NULL, &p->connectivity_changed);
     p->updating_selected = true;
@@ -317,6 +343,11 @@ static void pf_update_locked(grpc_exec_ctx *exec_ctx, grpc_lb_policy *policy,
   }
   const grpc_lb_addresses *addresses =
       (const grpc_lb_addresses *)arg->value.pointer.p;
+  p->multiple_connections =
+      grpc_channel_arg_get_integer(
+          grpc_channel_args_find(args->args,
+                                 GRPC_ARG_MAX_CONNECTIONS_PER_SUBCHANNEL),
+          (grpc_integer_options){1, 1, INT_MAX}) > 1;
   if (addresses->num_addresses == 0) {
     // Empty update. Unsubscribe from all current subchannels and put the
     // channel in TRANSIENT_FAILURE.
@@ -478,6 +509,10 @@ static void pf_connectivity_changed_locked(grpc_exec_ctx *exec_ctx, void *arg,
     GPR_ASSERT(p->selected != NULL);
     GRPC_CONNECTED_SUBCHANNEL_UNREF(exec_ctx, p->selected,
                                     "pf_update_connectivity");
+    if (p->selected_subchannel != NULL) {
+      GRPC_SUBCHANNEL_UNREF(exec_ctx, p->selected_subchannel,
+                            "pf_update_connectivity");
+    }
     if (GRPC_TRACER_ON(grpc_lb_pick_first_trace)) {
       gpr_log(GPR_DEBUG, "Pick First %p unreffing selected subchannel %p",
               (void *)p, (void *)p->selected);
@@ -485,6 +520,7 @@ static void pf_connectivity_changed_locked(grpc_exec_ctx *exec_ctx, void *arg,
     p->updating_selected = false;
     if (p->num_new_subchannels == 0) {
       p->selected = NULL;
+      p->selected_subchannel = NULL;
       return;
     }
     restart = true;
@@ -509,6 +545,7 @@ static void pf_connectivity_changed_locked(grpc_exec_ctx *exec_ctx, void *arg,
   }
   if (restart) {
     p->selected = NULL;
+    p->selected_subchannel = NULL;
     p->selected_key = NULL;
     GPR_ASSERT(p->new_subchannels != NULL);
     GPR_ASSERT(p->num_new_subchannels > 0);
@@ -544,9 +581,18 @@ static void pf_connectivity_changed_locked(grpc_exec_ctx *exec_ctx, void *arg,
       /* if the selected channel goes bad, we're done */
       p->checking_connectivity = GRPC_CHANNEL_SHUTDOWN;
     }
+    if (p->checking_connectivity == GRPC_CHANNEL_SHUTDOWN &&
+        p->selected_subchannel != NULL) {
+      /* let the subchannel go, so that nobody reuses its dead connection */
+      GRPC_SUBCHANNEL_UNREF(exec_ctx, p->selected_subchannel,
+                            "selected_shutdown");
+      p->selected_subchannel = NULL;
+    }
     grpc_connectivity_state_set(exec_ctx, &p->state_tracker,
                                 p->checking_connectivity, GRPC_ERROR_REF(error),
                                 "selected_changed");
+    update_ready_subchannels_locked(
+        exec_ctx, p, p->checking_connectivity == GRPC_CHANNEL_READY);
     if (p->checking_connectivity != GRPC_CHANNEL_SHUTDOWN) {
       grpc_connected_subchannel_notify_on_state_change(
           exec_ctx, p->selected, p->base.interested_parties,
@@ -573,7 +619,12 @@ static void pf_connectivity_changed_locked(grpc_exec_ctx *exec_ctx, void *arg,
                   "Pick First %p selected subchannel %p (connected %p)",
                   (void *)p, (void *)selected_subchannel, (void *)p->selected);
         }
+        if (p->multiple_connections) {
+          p->selected_subchannel =
+              GRPC_SUBCHANNEL_REF(selected_subchannel, "picked_first");
+        }
         p->selected_key = grpc_subchannel_get_key(selected_subchannel);
+        update_ready_subchannels_locked(exec_ctx, p, true);
         /* drop the pick list: we are connected now */
         GRPC_LB_POLICY_WEAK_REF(&p->base, "destroy_subchannels");
         destroy_subchannels_locked(exec_ctx, p);
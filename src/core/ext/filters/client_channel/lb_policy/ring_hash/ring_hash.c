@@ -0,0 +1,673 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/** Ring Hash Policy.
+ *
+ * Consistent hashing: every subchannel owns RING_HASH_POINTS_PER_SUBCHANNEL
+ * points on a ring of 32-bit hashes, derived from its address. A call goes to
+ * the subchannel of the first point at or after the call's hash, or of the
+ * next points if that subchannel is not READY. Since points depend only on
+ * addresses, an update adding or removing one of N addresses only moves about
+ * 1/N of the hashes.
+ *
+ * The hash of a call is that of the value of its GRPC_ARG_RING_HASH_HEADER
+ * header. Calls without one are spread at random.
+ *
+ * Subchannel list management follows round_robin. Every list keeps its ring
+ * as policy data. */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/string_util.h>
+
+#include "src/core/ext/filters/client_channel/lb_policy/subchannel_list.h"
+#include "src/core/ext/filters/client_channel/lb_policy_registry.h"
+#include "src/core/ext/filters/client_channel/subchannel.h"
+#include "src/core/ext/filters/client_channel/subchannel_index.h"
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/debug/trace.h"
+#include "src/core/lib/support/murmur_hash.h"
+#include "src/core/lib/transport/connectivity_state.h"
+
+grpc_tracer_flag grpc_lb_ring_hash_trace =
+    GRPC_TRACER_INITIALIZER(false, "ring_hash");
+
+/** Points per subchannel on the ring. More points spread hashes more evenly
+ * between subchannels. It must not depend on the number of subchannels, or
+ * updates would move all the points. */
+#define RING_HASH_POINTS_PER_SUBCHANNEL 100
+
+typedef struct {
+  uint32_t hash;
+  /** index in the subchannel list's \a subchannels */
+  size_t subchannel_index;
+} ring_entry;
+
+/** List of entities waiting for a pick.
+ *
+ * Once a pick is available, \a target is updated and \a on_complete called. */
+typedef struct pending_pick {
+  struct pending_pick *next;
+
+  /* output argument where to store the pick()ed user_data. It'll be NULL if no
+   * such data is present or there's an error (the definite test for errors is
+   * \a target being NULL). */
+  void **user_data;
+
+  /* bitmask passed to pick() and used for selective cancelling. See
+   * grpc_lb_policy_cancel_picks() */
+  uint32_t initial_metadata_flags;
+
+  /* output argument where to store the pick()ed connected subchannel, or NULL
+   * upon error. */
+  grpc_connected_subchannel **target;
+
+  /* hash of the picking call */
+  uint32_t hash;
+
+  /* to be invoked once the pick() has completed (regardless of success) */
+  grpc_closure *on_complete;
+} pending_pick;
+
+typedef struct ring_hash_lb_policy {
+  /** base policy: must be first */
+  grpc_lb_policy base;
+
+  grpc_lb_subchannel_list *subchannel_list;
+
+  /** have we started picking? */
+  bool started_picking;
+  /** are we shutting down? */
+  bool shutdown;
+  /** List of picks that are waiting on connectivity */
+  pending_pick *pending_picks;
+
+  /** our connectivity state tracker */
+  grpc_connectivity_state_tracker state_tracker;
+
+  /** Latest version of the subchannel list.
+   * Subchannel connectivity callbacks will only promote updated subchannel
+   * lists if they equal \a latest_pending_subchannel_list. In other words,
+   * racing callbacks that reference outdated subchannel lists won't perform any
+   * update. */
+  grpc_lb_subchannel_list *latest_pending_subchannel_list;
+
+  /** name of the header hashed to pick, or NULL */
+  char *hash_header;
+} ring_hash_lb_policy;
+
+/** Ring of a subchannel list, kept as its policy data. */
+typedef struct {
+  /** points of the subchannels, sorted by hash */
+  ring_entry *entries;
+  size_t size;
+} rh_ring;
+
+static void rh_ring_destroy(void *arg) {
+  rh_ring *ring = (rh_ring *)arg;
+  gpr_free(ring->entries);
+  gpr_free(ring);
+}
+
+/** Returns the subchannel of the first point at or after \a hash on the ring
+ * whose subchannel is READY, or NULL if no subchannel is READY. */
+static grpc_lb_subchannel_data *pick_subchannel_locked(ring_hash_lb_policy *p,
+                                                       uint32_t hash) {
+  grpc_lb_subchannel_list *subchannel_list = p->subchannel_list;
+  if (subchannel_list == NULL || subchannel_list->num_ready == 0) return NULL;
+  const rh_ring *ring = (const rh_ring *)subchannel_list->policy_data;
+  const ring_entry *entries = ring->entries;
+  const size_t ring_size = ring->size;
+  // Binary search for the first point at or after hash.
+  size_t lo = 0;
+  size_t hi = ring_size;
+  while (lo < hi) {
+    const size_t mid = lo + (hi - lo) / 2;
+    if (entries[mid].hash < hash) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  // Fall through to the next points, wrapping around, until one is READY.
+  for (size_t i = 0; i < ring_size; i++) {
+    grpc_lb_subchannel_data *sd =
+        &subchannel_list->subchannels[entries[(lo + i) % ring_size]
+                                          .subchannel_index];
+    if (sd->curr_connectivity_state == GRPC_CHANNEL_READY) return sd;
+  }
+  GPR_UNREACHABLE_CODE(return NULL);
+}
+
+static void rh_destroy(grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol) {
+  ring_hash_lb_policy *p = (ring_hash_lb_policy *)pol;
+  if (GRPC_TRACER_ON(grpc_lb_ring_hash_trace)) {
+    gpr_log(GPR_DEBUG, "[RH %p] Destroying Ring Hash policy at %p",
+            (void *)pol, (void *)pol);
+  }
+  grpc_connectivity_state_destroy(exec_ctx, &p->state_tracker);
+  grpc_subchannel_index_unref();
+  gpr_free(p->hash_header);
+  gpr_free(p);
+}
+
+static void rh_shutdown_locked(grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol) {
+  ring_hash_lb_policy *p = (ring_hash_lb_policy *)pol;
+  if (GRPC_TRACER_ON(grpc_lb_ring_hash_trace)) {
+    gpr_log(GPR_DEBUG, "[RH %p] Shutting down Ring Hash policy at %p",
+            (void *)pol, (void *)pol);
+  }
+  p->shutdown = true;
+  pending_pick *pp;
+  while ((pp = p->pending_picks)) {
+    p->pending_picks = pp->next;
+    *pp->target = NULL;
+    GRPC_CLOSURE_SCHED(
+        exec_ctx, pp->on_complete,
+        GRPC_ERROR_CREATE_FROM_STATIC_STRING("Channel Shutdown"));
+    gpr_free(pp);
+  }
+  grpc_connectivity_state_set(
+      exec_ctx, &p->state_tracker, GRPC_CHANNEL_SHUTDOWN,
+      GRPC_ERROR_CREATE_FROM_STATIC_STRING("Channel Shutdown"), "rh_shutdown");
+  const bool latest_is_current =
+      p->subchannel_list == p->latest_pending_subchannel_list;
+  grpc_lb_subchannel_list_shutdown_and_unref(exec_ctx, p->subchannel_list,
+                                             "sl_shutdown_rh_shutdown");
+  p->subchannel_list = NULL;
+  if (!latest_is_current && p->latest_pending_subchannel_list != NULL &&
+      !p->latest_pending_subchannel_list->shutting_down) {
+    grpc_lb_subchannel_list_shutdown_and_unref(
+        exec_ctx, p->latest_pending_subchannel_list,
+        "sl_shutdown_pending_rh_shutdown");
+    p->latest_pending_subchannel_list = NULL;
+  }
+}
+
+static void rh_cancel_pick_locked(grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol,
+                                  grpc_connected_subchannel **target,
+                                  grpc_error *error) {
+  ring_hash_lb_policy *p = (ring_hash_lb_policy *)pol;
+  pending_pick *pp = p->pending_picks;
+  p->pending_picks = NULL;
+  while (pp != NULL) {
+    pending_pick *next = pp->next;
+    if (pp->target == target) {
+      *target = NULL;
+      GRPC_CLOSURE_SCHED(exec_ctx, pp->on_complete,
+                         GRPC_ERROR_CREATE_REFERENCING_FROM_STATIC_STRING(
+                             "Pick cancelled", &error, 1));
+      gpr_free(pp);
+    } else {
+      pp->next = p->pending_picks;
+      p->pending_picks = pp;
+    }
+    pp = next;
+  }
+  GRPC_ERROR_UNREF(error);
+}
+
+static void rh_cancel_picks_locked(grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol,
+                                   uint32_t initial_metadata_flags_mask,
+                                   uint32_t initial_metadata_flags_eq,
+                                   grpc_error *error) {
+  ring_hash_lb_policy *p = (ring_hash_lb_policy *)pol;
+  pending_pick *pp = p->pending_picks;
+  p->pending_picks = NULL;
+  while (pp != NULL) {
+    pending_pick *next = pp->next;
+    if ((pp->initial_metadata_flags & initial_metadata_flags_mask) ==
+        initial_metadata_flags_eq) {
+      *pp->target = NULL;
+      GRPC_CLOSURE_SCHED(exec_ctx, pp->on_complete,
+                         GRPC_ERROR_CREATE_REFERENCING_FROM_STATIC_STRING(
+                             "Pick cancelled", &error, 1));
+      gpr_free(pp);
+    } else {
+      pp->next = p->pending_picks;
+      p->pending_picks = pp;
+    }
+    pp = next;
+  }
+  GRPC_ERROR_UNREF(error);
+}
+
+static void start_picking_locked(grpc_exec_ctx *exec_ctx,
+                                 ring_hash_lb_policy *p) {
+  p->started_picking = true;
+  for (size_t i = 0; i < p->subchannel_list->num_subchannels; i++) {
+    grpc_lb_subchannel_data *sd = &p->subchannel_list->subchannels[i];
+    grpc_lb_subchannel_list_ref_for_connectivity_watch(sd->subchannel_list,
+                                                       "connectivity_watch");
+    grpc_lb_subchannel_data_start_connectivity_watch(exec_ctx, sd);
+  }
+}
+
+static void rh_exit_idle_locked(grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol) {
+  ring_hash_lb_policy *p = (ring_hash_lb_policy *)pol;
+  if (!p->started_picking) {
+    start_picking_locked(exec_ctx, p);
+  }
+}
+
+/** Returns the hash of the call picking with \a pick_args. */
+static uint32_t call_hash(ring_hash_lb_policy *p,
+                          const grpc_lb_policy_pick_args *pick_args) {
+  if (p->hash_header != NULL && pick_args->initial_metadata != NULL) {
+    for (grpc_linked_mdelem *l = pick_args->initial_metadata->list.head;
+         l != NULL; l = l->next) {
+      if (grpc_slice_str_cmp(GRPC_MDKEY(l->md), p->hash_header) == 0) {
+        const grpc_slice value = GRPC_MDVALUE(l->md);
+        return gpr_murmur_hash3(GRPC_SLICE_START_PTR(value),
+                                GRPC_SLICE_LENGTH(value), 0);
+      }
+    }
+  }
+  return (uint32_t)rand();
+}
+
+/** Completes a pick of \a sd into \a target and \a user_data. */
+static void fill_pick_locked(ring_hash_lb_policy *p,
+                             grpc_lb_subchannel_data *sd,
+                             grpc_connected_subchannel **target,
+                             void **user_data) {
+  *target = GRPC_CONNECTED_SUBCHANNEL_REF(
+      grpc_subchannel_get_connected_subchannel(sd->subchannel), "rh_picked");
+  if (user_data != NULL) {
+    *user_data = sd->user_data;
+  }
+  if (GRPC_TRACER_ON(grpc_lb_ring_hash_trace)) {
+    gpr_log(GPR_DEBUG,
+            "[RH %p] Picked target <-- Subchannel %p (connected %p) (sl %p)",
+            (void *)p, (void *)sd->subchannel, (void *)*target,
+            (void *)sd->subchannel_list);
+  }
+}
+
+static int rh_pick_locked(grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol,
+                          const grpc_lb_policy_pick_args *pick_args,
+                          grpc_connected_subchannel **target,
+                          grpc_call_context_element *context, void **user_data,
+                          grpc_closure *on_complete) {
+  ring_hash_lb_policy *p = (ring_hash_lb_policy *)pol;
+  GPR_ASSERT(!p->shutdown);
+  if (GRPC_TRACER_ON(grpc_lb_ring_hash_trace)) {
+    gpr_log(GPR_INFO, "[RH %p] Trying to pick", (void *)pol);
+  }
+  const uint32_t hash = call_hash(p, pick_args);
+  grpc_lb_subchannel_data *sd = pick_subchannel_locked(p, hash);
+  if (sd != NULL) {
+    /* readily available, report right away */
+    fill_pick_locked(p, sd, target, user_data);
+    return 1;
+  }
+  /* no pick currently available. Save for later in list of pending picks */
+  if (!p->started_picking) {
+    start_picking_locked(exec_ctx, p);
+  }
+  pending_pick *pp = (pending_pick *)gpr_malloc(sizeof(*pp));
+  pp->next = p->pending_picks;
+  pp->target = target;
+  pp->hash = hash;
+  pp->on_complete = on_complete;
+  pp->initial_metadata_flags = pick_args->initial_metadata_flags;
+  pp->user_data = user_data;
+  p->pending_picks = pp;
+  return 0;
+}
+
+/** Sets the policy's connectivity status based on that of the passed-in \a sd
+ * and the subchannel list \a sd belongs to, with the same rules as
+ * round_robin. \a error will only be used upon policy transition to
+ * TRANSIENT_FAILURE or SHUTDOWN. Returns the connectivity status set. */
+static grpc_connectivity_state update_lb_connectivity_status_locked(
+    grpc_exec_ctx *exec_ctx, grpc_lb_subchannel_data *sd, grpc_error *error) {
+  grpc_connectivity_state new_state = sd->curr_connectivity_state;
+  grpc_lb_subchannel_list *subchannel_list = sd->subchannel_list;
+  ring_hash_lb_policy *p = (ring_hash_lb_policy *)subchannel_list->policy;
+  if (subchannel_list->num_ready > 0) { /* 1) READY */
+    grpc_connectivity_state_set(exec_ctx, &p->state_tracker, GRPC_CHANNEL_READY,
+                                GRPC_ERROR_NONE, "rh_ready");
+    new_state = GRPC_CHANNEL_READY;
+  } else if (sd->curr_connectivity_state ==
+             GRPC_CHANNEL_CONNECTING) { /* 2) CONNECTING */
+    grpc_connectivity_state_set(exec_ctx, &p->state_tracker,
+                                GRPC_CHANNEL_CONNECTING, GRPC_ERROR_NONE,
+                                "rh_connecting");
+    new_state = GRPC_CHANNEL_CONNECTING;
+  } else if (p->subchannel_list->num_shutdown ==
+             p->subchannel_list->num_subchannels) { /* 3) SHUTDOWN */
+    grpc_connectivity_state_set(exec_ctx, &p->state_tracker,
+                                GRPC_CHANNEL_SHUTDOWN, GRPC_ERROR_REF(error),
+                                "rh_shutdown");
+    p->shutdown = true;
+    new_state = GRPC_CHANNEL_SHUTDOWN;
+  } else if (subchannel_list->num_transient_failures ==
+             p->subchannel_list->num_subchannels) { /* 4) TRANSIENT_FAILURE */
+    grpc_connectivity_state_set(exec_ctx, &p->state_tracker,
+                                GRPC_CHANNEL_TRANSIENT_FAILURE,
+                                GRPC_ERROR_REF(error), "rh_transient_failure");
+    new_state = GRPC_CHANNEL_TRANSIENT_FAILURE;
+  } else if (subchannel_list->num_idle ==
+             p->subchannel_list->num_subchannels) { /* 5) IDLE */
+    grpc_connectivity_state_set(exec_ctx, &p->state_tracker, GRPC_CHANNEL_IDLE,
+                                GRPC_ERROR_NONE, "rh_idle");
+    new_state = GRPC_CHANNEL_IDLE;
+  }
+  GRPC_ERROR_UNREF(error);
+  return new_state;
+}
+
+static void rh_connectivity_changed_locked(grpc_exec_ctx *exec_ctx, void *arg,
+                                           grpc_error *error) {
+  grpc_lb_subchannel_data *sd = (grpc_lb_subchannel_data *)arg;
+  ring_hash_lb_policy *p = (ring_hash_lb_policy *)sd->subchannel_list->policy;
+  if (GRPC_TRACER_ON(grpc_lb_ring_hash_trace)) {
+    gpr_log(
+        GPR_DEBUG,
+        "[RH %p] connectivity changed for subchannel %p, subchannel_list %p: "
+        "prev_state=%s new_state=%s p->shutdown=%d "
+        "sd->subchannel_list->shutting_down=%d error=%s",
+        (void *)p, (void *)sd->subchannel, (void *)sd->subchannel_list,
+        grpc_connectivity_state_name(sd->prev_connectivity_state),
+        grpc_connectivity_state_name(sd->pending_connectivity_state_unsafe),
+        p->shutdown, sd->subchannel_list->shutting_down,
+        grpc_error_string(error));
+  }
+  // If the policy is shutting down, unref and return.
+  if (p->shutdown) {
+    grpc_lb_subchannel_list_unref_for_connectivity_watch(
+        exec_ctx, sd->subchannel_list, "pol_shutdown");
+    return;
+  }
+  if (sd->subchannel_list->shutting_down && error == GRPC_ERROR_CANCELLED) {
+    // the subchannel list associated with sd has been discarded. This callback
+    // corresponds to the unsubscription. The unrefs correspond to the picking
+    // ref (start_picking_locked or update_started_picking).
+    grpc_lb_subchannel_list_unref_for_connectivity_watch(
+        exec_ctx, sd->subchannel_list, "sl_shutdown");
+    return;
+  }
+  // Dispose of outdated subchannel lists.
+  if (sd->subchannel_list != p->subchannel_list &&
+      sd->subchannel_list != p->latest_pending_subchannel_list) {
+    if (!sd->subchannel_list->shutting_down) {
+      grpc_lb_subchannel_list_shutdown_and_unref(exec_ctx, sd->subchannel_list,
+                                                 "sl_outdated");
+    }
+    grpc_lb_subchannel_list_unref_for_connectivity_watch(
+        exec_ctx, sd->subchannel_list, "sl_outdated");
+    return;
+  }
+  // Update state counters and determine new overall state.
+  grpc_lb_subchannel_data_update_connectivity_state_locked(sd);
+  const grpc_connectivity_state new_policy_connectivity_state =
+      update_lb_connectivity_status_locked(exec_ctx, sd, GRPC_ERROR_REF(error));
+  // If the sd's new state is SHUTDOWN, unref the subchannel, and if the new
+  // policy's state is SHUTDOWN, clean up.
+  if (sd->curr_connectivity_state == GRPC_CHANNEL_SHUTDOWN) {
+    grpc_lb_subchannel_data_unref_subchannel(exec_ctx, sd,
+                                             "rh_subchannel_shutdown");
+    if (new_policy_connectivity_state == GRPC_CHANNEL_SHUTDOWN) {
+      // the policy is shutting down. Flush all the pending picks...
+      pending_pick *pp;
+      while ((pp = p->pending_picks)) {
+        p->pending_picks = pp->next;
+        *pp->target = NULL;
+        GRPC_CLOSURE_SCHED(exec_ctx, pp->on_complete, GRPC_ERROR_NONE);
+        gpr_free(pp);
+      }
+    }
+    grpc_lb_subchannel_list_unref_for_connectivity_watch(
+        exec_ctx, sd->subchannel_list, "sd_shutdown");
+  } else {  // sd not in SHUTDOWN
+    if (sd->curr_connectivity_state == GRPC_CHANNEL_READY) {
+      if (sd->subchannel_list != p->subchannel_list) {
+        // promote sd->subchannel_list to p->subchannel_list.
+        // sd->subchannel_list must be equal to
+        // p->latest_pending_subchannel_list because we have already filtered
+        // for sds belonging to outdated subchannel lists.
+        GPR_ASSERT(sd->subchannel_list == p->latest_pending_subchannel_list);
+        GPR_ASSERT(!sd->subchannel_list->shutting_down);
+        if (GRPC_TRACER_ON(grpc_lb_ring_hash_trace)) {
+          gpr_log(GPR_DEBUG,
+                  "[RH %p] phasing out subchannel list %p in favor of %p",
+                  (void *)p, (void *)p->subchannel_list,
+                  (void *)sd->subchannel_list);
+        }
+        if (p->subchannel_list != NULL) {
+          // dispose of the current subchannel_list
+          grpc_lb_subchannel_list_shutdown_and_unref(
+              exec_ctx, p->subchannel_list, "sl_phase_out_shutdown");
+        }
+        p->subchannel_list = p->latest_pending_subchannel_list;
+        p->latest_pending_subchannel_list = NULL;
+      }
+      /* at this point we know there's at least one suitable subchannel.
+       * Serve the pending picks, each one by its hash. */
+      pending_pick *pp;
+      while ((pp = p->pending_picks)) {
+        p->pending_picks = pp->next;
+        grpc_lb_subchannel_data *selected =
+            pick_subchannel_locked(p, pp->hash);
+        GPR_ASSERT(selected != NULL);
+        fill_pick_locked(p, selected, pp->target, pp->user_data);
+        GRPC_CLOSURE_SCHED(exec_ctx, pp->on_complete, GRPC_ERROR_NONE);
+        gpr_free(pp);
+      }
+    }
+    /* renew notification: reuses the connectivity watch refs on the policy
+     * and on sd->subchannel_list. */
+    grpc_lb_subchannel_data_start_connectivity_watch(exec_ctx, sd);
+  }
+}
+
+static grpc_connectivity_state rh_check_connectivity_locked(
+    grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol, grpc_error **error) {
+  ring_hash_lb_policy *p = (ring_hash_lb_policy *)pol;
+  return grpc_connectivity_state_get(&p->state_tracker, error);
+}
+
+static void rh_notify_on_state_change_locked(grpc_exec_ctx *exec_ctx,
+                                             grpc_lb_policy *pol,
+                                             grpc_connectivity_state *current,
+                                             grpc_closure *notify) {
+  ring_hash_lb_policy *p = (ring_hash_lb_policy *)pol;
+  grpc_connectivity_state_notify_on_state_change(exec_ctx, &p->state_tracker,
+                                                 current, notify);
+}
+
+static void rh_ping_one_locked(grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol,
+                               grpc_closure *closure) {
+  ring_hash_lb_policy *p = (ring_hash_lb_policy *)pol;
+  grpc_lb_subchannel_data *selected =
+      pick_subchannel_locked(p, (uint32_t)rand());
+  if (selected != NULL) {
+    grpc_connected_subchannel *target = GRPC_CONNECTED_SUBCHANNEL_REF(
+        grpc_subchannel_get_connected_subchannel(selected->subchannel),
+        "rh_picked");
+    grpc_connected_subchannel_ping(exec_ctx, target, closure);
+    GRPC_CONNECTED_SUBCHANNEL_UNREF(exec_ctx, target, "rh_picked");
+  } else {
+    GRPC_CLOSURE_SCHED(exec_ctx, closure, GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+                                              "Ring Hash not connected"));
+  }
+}
+
+static int ring_entry_cmp(const void *a, const void *b) {
+  const ring_entry *ea = (const ring_entry *)a;
+  const ring_entry *eb = (const ring_entry *)b;
+  return GPR_ICMP(ea->hash, eb->hash);
+}
+
+/** Builds the ring of \a subchannel_list, whose subchannels were created for
+ * \a addresses. */
+static rh_ring *rh_ring_create(const grpc_lb_subchannel_list *subchannel_list,
+                               const grpc_lb_addresses *addresses) {
+  rh_ring *ring = (rh_ring *)gpr_zalloc(sizeof(*ring));
+  ring->entries = (ring_entry *)gpr_malloc(sizeof(ring_entry) *
+                                           RING_HASH_POINTS_PER_SUBCHANNEL *
+                                           subchannel_list->num_subchannels);
+  for (size_t i = 0; i < subchannel_list->num_subchannels; i++) {
+    const grpc_resolved_address *address =
+        &addresses->addresses[subchannel_list->subchannels[i].address_index]
+             .address;
+    for (uint32_t j = 0; j < RING_HASH_POINTS_PER_SUBCHANNEL; j++) {
+      ring_entry *entry = &ring->entries[ring->size++];
+      entry->hash = gpr_murmur_hash3(address->addr, address->len, j);
+      entry->subchannel_index = i;
+    }
+  }
+  qsort(ring->entries, ring->size, sizeof(ring_entry), ring_entry_cmp);
+  return ring;
+}
+
+static void rh_update_locked(grpc_exec_ctx *exec_ctx, grpc_lb_policy *policy,
+                             const grpc_lb_policy_args *args) {
+  ring_hash_lb_policy *p = (ring_hash_lb_policy *)policy;
+  const grpc_arg *arg =
+      grpc_channel_args_find(args->args, GRPC_ARG_LB_ADDRESSES);
+  if (arg == NULL || arg->type != GRPC_ARG_POINTER) {
+    if (p->subchannel_list == NULL) {
+      // If we don't have a current subchannel list, go into TRANSIENT FAILURE.
+      grpc_connectivity_state_set(
+          exec_ctx, &p->state_tracker, GRPC_CHANNEL_TRANSIENT_FAILURE,
+          GRPC_ERROR_CREATE_FROM_STATIC_STRING("Missing update in args"),
+          "rh_update_missing");
+    } else {
+      // otherwise, keep using the current subchannel list (ignore this update).
+      gpr_log(GPR_ERROR,
+              "[RH %p] No valid LB addresses channel arg for update, ignoring.",
+              (void *)p);
+    }
+    return;
+  }
+  grpc_lb_addresses *addresses = (grpc_lb_addresses *)arg->value.pointer.p;
+  grpc_lb_subchannel_list *subchannel_list = grpc_lb_subchannel_list_create(
+      exec_ctx, &p->base, &grpc_lb_ring_hash_trace, addresses, args,
+      rh_connectivity_changed_locked);
+  subchannel_list->policy_data = rh_ring_create(subchannel_list, addresses);
+  subchannel_list->destroy_policy_data = rh_ring_destroy;
+  if (subchannel_list->num_subchannels == 0) {
+    grpc_connectivity_state_set(
+        exec_ctx, &p->state_tracker, GRPC_CHANNEL_TRANSIENT_FAILURE,
+        GRPC_ERROR_CREATE_FROM_STATIC_STRING("Empty update"),
+        "rh_update_empty");
+    if (p->subchannel_list != NULL) {
+      grpc_lb_subchannel_list_shutdown_and_unref(exec_ctx, p->subchannel_list,
+                                                 "sl_shutdown_empty_update");
+    }
+    p->subchannel_list = subchannel_list;  // empty list
+    return;
+  }
+  if (p->started_picking) {
+    if (p->latest_pending_subchannel_list != NULL) {
+      if (GRPC_TRACER_ON(grpc_lb_ring_hash_trace)) {
+        gpr_log(GPR_DEBUG,
+                "[RH %p] Shutting down latest pending subchannel list %p, "
+                "about to be replaced by newer latest %p",
+                (void *)p, (void *)p->latest_pending_subchannel_list,
+                (void *)subchannel_list);
+      }
+      grpc_lb_subchannel_list_shutdown_and_unref(
+          exec_ctx, p->latest_pending_subchannel_list,
+          "sl_outdated_dont_smash");
+    }
+    p->latest_pending_subchannel_list = subchannel_list;
+    for (size_t i = 0; i < subchannel_list->num_subchannels; ++i) {
+      /* Watch every new subchannel. A subchannel list becomes active the
+       * moment one of its subchannels is READY. At that moment, we swap
+       * p->subchannel_list for sd->subchannel_list, provided the subchannel
+       * list is still valid (ie, isn't shutting down) */
+      grpc_lb_subchannel_list_ref_for_connectivity_watch(subchannel_list,
+                                                         "connectivity_watch");
+      grpc_lb_subchannel_data_start_connectivity_watch(
+          exec_ctx, &subchannel_list->subchannels[i]);
+    }
+  } else {
+    // The policy isn't picking yet. Save the update for later, disposing of
+    // previous version if any.
+    if (p->subchannel_list != NULL) {
+      grpc_lb_subchannel_list_shutdown_and_unref(
+          exec_ctx, p->subchannel_list, "rh_update_before_started_picking");
+    }
+    p->subchannel_list = subchannel_list;
+  }
+}
+
+static const grpc_lb_policy_vtable ring_hash_lb_policy_vtable = {
+    rh_destroy,
+    rh_shutdown_locked,
+    rh_pick_locked,
+    rh_cancel_pick_locked,
+    rh_cancel_picks_locked,
+    rh_ping_one_locked,
+    rh_exit_idle_locked,
+    rh_check_connectivity_locked,
+    rh_notify_on_state_change_locked,
+    rh_update_locked};
+
+static void ring_hash_factory_ref(grpc_lb_policy_factory *factory) {}
+
+static void ring_hash_factory_unref(grpc_lb_policy_factory *factory) {}
+
+static grpc_lb_policy *ring_hash_create(grpc_exec_ctx *exec_ctx,
+                                            grpc_lb_policy_factory *factory,
+                                            grpc_lb_policy_args *args) {
+  GPR_ASSERT(args->client_channel_factory != NULL);
+  ring_hash_lb_policy *p =
+      (ring_hash_lb_policy *)gpr_zalloc(sizeof(*p));
+  grpc_lb_policy_init(&p->base, &ring_hash_lb_policy_vtable,
+                      args->combiner);
+  grpc_subchannel_index_ref();
+  grpc_connectivity_state_init(&p->state_tracker, GRPC_CHANNEL_IDLE,
+                               "ring_hash");
+  const grpc_arg *header_arg =
+      grpc_channel_args_find(args->args, GRPC_ARG_RING_HASH_HEADER);
+  if (header_arg != NULL && header_arg->type == GRPC_ARG_STRING) {
+    p->hash_header = gpr_strdup(header_arg->value.string);
+  }
+  rh_update_locked(exec_ctx, &p->base, args);
+  if (GRPC_TRACER_ON(grpc_lb_ring_hash_trace)) {
+    gpr_log(GPR_DEBUG, "[RH %p] Created with %lu subchannels", (void *)p,
+            (unsigned long)p->subchannel_list->num_subchannels);
+  }
+  return &p->base;
+}
+
+static const grpc_lb_policy_factory_vtable ring_hash_factory_vtable = {
+    ring_hash_factory_ref, ring_hash_factory_unref,
+    ring_hash_create, "ring_hash"};
+
+static grpc_lb_policy_factory ring_hash_lb_policy_factory = {
+    &ring_hash_factory_vtable};
+
+static grpc_lb_policy_factory *ring_hash_lb_factory_create() {
+  return &ring_hash_lb_policy_factory;
+}
+
+/* Plugin registration */
+
+void grpc_lb_policy_ring_hash_init() {
+  grpc_register_lb_policy(ring_hash_lb_factory_create());
+  grpc_register_tracer(&grpc_lb_ring_hash_trace);
+}
+
+void grpc_lb_policy_ring_hash_shutdown() {}
\ No newline at end of file
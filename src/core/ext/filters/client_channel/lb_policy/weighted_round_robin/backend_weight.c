@@ -0,0 +1,79 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/ext/filters/client_channel/lb_policy/weighted_round_robin/backend_weight.h"
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/sync.h>
+#include <grpc/support/useful.h>
+
+struct grpc_wrr_backend_weight {
+  gpr_refcount refs;
+  gpr_mu mu;
+  /** weight computed from the last report, or 0 if none had traffic */
+  double weight;
+  /** when the last report was received */
+  gpr_timespec last_update_time;
+};
+
+grpc_wrr_backend_weight *grpc_wrr_backend_weight_create(void) {
+  grpc_wrr_backend_weight *weight =
+      (grpc_wrr_backend_weight *)gpr_zalloc(sizeof(*weight));
+  gpr_ref_init(&weight->refs, 1);
+  gpr_mu_init(&weight->mu);
+  weight->last_update_time = gpr_inf_past(GPR_CLOCK_MONOTONIC);
+  return weight;
+}
+
+grpc_wrr_backend_weight *grpc_wrr_backend_weight_ref(
+    grpc_wrr_backend_weight *weight) {
+  gpr_ref_non_zero(&weight->refs);
+  return weight;
+}
+
+void grpc_wrr_backend_weight_unref(grpc_wrr_backend_weight *weight) {
+  if (gpr_unref(&weight->refs)) {
+    gpr_mu_destroy(&weight->mu);
+    gpr_free(weight);
+  }
+}
+
+void grpc_wrr_backend_weight_update(grpc_wrr_backend_weight *weight,
+                                    const grpc_load_report *report,
+                                    gpr_timespec now) {
+  // A backend too idle to register any utilization counts as 0.1% busy.
+  const double utilization =
+      (double)GPR_MAX(report->utilization_permille, 1) / 1000;
+  gpr_mu_lock(&weight->mu);
+  weight->weight = report->qps / utilization;
+  weight->last_update_time = now;
+  gpr_mu_unlock(&weight->mu);
+}
+
+double grpc_wrr_backend_weight_get(grpc_wrr_backend_weight *weight,
+                                   gpr_timespec now, int expiration_ms) {
+  const gpr_timespec expiration =
+      gpr_time_from_millis(expiration_ms, GPR_TIMESPAN);
+  gpr_mu_lock(&weight->mu);
+  const double result =
+      gpr_time_cmp(gpr_time_add(weight->last_update_time, expiration), now) < 0
+          ? 0
+          : weight->weight;
+  gpr_mu_unlock(&weight->mu);
+  return result;
+}
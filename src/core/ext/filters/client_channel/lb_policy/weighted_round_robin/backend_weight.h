@@ -0,0 +1,48 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_EXT_FILTERS_CLIENT_CHANNEL_LB_POLICY_WEIGHTED_ROUND_ROBIN_BACKEND_WEIGHT_H
+#define GRPC_CORE_EXT_FILTERS_CLIENT_CHANNEL_LB_POLICY_WEIGHTED_ROUND_ROBIN_BACKEND_WEIGHT_H
+
+#include <grpc/support/time.h>
+
+#include "src/core/lib/transport/load_report_encoding.h"
+
+/** Weight of a backend, derived from the load reports in the trailing
+ * metadata of the calls sent to it. Shared by the weighted_round_robin policy
+ * and the calls it picks, which update it from outside the combiner. */
+typedef struct grpc_wrr_backend_weight grpc_wrr_backend_weight;
+
+grpc_wrr_backend_weight *grpc_wrr_backend_weight_create(void);
+grpc_wrr_backend_weight *grpc_wrr_backend_weight_ref(
+    grpc_wrr_backend_weight *weight);
+void grpc_wrr_backend_weight_unref(grpc_wrr_backend_weight *weight);
+
+/** Records \a report, received at \a now (GPR_CLOCK_MONOTONIC). */
+void grpc_wrr_backend_weight_update(grpc_wrr_backend_weight *weight,
+                                    const grpc_load_report *report,
+                                    gpr_timespec now);
+
+/** Returns the queries per second the backend serves per unit of CPU
+ * utilization, or 0 if it has not reported a load with some traffic in the
+ * last \a expiration_ms before \a now. */
+double grpc_wrr_backend_weight_get(grpc_wrr_backend_weight *weight,
+                                   gpr_timespec now, int expiration_ms);
+
+#endif /* GRPC_CORE_EXT_FILTERS_CLIENT_CHANNEL_LB_POLICY_WEIGHTED_ROUND_ROBIN_BACKEND_WEIGHT_H \
+          */
@@ -0,0 +1,118 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/ext/filters/client_channel/lb_policy/weighted_round_robin/load_report_filter.h"
+
+#include "src/core/ext/filters/client_channel/lb_policy/weighted_round_robin/backend_weight.h"
+#include "src/core/lib/iomgr/error.h"
+#include "src/core/lib/profiling/timers.h"
+#include "src/core/lib/slice/slice_internal.h"
+#include "src/core/lib/transport/metadata_batch.h"
+
+static grpc_error *init_channel_elem(grpc_exec_ctx *exec_ctx,
+                                     grpc_channel_element *elem,
+                                     grpc_channel_element_args *args) {
+  return GRPC_ERROR_NONE;
+}
+
+static void destroy_channel_elem(grpc_exec_ctx *exec_ctx,
+                                 grpc_channel_element *elem) {}
+
+typedef struct {
+  // Weight to update, or NULL if the call was not picked with a tracker.
+  grpc_wrr_backend_weight *weight;
+  // State for intercepting recv_trailing_metadata.
+  grpc_metadata_batch *recv_trailing_metadata;
+  grpc_closure on_complete_for_recv;
+  grpc_closure *original_on_complete_for_recv;
+} call_data;
+
+static void on_complete_for_recv(grpc_exec_ctx *exec_ctx, void *arg,
+                                 grpc_error *error) {
+  call_data *calld = (call_data *)arg;
+  if (error == GRPC_ERROR_NONE) {
+    for (grpc_linked_mdelem *l = calld->recv_trailing_metadata->list.head;
+         l != NULL; l = l->next) {
+      if (grpc_slice_str_cmp(GRPC_MDKEY(l->md), GRPC_LOAD_REPORT_KEY) == 0) {
+        grpc_load_report report;
+        if (grpc_load_report_decode(GRPC_MDVALUE(l->md), &report)) {
+          grpc_wrr_backend_weight_update(calld->weight, &report,
+                                         gpr_now(GPR_CLOCK_MONOTONIC));
+        }
+        break;
+      }
+    }
+  }
+  GRPC_CLOSURE_RUN(exec_ctx, calld->original_on_complete_for_recv,
+                   GRPC_ERROR_REF(error));
+}
+
+static grpc_error *init_call_elem(grpc_exec_ctx *exec_ctx,
+                                  grpc_call_element *elem,
+                                  const grpc_call_element_args *args) {
+  call_data *calld = (call_data *)elem->call_data;
+  // Get the weight from the context and take a ref.
+  if (args->context != NULL &&
+      args->context[GRPC_CONTEXT_LB_CALL_TRACKER].value != NULL) {
+    calld->weight = grpc_wrr_backend_weight_ref(
+        (grpc_wrr_backend_weight *)args->context[GRPC_CONTEXT_LB_CALL_TRACKER]
+            .value);
+  }
+  return GRPC_ERROR_NONE;
+}
+
+static void destroy_call_elem(grpc_exec_ctx *exec_ctx, grpc_call_element *elem,
+                              const grpc_call_final_info *final_info,
+                              grpc_closure *ignored) {
+  call_data *calld = (call_data *)elem->call_data;
+  if (calld->weight != NULL) {
+    grpc_wrr_backend_weight_unref(calld->weight);
+  }
+}
+
+static void start_transport_stream_op_batch(
+    grpc_exec_ctx *exec_ctx, grpc_call_element *elem,
+    grpc_transport_stream_op_batch *batch) {
+  call_data *calld = (call_data *)elem->call_data;
+  GPR_TIMER_BEGIN("wrr_lr_start_transport_stream_op_batch", 0);
+  // Intercept recv_trailing_metadata, which is ready on completion.
+  if (batch->recv_trailing_metadata && calld->weight != NULL) {
+    calld->recv_trailing_metadata =
+        batch->payload->recv_trailing_metadata.recv_trailing_metadata;
+    calld->original_on_complete_for_recv = batch->on_complete;
+    GRPC_CLOSURE_INIT(&calld->on_complete_for_recv, on_complete_for_recv,
+                      calld, grpc_schedule_on_exec_ctx);
+    batch->on_complete = &calld->on_complete_for_recv;
+  }
+  // Chain to next filter.
+  grpc_call_next_op(exec_ctx, elem, batch);
+  GPR_TIMER_END("wrr_lr_start_transport_stream_op_batch", 0);
+}
+
+const grpc_channel_filter grpc_wrr_load_report_filter = {
+    start_transport_stream_op_batch,
+    grpc_channel_next_op,
+    sizeof(call_data),
+    init_call_elem,
+    grpc_call_stack_ignore_set_pollset_or_pollset_set,
+    destroy_call_elem,
+    0,  // sizeof(channel_data)
+    init_channel_elem,
+    destroy_channel_elem,
+    grpc_channel_next_get_info,
+    "wrr_load_report"};
@@ -0,0 +1,809 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/** Weighted Round Robin Policy.
+ *
+ * Round robin over the READY subchannels, with each subchannel weighted by
+ * the queries per second its server serves per unit of CPU utilization, as
+ * reported by the server's load reporting filter in the trailing metadata of
+ * calls (see load_report_encoding.h). The load_report_filter feeds those
+ * reports to the subchannel's grpc_wrr_backend_weight, which the pick places
+ * in the GRPC_CONTEXT_LB_CALL_TRACKER context element of the call.
+ *
+ * Picks follow an earliest deadline first schedule, in which a subchannel of
+ * weight w is due every mean_weight / w picks, which interleaves the
+ * subchannels smoothly. Subchannels without a report in the last
+ * GRPC_ARG_WEIGHTED_ROUND_ROBIN_WEIGHT_EXPIRATION_MS get the mean weight of
+ * the others, so a channel without reports degrades to round robin. The
+ * schedule is rebuilt from the current weights every second.
+ *
+ * Subchannel list management follows round_robin. Every list keeps the
+ * weights of its subchannels as policy data. Weights follow a subchannel
+ * across updates that keep it. */
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <grpc/support/alloc.h>
+
+#include "src/core/ext/filters/client_channel/lb_policy/subchannel_list.h"
+#include "src/core/ext/filters/client_channel/lb_policy/weighted_round_robin/backend_weight.h"
+#include "src/core/ext/filters/client_channel/lb_policy/weighted_round_robin/load_report_filter.h"
+#include "src/core/ext/filters/client_channel/lb_policy_registry.h"
+#include "src/core/ext/filters/client_channel/subchannel.h"
+#include "src/core/ext/filters/client_channel/subchannel_index.h"
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/debug/trace.h"
+#include "src/core/lib/surface/channel_init.h"
+#include "src/core/lib/transport/connectivity_state.h"
+
+grpc_tracer_flag grpc_lb_weighted_round_robin_trace =
+    GRPC_TRACER_INITIALIZER(false, "weighted_round_robin");
+
+#define DEFAULT_WEIGHT_EXPIRATION_MS 10000
+/** How often the schedule picks up new weights. */
+#define SCHEDULE_UPDATE_INTERVAL_MS 1000
+
+/** Destroy function of the GRPC_CONTEXT_LB_CALL_TRACKER context element. */
+static void wrr_call_tracker_destroy(void *arg) {
+  grpc_wrr_backend_weight_unref((grpc_wrr_backend_weight *)arg);
+}
+
+/** Has the load_report_filter of the call of \a context report to \a weight
+ * until the client channel destroys \a context. */
+static void wrr_track_call(grpc_wrr_backend_weight *weight,
+                           grpc_call_context_element *context) {
+  if (context == NULL) return;
+  context[GRPC_CONTEXT_LB_CALL_TRACKER].value =
+      grpc_wrr_backend_weight_ref(weight);
+  context[GRPC_CONTEXT_LB_CALL_TRACKER].destroy = wrr_call_tracker_destroy;
+}
+
+/** Entry of the pick schedule. */
+typedef struct {
+  /** in picks, since the schedule was built */
+  double deadline;
+  /** picks between two picks of the subchannel */
+  double period;
+  /** of the subchannel in the subchannel list */
+  size_t index;
+} schedule_entry;
+
+/** List of entities waiting for a pick.
+ *
+ * Once a pick is available, \a target is updated and \a on_complete called. */
+typedef struct pending_pick {
+  struct pending_pick *next;
+
+  /* output argument where to store the pick()ed user_data. It'll be NULL if no
+   * such data is present or there's an error (the definite test for errors is
+   * \a target being NULL). */
+  void **user_data;
+
+  /* bitmask passed to pick() and used for selective cancelling. See
+   * grpc_lb_policy_cancel_picks() */
+  uint32_t initial_metadata_flags;
+
+  /* output argument where to store the pick()ed connected subchannel, or NULL
+   * upon error. */
+  grpc_connected_subchannel **target;
+
+  /* call context of the pick, where the call tracker goes */
+  grpc_call_context_element *context;
+
+  /* to be invoked once the pick() has completed (regardless of success) */
+  grpc_closure *on_complete;
+} pending_pick;
+
+typedef struct weighted_round_robin_lb_policy {
+  /** base policy: must be first */
+  grpc_lb_policy base;
+
+  grpc_lb_subchannel_list *subchannel_list;
+
+  /** have we started picking? */
+  bool started_picking;
+  /** are we shutting down? */
+  bool shutdown;
+  /** List of picks that are waiting on connectivity */
+  pending_pick *pending_picks;
+
+  /** our connectivity state tracker */
+  grpc_connectivity_state_tracker state_tracker;
+
+  /** Latest version of the subchannel list.
+   * Subchannel connectivity callbacks will only promote updated subchannel
+   * lists if they equal \a latest_pending_subchannel_list. In other words,
+   * racing callbacks that reference outdated subchannel lists won't perform any
+   * update. */
+  grpc_lb_subchannel_list *latest_pending_subchannel_list;
+
+  /** how long a load report weighs on the schedule */
+  int weight_expiration_ms;
+  /** min-heap by deadline of the READY subchannels of \a subchannel_list,
+   * valid if \a schedule_valid */
+  schedule_entry *schedule;
+  size_t num_scheduled;
+  bool schedule_valid;
+  /** when to rebuild the schedule with new weights */
+  gpr_timespec next_schedule_update;
+} weighted_round_robin_lb_policy;
+
+/** State weighted_round_robin keeps per subchannel list. */
+typedef struct {
+  /** weight of each subchannel of the list, by index */
+  grpc_wrr_backend_weight **weights;
+  size_t num_subchannels;
+} wrr_subchannel_list_data;
+
+static void wrr_subchannel_list_data_destroy(void *arg) {
+  wrr_subchannel_list_data *data = (wrr_subchannel_list_data *)arg;
+  for (size_t i = 0; i < data->num_subchannels; i++) {
+    grpc_wrr_backend_weight_unref(data->weights[i]);
+  }
+  gpr_free(data->weights);
+  gpr_free(data);
+}
+
+static grpc_wrr_backend_weight *subchannel_weight(
+    const grpc_lb_subchannel_data *sd) {
+  const wrr_subchannel_list_data *data =
+      (const wrr_subchannel_list_data *)sd->subchannel_list->policy_data;
+  return data->weights[sd - sd->subchannel_list->subchannels];
+}
+
+static bool schedule_entry_before(const schedule_entry *a,
+                                  const schedule_entry *b) {
+  return a->deadline < b->deadline ||
+         (a->deadline == b->deadline && a->index < b->index);
+}
+
+static void schedule_sift_up_locked(weighted_round_robin_lb_policy *p,
+                                    size_t i) {
+  while (i > 0) {
+    const size_t parent = (i - 1) / 2;
+    if (!schedule_entry_before(&p->schedule[i], &p->schedule[parent])) break;
+    const schedule_entry tmp = p->schedule[i];
+    p->schedule[i] = p->schedule[parent];
+    p->schedule[parent] = tmp;
+    i = parent;
+  }
+}
+
+static void schedule_sift_down_locked(weighted_round_robin_lb_policy *p,
+                                      size_t i) {
+  for (;;) {
+    size_t first = i;
+    const size_t left = 2 * i + 1;
+    const size_t right = left + 1;
+    if (left < p->num_scheduled &&
+        schedule_entry_before(&p->schedule[left], &p->schedule[first])) {
+      first = left;
+    }
+    if (right < p->num_scheduled &&
+        schedule_entry_before(&p->schedule[right], &p->schedule[first])) {
+      first = right;
+    }
+    if (first == i) break;
+    const schedule_entry tmp = p->schedule[i];
+    p->schedule[i] = p->schedule[first];
+    p->schedule[first] = tmp;
+    i = first;
+  }
+}
+
+/** Schedules the READY subchannels of \a p->subchannel_list by their weights
+ * at \a now. */
+static void build_schedule_locked(weighted_round_robin_lb_policy *p,
+                                  gpr_timespec now) {
+  grpc_lb_subchannel_list *subchannel_list = p->subchannel_list;
+  p->schedule = (schedule_entry *)gpr_realloc(
+      p->schedule, sizeof(schedule_entry) * subchannel_list->num_subchannels);
+  p->num_scheduled = 0;
+  double total_weight = 0;
+  size_t num_weighted = 0;
+  for (size_t i = 0; i < subchannel_list->num_subchannels; i++) {
+    grpc_lb_subchannel_data *sd = &subchannel_list->subchannels[i];
+    if (sd->curr_connectivity_state != GRPC_CHANNEL_READY) continue;
+    // Stash the weight in the period until the mean is known.
+    const double weight = grpc_wrr_backend_weight_get(
+        subchannel_weight(sd), now, p->weight_expiration_ms);
+    if (weight > 0) {
+      total_weight += weight;
+      ++num_weighted;
+    }
+    schedule_entry *entry = &p->schedule[p->num_scheduled++];
+    entry->period = weight;
+    entry->index = i;
+  }
+  const double mean_weight =
+      num_weighted > 0 ? total_weight / (double)num_weighted : 1;
+  for (size_t i = 0; i < p->num_scheduled; i++) {
+    schedule_entry *entry = &p->schedule[i];
+    entry->period = entry->period > 0 ? mean_weight / entry->period : 1;
+    // Start at a random phase, so that clients don't pick in lockstep.
+    entry->deadline = entry->period * rand() / ((double)RAND_MAX + 1);
+    schedule_sift_up_locked(p, i);
+  }
+  if (GRPC_TRACER_ON(grpc_lb_weighted_round_robin_trace)) {
+    gpr_log(GPR_DEBUG,
+            "[WRR %p] Scheduled %lu subchannels, %lu of them weighted, mean "
+            "weight %f",
+            (void *)p, (unsigned long)p->num_scheduled,
+            (unsigned long)num_weighted, mean_weight);
+  }
+  p->schedule_valid = true;
+  p->next_schedule_update = gpr_time_add(
+      now, gpr_time_from_millis(SCHEDULE_UPDATE_INTERVAL_MS, GPR_TIMESPAN));
+}
+
+/** Returns the READY subchannel next due in the schedule, or NULL if no
+ * subchannel is READY. */
+static grpc_lb_subchannel_data *pick_subchannel_locked(
+    weighted_round_robin_lb_policy *p) {
+  grpc_lb_subchannel_list *subchannel_list = p->subchannel_list;
+  if (subchannel_list == NULL || subchannel_list->num_ready == 0) return NULL;
+  const gpr_timespec now = gpr_now(GPR_CLOCK_MONOTONIC);
+  if (!p->schedule_valid || gpr_time_cmp(now, p->next_schedule_update) >= 0) {
+    build_schedule_locked(p, now);
+  }
+  GPR_ASSERT(p->num_scheduled > 0);
+  schedule_entry *first = &p->schedule[0];
+  grpc_lb_subchannel_data *sd = &subchannel_list->subchannels[first->index];
+  GPR_ASSERT(sd->curr_connectivity_state == GRPC_CHANNEL_READY);
+  first->deadline += first->period;
+  schedule_sift_down_locked(p, 0);
+  return sd;
+}
+
+static void wrr_destroy(grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol) {
+  weighted_round_robin_lb_policy *p = (weighted_round_robin_lb_policy *)pol;
+  if (GRPC_TRACER_ON(grpc_lb_weighted_round_robin_trace)) {
+    gpr_log(GPR_DEBUG, "[WRR %p] Destroying Weighted Round Robin policy at %p",
+            (void *)pol, (void *)pol);
+  }
+  grpc_connectivity_state_destroy(exec_ctx, &p->state_tracker);
+  grpc_subchannel_index_unref();
+  gpr_free(p->schedule);
+  gpr_free(p);
+}
+
+static void wrr_shutdown_locked(grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol) {
+  weighted_round_robin_lb_policy *p = (weighted_round_robin_lb_policy *)pol;
+  if (GRPC_TRACER_ON(grpc_lb_weighted_round_robin_trace)) {
+    gpr_log(GPR_DEBUG,
+            "[WRR %p] Shutting down Weighted Round Robin policy at %p",
+            (void *)pol, (void *)pol);
+  }
+  p->shutdown = true;
+  pending_pick *pp;
+  while ((pp = p->pending_picks)) {
+    p->pending_picks = pp->next;
+    *pp->target = NULL;
+    GRPC_CLOSURE_SCHED(
+        exec_ctx, pp->on_complete,
+        GRPC_ERROR_CREATE_FROM_STATIC_STRING("Channel Shutdown"));
+    gpr_free(pp);
+  }
+  grpc_connectivity_state_set(
+      exec_ctx, &p->state_tracker, GRPC_CHANNEL_SHUTDOWN,
+      GRPC_ERROR_CREATE_FROM_STATIC_STRING("Channel Shutdown"), "wrr_shutdown");
+  const bool latest_is_current =
+      p->subchannel_list == p->latest_pending_subchannel_list;
+  grpc_lb_subchannel_list_shutdown_and_unref(exec_ctx, p->subchannel_list,
+                                             "sl_shutdown_wrr_shutdown");
+  p->subchannel_list = NULL;
+  if (!latest_is_current && p->latest_pending_subchannel_list != NULL &&
+      !p->latest_pending_subchannel_list->shutting_down) {
+    grpc_lb_subchannel_list_shutdown_and_unref(
+        exec_ctx, p->latest_pending_subchannel_list,
+        "sl_shutdown_pending_wrr_shutdown");
+    p->latest_pending_subchannel_list = NULL;
+  }
+}
+
+static void wrr_cancel_pick_locked(grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol,
+                                   grpc_connected_subchannel **target,
+                                   grpc_error *error) {
+  weighted_round_robin_lb_policy *p = (weighted_round_robin_lb_policy *)pol;
+  pending_pick *pp = p->pending_picks;
+  p->pending_picks = NULL;
+  while (pp != NULL) {
+    pending_pick *next = pp->next;
+    if (pp->target == target) {
+      *target = NULL;
+      GRPC_CLOSURE_SCHED(exec_ctx, pp->on_complete,
+                         GRPC_ERROR_CREATE_REFERENCING_FROM_STATIC_STRING(
+                             "Pick cancelled", &error, 1));
+      gpr_free(pp);
+    } else {
+      pp->next = p->pending_picks;
+      p->pending_picks = pp;
+    }
+    pp = next;
+  }
+  GRPC_ERROR_UNREF(error);
+}
+
+static void wrr_cancel_picks_locked(grpc_exec_ctx *exec_ctx,
+                                    grpc_lb_policy *pol,
+                                    uint32_t initial_metadata_flags_mask,
+                                    uint32_t initial_metadata_flags_eq,
+                                    grpc_error *error) {
+  weighted_round_robin_lb_policy *p = (weighted_round_robin_lb_policy *)pol;
+  pending_pick *pp = p->pending_picks;
+  p->pending_picks = NULL;
+  while (pp != NULL) {
+    pending_pick *next = pp->next;
+    if ((pp->initial_metadata_flags & initial_metadata_flags_mask) ==
+        initial_metadata_flags_eq) {
+      *pp->target = NULL;
+      GRPC_CLOSURE_SCHED(exec_ctx, pp->on_complete,
+                         GRPC_ERROR_CREATE_REFERENCING_FROM_STATIC_STRING(
+                             "Pick cancelled", &error, 1));
+      gpr_free(pp);
+    } else {
+      pp->next = p->pending_picks;
+      p->pending_picks = pp;
+    }
+    pp = next;
+  }
+  GRPC_ERROR_UNREF(error);
+}
+
+static void start_picking_locked(grpc_exec_ctx *exec_ctx,
+                                 weighted_round_robin_lb_policy *p) {
+  p->started_picking = true;
+  for (size_t i = 0; i < p->subchannel_list->num_subchannels; i++) {
+    grpc_lb_subchannel_data *sd = &p->subchannel_list->subchannels[i];
+    grpc_lb_subchannel_list_ref_for_connectivity_watch(sd->subchannel_list,
+                                                       "connectivity_watch");
+    grpc_lb_subchannel_data_start_connectivity_watch(exec_ctx, sd);
+  }
+}
+
+static void wrr_exit_idle_locked(grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol) {
+  weighted_round_robin_lb_policy *p = (weighted_round_robin_lb_policy *)pol;
+  if (!p->started_picking) {
+    start_picking_locked(exec_ctx, p);
+  }
+}
+
+/** Completes a pick of \a sd into \a target, \a context and \a user_data. */
+static void fill_pick_locked(weighted_round_robin_lb_policy *p,
+                             grpc_lb_subchannel_data *sd,
+                             grpc_connected_subchannel **target,
+                             grpc_call_context_element *context,
+                             void **user_data) {
+  *target = GRPC_CONNECTED_SUBCHANNEL_REF(
+      grpc_subchannel_get_connected_subchannel(sd->subchannel), "wrr_picked");
+  if (user_data != NULL) {
+    *user_data = sd->user_data;
+  }
+  wrr_track_call(subchannel_weight(sd), context);
+  if (GRPC_TRACER_ON(grpc_lb_weighted_round_robin_trace)) {
+    gpr_log(GPR_DEBUG,
+            "[WRR %p] Picked target <-- Subchannel %p (connected %p) (sl %p, "
+            "index %lu)",
+            (void *)p, (void *)sd->subchannel, (void *)*target,
+            (void *)sd->subchannel_list,
+            (unsigned long)(sd - sd->subchannel_list->subchannels));
+  }
+}
+
+static int wrr_pick_locked(grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol,
+                           const grpc_lb_policy_pick_args *pick_args,
+                           grpc_connected_subchannel **target,
+                           grpc_call_context_element *context, void **user_data,
+                           grpc_closure *on_complete) {
+  weighted_round_robin_lb_policy *p = (weighted_round_robin_lb_policy *)pol;
+  GPR_ASSERT(!p->shutdown);
+  if (GRPC_TRACER_ON(grpc_lb_weighted_round_robin_trace)) {
+    gpr_log(GPR_INFO, "[WRR %p] Trying to pick", (void *)pol);
+  }
+  grpc_lb_subchannel_data *sd = pick_subchannel_locked(p);
+  if (sd != NULL) {
+    /* readily available, report right away */
+    fill_pick_locked(p, sd, target, context, user_data);
+    return 1;
+  }
+  /* no pick currently available. Save for later in list of pending picks */
+  if (!p->started_picking) {
+    start_picking_locked(exec_ctx, p);
+  }
+  pending_pick *pp = (pending_pick *)gpr_malloc(sizeof(*pp));
+  pp->next = p->pending_picks;
+  pp->target = target;
+  pp->context = context;
+  pp->on_complete = on_complete;
+  pp->initial_metadata_flags = pick_args->initial_metadata_flags;
+  pp->user_data = user_data;
+  p->pending_picks = pp;
+  return 0;
+}
+
+/** Sets the policy's connectivity status based on that of the passed-in \a sd
+ * and the subchannel list \a sd belongs to, with the same rules as
+ * round_robin. \a error will only be used upon policy transition to
+ * TRANSIENT_FAILURE or SHUTDOWN. Returns the connectivity status set. */
+static grpc_connectivity_state update_lb_connectivity_status_locked(
+    grpc_exec_ctx *exec_ctx, grpc_lb_subchannel_data *sd, grpc_error *error) {
+  grpc_connectivity_state new_state = sd->curr_connectivity_state;
+  grpc_lb_subchannel_list *subchannel_list = sd->subchannel_list;
+  weighted_round_robin_lb_policy *p =
+      (weighted_round_robin_lb_policy *)subchannel_list->policy;
+  if (subchannel_list->num_ready > 0) { /* 1) READY */
+    grpc_connectivity_state_set(exec_ctx, &p->state_tracker, GRPC_CHANNEL_READY,
+                                GRPC_ERROR_NONE, "wrr_ready");
+    new_state = GRPC_CHANNEL_READY;
+  } else if (sd->curr_connectivity_state ==
+             GRPC_CHANNEL_CONNECTING) { /* 2) CONNECTING */
+    grpc_connectivity_state_set(exec_ctx, &p->state_tracker,
+                                GRPC_CHANNEL_CONNECTING, GRPC_ERROR_NONE,
+                                "wrr_connecting");
+    new_state = GRPC_CHANNEL_CONNECTING;
+  } else if (p->subchannel_list->num_shutdown ==
+             p->subchannel_list->num_subchannels) { /* 3) SHUTDOWN */
+    grpc_connectivity_state_set(exec_ctx, &p->state_tracker,
+                                GRPC_CHANNEL_SHUTDOWN, GRPC_ERROR_REF(error),
+                                "wrr_shutdown");
+    p->shutdown = true;
+    new_state = GRPC_CHANNEL_SHUTDOWN;
+  } else if (subchannel_list->num_transient_failures ==
+             p->subchannel_list->num_subchannels) { /* 4) TRANSIENT_FAILURE */
+    grpc_connectivity_state_set(exec_ctx, &p->state_tracker,
+                                GRPC_CHANNEL_TRANSIENT_FAILURE,
+                                GRPC_ERROR_REF(error), "wrr_transient_failure");
+    new_state = GRPC_CHANNEL_TRANSIENT_FAILURE;
+  } else if (subchannel_list->num_idle ==
+             p->subchannel_list->num_subchannels) { /* 5) IDLE */
+    grpc_connectivity_state_set(exec_ctx, &p->state_tracker, GRPC_CHANNEL_IDLE,
+                                GRPC_ERROR_NONE, "wrr_idle");
+    new_state = GRPC_CHANNEL_IDLE;
+  }
+  GRPC_ERROR_UNREF(error);
+  return new_state;
+}
+
+static void wrr_connectivity_changed_locked(grpc_exec_ctx *exec_ctx, void *arg,
+                                            grpc_error *error) {
+  grpc_lb_subchannel_data *sd = (grpc_lb_subchannel_data *)arg;
+  weighted_round_robin_lb_policy *p =
+      (weighted_round_robin_lb_policy *)sd->subchannel_list->policy;
+  if (GRPC_TRACER_ON(grpc_lb_weighted_round_robin_trace)) {
+    gpr_log(
+        GPR_DEBUG,
+        "[WRR %p] connectivity changed for subchannel %p, subchannel_list %p: "
+        "prev_state=%s new_state=%s p->shutdown=%d "
+        "sd->subchannel_list->shutting_down=%d error=%s",
+        (void *)p, (void *)sd->subchannel, (void *)sd->subchannel_list,
+        grpc_connectivity_state_name(sd->prev_connectivity_state),
+        grpc_connectivity_state_name(sd->pending_connectivity_state_unsafe),
+        p->shutdown, sd->subchannel_list->shutting_down,
+        grpc_error_string(error));
+  }
+  // If the policy is shutting down, unref and return.
+  if (p->shutdown) {
+    grpc_lb_subchannel_list_unref_for_connectivity_watch(
+        exec_ctx, sd->subchannel_list, "pol_shutdown");
+    return;
+  }
+  if (sd->subchannel_list->shutting_down && error == GRPC_ERROR_CANCELLED) {
+    // the subchannel list associated with sd has been discarded. This callback
+    // corresponds to the unsubscription. The unrefs correspond to the picking
+    // ref (start_picking_locked or update_started_picking).
+    grpc_lb_subchannel_list_unref_for_connectivity_watch(
+        exec_ctx, sd->subchannel_list, "sl_shutdown");
+    return;
+  }
+  // Dispose of outdated subchannel lists.
+  if (sd->subchannel_list != p->subchannel_list &&
+      sd->subchannel_list != p->latest_pending_subchannel_list) {
+    if (!sd->subchannel_list->shutting_down) {
+      grpc_lb_subchannel_list_shutdown_and_unref(exec_ctx, sd->subchannel_list,
+                                                 "sl_outdated");
+    }
+    grpc_lb_subchannel_list_unref_for_connectivity_watch(
+        exec_ctx, sd->subchannel_list, "sl_outdated");
+    return;
+  }
+  // Update state counters and determine new overall state.
+  const bool was_ready = sd->prev_connectivity_state == GRPC_CHANNEL_READY;
+  grpc_lb_subchannel_data_update_connectivity_state_locked(sd);
+  if (was_ready != (sd->curr_connectivity_state == GRPC_CHANNEL_READY)) {
+    p->schedule_valid = false;
+  }
+  const grpc_connectivity_state new_policy_connectivity_state =
+      update_lb_connectivity_status_locked(exec_ctx, sd, GRPC_ERROR_REF(error));
+  // If the sd's new state is SHUTDOWN, unref the subchannel, and if the new
+  // policy's state is SHUTDOWN, clean up.
+  if (sd->curr_connectivity_state == GRPC_CHANNEL_SHUTDOWN) {
+    grpc_lb_subchannel_data_unref_subchannel(exec_ctx, sd,
+                                             "wrr_subchannel_shutdown");
+    if (new_policy_connectivity_state == GRPC_CHANNEL_SHUTDOWN) {
+      // the policy is shutting down. Flush all the pending picks...
+      pending_pick *pp;
+      while ((pp = p->pending_picks)) {
+        p->pending_picks = pp->next;
+        *pp->target = NULL;
+        GRPC_CLOSURE_SCHED(exec_ctx, pp->on_complete, GRPC_ERROR_NONE);
+        gpr_free(pp);
+      }
+    }
+    grpc_lb_subchannel_list_unref_for_connectivity_watch(
+        exec_ctx, sd->subchannel_list, "sd_shutdown");
+  } else {  // sd not in SHUTDOWN
+    if (sd->curr_connectivity_state == GRPC_CHANNEL_READY) {
+      if (sd->subchannel_list != p->subchannel_list) {
+        // promote sd->subchannel_list to p->subchannel_list.
+        // sd->subchannel_list must be equal to
+        // p->latest_pending_subchannel_list because we have already filtered
+        // for sds belonging to outdated subchannel lists.
+        GPR_ASSERT(sd->subchannel_list == p->latest_pending_subchannel_list);
+        GPR_ASSERT(!sd->subchannel_list->shutting_down);
+        if (GRPC_TRACER_ON(grpc_lb_weighted_round_robin_trace)) {
+          gpr_log(GPR_DEBUG,
+                  "[WRR %p] phasing out subchannel list %p in favor of %p",
+                  (void *)p, (void *)p->subchannel_list,
+                  (void *)sd->subchannel_list);
+        }
+        if (p->subchannel_list != NULL) {
+          // dispose of the current subchannel_list
+          grpc_lb_subchannel_list_shutdown_and_unref(
+              exec_ctx, p->subchannel_list, "sl_phase_out_shutdown");
+        }
+        p->subchannel_list = p->latest_pending_subchannel_list;
+        p->latest_pending_subchannel_list = NULL;
+        p->schedule_valid = false;
+      }
+      /* at this point we know there's at least one suitable subchannel.
+       * Serve the pending picks, each one picking as wrr_pick() would, so that
+       * they follow the schedule too. */
+      pending_pick *pp;
+      while ((pp = p->pending_picks)) {
+        p->pending_picks = pp->next;
+        grpc_lb_subchannel_data *selected = pick_subchannel_locked(p);
+        GPR_ASSERT(selected != NULL);
+        fill_pick_locked(p, selected, pp->target, pp->context, pp->user_data);
+        GRPC_CLOSURE_SCHED(exec_ctx, pp->on_complete, GRPC_ERROR_NONE);
+        gpr_free(pp);
+      }
+    }
+    /* renew notification: reuses the connectivity watch refs on the policy
+     * and on sd->subchannel_list. */
+    grpc_lb_subchannel_data_start_connectivity_watch(exec_ctx, sd);
+  }
+}
+
+static grpc_connectivity_state wrr_check_connectivity_locked(
+    grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol, grpc_error **error) {
+  weighted_round_robin_lb_policy *p = (weighted_round_robin_lb_policy *)pol;
+  return grpc_connectivity_state_get(&p->state_tracker, error);
+}
+
+static void wrr_notify_on_state_change_locked(grpc_exec_ctx *exec_ctx,
+                                              grpc_lb_policy *pol,
+                                              grpc_connectivity_state *current,
+                                              grpc_closure *notify) {
+  weighted_round_robin_lb_policy *p = (weighted_round_robin_lb_policy *)pol;
+  grpc_connectivity_state_notify_on_state_change(exec_ctx, &p->state_tracker,
+                                                 current, notify);
+}
+
+static void wrr_ping_one_locked(grpc_exec_ctx *exec_ctx, grpc_lb_policy *pol,
+                                grpc_closure *closure) {
+  weighted_round_robin_lb_policy *p = (weighted_round_robin_lb_policy *)pol;
+  grpc_lb_subchannel_data *selected = pick_subchannel_locked(p);
+  if (selected != NULL) {
+    grpc_connected_subchannel *target = GRPC_CONNECTED_SUBCHANNEL_REF(
+        grpc_subchannel_get_connected_subchannel(selected->subchannel),
+        "wrr_picked");
+    grpc_connected_subchannel_ping(exec_ctx, target, closure);
+    GRPC_CONNECTED_SUBCHANNEL_UNREF(exec_ctx, target, "wrr_picked");
+  } else {
+    GRPC_CLOSURE_SCHED(exec_ctx, closure,
+                       GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+                           "Weighted Round Robin not connected"));
+  }
+}
+
+/** Returns the weight of \a subchannel in \a subchannel_list, or NULL if it
+ * is not there. */
+static grpc_wrr_backend_weight *find_weight_locked(
+    grpc_lb_subchannel_list *subchannel_list, grpc_subchannel *subchannel) {
+  if (subchannel_list == NULL) return NULL;
+  for (size_t i = 0; i < subchannel_list->num_subchannels; i++) {
+    grpc_lb_subchannel_data *sd = &subchannel_list->subchannels[i];
+    if (sd->subchannel == subchannel) return subchannel_weight(sd);
+  }
+  return NULL;
+}
+
+static void wrr_update_locked(grpc_exec_ctx *exec_ctx, grpc_lb_policy *policy,
+                              const grpc_lb_policy_args *args) {
+  weighted_round_robin_lb_policy *p = (weighted_round_robin_lb_policy *)policy;
+  const grpc_arg *arg =
+      grpc_channel_args_find(args->args, GRPC_ARG_LB_ADDRESSES);
+  if (arg == NULL || arg->type != GRPC_ARG_POINTER) {
+    if (p->subchannel_list == NULL) {
+      // If we don't have a current subchannel list, go into TRANSIENT FAILURE.
+      grpc_connectivity_state_set(
+          exec_ctx, &p->state_tracker, GRPC_CHANNEL_TRANSIENT_FAILURE,
+          GRPC_ERROR_CREATE_FROM_STATIC_STRING("Missing update in args"),
+          "wrr_update_missing");
+    } else {
+      // otherwise, keep using the current subchannel list (ignore this update).
+      gpr_log(
+          GPR_ERROR,
+          "[WRR %p] No valid LB addresses channel arg for update, ignoring.",
+          (void *)p);
+    }
+    return;
+  }
+  grpc_lb_addresses *addresses = (grpc_lb_addresses *)arg->value.pointer.p;
+  grpc_lb_subchannel_list *subchannel_list = grpc_lb_subchannel_list_create(
+      exec_ctx, &p->base, &grpc_lb_weighted_round_robin_trace, addresses, args,
+      wrr_connectivity_changed_locked);
+  const size_t num_subchannels = subchannel_list->num_subchannels;
+  wrr_subchannel_list_data *data =
+      (wrr_subchannel_list_data *)gpr_zalloc(sizeof(*data));
+  data->weights = (grpc_wrr_backend_weight **)gpr_malloc(
+      sizeof(*data->weights) * num_subchannels);
+  data->num_subchannels = num_subchannels;
+  for (size_t i = 0; i < num_subchannels; i++) {
+    // Subchannels are shared through the subchannel index, so a subchannel
+    // the previous list had keeps the weight its server reported.
+    grpc_wrr_backend_weight *weight = find_weight_locked(
+        p->subchannel_list, subchannel_list->subchannels[i].subchannel);
+    data->weights[i] = weight != NULL ? grpc_wrr_backend_weight_ref(weight)
+                                      : grpc_wrr_backend_weight_create();
+  }
+  subchannel_list->policy_data = data;
+  subchannel_list->destroy_policy_data = wrr_subchannel_list_data_destroy;
+  if (num_subchannels == 0) {
+    grpc_connectivity_state_set(
+        exec_ctx, &p->state_tracker, GRPC_CHANNEL_TRANSIENT_FAILURE,
+        GRPC_ERROR_CREATE_FROM_STATIC_STRING("Empty update"),
+        "wrr_update_empty");
+    if (p->subchannel_list != NULL) {
+      grpc_lb_subchannel_list_shutdown_and_unref(exec_ctx, p->subchannel_list,
+                                                 "sl_shutdown_empty_update");
+    }
+    p->subchannel_list = subchannel_list;  // empty list
+    p->schedule_valid = false;
+    return;
+  }
+  if (p->started_picking) {
+    if (p->latest_pending_subchannel_list != NULL) {
+      if (GRPC_TRACER_ON(grpc_lb_weighted_round_robin_trace)) {
+        gpr_log(GPR_DEBUG,
+                "[WRR %p] Shutting down latest pending subchannel list %p, "
+                "about to be replaced by newer latest %p",
+                (void *)p, (void *)p->latest_pending_subchannel_list,
+                (void *)subchannel_list);
+      }
+      grpc_lb_subchannel_list_shutdown_and_unref(
+          exec_ctx, p->latest_pending_subchannel_list,
+          "sl_outdated_dont_smash");
+    }
+    p->latest_pending_subchannel_list = subchannel_list;
+    for (size_t i = 0; i < num_subchannels; i++) {
+      /* Watch every new subchannel. A subchannel list becomes active the
+       * moment one of its subchannels is READY. At that moment, we swap
+       * p->subchannel_list for sd->subchannel_list, provided the subchannel
+       * list is still valid (ie, isn't shutting down) */
+      grpc_lb_subchannel_list_ref_for_connectivity_watch(subchannel_list,
+                                                         "connectivity_watch");
+      grpc_lb_subchannel_data_start_connectivity_watch(
+          exec_ctx, &subchannel_list->subchannels[i]);
+    }
+  } else {
+    // The policy isn't picking yet. Save the update for later, disposing of
+    // previous version if any.
+    if (p->subchannel_list != NULL) {
+      grpc_lb_subchannel_list_shutdown_and_unref(
+          exec_ctx, p->subchannel_list, "wrr_update_before_started_picking");
+    }
+    p->subchannel_list = subchannel_list;
+    p->schedule_valid = false;
+  }
+}
+
+static const grpc_lb_policy_vtable weighted_round_robin_lb_policy_vtable = {
+    wrr_destroy,
+    wrr_shutdown_locked,
+    wrr_pick_locked,
+    wrr_cancel_pick_locked,
+    wrr_cancel_picks_locked,
+    wrr_ping_one_locked,
+    wrr_exit_idle_locked,
+    wrr_check_connectivity_locked,
+    wrr_notify_on_state_change_locked,
+    wrr_update_locked};
+
+static void weighted_round_robin_factory_ref(
+    grpc_lb_policy_factory *factory) {}
+
+static void weighted_round_robin_factory_unref(
+    grpc_lb_policy_factory *factory) {}
+
+static grpc_lb_policy *weighted_round_robin_create(
+    grpc_exec_ctx *exec_ctx, grpc_lb_policy_factory *factory,
+    grpc_lb_policy_args *args) {
+  GPR_ASSERT(args->client_channel_factory != NULL);
+  weighted_round_robin_lb_policy *p =
+      (weighted_round_robin_lb_policy *)gpr_zalloc(sizeof(*p));
+  grpc_lb_policy_init(&p->base, &weighted_round_robin_lb_policy_vtable,
+                      args->combiner);
+  grpc_subchannel_index_ref();
+  grpc_connectivity_state_init(&p->state_tracker, GRPC_CHANNEL_IDLE,
+                               "weighted_round_robin");
+  const grpc_arg *arg = grpc_channel_args_find(
+      args->args, GRPC_ARG_WEIGHTED_ROUND_ROBIN_WEIGHT_EXPIRATION_MS);
+  p->weight_expiration_ms = grpc_channel_arg_get_integer(
+      arg, (grpc_integer_options){DEFAULT_WEIGHT_EXPIRATION_MS, 1, INT_MAX});
+  wrr_update_locked(exec_ctx, &p->base, args);
+  if (GRPC_TRACER_ON(grpc_lb_weighted_round_robin_trace)) {
+    gpr_log(GPR_DEBUG, "[WRR %p] Created with %lu subchannels", (void *)p,
+            (unsigned long)p->subchannel_list->num_subchannels);
+  }
+  return &p->base;
+}
+
+static const grpc_lb_policy_factory_vtable
+    weighted_round_robin_factory_vtable = {
+        weighted_round_robin_factory_ref, weighted_round_robin_factory_unref,
+        weighted_round_robin_create, "weighted_round_robin"};
+
+static grpc_lb_policy_factory weighted_round_robin_lb_policy_factory = {
+    &weighted_round_robin_factory_vtable};
+
+static grpc_lb_policy_factory *weighted_round_robin_lb_factory_create() {
+  return &weighted_round_robin_lb_policy_factory;
+}
+
+/* Plugin registration */
+
+// Only add the load report filter if the weighted_round_robin LB policy is
+// used.
+static bool maybe_add_load_report_filter(grpc_exec_ctx *exec_ctx,
+                                         grpc_channel_stack_builder *builder,
+                                         void *arg) {
+  const grpc_channel_args *args =
+      grpc_channel_stack_builder_get_channel_arguments(builder);
+  const grpc_arg *channel_arg =
+      grpc_channel_args_find(args, GRPC_ARG_LB_POLICY_NAME);
+  if (channel_arg != NULL && channel_arg->type == GRPC_ARG_STRING &&
+      strcmp(channel_arg->value.string, "weighted_round_robin") == 0) {
+    return grpc_channel_stack_builder_append_filter(
+        builder, (const grpc_channel_filter *)arg, NULL, NULL);
+  }
+  return true;
+}
+
+void grpc_lb_policy_weighted_round_robin_init() {
+  grpc_register_lb_policy(weighted_round_robin_lb_factory_create());
+  grpc_register_tracer(&grpc_lb_weighted_round_robin_trace);
+  grpc_channel_init_register_stage(GRPC_CLIENT_SUBCHANNEL,
+                                   GRPC_CHANNEL_INIT_BUILTIN_PRIORITY,
+                                   maybe_add_load_report_filter,
+                                   (void *)&grpc_wrr_load_report_filter);
+}
+
+void grpc_lb_policy_weighted_round_robin_shutdown() {}
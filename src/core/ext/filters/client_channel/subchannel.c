@@ -51,6 +51,8 @@
 #define GRPC_SUBCHANNEL_RECONNECT_MAX_BACKOFF_SECONDS 120
 #define GRPC_SUBCHANNEL_RECONNECT_JITTER 0.2
 
+#define GRPC_SUBCHANNEL_DEFAULT_CONNECTION_STREAM_LIMIT 100
+
 #define GET_CONNECTED_SUBCHANNEL(subchannel, barrier)      \
   ((grpc_connected_subchannel *)(gpr_atm_##barrier##_load( \
       &(subchannel)->connected_subchannel)))
@@ -59,6 +61,8 @@ typedef struct {
   grpc_closure closure;
   grpc_subchannel *subchannel;
   grpc_connectivity_state connectivity_state;
+  /** the additional connection being watched, or NULL for the first one */
+  grpc_connected_subchannel *connection;
 } state_watcher;
 
 typedef struct external_state_watcher {
@@ -94,6 +98,12 @@ struct grpc_subchannel {
   /** callback for connection finishing */
   grpc_closure connected;
 
+  /** set during an additional connection attempt */
+  grpc_connect_out_args extra_connecting_result;
+
+  /** callback for an additional connection finishing */
+  grpc_closure extra_connected;
+
   /** callback for our alarm */
   grpc_closure on_alarm;
 
@@ -111,6 +121,8 @@ struct grpc_subchannel {
   bool disconnected;
   /** are we connecting */
   bool connecting;
+  /** are we opening an additional connection */
+  bool extra_connecting;
   /** connectivity state tracking */
   grpc_connectivity_state_tracker state_tracker;
 
@@ -126,6 +138,25 @@ struct grpc_subchannel {
   bool backoff_begun;
   /** our alarm */
   grpc_timer alarm;
+
+  /** maximum number of connections to open to the address */
+  int max_connections;
+  /** active calls per connection at which another one is opened */
+  int connection_stream_limit;
+  /** connections opened in addition to connected_subchannel */
+  grpc_connected_subchannel **extra_connections;
+  size_t num_extra_connections;
+  size_t extra_connections_capacity;
+  /** no additional connection is attempted before this time */
+  gpr_timespec next_extra_attempt;
+};
+
+struct grpc_connected_subchannel {
+  /** subchannel calls created on this connection and not yet destroyed */
+  gpr_atm active_calls;
+  /** weak ref to the owning subchannel if it may open several connections,
+      else NULL */
+  grpc_subchannel *subchannel;
 };
 
 struct grpc_subchannel_call {
@@ -134,12 +165,19 @@ struct grpc_subchannel_call {
 };
 
 #define SUBCHANNEL_CALL_TO_CALL_STACK(call) ((grpc_call_stack *)((call) + 1))
-#define CHANNEL_STACK_FROM_CONNECTION(con) ((grpc_channel_stack *)(con))
+/* the channel stack follows the connection header, suitably aligned */
+#define CONNECTION_PREFIX_SIZE                                    \
+  ((sizeof(grpc_connected_subchannel) + GPR_MAX_ALIGNMENT - 1u) & \
+   ~(GPR_MAX_ALIGNMENT - 1u))
+#define CHANNEL_STACK_FROM_CONNECTION(con) \
+  ((grpc_channel_stack *)((char *)(con) + CONNECTION_PREFIX_SIZE))
 #define CALLSTACK_TO_SUBCHANNEL_CALL(callstack) \
   (((grpc_subchannel_call *)(callstack)) - 1)
 
 static void subchannel_connected(grpc_exec_ctx *exec_ctx, void *subchannel,
                                  grpc_error *error);
+static void subchannel_extra_connected(grpc_exec_ctx *exec_ctx,
+                                       void *subchannel, grpc_error *error);
 
 #ifndef NDEBUG
 #define REF_REASON reason
@@ -160,6 +198,9 @@ static void connection_destroy(grpc_exec_ctx *exec_ctx, void *arg,
                                grpc_error *error) {
   grpc_connected_subchannel *c = (grpc_connected_subchannel *)arg;
   grpc_channel_stack_destroy(exec_ctx, CHANNEL_STACK_FROM_CONNECTION(c));
+  if (c->subchannel != NULL) {
+    GRPC_SUBCHANNEL_WEAK_UNREF(exec_ctx, c->subchannel, "connection");
+  }
   gpr_free(c);
 }
 
@@ -189,6 +230,7 @@ static void subchannel_destroy(grpc_exec_ctx *exec_ctx, void *arg,
   grpc_connector_unref(exec_ctx, c->connector);
   grpc_pollset_set_destroy(exec_ctx, c->pollset_set);
   grpc_subchannel_key_destroy(exec_ctx, c->key);
+  gpr_free(c->extra_connections);
   gpr_mu_destroy(&c->mu);
   gpr_free(c);
 }
@@ -254,6 +296,11 @@ static void disconnect(grpc_exec_ctx *exec_ctx, grpc_subchannel *c) {
     GRPC_CONNECTED_SUBCHANNEL_UNREF(exec_ctx, con, "connection");
     gpr_atm_no_barrier_store(&c->connected_subchannel, (gpr_atm)0xdeadbeef);
   }
+  for (size_t i = 0; i < c->num_extra_connections; i++) {
+    GRPC_CONNECTED_SUBCHANNEL_UNREF(exec_ctx, c->extra_connections[i],
+                                    "connection");
+  }
+  c->num_extra_connections = 0;
   gpr_mu_unlock(&c->mu);
 }
 
@@ -330,6 +377,8 @@ grpc_subchannel *grpc_subchannel_create(grpc_exec_ctx *exec_ctx,
       &c->root_external_state_watcher;
   GRPC_CLOSURE_INIT(&c->connected, subchannel_connected, c,
                     grpc_schedule_on_exec_ctx);
+  GRPC_CLOSURE_INIT(&c->extra_connected, subchannel_extra_connected, c,
+                    grpc_schedule_on_exec_ctx);
   grpc_connectivity_state_init(&c->state_tracker, GRPC_CHANNEL_IDLE,
                                "subchannel");
   int initial_backoff_ms =
@@ -373,6 +422,14 @@ grpc_subchannel *grpc_subchannel_create(grpc_exec_ctx *exec_ctx,
                               : GRPC_SUBCHANNEL_RECONNECT_BACKOFF_MULTIPLIER,
       fixed_reconnect_backoff ? 0.0 : GRPC_SUBCHANNEL_RECONNECT_JITTER,
       min_backoff_ms, max_backoff_ms);
+  c->max_connections = grpc_channel_arg_get_integer(
+      grpc_channel_args_find(c->args, GRPC_ARG_MAX_CONNECTIONS_PER_SUBCHANNEL),
+      (grpc_integer_options){1, 1, INT_MAX});
+  c->connection_stream_limit = grpc_channel_arg_get_integer(
+      grpc_channel_args_find(c->args,
+                             GRPC_ARG_SUBCHANNEL_CONNECTION_STREAM_LIMIT),
+      (grpc_integer_options){GRPC_SUBCHANNEL_DEFAULT_CONNECTION_STREAM_LIMIT,
+                             1, INT_MAX});
   gpr_mu_init(&c->mu);
 
   return grpc_subchannel_index_register(exec_ctx, key, c);
@@ -488,6 +545,33 @@ static void maybe_start_connecting_locked(grpc_exec_ctx *exec_ctx,
   }
 }
 
+/* Opens one more connection alongside the published one. The subchannel's
+   connectivity state only follows its first connection, so this neither
+   reports CONNECTING nor backs off through the alarm. The connector runs one
+   attempt at a time; that of the first connection is over by the time this is
+   called. */
+static void maybe_start_extra_connection_locked(grpc_exec_ctx *exec_ctx,
+                                                grpc_subchannel *c) {
+  if (c->disconnected || c->connecting || c->extra_connecting ||
+      c->num_extra_connections + 1 >= (size_t)c->max_connections) {
+    return;
+  }
+  gpr_timespec now = gpr_now(GPR_CLOCK_MONOTONIC);
+  if (gpr_time_cmp(now, c->next_extra_attempt) < 0) return;
+
+  c->extra_connecting = true;
+  GRPC_SUBCHANNEL_WEAK_REF(c, "extra_connecting");
+
+  grpc_connect_in_args args;
+  args.interested_parties = c->pollset_set;
+  args.deadline = gpr_time_add(
+      now, gpr_time_from_millis(c->backoff_state.min_timeout_millis,
+                                GPR_TIMESPAN));
+  args.channel_args = c->args;
+  grpc_connector_connect(exec_ctx, c->connector, &args,
+                         &c->extra_connecting_result, &c->extra_connected);
+}
+
 void grpc_subchannel_notify_on_state_change(
     grpc_exec_ctx *exec_ctx, grpc_subchannel *c,
     grpc_pollset_set *interested_parties, grpc_connectivity_state *state,
@@ -564,6 +648,38 @@ static void subchannel_on_child_state_changed(grpc_exec_ctx *exec_ctx, void *p,
   gpr_free(sw);
 }
 
+static void subchannel_on_extra_connection_state_changed(
+    grpc_exec_ctx *exec_ctx, void *p, grpc_error *error) {
+  state_watcher *sw = (state_watcher *)p;
+  grpc_subchannel *c = sw->subchannel;
+
+  gpr_mu_lock(&c->mu);
+  size_t i = 0;
+  while (i < c->num_extra_connections &&
+         c->extra_connections[i] != sw->connection) {
+    i++;
+  }
+  /* not found: the subchannel disconnected and dropped its connections */
+  if (i < c->num_extra_connections) {
+    if (sw->connectivity_state == GRPC_CHANNEL_TRANSIENT_FAILURE ||
+        sw->connectivity_state == GRPC_CHANNEL_SHUTDOWN) {
+      /* new calls go to the remaining connections */
+      c->extra_connections[i] =
+          c->extra_connections[--c->num_extra_connections];
+      GRPC_CONNECTED_SUBCHANNEL_UNREF(exec_ctx, sw->connection, "connection");
+    } else {
+      grpc_connected_subchannel_notify_on_state_change(
+          exec_ctx, sw->connection, NULL, &sw->connectivity_state,
+          &sw->closure);
+      GRPC_SUBCHANNEL_WEAK_REF(c, "state_watcher");
+      sw = NULL;
+    }
+  }
+  gpr_mu_unlock(&c->mu);
+  GRPC_SUBCHANNEL_WEAK_UNREF(exec_ctx, c, "state_watcher");
+  gpr_free(sw);
+}
+
 static void connected_subchannel_state_op(grpc_exec_ctx *exec_ctx,
                                           grpc_connected_subchannel *con,
                                           grpc_pollset_set *interested_parties,
@@ -596,40 +712,52 @@ void grpc_connected_subchannel_ping(grpc_exec_ctx *exec_ctx,
   elem->filter->start_transport_op(exec_ctx, elem, op);
 }
 
-static bool publish_transport_locked(grpc_exec_ctx *exec_ctx,
-                                     grpc_subchannel *c) {
+/* Builds the channel stack of a connection over the transport in \a result,
+   which it takes. Returns NULL on failure. */
+static grpc_connected_subchannel *create_connection(
+    grpc_exec_ctx *exec_ctx, grpc_connect_out_args *result) {
   grpc_connected_subchannel *con;
-  grpc_channel_stack *stk;
-  state_watcher *sw_subchannel;
 
   /* construct channel stack */
   grpc_channel_stack_builder *builder = grpc_channel_stack_builder_create();
-  grpc_channel_stack_builder_set_channel_arguments(
-      exec_ctx, builder, c->connecting_result.channel_args);
-  grpc_channel_stack_builder_set_transport(builder,
-                                           c->connecting_result.transport);
+  grpc_channel_stack_builder_set_channel_arguments(exec_ctx, builder,
+                                                   result->channel_args);
+  grpc_channel_stack_builder_set_transport(builder, result->transport);
 
   if (!grpc_channel_init_create_stack(exec_ctx, builder,
                                       GRPC_CLIENT_SUBCHANNEL)) {
     grpc_channel_stack_builder_destroy(exec_ctx, builder);
-    return false;
+    return NULL;
   }
   grpc_error *error = grpc_channel_stack_builder_finish(
-      exec_ctx, builder, 0, 1, connection_destroy, NULL, (void **)&con);
+      exec_ctx, builder, CONNECTION_PREFIX_SIZE, 1, connection_destroy, NULL,
+      (void **)&con);
   if (error != GRPC_ERROR_NONE) {
-    grpc_transport_destroy(exec_ctx, c->connecting_result.transport);
+    grpc_transport_destroy(exec_ctx, result->transport);
     gpr_log(GPR_ERROR, "error initializing subchannel stack: %s",
             grpc_error_string(error));
     GRPC_ERROR_UNREF(error);
-    return false;
+    return NULL;
   }
+  memset(result, 0, sizeof(*result));
+  return con;
+}
+
+static bool publish_transport_locked(grpc_exec_ctx *exec_ctx,
+                                     grpc_subchannel *c) {
+  grpc_connected_subchannel *con;
+  grpc_channel_stack *stk;
+  state_watcher *sw_subchannel;
+
+  con = create_connection(exec_ctx, &c->connecting_result);
+  if (con == NULL) return false;
   stk = CHANNEL_STACK_FROM_CONNECTION(con);
-  memset(&c->connecting_result, 0, sizeof(c->connecting_result));
 
   /* initialize state watcher */
   sw_subchannel = (state_watcher *)gpr_malloc(sizeof(*sw_subchannel));
   sw_subchannel->subchannel = c;
   sw_subchannel->connectivity_state = GRPC_CHANNEL_READY;
+  sw_subchannel->connection = NULL;
   GRPC_CLOSURE_INIT(&sw_subchannel->closure, subchannel_on_child_state_changed,
                     sw_subchannel, grpc_schedule_on_exec_ctx);
 
@@ -640,6 +768,10 @@ static bool publish_transport_locked(grpc_exec_ctx *exec_ctx,
     return false;
   }
 
+  if (c->max_connections > 1) {
+    con->subchannel = GRPC_SUBCHANNEL_WEAK_REF(c, "connection");
+  }
+
   /* publish */
   /* TODO(ctiller): this full barrier seems to clear up a TSAN failure.
                     I'd have expected the rel_cas below to be enough, but
@@ -662,6 +794,42 @@ static bool publish_transport_locked(grpc_exec_ctx *exec_ctx,
   return true;
 }
 
+/* Adds the transport of an additional connect to c->extra_connections. Calls
+   reach it through the first connection, and it leaves the subchannel's
+   connectivity state alone. */
+static bool publish_extra_connection_locked(grpc_exec_ctx *exec_ctx,
+                                            grpc_subchannel *c) {
+  grpc_connected_subchannel *con =
+      create_connection(exec_ctx, &c->extra_connecting_result);
+  if (con == NULL) return false;
+
+  if (c->disconnected) {
+    grpc_channel_stack_destroy(exec_ctx, CHANNEL_STACK_FROM_CONNECTION(con));
+    gpr_free(con);
+    return false;
+  }
+
+  if (c->num_extra_connections == c->extra_connections_capacity) {
+    c->extra_connections_capacity =
+        GPR_MAX(2 * c->extra_connections_capacity, 4);
+    c->extra_connections = (grpc_connected_subchannel **)gpr_realloc(
+        c->extra_connections,
+        c->extra_connections_capacity * sizeof(*c->extra_connections));
+  }
+  c->extra_connections[c->num_extra_connections++] = con;
+
+  state_watcher *sw = (state_watcher *)gpr_malloc(sizeof(*sw));
+  sw->subchannel = c;
+  sw->connectivity_state = GRPC_CHANNEL_READY;
+  sw->connection = con;
+  GRPC_CLOSURE_INIT(&sw->closure, subchannel_on_extra_connection_state_changed,
+                    sw, grpc_schedule_on_exec_ctx);
+  GRPC_SUBCHANNEL_WEAK_REF(c, "state_watcher");
+  grpc_connected_subchannel_notify_on_state_change(
+      exec_ctx, con, c->pollset_set, &sw->connectivity_state, &sw->closure);
+  return true;
+}
+
 static void subchannel_connected(grpc_exec_ctx *exec_ctx, void *arg,
                                  grpc_error *error) {
   grpc_subchannel *c = (grpc_subchannel *)arg;
@@ -694,6 +862,31 @@ static void subchannel_connected(grpc_exec_ctx *exec_ctx, void *arg,
   grpc_channel_args_destroy(exec_ctx, delete_channel_args);
 }
 
+static void subchannel_extra_connected(grpc_exec_ctx *exec_ctx, void *arg,
+                                       grpc_error *error) {
+  grpc_subchannel *c = (grpc_subchannel *)arg;
+  grpc_channel_args *delete_channel_args =
+      c->extra_connecting_result.channel_args;
+
+  gpr_mu_lock(&c->mu);
+  c->extra_connecting = false;
+  if (c->extra_connecting_result.transport != NULL &&
+      publish_extra_connection_locked(exec_ctx, c)) {
+    /* do nothing, transport was published */
+  } else if (!c->disconnected) {
+    /* keep using the open connections, and hold off before trying again */
+    gpr_log(GPR_INFO, "Additional connect failed: %s",
+            grpc_error_string(error));
+    c->next_extra_attempt = gpr_time_add(
+        gpr_now(GPR_CLOCK_MONOTONIC),
+        gpr_time_from_millis(c->backoff_state.initial_connect_timeout,
+                             GPR_TIMESPAN));
+  }
+  gpr_mu_unlock(&c->mu);
+  GRPC_SUBCHANNEL_WEAK_UNREF(exec_ctx, c, "extra_connecting");
+  grpc_channel_args_destroy(exec_ctx, delete_channel_args);
+}
+
 /*
  * grpc_subchannel_call implementation
  */
@@ -704,6 +897,7 @@ static void subchannel_call_destroy(grpc_exec_ctx *exec_ctx, void *call,
   GPR_ASSERT(c->schedule_closure_after_destroy != NULL);
   GPR_TIMER_BEGIN("grpc_subchannel_call_unref.destroy", 0);
   grpc_connected_subchannel *connection = c->connection;
+  gpr_atm_no_barrier_fetch_add(&connection->active_calls, -1);
   grpc_call_stack_destroy(exec_ctx, SUBCHANNEL_CALL_TO_CALL_STACK(c), NULL,
                           c->schedule_closure_after_destroy);
   GRPC_CONNECTED_SUBCHANNEL_UNREF(exec_ctx, connection, "subchannel_call");
@@ -749,15 +943,43 @@ const grpc_subchannel_key *grpc_subchannel_get_key(
   return subchannel->key;
 }
 
+/* Returns a ref to the connection of con's subchannel with the fewest active
+   calls, opening another one if they have all reached the stream limit. */
+static grpc_connected_subchannel *pick_connection(
+    grpc_exec_ctx *exec_ctx, grpc_connected_subchannel *con) {
+  grpc_subchannel *c = con->subchannel;
+  gpr_atm limit = c->connection_stream_limit;
+  gpr_mu_lock(&c->mu);
+  if (!c->disconnected) {
+    gpr_atm best_calls = gpr_atm_no_barrier_load(&con->active_calls);
+    for (size_t i = 0; i < c->num_extra_connections; i++) {
+      gpr_atm calls =
+          gpr_atm_no_barrier_load(&c->extra_connections[i]->active_calls);
+      if (calls < best_calls) {
+        con = c->extra_connections[i];
+        best_calls = calls;
+      }
+    }
+    if (best_calls >= limit) maybe_start_extra_connection_locked(exec_ctx, c);
+  }
+  GRPC_CONNECTED_SUBCHANNEL_REF(con, "subchannel_call");
+  gpr_mu_unlock(&c->mu);
+  return con;
+}
+
 grpc_error *grpc_connected_subchannel_create_call(
     grpc_exec_ctx *exec_ctx, grpc_connected_subchannel *con,
     const grpc_connected_subchannel_call_args *args,
     grpc_subchannel_call **call) {
+  con = con->subchannel != NULL
+            ? pick_connection(exec_ctx, con)
+            : GRPC_CONNECTED_SUBCHANNEL_REF(con, "subchannel_call");
   grpc_channel_stack *chanstk = CHANNEL_STACK_FROM_CONNECTION(con);
   *call = (grpc_subchannel_call *)gpr_arena_alloc(
       args->arena, sizeof(grpc_subchannel_call) + chanstk->call_stack_size);
   grpc_call_stack *callstk = SUBCHANNEL_CALL_TO_CALL_STACK(*call);
-  (*call)->connection = GRPC_CONNECTED_SUBCHANNEL_REF(con, "subchannel_call");
+  (*call)->connection = con;
+  gpr_atm_no_barrier_fetch_add(&con->active_calls, 1);
   const grpc_call_element_args call_args = {
       .call_stack = callstk,
       .server_transport_data = NULL,
@@ -20,6 +20,7 @@
 
 #include <grpc/load_reporting.h>
 #include <grpc/support/alloc.h>
+#include <grpc/support/cpu.h>
 #include <grpc/support/log.h>
 #include <grpc/support/string_util.h>
 #include <grpc/support/sync.h>
@@ -29,8 +30,74 @@
 #include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/profiling/timers.h"
 #include "src/core/lib/slice/slice_internal.h"
+#include "src/core/lib/support/process_cpu_time.h"
+#include "src/core/lib/transport/load_report_encoding.h"
 #include "src/core/lib/transport/static_metadata.h"
 
+/* Load of the process, measured at most once a second over the calls of all
+ * servers with load reporting, and reported in their trailing metadata. */
+static gpr_atm g_calls_completed;
+static gpr_atm g_utilization_permille;
+static gpr_atm g_qps;
+/** second of GPR_CLOCK_MONOTONIC from which the load is due for measurement */
+static gpr_atm g_next_measurement_sec;
+/** guards the last measurement */
+static gpr_mu g_measurement_mu;
+static gpr_timespec g_last_measurement_time;
+static bool g_have_last_measurement_cpu_time;
+static gpr_timespec g_last_measurement_cpu_time;
+static gpr_atm g_last_measurement_calls_completed;
+
+void grpc_server_load_reporting_filter_init(void) {
+  gpr_mu_init(&g_measurement_mu);
+  g_last_measurement_time = gpr_now(GPR_CLOCK_MONOTONIC);
+  g_have_last_measurement_cpu_time =
+      gpr_process_cpu_time(&g_last_measurement_cpu_time);
+  g_last_measurement_calls_completed =
+      gpr_atm_no_barrier_load(&g_calls_completed);
+  gpr_atm_no_barrier_store(&g_next_measurement_sec,
+                           (gpr_atm)g_last_measurement_time.tv_sec + 1);
+}
+
+void grpc_server_load_reporting_filter_shutdown(void) {
+  gpr_mu_destroy(&g_measurement_mu);
+}
+
+static void maybe_measure_load(gpr_timespec now) {
+  if ((gpr_atm)now.tv_sec < gpr_atm_no_barrier_load(&g_next_measurement_sec) ||
+      !gpr_mu_trylock(&g_measurement_mu)) {
+    return;
+  }
+  const double elapsed_sec =
+      gpr_timespec_to_micros(gpr_time_sub(now, g_last_measurement_time)) /
+      GPR_US_PER_SEC;
+  if (elapsed_sec > 0) {
+    const gpr_atm calls_completed = gpr_atm_no_barrier_load(&g_calls_completed);
+    gpr_atm_no_barrier_store(
+        &g_qps,
+        (gpr_atm)((double)(calls_completed -
+                           g_last_measurement_calls_completed) /
+                  elapsed_sec));
+    g_last_measurement_calls_completed = calls_completed;
+    gpr_timespec cpu_time;
+    const bool have_cpu_time = gpr_process_cpu_time(&cpu_time);
+    if (have_cpu_time && g_have_last_measurement_cpu_time) {
+      const double cpu_sec =
+          gpr_timespec_to_micros(
+              gpr_time_sub(cpu_time, g_last_measurement_cpu_time)) /
+          GPR_US_PER_SEC;
+      gpr_atm_no_barrier_store(
+          &g_utilization_permille,
+          (gpr_atm)(1000 * cpu_sec / (elapsed_sec * gpr_cpu_num_cores())));
+    }
+    g_have_last_measurement_cpu_time = have_cpu_time;
+    g_last_measurement_cpu_time = cpu_time;
+    g_last_measurement_time = now;
+  }
+  gpr_atm_no_barrier_store(&g_next_measurement_sec, (gpr_atm)now.tv_sec + 1);
+  gpr_mu_unlock(&g_measurement_mu);
+}
+
 typedef struct call_data {
   intptr_t id; /**< an id unique to the call */
   bool have_trailing_md_string;
@@ -39,6 +106,9 @@ typedef struct call_data {
   grpc_slice initial_md_string;
   bool have_service_method;
   grpc_slice service_method;
+  /** did the application report the load itself? */
+  bool have_load_report;
+  grpc_linked_mdelem load_report;
 
   /* stores the recv_initial_metadata op's ready closure, which we wrap with our
    * own (on_initial_md_ready) in order to capture the incoming initial metadata
@@ -182,6 +252,9 @@ static grpc_filtered_mdelem lr_trailing_md_filter(grpc_exec_ctx *exec_ctx,
     calld->trailing_md_string = GRPC_MDVALUE(md);
     return GRPC_FILTERED_REMOVE();
   }
+  if (grpc_slice_str_cmp(GRPC_MDKEY(md), GRPC_LOAD_REPORT_KEY) == 0) {
+    calld->have_load_report = true;
+  }
   return GRPC_FILTERED_MDELEM(md);
 }
 
@@ -207,6 +280,24 @@ static void lr_start_transport_stream_op_batch(
             op->payload->send_trailing_metadata.send_trailing_metadata,
             lr_trailing_md_filter, elem,
             "LR trailing metadata filtering error"));
+    gpr_atm_no_barrier_fetch_add(&g_calls_completed, 1);
+    maybe_measure_load(gpr_now(GPR_CLOCK_MONOTONIC));
+    if (!calld->have_load_report) {
+      const grpc_load_report report = {
+          (uint32_t)gpr_atm_no_barrier_load(&g_utilization_permille),
+          (uint32_t)gpr_atm_no_barrier_load(&g_qps)};
+      char buffer[GRPC_LOAD_REPORT_ENCODE_MIN_BUFSIZE];
+      grpc_load_report_encode(&report, buffer);
+      GRPC_LOG_IF_ERROR(
+          "grpc_metadata_batch_add_tail",
+          grpc_metadata_batch_add_tail(
+              exec_ctx,
+              op->payload->send_trailing_metadata.send_trailing_metadata,
+              &calld->load_report,
+              grpc_mdelem_from_slices(
+                  exec_ctx, grpc_slice_from_static_string(GRPC_LOAD_REPORT_KEY),
+                  grpc_slice_from_copied_string(buffer))));
+    }
   }
   grpc_call_next_op(exec_ctx, elem, op);
 
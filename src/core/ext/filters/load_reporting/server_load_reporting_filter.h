@@ -24,5 +24,9 @@
 
 extern const grpc_channel_filter grpc_server_load_reporting_filter;
 
+/** Global state of the filter, which measures the load of the process */
+void grpc_server_load_reporting_filter_init(void);
+void grpc_server_load_reporting_filter_shutdown(void);
+
 #endif /* GRPC_CORE_EXT_FILTERS_LOAD_REPORTING_SERVER_LOAD_REPORTING_FILTER_H \
           */
@@ -62,9 +62,12 @@ grpc_arg grpc_load_reporting_enable_arg() {
 /* Plugin registration */
 
 void grpc_server_load_reporting_plugin_init(void) {
+  grpc_server_load_reporting_filter_init();
   grpc_channel_init_register_stage(GRPC_SERVER_CHANNEL, INT_MAX,
                                    maybe_add_server_load_reporting_filter,
                                    (void *)&grpc_server_load_reporting_filter);
 }
 
-void grpc_server_load_reporting_plugin_shutdown() {}
+void grpc_server_load_reporting_plugin_shutdown() {
+  grpc_server_load_reporting_filter_shutdown();
+}
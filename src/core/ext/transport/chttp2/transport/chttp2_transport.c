@@ -36,6 +36,7 @@
 #include "src/core/lib/compression/stream_compression.h"
 #include "src/core/lib/debug/stats.h"
 #include "src/core/lib/http/parser.h"
+#include "src/core/lib/iomgr/error_internal.h"
 #include "src/core/lib/iomgr/executor.h"
 #include "src/core/lib/iomgr/timer.h"
 #include "src/core/lib/profiling/timers.h"
@@ -174,6 +175,16 @@ static void finish_keepalive_ping_locked(grpc_exec_ctx *exec_ctx, void *arg,
 static void keepalive_watchdog_fired_locked(grpc_exec_ctx *exec_ctx, void *arg,
                                             grpc_error *error);
 
+/** idle memory functions */
+static void note_activity_locked(grpc_exec_ctx *exec_ctx,
+                                 grpc_chttp2_transport *t);
+static void idle_memory_timer_fired_locked(grpc_exec_ctx *exec_ctx, void *arg,
+                                           grpc_error *error);
+static void release_idle_memory_locked(grpc_exec_ctx *exec_ctx,
+                                       grpc_chttp2_transport *t);
+static void update_idle_memory_charge(grpc_exec_ctx *exec_ctx,
+                                      grpc_chttp2_transport *t);
+
 static void reset_byte_stream(grpc_exec_ctx *exec_ctx, void *arg,
                               grpc_error *error);
 
@@ -185,6 +196,10 @@ static void destruct_transport(grpc_exec_ctx *exec_ctx,
                                grpc_chttp2_transport *t) {
   size_t i;
 
+  if (t->idle_memory_charged > 0) {
+    grpc_resource_user_free(exec_ctx, grpc_endpoint_get_resource_user(t->ep),
+                            t->idle_memory_charged);
+  }
   grpc_endpoint_destroy(exec_ctx, t->ep);
 
   grpc_slice_buffer_destroy_internal(exec_ctx, &t->qbuf);
@@ -312,6 +327,9 @@ static void init_transport(grpc_exec_ctx *exec_ctx, grpc_chttp2_transport *t,
   GRPC_CLOSURE_INIT(&t->keepalive_watchdog_fired_locked,
                     keepalive_watchdog_fired_locked, t,
                     grpc_combiner_scheduler(t->combiner));
+  GRPC_CLOSURE_INIT(&t->idle_memory_timer_fired_locked,
+                    idle_memory_timer_fired_locked, t,
+                    grpc_combiner_scheduler(t->combiner));
 
   grpc_bdp_estimator_init(&t->flow_control.bdp_estimator, t->peer_string);
   t->flow_control.last_pid_update = gpr_now(GPR_CLOCK_MONOTONIC);
@@ -500,6 +518,10 @@ static void init_transport(grpc_exec_ctx *exec_ctx, grpc_chttp2_transport *t,
         t->keepalive_permit_without_calls =
             (uint32_t)grpc_channel_arg_get_integer(
                 &channel_args->args[i], (grpc_integer_options){0, 0, 1});
+      } else if (0 == strcmp(channel_args->args[i].key,
+                             GRPC_ARG_IDLE_CONNECTION_MEMORY_RELEASE_MS)) {
+        t->idle_memory_release_ms = grpc_channel_arg_get_integer(
+            &channel_args->args[i], (grpc_integer_options){0, 0, INT_MAX});
       } else if (0 == strcmp(channel_args->args[i].key,
                              GRPC_ARG_OPTIMIZATION_TARGET)) {
         if (channel_args->args[i].type != GRPC_ARG_STRING) {
@@ -591,6 +613,15 @@ static void init_transport(grpc_exec_ctx *exec_ctx, grpc_chttp2_transport *t,
     t->keepalive_state = GRPC_CHTTP2_KEEPALIVE_STATE_DISABLED;
   }
 
+  if (t->idle_memory_release_ms != 0) {
+    /* start out as if released: tables and the stream map are allocated on
+       first use and grow as they fill */
+    grpc_chttp2_stream_map_release_memory(&t->stream_map);
+    grpc_chttp2_hpack_compressor_release_memory(exec_ctx, &t->hpack_compressor);
+    grpc_chttp2_hpack_parser_release_memory(&t->hpack_parser);
+  }
+  note_activity_locked(exec_ctx, t);
+
   grpc_chttp2_initiate_write(exec_ctx, t,
                              GRPC_CHTTP2_INITIATE_WRITE_INITIAL_WRITE);
   post_benign_reclaimer(exec_ctx, t);
@@ -654,6 +685,9 @@ static void close_transport_locked(grpc_exec_ctx *exec_ctx,
         /* keepalive timers are not set in these two states */
         break;
     }
+    if (t->idle_memory_timer_set) {
+      grpc_timer_cancel(exec_ctx, &t->idle_memory_timer);
+    }
 
     /* flush writable stream list to avoid dangling references */
     grpc_chttp2_stream *s;
@@ -1026,6 +1060,7 @@ static void write_action_begin_locked(grpc_exec_ctx *exec_ctx, void *gt,
     r = grpc_chttp2_begin_write(exec_ctx, t);
   }
   if (r.writing) {
+    note_activity_locked(exec_ctx, t);
     if (r.partial) {
       GRPC_STATS_INC_HTTP2_PARTIAL_WRITES(exec_ctx);
     }
@@ -1037,6 +1072,7 @@ static void write_action_begin_locked(grpc_exec_ctx *exec_ctx, void *gt,
     if (scheduler != grpc_schedule_on_exec_ctx) {
       GRPC_STATS_INC_HTTP2_WRITES_OFFLOADED(exec_ctx);
     }
+    t->is_partial_write = r.partial;
     set_write_state(
         exec_ctx, t, r.partial ? GRPC_CHTTP2_WRITE_STATE_WRITING_WITH_MORE
                                : GRPC_CHTTP2_WRITE_STATE_WRITING,
@@ -1055,6 +1091,10 @@ static void write_action_begin_locked(grpc_exec_ctx *exec_ctx, void *gt,
 static void write_action(grpc_exec_ctx *exec_ctx, void *gt, grpc_error *error) {
   grpc_chttp2_transport *t = (grpc_chttp2_transport *)gt;
   GPR_TIMER_BEGIN("write_action", 0);
+  if (t->is_partial_write) {
+    /* lets the endpoint coalesce this write with the next one */
+    grpc_endpoint_hint_write_more(t->ep);
+  }
   grpc_endpoint_write(
       exec_ctx, t->ep, &t->outbuf,
       GRPC_CLOSURE_INIT(&t->write_action_end_locked, write_action_end_locked, t,
@@ -1074,8 +1114,7 @@ static void write_action_end_locked(grpc_exec_ctx *exec_ctx, void *tp,
   if (t->sent_goaway_state == GRPC_CHTTP2_GOAWAY_SEND_SCHEDULED) {
     t->sent_goaway_state = GRPC_CHTTP2_GOAWAY_SENT;
     if (grpc_chttp2_stream_map_size(&t->stream_map) == 0) {
-      close_transport_locked(
-          exec_ctx, t, GRPC_ERROR_CREATE_FROM_STATIC_STRING("goaway sent"));
+      close_transport_locked(exec_ctx, t, GRPC_ERROR_GOAWAY_SENT);
     }
   }
 
@@ -2143,7 +2182,13 @@ static grpc_error *removal_error(grpc_error *extra_error, grpc_chttp2_stream *s,
   add_error(s->write_closed_error, refs, &nrefs);
   add_error(extra_error, refs, &nrefs);
   grpc_error *error = GRPC_ERROR_NONE;
-  if (nrefs > 0) {
+  if (nrefs == 1 &&
+      (grpc_error_is_special(refs[0]) || grpc_error_is_static(refs[0])) &&
+      grpc_error_get_int(refs[0], GRPC_ERROR_INT_GRPC_STATUS, NULL)) {
+    /* a preallocated cause already says all the wrapper would: pass it on
+       rather than allocating for each stream of a cancellation storm */
+    error = GRPC_ERROR_REF(refs[0]);
+  } else if (nrefs > 0) {
     error = GRPC_ERROR_CREATE_REFERENCING_FROM_STATIC_STRING(master_error_msg,
                                                              refs, nrefs);
   }
@@ -2525,6 +2570,7 @@ static void read_action_locked(grpc_exec_ctx *exec_ctx, void *tp,
   GPR_SWAP(grpc_error *, err, error);
   GRPC_ERROR_UNREF(err);
   if (!t->closed) {
+    note_activity_locked(exec_ctx, t);
     GPR_TIMER_BEGIN("reading_action.parse", 0);
     size_t i = 0;
     grpc_error *errors[3] = {GRPC_ERROR_REF(error), GRPC_ERROR_NONE,
@@ -2767,6 +2813,121 @@ static void keepalive_watchdog_fired_locked(grpc_exec_ctx *exec_ctx, void *arg,
   GRPC_CHTTP2_UNREF_TRANSPORT(exec_ctx, t, "keepalive watchdog");
 }
 
+/*******************************************************************************
+ * IDLE CONNECTION MEMORY
+ */
+
+static void start_idle_memory_timer(grpc_exec_ctx *exec_ctx,
+                                    grpc_chttp2_transport *t,
+                                    gpr_timespec deadline) {
+  t->idle_memory_timer_set = true;
+  GRPC_CHTTP2_REF_TRANSPORT(t, "idle_memory_timer");
+  grpc_timer_init(exec_ctx, &t->idle_memory_timer, deadline,
+                  &t->idle_memory_timer_fired_locked,
+                  gpr_now(GPR_CLOCK_MONOTONIC));
+}
+
+/* in idle memory mode, restart the countdown to releasing memory; whatever
+   was released is reallocated as it is used */
+static void note_activity_locked(grpc_exec_ctx *exec_ctx,
+                                 grpc_chttp2_transport *t) {
+  if (t->idle_memory_release_ms == 0) return;
+  t->last_activity = gpr_now(GPR_CLOCK_MONOTONIC);
+  t->idle_memory_released = false;
+  if (!t->idle_memory_timer_set && !t->closed) {
+    start_idle_memory_timer(
+        exec_ctx, t,
+        gpr_time_add(t->last_activity,
+                     gpr_time_from_millis(t->idle_memory_release_ms,
+                                          GPR_TIMESPAN)));
+  }
+}
+
+static void idle_memory_timer_fired_locked(grpc_exec_ctx *exec_ctx, void *arg,
+                                           grpc_error *error) {
+  grpc_chttp2_transport *t = (grpc_chttp2_transport *)arg;
+  t->idle_memory_timer_set = false;
+  if (error == GRPC_ERROR_NONE && !t->closed) {
+    gpr_timespec now = gpr_now(GPR_CLOCK_MONOTONIC);
+    gpr_timespec period =
+        gpr_time_from_millis(t->idle_memory_release_ms, GPR_TIMESPAN);
+    gpr_timespec deadline = gpr_time_add(t->last_activity, period);
+    if (gpr_time_cmp(now, deadline) < 0) {
+      update_idle_memory_charge(exec_ctx, t);
+      start_idle_memory_timer(exec_ctx, t, deadline);
+    } else if (grpc_chttp2_stream_map_size(&t->stream_map) > 0) {
+      /* quiet streams still need their state: look again later */
+      update_idle_memory_charge(exec_ctx, t);
+      start_idle_memory_timer(exec_ctx, t, gpr_time_add(now, period));
+    } else if (!t->idle_memory_released) {
+      release_idle_memory_locked(exec_ctx, t);
+    }
+  }
+  GRPC_CHTTP2_UNREF_TRANSPORT(exec_ctx, t, "idle_memory_timer");
+}
+
+static void release_slice_buffer_memory(grpc_exec_ctx *exec_ctx,
+                                        grpc_slice_buffer *sb) {
+  if (sb->count == 0 && sb->base_slices != sb->inlined) {
+    grpc_slice_buffer_destroy_internal(exec_ctx, sb);
+    grpc_slice_buffer_init(sb);
+  }
+}
+
+/* Free or shrink what an idle transport can rebuild. The read buffer is left
+   alone: the endpoint is reading into it (and in this mode, keeps no memory
+   there while nothing arrives). */
+static void release_idle_memory_locked(grpc_exec_ctx *exec_ctx,
+                                       grpc_chttp2_transport *t) {
+  if (GRPC_TRACER_ON(grpc_http_trace)) {
+    gpr_log(GPR_DEBUG, "HTTP2: %s - release idle connection memory",
+            t->peer_string);
+  }
+  GRPC_STATS_INC_HTTP2_IDLE_MEMORY_RELEASES(exec_ctx);
+  grpc_chttp2_stream_map_release_memory(&t->stream_map);
+  grpc_chttp2_hpack_compressor_release_memory(exec_ctx, &t->hpack_compressor);
+  grpc_chttp2_hpack_parser_release_memory(&t->hpack_parser);
+  release_slice_buffer_memory(exec_ctx, &t->outbuf);
+  release_slice_buffer_memory(exec_ctx, &t->qbuf);
+  t->idle_memory_released = true;
+  update_idle_memory_charge(exec_ctx, t);
+}
+
+/* bytes held in structures that release_idle_memory_locked frees */
+static size_t idle_releasable_bytes(grpc_chttp2_transport *t) {
+  size_t bytes = t->stream_map.capacity * (sizeof(uint32_t) + sizeof(void *));
+  if (t->hpack_compressor.tables != NULL) {
+    bytes += sizeof(*t->hpack_compressor.tables);
+  }
+  bytes += t->hpack_compressor.cap_table_elems * sizeof(uint16_t);
+  bytes += t->hpack_parser.table.cap_entries * sizeof(grpc_mdelem);
+  bytes += t->hpack_parser.key.data.copied.capacity;
+  bytes += t->hpack_parser.value.data.copied.capacity;
+  if (t->outbuf.base_slices != t->outbuf.inlined) {
+    bytes += t->outbuf.capacity * sizeof(grpc_slice);
+  }
+  if (t->qbuf.base_slices != t->qbuf.inlined) {
+    bytes += t->qbuf.capacity * sizeof(grpc_slice);
+  }
+  return bytes;
+}
+
+/* charge the releasable state to the resource quota, so that pressure on it
+   reaches the benign reclaimer; reconciled whenever the idle timer fires */
+static void update_idle_memory_charge(grpc_exec_ctx *exec_ctx,
+                                      grpc_chttp2_transport *t) {
+  grpc_resource_user *resource_user = grpc_endpoint_get_resource_user(t->ep);
+  size_t bytes = idle_releasable_bytes(t);
+  if (bytes > t->idle_memory_charged) {
+    grpc_resource_user_alloc(exec_ctx, resource_user,
+                             bytes - t->idle_memory_charged, NULL);
+  } else if (bytes < t->idle_memory_charged) {
+    grpc_resource_user_free(exec_ctx, resource_user,
+                            t->idle_memory_charged - bytes);
+  }
+  t->idle_memory_charged = bytes;
+}
+
 /*******************************************************************************
  * CALLBACK LOOP
  */
@@ -3099,8 +3260,16 @@ static void post_destructive_reclaimer(grpc_exec_ctx *exec_ctx,
 static void benign_reclaimer_locked(grpc_exec_ctx *exec_ctx, void *arg,
                                     grpc_error *error) {
   grpc_chttp2_transport *t = (grpc_chttp2_transport *)arg;
-  if (error == GRPC_ERROR_NONE &&
+  bool repost = false;
+  if (error == GRPC_ERROR_NONE && t->idle_memory_release_ms != 0 &&
+      !t->idle_memory_released &&
       grpc_chttp2_stream_map_size(&t->stream_map) == 0) {
+    /* Idle channel in idle memory mode: release what can be rebuilt first,
+     * and only ask the peer to go away if that was not enough */
+    release_idle_memory_locked(exec_ctx, t);
+    repost = true;
+  } else if (error == GRPC_ERROR_NONE &&
+             grpc_chttp2_stream_map_size(&t->stream_map) == 0) {
     /* Channel with no active streams: send a goaway to try and make it
      * disconnect cleanly */
     if (GRPC_TRACER_ON(grpc_resource_quota_trace)) {
@@ -3119,6 +3288,9 @@ static void benign_reclaimer_locked(grpc_exec_ctx *exec_ctx, void *arg,
             t->peer_string, grpc_chttp2_stream_map_size(&t->stream_map));
   }
   t->benign_reclaimer_registered = false;
+  if (repost) {
+    post_benign_reclaimer(exec_ctx, t);
+  }
   if (error != GRPC_ERROR_CANCELLED) {
     grpc_resource_user_finish_reclamation(
         exec_ctx, grpc_endpoint_get_resource_user(t->ep));
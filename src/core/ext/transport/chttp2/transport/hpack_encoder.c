@@ -75,6 +75,11 @@ typedef struct {
   /* maximum size of a frame */
   size_t max_frame_size;
   bool use_true_binary_metadata;
+  /* true while everything in this batch has been sent as indexed fields,
+     making its encoding reusable: see grpc_chttp2_hpack_cached_block */
+  bool cacheable;
+  uint8_t num_filter_idx;
+  uint8_t filter_idx[GRPC_CHTTP2_HPACKC_MAX_CACHED_ELEMS];
 } framer_state;
 
 /* fills p (which is expected to be 9 bytes long) with a data frame header */
@@ -166,6 +171,19 @@ static uint8_t *add_tiny_header_data(framer_state *st, size_t len) {
   return grpc_slice_buffer_tiny_add(st->output, len);
 }
 
+/* invalidate all cached blocks: called whenever the decoder table changes */
+static void bump_table_generation(grpc_chttp2_hpack_compressor *c) {
+  if (++c->table_generation == 0) {
+    /* wrapped: make sure no stale block can match again */
+    if (c->tables != NULL) {
+      memset(c->tables->cached_blocks, 0, sizeof(c->tables->cached_blocks));
+    }
+    c->table_generation = 1;
+  }
+}
+
+static void rebuild_elems(grpc_chttp2_hpack_compressor *c, uint32_t new_cap);
+
 static void evict_entry(grpc_chttp2_hpack_compressor *c) {
   c->tail_remote_index++;
   GPR_ASSERT(c->tail_remote_index > 0);
@@ -181,8 +199,11 @@ static void evict_entry(grpc_chttp2_hpack_compressor *c) {
 /* add an element to the decoder table */
 static void add_elem(grpc_exec_ctx *exec_ctx, grpc_chttp2_hpack_compressor *c,
                      grpc_mdelem elem) {
+  grpc_chttp2_hpack_compressor_tables *tbl = c->tables;
   GPR_ASSERT(GRPC_MDELEM_IS_INTERNED(elem));
 
+  bump_table_generation(c);
+
   uint32_t key_hash = grpc_slice_hash(GRPC_MDKEY(elem));
   uint32_t value_hash = grpc_slice_hash(GRPC_MDVALUE(elem));
   uint32_t elem_hash = GRPC_MDSTR_KV_HASH(key_hash, value_hash);
@@ -205,70 +226,74 @@ static void add_elem(grpc_exec_ctx *exec_ctx, grpc_chttp2_hpack_compressor *c,
     evict_entry(c);
   }
   GPR_ASSERT(c->table_elems < c->max_table_size);
+  if (c->grow_on_demand && c->table_elems == c->cap_table_elems) {
+    rebuild_elems(c, GPR_MIN(GPR_MAX(2 * c->cap_table_elems, 16),
+                             c->max_table_elems));
+  }
   c->table_elem_size[new_index % c->cap_table_elems] = (uint16_t)elem_size;
   c->table_size = (uint16_t)(c->table_size + elem_size);
   c->table_elems++;
 
   /* Store this element into {entries,indices}_elem */
-  if (grpc_mdelem_eq(c->entries_elems[HASH_FRAGMENT_2(elem_hash)], elem)) {
+  if (grpc_mdelem_eq(tbl->entries_elems[HASH_FRAGMENT_2(elem_hash)], elem)) {
     /* already there: update with new index */
-    c->indices_elems[HASH_FRAGMENT_2(elem_hash)] = new_index;
-  } else if (grpc_mdelem_eq(c->entries_elems[HASH_FRAGMENT_3(elem_hash)],
+    tbl->indices_elems[HASH_FRAGMENT_2(elem_hash)] = new_index;
+  } else if (grpc_mdelem_eq(tbl->entries_elems[HASH_FRAGMENT_3(elem_hash)],
                             elem)) {
     /* already there (cuckoo): update with new index */
-    c->indices_elems[HASH_FRAGMENT_3(elem_hash)] = new_index;
-  } else if (GRPC_MDISNULL(c->entries_elems[HASH_FRAGMENT_2(elem_hash)])) {
+    tbl->indices_elems[HASH_FRAGMENT_3(elem_hash)] = new_index;
+  } else if (GRPC_MDISNULL(tbl->entries_elems[HASH_FRAGMENT_2(elem_hash)])) {
     /* not there, but a free element: add */
-    c->entries_elems[HASH_FRAGMENT_2(elem_hash)] = GRPC_MDELEM_REF(elem);
-    c->indices_elems[HASH_FRAGMENT_2(elem_hash)] = new_index;
-  } else if (GRPC_MDISNULL(c->entries_elems[HASH_FRAGMENT_3(elem_hash)])) {
+    tbl->entries_elems[HASH_FRAGMENT_2(elem_hash)] = GRPC_MDELEM_REF(elem);
+    tbl->indices_elems[HASH_FRAGMENT_2(elem_hash)] = new_index;
+  } else if (GRPC_MDISNULL(tbl->entries_elems[HASH_FRAGMENT_3(elem_hash)])) {
     /* not there (cuckoo), but a free element: add */
-    c->entries_elems[HASH_FRAGMENT_3(elem_hash)] = GRPC_MDELEM_REF(elem);
-    c->indices_elems[HASH_FRAGMENT_3(elem_hash)] = new_index;
-  } else if (c->indices_elems[HASH_FRAGMENT_2(elem_hash)] <
-             c->indices_elems[HASH_FRAGMENT_3(elem_hash)]) {
+    tbl->entries_elems[HASH_FRAGMENT_3(elem_hash)] = GRPC_MDELEM_REF(elem);
+    tbl->indices_elems[HASH_FRAGMENT_3(elem_hash)] = new_index;
+  } else if (tbl->indices_elems[HASH_FRAGMENT_2(elem_hash)] <
+             tbl->indices_elems[HASH_FRAGMENT_3(elem_hash)]) {
     /* not there: replace oldest */
-    GRPC_MDELEM_UNREF(exec_ctx, c->entries_elems[HASH_FRAGMENT_2(elem_hash)]);
-    c->entries_elems[HASH_FRAGMENT_2(elem_hash)] = GRPC_MDELEM_REF(elem);
-    c->indices_elems[HASH_FRAGMENT_2(elem_hash)] = new_index;
+    GRPC_MDELEM_UNREF(exec_ctx, tbl->entries_elems[HASH_FRAGMENT_2(elem_hash)]);
+    tbl->entries_elems[HASH_FRAGMENT_2(elem_hash)] = GRPC_MDELEM_REF(elem);
+    tbl->indices_elems[HASH_FRAGMENT_2(elem_hash)] = new_index;
   } else {
     /* not there: replace oldest */
-    GRPC_MDELEM_UNREF(exec_ctx, c->entries_elems[HASH_FRAGMENT_3(elem_hash)]);
-    c->entries_elems[HASH_FRAGMENT_3(elem_hash)] = GRPC_MDELEM_REF(elem);
-    c->indices_elems[HASH_FRAGMENT_3(elem_hash)] = new_index;
+    GRPC_MDELEM_UNREF(exec_ctx, tbl->entries_elems[HASH_FRAGMENT_3(elem_hash)]);
+    tbl->entries_elems[HASH_FRAGMENT_3(elem_hash)] = GRPC_MDELEM_REF(elem);
+    tbl->indices_elems[HASH_FRAGMENT_3(elem_hash)] = new_index;
   }
 
   /* do exactly the same for the key (so we can find by that again too) */
 
-  if (grpc_slice_eq(c->entries_keys[HASH_FRAGMENT_2(key_hash)],
+  if (grpc_slice_eq(tbl->entries_keys[HASH_FRAGMENT_2(key_hash)],
                     GRPC_MDKEY(elem))) {
-    c->indices_keys[HASH_FRAGMENT_2(key_hash)] = new_index;
-  } else if (grpc_slice_eq(c->entries_keys[HASH_FRAGMENT_3(key_hash)],
+    tbl->indices_keys[HASH_FRAGMENT_2(key_hash)] = new_index;
+  } else if (grpc_slice_eq(tbl->entries_keys[HASH_FRAGMENT_3(key_hash)],
                            GRPC_MDKEY(elem))) {
-    c->indices_keys[HASH_FRAGMENT_3(key_hash)] = new_index;
-  } else if (c->entries_keys[HASH_FRAGMENT_2(key_hash)].refcount ==
+    tbl->indices_keys[HASH_FRAGMENT_3(key_hash)] = new_index;
+  } else if (tbl->entries_keys[HASH_FRAGMENT_2(key_hash)].refcount ==
              &terminal_slice_refcount) {
-    c->entries_keys[HASH_FRAGMENT_2(key_hash)] =
+    tbl->entries_keys[HASH_FRAGMENT_2(key_hash)] =
         grpc_slice_ref_internal(GRPC_MDKEY(elem));
-    c->indices_keys[HASH_FRAGMENT_2(key_hash)] = new_index;
-  } else if (c->entries_keys[HASH_FRAGMENT_3(key_hash)].refcount ==
+    tbl->indices_keys[HASH_FRAGMENT_2(key_hash)] = new_index;
+  } else if (tbl->entries_keys[HASH_FRAGMENT_3(key_hash)].refcount ==
              &terminal_slice_refcount) {
-    c->entries_keys[HASH_FRAGMENT_3(key_hash)] =
+    tbl->entries_keys[HASH_FRAGMENT_3(key_hash)] =
         grpc_slice_ref_internal(GRPC_MDKEY(elem));
-    c->indices_keys[HASH_FRAGMENT_3(key_hash)] = new_index;
-  } else if (c->indices_keys[HASH_FRAGMENT_2(key_hash)] <
-             c->indices_keys[HASH_FRAGMENT_3(key_hash)]) {
+    tbl->indices_keys[HASH_FRAGMENT_3(key_hash)] = new_index;
+  } else if (tbl->indices_keys[HASH_FRAGMENT_2(key_hash)] <
+             tbl->indices_keys[HASH_FRAGMENT_3(key_hash)]) {
     grpc_slice_unref_internal(exec_ctx,
-                              c->entries_keys[HASH_FRAGMENT_2(key_hash)]);
-    c->entries_keys[HASH_FRAGMENT_2(key_hash)] =
+                              tbl->entries_keys[HASH_FRAGMENT_2(key_hash)]);
+    tbl->entries_keys[HASH_FRAGMENT_2(key_hash)] =
         grpc_slice_ref_internal(GRPC_MDKEY(elem));
-    c->indices_keys[HASH_FRAGMENT_2(key_hash)] = new_index;
+    tbl->indices_keys[HASH_FRAGMENT_2(key_hash)] = new_index;
   } else {
     grpc_slice_unref_internal(exec_ctx,
-                              c->entries_keys[HASH_FRAGMENT_3(key_hash)]);
-    c->entries_keys[HASH_FRAGMENT_3(key_hash)] =
+                              tbl->entries_keys[HASH_FRAGMENT_3(key_hash)]);
+    tbl->entries_keys[HASH_FRAGMENT_3(key_hash)] =
         grpc_slice_ref_internal(GRPC_MDKEY(elem));
-    c->indices_keys[HASH_FRAGMENT_3(key_hash)] = new_index;
+    tbl->indices_keys[HASH_FRAGMENT_3(key_hash)] = new_index;
   }
 }
 
@@ -443,10 +468,12 @@ static void hpack_enc(grpc_exec_ctx *exec_ctx, grpc_chttp2_hpack_compressor *c,
     gpr_free(v);
   }
   if (!GRPC_MDELEM_IS_INTERNED(elem)) {
+    st->cacheable = false;
     emit_lithdr_noidx_v(exec_ctx, c, elem, st);
     return;
   }
 
+  grpc_chttp2_hpack_compressor_tables *tbl = c->tables;
   uint32_t key_hash;
   uint32_t value_hash;
   uint32_t elem_hash;
@@ -458,36 +485,45 @@ static void hpack_enc(grpc_exec_ctx *exec_ctx, grpc_chttp2_hpack_compressor *c,
   value_hash = grpc_slice_hash(GRPC_MDVALUE(elem));
   elem_hash = GRPC_MDSTR_KV_HASH(key_hash, value_hash);
 
-  inc_filter(HASH_FRAGMENT_1(elem_hash), &c->filter_elems_sum, c->filter_elems);
+  inc_filter(HASH_FRAGMENT_1(elem_hash), &tbl->filter_elems_sum,
+             tbl->filter_elems);
+  if (st->num_filter_idx < GRPC_CHTTP2_HPACKC_MAX_CACHED_ELEMS) {
+    st->filter_idx[st->num_filter_idx++] = HASH_FRAGMENT_1(elem_hash);
+  } else {
+    st->cacheable = false;
+  }
 
   /* is this elem currently in the decoders table? */
 
-  if (grpc_mdelem_eq(c->entries_elems[HASH_FRAGMENT_2(elem_hash)], elem) &&
-      c->indices_elems[HASH_FRAGMENT_2(elem_hash)] > c->tail_remote_index) {
+  if (grpc_mdelem_eq(tbl->entries_elems[HASH_FRAGMENT_2(elem_hash)], elem) &&
+      tbl->indices_elems[HASH_FRAGMENT_2(elem_hash)] > c->tail_remote_index) {
     /* HIT: complete element (first cuckoo hash) */
     emit_indexed(exec_ctx, c,
-                 dynidx(c, c->indices_elems[HASH_FRAGMENT_2(elem_hash)]), st);
+                 dynidx(c, tbl->indices_elems[HASH_FRAGMENT_2(elem_hash)]), st);
     return;
   }
 
-  if (grpc_mdelem_eq(c->entries_elems[HASH_FRAGMENT_3(elem_hash)], elem) &&
-      c->indices_elems[HASH_FRAGMENT_3(elem_hash)] > c->tail_remote_index) {
+  if (grpc_mdelem_eq(tbl->entries_elems[HASH_FRAGMENT_3(elem_hash)], elem) &&
+      tbl->indices_elems[HASH_FRAGMENT_3(elem_hash)] > c->tail_remote_index) {
     /* HIT: complete element (second cuckoo hash) */
     emit_indexed(exec_ctx, c,
-                 dynidx(c, c->indices_elems[HASH_FRAGMENT_3(elem_hash)]), st);
+                 dynidx(c, tbl->indices_elems[HASH_FRAGMENT_3(elem_hash)]), st);
     return;
   }
 
+  /* everything from here on emits a literal */
+  st->cacheable = false;
+
   /* should this elem be in the table? */
   decoder_space_usage = grpc_mdelem_get_size_in_hpack_table(elem);
   should_add_elem = decoder_space_usage < MAX_DECODER_SPACE_USAGE &&
-                    c->filter_elems[HASH_FRAGMENT_1(elem_hash)] >=
-                        c->filter_elems_sum / ONE_ON_ADD_PROBABILITY;
+                    tbl->filter_elems[HASH_FRAGMENT_1(elem_hash)] >=
+                        tbl->filter_elems_sum / ONE_ON_ADD_PROBABILITY;
 
   /* no hits for the elem... maybe there's a key? */
 
-  indices_key = c->indices_keys[HASH_FRAGMENT_2(key_hash)];
-  if (grpc_slice_eq(c->entries_keys[HASH_FRAGMENT_2(key_hash)],
+  indices_key = tbl->indices_keys[HASH_FRAGMENT_2(key_hash)];
+  if (grpc_slice_eq(tbl->entries_keys[HASH_FRAGMENT_2(key_hash)],
                     GRPC_MDKEY(elem)) &&
       indices_key > c->tail_remote_index) {
     /* HIT: key (first cuckoo hash) */
@@ -502,8 +538,8 @@ static void hpack_enc(grpc_exec_ctx *exec_ctx, grpc_chttp2_hpack_compressor *c,
     GPR_UNREACHABLE_CODE(return );
   }
 
-  indices_key = c->indices_keys[HASH_FRAGMENT_3(key_hash)];
-  if (grpc_slice_eq(c->entries_keys[HASH_FRAGMENT_3(key_hash)],
+  indices_key = tbl->indices_keys[HASH_FRAGMENT_3(key_hash)];
+  if (grpc_slice_eq(tbl->entries_keys[HASH_FRAGMENT_3(key_hash)],
                     GRPC_MDKEY(elem)) &&
       indices_key > c->tail_remote_index) {
     /* HIT: key (first cuckoo hash) */
@@ -549,33 +585,63 @@ static void deadline_enc(grpc_exec_ctx *exec_ctx,
 
 static uint32_t elems_for_bytes(uint32_t bytes) { return (bytes + 31) / 32; }
 
+static grpc_chttp2_hpack_compressor_tables *create_tables(void) {
+  grpc_chttp2_hpack_compressor_tables *tbl =
+      (grpc_chttp2_hpack_compressor_tables *)gpr_zalloc(sizeof(*tbl));
+  for (size_t i = 0; i < GPR_ARRAY_SIZE(tbl->entries_keys); i++) {
+    tbl->entries_keys[i] = terminal_slice;
+  }
+  return tbl;
+}
+
 void grpc_chttp2_hpack_compressor_init(grpc_chttp2_hpack_compressor *c) {
   memset(c, 0, sizeof(*c));
   c->max_table_size = GRPC_CHTTP2_HPACKC_INITIAL_TABLE_SIZE;
   c->cap_table_elems = elems_for_bytes(c->max_table_size);
   c->max_table_elems = c->cap_table_elems;
   c->max_usable_size = GRPC_CHTTP2_HPACKC_INITIAL_TABLE_SIZE;
+  c->table_generation = 1;
   c->table_elem_size =
       (uint16_t *)gpr_malloc(sizeof(*c->table_elem_size) * c->cap_table_elems);
   memset(c->table_elem_size, 0,
          sizeof(*c->table_elem_size) * c->cap_table_elems);
-  for (size_t i = 0; i < GPR_ARRAY_SIZE(c->entries_keys); i++) {
-    c->entries_keys[i] = terminal_slice;
-  }
+  c->tables = create_tables();
 }
 
-void grpc_chttp2_hpack_compressor_destroy(grpc_exec_ctx *exec_ctx,
-                                          grpc_chttp2_hpack_compressor *c) {
+static void destroy_tables(grpc_exec_ctx *exec_ctx,
+                           grpc_chttp2_hpack_compressor_tables *tbl) {
   int i;
   for (i = 0; i < GRPC_CHTTP2_HPACKC_NUM_VALUES; i++) {
-    if (c->entries_keys[i].refcount != &terminal_slice_refcount) {
-      grpc_slice_unref_internal(exec_ctx, c->entries_keys[i]);
+    if (tbl->entries_keys[i].refcount != &terminal_slice_refcount) {
+      grpc_slice_unref_internal(exec_ctx, tbl->entries_keys[i]);
     }
-    GRPC_MDELEM_UNREF(exec_ctx, c->entries_elems[i]);
+    GRPC_MDELEM_UNREF(exec_ctx, tbl->entries_elems[i]);
+  }
+  gpr_free(tbl);
+}
+
+void grpc_chttp2_hpack_compressor_destroy(grpc_exec_ctx *exec_ctx,
+                                          grpc_chttp2_hpack_compressor *c) {
+  if (c->tables != NULL) {
+    destroy_tables(exec_ctx, c->tables);
   }
   gpr_free(c->table_elem_size);
 }
 
+void grpc_chttp2_hpack_compressor_release_memory(
+    grpc_exec_ctx *exec_ctx, grpc_chttp2_hpack_compressor *c) {
+  c->grow_on_demand = true;
+  if (c->tables != NULL) {
+    /* fresh tables start with no cached blocks, so there is no need to bump
+       the table generation */
+    destroy_tables(exec_ctx, c->tables);
+    c->tables = NULL;
+  }
+  if (c->table_elems < c->cap_table_elems) {
+    rebuild_elems(c, c->table_elems);
+  }
+}
+
 void grpc_chttp2_hpack_compressor_set_max_usable_size(
     grpc_chttp2_hpack_compressor *c, uint32_t max_table_size) {
   c->max_usable_size = max_table_size;
@@ -584,12 +650,15 @@ void grpc_chttp2_hpack_compressor_set_max_usable_size(
 }
 
 static void rebuild_elems(grpc_chttp2_hpack_compressor *c, uint32_t new_cap) {
-  uint16_t *table_elem_size =
-      (uint16_t *)gpr_malloc(sizeof(*table_elem_size) * new_cap);
+  uint16_t *table_elem_size = NULL;
   uint32_t i;
 
-  memset(table_elem_size, 0, sizeof(*table_elem_size) * new_cap);
   GPR_ASSERT(c->table_elems <= new_cap);
+  if (new_cap > 0) {
+    table_elem_size =
+        (uint16_t *)gpr_malloc(sizeof(*table_elem_size) * new_cap);
+    memset(table_elem_size, 0, sizeof(*table_elem_size) * new_cap);
+  }
 
   for (i = 0; i < c->table_elems; i++) {
     uint32_t ofs = c->tail_remote_index + i + 1;
@@ -608,13 +677,17 @@ void grpc_chttp2_hpack_compressor_set_max_table_size(
   if (max_table_size == c->max_table_size) {
     return;
   }
+  bump_table_generation(c);
   while (c->table_size > 0 && c->table_size > max_table_size) {
     evict_entry(c);
   }
   c->max_table_size = max_table_size;
   c->max_table_elems = elems_for_bytes(max_table_size);
   if (c->max_table_elems > c->cap_table_elems) {
-    rebuild_elems(c, GPR_MAX(c->max_table_elems, 2 * c->cap_table_elems));
+    /* when growing on demand, add_elem grows table_elem_size as needed */
+    if (!c->grow_on_demand) {
+      rebuild_elems(c, GPR_MAX(c->max_table_elems, 2 * c->cap_table_elems));
+    }
   } else if (c->max_table_elems < c->cap_table_elems / 3) {
     uint32_t new_cap = GPR_MAX(c->max_table_elems, 16);
     if (new_cap != c->cap_table_elems) {
@@ -627,6 +700,105 @@ void grpc_chttp2_hpack_compressor_set_max_table_size(
   }
 }
 
+/* collect the elements of a batch into elems (which has room for
+   GRPC_CHTTP2_HPACKC_MAX_CACHED_ELEMS): returns false if the batch can never
+   be served from the block cache */
+static bool get_cache_key(grpc_mdelem **extra_headers,
+                          size_t extra_headers_size,
+                          grpc_metadata_batch *metadata, grpc_mdelem *elems,
+                          uint8_t *num_elems) {
+  /* deadlines are encoded relative to the current time */
+  if (gpr_time_cmp(metadata->deadline,
+                   gpr_inf_future(metadata->deadline.clock_type)) != 0) {
+    return false;
+  }
+  uint8_t n = 0;
+  for (size_t i = 0; i < extra_headers_size; ++i) {
+    if (n == GRPC_CHTTP2_HPACKC_MAX_CACHED_ELEMS ||
+        !GRPC_MDELEM_IS_INTERNED(*extra_headers[i])) {
+      return false;
+    }
+    elems[n++] = *extra_headers[i];
+  }
+  for (grpc_linked_mdelem *l = metadata->list.head; l; l = l->next) {
+    if (n == GRPC_CHTTP2_HPACKC_MAX_CACHED_ELEMS ||
+        !GRPC_MDELEM_IS_INTERNED(l->md)) {
+      return false;
+    }
+    elems[n++] = l->md;
+  }
+  *num_elems = n;
+  return true;
+}
+
+static grpc_chttp2_hpack_cached_block *find_cached_block(
+    grpc_chttp2_hpack_compressor *c, const grpc_mdelem *elems,
+    uint8_t num_elems) {
+  grpc_chttp2_hpack_compressor_tables *tbl = c->tables;
+  for (size_t i = 0; i < GRPC_CHTTP2_HPACKC_NUM_CACHED_BLOCKS; i++) {
+    grpc_chttp2_hpack_cached_block *b = &tbl->cached_blocks[i];
+    if (b->table_generation == c->table_generation &&
+        b->num_elems == num_elems &&
+        0 == memcmp(b->elems, elems, num_elems * sizeof(*elems))) {
+      return b;
+    }
+  }
+  return NULL;
+}
+
+/* send a cached block as a single HEADERS frame, updating the compressor
+   exactly as encoding its elements would have */
+static void emit_cached_block(grpc_exec_ctx *exec_ctx,
+                              grpc_chttp2_hpack_compressor *c,
+                              const grpc_chttp2_hpack_cached_block *b,
+                              const grpc_encode_header_options *options,
+                              grpc_slice_buffer *outbuf) {
+  grpc_chttp2_hpack_compressor_tables *tbl = c->tables;
+  GRPC_STATS_INC_HPACK_SEND_CACHED_BLOCK(exec_ctx);
+  for (uint8_t i = 0; i < b->num_elems; i++) {
+    GRPC_STATS_INC_HPACK_SEND_INDEXED(exec_ctx);
+    inc_filter(b->filter_idx[i], &tbl->filter_elems_sum, tbl->filter_elems);
+  }
+  grpc_slice frame = GRPC_SLICE_MALLOC(9 + (size_t)b->length);
+  uint8_t *p = GRPC_SLICE_START_PTR(frame);
+  fill_header(p, GRPC_CHTTP2_FRAME_HEADER, options->stream_id, b->length,
+              (uint8_t)((options->is_eof ? GRPC_CHTTP2_DATA_FLAG_END_STREAM
+                                         : 0) |
+                        GRPC_CHTTP2_DATA_FLAG_END_HEADERS));
+  memcpy(p + 9, b->bytes, b->length);
+  grpc_slice_buffer_add(outbuf, frame);
+  options->stats->framing_bytes += 9;
+  options->stats->header_bytes += b->length;
+}
+
+/* remember the payload of the (single) frame just encoded at header_idx */
+static void add_cached_block(grpc_chttp2_hpack_compressor *c,
+                             const grpc_mdelem *elems, uint8_t num_elems,
+                             const framer_state *st, size_t length) {
+  grpc_chttp2_hpack_compressor_tables *tbl = c->tables;
+  grpc_chttp2_hpack_cached_block *b =
+      &tbl->cached_blocks[tbl->next_cached_block];
+  tbl->next_cached_block = (uint8_t)((tbl->next_cached_block + 1) %
+                                     GRPC_CHTTP2_HPACKC_NUM_CACHED_BLOCKS);
+  b->table_generation = c->table_generation;
+  b->num_elems = num_elems;
+  b->length = (uint8_t)length;
+  memcpy(b->filter_idx, st->filter_idx, num_elems);
+  memcpy(b->elems, elems, num_elems * sizeof(*elems));
+  /* the payload follows the 9 byte frame header, which may share a slice
+     with it */
+  size_t skip = 9;
+  size_t copied = 0;
+  for (size_t i = st->header_idx; copied < length; i++) {
+    grpc_slice slice = st->output->slices[i];
+    size_t slice_len = GRPC_SLICE_LENGTH(slice) - skip;
+    size_t n = GPR_MIN(slice_len, length - copied);
+    memcpy(b->bytes + copied, GRPC_SLICE_START_PTR(slice) + skip, n);
+    copied += n;
+    skip = 0;
+  }
+}
+
 void grpc_chttp2_encode_header(grpc_exec_ctx *exec_ctx,
                                grpc_chttp2_hpack_compressor *c,
                                grpc_mdelem **extra_headers,
@@ -635,6 +807,27 @@ void grpc_chttp2_encode_header(grpc_exec_ctx *exec_ctx,
                                const grpc_encode_header_options *options,
                                grpc_slice_buffer *outbuf) {
   GPR_ASSERT(options->stream_id != 0);
+  if (c->tables == NULL) {
+    /* released while the connection was idle */
+    c->tables = create_tables();
+  }
+
+  /* a batch of interned elements that was last sent as indexed fields
+     against the current decoder table encodes to the same bytes again */
+  grpc_mdelem cache_key[GRPC_CHTTP2_HPACKC_MAX_CACHED_ELEMS];
+  uint8_t cache_key_elems = 0;
+  bool cacheable = c->advertise_table_size_change == 0 &&
+                   get_cache_key(extra_headers, extra_headers_size, metadata,
+                                 cache_key, &cache_key_elems);
+  if (cacheable) {
+    grpc_chttp2_hpack_cached_block *b =
+        find_cached_block(c, cache_key, cache_key_elems);
+    if (b != NULL && b->length <= options->max_frame_size) {
+      grpc_metadata_batch_assert_ok(metadata);
+      emit_cached_block(exec_ctx, c, b, options, outbuf);
+      return;
+    }
+  }
 
   framer_state st;
   st.seen_regular_header = 0;
@@ -644,6 +837,8 @@ void grpc_chttp2_encode_header(grpc_exec_ctx *exec_ctx,
   st.stats = options->stats;
   st.max_frame_size = options->max_frame_size;
   st.use_true_binary_metadata = options->use_true_binary_metadata;
+  st.cacheable = cacheable;
+  st.num_filter_idx = 0;
 
   /* Encode a metadata batch; store the returned values, representing
      a metadata element that needs to be unreffed back into the metadata
@@ -665,5 +860,10 @@ void grpc_chttp2_encode_header(grpc_exec_ctx *exec_ctx,
     deadline_enc(exec_ctx, c, deadline, &st);
   }
 
+  size_t length = st.output->length - st.output_length_at_start_of_frame;
+  if (st.cacheable && st.is_first_frame &&
+      length <= GRPC_CHTTP2_HPACKC_MAX_CACHED_BYTES) {
+    add_cached_block(c, cache_key, cache_key_elems, &st, length);
+  }
   finish_frame(&st, 1, options->is_eof);
 }
@@ -33,23 +33,34 @@
 #define GRPC_CHTTP2_HPACKC_INITIAL_TABLE_SIZE 4096
 /* maximum table size we'll actually use */
 #define GRPC_CHTTP2_HPACKC_MAX_TABLE_SIZE (1024 * 1024)
+/* number of encoded header blocks remembered by each compressor */
+#define GRPC_CHTTP2_HPACKC_NUM_CACHED_BLOCKS 4
+/* largest batch (in elements) and encoding (in bytes) that will be cached */
+#define GRPC_CHTTP2_HPACKC_MAX_CACHED_ELEMS 16
+#define GRPC_CHTTP2_HPACKC_MAX_CACHED_BYTES 48
 
+/* A previously encoded header block made up entirely of indexed fields.
+   Replaying it is only equivalent to re-encoding while the decoder table is
+   unchanged, so it records the table generation it was encoded against. */
 typedef struct {
-  uint32_t filter_elems_sum;
-  uint32_t max_table_size;
-  uint32_t max_table_elems;
-  uint32_t cap_table_elems;
-  /** if non-zero, advertise to the decoder that we'll start using a table
-      of this size */
-  uint8_t advertise_table_size_change;
-  /** maximum number of bytes we'll use for the decode table (to guard against
-      peers ooming us by setting decode table size high) */
-  uint32_t max_usable_size;
-  /* one before the lowest usable table index */
-  uint32_t tail_remote_index;
-  uint32_t table_size;
-  uint32_t table_elems;
+  uint32_t table_generation;
+  uint8_t num_elems;
+  uint8_t length;
+  /* the filter slot each element bumped, replayed on a cache hit so that
+     the popularity counts match an uncached encode */
+  uint8_t filter_idx[GRPC_CHTTP2_HPACKC_MAX_CACHED_ELEMS];
+  /* elements are compared by identity and not reffed: while the table
+     generation matches, entries_elems holds a ref to each of them */
+  grpc_mdelem elems[GRPC_CHTTP2_HPACKC_MAX_CACHED_ELEMS];
+  uint8_t bytes[GRPC_CHTTP2_HPACKC_MAX_CACHED_BYTES];
+} grpc_chttp2_hpack_cached_block;
 
+/* The compressor's guesses at what is in the decoder table, and its cache of
+   encoded blocks. Dropped by grpc_chttp2_hpack_compressor_release_memory and
+   reallocated on next use: forgetting them only costs compression until they
+   are relearned. */
+typedef struct {
+  uint32_t filter_elems_sum;
   /* filter tables for elems: this tables provides an approximate
      popularity count for particular hashes, and are used to determine whether
      a new literal should be added to the compression table or not.
@@ -64,7 +75,38 @@ typedef struct {
   uint32_t indices_keys[GRPC_CHTTP2_HPACKC_NUM_VALUES];
   uint32_t indices_elems[GRPC_CHTTP2_HPACKC_NUM_VALUES];
 
+  /* encodings of recently sent batches, replaced round robin */
+  grpc_chttp2_hpack_cached_block
+      cached_blocks[GRPC_CHTTP2_HPACKC_NUM_CACHED_BLOCKS];
+  uint8_t next_cached_block;
+} grpc_chttp2_hpack_compressor_tables;
+
+typedef struct {
+  uint32_t max_table_size;
+  uint32_t max_table_elems;
+  uint32_t cap_table_elems;
+  /** if non-zero, advertise to the decoder that we'll start using a table
+      of this size */
+  uint8_t advertise_table_size_change;
+  /** maximum number of bytes we'll use for the decode table (to guard against
+      peers ooming us by setting decode table size high) */
+  uint32_t max_usable_size;
+  /* one before the lowest usable table index */
+  uint32_t tail_remote_index;
+  uint32_t table_size;
+  uint32_t table_elems;
+
+  /* sizes of the elements in the decoder table, by index modulo
+     cap_table_elems */
   uint16_t *table_elem_size;
+  /* if set, table_elem_size is grown as elements are added rather than sized
+     for max_table_elems up front: set once memory has been released */
+  bool grow_on_demand;
+
+  /* bumped whenever the decoder table changes (never zero) */
+  uint32_t table_generation;
+  /* NULL from a release until the next header block is encoded */
+  grpc_chttp2_hpack_compressor_tables *tables;
 } grpc_chttp2_hpack_compressor;
 
 void grpc_chttp2_hpack_compressor_init(grpc_chttp2_hpack_compressor *c);
@@ -74,6 +116,11 @@ void grpc_chttp2_hpack_compressor_set_max_table_size(
     grpc_chttp2_hpack_compressor *c, uint32_t max_table_size);
 void grpc_chttp2_hpack_compressor_set_max_usable_size(
     grpc_chttp2_hpack_compressor *c, uint32_t max_table_size);
+/* Free the compressor's tables and shrink its record of the decoder table to
+   fit, for a connection that has gone idle. Encoding reallocates them, and
+   from then on grows the record as the decoder table fills. */
+void grpc_chttp2_hpack_compressor_release_memory(
+    grpc_exec_ctx *exec_ctx, grpc_chttp2_hpack_compressor *c);
 
 typedef struct {
   uint32_t stream_id;
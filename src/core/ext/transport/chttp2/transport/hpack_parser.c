@@ -27,6 +27,7 @@
 #include <grpc/support/log.h>
 #include <grpc/support/port_platform.h>
 #include <grpc/support/string_util.h>
+#include <grpc/support/sync.h>
 #include <grpc/support/useful.h>
 
 #include "src/core/ext/transport/chttp2/transport/bin_encoder.h"
@@ -1445,33 +1446,86 @@ static grpc_error *finish_str(grpc_exec_ctx *exec_ctx,
   return GRPC_ERROR_NONE;
 }
 
-/* decode a nibble from a huffman encoded stream */
-static grpc_error *huff_nibble(grpc_exec_ctx *exec_ctx,
-                               grpc_chttp2_hpack_parser *p, uint8_t nibble) {
-  int16_t emit = emit_sub_tbl[16 * emit_tbl[p->huff_state] + nibble];
-  int16_t next = next_sub_tbl[16 * next_tbl[p->huff_state] + nibble];
-  if (emit != -1) {
-    if (emit >= 0 && emit < 256) {
-      uint8_t c = (uint8_t)emit;
-      grpc_error *err = append_string(exec_ctx, p, &c, (&c) + 1);
-      if (err != GRPC_ERROR_NONE) return err;
-    } else {
-      assert(emit == 256);
+/* decode a nibble from a huffman encoded stream: the reference decoder that
+   the byte table below is derived from */
+static int16_t huff_nibble(int16_t state, uint8_t nibble, uint8_t **out) {
+  int16_t emit = emit_sub_tbl[16 * emit_tbl[state] + nibble];
+  if (emit >= 0 && emit < 256) {
+    *(*out)++ = (uint8_t)emit;
+  } else {
+    assert(emit == -1 || emit == 256);
+  }
+  return next_sub_tbl[16 * next_tbl[state] + nibble];
+}
+
+size_t grpc_chttp2_hpack_huff_decode_nibbles(int16_t *state,
+                                             const uint8_t *in, size_t len,
+                                             uint8_t *out) {
+  uint8_t *start = out;
+  int16_t s = *state;
+  for (size_t i = 0; i < len; i++) {
+    s = huff_nibble(s, in[i] >> 4, &out);
+    s = huff_nibble(s, in[i] & 0xf, &out);
+  }
+  *state = s;
+  return (size_t)(out - start);
+}
+
+/* byte at a time decoding table: indexed by 256 * state + input byte, each
+   entry packs the next state (bits 0-7), up to two emitted bytes (bits 8-15
+   and 16-23) and the number of bytes emitted (bits 24-25). No huffman code is
+   shorter than five bits, so a byte can never complete more than two.
+   Built once from the nibble tables above. */
+static uint32_t huff_byte_tbl[256 * 256];
+static gpr_once huff_byte_tbl_once = GPR_ONCE_INIT;
+
+static void init_huff_byte_tbl(void) {
+  for (int state = 0; state < 256; state++) {
+    for (int byte = 0; byte < 256; byte++) {
+      uint8_t emitted[2];
+      uint8_t *out = emitted;
+      int16_t next = huff_nibble((int16_t)state, (uint8_t)(byte >> 4), &out);
+      next = huff_nibble(next, (uint8_t)(byte & 0xf), &out);
+      uint32_t count = (uint32_t)(out - emitted);
+      GPR_ASSERT(next >= 0 && next < 256);
+      huff_byte_tbl[256 * state + byte] =
+          (uint32_t)next | (count > 0 ? (uint32_t)emitted[0] << 8 : 0) |
+          (count > 1 ? (uint32_t)emitted[1] << 16 : 0) | count << 24;
     }
   }
-  p->huff_state = next;
-  return GRPC_ERROR_NONE;
+}
+
+size_t grpc_chttp2_hpack_huff_decode(int16_t *state, const uint8_t *in,
+                                     size_t len, uint8_t *out) {
+  gpr_once_init(&huff_byte_tbl_once, init_huff_byte_tbl);
+  uint8_t *start = out;
+  uint32_t s = (uint32_t)*state;
+  for (size_t i = 0; i < len; i++) {
+    uint32_t e = huff_byte_tbl[256 * s + in[i]];
+    /* always store both bytes and advance by the count: keeps the loop free
+       of data dependent branches */
+    out[0] = (uint8_t)(e >> 8);
+    out[1] = (uint8_t)(e >> 16);
+    out += e >> 24;
+    s = e & 0xff;
+  }
+  *state = (int16_t)s;
+  return (size_t)(out - start);
 }
 
 /* decode full bytes from a huffman encoded stream */
 static grpc_error *add_huff_bytes(grpc_exec_ctx *exec_ctx,
                                   grpc_chttp2_hpack_parser *p,
                                   const uint8_t *cur, const uint8_t *end) {
-  for (; cur != end; ++cur) {
-    grpc_error *err = huff_nibble(exec_ctx, p, *cur >> 4);
-    if (err != GRPC_ERROR_NONE) return parse_error(exec_ctx, p, cur, end, err);
-    err = huff_nibble(exec_ctx, p, *cur & 0xf);
+  /* decode in chunks so that the decoded output reaches append_string in
+     bulk rather than a byte at a time */
+  uint8_t decoded[2 * 128];
+  while (cur != end) {
+    size_t n = GPR_MIN((size_t)(end - cur), sizeof(decoded) / 2);
+    size_t len = grpc_chttp2_hpack_huff_decode(&p->huff_state, cur, n, decoded);
+    grpc_error *err = append_string(exec_ctx, p, decoded, decoded + len);
     if (err != GRPC_ERROR_NONE) return parse_error(exec_ctx, p, cur, end, err);
+    cur += n;
   }
   return GRPC_ERROR_NONE;
 }
@@ -1638,6 +1692,22 @@ void grpc_chttp2_hpack_parser_destroy(grpc_exec_ctx *exec_ctx,
   gpr_free(p->value.data.copied.str);
 }
 
+static void release_string(grpc_chttp2_hpack_parser_string *str) {
+  gpr_free(str->data.copied.str);
+  str->data.copied.str = NULL;
+  str->data.copied.capacity = 0;
+  str->data.copied.length = 0;
+}
+
+void grpc_chttp2_hpack_parser_release_memory(grpc_chttp2_hpack_parser *p) {
+  /* between fields the string buffers hold nothing that is still needed */
+  if (p->state == parse_begin) {
+    release_string(&p->key);
+    release_string(&p->value);
+  }
+  grpc_chttp2_hptbl_shrink_to_fit(&p->table);
+}
+
 grpc_error *grpc_chttp2_hpack_parser_parse(grpc_exec_ctx *exec_ctx,
                                            grpc_chttp2_hpack_parser *p,
                                            grpc_slice slice) {
@@ -97,12 +97,27 @@ void grpc_chttp2_hpack_parser_init(grpc_exec_ctx *exec_ctx,
 void grpc_chttp2_hpack_parser_destroy(grpc_exec_ctx *exec_ctx,
                                       grpc_chttp2_hpack_parser *p);
 
+/* Free the string buffers and shrink the table to fit, for a connection that
+   has gone idle: both grow back as headers are parsed */
+void grpc_chttp2_hpack_parser_release_memory(grpc_chttp2_hpack_parser *p);
+
 void grpc_chttp2_hpack_parser_set_has_priority(grpc_chttp2_hpack_parser *p);
 
 grpc_error *grpc_chttp2_hpack_parser_parse(grpc_exec_ctx *exec_ctx,
                                            grpc_chttp2_hpack_parser *p,
                                            grpc_slice slice);
 
+/* Huffman decode len bytes from in, continuing from *state (zero at the start
+   of a string) and updating it. out must have room for 2 * len bytes; returns
+   the number of bytes written. Consumes a whole input byte per lookup. */
+size_t grpc_chttp2_hpack_huff_decode(int16_t *state, const uint8_t *in,
+                                     size_t len, uint8_t *out);
+/* Reference implementation of grpc_chttp2_hpack_huff_decode that walks the
+   code a nibble at a time: exposed for testing */
+size_t grpc_chttp2_hpack_huff_decode_nibbles(int16_t *state,
+                                             const uint8_t *in, size_t len,
+                                             uint8_t *out);
+
 /* wraps grpc_chttp2_hpack_parser_parse to provide a frame level parser for
    the transport */
 grpc_error *grpc_chttp2_header_parser_parse(grpc_exec_ctx *exec_ctx,
@@ -228,9 +228,13 @@ static void evict1(grpc_exec_ctx *exec_ctx, grpc_chttp2_hptbl *tbl) {
 }
 
 static void rebuild_ents(grpc_chttp2_hptbl *tbl, uint32_t new_cap) {
-  grpc_mdelem *ents = (grpc_mdelem *)gpr_malloc(sizeof(*ents) * new_cap);
+  grpc_mdelem *ents = NULL;
   uint32_t i;
 
+  GPR_ASSERT(tbl->num_ents <= new_cap);
+  if (new_cap > 0) {
+    ents = (grpc_mdelem *)gpr_malloc(sizeof(*ents) * new_cap);
+  }
   for (i = 0; i < tbl->num_ents; i++) {
     ents[i] = tbl->ents[(tbl->first_ent + i) % tbl->cap_entries];
   }
@@ -279,7 +283,10 @@ grpc_error *grpc_chttp2_hptbl_set_current_table_size(grpc_exec_ctx *exec_ctx,
   tbl->current_table_bytes = bytes;
   tbl->max_entries = entries_for_bytes(bytes);
   if (tbl->max_entries > tbl->cap_entries) {
-    rebuild_ents(tbl, GPR_MAX(tbl->max_entries, 2 * tbl->cap_entries));
+    /* when growing on demand, grpc_chttp2_hptbl_add grows ents as needed */
+    if (!tbl->grow_on_demand) {
+      rebuild_ents(tbl, GPR_MAX(tbl->max_entries, 2 * tbl->cap_entries));
+    }
   } else if (tbl->max_entries < tbl->cap_entries / 3) {
     uint32_t new_cap = GPR_MAX(tbl->max_entries, 16u);
     if (new_cap != tbl->cap_entries) {
@@ -330,6 +337,14 @@ grpc_error *grpc_chttp2_hptbl_add(grpc_exec_ctx *exec_ctx,
     evict1(exec_ctx, tbl);
   }
 
+  /* when growing on demand, grow ents if full: entries take at least
+     GRPC_CHTTP2_HPACK_ENTRY_OVERHEAD bytes each, so there is always room for
+     this one within max_entries */
+  if (tbl->grow_on_demand && tbl->num_ents == tbl->cap_entries) {
+    rebuild_ents(tbl, GPR_MIN(GPR_MAX(2 * tbl->cap_entries, 16u),
+                              tbl->max_entries));
+  }
+
   /* copy the finalized entry in */
   tbl->ents[(tbl->first_ent + tbl->num_ents) % tbl->cap_entries] =
       GRPC_MDELEM_REF(md);
@@ -340,6 +355,13 @@ grpc_error *grpc_chttp2_hptbl_add(grpc_exec_ctx *exec_ctx,
   return GRPC_ERROR_NONE;
 }
 
+void grpc_chttp2_hptbl_shrink_to_fit(grpc_chttp2_hptbl *tbl) {
+  tbl->grow_on_demand = true;
+  if (tbl->num_ents < tbl->cap_entries) {
+    rebuild_ents(tbl, tbl->num_ents);
+  }
+}
+
 grpc_chttp2_hptbl_find_result grpc_chttp2_hptbl_find(
     const grpc_chttp2_hptbl *tbl, grpc_mdelem md) {
   grpc_chttp2_hptbl_find_result r = {0, 0};
@@ -61,6 +61,9 @@ typedef struct {
   uint32_t max_entries;
   /* Number of entries allocated in ents */
   uint32_t cap_entries;
+  /* if set, ents is grown as entries are added rather than sized for
+     max_entries up front: set once the table has been shrunk to fit */
+  bool grow_on_demand;
   /* a circular buffer of headers - this is stored in the opposite order to
      what hpack specifies, in order to simplify table management a little...
      meaning lookups need to SUBTRACT from the end position */
@@ -85,6 +88,9 @@ grpc_mdelem grpc_chttp2_hptbl_lookup(const grpc_chttp2_hptbl *tbl,
 grpc_error *grpc_chttp2_hptbl_add(grpc_exec_ctx *exec_ctx,
                                   grpc_chttp2_hptbl *tbl,
                                   grpc_mdelem md) GRPC_MUST_USE_RESULT;
+/* release the unused part of the entry buffer; from then on it grows back as
+   entries are added */
+void grpc_chttp2_hptbl_shrink_to_fit(grpc_chttp2_hptbl *tbl);
 /* Find a key/value pair in the table... returns the index in the table of the
    most similar entry, or 0 if the value was not found */
 typedef struct {
@@ -293,6 +293,9 @@ struct grpc_chttp2_transport {
       set when we initiate writing from idle, cleared when we
       initiate writing from writing+more */
   bool is_first_write_in_batch;
+  /** does the write being handed to the endpoint leave streams queued, so
+      that another write is certain to follow it? */
+  bool is_partial_write;
 
   /** is the transport destroying itself? */
   uint8_t destroying;
@@ -462,6 +465,22 @@ struct grpc_chttp2_transport {
   bool keepalive_permit_without_calls;
   /** keep-alive state machine state */
   grpc_chttp2_keepalive_state keepalive_state;
+
+  /* idle connection memory mode (GRPC_ARG_IDLE_CONNECTION_MEMORY_RELEASE_MS) */
+  /** how long the transport must be quiet before releasing memory: zero if
+      the mode is off */
+  int idle_memory_release_ms;
+  /** when the transport last read or wrote */
+  gpr_timespec last_activity;
+  /** have buffers and tables been released since then? */
+  bool idle_memory_released;
+  /** is idle_memory_timer pending? */
+  bool idle_memory_timer_set;
+  /** fires to check whether the transport has been quiet long enough */
+  grpc_timer idle_memory_timer;
+  grpc_closure idle_memory_timer_fired_locked;
+  /** bytes of releasable state charged to the endpoint's resource user */
+  size_t idle_memory_charged;
 };
 
 typedef enum {
@@ -39,6 +39,16 @@ void grpc_chttp2_stream_map_destroy(grpc_chttp2_stream_map *map) {
   gpr_free(map->values);
 }
 
+void grpc_chttp2_stream_map_release_memory(grpc_chttp2_stream_map *map) {
+  if (map->count == 0) {
+    gpr_free(map->keys);
+    gpr_free(map->values);
+    map->keys = NULL;
+    map->values = NULL;
+    map->capacity = 0;
+  }
+}
+
 static size_t compact(uint32_t *keys, void **values, size_t count) {
   size_t i, out;
 
@@ -70,8 +80,10 @@ void grpc_chttp2_stream_map_add(grpc_chttp2_stream_map *map, uint32_t key,
       map->free = 0;
     } else {
       /* resize when less than 25% of the table is free, because compaction
-         won't help much */
-      map->capacity = capacity = 3 * capacity / 2;
+         won't help much; only a map released by
+         grpc_chttp2_stream_map_release_memory is empty, and it starts over at
+         8 entries */
+      map->capacity = capacity = capacity == 0 ? 8 : 3 * capacity / 2;
       map->keys = keys =
           (uint32_t *)gpr_realloc(keys, capacity * sizeof(uint32_t));
       map->values = values =
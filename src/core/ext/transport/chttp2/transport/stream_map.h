@@ -41,6 +41,9 @@ void grpc_chttp2_stream_map_init(grpc_chttp2_stream_map *map,
                                  size_t initial_capacity);
 void grpc_chttp2_stream_map_destroy(grpc_chttp2_stream_map *map);
 
+/* Free the storage of an empty map: the next add reallocates it */
+void grpc_chttp2_stream_map_release_memory(grpc_chttp2_stream_map *map);
+
 /* Add a new key: given http2 semantics, new keys must always be greater than
    existing keys - this is asserted */
 void grpc_chttp2_stream_map_add(grpc_chttp2_stream_map *map, uint32_t key,
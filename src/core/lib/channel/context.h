@@ -38,6 +38,10 @@ typedef enum {
   /// Value is a \a grpc_grpclb_client_stats.
   GRPC_GRPCLB_CLIENT_STATS,
 
+  /// Value is set by the LB policy that picked the call's subchannel, if it
+  /// tracks calls: destroying it tells the policy that the call has ended.
+  GRPC_CONTEXT_LB_CALL_TRACKER,
+
   GRPC_CONTEXT_COUNT
 } grpc_context_index;
 
@@ -28,6 +28,10 @@ void grpc_endpoint_write(grpc_exec_ctx* exec_ctx, grpc_endpoint* ep,
   ep->vtable->write(exec_ctx, ep, slices, cb);
 }
 
+void grpc_endpoint_hint_write_more(grpc_endpoint* ep) {
+  ep->vtable->hint_write_more(ep);
+}
+
 void grpc_endpoint_add_to_pollset(grpc_exec_ctx* exec_ctx, grpc_endpoint* ep,
                                   grpc_pollset* pollset) {
   ep->vtable->add_to_pollset(exec_ctx, ep, pollset);
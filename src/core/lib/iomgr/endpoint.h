@@ -46,6 +46,7 @@ struct grpc_endpoint_vtable {
   grpc_resource_user *(*get_resource_user)(grpc_endpoint *ep);
   char *(*get_peer)(grpc_endpoint *ep);
   int (*get_fd)(grpc_endpoint *ep);
+  void (*hint_write_more)(grpc_endpoint *ep);
 };
 
 /* When data is available on the connection, calls the callback with slices.
@@ -75,6 +76,11 @@ int grpc_endpoint_get_fd(grpc_endpoint *ep);
 void grpc_endpoint_write(grpc_exec_ctx *exec_ctx, grpc_endpoint *ep,
                          grpc_slice_buffer *slices, grpc_closure *cb);
 
+/* Hint that another write will be issued on \a ep as soon as the next write
+   completes. Applies to the next grpc_endpoint_write only: endpoints may use
+   it to hold back a trailing partial packet until that write arrives. */
+void grpc_endpoint_hint_write_more(grpc_endpoint *ep);
+
 /* Causes any pending and future read/write callbacks to run immediately with
    success==0 */
 void grpc_endpoint_shutdown(grpc_exec_ctx *exec_ctx, grpc_endpoint *ep,
@@ -125,9 +125,26 @@ bool grpc_error_is_special(grpc_error *err) {
          err == GRPC_ERROR_CANCELLED;
 }
 
+// Storage for one static error: room for a grpc status and two strings
+typedef union {
+  grpc_error error;
+  intptr_t slots[(sizeof(grpc_error) + sizeof(intptr_t) +
+                  2 * sizeof(grpc_slice)) /
+                 sizeof(intptr_t)];
+} static_error;
+
+// All static errors live in one array, so telling them apart from allocated
+// errors is a range check
+static static_error g_static_errors[GRPC_STATIC_ERROR_COUNT];
+
+bool grpc_error_is_static(grpc_error *err) {
+  return (uintptr_t)err - (uintptr_t)g_static_errors <
+         sizeof(g_static_errors);
+}
+
 #ifndef NDEBUG
 grpc_error *grpc_error_ref(grpc_error *err, const char *file, int line) {
-  if (grpc_error_is_special(err)) return err;
+  if (grpc_error_is_special(err) || grpc_error_is_static(err)) return err;
   if (GRPC_TRACER_ON(grpc_trace_error_refcount)) {
     gpr_log(GPR_DEBUG, "%p: %" PRIdPTR " -> %" PRIdPTR " [%s:%d]", err,
             gpr_atm_no_barrier_load(&err->atomics.refs.count),
@@ -138,7 +155,7 @@ grpc_error *grpc_error_ref(grpc_error *err, const char *file, int line) {
 }
 #else
 grpc_error *grpc_error_ref(grpc_error *err) {
-  if (grpc_error_is_special(err)) return err;
+  if (grpc_error_is_special(err) || grpc_error_is_static(err)) return err;
   gpr_ref(&err->atomics.refs);
   return err;
 }
@@ -180,7 +197,7 @@ static void error_destroy(grpc_error *err) {
 
 #ifndef NDEBUG
 void grpc_error_unref(grpc_error *err, const char *file, int line) {
-  if (grpc_error_is_special(err)) return;
+  if (grpc_error_is_special(err) || grpc_error_is_static(err)) return;
   if (GRPC_TRACER_ON(grpc_trace_error_refcount)) {
     gpr_log(GPR_DEBUG, "%p: %" PRIdPTR " -> %" PRIdPTR " [%s:%d]", err,
             gpr_atm_no_barrier_load(&err->atomics.refs.count),
@@ -192,7 +209,7 @@ void grpc_error_unref(grpc_error *err, const char *file, int line) {
 }
 #else
 void grpc_error_unref(grpc_error *err) {
-  if (grpc_error_is_special(err)) return;
+  if (grpc_error_is_special(err) || grpc_error_is_static(err)) return;
   if (gpr_unref(&err->atomics.refs)) {
     error_destroy(err);
   }
@@ -397,7 +414,9 @@ static grpc_error *copy_error_and_unref(grpc_error *in) {
                        grpc_slice_from_static_string("cancelled"));
       internal_set_int(&out, GRPC_ERROR_INT_GRPC_STATUS, GRPC_STATUS_CANCELLED);
     }
-  } else if (gpr_ref_is_unique(&in->atomics.refs)) {
+  } else if (!grpc_error_is_static(in) &&
+             gpr_ref_is_unique(&in->atomics.refs)) {
+    // static errors are shared however many refs they appear to have
     out = in;
   } else {
     uint8_t new_arena_capacity = in->arena_capacity;
@@ -724,18 +743,7 @@ static char *finish_kvs(kv_pairs *kvs) {
   return s;
 }
 
-const char *grpc_error_string(grpc_error *err) {
-  GPR_TIMER_BEGIN("grpc_error_string", 0);
-  if (err == GRPC_ERROR_NONE) return no_error_string;
-  if (err == GRPC_ERROR_OOM) return oom_error_string;
-  if (err == GRPC_ERROR_CANCELLED) return cancelled_error_string;
-
-  void *p = (void *)gpr_atm_acq_load(&err->atomics.error_string);
-  if (p != NULL) {
-    GPR_TIMER_END("grpc_error_string", 0);
-    return (const char *)p;
-  }
-
+static char *format_error(grpc_error *err) {
   kv_pairs kvs;
   memset(&kvs, 0, sizeof(kvs));
 
@@ -748,7 +756,22 @@ const char *grpc_error_string(grpc_error *err) {
 
   qsort(kvs.kvs, kvs.num_kvs, sizeof(kv_pair), cmp_kvs);
 
-  char *out = finish_kvs(&kvs);
+  return finish_kvs(&kvs);
+}
+
+const char *grpc_error_string(grpc_error *err) {
+  GPR_TIMER_BEGIN("grpc_error_string", 0);
+  if (err == GRPC_ERROR_NONE) return no_error_string;
+  if (err == GRPC_ERROR_OOM) return oom_error_string;
+  if (err == GRPC_ERROR_CANCELLED) return cancelled_error_string;
+
+  void *p = (void *)gpr_atm_acq_load(&err->atomics.error_string);
+  if (p != NULL) {
+    GPR_TIMER_END("grpc_error_string", 0);
+    return (const char *)p;
+  }
+
+  char *out = format_error(err);
 
   if (!gpr_atm_rel_cas(&err->atomics.error_string, 0, (gpr_atm)out)) {
     gpr_free(out);
@@ -759,6 +782,64 @@ const char *grpc_error_string(grpc_error *err) {
   return out;
 }
 
+typedef struct {
+  const char *description;
+  // -1 for none
+  int status;
+} static_error_def;
+
+static const static_error_def static_error_defs[GRPC_STATIC_ERROR_COUNT] = {
+    {"Deadline Exceeded", GRPC_STATUS_DEADLINE_EXCEEDED},
+    {"Server Shutdown", -1},
+    {"Server shutdown", GRPC_STATUS_OK},
+    {"goaway sent", -1},
+};
+
+// Longest string form of a static error
+#define MAX_STATIC_ERROR_STRING 128
+
+static char g_static_error_strings[GRPC_STATIC_ERROR_COUNT]
+                                  [MAX_STATIC_ERROR_STRING];
+static gpr_once g_static_errors_once = GPR_ONCE_INIT;
+
+// Static errors carry no file, line or creation time: they are shared by
+// every site that raises them. Their strings are formatted up front into
+// static buffers, which (unlike cached strings) are never freed.
+static void init_static_errors(void) {
+  for (size_t i = 0; i < GRPC_STATIC_ERROR_COUNT; i++) {
+    grpc_error *err = &g_static_errors[i].error;
+    err->arena_size = 0;
+    err->arena_capacity = (uint8_t)(GPR_ARRAY_SIZE(g_static_errors[i].slots) -
+                                    sizeof(grpc_error) / sizeof(intptr_t));
+    err->first_err = UINT8_MAX;
+    err->last_err = UINT8_MAX;
+    memset(err->ints, UINT8_MAX, GRPC_ERROR_INT_MAX);
+    memset(err->strs, UINT8_MAX, GRPC_ERROR_STR_MAX);
+    memset(err->times, UINT8_MAX, GRPC_ERROR_TIME_MAX);
+    gpr_ref_init(&err->atomics.refs, 1);
+    internal_set_str(
+        &err, GRPC_ERROR_STR_DESCRIPTION,
+        grpc_slice_from_static_string(static_error_defs[i].description));
+    if (static_error_defs[i].status != -1) {
+      internal_set_int(&err, GRPC_ERROR_INT_GRPC_STATUS,
+                       static_error_defs[i].status);
+    }
+    // the storage must have been large enough not to be reallocated
+    GPR_ASSERT(err == &g_static_errors[i].error);
+    char *str = format_error(err);
+    GPR_ASSERT(strlen(str) < MAX_STATIC_ERROR_STRING);
+    strcpy(g_static_error_strings[i], str);
+    gpr_free(str);
+    gpr_atm_no_barrier_store(&err->atomics.error_string,
+                             (gpr_atm)g_static_error_strings[i]);
+  }
+}
+
+grpc_error *grpc_error_static(grpc_static_error which) {
+  gpr_once_init(&g_static_errors_once, init_static_errors);
+  return &g_static_errors[which].error;
+}
+
 grpc_error *grpc_os_error(const char *file, int line, int err,
                           const char *call_name) {
   return grpc_error_set_str(
@@ -126,6 +126,38 @@ typedef enum {
 #define GRPC_ERROR_OOM ((grpc_error *)2)
 #define GRPC_ERROR_CANCELLED ((grpc_error *)4)
 
+/// Immutable errors preallocated for failures that tend to arrive in storms:
+/// every call on a channel reaching its deadline, or a server shutting down
+/// with calls pending and connections open. Like the special errors they are never allocated or
+/// freed, but they carry real attributes (see grpc_static_error), and their
+/// string form is built once. Setting an attribute on one, or adding a
+/// child, returns a newly allocated copy.
+
+typedef enum {
+  /// "Deadline Exceeded", with grpc status DEADLINE_EXCEEDED
+  GRPC_STATIC_ERROR_DEADLINE_EXCEEDED,
+  /// "Server Shutdown"
+  GRPC_STATIC_ERROR_SERVER_SHUTDOWN,
+  /// "Server shutdown", with grpc status OK: the GOAWAY a shutting down
+  /// server sends on each of its connections
+  GRPC_STATIC_ERROR_SERVER_GOAWAY,
+  /// "goaway sent": a transport closing once its GOAWAY is written and no
+  /// streams are left
+  GRPC_STATIC_ERROR_GOAWAY_SENT,
+
+  /// Must always be last
+  GRPC_STATIC_ERROR_COUNT,
+} grpc_static_error;
+
+grpc_error *grpc_error_static(grpc_static_error which);
+#define GRPC_ERROR_DEADLINE_EXCEEDED \
+  grpc_error_static(GRPC_STATIC_ERROR_DEADLINE_EXCEEDED)
+#define GRPC_ERROR_SERVER_SHUTDOWN \
+  grpc_error_static(GRPC_STATIC_ERROR_SERVER_SHUTDOWN)
+#define GRPC_ERROR_SERVER_GOAWAY \
+  grpc_error_static(GRPC_STATIC_ERROR_SERVER_GOAWAY)
+#define GRPC_ERROR_GOAWAY_SENT grpc_error_static(GRPC_STATIC_ERROR_GOAWAY_SENT)
+
 const char *grpc_error_string(grpc_error *error);
 
 /// Create an error - but use GRPC_ERROR_CREATE instead
@@ -56,5 +56,7 @@ struct grpc_error {
 };
 
 bool grpc_error_is_special(grpc_error *err);
+// True for the preallocated errors returned by grpc_error_static
+bool grpc_error_is_static(grpc_error *err);
 
 #endif /* GRPC_CORE_LIB_IOMGR_ERROR_INTERNAL_H */
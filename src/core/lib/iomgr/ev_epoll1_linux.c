@@ -388,6 +388,9 @@ static gpr_atm g_active_poller;
 static pollset_neighborhood *g_neighborhoods;
 static size_t g_num_neighborhoods;
 
+/* The kernel polling object the designated poller waits on */
+static const grpc_epoll1_poller_vtable *g_poller;
+
 /* Return true if first in list */
 static bool worker_insert(grpc_pollset *pollset, grpc_pollset_worker *worker) {
   if (pollset->root_worker == NULL) {
@@ -429,20 +432,12 @@ static size_t choose_neighborhood(void) {
   return (size_t)gpr_cpu_current_cpu() % g_num_neighborhoods;
 }
 
-static grpc_error *pollset_global_init(void) {
+grpc_error *grpc_epoll1_pollset_global_init(
+    const grpc_epoll1_poller_vtable *poller) {
   gpr_tls_init(&g_current_thread_pollset);
   gpr_tls_init(&g_current_thread_worker);
   gpr_atm_no_barrier_store(&g_active_poller, 0);
-  global_wakeup_fd.read_fd = -1;
-  grpc_error *err = grpc_wakeup_fd_init(&global_wakeup_fd);
-  if (err != GRPC_ERROR_NONE) return err;
-  struct epoll_event ev;
-  ev.events = (uint32_t)(EPOLLIN | EPOLLET);
-  ev.data.ptr = &global_wakeup_fd;
-  if (epoll_ctl(g_epoll_set.epfd, EPOLL_CTL_ADD, global_wakeup_fd.read_fd,
-                &ev) != 0) {
-    return GRPC_OS_ERROR(errno, "epoll_ctl");
-  }
+  g_poller = poller;
   g_num_neighborhoods = GPR_CLAMP(gpr_cpu_num_cores(), 1, MAX_NEIGHBORHOODS);
   g_neighborhoods = (pollset_neighborhood *)gpr_zalloc(
       sizeof(*g_neighborhoods) * g_num_neighborhoods);
@@ -452,10 +447,9 @@ static grpc_error *pollset_global_init(void) {
   return GRPC_ERROR_NONE;
 }
 
-static void pollset_global_shutdown(void) {
+void grpc_epoll1_pollset_global_shutdown(void) {
   gpr_tls_destroy(&g_current_thread_pollset);
   gpr_tls_destroy(&g_current_thread_worker);
-  if (global_wakeup_fd.read_fd != -1) grpc_wakeup_fd_destroy(&global_wakeup_fd);
   for (size_t i = 0; i < g_num_neighborhoods; i++) {
     gpr_mu_destroy(&g_neighborhoods[i].mu);
   }
@@ -526,8 +520,7 @@ static grpc_error *pollset_kick_all(grpc_exec_ctx *exec_ctx,
         case DESIGNATED_POLLER:
           GRPC_STATS_INC_POLLSET_KICK_WAKEUP_FD(exec_ctx);
           SET_KICK_STATE(worker, KICKED);
-          append_error(&error, grpc_wakeup_fd_wakeup(&global_wakeup_fd),
-                       "pollset_kick_all");
+          append_error(&error, g_poller->wakeup(), "pollset_kick_all");
           break;
       }
 
@@ -562,8 +555,8 @@ static void pollset_shutdown(grpc_exec_ctx *exec_ctx, grpc_pollset *pollset,
   GPR_TIMER_END("pollset_shutdown", 0);
 }
 
-static int poll_deadline_to_millis_timeout(gpr_timespec deadline,
-                                           gpr_timespec now) {
+int grpc_epoll1_poll_deadline_to_millis_timeout(gpr_timespec deadline,
+                                                gpr_timespec now) {
   gpr_timespec timeout;
   if (gpr_time_cmp(deadline, gpr_inf_future(deadline.clock_type)) == 0) {
     return -1;
@@ -583,6 +576,15 @@ static int poll_deadline_to_millis_timeout(gpr_timespec deadline,
   return millis >= 1 ? millis : 1;
 }
 
+static grpc_error *epoll_wakeup(void) {
+  return grpc_wakeup_fd_wakeup(&global_wakeup_fd);
+}
+
+static bool epoll_has_pending_events(void) {
+  return gpr_atm_acq_load(&g_epoll_set.cursor) !=
+         gpr_atm_acq_load(&g_epoll_set.num_events);
+}
+
 /* Process the epoll events found by do_epoll_wait() function.
    - g_epoll_set.cursor points to the index of the first event to be processed
    - This function then processes up-to MAX_EPOLL_EVENTS_PER_ITERATION and
@@ -641,7 +643,7 @@ static grpc_error *do_epoll_wait(grpc_exec_ctx *exec_ctx, grpc_pollset *ps,
   GPR_TIMER_BEGIN("do_epoll_wait", 0);
 
   int r;
-  int timeout = poll_deadline_to_millis_timeout(deadline, now);
+  int timeout = grpc_epoll1_poll_deadline_to_millis_timeout(deadline, now);
   if (timeout != 0) {
     GRPC_SCHEDULING_START_BLOCKING_REGION;
   }
@@ -962,24 +964,22 @@ static grpc_error *pollset_work(grpc_exec_ctx *exec_ctx, grpc_pollset *ps,
     gpr_mu_unlock(&ps->mu); /* unlock */
     /* This is the designated polling thread at this point and should ideally do
        polling. However, if there are unprocessed events left from a previous
-       call to do_epoll_wait(), skip calling epoll_wait() in this iteration and
-       process the pending epoll events.
-
-       The reason for decoupling do_epoll_wait and process_epoll_events is to
-       better distrubute the work (i.e handling epoll events) across multiple
-       threads
-
-       process_epoll_events() returns very quickly: It just queues the work on
-       exec_ctx but does not execute it (the actual exectution or more
-       accurately grpc_exec_ctx_flush() happens in end_worker() AFTER selecting
-       a designated poller). So we are not waiting long periods without a
-       designated poller */
-    if (gpr_atm_acq_load(&g_epoll_set.cursor) ==
-        gpr_atm_acq_load(&g_epoll_set.num_events)) {
-      append_error(&error, do_epoll_wait(exec_ctx, ps, now, deadline),
+       wait (eg. do_epoll_wait()), skip waiting in this iteration and process
+       the pending events.
+
+       The reason for decoupling the wait and process_events is to better
+       distrubute the work (i.e handling epoll events) across multiple threads
+
+       process_events (eg. process_epoll_events()) returns very quickly: It just
+       queues the work on exec_ctx but does not execute it (the actual
+       exectution or more accurately grpc_exec_ctx_flush() happens in
+       end_worker() AFTER selecting a designated poller). So we are not waiting
+       long periods without a designated poller */
+    if (!g_poller->has_pending_events()) {
+      append_error(&error, g_poller->wait(exec_ctx, ps, now, deadline),
                    err_desc);
     }
-    append_error(&error, process_epoll_events(exec_ctx, ps), err_desc);
+    append_error(&error, g_poller->process_events(exec_ctx, ps), err_desc);
 
     gpr_mu_lock(&ps->mu); /* lock */
 
@@ -1062,7 +1062,7 @@ static grpc_error *pollset_kick(grpc_exec_ctx *exec_ctx, grpc_pollset *pollset,
           gpr_log(GPR_ERROR, " .. kicked %p", root_worker);
         }
         SET_KICK_STATE(root_worker, KICKED);
-        ret_err = grpc_wakeup_fd_wakeup(&global_wakeup_fd);
+        ret_err = g_poller->wakeup();
         goto done;
       } else if (next_worker->state == UNKICKED) {
         GRPC_STATS_INC_POLLSET_KICK_WAKEUP_CV(exec_ctx);
@@ -1094,7 +1094,7 @@ static grpc_error *pollset_kick(grpc_exec_ctx *exec_ctx, grpc_pollset *pollset,
                     root_worker);
           }
           SET_KICK_STATE(next_worker, KICKED);
-          ret_err = grpc_wakeup_fd_wakeup(&global_wakeup_fd);
+          ret_err = g_poller->wakeup();
           goto done;
         }
       } else {
@@ -1134,7 +1134,7 @@ static grpc_error *pollset_kick(grpc_exec_ctx *exec_ctx, grpc_pollset *pollset,
       gpr_log(GPR_ERROR, " .. kick active poller");
     }
     SET_KICK_STATE(specific_worker, KICKED);
-    ret_err = grpc_wakeup_fd_wakeup(&global_wakeup_fd);
+    ret_err = g_poller->wakeup();
     goto done;
   } else if (specific_worker->initialized_cv) {
     GRPC_STATS_INC_POLLSET_KICK_WAKEUP_CV(exec_ctx);
@@ -1195,9 +1195,53 @@ static void pollset_set_del_pollset_set(grpc_exec_ctx *exec_ctx,
  * Event engine binding
  */
 
+void grpc_epoll1_fill_pollset_vtable(grpc_event_engine_vtable *vtable) {
+  vtable->pollset_size = sizeof(grpc_pollset);
+
+  vtable->pollset_init = pollset_init;
+  vtable->pollset_shutdown = pollset_shutdown;
+  vtable->pollset_destroy = pollset_destroy;
+  vtable->pollset_work = pollset_work;
+  vtable->pollset_kick = pollset_kick;
+  vtable->pollset_add_fd = pollset_add_fd;
+
+  vtable->pollset_set_create = pollset_set_create;
+  vtable->pollset_set_destroy = pollset_set_destroy;
+  vtable->pollset_set_add_pollset = pollset_set_add_pollset;
+  vtable->pollset_set_del_pollset = pollset_set_del_pollset;
+  vtable->pollset_set_add_pollset_set = pollset_set_add_pollset_set;
+  vtable->pollset_set_del_pollset_set = pollset_set_del_pollset_set;
+  vtable->pollset_set_add_fd = pollset_set_add_fd;
+  vtable->pollset_set_del_fd = pollset_set_del_fd;
+}
+
+static const grpc_epoll1_poller_vtable epoll_poller = {
+    epoll_wakeup, do_epoll_wait, epoll_has_pending_events,
+    process_epoll_events,
+};
+
+static grpc_error *wakeup_fd_init(void) {
+  global_wakeup_fd.read_fd = -1;
+  grpc_error *err = grpc_wakeup_fd_init(&global_wakeup_fd);
+  if (err != GRPC_ERROR_NONE) return err;
+  struct epoll_event ev;
+  ev.events = (uint32_t)(EPOLLIN | EPOLLET);
+  ev.data.ptr = &global_wakeup_fd;
+  if (epoll_ctl(g_epoll_set.epfd, EPOLL_CTL_ADD, global_wakeup_fd.read_fd,
+                &ev) != 0) {
+    return GRPC_OS_ERROR(errno, "epoll_ctl");
+  }
+  return GRPC_ERROR_NONE;
+}
+
+static void wakeup_fd_shutdown(void) {
+  if (global_wakeup_fd.read_fd != -1) grpc_wakeup_fd_destroy(&global_wakeup_fd);
+}
+
 static void shutdown_engine(void) {
   fd_global_shutdown();
-  pollset_global_shutdown();
+  grpc_epoll1_pollset_global_shutdown();
+  wakeup_fd_shutdown();
   epoll_set_shutdown();
 }
 
@@ -1246,7 +1290,16 @@ const grpc_event_engine_vtable *grpc_init_epoll1_linux(bool explicit_request) {
 
   fd_global_init();
 
-  if (!GRPC_LOG_IF_ERROR("pollset_global_init", pollset_global_init())) {
+  if (!GRPC_LOG_IF_ERROR("wakeup_fd_init", wakeup_fd_init())) {
+    wakeup_fd_shutdown();
+    fd_global_shutdown();
+    epoll_set_shutdown();
+    return NULL;
+  }
+
+  if (!GRPC_LOG_IF_ERROR("pollset_global_init",
+                         grpc_epoll1_pollset_global_init(&epoll_poller))) {
+    wakeup_fd_shutdown();
     fd_global_shutdown();
     epoll_set_shutdown();
     return NULL;
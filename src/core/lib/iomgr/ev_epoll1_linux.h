@@ -26,4 +26,35 @@
 
 const grpc_event_engine_vtable *grpc_init_epoll1_linux(bool explicit_request);
 
+/* The pollsets of this engine only ever have their designated poller wait on
+   a single process-wide kernel object, so other engines built the same way
+   (see ev_uring_linux.c) reuse them, supplying that object through this
+   vtable. Only one engine may use them at a time. */
+typedef struct grpc_epoll1_poller_vtable {
+  /* Return the designated poller from a wait in progress (or make its next
+     wait return immediately) */
+  grpc_error *(*wakeup)(void);
+  /* Wait until deadline for events and stash them for process_events; called
+     by the designated poller only */
+  grpc_error *(*wait)(grpc_exec_ctx *exec_ctx, grpc_pollset *ps,
+                      gpr_timespec now, gpr_timespec deadline);
+  /* Whether events stashed by the last wait are still to be processed */
+  bool (*has_pending_events)(void);
+  /* Process some of the stashed events, scheduling their closures on
+     exec_ctx; called by the designated poller only */
+  grpc_error *(*process_events)(grpc_exec_ctx *exec_ctx, grpc_pollset *ps);
+} grpc_epoll1_poller_vtable;
+
+grpc_error *grpc_epoll1_pollset_global_init(
+    const grpc_epoll1_poller_vtable *poller);
+void grpc_epoll1_pollset_global_shutdown(void);
+
+/* Fill in pollset_size and the pollset and pollset_set functions of vtable */
+void grpc_epoll1_fill_pollset_vtable(grpc_event_engine_vtable *vtable);
+
+/* Milliseconds to wait for deadline: -1 for an infinite deadline, otherwise
+   rounded up */
+int grpc_epoll1_poll_deadline_to_millis_timeout(gpr_timespec deadline,
+                                                gpr_timespec now);
+
 #endif /* GRPC_CORE_LIB_IOMGR_EV_EPOLL1_LINUX_H */
@@ -34,6 +34,7 @@
 #include "src/core/lib/iomgr/ev_epollex_linux.h"
 #include "src/core/lib/iomgr/ev_epollsig_linux.h"
 #include "src/core/lib/iomgr/ev_poll_posix.h"
+#include "src/core/lib/iomgr/ev_uring_linux.h"
 #include "src/core/lib/support/env.h"
 
 grpc_tracer_flag grpc_polling_trace =
@@ -67,6 +68,7 @@ static const event_engine_factory g_factories[] = {
     {"poll", grpc_init_poll_posix},
     {"poll-cv", grpc_init_poll_cv_posix},
     {"epollex", grpc_init_epollex_linux},
+    {"uring", grpc_init_uring_linux},
 };
 
 static void add(const char *beg, const char *end, char ***ss, size_t *ns) {
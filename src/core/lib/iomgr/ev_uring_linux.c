@@ -0,0 +1,967 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/lib/iomgr/port.h"
+
+/* This polling engine is only relevant on linux kernels supporting io_uring */
+#ifdef GRPC_LINUX_IO_URING
+
+#include <linux/io_uring.h>
+
+#endif
+
+/* Multishot poll requests (and the extended io_uring_enter() argument used to
+ * pass a timeout) first appeared in linux 5.13 and 5.11 respectively; older
+ * uapi headers are treated the same as having no io_uring at all */
+#if defined(GRPC_LINUX_IO_URING) && defined(IORING_POLL_ADD_MULTI) && \
+    defined(IORING_ENTER_EXT_ARG) && defined(IORING_FEAT_RSRC_TAGS)
+
+#include "src/core/lib/iomgr/ev_uring_linux.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/cpu.h>
+#include <grpc/support/log.h>
+#include <grpc/support/string_util.h>
+#include <grpc/support/tls.h>
+#include <grpc/support/useful.h>
+
+#include "src/core/lib/debug/stats.h"
+#include "src/core/lib/iomgr/ev_epoll1_linux.h"
+#include "src/core/lib/iomgr/ev_posix.h"
+#include "src/core/lib/iomgr/iomgr_internal.h"
+#include "src/core/lib/iomgr/lockfree_event.h"
+#include "src/core/lib/profiling/timers.h"
+#include "src/core/lib/support/block_annotate.h"
+#include "src/core/lib/support/string.h"
+
+/*******************************************************************************
+ * Singleton io_uring instance related fields
+ */
+
+#define URING_SQ_ENTRIES 256
+#define URING_CQ_ENTRIES 4096
+#define MAX_URING_EVENTS 100
+#define MAX_URING_EVENTS_HANDLED_PER_ITERATION 1
+
+/* Every completion carries a tag in the low bits of its user_data. For polls
+ * the rest of user_data is the (suitably aligned) grpc_fd pointer, with the
+ * generation of the poll that produced the completion in the top 16 bits,
+ * which user space addresses never use. For io operations it is the
+ * grpc_uring_op pointer */
+#define URING_TAG_MASK ((uint64_t)0x3)
+#define URING_TAG_POLL ((uint64_t)0x0)
+#define URING_TAG_WAKEUP ((uint64_t)0x1)
+#define URING_TAG_CANCEL ((uint64_t)0x2)
+#define URING_TAG_OP ((uint64_t)0x3)
+#define URING_GEN_SHIFT 48
+#define URING_GEN_MASK ((uint64_t)0xffff)
+#define URING_FD_ALIGN_LOG 6
+
+typedef struct uring_event {
+  uint64_t user_data;
+  int32_t res;
+  uint32_t flags;
+} uring_event;
+
+/* NOTE ON SYNCHRONIZATION:
+ * - The submission queue may be written by any thread (fd creation and
+ *   removal, kicks, poll re-arming), so it is protected by sq_mu.
+ * - The completion queue and the events/num_events/cursor fields are only
+ *   modified by the designated poller. Hence there is no need for any locks to
+ *   protect them.
+ * - num_events and cursor fields have to be of atomic type to provide memory
+ *   visibility guarantees only. i.e In case of multiple pollers, the designated
+ *   polling thread keeps changing; the thread that wrote these values may be
+ *   different from the thread reading the values
+ */
+typedef struct uring_set {
+  int ring_fd;
+
+  void *sq_ring;
+  size_t sq_ring_size;
+  void *cq_ring;
+  size_t cq_ring_size;
+  struct io_uring_sqe *sqes;
+  size_t sqes_size;
+
+  gpr_mu sq_mu;
+  unsigned *sq_head;
+  unsigned *sq_tail;
+  unsigned sq_mask;
+  unsigned sq_entries;
+
+  unsigned *cq_head;
+  unsigned *cq_tail;
+  unsigned cq_mask;
+  struct io_uring_cqe *cqes;
+
+  /* The completions reaped by the last call to do_uring_wait() */
+  uring_event events[MAX_URING_EVENTS];
+
+  /* The number of completions reaped by the last call to do_uring_wait() */
+  gpr_atm num_events;
+
+  /* Index of the first event in events that has to be processed. This field is
+   * only valid if num_events > 0 */
+  gpr_atm cursor;
+} uring_set;
+
+/* The global singleton io_uring instance */
+static uring_set g_uring;
+
+/* Whether this engine is in use (see grpc_uring_enabled()) */
+static bool g_uring_enabled;
+
+/* Whether the current thread has an io operation batch waiting to be handed
+   to the kernel by uring_flush_batch() */
+GPR_TLS_DECL(g_uring_batch_pending);
+
+static int sys_io_uring_setup(unsigned entries, struct io_uring_params *p) {
+  return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int sys_io_uring_enter(int ring_fd, unsigned to_submit,
+                              unsigned min_complete, unsigned flags, void *arg,
+                              size_t argsz) {
+  return (int)syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete,
+                      flags, arg, argsz);
+}
+
+static void uring_set_unmap(void) {
+  if (g_uring.sqes != NULL) munmap(g_uring.sqes, g_uring.sqes_size);
+  if (g_uring.cq_ring != NULL && g_uring.cq_ring != g_uring.sq_ring) {
+    munmap(g_uring.cq_ring, g_uring.cq_ring_size);
+  }
+  if (g_uring.sq_ring != NULL) munmap(g_uring.sq_ring, g_uring.sq_ring_size);
+  g_uring.sqes = NULL;
+  g_uring.cq_ring = g_uring.sq_ring = NULL;
+}
+
+/* Must be called *only* once */
+static bool uring_set_init() {
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  params.flags = IORING_SETUP_CQSIZE;
+  params.cq_entries = URING_CQ_ENTRIES;
+  g_uring.ring_fd = sys_io_uring_setup(URING_SQ_ENTRIES, &params);
+  if (g_uring.ring_fd < 0) {
+    gpr_log(GPR_ERROR, "io_uring unavailable: %s", strerror(errno));
+    return false;
+  }
+  /* Kernels that predate multishot polls or timed waits are unusable. Neither
+   * can be probed directly, so use the feature bits introduced alongside */
+  if ((params.features & IORING_FEAT_EXT_ARG) == 0 ||
+      (params.features & IORING_FEAT_RSRC_TAGS) == 0) {
+    gpr_log(GPR_ERROR, "io_uring lacks multishot poll support");
+    close(g_uring.ring_fd);
+    g_uring.ring_fd = -1;
+    return false;
+  }
+
+  g_uring.sq_ring_size =
+      params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  g_uring.cq_ring_size =
+      params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    g_uring.sq_ring_size = g_uring.cq_ring_size =
+        GPR_MAX(g_uring.sq_ring_size, g_uring.cq_ring_size);
+  }
+  g_uring.sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+  g_uring.sq_ring =
+      mmap(NULL, g_uring.sq_ring_size, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_POPULATE, g_uring.ring_fd, IORING_OFF_SQ_RING);
+  if (g_uring.sq_ring == MAP_FAILED) g_uring.sq_ring = NULL;
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    g_uring.cq_ring = g_uring.sq_ring;
+  } else if (g_uring.sq_ring != NULL) {
+    g_uring.cq_ring =
+        mmap(NULL, g_uring.cq_ring_size, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, g_uring.ring_fd, IORING_OFF_CQ_RING);
+    if (g_uring.cq_ring == MAP_FAILED) g_uring.cq_ring = NULL;
+  }
+  if (g_uring.cq_ring != NULL) {
+    g_uring.sqes = (struct io_uring_sqe *)mmap(
+        NULL, g_uring.sqes_size, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, g_uring.ring_fd, IORING_OFF_SQES);
+    if (g_uring.sqes == MAP_FAILED) g_uring.sqes = NULL;
+  }
+  if (g_uring.sqes == NULL) {
+    gpr_log(GPR_ERROR, "io_uring mmap failed: %s", strerror(errno));
+    uring_set_unmap();
+    close(g_uring.ring_fd);
+    g_uring.ring_fd = -1;
+    return false;
+  }
+
+  char *sq = (char *)g_uring.sq_ring;
+  g_uring.sq_head = (unsigned *)(sq + params.sq_off.head);
+  g_uring.sq_tail = (unsigned *)(sq + params.sq_off.tail);
+  g_uring.sq_mask = *(unsigned *)(sq + params.sq_off.ring_mask);
+  g_uring.sq_entries = params.sq_entries;
+  /* sqes are always used in ring order, so the indirection array is fixed */
+  unsigned *sq_array = (unsigned *)(sq + params.sq_off.array);
+  for (unsigned i = 0; i < params.sq_entries; i++) {
+    sq_array[i] = i;
+  }
+  char *cq = (char *)g_uring.cq_ring;
+  g_uring.cq_head = (unsigned *)(cq + params.cq_off.head);
+  g_uring.cq_tail = (unsigned *)(cq + params.cq_off.tail);
+  g_uring.cq_mask = *(unsigned *)(cq + params.cq_off.ring_mask);
+  g_uring.cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+  gpr_mu_init(&g_uring.sq_mu);
+
+  gpr_log(GPR_INFO, "grpc io_uring fd: %d", g_uring.ring_fd);
+  gpr_atm_no_barrier_store(&g_uring.num_events, 0);
+  gpr_atm_no_barrier_store(&g_uring.cursor, 0);
+  return true;
+}
+
+/* uring_set_init() MUST be called before calling this. */
+static void uring_set_shutdown() {
+  if (g_uring.ring_fd >= 0) {
+    uring_set_unmap();
+    close(g_uring.ring_fd);
+    g_uring.ring_fd = -1;
+    gpr_mu_destroy(&g_uring.sq_mu);
+  }
+}
+
+/* Number of sqes queued in the submission ring but not yet consumed by the
+ * kernel. Unless handed over explicitly, they are submitted together with the
+ * next io_uring_enter() made by the designated poller */
+static unsigned uring_sq_pending(void) {
+  return *g_uring.sq_tail - __atomic_load_n(g_uring.sq_head, __ATOMIC_ACQUIRE);
+}
+
+/* Hand every queued sqe to the kernel. g_uring.sq_mu must be held */
+static grpc_error *uring_submit_locked(void) {
+  unsigned to_submit;
+  while ((to_submit = uring_sq_pending()) > 0) {
+    if (sys_io_uring_enter(g_uring.ring_fd, to_submit, 0, 0, NULL, 0) < 0 &&
+        errno != EINTR) {
+      return GRPC_OS_ERROR(errno, "io_uring_enter");
+    }
+  }
+  return GRPC_ERROR_NONE;
+}
+
+/* Return a zeroed sqe at the tail of the submission ring, flushing the ring
+ * first if it is full. The sqe only becomes visible to the kernel once it is
+ * published by uring_queue_sqe_locked(): pollers enter the ring without
+ * holding g_uring.sq_mu and must never see a half-filled sqe.
+ * g_uring.sq_mu must be held */
+static struct io_uring_sqe *uring_get_sqe_locked(void) {
+  if (uring_sq_pending() >= g_uring.sq_entries) {
+    GRPC_LOG_IF_ERROR("uring_get_sqe", uring_submit_locked());
+  }
+  struct io_uring_sqe *sqe = &g_uring.sqes[*g_uring.sq_tail & g_uring.sq_mask];
+  memset(sqe, 0, sizeof(*sqe));
+  return sqe;
+}
+
+/* g_uring.sq_mu must be held */
+static void uring_queue_sqe_locked(void) {
+  __atomic_store_n(g_uring.sq_tail, *g_uring.sq_tail + 1, __ATOMIC_RELEASE);
+}
+
+/* The alarm system needs to be able to wakeup 'some poller' sometimes
+ * (specifically when a new alarm needs to be triggered earlier than the next
+ * alarm 'epoch'). Instead of a wakeup fd, a no-op request is submitted: its
+ * completion is enough to return the designated poller from io_uring_enter(),
+ * and there is nothing left to consume afterwards. */
+static grpc_error *uring_wakeup(void) {
+  gpr_mu_lock(&g_uring.sq_mu);
+  struct io_uring_sqe *sqe = uring_get_sqe_locked();
+  sqe->opcode = IORING_OP_NOP;
+  sqe->user_data = URING_TAG_WAKEUP;
+  uring_queue_sqe_locked();
+  grpc_error *err = uring_submit_locked();
+  gpr_mu_unlock(&g_uring.sq_mu);
+  return err;
+}
+
+/*******************************************************************************
+ * Fd Declarations
+ */
+
+struct grpc_fd {
+  int fd;
+
+  /* Generation of the multishot poll currently armed for this fd, folded into
+   * the completion's user_data so that completions posted for a previous user
+   * of this (freelisted) grpc_fd can be told apart. Written under
+   * g_uring.sq_mu (which also protects 'orphaned') and read without it by
+   * the poller. */
+  gpr_atm poll_gen;
+  bool orphaned;
+
+  /* Whether a poll is armed. It only is once somebody waits for the fd to be
+   * readable or writable: fds whose io runs through grpc_uring_op (endpoints,
+   * listeners) do not need one. Written under g_uring.sq_mu */
+  gpr_atm poll_armed;
+
+  gpr_atm read_closure;
+  gpr_atm write_closure;
+
+  struct grpc_fd *freelist_next;
+
+  /* The pollset that last noticed that the fd is readable. The actual type
+   * stored in this is (grpc_pollset *) */
+  gpr_atm read_notifier_pollset;
+
+  grpc_iomgr_object iomgr_object;
+};
+
+static void fd_global_init(void);
+static void fd_global_shutdown(void);
+
+/*******************************************************************************
+ * Common helpers
+ */
+
+static bool append_error(grpc_error **composite, grpc_error *error,
+                         const char *desc) {
+  if (error == GRPC_ERROR_NONE) return true;
+  if (*composite == GRPC_ERROR_NONE) {
+    *composite = GRPC_ERROR_CREATE_FROM_COPIED_STRING(desc);
+  }
+  *composite = grpc_error_add_child(*composite, error);
+  return false;
+}
+
+/*******************************************************************************
+ * Fd Definitions
+ */
+
+/* We need to keep a freelist not because of any concerns of malloc performance
+ * but instead so that implementations with multiple threads in (for example)
+ * io_uring_enter deal with the race between fd removal and incoming poll
+ * completions.
+ *
+ * The problem is that the poller ultimately holds a reference to this
+ * object, so it is very difficult to know when is safe to free it, at least
+ * without some expensive synchronization.
+ *
+ * If we keep the object freelisted, in the worst case losing this race just
+ * becomes a stale completion, which is recognized by its poll generation.
+ */
+
+static grpc_fd *fd_freelist = NULL;
+static gpr_mu fd_freelist_mu;
+
+static void fd_global_init(void) { gpr_mu_init(&fd_freelist_mu); }
+
+static void fd_global_shutdown(void) {
+  gpr_mu_lock(&fd_freelist_mu);
+  gpr_mu_unlock(&fd_freelist_mu);
+  while (fd_freelist != NULL) {
+    grpc_fd *fd = fd_freelist;
+    fd_freelist = fd_freelist->freelist_next;
+    gpr_free_aligned(fd);
+  }
+  gpr_mu_destroy(&fd_freelist_mu);
+}
+
+static uint64_t uring_poll_tag(grpc_fd *fd) {
+  uint64_t gen = (uint64_t)gpr_atm_no_barrier_load(&fd->poll_gen);
+  return (uint64_t)(uintptr_t)fd | (gen << URING_GEN_SHIFT) | URING_TAG_POLL;
+}
+
+/* Queue a multishot poll for fd. Like an EPOLLET registration, it produces a
+ * completion each time the fd's readiness changes until it is removed (or
+ * until the kernel terminates it, in which case it is re-armed by
+ * process_uring_events()). g_uring.sq_mu must be held */
+static void uring_arm_poll_locked(grpc_fd *fd) {
+  struct io_uring_sqe *sqe = uring_get_sqe_locked();
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = fd->fd;
+  sqe->len = IORING_POLL_ADD_MULTI;
+  uint32_t events = POLLIN | POLLPRI | POLLOUT;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  events = (events << 16) | (events >> 16);
+#endif
+  sqe->poll32_events = events;
+  sqe->user_data = uring_poll_tag(fd);
+  uring_queue_sqe_locked();
+}
+
+static grpc_fd *fd_create(int fd, const char *name) {
+  grpc_fd *new_fd = NULL;
+
+  gpr_mu_lock(&fd_freelist_mu);
+  if (fd_freelist != NULL) {
+    new_fd = fd_freelist;
+    fd_freelist = fd_freelist->freelist_next;
+  }
+  gpr_mu_unlock(&fd_freelist_mu);
+
+  if (new_fd == NULL) {
+    new_fd = (grpc_fd *)gpr_malloc_aligned(sizeof(grpc_fd), URING_FD_ALIGN_LOG);
+    GPR_ASSERT(((uint64_t)(uintptr_t)new_fd >> URING_GEN_SHIFT) == 0);
+    gpr_atm_no_barrier_store(&new_fd->poll_gen, 0);
+  }
+
+  new_fd->fd = fd;
+  grpc_lfev_init(&new_fd->read_closure);
+  grpc_lfev_init(&new_fd->write_closure);
+  gpr_atm_no_barrier_store(&new_fd->read_notifier_pollset, (gpr_atm)NULL);
+
+  new_fd->freelist_next = NULL;
+
+  char *fd_name;
+  gpr_asprintf(&fd_name, "%s fd=%d", name, fd);
+  grpc_iomgr_register_object(&new_fd->iomgr_object, fd_name);
+#ifndef NDEBUG
+  if (GRPC_TRACER_ON(grpc_trace_fd_refcount)) {
+    gpr_log(GPR_DEBUG, "FD %d %p create %s", fd, new_fd, fd_name);
+  }
+#endif
+  gpr_free(fd_name);
+
+  gpr_mu_lock(&g_uring.sq_mu);
+  gpr_atm_rel_store(
+      &new_fd->poll_gen,
+      (gpr_atm)(((uint64_t)gpr_atm_no_barrier_load(&new_fd->poll_gen) + 1) &
+                URING_GEN_MASK));
+  new_fd->orphaned = false;
+  gpr_atm_no_barrier_store(&new_fd->poll_armed, 0);
+  gpr_mu_unlock(&g_uring.sq_mu);
+
+  return new_fd;
+}
+
+/* Arm the poll of fd if it is not yet. This happens right away rather than
+ * being left for the next poller to submit: the designated poller may be
+ * blocked in io_uring_enter() and would not notice the new poll until it is
+ * woken up */
+static void uring_ensure_poll(grpc_fd *fd) {
+  if (gpr_atm_acq_load(&fd->poll_armed)) return;
+  grpc_error *err = GRPC_ERROR_NONE;
+  gpr_mu_lock(&g_uring.sq_mu);
+  if (!gpr_atm_no_barrier_load(&fd->poll_armed) && !fd->orphaned) {
+    uring_arm_poll_locked(fd);
+    gpr_atm_rel_store(&fd->poll_armed, 1);
+    err = uring_submit_locked();
+  }
+  gpr_mu_unlock(&g_uring.sq_mu);
+  GRPC_LOG_IF_ERROR("uring_ensure_poll", err);
+}
+
+/* Queue the removal of the poll armed for fd, if any. Its completions carry
+ * the current generation, so bumping it turns those still in flight stale.
+ * g_uring.sq_mu must be held */
+static void uring_remove_poll_locked(grpc_fd *fd) {
+  if (!gpr_atm_no_barrier_load(&fd->poll_armed)) return;
+  struct io_uring_sqe *sqe = uring_get_sqe_locked();
+  sqe->opcode = IORING_OP_POLL_REMOVE;
+  sqe->fd = -1;
+  sqe->addr = uring_poll_tag(fd);
+  sqe->user_data = URING_TAG_CANCEL;
+  uring_queue_sqe_locked();
+  gpr_atm_rel_store(
+      &fd->poll_gen,
+      (gpr_atm)(((uint64_t)gpr_atm_no_barrier_load(&fd->poll_gen) + 1) &
+                URING_GEN_MASK));
+  gpr_atm_rel_store(&fd->poll_armed, 0);
+}
+
+static int fd_wrapped_fd(grpc_fd *fd) { return fd->fd; }
+
+/* if 'releasing_fd' is true, it means that we are going to detach the internal
+ * fd from grpc_fd structure (i.e which means we should not be calling
+ * shutdown() syscall on that fd) */
+static void fd_shutdown_internal(grpc_exec_ctx *exec_ctx, grpc_fd *fd,
+                                 grpc_error *why, bool releasing_fd) {
+  if (grpc_lfev_set_shutdown(exec_ctx, &fd->read_closure,
+                             GRPC_ERROR_REF(why))) {
+    if (!releasing_fd) {
+      shutdown(fd->fd, SHUT_RDWR);
+    }
+    grpc_lfev_set_shutdown(exec_ctx, &fd->write_closure, GRPC_ERROR_REF(why));
+  }
+  GRPC_ERROR_UNREF(why);
+}
+
+/* Might be called multiple times */
+static void fd_shutdown(grpc_exec_ctx *exec_ctx, grpc_fd *fd, grpc_error *why) {
+  fd_shutdown_internal(exec_ctx, fd, why, false);
+}
+
+static void fd_orphan(grpc_exec_ctx *exec_ctx, grpc_fd *fd,
+                      grpc_closure *on_done, int *release_fd,
+                      bool already_closed, const char *reason) {
+  grpc_error *error = GRPC_ERROR_NONE;
+  bool is_release_fd = (release_fd != NULL);
+
+  if (!grpc_lfev_is_shutdown(&fd->read_closure)) {
+    fd_shutdown_internal(exec_ctx, fd,
+                         GRPC_ERROR_CREATE_FROM_COPIED_STRING(reason),
+                         is_release_fd);
+  }
+
+  /* The armed poll holds a reference to the underlying file, so it has to be
+     removed before the fd is closed (or handed back to the caller) */
+  gpr_mu_lock(&g_uring.sq_mu);
+  fd->orphaned = true;
+  if (gpr_atm_no_barrier_load(&fd->poll_armed)) {
+    uring_remove_poll_locked(fd);
+    append_error(&error, uring_submit_locked(), "fd_orphan");
+  }
+  gpr_mu_unlock(&g_uring.sq_mu);
+
+  /* If release_fd is not NULL, we should be relinquishing control of the file
+     descriptor fd->fd (but we still own the grpc_fd structure). */
+  if (is_release_fd) {
+    *release_fd = fd->fd;
+  } else if (!already_closed) {
+    close(fd->fd);
+  }
+
+  GRPC_CLOSURE_SCHED(exec_ctx, on_done, GRPC_ERROR_REF(error));
+
+  grpc_iomgr_unregister_object(&fd->iomgr_object);
+  grpc_lfev_destroy(&fd->read_closure);
+  grpc_lfev_destroy(&fd->write_closure);
+
+  gpr_mu_lock(&fd_freelist_mu);
+  fd->freelist_next = fd_freelist;
+  fd_freelist = fd;
+  gpr_mu_unlock(&fd_freelist_mu);
+}
+
+static grpc_pollset *fd_get_read_notifier_pollset(grpc_exec_ctx *exec_ctx,
+                                                  grpc_fd *fd) {
+  gpr_atm notifier = gpr_atm_acq_load(&fd->read_notifier_pollset);
+  return (grpc_pollset *)notifier;
+}
+
+static bool fd_is_shutdown(grpc_fd *fd) {
+  return grpc_lfev_is_shutdown(&fd->read_closure);
+}
+
+static void fd_notify_on_read(grpc_exec_ctx *exec_ctx, grpc_fd *fd,
+                              grpc_closure *closure) {
+  uring_ensure_poll(fd);
+  grpc_lfev_notify_on(exec_ctx, &fd->read_closure, closure, "read");
+}
+
+static void fd_notify_on_write(grpc_exec_ctx *exec_ctx, grpc_fd *fd,
+                               grpc_closure *closure) {
+  uring_ensure_poll(fd);
+  grpc_lfev_notify_on(exec_ctx, &fd->write_closure, closure, "write");
+}
+
+static void fd_become_readable(grpc_exec_ctx *exec_ctx, grpc_fd *fd,
+                               grpc_pollset *notifier) {
+  grpc_lfev_set_ready(exec_ctx, &fd->read_closure, "read");
+  /* Use release store to match with acquire load in fd_get_read_notifier */
+  gpr_atm_rel_store(&fd->read_notifier_pollset, (gpr_atm)notifier);
+}
+
+static void fd_become_writable(grpc_exec_ctx *exec_ctx, grpc_fd *fd) {
+  grpc_lfev_set_ready(exec_ctx, &fd->write_closure, "write");
+}
+
+/*******************************************************************************
+ * Io operations
+ */
+
+bool grpc_uring_enabled(void) { return g_uring_enabled; }
+
+void grpc_uring_fd_release_poll(grpc_fd *fd) {
+  if (!gpr_atm_acq_load(&fd->poll_armed)) return;
+  gpr_mu_lock(&g_uring.sq_mu);
+  uring_remove_poll_locked(fd);
+  gpr_mu_unlock(&g_uring.sq_mu);
+}
+
+static void uring_flush_batch(grpc_exec_ctx *exec_ctx, void *arg,
+                              grpc_error *error_ignored) {
+  gpr_tls_set(&g_uring_batch_pending, 0);
+  gpr_mu_lock(&g_uring.sq_mu);
+  grpc_error *err = uring_submit_locked();
+  gpr_mu_unlock(&g_uring.sq_mu);
+  GRPC_LOG_IF_ERROR("uring_flush_batch", err);
+}
+
+/* Return an sqe for op. g_uring.sq_mu must be held */
+static struct io_uring_sqe *uring_get_op_sqe_locked(grpc_uring_op *op) {
+  struct io_uring_sqe *sqe = uring_get_sqe_locked();
+  sqe->user_data = (uint64_t)(uintptr_t)op | URING_TAG_OP;
+  return sqe;
+}
+
+/* Queue the sqe returned by uring_get_op_sqe_locked() and release
+   g_uring.sq_mu. Rather than entering the ring for each operation, the first
+   one queued by a thread schedules uring_flush_batch() on its exec_ctx: it
+   runs after the closures already there, so the operations they start go out
+   in the same io_uring_enter() (unless the designated poller takes them
+   along first) */
+static void uring_queue_op_and_unlock(grpc_exec_ctx *exec_ctx) {
+  uring_queue_sqe_locked();
+  gpr_mu_unlock(&g_uring.sq_mu);
+  if (gpr_tls_get(&g_uring_batch_pending) == 0) {
+    gpr_tls_set(&g_uring_batch_pending, 1);
+    GRPC_CLOSURE_SCHED(exec_ctx,
+                       GRPC_CLOSURE_CREATE(uring_flush_batch, NULL,
+                                           grpc_schedule_on_exec_ctx),
+                       GRPC_ERROR_NONE);
+  }
+}
+
+void grpc_uring_recvmsg(grpc_exec_ctx *exec_ctx, grpc_uring_op *op, int fd,
+                        struct msghdr *msg, int flags) {
+  gpr_mu_lock(&g_uring.sq_mu);
+  struct io_uring_sqe *sqe = uring_get_op_sqe_locked(op);
+  sqe->opcode = IORING_OP_RECVMSG;
+  sqe->fd = fd;
+  sqe->addr = (uint64_t)(uintptr_t)msg;
+  sqe->len = 1;
+  sqe->msg_flags = (uint32_t)flags;
+  uring_queue_op_and_unlock(exec_ctx);
+}
+
+void grpc_uring_sendmsg(grpc_exec_ctx *exec_ctx, grpc_uring_op *op, int fd,
+                        const struct msghdr *msg, int flags) {
+  gpr_mu_lock(&g_uring.sq_mu);
+  struct io_uring_sqe *sqe = uring_get_op_sqe_locked(op);
+  sqe->opcode = IORING_OP_SENDMSG;
+  sqe->fd = fd;
+  sqe->addr = (uint64_t)(uintptr_t)msg;
+  sqe->len = 1;
+  sqe->msg_flags = (uint32_t)flags;
+  uring_queue_op_and_unlock(exec_ctx);
+}
+
+void grpc_uring_accept(grpc_exec_ctx *exec_ctx, grpc_uring_op *op, int fd,
+                       struct sockaddr *addr, socklen_t *addr_len, int flags) {
+  gpr_mu_lock(&g_uring.sq_mu);
+  struct io_uring_sqe *sqe = uring_get_op_sqe_locked(op);
+  sqe->opcode = IORING_OP_ACCEPT;
+  sqe->fd = fd;
+  sqe->addr = (uint64_t)(uintptr_t)addr;
+  sqe->addr2 = (uint64_t)(uintptr_t)addr_len;
+  sqe->accept_flags = (uint32_t)flags;
+  uring_queue_op_and_unlock(exec_ctx);
+}
+
+void grpc_uring_cancel(grpc_exec_ctx *exec_ctx, grpc_uring_op *op) {
+  /* Submitted right away, together with op itself if it is still queued */
+  gpr_mu_lock(&g_uring.sq_mu);
+  struct io_uring_sqe *sqe = uring_get_sqe_locked();
+  sqe->opcode = IORING_OP_ASYNC_CANCEL;
+  sqe->fd = -1;
+  sqe->addr = (uint64_t)(uintptr_t)op | URING_TAG_OP;
+  sqe->user_data = URING_TAG_CANCEL;
+  uring_queue_sqe_locked();
+  grpc_error *err = uring_submit_locked();
+  gpr_mu_unlock(&g_uring.sq_mu);
+  GRPC_LOG_IF_ERROR("grpc_uring_cancel", err);
+}
+
+/*******************************************************************************
+ * Completion handling
+ */
+
+/* Process the completions reaped by do_uring_wait() function.
+   - g_uring.cursor points to the index of the first event to be processed
+   - This function then processes up-to MAX_URING_EVENTS_PER_ITERATION and
+     updates the g_uring.cursor
+
+   NOTE ON SYNCRHONIZATION: Similar to do_uring_wait(), this function is only
+   called by g_active_poller thread. So there is no need for synchronization
+   when accessing the completion fields in g_uring */
+static grpc_error *process_uring_events(grpc_exec_ctx *exec_ctx,
+                                        grpc_pollset *pollset) {
+  GPR_TIMER_BEGIN("process_uring_events", 0);
+  long num_events = gpr_atm_acq_load(&g_uring.num_events);
+  long cursor = gpr_atm_acq_load(&g_uring.cursor);
+  for (int idx = 0;
+       (idx < MAX_URING_EVENTS_HANDLED_PER_ITERATION) && cursor != num_events;
+       idx++) {
+    long c = cursor++;
+    uring_event *ev = &g_uring.events[c];
+
+    if ((ev->user_data & URING_TAG_MASK) == URING_TAG_OP) {
+      grpc_uring_op *op =
+          (grpc_uring_op *)(uintptr_t)(ev->user_data & ~URING_TAG_MASK);
+      op->res = ev->res;
+      GRPC_CLOSURE_SCHED(exec_ctx, op->on_done, GRPC_ERROR_NONE);
+      continue;
+    }
+    /* Wakeups need no further handling: returning from io_uring_enter() was
+       all they were for. Completions of poll removals and cancellations carry
+       no information */
+    if ((ev->user_data & URING_TAG_MASK) != URING_TAG_POLL) continue;
+    /* The poll was removed by fd_orphan() */
+    if (ev->res == -ECANCELED) continue;
+
+    grpc_fd *fd = (grpc_fd *)(uintptr_t)(
+        ev->user_data & ~((URING_GEN_MASK << URING_GEN_SHIFT) | URING_TAG_MASK));
+    gpr_atm gen = (gpr_atm)((ev->user_data >> URING_GEN_SHIFT) & URING_GEN_MASK);
+    /* The poll may have produced this completion just before its grpc_fd was
+       orphaned and handed out again; the generation tells them apart */
+    if (gen != gpr_atm_acq_load(&fd->poll_gen)) continue;
+
+    bool cancel = ev->res < 0 || (ev->res & (POLLERR | POLLHUP)) != 0;
+    bool read_ev = ev->res > 0 && (ev->res & (POLLIN | POLLPRI)) != 0;
+    bool write_ev = ev->res > 0 && (ev->res & POLLOUT) != 0;
+
+    if (read_ev || cancel) {
+      fd_become_readable(exec_ctx, fd, pollset);
+    }
+
+    if (write_ev || cancel) {
+      fd_become_writable(exec_ctx, fd);
+    }
+
+    if ((ev->flags & IORING_CQE_F_MORE) == 0 && ev->res >= 0) {
+      /* The kernel terminated the multishot poll (eg. the completion ring
+         overflowed); arm a new one unless the fd went away meanwhile. The sqe
+         goes out with the next do_uring_wait() */
+      gpr_mu_lock(&g_uring.sq_mu);
+      if (!fd->orphaned && gen == gpr_atm_no_barrier_load(&fd->poll_gen)) {
+        uring_arm_poll_locked(fd);
+      }
+      gpr_mu_unlock(&g_uring.sq_mu);
+    }
+  }
+  gpr_atm_rel_store(&g_uring.cursor, cursor);
+  GPR_TIMER_END("process_uring_events", 0);
+  return GRPC_ERROR_NONE;
+}
+
+/* Copy the completions sitting in the completion ring to g_uring.events and
+   return how many there were */
+static int uring_reap_completions(void) {
+  unsigned head = *g_uring.cq_head;
+  unsigned tail = __atomic_load_n(g_uring.cq_tail, __ATOMIC_ACQUIRE);
+  int n = 0;
+  while (head != tail && n < MAX_URING_EVENTS) {
+    struct io_uring_cqe *cqe = &g_uring.cqes[head & g_uring.cq_mask];
+    g_uring.events[n].user_data = cqe->user_data;
+    g_uring.events[n].res = cqe->res;
+    g_uring.events[n].flags = cqe->flags;
+    n++;
+    head++;
+  }
+  __atomic_store_n(g_uring.cq_head, head, __ATOMIC_RELEASE);
+  return n;
+}
+
+/* Submit any queued sqes and wait for completions, storing them in the
+   g_uring.events field; both happen in a single io_uring_enter() call, and
+   none at all if completions are already waiting in the ring and nothing needs
+   submitting. This does not "process" any of the events yet; that is done in
+   process_uring_events(). *See process_uring_events() function for more
+   details.
+
+   NOTE ON SYNCHRONIZATION: At any point of time, only the g_active_poller
+   (i.e the designated poller thread) will be calling this function. So there is
+   no need for any synchronization when accesing the completion fields in
+   g_uring */
+static grpc_error *do_uring_wait(grpc_exec_ctx *exec_ctx, grpc_pollset *ps,
+                                 gpr_timespec now, gpr_timespec deadline) {
+  GPR_TIMER_BEGIN("do_uring_wait", 0);
+
+  int r = uring_reap_completions();
+  unsigned to_submit = uring_sq_pending();
+
+  if (r == 0 || to_submit > 0) {
+    int timeout =
+        r > 0 ? 0 : grpc_epoll1_poll_deadline_to_millis_timeout(deadline, now);
+    struct __kernel_timespec ts;
+    struct io_uring_getevents_arg arg;
+    memset(&arg, 0, sizeof(arg));
+    arg.sigmask_sz = _NSIG / 8;
+    if (timeout > 0) {
+      ts.tv_sec = timeout / GPR_MS_PER_SEC;
+      ts.tv_nsec = (timeout % GPR_MS_PER_SEC) * GPR_NS_PER_MS;
+      arg.ts = (uint64_t)(uintptr_t)&ts;
+    }
+    unsigned flags = IORING_ENTER_EXT_ARG;
+    if (timeout != 0) {
+      flags |= IORING_ENTER_GETEVENTS;
+      GRPC_SCHEDULING_START_BLOCKING_REGION;
+    }
+    int e;
+    do {
+      GRPC_STATS_INC_SYSCALL_POLL(exec_ctx);
+      /* Sqes queued by other threads meanwhile are simply left for the next
+         call (to_submit only ever understates what is in the ring) */
+      e = sys_io_uring_enter(g_uring.ring_fd, to_submit, timeout != 0 ? 1 : 0,
+                             flags, &arg, sizeof(arg));
+    } while (e < 0 && errno == EINTR);
+    if (timeout != 0) {
+      GRPC_SCHEDULING_END_BLOCKING_REGION;
+    }
+
+    /* ETIME is the timeout expiring, EBUSY a backlog of completions that did
+       not fit in the completion ring: both just mean there is nothing more to
+       wait for */
+    if (e < 0 && errno != ETIME && errno != EBUSY) {
+      return GRPC_OS_ERROR(errno, "io_uring_enter");
+    }
+
+    if (r == 0) r = uring_reap_completions();
+  }
+
+  GRPC_STATS_INC_POLL_EVENTS_RETURNED(exec_ctx, r);
+
+  if (GRPC_TRACER_ON(grpc_polling_trace)) {
+    gpr_log(GPR_DEBUG, "ps: %p poll got %d events", ps, r);
+  }
+
+  gpr_atm_rel_store(&g_uring.num_events, r);
+  gpr_atm_rel_store(&g_uring.cursor, 0);
+
+  GPR_TIMER_END("do_uring_wait", 0);
+  return GRPC_ERROR_NONE;
+}
+
+static bool uring_has_pending_events(void) {
+  return gpr_atm_acq_load(&g_uring.cursor) !=
+         gpr_atm_acq_load(&g_uring.num_events);
+}
+
+/*******************************************************************************
+ * Event engine binding
+ */
+
+/* The pollsets (and their designated poller) are those of ev_epoll1_linux.c,
+   waiting on the ring instead of an epoll set */
+static const grpc_epoll1_poller_vtable uring_poller = {
+    uring_wakeup, do_uring_wait, uring_has_pending_events,
+    process_uring_events,
+};
+
+static void shutdown_engine(void) {
+  g_uring_enabled = false;
+  fd_global_shutdown();
+  grpc_epoll1_pollset_global_shutdown();
+  gpr_tls_destroy(&g_uring_batch_pending);
+  uring_set_shutdown();
+}
+
+/* The pollset and pollset_set functions are filled in by
+   grpc_epoll1_fill_pollset_vtable() */
+static grpc_event_engine_vtable vtable = {
+    0,
+
+    fd_create,
+    fd_wrapped_fd,
+    fd_orphan,
+    fd_shutdown,
+    fd_notify_on_read,
+    fd_notify_on_write,
+    fd_is_shutdown,
+    fd_get_read_notifier_pollset,
+
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+
+    shutdown_engine,
+};
+
+/* Kernels (or seccomp policies) may well lack io_uring even though the headers
+ * have it; uring_set_init() takes care of checking that. Being newer and less
+ * battle tested than epoll, this engine is only used when asked for by name */
+const grpc_event_engine_vtable *grpc_init_uring_linux(bool explicit_request) {
+  if (!explicit_request) {
+    return NULL;
+  }
+
+  if (!uring_set_init()) {
+    return NULL;
+  }
+
+  fd_global_init();
+  gpr_tls_init(&g_uring_batch_pending);
+
+  if (!GRPC_LOG_IF_ERROR("pollset_global_init",
+                         grpc_epoll1_pollset_global_init(&uring_poller))) {
+    gpr_tls_destroy(&g_uring_batch_pending);
+    fd_global_shutdown();
+    uring_set_shutdown();
+    return NULL;
+  }
+
+  grpc_epoll1_fill_pollset_vtable(&vtable);
+  g_uring_enabled = true;
+  return &vtable;
+}
+
+#else /* defined(GRPC_LINUX_IO_URING) */
+#if defined(GRPC_POSIX_SOCKET)
+#include <grpc/support/log.h>
+
+#include "src/core/lib/iomgr/ev_uring_linux.h"
+/* If GRPC_LINUX_IO_URING is not defined, it means io_uring is not available.
+ * Return NULL */
+const grpc_event_engine_vtable *grpc_init_uring_linux(bool explicit_request) {
+  return NULL;
+}
+
+bool grpc_uring_enabled(void) { return false; }
+
+void grpc_uring_fd_release_poll(grpc_fd *fd) {}
+
+void grpc_uring_recvmsg(grpc_exec_ctx *exec_ctx, grpc_uring_op *op, int fd,
+                        struct msghdr *msg, int flags) {
+  GPR_UNREACHABLE_CODE(return );
+}
+
+void grpc_uring_sendmsg(grpc_exec_ctx *exec_ctx, grpc_uring_op *op, int fd,
+                        const struct msghdr *msg, int flags) {
+  GPR_UNREACHABLE_CODE(return );
+}
+
+void grpc_uring_accept(grpc_exec_ctx *exec_ctx, grpc_uring_op *op, int fd,
+                       struct sockaddr *addr, socklen_t *addr_len, int flags) {
+  GPR_UNREACHABLE_CODE(return );
+}
+
+void grpc_uring_cancel(grpc_exec_ctx *exec_ctx, grpc_uring_op *op) {}
+#endif /* defined(GRPC_POSIX_SOCKET) */
+#endif /* !defined(GRPC_LINUX_IO_URING) */
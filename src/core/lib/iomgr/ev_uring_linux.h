@@ -0,0 +1,64 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_LIB_IOMGR_EV_URING_LINUX_H
+#define GRPC_CORE_LIB_IOMGR_EV_URING_LINUX_H
+
+#include "src/core/lib/iomgr/port.h"
+
+#include <sys/socket.h>
+
+#include "src/core/lib/iomgr/ev_posix.h"
+
+// a polling engine that utilizes a singleton io_uring instance (multishot polls
+// with batched submission) and turnstile polling
+
+const grpc_event_engine_vtable *grpc_init_uring_linux(bool explicit_request);
+
+/* Whether the uring engine is the one in use. Endpoints and listeners then
+   run their io through the ring operations below, rather than waiting for
+   their fd to become readable or writable and making the syscall themselves */
+bool grpc_uring_enabled(void);
+
+/* An io operation run by the ring. Once it completes, res is set to the
+   result of the syscall it stands for (a negated errno on failure) and
+   on_done is scheduled on the exec_ctx of the thread that reaped it */
+typedef struct grpc_uring_op {
+  grpc_closure *on_done;
+  int32_t res;
+} grpc_uring_op;
+
+/* Stop polling fd, whose io runs through ring operations from now on. Waiting
+   for it to become readable or writable polls it again */
+void grpc_uring_fd_release_poll(grpc_fd *fd);
+
+/* Start a recvmsg/sendmsg/accept4 on fd. The operations started by a thread
+   are handed to the kernel together, once the closures already scheduled on
+   its exec_ctx have run. msg (addr), and the memory it points to, must stay
+   valid until op completes */
+void grpc_uring_recvmsg(grpc_exec_ctx *exec_ctx, grpc_uring_op *op, int fd,
+                        struct msghdr *msg, int flags);
+void grpc_uring_sendmsg(grpc_exec_ctx *exec_ctx, grpc_uring_op *op, int fd,
+                        const struct msghdr *msg, int flags);
+void grpc_uring_accept(grpc_exec_ctx *exec_ctx, grpc_uring_op *op, int fd,
+                       struct sockaddr *addr, socklen_t *addr_len, int flags);
+
+/* Make op complete with -ECANCELED if it has not completed yet */
+void grpc_uring_cancel(grpc_exec_ctx *exec_ctx, grpc_uring_op *op);
+
+#endif /* GRPC_CORE_LIB_IOMGR_EV_URING_LINUX_H */
@@ -25,29 +25,65 @@
 #include <grpc/support/log.h>
 #include <grpc/support/sync.h>
 #include <grpc/support/thd.h>
+#include <grpc/support/time.h>
 #include <grpc/support/tls.h>
 #include <grpc/support/useful.h>
 
 #include "src/core/lib/debug/stats.h"
 #include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/support/mpscq.h"
 #include "src/core/lib/support/spinlock.h"
 
+/* Short jobs are kept in per-thread Chase-Lev deques: a thread pushes and pops
+   at the bottom of its own deque, idle threads steal from the top of the
+   others'. Closures scheduled from outside the executor go to a shared
+   injection queue, and long jobs to a separate queue, so that a thread never
+   picks up a potentially infinite job while it has short ones of its own
+   queued up. Threads with nothing to do sleep until new work is pushed. */
+
 #define MAX_DEPTH 2
+#define DEQUE_SIZE 256
 
-typedef struct {
-  gpr_mu mu;
+typedef struct thread_state {
+  gpr_atm top;
+  /* keep the end thieves update apart from the end the owner updates */
+  char padding[GPR_CACHELINE_SIZE];
+  gpr_atm bottom;
+  gpr_atm jobs[DEQUE_SIZE];
+
+  /* the remaining fields are guarded by g_sleep_mu */
   gpr_cv cv;
-  grpc_closure_list elems;
-  size_t depth;
-  bool shutdown;
-  bool queued_long_job;
+  bool sleeping;
+  struct thread_state *next_sleeper;
   gpr_thd_id id;
 } thread_state;
 
+typedef struct {
+  gpr_mpscq queue;
+  /* held by whichever thread is popping */
+  gpr_spinlock pop_lock;
+  gpr_atm count;
+} shared_queue;
+
 static thread_state *g_thread_state;
 static size_t g_max_threads;
 static gpr_atm g_cur_threads;
 static gpr_spinlock g_adding_thread_lock = GPR_SPINLOCK_STATIC_INITIALIZER;
+static gpr_atm g_shutdown;
+
+/* short jobs scheduled from outside the executor, or that did not fit in a
+   thread's deque */
+static shared_queue g_injector;
+static shared_queue g_long_jobs;
+/* number of jobs pushed but not yet picked up by a thread */
+static gpr_atm g_pending;
+/* number of executor_push calls that saw g_shutdown unset and may still be
+   touching the queues; shutdown waits for them before the final drain */
+static gpr_atm g_pushers;
+
+static gpr_mu g_sleep_mu;
+static thread_state *g_sleepers;
+static gpr_atm g_num_sleepers;
 
 GPR_TLS_DECL(g_this_thread_state);
 
@@ -56,32 +92,191 @@ static grpc_tracer_flag executor_trace =
 
 static void executor_thread(void *arg);
 
-static size_t run_closures(grpc_exec_ctx *exec_ctx, grpc_closure_list list) {
-  size_t n = 0;
-
-  grpc_closure *c = list.head;
-  while (c != NULL) {
-    grpc_closure *next = c->next_data.next;
-    grpc_error *error = c->error_data.error;
-    if (GRPC_TRACER_ON(executor_trace)) {
+static void run_closure(grpc_exec_ctx *exec_ctx, grpc_closure *c) {
+  grpc_error *error = c->error_data.error;
+  if (GRPC_TRACER_ON(executor_trace)) {
 #ifndef NDEBUG
-      gpr_log(GPR_DEBUG, "EXECUTOR: run %p [created by %s:%d]", c,
-              c->file_created, c->line_created);
+    gpr_log(GPR_DEBUG, "EXECUTOR: run %p [created by %s:%d]", c,
+            c->file_created, c->line_created);
 #else
-      gpr_log(GPR_DEBUG, "EXECUTOR: run %p", c);
+    gpr_log(GPR_DEBUG, "EXECUTOR: run %p", c);
 #endif
-    }
+  }
 #ifndef NDEBUG
-    c->scheduled = false;
+  c->scheduled = false;
 #endif
-    c->cb(exec_ctx, c->cb_arg, error);
-    GRPC_ERROR_UNREF(error);
-    c = next;
-    n++;
-    grpc_exec_ctx_flush(exec_ctx);
+  c->cb(exec_ctx, c->cb_arg, error);
+  GRPC_ERROR_UNREF(error);
+  grpc_exec_ctx_flush(exec_ctx);
+}
+
+/* Pushes to the bottom of the deque; only the owning thread may call this.
+   Returns false if the deque is full. */
+static bool deque_push(thread_state *ts, grpc_closure *c) {
+  gpr_atm b = gpr_atm_no_barrier_load(&ts->bottom);
+  gpr_atm t = gpr_atm_acq_load(&ts->top);
+  if (b - t >= DEQUE_SIZE) return false;
+  gpr_atm_no_barrier_store(&ts->jobs[b % DEQUE_SIZE], (gpr_atm)c);
+  gpr_atm_rel_store(&ts->bottom, b + 1);
+  return true;
+}
+
+/* Pops from the bottom of the deque; only the owning thread may call this */
+static grpc_closure *deque_pop(thread_state *ts) {
+  gpr_atm b = gpr_atm_no_barrier_load(&ts->bottom) - 1;
+  gpr_atm_no_barrier_store(&ts->bottom, b);
+  gpr_atm_full_barrier();
+  gpr_atm t = gpr_atm_no_barrier_load(&ts->top);
+  if (t > b) {
+    gpr_atm_no_barrier_store(&ts->bottom, b + 1);
+    return NULL;
+  }
+  grpc_closure *c =
+      (grpc_closure *)gpr_atm_no_barrier_load(&ts->jobs[b % DEQUE_SIZE]);
+  if (t == b) {
+    /* last job: race the thieves for it */
+    if (!gpr_atm_full_cas(&ts->top, t, t + 1)) c = NULL;
+    gpr_atm_no_barrier_store(&ts->bottom, b + 1);
+  }
+  return c;
+}
+
+/* Takes from the top of the deque; any thread may call this. Returns NULL if
+   the deque is empty or another thread got there first. */
+static grpc_closure *deque_steal(grpc_exec_ctx *exec_ctx, thread_state *ts) {
+  gpr_atm t = gpr_atm_acq_load(&ts->top);
+  gpr_atm_full_barrier();
+  gpr_atm b = gpr_atm_acq_load(&ts->bottom);
+  if (t >= b) return NULL;
+  grpc_closure *c =
+      (grpc_closure *)gpr_atm_no_barrier_load(&ts->jobs[t % DEQUE_SIZE]);
+  if (!gpr_atm_full_cas(&ts->top, t, t + 1)) {
+    GRPC_STATS_INC_EXECUTOR_PUSH_RETRIES(exec_ctx);
+    return NULL;
   }
+  return c;
+}
+
+static bool deque_empty(thread_state *ts) {
+  return gpr_atm_acq_load(&ts->bottom) <= gpr_atm_acq_load(&ts->top);
+}
+
+static void shared_queue_init(shared_queue *q) {
+  gpr_mpscq_init(&q->queue);
+  q->pop_lock = GPR_SPINLOCK_INITIALIZER;
+  gpr_atm_no_barrier_store(&q->count, 0);
+}
 
-  return n;
+static void shared_queue_push(shared_queue *q, grpc_closure *c) {
+  gpr_atm_full_fetch_add(&q->count, 1);
+  gpr_mpscq_push(&q->queue, &c->next_data.atm_next);
+}
+
+/* Returns NULL if the queue is empty, another thread is popping, or a push is
+   still in progress; callers find the job on their next attempt */
+static grpc_closure *shared_queue_pop(shared_queue *q) {
+  if (gpr_atm_acq_load(&q->count) == 0) return NULL;
+  if (!gpr_spinlock_trylock(&q->pop_lock)) return NULL;
+  grpc_closure *c = (grpc_closure *)gpr_mpscq_pop(&q->queue);
+  gpr_spinlock_unlock(&q->pop_lock);
+  if (c != NULL) gpr_atm_full_fetch_add(&q->count, -1);
+  return c;
+}
+
+static bool shared_queue_empty(shared_queue *q) {
+  return gpr_atm_acq_load(&q->count) == 0;
+}
+
+static bool work_available(void) {
+  if (!shared_queue_empty(&g_injector) || !shared_queue_empty(&g_long_jobs)) {
+    return true;
+  }
+  size_t cur_thread_count = (size_t)gpr_atm_no_barrier_load(&g_cur_threads);
+  for (size_t i = 0; i < cur_thread_count; i++) {
+    if (!deque_empty(&g_thread_state[i])) return true;
+  }
+  return false;
+}
+
+static grpc_closure *next_job(grpc_exec_ctx *exec_ctx, thread_state *ts) {
+  grpc_closure *c = deque_pop(ts);
+  if (c == NULL) c = shared_queue_pop(&g_long_jobs);
+  if (c == NULL) c = shared_queue_pop(&g_injector);
+  if (c == NULL) {
+    size_t cur_thread_count = (size_t)gpr_atm_no_barrier_load(&g_cur_threads);
+    size_t idx = (size_t)(ts - g_thread_state);
+    for (size_t i = 1; i < cur_thread_count && c == NULL; i++) {
+      c = deque_steal(exec_ctx,
+                      &g_thread_state[(idx + i) % cur_thread_count]);
+    }
+    if (c != NULL) GRPC_STATS_INC_EXECUTOR_JOBS_STOLEN(exec_ctx);
+  }
+  if (c != NULL) gpr_atm_full_fetch_add(&g_pending, -1);
+  return c;
+}
+
+/* Returns false if the executor is shutting down */
+static bool wait_for_work(thread_state *ts) {
+  gpr_mu_lock(&g_sleep_mu);
+  ts->sleeping = true;
+  ts->next_sleeper = g_sleepers;
+  g_sleepers = ts;
+  /* pushers publish their job before checking for sleepers, so either they
+     see us here or we see their job below */
+  gpr_atm_full_fetch_add(&g_num_sleepers, 1);
+  if (work_available() || gpr_atm_acq_load(&g_shutdown)) {
+    g_sleepers = ts->next_sleeper;
+    ts->sleeping = false;
+    gpr_atm_full_fetch_add(&g_num_sleepers, -1);
+  }
+  while (ts->sleeping && !gpr_atm_acq_load(&g_shutdown)) {
+    gpr_cv_wait(&ts->cv, &g_sleep_mu, gpr_inf_future(GPR_CLOCK_REALTIME));
+  }
+  gpr_mu_unlock(&g_sleep_mu);
+  return !gpr_atm_acq_load(&g_shutdown);
+}
+
+static bool wake_one_thread(grpc_exec_ctx *exec_ctx) {
+  if (gpr_atm_acq_load(&g_num_sleepers) == 0) return false;
+  gpr_mu_lock(&g_sleep_mu);
+  thread_state *ts = g_sleepers;
+  if (ts != NULL) {
+    g_sleepers = ts->next_sleeper;
+    ts->sleeping = false;
+    gpr_atm_full_fetch_add(&g_num_sleepers, -1);
+    GRPC_STATS_INC_EXECUTOR_WAKEUP_INITIATED(exec_ctx);
+    gpr_cv_signal(&ts->cv);
+  }
+  gpr_mu_unlock(&g_sleep_mu);
+  return ts != NULL;
+}
+
+static void add_thread(void) {
+  if (!gpr_spinlock_trylock(&g_adding_thread_lock)) return;
+  size_t cur_thread_count = (size_t)gpr_atm_no_barrier_load(&g_cur_threads);
+  if (cur_thread_count < g_max_threads && !gpr_atm_acq_load(&g_shutdown)) {
+    gpr_thd_options opt = gpr_thd_options_default();
+    gpr_thd_options_set_joinable(&opt);
+    gpr_thd_new(&g_thread_state[cur_thread_count].id, executor_thread,
+                &g_thread_state[cur_thread_count], &opt);
+    gpr_atm_rel_store(&g_cur_threads, (gpr_atm)(cur_thread_count + 1));
+  }
+  gpr_spinlock_unlock(&g_adding_thread_lock);
+}
+
+static void run_remaining(grpc_exec_ctx *exec_ctx) {
+  grpc_closure *c;
+  for (size_t i = 0; i < g_max_threads; i++) {
+    while ((c = deque_steal(exec_ctx, &g_thread_state[i])) != NULL) {
+      run_closure(exec_ctx, c);
+    }
+  }
+  while (!shared_queue_empty(&g_long_jobs)) {
+    if ((c = shared_queue_pop(&g_long_jobs)) != NULL) run_closure(exec_ctx, c);
+  }
+  while (!shared_queue_empty(&g_injector)) {
+    if ((c = shared_queue_pop(&g_injector)) != NULL) run_closure(exec_ctx, c);
+  }
 }
 
 bool grpc_executor_is_threaded() {
@@ -93,42 +288,57 @@ void grpc_executor_set_threading(grpc_exec_ctx *exec_ctx, bool threading) {
   if (threading) {
     if (cur_threads > 0) return;
     g_max_threads = GPR_MAX(1, 2 * gpr_cpu_num_cores());
-    gpr_atm_no_barrier_store(&g_cur_threads, 1);
+    gpr_atm_no_barrier_store(&g_shutdown, 0);
+    gpr_atm_no_barrier_store(&g_pending, 0);
+    gpr_atm_no_barrier_store(&g_pushers, 0);
+    gpr_atm_no_barrier_store(&g_num_sleepers, 0);
+    shared_queue_init(&g_injector);
+    shared_queue_init(&g_long_jobs);
+    gpr_mu_init(&g_sleep_mu);
+    g_sleepers = NULL;
     gpr_tls_init(&g_this_thread_state);
     g_thread_state =
         (thread_state *)gpr_zalloc(sizeof(thread_state) * g_max_threads);
     for (size_t i = 0; i < g_max_threads; i++) {
-      gpr_mu_init(&g_thread_state[i].mu);
       gpr_cv_init(&g_thread_state[i].cv);
-      g_thread_state[i].elems = (grpc_closure_list)GRPC_CLOSURE_LIST_INIT;
     }
 
     gpr_thd_options opt = gpr_thd_options_default();
     gpr_thd_options_set_joinable(&opt);
     gpr_thd_new(&g_thread_state[0].id, executor_thread, &g_thread_state[0],
                 &opt);
+    gpr_atm_rel_store(&g_cur_threads, 1);
   } else {
     if (cur_threads == 0) return;
+    gpr_mu_lock(&g_sleep_mu);
+    gpr_atm_full_xchg(&g_shutdown, 1);
     for (size_t i = 0; i < g_max_threads; i++) {
-      gpr_mu_lock(&g_thread_state[i].mu);
-      g_thread_state[i].shutdown = true;
       gpr_cv_signal(&g_thread_state[i].cv);
-      gpr_mu_unlock(&g_thread_state[i].mu);
+    }
+    gpr_mu_unlock(&g_sleep_mu);
+    /* pushes that raced with setting g_shutdown finish enqueueing before the
+       queues are drained for the last time; later ones run inline */
+    while (gpr_atm_acq_load(&g_pushers) != 0) {
+      gpr_sleep_until(gpr_time_add(gpr_now(GPR_CLOCK_MONOTONIC),
+                                   gpr_time_from_micros(10, GPR_TIMESPAN)));
     }
     /* ensure no thread is adding a new thread... once this is past, then
        no thread will try to add a new one either (since shutdown is true) */
     gpr_spinlock_lock(&g_adding_thread_lock);
     gpr_spinlock_unlock(&g_adding_thread_lock);
-    for (gpr_atm i = 0; i < g_cur_threads; i++) {
+    cur_threads = gpr_atm_no_barrier_load(&g_cur_threads);
+    for (gpr_atm i = 0; i < cur_threads; i++) {
       gpr_thd_join(g_thread_state[i].id);
     }
     gpr_atm_no_barrier_store(&g_cur_threads, 0);
+    run_remaining(exec_ctx);
     for (size_t i = 0; i < g_max_threads; i++) {
-      gpr_mu_destroy(&g_thread_state[i].mu);
       gpr_cv_destroy(&g_thread_state[i].cv);
-      run_closures(exec_ctx, g_thread_state[i].elems);
     }
     gpr_free(g_thread_state);
+    gpr_mu_destroy(&g_sleep_mu);
+    gpr_mpscq_destroy(&g_injector.queue);
+    gpr_mpscq_destroy(&g_long_jobs.queue);
     gpr_tls_destroy(&g_this_thread_state);
   }
 }
@@ -150,129 +360,79 @@ static void executor_thread(void *arg) {
   grpc_exec_ctx exec_ctx =
       GRPC_EXEC_CTX_INITIALIZER(0, grpc_never_ready_to_finish, NULL);
 
-  size_t subtract_depth = 0;
-  for (;;) {
-    if (GRPC_TRACER_ON(executor_trace)) {
-      gpr_log(GPR_DEBUG, "EXECUTOR[%d]: step (sub_depth=%" PRIdPTR ")",
-              (int)(ts - g_thread_state), subtract_depth);
-    }
-    gpr_mu_lock(&ts->mu);
-    ts->depth -= subtract_depth;
-    while (grpc_closure_list_empty(ts->elems) && !ts->shutdown) {
-      ts->queued_long_job = false;
-      gpr_cv_wait(&ts->cv, &ts->mu, gpr_inf_future(GPR_CLOCK_REALTIME));
-    }
-    if (ts->shutdown) {
-      if (GRPC_TRACER_ON(executor_trace)) {
-        gpr_log(GPR_DEBUG, "EXECUTOR[%d]: shutdown",
-                (int)(ts - g_thread_state));
-      }
-      gpr_mu_unlock(&ts->mu);
-      break;
+  while (!gpr_atm_acq_load(&g_shutdown)) {
+    grpc_closure *c = next_job(&exec_ctx, ts);
+    if (c != NULL) {
+      run_closure(&exec_ctx, c);
+      continue;
     }
     GRPC_STATS_INC_EXECUTOR_QUEUE_DRAINED(&exec_ctx);
-    grpc_closure_list exec = ts->elems;
-    ts->elems = (grpc_closure_list)GRPC_CLOSURE_LIST_INIT;
-    gpr_mu_unlock(&ts->mu);
     if (GRPC_TRACER_ON(executor_trace)) {
-      gpr_log(GPR_DEBUG, "EXECUTOR[%d]: execute", (int)(ts - g_thread_state));
+      gpr_log(GPR_DEBUG, "EXECUTOR[%d]: idle", (int)(ts - g_thread_state));
     }
-
-    subtract_depth = run_closures(&exec_ctx, exec);
+    if (!wait_for_work(ts)) break;
+  }
+  if (GRPC_TRACER_ON(executor_trace)) {
+    gpr_log(GPR_DEBUG, "EXECUTOR[%d]: shutdown", (int)(ts - g_thread_state));
   }
   grpc_exec_ctx_finish(&exec_ctx);
 }
 
 static void executor_push(grpc_exec_ctx *exec_ctx, grpc_closure *closure,
                           grpc_error *error, bool is_short) {
-  bool retry_push;
   if (is_short) {
     GRPC_STATS_INC_EXECUTOR_SCHEDULED_SHORT_ITEMS(exec_ctx);
   } else {
     GRPC_STATS_INC_EXECUTOR_SCHEDULED_LONG_ITEMS(exec_ctx);
   }
-  do {
-    retry_push = false;
-    size_t cur_thread_count = (size_t)gpr_atm_no_barrier_load(&g_cur_threads);
-    if (cur_thread_count == 0) {
-      if (GRPC_TRACER_ON(executor_trace)) {
+  bool inline_push = gpr_atm_no_barrier_load(&g_cur_threads) == 0;
+  if (!inline_push) {
+    gpr_atm_full_fetch_add(&g_pushers, 1);
+    if (gpr_atm_acq_load(&g_shutdown)) {
+      /* the queues may already have been drained for the last time */
+      gpr_atm_full_fetch_add(&g_pushers, -1);
+      inline_push = true;
+    }
+  }
+  if (inline_push) {
+    if (GRPC_TRACER_ON(executor_trace)) {
 #ifndef NDEBUG
-        gpr_log(GPR_DEBUG, "EXECUTOR: schedule %p (created %s:%d) inline",
-                closure, closure->file_created, closure->line_created);
+      gpr_log(GPR_DEBUG, "EXECUTOR: schedule %p (created %s:%d) inline",
+              closure, closure->file_created, closure->line_created);
 #else
-        gpr_log(GPR_DEBUG, "EXECUTOR: schedule %p inline", closure);
+      gpr_log(GPR_DEBUG, "EXECUTOR: schedule %p inline", closure);
 #endif
-      }
-      grpc_closure_list_append(&exec_ctx->closure_list, closure, error);
-      return;
-    }
-    thread_state *ts = (thread_state *)gpr_tls_get(&g_this_thread_state);
-    if (ts == NULL) {
-      ts = &g_thread_state[GPR_HASH_POINTER(exec_ctx, cur_thread_count)];
-    } else {
-      GRPC_STATS_INC_EXECUTOR_SCHEDULED_TO_SELF(exec_ctx);
     }
-    thread_state *orig_ts = ts;
-
-    bool try_new_thread;
-    for (;;) {
-      if (GRPC_TRACER_ON(executor_trace)) {
+    grpc_closure_list_append(&exec_ctx->closure_list, closure, error);
+    return;
+  }
+  if (GRPC_TRACER_ON(executor_trace)) {
 #ifndef NDEBUG
-        gpr_log(
-            GPR_DEBUG,
-            "EXECUTOR: try to schedule %p (%s) (created %s:%d) to thread %d",
-            closure, is_short ? "short" : "long", closure->file_created,
-            closure->line_created, (int)(ts - g_thread_state));
+    gpr_log(GPR_DEBUG, "EXECUTOR: schedule %p (%s) (created %s:%d)", closure,
+            is_short ? "short" : "long", closure->file_created,
+            closure->line_created);
 #else
-        gpr_log(GPR_DEBUG, "EXECUTOR: try to schedule %p (%s) to thread %d",
-                closure, is_short ? "short" : "long",
-                (int)(ts - g_thread_state));
+    gpr_log(GPR_DEBUG, "EXECUTOR: schedule %p (%s)", closure,
+            is_short ? "short" : "long");
 #endif
-      }
-      gpr_mu_lock(&ts->mu);
-      if (ts->queued_long_job) {
-        // if there's a long job queued, we never queue anything else to this
-        // queue (since long jobs can take 'infinite' time and we need to
-        // guarantee no starvation)
-        // ... spin through queues and try again
-        gpr_mu_unlock(&ts->mu);
-        size_t idx = (size_t)(ts - g_thread_state);
-        ts = &g_thread_state[(idx + 1) % cur_thread_count];
-        if (ts == orig_ts) {
-          retry_push = true;
-          try_new_thread = true;
-          break;
-        }
-        continue;
-      }
-      if (grpc_closure_list_empty(ts->elems)) {
-        GRPC_STATS_INC_EXECUTOR_WAKEUP_INITIATED(exec_ctx);
-        gpr_cv_signal(&ts->cv);
-      }
-      grpc_closure_list_append(&ts->elems, closure, error);
-      ts->depth++;
-      try_new_thread = ts->depth > MAX_DEPTH &&
-                       cur_thread_count < g_max_threads && !ts->shutdown;
-      if (!is_short) ts->queued_long_job = true;
-      gpr_mu_unlock(&ts->mu);
-      break;
-    }
-    if (try_new_thread && gpr_spinlock_trylock(&g_adding_thread_lock)) {
-      cur_thread_count = (size_t)gpr_atm_no_barrier_load(&g_cur_threads);
-      if (cur_thread_count < g_max_threads) {
-        gpr_atm_no_barrier_store(&g_cur_threads, cur_thread_count + 1);
-
-        gpr_thd_options opt = gpr_thd_options_default();
-        gpr_thd_options_set_joinable(&opt);
-        gpr_thd_new(&g_thread_state[cur_thread_count].id, executor_thread,
-                    &g_thread_state[cur_thread_count], &opt);
-      }
-      gpr_spinlock_unlock(&g_adding_thread_lock);
-    }
-    if (retry_push) {
-      GRPC_STATS_INC_EXECUTOR_PUSH_RETRIES(exec_ctx);
-    }
-  } while (retry_push);
+  }
+  closure->error_data.error = error;
+  thread_state *ts = (thread_state *)gpr_tls_get(&g_this_thread_state);
+  if (!is_short) {
+    shared_queue_push(&g_long_jobs, closure);
+  } else if (ts != NULL) {
+    GRPC_STATS_INC_EXECUTOR_SCHEDULED_TO_SELF(exec_ctx);
+    if (!deque_push(ts, closure)) shared_queue_push(&g_injector, closure);
+  } else {
+    shared_queue_push(&g_injector, closure);
+  }
+  gpr_atm pending = gpr_atm_full_fetch_add(&g_pending, 1) + 1;
+  /* a long job may never return its thread, so make sure there is another one
+     around to pick up the rest of the work */
+  if (!wake_one_thread(exec_ctx) && (!is_short || pending > MAX_DEPTH)) {
+    add_thread();
+  }
+  gpr_atm_full_fetch_add(&g_pushers, -1);
 }
 
 static void executor_push_short(grpc_exec_ctx *exec_ctx, grpc_closure *closure,
@@ -34,12 +34,16 @@
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
+#ifdef GPR_LINUX
+#include <linux/filter.h>
+#endif
 
 #include <grpc/support/alloc.h>
 #include <grpc/support/host_port.h>
 #include <grpc/support/log.h>
 #include <grpc/support/port_platform.h>
 #include <grpc/support/sync.h>
+#include <grpc/support/useful.h>
 #include "src/core/lib/iomgr/sockaddr_utils.h"
 #include "src/core/lib/support/string.h"
 
@@ -195,6 +199,49 @@ grpc_error *grpc_set_socket_low_latency(int fd, int low_latency) {
   return GRPC_ERROR_NONE;
 }
 
+/* set SO_BUSY_POLL */
+grpc_error *grpc_set_socket_busy_poll(int fd, int busy_poll_us) {
+#ifdef SO_BUSY_POLL
+  return 0 == setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &busy_poll_us,
+                         sizeof(busy_poll_us))
+             ? GRPC_ERROR_NONE
+             : GRPC_OS_ERROR(errno, "setsockopt(SO_BUSY_POLL)");
+#else
+  return GRPC_ERROR_CREATE_FROM_STATIC_STRING("SO_BUSY_POLL not supported");
+#endif
+}
+
+/* set SO_INCOMING_CPU */
+grpc_error *grpc_set_socket_incoming_cpu(int fd, int cpu) {
+#ifdef SO_INCOMING_CPU
+  return 0 == setsockopt(fd, SOL_SOCKET, SO_INCOMING_CPU, &cpu, sizeof(cpu))
+             ? GRPC_ERROR_NONE
+             : GRPC_OS_ERROR(errno, "setsockopt(SO_INCOMING_CPU)");
+#else
+  return GRPC_ERROR_CREATE_FROM_STATIC_STRING("SO_INCOMING_CPU not supported");
+#endif
+}
+
+/* attach a classic BPF program returning (current cpu % group_size) */
+grpc_error *grpc_set_socket_reuseport_cpu_steering(int fd,
+                                                   unsigned group_size) {
+#if defined(GPR_LINUX) && defined(SO_ATTACH_REUSEPORT_CBPF)
+  struct sock_filter code[] = {
+      {BPF_LD | BPF_W | BPF_ABS, 0, 0, (uint32_t)(SKF_AD_OFF + SKF_AD_CPU)},
+      {BPF_ALU | BPF_MOD | BPF_K, 0, 0, group_size},
+      {BPF_RET | BPF_A, 0, 0, 0},
+  };
+  struct sock_fprog prog = {(unsigned short)GPR_ARRAY_SIZE(code), code};
+  return 0 == setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog,
+                         sizeof(prog))
+             ? GRPC_ERROR_NONE
+             : GRPC_OS_ERROR(errno, "setsockopt(SO_ATTACH_REUSEPORT_CBPF)");
+#else
+  return GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+      "SO_ATTACH_REUSEPORT_CBPF not supported");
+#endif
+}
+
 /* set a socket using a grpc_socket_mutator */
 grpc_error *grpc_set_socket_with_mutator(int fd, grpc_socket_mutator *mutator) {
   GPR_ASSERT(mutator);
@@ -76,6 +76,21 @@ grpc_error *grpc_set_socket_sndbuf(int fd, int buffer_size_bytes);
 /* Tries to set the socket's receive buffer to given size. */
 grpc_error *grpc_set_socket_rcvbuf(int fd, int buffer_size_bytes);
 
+/* Tries to set SO_BUSY_POLL: the number of microseconds blocking reads (and
+   polls) may busy wait on the device queue for packets. Raising it above the
+   net.core.busy_read sysctl requires CAP_NET_ADMIN. */
+grpc_error *grpc_set_socket_busy_poll(int fd, int busy_poll_us);
+
+/* Tries to set SO_INCOMING_CPU on a listening socket, making it the preferred
+   SO_REUSEPORT socket for connections whose packets are processed on \a cpu */
+grpc_error *grpc_set_socket_incoming_cpu(int fd, int cpu);
+
+/* Tries to attach a reuseport BPF program to the SO_REUSEPORT group of \a fd
+   that hands connections processed on CPU c to the (c % group_size)-th socket
+   of the group, in the order they started listening */
+grpc_error *grpc_set_socket_reuseport_cpu_steering(int fd,
+                                                   unsigned group_size);
+
 /* Tries to set the socket using a grpc_socket_mutator */
 grpc_error *grpc_set_socket_with_mutator(int fd, grpc_socket_mutator *mutator);
 
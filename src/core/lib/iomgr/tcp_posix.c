@@ -24,6 +24,7 @@
 #include "src/core/lib/iomgr/tcp_posix.h"
 
 #include <errno.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
@@ -31,6 +32,11 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#ifdef GRPC_LINUX_ERRQUEUE
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#endif
+
 #include <grpc/slice.h>
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
@@ -43,7 +49,11 @@
 #include "src/core/lib/debug/stats.h"
 #include "src/core/lib/debug/trace.h"
 #include "src/core/lib/iomgr/ev_posix.h"
+#include "src/core/lib/iomgr/ev_uring_linux.h"
 #include "src/core/lib/iomgr/executor.h"
+#include "src/core/lib/iomgr/socket_utils_posix.h"
+#include "src/core/lib/iomgr/tcp_uring_linux.h"
+#include "src/core/lib/iomgr/timer.h"
 #include "src/core/lib/profiling/timers.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "src/core/lib/slice/slice_string_helpers.h"
@@ -55,14 +65,40 @@
 #define SENDMSG_FLAGS 0
 #endif
 
+#ifdef MSG_MORE
+#define SENDMSG_MORE_FLAG MSG_MORE
+#else
+#define SENDMSG_MORE_FLAG 0
+#endif
+
 #ifdef GRPC_MSG_IOVLEN_TYPE
 typedef GRPC_MSG_IOVLEN_TYPE msg_iovlen_type;
 #else
 typedef size_t msg_iovlen_type;
 #endif
 
+#if defined(GRPC_LINUX_ERRQUEUE) && defined(SO_ZEROCOPY) && \
+    defined(SO_EE_ORIGIN_ZEROCOPY)
+#define GRPC_TCP_ZEROCOPY 1
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+#endif
+
 grpc_tracer_flag grpc_tcp_trace = GRPC_TRACER_INITIALIZER(false, "tcp");
 
+/* A write sent with MSG_ZEROCOPY. The kernel may keep reading the memory
+   behind these slices until it posts a completion for this sequence number
+   to the socket error queue, so the record holds refs to them (and copies of
+   any inlined bytes) until then. The slices follow the struct in memory. */
+typedef struct zerocopy_send_record {
+  struct zerocopy_send_record *next;
+  uint32_t seq;
+  size_t nslices;
+} zerocopy_send_record;
+
+#define ZEROCOPY_RECORD_SLICES(r) ((grpc_slice *)((r) + 1))
+
 typedef struct {
   grpc_endpoint base;
   grpc_fd *em_fd;
@@ -75,6 +111,19 @@ typedef struct {
 
   int min_read_chunk_size;
   int max_read_chunk_size;
+  /** a read that has waited this long for data drops its buffer, rather
+      than keeping it for the data to arrive; zero keeps it
+      (GRPC_ARG_IDLE_CONNECTION_MEMORY_RELEASE_MS) */
+  int idle_read_release_ms;
+  /** guards the read buffer against idle_read_timer while a read waits */
+  gpr_mu idle_read_mu;
+  /** is a read waiting for the socket to become readable, and since when? */
+  bool idle_read_waiting;
+  gpr_timespec idle_read_since;
+  bool idle_read_timer_armed;
+  bool idle_read_shutdown;
+  grpc_timer idle_read_timer;
+  grpc_closure idle_read_timer_closure;
 
   /* garbage after the last read */
   grpc_slice_buffer last_read_buffer;
@@ -98,6 +147,43 @@ typedef struct {
 
   grpc_resource_user *resource_user;
   grpc_resource_user_slice_allocator slice_allocator;
+
+  /* MSG_ZEROCOPY: writes of at least zerocopy_threshold bytes skip the copy
+     into the kernel when zerocopy_enabled */
+  bool zerocopy_enabled;
+  size_t zerocopy_threshold;
+  /** sequence number the kernel will assign to the next zerocopy write */
+  uint32_t zerocopy_next_seq;
+  /** number of records in the zerocopy list (readable without the lock) */
+  gpr_atm zerocopy_outstanding;
+  /** guards the list of records awaiting completion, oldest first */
+  gpr_mu zerocopy_mu;
+  zerocopy_send_record *zerocopy_head;
+  zerocopy_send_record *zerocopy_tail;
+  /** once the last ref is gone, polls the error queue until the records
+      above drain, keeping the fd open until then */
+  grpc_timer zerocopy_drain_timer;
+  grpc_closure zerocopy_drain_closure;
+  gpr_timespec zerocopy_drain_deadline;
+  int zerocopy_drain_backoff_ms;
+
+  /* write coalescing: when the caller hints that another write follows, the
+     tail of this one is sent with MSG_MORE and left for the kernel to hold
+     back until that write (or cork_timer, after cork_budget) pushes it */
+  bool coalescing_enabled;
+  gpr_timespec cork_budget;
+  /** set by tcp_hint_write_more, consumed by the next tcp_write */
+  bool write_more_hinted;
+  /** whether the write in progress is to end with MSG_MORE */
+  bool outgoing_more;
+  /** whether bytes sent with MSG_MORE may still be held back by the kernel */
+  gpr_atm corked;
+  /** bytes and segments offered since the last push, for the write stats */
+  gpr_atm corked_bytes;
+  gpr_atm corked_iovs;
+  gpr_atm cork_timer_armed;
+  grpc_timer cork_timer;
+  grpc_closure cork_timer_closure;
 } grpc_tcp;
 
 typedef struct backup_poller {
@@ -278,6 +364,101 @@ static size_t get_target_read_size(grpc_tcp *tcp) {
   return sz;
 }
 
+static void zerocopy_record_destroy(grpc_exec_ctx *exec_ctx,
+                                    zerocopy_send_record *r) {
+  for (size_t i = 0; i < r->nslices; i++) {
+    grpc_slice_unref_internal(exec_ctx, ZEROCOPY_RECORD_SLICES(r)[i]);
+  }
+  gpr_free(r);
+}
+
+/* Release every record up to and including sequence number last_seq (or all
+   of them if release_all). TCP completes zerocopy writes in order, so this
+   is always a prefix of the list. */
+static void zerocopy_records_release(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp,
+                                     uint32_t last_seq, bool release_all) {
+  zerocopy_send_record *done = NULL;
+  zerocopy_send_record **done_tail = &done;
+  gpr_atm ndone = 0;
+  gpr_mu_lock(&tcp->zerocopy_mu);
+  while (tcp->zerocopy_head != NULL &&
+         (release_all || (int32_t)(tcp->zerocopy_head->seq - last_seq) <= 0)) {
+    *done_tail = tcp->zerocopy_head;
+    done_tail = &tcp->zerocopy_head->next;
+    tcp->zerocopy_head = tcp->zerocopy_head->next;
+    ndone++;
+  }
+  *done_tail = NULL;
+  if (tcp->zerocopy_head == NULL) tcp->zerocopy_tail = NULL;
+  gpr_mu_unlock(&tcp->zerocopy_mu);
+  gpr_atm_no_barrier_fetch_add(&tcp->zerocopy_outstanding, -ndone);
+  while (done != NULL) {
+    zerocopy_send_record *next = done->next;
+    zerocopy_record_destroy(exec_ctx, done);
+    done = next;
+  }
+}
+
+/* Drain MSG_ZEROCOPY completions from the socket error queue, releasing the
+   slices of every write the kernel is done with. Completions raise EPOLLERR,
+   which wakes up a pending read, so this runs from the read path (and
+   opportunistically before each write). */
+static void tcp_process_errqueue(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp) {
+#ifdef GRPC_TCP_ZEROCOPY
+  if (gpr_atm_no_barrier_load(&tcp->zerocopy_outstanding) == 0) return;
+  for (;;) {
+    union {
+      char buf[CMSG_SPACE(sizeof(struct sock_extended_err)) +
+               CMSG_SPACE(sizeof(struct sockaddr_in6))];
+      struct cmsghdr align;
+    } control;
+    struct msghdr msg;
+    ssize_t r;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+    do {
+      r = recvmsg(tcp->fd, &msg, MSG_ERRQUEUE);
+    } while (r < 0 && errno == EINTR);
+    if (r < 0) {
+      /* EAGAIN: nothing left to process */
+      return;
+    }
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL;
+         cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+      if (!(cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_RECVERR) &&
+          !(cmsg->cmsg_level == IPPROTO_IPV6 &&
+            cmsg->cmsg_type == IPV6_RECVERR)) {
+        continue;
+      }
+      struct sock_extended_err *serr =
+          (struct sock_extended_err *)CMSG_DATA(cmsg);
+      if (serr->ee_errno != 0 || serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+        continue;
+      }
+      if (serr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+        GRPC_STATS_INC_TCP_WRITE_ZEROCOPY_COPIED(exec_ctx);
+      }
+      if (GRPC_TRACER_ON(grpc_tcp_trace)) {
+        gpr_log(GPR_DEBUG, "TCP:%p zerocopy done %u..%u", tcp, serr->ee_info,
+                serr->ee_data);
+      }
+      /* [ee_info, ee_data] is the range of completed sequence numbers */
+      zerocopy_records_release(exec_ctx, tcp, serr->ee_data, false);
+    }
+  }
+#endif
+}
+
+static bool tcp_enable_zerocopy(int fd) {
+#ifdef GRPC_TCP_ZEROCOPY
+  const int enable = 1;
+  return setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)) == 0;
+#else
+  return false;
+#endif
+}
+
 static grpc_error *tcp_annotate_error(grpc_error *src_error, grpc_tcp *tcp) {
   return grpc_error_set_str(
       grpc_error_set_int(src_error, GRPC_ERROR_INT_FD, tcp->fd),
@@ -293,11 +474,20 @@ static void tcp_handle_write(grpc_exec_ctx *exec_ctx, void *arg /* grpc_tcp */,
 static void tcp_shutdown(grpc_exec_ctx *exec_ctx, grpc_endpoint *ep,
                          grpc_error *why) {
   grpc_tcp *tcp = (grpc_tcp *)ep;
+  grpc_timer_cancel(exec_ctx, &tcp->cork_timer);
+  if (tcp->idle_read_release_ms > 0) {
+    gpr_mu_lock(&tcp->idle_read_mu);
+    tcp->idle_read_shutdown = true;
+    grpc_timer_cancel(exec_ctx, &tcp->idle_read_timer);
+    gpr_mu_unlock(&tcp->idle_read_mu);
+  }
   grpc_fd_shutdown(exec_ctx, tcp->em_fd, why);
   grpc_resource_user_shutdown(exec_ctx, tcp->resource_user);
 }
 
-static void tcp_free(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp) {
+static void tcp_free_now(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp) {
+  gpr_mu_destroy(&tcp->zerocopy_mu);
+  gpr_mu_destroy(&tcp->idle_read_mu);
   grpc_fd_orphan(exec_ctx, tcp->em_fd, tcp->release_fd_cb, tcp->release_fd,
                  false /* already_closed */, "tcp_unref_orphan");
   grpc_slice_buffer_destroy_internal(exec_ctx, &tcp->last_read_buffer);
@@ -306,6 +496,72 @@ static void tcp_free(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp) {
   gpr_free(tcp);
 }
 
+#define ZEROCOPY_DRAIN_INITIAL_BACKOFF_MS 1
+#define ZEROCOPY_DRAIN_MAX_BACKOFF_MS 100
+#define ZEROCOPY_DRAIN_TIMEOUT_S 30
+
+static void zerocopy_drain_arm(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp) {
+  gpr_timespec now = gpr_now(GPR_CLOCK_MONOTONIC);
+  grpc_timer_init(
+      exec_ctx, &tcp->zerocopy_drain_timer,
+      gpr_time_add(now, gpr_time_from_millis(tcp->zerocopy_drain_backoff_ms,
+                                             GPR_TIMESPAN)),
+      &tcp->zerocopy_drain_closure, now);
+  tcp->zerocopy_drain_backoff_ms = GPR_MIN(
+      2 * tcp->zerocopy_drain_backoff_ms, ZEROCOPY_DRAIN_MAX_BACKOFF_MS);
+}
+
+static void tcp_handle_zerocopy_drain(grpc_exec_ctx *exec_ctx,
+                                      void *arg /* grpc_tcp */,
+                                      grpc_error *error) {
+  grpc_tcp *tcp = (grpc_tcp *)arg;
+  tcp_process_errqueue(exec_ctx, tcp);
+  if (gpr_atm_no_barrier_load(&tcp->zerocopy_outstanding) != 0) {
+    if (error == GRPC_ERROR_NONE &&
+        gpr_time_cmp(gpr_now(GPR_CLOCK_MONOTONIC),
+                     tcp->zerocopy_drain_deadline) < 0) {
+      zerocopy_drain_arm(exec_ctx, tcp);
+      return;
+    }
+    /* the kernel never reported these writes done (or timers are shutting
+       down): leak the slices rather than let their memory be reused while
+       the kernel may still read it */
+    gpr_log(GPR_ERROR, "TCP:%p leaking %" PRIdPTR " unfinished zerocopy writes",
+            tcp, gpr_atm_no_barrier_load(&tcp->zerocopy_outstanding));
+    gpr_mu_lock(&tcp->zerocopy_mu);
+    while (tcp->zerocopy_head != NULL) {
+      zerocopy_send_record *next = tcp->zerocopy_head->next;
+      gpr_free(tcp->zerocopy_head);
+      tcp->zerocopy_head = next;
+    }
+    tcp->zerocopy_tail = NULL;
+    gpr_mu_unlock(&tcp->zerocopy_mu);
+  }
+  tcp_free_now(exec_ctx, tcp);
+}
+
+static void tcp_free(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp) {
+  /* the kernel may keep reading the memory behind unfinished zerocopy writes
+     until it reports them on the error queue, so their slices (and the fd
+     that queue belongs to) must outlive the endpoint until it does */
+  tcp_process_errqueue(exec_ctx, tcp);
+  if (gpr_atm_no_barrier_load(&tcp->zerocopy_outstanding) == 0) {
+    tcp_free_now(exec_ctx, tcp);
+    return;
+  }
+  if (GRPC_TRACER_ON(grpc_tcp_trace)) {
+    gpr_log(GPR_DEBUG, "TCP:%p waiting for %" PRIdPTR " zerocopy writes", tcp,
+            gpr_atm_no_barrier_load(&tcp->zerocopy_outstanding));
+  }
+  tcp->zerocopy_drain_deadline =
+      gpr_time_add(gpr_now(GPR_CLOCK_MONOTONIC),
+                   gpr_time_from_seconds(ZEROCOPY_DRAIN_TIMEOUT_S, GPR_TIMESPAN));
+  tcp->zerocopy_drain_backoff_ms = ZEROCOPY_DRAIN_INITIAL_BACKOFF_MS;
+  GRPC_CLOSURE_INIT(&tcp->zerocopy_drain_closure, tcp_handle_zerocopy_drain,
+                    tcp, grpc_schedule_on_exec_ctx);
+  zerocopy_drain_arm(exec_ctx, tcp);
+}
+
 #ifndef NDEBUG
 #define TCP_UNREF(cl, tcp, reason) \
   tcp_unref((cl), (tcp), (reason), __FILE__, __LINE__)
@@ -376,6 +632,67 @@ static void call_read_cb(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp,
 }
 
 #define MAX_READ_IOVEC 4
+/* The timer and the closures are scheduled on the exec_ctx, so arming and
+   cancelling it under idle_read_mu runs nothing under the lock */
+static void idle_read_arm_timer_locked(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp,
+                                       gpr_timespec now) {
+  grpc_timer_init(
+      exec_ctx, &tcp->idle_read_timer,
+      gpr_time_add(tcp->idle_read_since,
+                   gpr_time_from_millis(tcp->idle_read_release_ms,
+                                        GPR_TIMESPAN)),
+      &tcp->idle_read_timer_closure, now);
+}
+
+/* called before waiting for the socket to become readable */
+static void idle_read_start_waiting(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp) {
+  gpr_timespec now = gpr_now(GPR_CLOCK_MONOTONIC);
+  gpr_mu_lock(&tcp->idle_read_mu);
+  tcp->idle_read_waiting = true;
+  tcp->idle_read_since = now;
+  /* a pending timer re-arms itself from idle_read_since when it fires */
+  if (!tcp->idle_read_timer_armed && !tcp->idle_read_shutdown) {
+    tcp->idle_read_timer_armed = true;
+    TCP_REF(tcp, "idle_read_timer");
+    idle_read_arm_timer_locked(exec_ctx, tcp, now);
+  }
+  gpr_mu_unlock(&tcp->idle_read_mu);
+}
+
+static void idle_read_stop_waiting(grpc_tcp *tcp) {
+  gpr_mu_lock(&tcp->idle_read_mu);
+  tcp->idle_read_waiting = false;
+  gpr_mu_unlock(&tcp->idle_read_mu);
+}
+
+static void tcp_handle_idle_read_timeout(grpc_exec_ctx *exec_ctx,
+                                         void *arg /* grpc_tcp */,
+                                         grpc_error *error) {
+  grpc_tcp *tcp = (grpc_tcp *)arg;
+  gpr_timespec now = gpr_now(GPR_CLOCK_MONOTONIC);
+  bool rearm = false;
+  gpr_mu_lock(&tcp->idle_read_mu);
+  if (error == GRPC_ERROR_NONE && tcp->idle_read_waiting &&
+      !tcp->idle_read_shutdown) {
+    gpr_timespec idle_for = gpr_time_sub(now, tcp->idle_read_since);
+    if (gpr_time_to_millis(idle_for) >= tcp->idle_read_release_ms) {
+      /* nothing has arrived for a whole idle period: tcp_continue_read
+         allocates a new buffer once the socket is readable */
+      grpc_slice_buffer_reset_and_unref_internal(exec_ctx,
+                                                 tcp->incoming_buffer);
+    } else {
+      /* the connection read since the timer was armed */
+      rearm = true;
+      idle_read_arm_timer_locked(exec_ctx, tcp, now);
+    }
+  }
+  tcp->idle_read_timer_armed = rearm;
+  gpr_mu_unlock(&tcp->idle_read_mu);
+  if (!rearm) {
+    TCP_UNREF(exec_ctx, tcp, "idle_read_timer");
+  }
+}
+
 static void tcp_do_read(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp) {
   struct msghdr msg;
   struct iovec iov[MAX_READ_IOVEC];
@@ -414,6 +731,9 @@ static void tcp_do_read(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp) {
      * be running. */
     if (errno == EAGAIN) {
       finish_estimate(tcp);
+      if (tcp->idle_read_release_ms > 0) {
+        idle_read_start_waiting(exec_ctx, tcp);
+      }
       /* We've consumed the edge, request a new one */
       notify_on_read(exec_ctx, tcp);
     } else {
@@ -491,6 +811,10 @@ static void tcp_handle_read(grpc_exec_ctx *exec_ctx, void *arg /* grpc_tcp */,
   if (GRPC_TRACER_ON(grpc_tcp_trace)) {
     gpr_log(GPR_DEBUG, "TCP:%p got_read: %s", tcp, grpc_error_string(error));
   }
+  if (tcp->idle_read_release_ms > 0) {
+    idle_read_stop_waiting(tcp);
+  }
+  tcp_process_errqueue(exec_ctx, tcp);
 
   if (error != GRPC_ERROR_NONE) {
     grpc_slice_buffer_reset_and_unref_internal(exec_ctx, tcp->incoming_buffer);
@@ -520,6 +844,130 @@ static void tcp_read(grpc_exec_ctx *exec_ctx, grpc_endpoint *ep,
   }
 }
 
+static ssize_t tcp_send(grpc_exec_ctx *exec_ctx, int fd,
+                        const struct msghdr *msg, int flags) {
+  ssize_t sent_length;
+  GPR_TIMER_BEGIN("sendmsg", 1);
+  do {
+    GRPC_STATS_INC_SYSCALL_WRITE(exec_ctx);
+    sent_length = sendmsg(fd, msg, flags);
+  } while (sent_length < 0 && errno == EINTR);
+  GPR_TIMER_END("sendmsg", 0);
+  return sent_length;
+}
+
+#ifdef GRPC_TCP_ZEROCOPY
+static zerocopy_send_record *zerocopy_record_create(grpc_tcp *tcp,
+                                                   size_t first_slice_idx,
+                                                   size_t nslices) {
+  zerocopy_send_record *r = (zerocopy_send_record *)gpr_malloc(
+      sizeof(*r) + nslices * sizeof(grpc_slice));
+  r->next = NULL;
+  r->seq = 0;
+  r->nslices = nslices;
+  for (size_t i = 0; i < nslices; i++) {
+    ZEROCOPY_RECORD_SLICES(r)[i] = grpc_slice_ref_internal(
+        tcp->outgoing_buffer->slices[first_slice_idx + i]);
+  }
+  return r;
+}
+
+static void zerocopy_record_push(grpc_tcp *tcp, zerocopy_send_record *r) {
+  r->seq = tcp->zerocopy_next_seq++;
+  gpr_mu_lock(&tcp->zerocopy_mu);
+  if (tcp->zerocopy_tail == NULL) {
+    tcp->zerocopy_head = r;
+  } else {
+    tcp->zerocopy_tail->next = r;
+  }
+  tcp->zerocopy_tail = r;
+  gpr_mu_unlock(&tcp->zerocopy_mu);
+  gpr_atm_no_barrier_fetch_add(&tcp->zerocopy_outstanding, 1);
+}
+
+/* point each iov entry at the corresponding slice, skipping first_byte_idx
+   bytes of the first one */
+static void set_iov_bases(struct iovec *iov, msg_iovlen_type iov_size,
+                          grpc_slice *slices, size_t first_byte_idx) {
+  for (msg_iovlen_type i = 0; i < iov_size; i++) {
+    iov[i].iov_base =
+        GRPC_SLICE_START_PTR(slices[i]) + (i == 0 ? first_byte_idx : 0);
+  }
+}
+
+/* Send msg (built from outgoing_buffer starting at first_slice_idx) with
+   MSG_ZEROCOPY. On success the slices are kept alive by a record until the
+   kernel reports completion; if the kernel cannot take the write as zerocopy
+   it is sent as a regular, copying write. */
+static ssize_t tcp_send_zerocopy(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp,
+                                 struct msghdr *msg, int flags,
+                                 size_t first_slice_idx,
+                                 size_t first_byte_idx) {
+  zerocopy_send_record *r =
+      zerocopy_record_create(tcp, first_slice_idx, (size_t)msg->msg_iovlen);
+  /* inlined slices carry their bytes by value: send from the record's copies,
+     which outlive the caller's slice buffer */
+  set_iov_bases(msg->msg_iov, (msg_iovlen_type)msg->msg_iovlen,
+                ZEROCOPY_RECORD_SLICES(r), first_byte_idx);
+  ssize_t sent_length =
+      tcp_send(exec_ctx, tcp->fd, msg, flags | MSG_ZEROCOPY);
+  if (sent_length >= 0) {
+    GRPC_STATS_INC_TCP_WRITE_ZEROCOPY(exec_ctx);
+    zerocopy_record_push(tcp, r);
+    return sent_length;
+  }
+  int saved_errno = errno;
+  set_iov_bases(msg->msg_iov, (msg_iovlen_type)msg->msg_iovlen,
+                &tcp->outgoing_buffer->slices[first_slice_idx], first_byte_idx);
+  zerocopy_record_destroy(exec_ctx, r);
+  if (saved_errno == ENOBUFS) {
+    /* out of optmem to track the completion: copy this write instead */
+    GRPC_STATS_INC_TCP_WRITE_ZEROCOPY_FALLBACK(exec_ctx);
+    return tcp_send(exec_ctx, tcp->fd, msg, flags);
+  }
+  errno = saved_errno;
+  return sent_length;
+}
+#endif
+
+/* record a run of corked writes, now pushed, as one write in the stats */
+static void cork_record_push(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp) {
+  GRPC_STATS_INC_TCP_WRITE_SIZE(exec_ctx,
+                                gpr_atm_full_xchg(&tcp->corked_bytes, 0));
+  GRPC_STATS_INC_TCP_WRITE_IOV_SIZE(exec_ctx,
+                                    gpr_atm_full_xchg(&tcp->corked_iovs, 0));
+}
+
+static void tcp_handle_cork_timeout(grpc_exec_ctx *exec_ctx,
+                                    void *arg /* grpc_tcp */,
+                                    grpc_error *error) {
+  grpc_tcp *tcp = (grpc_tcp *)arg;
+  gpr_atm_rel_store(&tcp->cork_timer_armed, 0);
+  if (error == GRPC_ERROR_NONE && gpr_atm_full_cas(&tcp->corked, 1, 0)) {
+    /* the announced write did not come in time: setting TCP_NODELAY pushes
+       out whatever MSG_MORE held back */
+    GRPC_STATS_INC_TCP_WRITE_CORK_TIMEOUTS(exec_ctx);
+    cork_record_push(exec_ctx, tcp);
+    grpc_error *err = grpc_set_socket_low_latency(tcp->fd, 1);
+    if (err != GRPC_ERROR_NONE && GRPC_TRACER_ON(grpc_tcp_trace)) {
+      gpr_log(GPR_DEBUG, "TCP:%p uncork: %s", tcp, grpc_error_string(err));
+    }
+    GRPC_ERROR_UNREF(err);
+  }
+  TCP_UNREF(exec_ctx, tcp, "cork_timer");
+}
+
+/* bound how long the kernel may hold back the tail of the last write */
+static void cork_arm_timer(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp) {
+  /* an already pending timer fires early for this write, which is harmless */
+  if (!gpr_atm_full_cas(&tcp->cork_timer_armed, 0, 1)) return;
+  TCP_REF(tcp, "cork_timer");
+  gpr_timespec now = gpr_now(GPR_CLOCK_MONOTONIC);
+  grpc_timer_init(exec_ctx, &tcp->cork_timer,
+                  gpr_time_add(now, tcp->cork_budget),
+                  &tcp->cork_timer_closure, now);
+}
+
 /* returns true if done, false if pending; if returning true, *error is set */
 #define MAX_WRITE_IOVEC 1000
 static bool tcp_flush(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp,
@@ -562,16 +1010,30 @@ static bool tcp_flush(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp,
     msg.msg_controllen = 0;
     msg.msg_flags = 0;
 
-    GRPC_STATS_INC_TCP_WRITE_SIZE(exec_ctx, sending_length);
-    GRPC_STATS_INC_TCP_WRITE_IOV_SIZE(exec_ctx, iov_size);
+    int flags = SENDMSG_FLAGS;
+    if (tcp->coalescing_enabled) {
+      /* more is known to follow if this is a partial write, or if the caller
+         announced its next write */
+      if (tcp->outgoing_slice_idx != tcp->outgoing_buffer->count ||
+          tcp->outgoing_more) {
+        flags |= SENDMSG_MORE_FLAG;
+      }
+      gpr_atm_no_barrier_fetch_add(&tcp->corked_bytes, (gpr_atm)sending_length);
+      gpr_atm_no_barrier_fetch_add(&tcp->corked_iovs, (gpr_atm)iov_size);
+    } else {
+      GRPC_STATS_INC_TCP_WRITE_SIZE(exec_ctx, sending_length);
+      GRPC_STATS_INC_TCP_WRITE_IOV_SIZE(exec_ctx, iov_size);
+    }
 
-    GPR_TIMER_BEGIN("sendmsg", 1);
-    do {
-      /* TODO(klempner): Cork if this is a partial write */
-      GRPC_STATS_INC_SYSCALL_WRITE(exec_ctx);
-      sent_length = sendmsg(tcp->fd, &msg, SENDMSG_FLAGS);
-    } while (sent_length < 0 && errno == EINTR);
-    GPR_TIMER_END("sendmsg", 0);
+#ifdef GRPC_TCP_ZEROCOPY
+    if (tcp->zerocopy_enabled && sending_length >= tcp->zerocopy_threshold) {
+      sent_length = tcp_send_zerocopy(exec_ctx, tcp, &msg, flags,
+                                      unwind_slice_idx, unwind_byte_idx);
+    } else
+#endif
+    {
+      sent_length = tcp_send(exec_ctx, tcp->fd, &msg, flags);
+    }
 
     if (sent_length < 0) {
       if (errno == EAGAIN) {
@@ -589,6 +1051,11 @@ static bool tcp_flush(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp,
       }
     }
 
+    if (flags & SENDMSG_MORE_FLAG) {
+      GRPC_STATS_INC_TCP_WRITE_CORKED(exec_ctx);
+      gpr_atm_rel_store(&tcp->corked, 1);
+    }
+
     GPR_ASSERT(tcp->outgoing_byte_idx == 0);
     trailing = sending_length - (size_t)sent_length;
     while (trailing > 0) {
@@ -606,6 +1073,14 @@ static bool tcp_flush(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp,
     }
 
     if (tcp->outgoing_slice_idx == tcp->outgoing_buffer->count) {
+      if (tcp->coalescing_enabled) {
+        if (flags & SENDMSG_MORE_FLAG) {
+          cork_arm_timer(exec_ctx, tcp);
+        } else {
+          gpr_atm_rel_store(&tcp->corked, 0);
+          cork_record_push(exec_ctx, tcp);
+        }
+      }
       *error = GRPC_ERROR_NONE;
       return true;
     }
@@ -661,6 +1136,9 @@ static void tcp_write(grpc_exec_ctx *exec_ctx, grpc_endpoint *ep,
 
   GPR_TIMER_BEGIN("tcp_write", 0);
   GPR_ASSERT(tcp->write_cb == NULL);
+  tcp_process_errqueue(exec_ctx, tcp);
+  tcp->outgoing_more = tcp->write_more_hinted;
+  tcp->write_more_hinted = false;
 
   if (buf->length == 0) {
     GPR_TIMER_END("tcp_write", 0);
@@ -721,10 +1199,15 @@ static grpc_resource_user *tcp_get_resource_user(grpc_endpoint *ep) {
   return tcp->resource_user;
 }
 
+static void tcp_hint_write_more(grpc_endpoint *ep) {
+  grpc_tcp *tcp = (grpc_tcp *)ep;
+  tcp->write_more_hinted = tcp->coalescing_enabled;
+}
+
 static const grpc_endpoint_vtable vtable = {
     tcp_read,     tcp_write,   tcp_add_to_pollset,    tcp_add_to_pollset_set,
     tcp_shutdown, tcp_destroy, tcp_get_resource_user, tcp_get_peer,
-    tcp_get_fd};
+    tcp_get_fd,   tcp_hint_write_more};
 
 #define MAX_CHUNK_SIZE 32 * 1024 * 1024
 
@@ -734,6 +1217,14 @@ grpc_endpoint *grpc_tcp_create(grpc_exec_ctx *exec_ctx, grpc_fd *em_fd,
   int tcp_read_chunk_size = GRPC_TCP_DEFAULT_READ_SLICE_SIZE;
   int tcp_max_read_chunk_size = 4 * 1024 * 1024;
   int tcp_min_read_chunk_size = 256;
+  bool tcp_tx_zerocopy_enabled = false;
+  int tcp_tx_zerocopy_send_bytes_threshold =
+      GRPC_TCP_DEFAULT_TX_ZEROCOPY_SEND_BYTES_THRESHOLD;
+  int busy_poll_us = 0;
+  int idle_read_release_ms = 0;
+  bool tcp_write_coalescing = false;
+  int tcp_write_coalescing_budget_us =
+      GRPC_TCP_DEFAULT_WRITE_COALESCING_BUDGET_US;
   grpc_resource_quota *resource_quota = grpc_resource_quota_create(NULL);
   if (channel_args != NULL) {
     for (size_t i = 0; i < channel_args->num_args; i++) {
@@ -755,6 +1246,37 @@ grpc_endpoint *grpc_tcp_create(grpc_exec_ctx *exec_ctx, grpc_fd *em_fd,
                                         MAX_CHUNK_SIZE};
         tcp_max_read_chunk_size =
             grpc_channel_arg_get_integer(&channel_args->args[i], options);
+      } else if (0 == strcmp(channel_args->args[i].key,
+                             GRPC_ARG_TCP_TX_ZEROCOPY_ENABLED)) {
+        tcp_tx_zerocopy_enabled = grpc_channel_arg_get_bool(
+            &channel_args->args[i], tcp_tx_zerocopy_enabled);
+      } else if (0 == strcmp(channel_args->args[i].key,
+                             GRPC_ARG_TCP_TX_ZEROCOPY_SEND_BYTES_THRESHOLD)) {
+        grpc_integer_options options = {
+            tcp_tx_zerocopy_send_bytes_threshold, 0, INT_MAX};
+        tcp_tx_zerocopy_send_bytes_threshold =
+            grpc_channel_arg_get_integer(&channel_args->args[i], options);
+      } else if (0 == strcmp(channel_args->args[i].key,
+                             GRPC_ARG_TCP_WRITE_COALESCING)) {
+        tcp_write_coalescing = grpc_channel_arg_get_bool(
+            &channel_args->args[i], tcp_write_coalescing);
+      } else if (0 == strcmp(channel_args->args[i].key,
+                             GRPC_ARG_TCP_WRITE_COALESCING_BUDGET_US)) {
+        /* past 200ms the kernel's own cork timeout takes over anyway */
+        grpc_integer_options options = {tcp_write_coalescing_budget_us, 1,
+                                        200000};
+        tcp_write_coalescing_budget_us =
+            grpc_channel_arg_get_integer(&channel_args->args[i], options);
+      } else if (0 == strcmp(channel_args->args[i].key,
+                             GRPC_ARG_IDLE_CONNECTION_MEMORY_RELEASE_MS)) {
+        grpc_integer_options options = {0, 0, INT_MAX};
+        idle_read_release_ms =
+            grpc_channel_arg_get_integer(&channel_args->args[i], options);
+      } else if (0 ==
+                 strcmp(channel_args->args[i].key, GRPC_ARG_BUSY_POLL_US)) {
+        grpc_integer_options options = {0, 0, INT_MAX};
+        busy_poll_us =
+            grpc_channel_arg_get_integer(&channel_args->args[i], options);
       } else if (0 ==
                  strcmp(channel_args->args[i].key, GRPC_ARG_RESOURCE_QUOTA)) {
         grpc_resource_quota_unref_internal(exec_ctx, resource_quota);
@@ -770,6 +1292,18 @@ grpc_endpoint *grpc_tcp_create(grpc_exec_ctx *exec_ctx, grpc_fd *em_fd,
   tcp_read_chunk_size = GPR_CLAMP(tcp_read_chunk_size, tcp_min_read_chunk_size,
                                   tcp_max_read_chunk_size);
 
+#ifdef GRPC_LINUX_IO_URING
+  if (grpc_uring_enabled() && !tcp_tx_zerocopy_enabled &&
+      !tcp_write_coalescing && idle_read_release_ms == 0 &&
+      busy_poll_us == 0) {
+    grpc_endpoint *ep = grpc_tcp_uring_create(
+        exec_ctx, em_fd, resource_quota, tcp_read_chunk_size,
+        tcp_min_read_chunk_size, tcp_max_read_chunk_size, peer_string);
+    grpc_resource_quota_unref_internal(exec_ctx, resource_quota);
+    return ep;
+  }
+#endif
+
   grpc_tcp *tcp = (grpc_tcp *)gpr_malloc(sizeof(grpc_tcp));
   tcp->base.vtable = &vtable;
   tcp->peer_string = gpr_strdup(peer_string);
@@ -782,6 +1316,15 @@ grpc_endpoint *grpc_tcp_create(grpc_exec_ctx *exec_ctx, grpc_fd *em_fd,
   tcp->target_length = (double)tcp_read_chunk_size;
   tcp->min_read_chunk_size = tcp_min_read_chunk_size;
   tcp->max_read_chunk_size = tcp_max_read_chunk_size;
+  tcp->idle_read_release_ms = idle_read_release_ms;
+  gpr_mu_init(&tcp->idle_read_mu);
+  tcp->idle_read_waiting = false;
+  tcp->idle_read_timer_armed = false;
+  tcp->idle_read_shutdown = false;
+  grpc_timer_init_unset(&tcp->idle_read_timer);
+  GRPC_CLOSURE_INIT(&tcp->idle_read_timer_closure,
+                    tcp_handle_idle_read_timeout, tcp,
+                    grpc_schedule_on_exec_ctx);
   tcp->bytes_read_this_round = 0;
   tcp->finished_edge = true;
   /* paired with unref in grpc_tcp_destroy */
@@ -789,6 +1332,39 @@ grpc_endpoint *grpc_tcp_create(grpc_exec_ctx *exec_ctx, grpc_fd *em_fd,
   gpr_atm_no_barrier_store(&tcp->shutdown_count, 0);
   tcp->em_fd = em_fd;
   grpc_slice_buffer_init(&tcp->last_read_buffer);
+  tcp->zerocopy_enabled =
+      tcp_tx_zerocopy_enabled && tcp_enable_zerocopy(tcp->fd);
+  if (tcp_tx_zerocopy_enabled && !tcp->zerocopy_enabled &&
+      GRPC_TRACER_ON(grpc_tcp_trace)) {
+    gpr_log(GPR_DEBUG, "TCP:%p MSG_ZEROCOPY unavailable, copying writes", tcp);
+  }
+  tcp->zerocopy_threshold = (size_t)tcp_tx_zerocopy_send_bytes_threshold;
+  tcp->zerocopy_next_seq = 0;
+  gpr_atm_no_barrier_store(&tcp->zerocopy_outstanding, 0);
+  gpr_mu_init(&tcp->zerocopy_mu);
+  tcp->zerocopy_head = NULL;
+  tcp->zerocopy_tail = NULL;
+  tcp->coalescing_enabled = tcp_write_coalescing && SENDMSG_MORE_FLAG != 0;
+  tcp->cork_budget =
+      gpr_time_from_micros(tcp_write_coalescing_budget_us, GPR_TIMESPAN);
+  tcp->write_more_hinted = false;
+  tcp->outgoing_more = false;
+  gpr_atm_no_barrier_store(&tcp->corked, 0);
+  gpr_atm_no_barrier_store(&tcp->corked_bytes, 0);
+  gpr_atm_no_barrier_store(&tcp->corked_iovs, 0);
+  gpr_atm_no_barrier_store(&tcp->cork_timer_armed, 0);
+  grpc_timer_init_unset(&tcp->cork_timer);
+  GRPC_CLOSURE_INIT(&tcp->cork_timer_closure, tcp_handle_cork_timeout, tcp,
+                    grpc_schedule_on_exec_ctx);
+  if (busy_poll_us > 0) {
+    /* Usually fails without CAP_NET_ADMIN; busy polling the completion queue
+       does not depend on it, so only mention it when tracing */
+    grpc_error *err = grpc_set_socket_busy_poll(tcp->fd, busy_poll_us);
+    if (err != GRPC_ERROR_NONE && GRPC_TRACER_ON(grpc_tcp_trace)) {
+      gpr_log(GPR_DEBUG, "TCP:%p %s", tcp, grpc_error_string(err));
+    }
+    GRPC_ERROR_UNREF(err);
+  }
   tcp->resource_user = grpc_resource_user_create(resource_quota, peer_string);
   grpc_resource_user_slice_allocator_init(
       &tcp->slice_allocator, tcp->resource_user, tcp_read_allocation_done, tcp);
@@ -800,6 +1376,11 @@ grpc_endpoint *grpc_tcp_create(grpc_exec_ctx *exec_ctx, grpc_fd *em_fd,
 }
 
 int grpc_tcp_fd(grpc_endpoint *ep) {
+#ifdef GRPC_LINUX_IO_URING
+  if (grpc_is_tcp_uring_endpoint(ep)) {
+    return grpc_endpoint_get_fd(ep);
+  }
+#endif
   grpc_tcp *tcp = (grpc_tcp *)ep;
   GPR_ASSERT(ep->vtable == &vtable);
   return grpc_fd_wrapped_fd(tcp->em_fd);
@@ -807,6 +1388,12 @@ int grpc_tcp_fd(grpc_endpoint *ep) {
 
 void grpc_tcp_destroy_and_release_fd(grpc_exec_ctx *exec_ctx, grpc_endpoint *ep,
                                      int *fd, grpc_closure *done) {
+#ifdef GRPC_LINUX_IO_URING
+  if (grpc_is_tcp_uring_endpoint(ep)) {
+    grpc_tcp_uring_destroy_and_release_fd(exec_ctx, ep, fd, done);
+    return;
+  }
+#endif
   grpc_network_status_unregister_endpoint(ep);
   grpc_tcp *tcp = (grpc_tcp *)ep;
   GPR_ASSERT(ep->vtable == &vtable);
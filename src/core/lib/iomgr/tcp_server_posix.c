@@ -38,6 +38,7 @@
 #include <unistd.h>
 
 #include <grpc/support/alloc.h>
+#include <grpc/support/cpu.h>
 #include <grpc/support/log.h>
 #include <grpc/support/string_util.h>
 #include <grpc/support/sync.h>
@@ -45,6 +46,7 @@
 #include <grpc/support/useful.h>
 
 #include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/iomgr/ev_uring_linux.h"
 #include "src/core/lib/iomgr/resolve_address.h"
 #include "src/core/lib/iomgr/sockaddr.h"
 #include "src/core/lib/iomgr/sockaddr_utils.h"
@@ -77,6 +79,7 @@ grpc_error *grpc_tcp_server_create(grpc_exec_ctx *exec_ctx,
   grpc_tcp_server *s = (grpc_tcp_server *)gpr_zalloc(sizeof(grpc_tcp_server));
   s->so_reuseport = has_so_reuseport;
   s->expand_wildcard_addrs = false;
+  s->per_core_listeners = false;
   for (size_t i = 0; i < (args == NULL ? 0 : args->num_args); i++) {
     if (0 == strcmp(GRPC_ARG_ALLOW_REUSEPORT, args->args[i].key)) {
       if (args->args[i].type == GRPC_ARG_INTEGER) {
@@ -87,6 +90,14 @@ grpc_error *grpc_tcp_server_create(grpc_exec_ctx *exec_ctx,
         return GRPC_ERROR_CREATE_FROM_STATIC_STRING(GRPC_ARG_ALLOW_REUSEPORT
                                                     " must be an integer");
       }
+    } else if (0 == strcmp(GRPC_ARG_PER_CORE_LISTENERS, args->args[i].key)) {
+      if (args->args[i].type == GRPC_ARG_INTEGER) {
+        s->per_core_listeners = (args->args[i].value.integer != 0);
+      } else {
+        gpr_free(s);
+        return GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+            GRPC_ARG_PER_CORE_LISTENERS " must be an integer");
+      }
     } else if (0 == strcmp(GRPC_ARG_EXPAND_WILDCARD_ADDRS, args->args[i].key)) {
       if (args->args[i].type == GRPC_ARG_INTEGER) {
         s->expand_wildcard_addrs = (args->args[i].value.integer != 0);
@@ -187,6 +198,7 @@ static void tcp_server_destroy(grpc_exec_ctx *exec_ctx, grpc_tcp_server *s) {
     for (sp = s->head; sp; sp = sp->next) {
       grpc_fd_shutdown(exec_ctx, sp->emfd, GRPC_ERROR_CREATE_FROM_STATIC_STRING(
                                                "Server destroyed"));
+      if (grpc_uring_enabled()) grpc_uring_cancel(exec_ctx, &sp->accept_op);
     }
     gpr_mu_unlock(&s->mu);
   } else {
@@ -195,6 +207,62 @@ static void tcp_server_destroy(grpc_exec_ctx *exec_ctx, grpc_tcp_server *s) {
   }
 }
 
+static grpc_pollset *next_read_notifier_pollset(grpc_tcp_listener *sp) {
+  if (sp->pollset != NULL) {
+    return sp->pollset;
+  }
+  return sp->server->pollsets[(size_t)gpr_atm_no_barrier_fetch_add(
+                                  &sp->server->next_pollset_to_assign, 1) %
+                              sp->server->pollset_count];
+}
+
+/* Hand fd, a connection accepted on sp from addr, to the server */
+static void on_accepted(grpc_exec_ctx *exec_ctx, grpc_tcp_listener *sp,
+                        grpc_pollset *read_notifier_pollset, int fd,
+                        const grpc_resolved_address *addr) {
+  char *addr_str;
+  char *name;
+
+  grpc_set_socket_no_sigpipe_if_possible(fd);
+
+  addr_str = grpc_sockaddr_to_uri(addr);
+  gpr_asprintf(&name, "tcp-server-connection:%s", addr_str);
+
+  if (GRPC_TRACER_ON(grpc_tcp_trace)) {
+    gpr_log(GPR_DEBUG, "SERVER_CONNECT: incoming connection: %s", addr_str);
+  }
+
+  grpc_fd *fdobj = grpc_fd_create(fd, name);
+
+  grpc_pollset_add_fd(exec_ctx, read_notifier_pollset, fdobj);
+
+  // Create acceptor.
+  grpc_tcp_server_acceptor *acceptor =
+      (grpc_tcp_server_acceptor *)gpr_malloc(sizeof(*acceptor));
+  acceptor->from_server = sp->server;
+  acceptor->port_index = sp->port_index;
+  acceptor->fd_index = sp->fd_index;
+
+  sp->server->on_accept_cb(
+      exec_ctx, sp->server->on_accept_cb_arg,
+      grpc_tcp_create(exec_ctx, fdobj, sp->server->channel_args, addr_str),
+      read_notifier_pollset, acceptor);
+
+  gpr_free(name);
+  gpr_free(addr_str);
+}
+
+/* called when sp stops accepting connections */
+static void listener_done(grpc_exec_ctx *exec_ctx, grpc_tcp_listener *sp) {
+  gpr_mu_lock(&sp->server->mu);
+  if (0 == --sp->server->active_ports && sp->server->shutdown) {
+    gpr_mu_unlock(&sp->server->mu);
+    deactivated_all_ports(exec_ctx, sp->server);
+  } else {
+    gpr_mu_unlock(&sp->server->mu);
+  }
+}
+
 /* event manager callback when reads are ready */
 static void on_read(grpc_exec_ctx *exec_ctx, void *arg, grpc_error *err) {
   grpc_tcp_listener *sp = (grpc_tcp_listener *)arg;
@@ -203,16 +271,11 @@ static void on_read(grpc_exec_ctx *exec_ctx, void *arg, grpc_error *err) {
     goto error;
   }
 
-  read_notifier_pollset =
-      sp->server->pollsets[(size_t)gpr_atm_no_barrier_fetch_add(
-                               &sp->server->next_pollset_to_assign, 1) %
-                           sp->server->pollset_count];
+  read_notifier_pollset = next_read_notifier_pollset(sp);
 
   /* loop until accept4 returns EAGAIN, and then re-arm notification */
   for (;;) {
     grpc_resolved_address addr;
-    char *addr_str;
-    char *name;
     addr.len = sizeof(struct sockaddr_storage);
     /* Note: If we ever decide to return this address to the user, remember to
        strip off the ::ffff:0.0.0.0/96 prefix first. */
@@ -237,44 +300,86 @@ static void on_read(grpc_exec_ctx *exec_ctx, void *arg, grpc_error *err) {
       }
     }
 
-    grpc_set_socket_no_sigpipe_if_possible(fd);
-
-    addr_str = grpc_sockaddr_to_uri(&addr);
-    gpr_asprintf(&name, "tcp-server-connection:%s", addr_str);
-
-    if (GRPC_TRACER_ON(grpc_tcp_trace)) {
-      gpr_log(GPR_DEBUG, "SERVER_CONNECT: incoming connection: %s", addr_str);
-    }
-
-    grpc_fd *fdobj = grpc_fd_create(fd, name);
+    on_accepted(exec_ctx, sp, read_notifier_pollset, fd, &addr);
+  }
 
-    grpc_pollset_add_fd(exec_ctx, read_notifier_pollset, fdobj);
+  GPR_UNREACHABLE_CODE(return );
 
-    // Create acceptor.
-    grpc_tcp_server_acceptor *acceptor =
-        (grpc_tcp_server_acceptor *)gpr_malloc(sizeof(*acceptor));
-    acceptor->from_server = sp->server;
-    acceptor->port_index = sp->port_index;
-    acceptor->fd_index = sp->fd_index;
+error:
+  listener_done(exec_ctx, sp);
+}
 
-    sp->server->on_accept_cb(
-        exec_ctx, sp->server->on_accept_cb_arg,
-        grpc_tcp_create(exec_ctx, fdobj, sp->server->channel_args, addr_str),
-        read_notifier_pollset, acceptor);
+/* Queue an accept of the next connection on sp to the uring engine. The
+   server mutex must be held: shutting the listeners down cancels the accept
+   under it */
+static void start_uring_accept_locked(grpc_exec_ctx *exec_ctx,
+                                      grpc_tcp_listener *sp) {
+  sp->accept_addr_len = sizeof(struct sockaddr_storage);
+  grpc_uring_accept(exec_ctx, &sp->accept_op, sp->fd,
+                    (struct sockaddr *)sp->accept_addr.addr,
+                    &sp->accept_addr_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+}
 
-    gpr_free(name);
-    gpr_free(addr_str);
+/* uring engine callback when an accept completes */
+static void on_uring_accept(grpc_exec_ctx *exec_ctx, void *arg,
+                            grpc_error *error_ignored) {
+  grpc_tcp_listener *sp = (grpc_tcp_listener *)arg;
+  int res = sp->accept_op.res;
+  if (res >= 0) {
+    gpr_mu_lock(&sp->server->mu);
+    bool listening = !sp->server->shutdown && !sp->server->shutdown_listeners;
+    gpr_mu_unlock(&sp->server->mu);
+    if (listening) {
+      /* Note: If we ever decide to return this address to the user, remember
+         to strip off the ::ffff:0.0.0.0/96 prefix first. */
+      sp->accept_addr.len = sp->accept_addr_len;
+      on_accepted(exec_ctx, sp, next_read_notifier_pollset(sp), res,
+                  &sp->accept_addr);
+    } else {
+      /* the accept completed just before the cancellation reached it */
+      close(res);
+    }
   }
 
-  GPR_UNREACHABLE_CODE(return );
-
-error:
   gpr_mu_lock(&sp->server->mu);
-  if (0 == --sp->server->active_ports && sp->server->shutdown) {
+  if (sp->server->shutdown || sp->server->shutdown_listeners) {
+    /* accepts fail once the listeners shut down, and we needn't notify users */
     gpr_mu_unlock(&sp->server->mu);
-    deactivated_all_ports(exec_ctx, sp->server);
+    listener_done(exec_ctx, sp);
+    return;
+  }
+  switch (-res) {
+    case EAGAIN:
+      /* older kernels fail accepts on non-blocking sockets rather than
+         waiting: accept on read readiness from here on */
+      grpc_fd_notify_on_read(exec_ctx, sp->emfd, &sp->read_closure);
+      break;
+    case EBADF:
+    case EINVAL:
+    case ECANCELED:
+      gpr_log(GPR_ERROR, "Failed accept: %s", strerror(-res));
+      gpr_mu_unlock(&sp->server->mu);
+      listener_done(exec_ctx, sp);
+      return;
+    default:
+      /* accepted a connection, or failed to accept one */
+      start_uring_accept_locked(exec_ctx, sp);
+      break;
+  }
+  gpr_mu_unlock(&sp->server->mu);
+}
+
+/* Start accepting connections on sp. The server mutex must be held */
+static void start_accepting_locked(grpc_exec_ctx *exec_ctx,
+                                   grpc_tcp_listener *sp) {
+  GRPC_CLOSURE_INIT(&sp->read_closure, on_read, sp, grpc_schedule_on_exec_ctx);
+  if (grpc_uring_enabled()) {
+    GRPC_CLOSURE_INIT(&sp->accept_closure, on_uring_accept, sp,
+                      grpc_schedule_on_exec_ctx);
+    sp->accept_op.on_done = &sp->accept_closure;
+    start_uring_accept_locked(exec_ctx, sp);
   } else {
-    gpr_mu_unlock(&sp->server->mu);
+    grpc_fd_notify_on_read(exec_ctx, sp->emfd, &sp->read_closure);
   }
 }
 
@@ -381,6 +486,7 @@ static grpc_error *clone_port(grpc_tcp_listener *listener, unsigned count) {
     sp->port = port;
     sp->port_index = listener->port_index;
     sp->fd_index = listener->fd_index + count - i;
+    sp->pollset = NULL;
     GPR_ASSERT(sp->emfd);
     while (listener->server->tail->next != NULL) {
       listener->server->tail = listener->server->tail->next;
@@ -392,6 +498,34 @@ static grpc_error *clone_port(grpc_tcp_listener *listener, unsigned count) {
   return GRPC_ERROR_NONE;
 }
 
+/* Per-core mode for the listener group of \a listener, just expanded by
+   clone_port into \a count sockets: the i-th socket to start listening (the
+   original listener, then clone i - 1) gets connections processed on CPUs
+   i, i + count, ..., and binds them to pollsets[i], so that they are polled
+   on the CPU that receives their packets. */
+static void steer_port_to_cpus(grpc_tcp_listener *listener,
+                               grpc_pollset **pollsets, size_t count) {
+  unsigned ncpus = gpr_cpu_num_cores();
+  grpc_tcp_listener *sp = listener;
+  for (size_t pos = 0; pos < count; pos++, sp = sp->next) {
+    /* clone_port links each clone right after the original listener, so the
+       clones appear in reverse order of creation */
+    size_t i = pos == 0 ? 0 : count - pos;
+    sp->pollset = pollsets[i];
+    GRPC_LOG_IF_ERROR("per_core_listeners",
+                      grpc_set_socket_incoming_cpu(sp->fd, (int)(i % ncpus)));
+  }
+  /* Without the BPF program the kernel still prefers the listener whose
+     SO_INCOMING_CPU matches, but falls back to hashing otherwise */
+  grpc_error *err =
+      grpc_set_socket_reuseport_cpu_steering(listener->fd, (unsigned)count);
+  if (err != GRPC_ERROR_NONE) {
+    const char *msg = grpc_error_string(err);
+    gpr_log(GPR_INFO, "per_core_listeners: %s", msg);
+    GRPC_ERROR_UNREF(err);
+  }
+}
+
 grpc_error *grpc_tcp_server_add_port(grpc_tcp_server *s,
                                      const grpc_resolved_address *addr,
                                      int *out_port) {
@@ -502,11 +636,14 @@ void grpc_tcp_server_start(grpc_exec_ctx *exec_ctx, grpc_tcp_server *s,
         pollset_count > 1) {
       GPR_ASSERT(GRPC_LOG_IF_ERROR(
           "clone_port", clone_port(sp, (unsigned)(pollset_count - 1))));
+      if (s->per_core_listeners) {
+        steer_port_to_cpus(sp, pollsets, pollset_count);
+      }
       for (i = 0; i < pollset_count; i++) {
-        grpc_pollset_add_fd(exec_ctx, pollsets[i], sp->emfd);
-        GRPC_CLOSURE_INIT(&sp->read_closure, on_read, sp,
-                          grpc_schedule_on_exec_ctx);
-        grpc_fd_notify_on_read(exec_ctx, sp->emfd, &sp->read_closure);
+        grpc_pollset_add_fd(exec_ctx,
+                            sp->pollset != NULL ? sp->pollset : pollsets[i],
+                            sp->emfd);
+        start_accepting_locked(exec_ctx, sp);
         s->active_ports++;
         sp = sp->next;
       }
@@ -514,9 +651,7 @@ void grpc_tcp_server_start(grpc_exec_ctx *exec_ctx, grpc_tcp_server *s,
       for (i = 0; i < pollset_count; i++) {
         grpc_pollset_add_fd(exec_ctx, pollsets[i], sp->emfd);
       }
-      GRPC_CLOSURE_INIT(&sp->read_closure, on_read, sp,
-                        grpc_schedule_on_exec_ctx);
-      grpc_fd_notify_on_read(exec_ctx, sp->emfd, &sp->read_closure);
+      start_accepting_locked(exec_ctx, sp);
       s->active_ports++;
       sp = sp->next;
     }
@@ -557,6 +692,7 @@ void grpc_tcp_server_shutdown_listeners(grpc_exec_ctx *exec_ctx,
     for (sp = s->head; sp; sp = sp->next) {
       grpc_fd_shutdown(exec_ctx, sp->emfd,
                        GRPC_ERROR_CREATE_FROM_STATIC_STRING("Server shutdown"));
+      if (grpc_uring_enabled()) grpc_uring_cancel(exec_ctx, &sp->accept_op);
     }
   }
   gpr_mu_unlock(&s->mu);
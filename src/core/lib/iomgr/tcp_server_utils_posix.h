@@ -20,6 +20,7 @@
 #define GRPC_CORE_LIB_IOMGR_TCP_SERVER_UTILS_POSIX_H
 
 #include "src/core/lib/iomgr/ev_posix.h"
+#include "src/core/lib/iomgr/ev_uring_linux.h"
 #include "src/core/lib/iomgr/resolve_address.h"
 #include "src/core/lib/iomgr/socket_utils_posix.h"
 #include "src/core/lib/iomgr/tcp_server.h"
@@ -35,6 +36,12 @@ typedef struct grpc_tcp_listener {
   unsigned fd_index;
   grpc_closure read_closure;
   grpc_closure destroyed_closure;
+  /* with the uring engine, connections are accepted by accept_op instead of
+     on read readiness; accept_addr receives the peer address */
+  grpc_uring_op accept_op;
+  grpc_closure accept_closure;
+  grpc_resolved_address accept_addr;
+  socklen_t accept_addr_len;
   struct grpc_tcp_listener *next;
   /* sibling is a linked list of all listeners for a given port. add_port and
      clone_port place all new listeners in the same sibling list. A member of
@@ -44,6 +51,9 @@ typedef struct grpc_tcp_listener {
      identified while iterating through 'next'. */
   struct grpc_tcp_listener *sibling;
   int is_sibling;
+  /* in per-core mode, the only pollset connections accepted on this listener
+     are bound to; NULL to spread them across all of the server's pollsets */
+  grpc_pollset *pollset;
 } grpc_tcp_listener;
 
 /* the overall server */
@@ -68,6 +78,8 @@ struct grpc_tcp_server {
   bool so_reuseport;
   /* expand wildcard addresses to a list of all local addresses */
   bool expand_wildcard_addrs;
+  /* give each pollset its own CPU-steered SO_REUSEPORT listener */
+  bool per_core_listeners;
 
   /* linked list of server ports */
   grpc_tcp_listener *head;
@@ -0,0 +1,639 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/lib/iomgr/port.h"
+
+#ifdef GRPC_LINUX_IO_URING
+
+#include "src/core/lib/iomgr/tcp_uring_linux.h"
+
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#include <grpc/slice.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/string_util.h>
+#include <grpc/support/sync.h>
+#include <grpc/support/useful.h>
+
+#include "src/core/lib/debug/stats.h"
+#include "src/core/lib/iomgr/ev_uring_linux.h"
+#include "src/core/lib/iomgr/network_status_tracker.h"
+#include "src/core/lib/iomgr/tcp_posix.h"
+#include "src/core/lib/profiling/timers.h"
+#include "src/core/lib/slice/slice_internal.h"
+#include "src/core/lib/slice/slice_string_helpers.h"
+
+#ifdef GRPC_HAVE_MSG_NOSIGNAL
+#define SENDMSG_FLAGS MSG_NOSIGNAL
+#else
+#define SENDMSG_FLAGS 0
+#endif
+
+#ifdef GRPC_MSG_IOVLEN_TYPE
+typedef GRPC_MSG_IOVLEN_TYPE msg_iovlen_type;
+#else
+typedef size_t msg_iovlen_type;
+#endif
+
+#define MAX_READ_IOVEC 4
+/* The iovecs of a write live in the endpoint until the write completes, so
+   there are fewer of them than tcp_posix.c puts on its stack; longer buffers
+   take several writes */
+#define MAX_WRITE_IOVEC 256
+
+typedef struct {
+  grpc_endpoint base;
+  grpc_fd *em_fd;
+  int fd;
+  double target_length;
+  gpr_refcount refcount;
+
+  int min_read_chunk_size;
+  int max_read_chunk_size;
+
+  /* garbage after the last read */
+  grpc_slice_buffer last_read_buffer;
+
+  grpc_slice_buffer *incoming_buffer;
+  grpc_slice_buffer *outgoing_buffer;
+  /** slice within outgoing_buffer to write next */
+  size_t outgoing_slice_idx;
+  /** byte within outgoing_buffer->slices[outgoing_slice_idx] to write next */
+  size_t outgoing_byte_idx;
+
+  grpc_closure *read_cb;
+  grpc_closure *write_cb;
+  grpc_closure *release_fd_cb;
+  int *release_fd;
+
+  /* the ring operations, and the message headers the kernel works from until
+     they complete */
+  grpc_uring_op read_op;
+  struct msghdr read_msg;
+  struct iovec read_iov[MAX_READ_IOVEC];
+  grpc_uring_op write_op;
+  struct msghdr write_msg;
+  struct iovec write_iov[MAX_WRITE_IOVEC];
+
+  grpc_closure read_done_closure;
+  grpc_closure write_done_closure;
+  /* older kernels fail operations on non-blocking sockets with -EAGAIN rather
+     than waiting; these retry them once the fd polls ready */
+  grpc_closure read_retry_closure;
+  grpc_closure write_retry_closure;
+
+  /** guards the fields below, which tcp_shutdown may access concurrently */
+  gpr_mu mu;
+  bool shutdown;
+  grpc_error *shutdown_error;
+  bool read_in_flight;
+  bool write_in_flight;
+
+  char *peer_string;
+
+  grpc_resource_user *resource_user;
+  grpc_resource_user_slice_allocator slice_allocator;
+} grpc_tcp;
+
+static grpc_error *tcp_annotate_error(grpc_error *src_error, grpc_tcp *tcp) {
+  return grpc_error_set_str(
+      grpc_error_set_int(src_error, GRPC_ERROR_INT_FD, tcp->fd),
+      GRPC_ERROR_STR_TARGET_ADDRESS,
+      grpc_slice_from_copied_string(tcp->peer_string));
+}
+
+static void tcp_free(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp) {
+  grpc_fd_orphan(exec_ctx, tcp->em_fd, tcp->release_fd_cb, tcp->release_fd,
+                 false /* already_closed */, "tcp_unref_orphan");
+  grpc_slice_buffer_destroy_internal(exec_ctx, &tcp->last_read_buffer);
+  grpc_resource_user_unref(exec_ctx, tcp->resource_user);
+  GRPC_ERROR_UNREF(tcp->shutdown_error);
+  gpr_mu_destroy(&tcp->mu);
+  gpr_free(tcp->peer_string);
+  gpr_free(tcp);
+}
+
+#ifndef NDEBUG
+#define TCP_UNREF(cl, tcp, reason) \
+  tcp_unref((cl), (tcp), (reason), __FILE__, __LINE__)
+#define TCP_REF(tcp, reason) tcp_ref((tcp), (reason), __FILE__, __LINE__)
+static void tcp_unref(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp,
+                      const char *reason, const char *file, int line) {
+  if (GRPC_TRACER_ON(grpc_tcp_trace)) {
+    gpr_atm val = gpr_atm_no_barrier_load(&tcp->refcount.count);
+    gpr_log(file, line, GPR_LOG_SEVERITY_DEBUG,
+            "TCP unref %p : %s %" PRIdPTR " -> %" PRIdPTR, tcp, reason, val,
+            val - 1);
+  }
+  if (gpr_unref(&tcp->refcount)) {
+    tcp_free(exec_ctx, tcp);
+  }
+}
+
+static void tcp_ref(grpc_tcp *tcp, const char *reason, const char *file,
+                    int line) {
+  if (GRPC_TRACER_ON(grpc_tcp_trace)) {
+    gpr_atm val = gpr_atm_no_barrier_load(&tcp->refcount.count);
+    gpr_log(file, line, GPR_LOG_SEVERITY_DEBUG,
+            "TCP   ref %p : %s %" PRIdPTR " -> %" PRIdPTR, tcp, reason, val,
+            val + 1);
+  }
+  gpr_ref(&tcp->refcount);
+}
+#else
+#define TCP_UNREF(cl, tcp, reason) tcp_unref((cl), (tcp))
+#define TCP_REF(tcp, reason) tcp_ref((tcp))
+static void tcp_unref(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp) {
+  if (gpr_unref(&tcp->refcount)) {
+    tcp_free(exec_ctx, tcp);
+  }
+}
+
+static void tcp_ref(grpc_tcp *tcp) { gpr_ref(&tcp->refcount); }
+#endif
+
+/* Hand op to the ring with start, or, once the endpoint is shut down, complete
+   it right away as if it had been cancelled */
+#define TCP_START_OP(exec_ctx, tcp, op, in_flight, start)            \
+  do {                                                               \
+    gpr_mu_lock(&(tcp)->mu);                                         \
+    if ((tcp)->shutdown) {                                           \
+      (op)->res = -ECANCELED;                                        \
+      GRPC_CLOSURE_SCHED((exec_ctx), (op)->on_done, GRPC_ERROR_NONE); \
+    } else {                                                         \
+      (in_flight) = true;                                            \
+      start;                                                         \
+    }                                                                \
+    gpr_mu_unlock(&(tcp)->mu);                                       \
+  } while (false)
+
+/* Note that an op is no longer in flight, and return the shutdown error to
+   fail it with if it made no progress (it was cancelled, or never started)
+   because the endpoint is shut down */
+static grpc_error *tcp_finish_op(grpc_tcp *tcp, bool *in_flight) {
+  grpc_error *error = GRPC_ERROR_NONE;
+  gpr_mu_lock(&tcp->mu);
+  *in_flight = false;
+  if (tcp->shutdown) {
+    error = GRPC_ERROR_REF(tcp->shutdown_error);
+  }
+  gpr_mu_unlock(&tcp->mu);
+  return error;
+}
+
+static void tcp_shutdown(grpc_exec_ctx *exec_ctx, grpc_endpoint *ep,
+                         grpc_error *why) {
+  grpc_tcp *tcp = (grpc_tcp *)ep;
+  gpr_mu_lock(&tcp->mu);
+  if (!tcp->shutdown) {
+    tcp->shutdown = true;
+    tcp->shutdown_error = tcp_annotate_error(
+        GRPC_ERROR_CREATE_REFERENCING_FROM_STATIC_STRING("Endpoint shutdown",
+                                                         &why, 1),
+        tcp);
+    if (tcp->read_in_flight) grpc_uring_cancel(exec_ctx, &tcp->read_op);
+    if (tcp->write_in_flight) grpc_uring_cancel(exec_ctx, &tcp->write_op);
+  }
+  gpr_mu_unlock(&tcp->mu);
+  grpc_fd_shutdown(exec_ctx, tcp->em_fd, why);
+  grpc_resource_user_shutdown(exec_ctx, tcp->resource_user);
+}
+
+static void tcp_destroy(grpc_exec_ctx *exec_ctx, grpc_endpoint *ep) {
+  grpc_network_status_unregister_endpoint(ep);
+  grpc_tcp *tcp = (grpc_tcp *)ep;
+  grpc_slice_buffer_reset_and_unref_internal(exec_ctx, &tcp->last_read_buffer);
+  TCP_UNREF(exec_ctx, tcp, "destroy");
+}
+
+static void update_estimate(grpc_tcp *tcp, size_t bytes) {
+  /* If a read fills >80% of the target buffer, increase the size of the
+     target buffer to either the amount read, or twice its previous value */
+  if ((double)bytes > tcp->target_length * 0.8) {
+    tcp->target_length = GPR_MAX(2 * tcp->target_length, (double)bytes);
+  } else {
+    tcp->target_length = 0.99 * tcp->target_length + 0.01 * (double)bytes;
+  }
+}
+
+static size_t get_target_read_size(grpc_tcp *tcp) {
+  grpc_resource_quota *rq = grpc_resource_user_quota(tcp->resource_user);
+  double pressure = grpc_resource_quota_get_memory_pressure(rq);
+  double target =
+      tcp->target_length * (pressure > 0.8 ? (1.0 - pressure) / 0.2 : 1.0);
+  size_t sz = (((size_t)GPR_CLAMP(target, tcp->min_read_chunk_size,
+                                  tcp->max_read_chunk_size)) +
+               255) &
+              ~(size_t)255;
+  /* don't use more than 1/16th of the overall resource quota for a single read
+   * alloc */
+  size_t rqmax = grpc_resource_quota_peek_size(rq);
+  if (sz > rqmax / 16 && rqmax > 1024) {
+    sz = rqmax / 16;
+  }
+  return sz;
+}
+
+static void call_read_cb(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp,
+                         grpc_error *error) {
+  grpc_closure *cb = tcp->read_cb;
+
+  if (GRPC_TRACER_ON(grpc_tcp_trace)) {
+    gpr_log(GPR_DEBUG, "TCP:%p call_cb %p %p:%p", tcp, cb, cb->cb, cb->cb_arg);
+    size_t i;
+    const char *str = grpc_error_string(error);
+    gpr_log(GPR_DEBUG, "read: error=%s", str);
+
+    for (i = 0; i < tcp->incoming_buffer->count; i++) {
+      char *dump = grpc_dump_slice(tcp->incoming_buffer->slices[i],
+                                   GPR_DUMP_HEX | GPR_DUMP_ASCII);
+      gpr_log(GPR_DEBUG, "READ %p (peer=%s): %s", tcp, tcp->peer_string, dump);
+      gpr_free(dump);
+    }
+  }
+
+  tcp->read_cb = NULL;
+  tcp->incoming_buffer = NULL;
+  GRPC_CLOSURE_RUN(exec_ctx, cb, error);
+}
+
+static void tcp_fail_read(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp,
+                          grpc_error *error) {
+  grpc_slice_buffer_reset_and_unref_internal(exec_ctx, tcp->incoming_buffer);
+  grpc_slice_buffer_reset_and_unref_internal(exec_ctx, &tcp->last_read_buffer);
+  call_read_cb(exec_ctx, tcp, error);
+  TCP_UNREF(exec_ctx, tcp, "read");
+}
+
+static void tcp_start_read(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp) {
+  GPR_ASSERT(tcp->incoming_buffer->count <= MAX_READ_IOVEC);
+  for (size_t i = 0; i < tcp->incoming_buffer->count; i++) {
+    tcp->read_iov[i].iov_base =
+        GRPC_SLICE_START_PTR(tcp->incoming_buffer->slices[i]);
+    tcp->read_iov[i].iov_len =
+        GRPC_SLICE_LENGTH(tcp->incoming_buffer->slices[i]);
+  }
+  memset(&tcp->read_msg, 0, sizeof(tcp->read_msg));
+  tcp->read_msg.msg_iov = tcp->read_iov;
+  tcp->read_msg.msg_iovlen = (msg_iovlen_type)tcp->incoming_buffer->count;
+
+  GRPC_STATS_INC_TCP_READ_OFFER(exec_ctx, tcp->incoming_buffer->length);
+  GRPC_STATS_INC_TCP_READ_OFFER_IOV_SIZE(exec_ctx, tcp->incoming_buffer->count);
+
+  TCP_START_OP(exec_ctx, tcp, &tcp->read_op, tcp->read_in_flight,
+               grpc_uring_recvmsg(exec_ctx, &tcp->read_op, tcp->fd,
+                                  &tcp->read_msg, 0));
+}
+
+static void tcp_handle_read(grpc_exec_ctx *exec_ctx, void *arg /* grpc_tcp */,
+                            grpc_error *error_ignored) {
+  grpc_tcp *tcp = (grpc_tcp *)arg;
+  int32_t res = tcp->read_op.res;
+  grpc_error *shutdown_error = tcp_finish_op(tcp, &tcp->read_in_flight);
+  if (GRPC_TRACER_ON(grpc_tcp_trace)) {
+    gpr_log(GPR_DEBUG, "TCP:%p got_read: %d", tcp, res);
+  }
+
+  if (shutdown_error != GRPC_ERROR_NONE && res <= 0) {
+    tcp_fail_read(exec_ctx, tcp, shutdown_error);
+    return;
+  }
+  GRPC_ERROR_UNREF(shutdown_error);
+
+  if (res == -EINTR) {
+    tcp_start_read(exec_ctx, tcp);
+  } else if (res == -EAGAIN) {
+    grpc_fd_notify_on_read(exec_ctx, tcp->em_fd, &tcp->read_retry_closure);
+  } else if (res < 0) {
+    tcp_fail_read(exec_ctx, tcp,
+                  tcp_annotate_error(GRPC_OS_ERROR(-res, "recvmsg"), tcp));
+  } else if (res == 0) {
+    /* 0 read size ==> end of stream */
+    tcp_fail_read(
+        exec_ctx, tcp,
+        tcp_annotate_error(
+            GRPC_ERROR_CREATE_FROM_STATIC_STRING("Socket closed"), tcp));
+  } else {
+    size_t read_bytes = (size_t)res;
+    GRPC_STATS_INC_TCP_READ_SIZE(exec_ctx, read_bytes);
+    update_estimate(tcp, read_bytes);
+    GPR_ASSERT(read_bytes <= tcp->incoming_buffer->length);
+    if (read_bytes < tcp->incoming_buffer->length) {
+      grpc_slice_buffer_trim_end(tcp->incoming_buffer,
+                                 tcp->incoming_buffer->length - read_bytes,
+                                 &tcp->last_read_buffer);
+    }
+    call_read_cb(exec_ctx, tcp, GRPC_ERROR_NONE);
+    TCP_UNREF(exec_ctx, tcp, "read");
+  }
+}
+
+/* A shutdown fd fails the retry; starting the read again then completes it
+   with the shutdown error */
+static void tcp_retry_read(grpc_exec_ctx *exec_ctx, void *arg /* grpc_tcp */,
+                           grpc_error *error_ignored) {
+  tcp_start_read(exec_ctx, (grpc_tcp *)arg);
+}
+
+static void tcp_read_allocation_done(grpc_exec_ctx *exec_ctx, void *tcpp,
+                                     grpc_error *error) {
+  grpc_tcp *tcp = (grpc_tcp *)tcpp;
+  if (GRPC_TRACER_ON(grpc_tcp_trace)) {
+    gpr_log(GPR_DEBUG, "TCP:%p read_allocation_done: %s", tcp,
+            grpc_error_string(error));
+  }
+  if (error != GRPC_ERROR_NONE) {
+    tcp_fail_read(exec_ctx, tcp, GRPC_ERROR_REF(error));
+  } else {
+    tcp_start_read(exec_ctx, tcp);
+  }
+}
+
+static void tcp_read(grpc_exec_ctx *exec_ctx, grpc_endpoint *ep,
+                     grpc_slice_buffer *incoming_buffer, grpc_closure *cb) {
+  grpc_tcp *tcp = (grpc_tcp *)ep;
+  GPR_ASSERT(tcp->read_cb == NULL);
+  tcp->read_cb = cb;
+  tcp->incoming_buffer = incoming_buffer;
+  grpc_slice_buffer_reset_and_unref_internal(exec_ctx, incoming_buffer);
+  grpc_slice_buffer_swap(incoming_buffer, &tcp->last_read_buffer);
+  TCP_REF(tcp, "read");
+  size_t target_read_size = get_target_read_size(tcp);
+  if (tcp->incoming_buffer->length < target_read_size &&
+      tcp->incoming_buffer->count < MAX_READ_IOVEC) {
+    grpc_resource_user_alloc_slices(exec_ctx, &tcp->slice_allocator,
+                                    target_read_size, 1, tcp->incoming_buffer);
+  } else {
+    tcp_start_read(exec_ctx, tcp);
+  }
+}
+
+static void tcp_start_write(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp) {
+  size_t sending_length = 0;
+  size_t slice_idx = tcp->outgoing_slice_idx;
+  size_t byte_idx = tcp->outgoing_byte_idx;
+  msg_iovlen_type iov_size;
+  for (iov_size = 0; slice_idx != tcp->outgoing_buffer->count &&
+                     iov_size != MAX_WRITE_IOVEC;
+       iov_size++) {
+    /* not a copy of the slice: the kernel reads inlined bytes from the buffer
+       after this returns */
+    grpc_slice *slice = &tcp->outgoing_buffer->slices[slice_idx];
+    tcp->write_iov[iov_size].iov_base = GRPC_SLICE_START_PTR(*slice) + byte_idx;
+    tcp->write_iov[iov_size].iov_len = GRPC_SLICE_LENGTH(*slice) - byte_idx;
+    sending_length += tcp->write_iov[iov_size].iov_len;
+    slice_idx++;
+    byte_idx = 0;
+  }
+  GPR_ASSERT(iov_size > 0);
+  memset(&tcp->write_msg, 0, sizeof(tcp->write_msg));
+  tcp->write_msg.msg_iov = tcp->write_iov;
+  tcp->write_msg.msg_iovlen = iov_size;
+
+  GRPC_STATS_INC_TCP_WRITE_SIZE(exec_ctx, sending_length);
+  GRPC_STATS_INC_TCP_WRITE_IOV_SIZE(exec_ctx, iov_size);
+
+  TCP_START_OP(exec_ctx, tcp, &tcp->write_op, tcp->write_in_flight,
+               grpc_uring_sendmsg(exec_ctx, &tcp->write_op, tcp->fd,
+                                  &tcp->write_msg, SENDMSG_FLAGS));
+}
+
+static void tcp_finish_write(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp,
+                             grpc_error *error) {
+  grpc_closure *cb = tcp->write_cb;
+  tcp->write_cb = NULL;
+  if (GRPC_TRACER_ON(grpc_tcp_trace)) {
+    const char *str = grpc_error_string(error);
+    gpr_log(GPR_DEBUG, "write: %s", str);
+  }
+  GRPC_CLOSURE_RUN(exec_ctx, cb, error);
+  TCP_UNREF(exec_ctx, tcp, "write");
+}
+
+static void tcp_handle_write(grpc_exec_ctx *exec_ctx, void *arg /* grpc_tcp */,
+                             grpc_error *error_ignored) {
+  grpc_tcp *tcp = (grpc_tcp *)arg;
+  int32_t res = tcp->write_op.res;
+  grpc_error *shutdown_error = tcp_finish_op(tcp, &tcp->write_in_flight);
+
+  if (shutdown_error != GRPC_ERROR_NONE && res <= 0) {
+    tcp_finish_write(exec_ctx, tcp, shutdown_error);
+    return;
+  }
+
+  if (res == -EINTR) {
+    GRPC_ERROR_UNREF(shutdown_error);
+    tcp_start_write(exec_ctx, tcp);
+    return;
+  } else if (res == -EAGAIN) {
+    GRPC_ERROR_UNREF(shutdown_error);
+    grpc_fd_notify_on_write(exec_ctx, tcp->em_fd, &tcp->write_retry_closure);
+    return;
+  } else if (res == -EPIPE) {
+    GRPC_ERROR_UNREF(shutdown_error);
+    tcp_finish_write(exec_ctx, tcp,
+                     grpc_error_set_int(GRPC_OS_ERROR(EPIPE, "sendmsg"),
+                                        GRPC_ERROR_INT_GRPC_STATUS,
+                                        GRPC_STATUS_UNAVAILABLE));
+    return;
+  } else if (res < 0) {
+    GRPC_ERROR_UNREF(shutdown_error);
+    tcp_finish_write(exec_ctx, tcp, tcp_annotate_error(
+                                        GRPC_OS_ERROR(-res, "sendmsg"), tcp));
+    return;
+  }
+
+  /* skip past what was sent */
+  size_t sent = (size_t)res;
+  while (sent > 0) {
+    size_t left =
+        GRPC_SLICE_LENGTH(
+            tcp->outgoing_buffer->slices[tcp->outgoing_slice_idx]) -
+        tcp->outgoing_byte_idx;
+    if (sent < left) {
+      tcp->outgoing_byte_idx += sent;
+      break;
+    }
+    sent -= left;
+    tcp->outgoing_slice_idx++;
+    tcp->outgoing_byte_idx = 0;
+  }
+
+  if (tcp->outgoing_slice_idx == tcp->outgoing_buffer->count) {
+    GRPC_ERROR_UNREF(shutdown_error);
+    tcp_finish_write(exec_ctx, tcp, GRPC_ERROR_NONE);
+  } else if (shutdown_error != GRPC_ERROR_NONE) {
+    tcp_finish_write(exec_ctx, tcp, shutdown_error);
+  } else {
+    if (GRPC_TRACER_ON(grpc_tcp_trace)) {
+      gpr_log(GPR_DEBUG, "write: partial");
+    }
+    tcp_start_write(exec_ctx, tcp);
+  }
+}
+
+static void tcp_retry_write(grpc_exec_ctx *exec_ctx, void *arg /* grpc_tcp */,
+                            grpc_error *error_ignored) {
+  tcp_start_write(exec_ctx, (grpc_tcp *)arg);
+}
+
+static void tcp_write(grpc_exec_ctx *exec_ctx, grpc_endpoint *ep,
+                      grpc_slice_buffer *buf, grpc_closure *cb) {
+  grpc_tcp *tcp = (grpc_tcp *)ep;
+
+  if (GRPC_TRACER_ON(grpc_tcp_trace)) {
+    size_t i;
+
+    for (i = 0; i < buf->count; i++) {
+      char *data =
+          grpc_dump_slice(buf->slices[i], GPR_DUMP_HEX | GPR_DUMP_ASCII);
+      gpr_log(GPR_DEBUG, "WRITE %p (peer=%s): %s", tcp, tcp->peer_string, data);
+      gpr_free(data);
+    }
+  }
+
+  GPR_TIMER_BEGIN("tcp_write", 0);
+  GPR_ASSERT(tcp->write_cb == NULL);
+
+  if (buf->length == 0) {
+    GPR_TIMER_END("tcp_write", 0);
+    GRPC_CLOSURE_SCHED(
+        exec_ctx, cb,
+        grpc_fd_is_shutdown(tcp->em_fd)
+            ? tcp_annotate_error(GRPC_ERROR_CREATE_FROM_STATIC_STRING("EOF"),
+                                 tcp)
+            : GRPC_ERROR_NONE);
+    return;
+  }
+  tcp->outgoing_buffer = buf;
+  tcp->outgoing_slice_idx = 0;
+  tcp->outgoing_byte_idx = 0;
+  tcp->write_cb = cb;
+  TCP_REF(tcp, "write");
+  tcp_start_write(exec_ctx, tcp);
+
+  GPR_TIMER_END("tcp_write", 0);
+}
+
+static void tcp_add_to_pollset(grpc_exec_ctx *exec_ctx, grpc_endpoint *ep,
+                               grpc_pollset *pollset) {
+  grpc_tcp *tcp = (grpc_tcp *)ep;
+  grpc_pollset_add_fd(exec_ctx, pollset, tcp->em_fd);
+}
+
+static void tcp_add_to_pollset_set(grpc_exec_ctx *exec_ctx, grpc_endpoint *ep,
+                                   grpc_pollset_set *pollset_set) {
+  grpc_tcp *tcp = (grpc_tcp *)ep;
+  grpc_pollset_set_add_fd(exec_ctx, pollset_set, tcp->em_fd);
+}
+
+static char *tcp_get_peer(grpc_endpoint *ep) {
+  grpc_tcp *tcp = (grpc_tcp *)ep;
+  return gpr_strdup(tcp->peer_string);
+}
+
+static int tcp_get_fd(grpc_endpoint *ep) {
+  grpc_tcp *tcp = (grpc_tcp *)ep;
+  return tcp->fd;
+}
+
+static grpc_resource_user *tcp_get_resource_user(grpc_endpoint *ep) {
+  grpc_tcp *tcp = (grpc_tcp *)ep;
+  return tcp->resource_user;
+}
+
+/* Writes are not coalesced: each one goes out in the next ring batch */
+static void tcp_hint_write_more(grpc_endpoint *ep) {}
+
+static const grpc_endpoint_vtable vtable = {
+    tcp_read,     tcp_write,   tcp_add_to_pollset,    tcp_add_to_pollset_set,
+    tcp_shutdown, tcp_destroy, tcp_get_resource_user, tcp_get_peer,
+    tcp_get_fd,   tcp_hint_write_more};
+
+grpc_endpoint *grpc_tcp_uring_create(grpc_exec_ctx *exec_ctx, grpc_fd *em_fd,
+                                     grpc_resource_quota *resource_quota,
+                                     int read_chunk_size,
+                                     int min_read_chunk_size,
+                                     int max_read_chunk_size,
+                                     const char *peer_string) {
+  grpc_tcp *tcp = (grpc_tcp *)gpr_malloc(sizeof(grpc_tcp));
+  tcp->base.vtable = &vtable;
+  tcp->peer_string = gpr_strdup(peer_string);
+  tcp->fd = grpc_fd_wrapped_fd(em_fd);
+  tcp->read_cb = NULL;
+  tcp->write_cb = NULL;
+  tcp->release_fd_cb = NULL;
+  tcp->release_fd = NULL;
+  tcp->incoming_buffer = NULL;
+  tcp->outgoing_buffer = NULL;
+  tcp->target_length = (double)read_chunk_size;
+  tcp->min_read_chunk_size = min_read_chunk_size;
+  tcp->max_read_chunk_size = max_read_chunk_size;
+  /* paired with unref in grpc_tcp_destroy */
+  gpr_ref_init(&tcp->refcount, 1);
+  tcp->em_fd = em_fd;
+  /* the fd may have been polled for a connect to complete; its io goes
+     through the ring from now on */
+  grpc_uring_fd_release_poll(em_fd);
+  grpc_slice_buffer_init(&tcp->last_read_buffer);
+  GRPC_CLOSURE_INIT(&tcp->read_done_closure, tcp_handle_read, tcp,
+                    grpc_schedule_on_exec_ctx);
+  GRPC_CLOSURE_INIT(&tcp->write_done_closure, tcp_handle_write, tcp,
+                    grpc_schedule_on_exec_ctx);
+  GRPC_CLOSURE_INIT(&tcp->read_retry_closure, tcp_retry_read, tcp,
+                    grpc_schedule_on_exec_ctx);
+  GRPC_CLOSURE_INIT(&tcp->write_retry_closure, tcp_retry_write, tcp,
+                    grpc_schedule_on_exec_ctx);
+  tcp->read_op.on_done = &tcp->read_done_closure;
+  tcp->write_op.on_done = &tcp->write_done_closure;
+  gpr_mu_init(&tcp->mu);
+  tcp->shutdown = false;
+  tcp->shutdown_error = GRPC_ERROR_NONE;
+  tcp->read_in_flight = false;
+  tcp->write_in_flight = false;
+  tcp->resource_user = grpc_resource_user_create(resource_quota, peer_string);
+  grpc_resource_user_slice_allocator_init(
+      &tcp->slice_allocator, tcp->resource_user, tcp_read_allocation_done, tcp);
+  /* Tell network status tracker about new endpoint */
+  grpc_network_status_register_endpoint(&tcp->base);
+
+  return &tcp->base;
+}
+
+bool grpc_is_tcp_uring_endpoint(grpc_endpoint *ep) {
+  return ep->vtable == &vtable;
+}
+
+void grpc_tcp_uring_destroy_and_release_fd(grpc_exec_ctx *exec_ctx,
+                                           grpc_endpoint *ep, int *fd,
+                                           grpc_closure *done) {
+  grpc_network_status_unregister_endpoint(ep);
+  grpc_tcp *tcp = (grpc_tcp *)ep;
+  GPR_ASSERT(ep->vtable == &vtable);
+  tcp->release_fd = fd;
+  tcp->release_fd_cb = done;
+  grpc_slice_buffer_reset_and_unref_internal(exec_ctx, &tcp->last_read_buffer);
+  TCP_UNREF(exec_ctx, tcp, "destroy");
+}
+
+#endif
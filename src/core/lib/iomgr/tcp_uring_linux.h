@@ -0,0 +1,49 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_LIB_IOMGR_TCP_URING_LINUX_H
+#define GRPC_CORE_LIB_IOMGR_TCP_URING_LINUX_H
+/*
+   TCP endpoint whose reads and writes are io_uring operations, for use with
+   the uring polling engine (see ev_uring_linux.h). grpc_tcp_create() returns
+   one when that engine is in use, unless the channel args ask for something
+   only the readiness based endpoint does (zerocopy writes, write coalescing,
+   idle read buffer release, socket busy polling).
+*/
+
+#include "src/core/lib/iomgr/endpoint.h"
+#include "src/core/lib/iomgr/ev_posix.h"
+#include "src/core/lib/iomgr/resource_quota.h"
+
+/* Create a tcp endpoint for fd, taking ownership of it. The read chunk sizes
+   are those of grpc_tcp_create() */
+grpc_endpoint *grpc_tcp_uring_create(grpc_exec_ctx *exec_ctx, grpc_fd *fd,
+                                     grpc_resource_quota *resource_quota,
+                                     int read_chunk_size,
+                                     int min_read_chunk_size,
+                                     int max_read_chunk_size,
+                                     const char *peer_string);
+
+bool grpc_is_tcp_uring_endpoint(grpc_endpoint *ep);
+
+/* As grpc_tcp_destroy_and_release_fd() */
+void grpc_tcp_uring_destroy_and_release_fd(grpc_exec_ctx *exec_ctx,
+                                           grpc_endpoint *ep, int *fd,
+                                           grpc_closure *done);
+
+#endif /* GRPC_CORE_LIB_IOMGR_TCP_URING_LINUX_H */
@@ -340,10 +340,13 @@ static grpc_resource_user *uv_get_resource_user(grpc_endpoint *ep) {
 
 static int uv_get_fd(grpc_endpoint *ep) { return -1; }
 
+static void uv_hint_write_more(grpc_endpoint *ep) {}
+
 static grpc_endpoint_vtable vtable = {
     uv_endpoint_read,      uv_endpoint_write,    uv_add_to_pollset,
     uv_add_to_pollset_set, uv_endpoint_shutdown, uv_destroy,
-    uv_get_resource_user,  uv_get_peer,          uv_get_fd};
+    uv_get_resource_user,  uv_get_peer,          uv_get_fd,
+    uv_hint_write_more};
 
 grpc_endpoint *grpc_tcp_create(uv_tcp_t *handle,
                                grpc_resource_quota *resource_quota,
@@ -411,10 +411,12 @@ static grpc_resource_user *win_get_resource_user(grpc_endpoint *ep) {
 
 static int win_get_fd(grpc_endpoint *ep) { return -1; }
 
+static void win_hint_write_more(grpc_endpoint *ep) {}
+
 static grpc_endpoint_vtable vtable = {
     win_read,     win_write,   win_add_to_pollset,    win_add_to_pollset_set,
     win_shutdown, win_destroy, win_get_resource_user, win_get_peer,
-    win_get_fd};
+    win_get_fd,   win_hint_write_more};
 
 grpc_endpoint *grpc_tcp_create(grpc_exec_ctx *exec_ctx, grpc_winsocket *socket,
                                grpc_channel_args *channel_args,
@@ -103,4 +103,30 @@ void grpc_timer_consume_kick(void);
 
 void grpc_kick_poller(void);
 
+#ifdef GRPC_TIMER_USE_GENERIC
+/* Implementations of the timer list API above. The sharded heap is the
+   default; building with GRPC_TIMER_USE_WHEEL makes the hierarchical timing
+   wheel the default instead. Either way, setting GRPC_TIMER_STRATEGY to "heap"
+   or "wheel" in the environment picks one when the timer list is
+   initialized. */
+typedef struct grpc_timer_vtable {
+  void (*init)(grpc_exec_ctx *exec_ctx, grpc_timer *timer,
+               gpr_timespec deadline, grpc_closure *closure, gpr_timespec now);
+  void (*cancel)(grpc_exec_ctx *exec_ctx, grpc_timer *timer);
+  grpc_timer_check_result (*check)(grpc_exec_ctx *exec_ctx, gpr_timespec now,
+                                   gpr_timespec *next);
+  void (*list_init)(gpr_timespec now);
+  void (*list_shutdown)(grpc_exec_ctx *exec_ctx);
+  void (*consume_kick)(void);
+} grpc_timer_vtable;
+
+extern const grpc_timer_vtable grpc_timer_heap_vtable;
+extern const grpc_timer_vtable grpc_timer_wheel_vtable;
+
+/* Use \a impl from the next grpc_timer_list_init on, regardless of
+   GRPC_TIMER_STRATEGY. Must not be called while the timer list is
+   initialized. */
+void grpc_timer_set_impl(const grpc_timer_vtable *impl);
+#endif /* GRPC_TIMER_USE_GENERIC */
+
 #endif /* GRPC_CORE_LIB_IOMGR_TIMER_H */
@@ -22,6 +22,8 @@
 
 #include "src/core/lib/iomgr/timer.h"
 
+#include <string.h>
+
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 #include <grpc/support/string_util.h>
@@ -31,6 +33,7 @@
 #include "src/core/lib/debug/trace.h"
 #include "src/core/lib/iomgr/time_averaged_stats.h"
 #include "src/core/lib/iomgr/timer_heap.h"
+#include "src/core/lib/support/env.h"
 #include "src/core/lib/support/spinlock.h"
 
 #define INVALID_HEAP_INDEX 0xffffffffu
@@ -149,7 +152,7 @@ static gpr_atm compute_min_deadline(timer_shard *shard) {
              : grpc_timer_heap_top(&shard->heap)->deadline;
 }
 
-void grpc_timer_list_init(gpr_timespec now) {
+static void timer_list_init(gpr_timespec now) {
   uint32_t i;
 
   g_shared_mutables.initialized = true;
@@ -160,8 +163,6 @@ void grpc_timer_list_init(gpr_timespec now) {
   g_shared_mutables.min_timer = timespec_to_atm_round_down(now);
   gpr_tls_init(&g_last_seen_min_timer);
   gpr_tls_set(&g_last_seen_min_timer, 0);
-  grpc_register_tracer(&grpc_timer_trace);
-  grpc_register_tracer(&grpc_timer_check_trace);
 
   for (i = 0; i < NUM_SHARDS; i++) {
     timer_shard *shard = &g_shards[i];
@@ -177,7 +178,7 @@ void grpc_timer_list_init(gpr_timespec now) {
   }
 }
 
-void grpc_timer_list_shutdown(grpc_exec_ctx *exec_ctx) {
+static void timer_list_shutdown(grpc_exec_ctx *exec_ctx) {
   int i;
   run_some_expired_timers(
       exec_ctx, GPR_ATM_MAX, NULL,
@@ -235,9 +236,9 @@ static void note_deadline_change(timer_shard *shard) {
 
 void grpc_timer_init_unset(grpc_timer *timer) { timer->pending = false; }
 
-void grpc_timer_init(grpc_exec_ctx *exec_ctx, grpc_timer *timer,
-                     gpr_timespec deadline, grpc_closure *closure,
-                     gpr_timespec now) {
+static void timer_init(grpc_exec_ctx *exec_ctx, grpc_timer *timer,
+                       gpr_timespec deadline, grpc_closure *closure,
+                       gpr_timespec now) {
   int is_first_timer = 0;
   timer_shard *shard = &g_shards[GPR_HASH_POINTER(timer, NUM_SHARDS)];
   GPR_ASSERT(deadline.clock_type == g_clock_type);
@@ -316,12 +317,12 @@ void grpc_timer_init(grpc_exec_ctx *exec_ctx, grpc_timer *timer,
   }
 }
 
-void grpc_timer_consume_kick(void) {
+static void timer_consume_kick(void) {
   /* force re-evaluation of last seeen min */
   gpr_tls_set(&g_last_seen_min_timer, 0);
 }
 
-void grpc_timer_cancel(grpc_exec_ctx *exec_ctx, grpc_timer *timer) {
+static void timer_cancel(grpc_exec_ctx *exec_ctx, grpc_timer *timer) {
   if (!g_shared_mutables.initialized) {
     /* must have already been cancelled, also the shard mutex is invalid */
     return;
@@ -500,8 +501,9 @@ static grpc_timer_check_result run_some_expired_timers(grpc_exec_ctx *exec_ctx,
   return result;
 }
 
-grpc_timer_check_result grpc_timer_check(grpc_exec_ctx *exec_ctx,
-                                         gpr_timespec now, gpr_timespec *next) {
+static grpc_timer_check_result timer_check(grpc_exec_ctx *exec_ctx,
+                                           gpr_timespec now,
+                                           gpr_timespec *next) {
   // prelude
   GPR_ASSERT(now.clock_type == g_clock_type);
   gpr_atm now_atm = timespec_to_atm_round_down(now);
@@ -568,4 +570,58 @@ grpc_timer_check_result grpc_timer_check(grpc_exec_ctx *exec_ctx,
   return r;
 }
 
+const grpc_timer_vtable grpc_timer_heap_vtable = {
+    timer_init,          timer_cancel,        timer_check,
+    timer_list_init,     timer_list_shutdown, timer_consume_kick};
+
+#ifdef GRPC_TIMER_USE_WHEEL
+static const grpc_timer_vtable *g_timer_impl = &grpc_timer_wheel_vtable;
+#else
+static const grpc_timer_vtable *g_timer_impl = &grpc_timer_heap_vtable;
+#endif
+static bool g_timer_impl_forced = false;
+
+void grpc_timer_set_impl(const grpc_timer_vtable *impl) {
+  g_timer_impl = impl;
+  g_timer_impl_forced = true;
+}
+
+void grpc_timer_init(grpc_exec_ctx *exec_ctx, grpc_timer *timer,
+                     gpr_timespec deadline, grpc_closure *closure,
+                     gpr_timespec now) {
+  g_timer_impl->init(exec_ctx, timer, deadline, closure, now);
+}
+
+void grpc_timer_cancel(grpc_exec_ctx *exec_ctx, grpc_timer *timer) {
+  g_timer_impl->cancel(exec_ctx, timer);
+}
+
+grpc_timer_check_result grpc_timer_check(grpc_exec_ctx *exec_ctx,
+                                         gpr_timespec now, gpr_timespec *next) {
+  return g_timer_impl->check(exec_ctx, now, next);
+}
+
+void grpc_timer_list_init(gpr_timespec now) {
+  grpc_register_tracer(&grpc_timer_trace);
+  grpc_register_tracer(&grpc_timer_check_trace);
+  char *s = gpr_getenv("GRPC_TIMER_STRATEGY");
+  if (s != NULL && !g_timer_impl_forced) {
+    if (0 == strcmp(s, "heap")) {
+      g_timer_impl = &grpc_timer_heap_vtable;
+    } else if (0 == strcmp(s, "wheel")) {
+      g_timer_impl = &grpc_timer_wheel_vtable;
+    } else {
+      gpr_log(GPR_ERROR, "Unknown GRPC_TIMER_STRATEGY '%s', ignoring", s);
+    }
+  }
+  gpr_free(s);
+  g_timer_impl->list_init(now);
+}
+
+void grpc_timer_list_shutdown(grpc_exec_ctx *exec_ctx) {
+  g_timer_impl->list_shutdown(exec_ctx);
+}
+
+void grpc_timer_consume_kick(void) { g_timer_impl->consume_kick(); }
+
 #endif /* GRPC_TIMER_USE_GENERIC */
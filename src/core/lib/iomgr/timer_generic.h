@@ -24,7 +24,8 @@
 
 struct grpc_timer {
   gpr_atm deadline;
-  uint32_t heap_index; /* INVALID_HEAP_INDEX if not in heap */
+  /* heap: INVALID_HEAP_INDEX if not in heap; wheel: index of the slot */
+  uint32_t heap_index;
   bool pending;
   struct grpc_timer *next;
   struct grpc_timer *prev;
@@ -0,0 +1,466 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/lib/iomgr/port.h"
+
+#ifdef GRPC_TIMER_USE_GENERIC
+
+#include "src/core/lib/iomgr/timer.h"
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+#include <grpc/support/useful.h>
+#include "src/core/lib/debug/trace.h"
+#include "src/core/lib/support/spinlock.h"
+
+/* A hierarchical hashed timing wheel, sharded by timer address like the heap
+ * in timer_generic.c.
+ *
+ * Each shard has WHEEL_LEVELS wheels of WHEEL_SLOTS slots, a slot of level l
+ * spanning WHEEL_SLOTS^l milliseconds: the levels cover about 64ms, 4s, 4min,
+ * 4.6h and 12 days ahead. A timer is linked into the slot of the lowest level
+ * whose range covers its deadline, which makes adding and cancelling O(1).
+ * Whenever a level wraps around, the next slot of the level above is emptied
+ * into the levels below ("cascaded"), and the timers in the level 0 slot of
+ * the current millisecond fire. Per level occupancy bitmaps let the checker
+ * jump straight to the next slot that needs attention rather than walking
+ * every millisecond.
+ */
+
+#define LOG2_NUM_SHARDS 5
+#define NUM_SHARDS (1 << LOG2_NUM_SHARDS)
+#define WHEEL_BITS 6
+#define WHEEL_SLOTS (1 << WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS 5
+/* Timers due further out than this are parked in the last level and moved
+   closer as time passes */
+#define WHEEL_SPAN ((gpr_atm)1 << (WHEEL_BITS * WHEEL_LEVELS))
+
+extern grpc_tracer_flag grpc_timer_trace;
+extern grpc_tracer_flag grpc_timer_check_trace;
+
+typedef struct {
+  gpr_mu mu;
+  /* Every tick up to and including this one has been processed */
+  gpr_atm current_tick;
+  /* Bit s of occupied[l] is set iff slots[l][s] is not empty */
+  uint64_t occupied[WHEEL_LEVELS];
+  /* Heads of the circular timer lists */
+  grpc_timer slots[WHEEL_LEVELS][WHEEL_SLOTS];
+} wheel_shard;
+
+static wheel_shard *g_shards;
+
+struct shared_mutables {
+  /* No timer is due before this tick */
+  gpr_atm min_timer;
+  /* Allow only one sweep over the shards at once */
+  gpr_spinlock checker_mu;
+  bool initialized;
+} GPR_ALIGN_STRUCT(GPR_CACHELINE_SIZE);
+
+static struct shared_mutables g_shared_mutables;
+
+static gpr_clock_type g_clock_type;
+static gpr_timespec g_start_time;
+
+static gpr_timespec dbl_to_ts(double d) {
+  gpr_timespec ts;
+  ts.tv_sec = (int64_t)d;
+  ts.tv_nsec = (int32_t)(1e9 * (d - (double)ts.tv_sec));
+  ts.clock_type = GPR_TIMESPAN;
+  return ts;
+}
+
+static gpr_atm timespec_to_atm_round_up(gpr_timespec ts) {
+  ts = gpr_time_sub(ts, g_start_time);
+  double x = GPR_MS_PER_SEC * (double)ts.tv_sec +
+             (double)ts.tv_nsec / GPR_NS_PER_MS +
+             (double)(GPR_NS_PER_SEC - 1) / (double)GPR_NS_PER_SEC;
+  if (x < 0) return 0;
+  if (x > GPR_ATM_MAX) return GPR_ATM_MAX;
+  return (gpr_atm)x;
+}
+
+static gpr_atm timespec_to_atm_round_down(gpr_timespec ts) {
+  ts = gpr_time_sub(ts, g_start_time);
+  double x =
+      GPR_MS_PER_SEC * (double)ts.tv_sec + (double)ts.tv_nsec / GPR_NS_PER_MS;
+  if (x < 0) return 0;
+  if (x > GPR_ATM_MAX) return GPR_ATM_MAX;
+  return (gpr_atm)x;
+}
+
+static gpr_timespec atm_to_timespec(gpr_atm x) {
+  return gpr_time_add(g_start_time, dbl_to_ts((double)x / 1000.0));
+}
+
+static int lowest_set_bit(uint64_t x) {
+#ifdef __GNUC__
+  return __builtin_ctzll(x);
+#else
+  int i = 0;
+  while ((x & 1) == 0) {
+    x >>= 1;
+    i++;
+  }
+  return i;
+#endif
+}
+
+static void list_join(grpc_timer *head, grpc_timer *timer) {
+  timer->next = head;
+  timer->prev = head->prev;
+  timer->next->prev = timer->prev->next = timer;
+}
+
+static void list_remove(grpc_timer *timer) {
+  timer->next->prev = timer->prev;
+  timer->prev->next = timer->next;
+}
+
+/* Links timer into the slot matching its deadline (or min_tick, if that is
+   later). REQUIRES: shard->mu locked, min_tick >= shard->current_tick */
+static void slot_add(wheel_shard *shard, grpc_timer *timer, gpr_atm min_tick) {
+  gpr_atm when = GPR_MAX(timer->deadline, min_tick);
+  gpr_atm delta = when - shard->current_tick;
+  int level = 0;
+  if (delta >= WHEEL_SPAN) {
+    when = shard->current_tick + WHEEL_SPAN - 1;
+    level = WHEEL_LEVELS - 1;
+  } else {
+    while (delta >= (gpr_atm)1 << (WHEEL_BITS * (level + 1))) level++;
+  }
+  uint32_t slot = (uint32_t)((when >> (WHEEL_BITS * level)) & WHEEL_MASK);
+  timer->heap_index = (uint32_t)level * WHEEL_SLOTS + slot;
+  list_join(&shard->slots[level][slot], timer);
+  shard->occupied[level] |= (uint64_t)1 << slot;
+}
+
+/* REQUIRES: shard->mu locked */
+static void slot_remove(wheel_shard *shard, grpc_timer *timer) {
+  grpc_timer *head = &shard->slots[0][0] + timer->heap_index;
+  list_remove(timer);
+  if (head->next == head) {
+    shard->occupied[timer->heap_index / WHEEL_SLOTS] &=
+        ~((uint64_t)1 << (timer->heap_index % WHEEL_SLOTS));
+  }
+}
+
+/* Moves the contents of a slot to the (empty) list headed by out.
+   REQUIRES: shard->mu locked */
+static void slot_take(wheel_shard *shard, int level, uint32_t slot,
+                      grpc_timer *out) {
+  grpc_timer *head = &shard->slots[level][slot];
+  out->next = out->prev = out;
+  if (head->next == head) return;
+  out->next = head->next;
+  out->prev = head->prev;
+  out->next->prev = out->prev->next = out;
+  head->next = head->prev = head;
+  shard->occupied[level] &= ~((uint64_t)1 << slot);
+}
+
+/* Returns the first tick after shard->current_tick at which some slot has to
+   be cascaded or fired, or GPR_ATM_MAX if the shard is empty. This is a lower
+   bound for the next deadline in the shard.
+   REQUIRES: shard->mu locked */
+static gpr_atm next_event(wheel_shard *shard) {
+  gpr_atm next = GPR_ATM_MAX;
+  for (int level = 0; level < WHEEL_LEVELS; level++) {
+    uint64_t occupied = shard->occupied[level];
+    if (occupied == 0) continue;
+    int shift = WHEEL_BITS * level;
+    int cur = (int)((shard->current_tick >> shift) & WHEEL_MASK);
+    gpr_atm turn = (shard->current_tick >> (shift + WHEEL_BITS))
+                   << (shift + WHEEL_BITS);
+    /* slots past the current one come up in this turn of the wheel, the
+       others in the next one */
+    uint64_t ahead =
+        cur == WHEEL_MASK ? 0 : occupied & (~(uint64_t)0 << (cur + 1));
+    if (ahead == 0) {
+      turn += (gpr_atm)1 << (shift + WHEEL_BITS);
+      ahead = occupied;
+    }
+    next = GPR_MIN(next, turn + ((gpr_atm)lowest_set_bit(ahead) << shift));
+  }
+  return next;
+}
+
+/* REQUIRES: shard->mu locked */
+static void cascade(wheel_shard *shard, int level, uint32_t slot) {
+  grpc_timer list;
+  slot_take(shard, level, slot, &list);
+  while (list.next != &list) {
+    grpc_timer *timer = list.next;
+    list_remove(timer);
+    slot_add(shard, timer, shard->current_tick);
+  }
+}
+
+/* REQUIRES: shard->mu locked */
+static size_t fire_slot(grpc_exec_ctx *exec_ctx, wheel_shard *shard,
+                        uint32_t slot, grpc_error *error) {
+  size_t n = 0;
+  grpc_timer list;
+  slot_take(shard, 0, slot, &list);
+  while (list.next != &list) {
+    grpc_timer *timer = list.next;
+    list_remove(timer);
+    if (timer->deadline > shard->current_tick) {
+      /* parked beyond WHEEL_SPAN: not there yet */
+      slot_add(shard, timer, shard->current_tick + 1);
+      continue;
+    }
+    if (GRPC_TRACER_ON(grpc_timer_trace)) {
+      gpr_log(GPR_DEBUG, "TIMER %p: FIRE %" PRIdPTR "ms late", timer,
+              shard->current_tick - timer->deadline);
+    }
+    timer->pending = false;
+    GRPC_CLOSURE_SCHED(exec_ctx, timer->closure, GRPC_ERROR_REF(error));
+    n++;
+  }
+  return n;
+}
+
+/* Processes every tick up to and including now.
+   REQUIRES: shard->mu locked */
+static size_t advance(grpc_exec_ctx *exec_ctx, wheel_shard *shard, gpr_atm now,
+                      grpc_error *error) {
+  size_t n = 0;
+  gpr_atm tick;
+  while ((tick = next_event(shard)) <= now) {
+    shard->current_tick = tick;
+    /* the higher levels first: their timers may land in lower slots due at
+       this very tick */
+    for (int level = WHEEL_LEVELS - 1; level > 0; level--) {
+      int shift = WHEEL_BITS * level;
+      if ((tick & (((gpr_atm)1 << shift) - 1)) == 0) {
+        cascade(shard, level, (uint32_t)((tick >> shift) & WHEEL_MASK));
+      }
+    }
+    n += fire_slot(exec_ctx, shard, (uint32_t)(tick & WHEEL_MASK), error);
+  }
+  shard->current_tick = GPR_MAX(shard->current_tick, now);
+  return n;
+}
+
+/* Runs every timer in the shard with error.
+   REQUIRES: shard->mu locked */
+static size_t drain(grpc_exec_ctx *exec_ctx, wheel_shard *shard,
+                    grpc_error *error) {
+  size_t n = 0;
+  for (int level = 0; level < WHEEL_LEVELS; level++) {
+    while (shard->occupied[level] != 0) {
+      grpc_timer list;
+      slot_take(shard, level,
+                (uint32_t)lowest_set_bit(shard->occupied[level]), &list);
+      while (list.next != &list) {
+        grpc_timer *timer = list.next;
+        list_remove(timer);
+        timer->pending = false;
+        GRPC_CLOSURE_SCHED(exec_ctx, timer->closure, GRPC_ERROR_REF(error));
+        n++;
+      }
+    }
+  }
+  return n;
+}
+
+static void wheel_list_init(gpr_timespec now) {
+  g_shared_mutables.initialized = true;
+  g_shared_mutables.checker_mu = GPR_SPINLOCK_INITIALIZER;
+  g_clock_type = now.clock_type;
+  g_start_time = now;
+  gpr_atm_no_barrier_store(&g_shared_mutables.min_timer, GPR_ATM_MAX);
+
+  g_shards = (wheel_shard *)gpr_malloc(NUM_SHARDS * sizeof(*g_shards));
+  for (int i = 0; i < NUM_SHARDS; i++) {
+    wheel_shard *shard = &g_shards[i];
+    gpr_mu_init(&shard->mu);
+    shard->current_tick = timespec_to_atm_round_down(now);
+    for (int level = 0; level < WHEEL_LEVELS; level++) {
+      shard->occupied[level] = 0;
+      for (int slot = 0; slot < WHEEL_SLOTS; slot++) {
+        grpc_timer *head = &shard->slots[level][slot];
+        head->next = head->prev = head;
+      }
+    }
+  }
+}
+
+static void wheel_list_shutdown(grpc_exec_ctx *exec_ctx) {
+  grpc_error *error =
+      GRPC_ERROR_CREATE_FROM_STATIC_STRING("Timer list shutdown");
+  for (int i = 0; i < NUM_SHARDS; i++) {
+    wheel_shard *shard = &g_shards[i];
+    gpr_mu_lock(&shard->mu);
+    drain(exec_ctx, shard, error);
+    gpr_mu_unlock(&shard->mu);
+    gpr_mu_destroy(&shard->mu);
+  }
+  GRPC_ERROR_UNREF(error);
+  gpr_free(g_shards);
+  g_shards = NULL;
+  g_shared_mutables.initialized = false;
+}
+
+static void wheel_timer_init(grpc_exec_ctx *exec_ctx, grpc_timer *timer,
+                             gpr_timespec deadline, grpc_closure *closure,
+                             gpr_timespec now) {
+  GPR_ASSERT(deadline.clock_type == g_clock_type);
+  GPR_ASSERT(now.clock_type == g_clock_type);
+  timer->closure = closure;
+  gpr_atm deadline_atm = timer->deadline = timespec_to_atm_round_up(deadline);
+
+  if (GRPC_TRACER_ON(grpc_timer_trace)) {
+    gpr_log(GPR_DEBUG, "TIMER %p: SET %" PRId64 ".%09d [%" PRIdPTR
+                       "] now %" PRId64 ".%09d [%" PRIdPTR "] call %p[%p]",
+            timer, deadline.tv_sec, deadline.tv_nsec, deadline_atm, now.tv_sec,
+            now.tv_nsec, timespec_to_atm_round_down(now), closure, closure->cb);
+  }
+
+  if (!g_shared_mutables.initialized) {
+    timer->pending = false;
+    GRPC_CLOSURE_SCHED(exec_ctx, timer->closure,
+                       GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+                           "Attempt to create timer before initialization"));
+    return;
+  }
+
+  if (gpr_time_cmp(deadline, now) <= 0) {
+    timer->pending = false;
+    GRPC_CLOSURE_SCHED(exec_ctx, timer->closure, GRPC_ERROR_NONE);
+    return;
+  }
+
+  wheel_shard *shard = &g_shards[GPR_HASH_POINTER(timer, NUM_SHARDS)];
+  gpr_mu_lock(&shard->mu);
+  timer->pending = true;
+  slot_add(shard, timer, shard->current_tick + 1);
+  gpr_mu_unlock(&shard->mu);
+
+  /* if this is the earliest deadline now, make sure a timer thread wakes up
+     for it */
+  gpr_atm min_timer = gpr_atm_no_barrier_load(&g_shared_mutables.min_timer);
+  while (deadline_atm < min_timer) {
+    if (gpr_atm_full_cas(&g_shared_mutables.min_timer, min_timer,
+                         deadline_atm)) {
+      grpc_kick_poller();
+      break;
+    }
+    min_timer = gpr_atm_no_barrier_load(&g_shared_mutables.min_timer);
+  }
+}
+
+static void wheel_timer_cancel(grpc_exec_ctx *exec_ctx, grpc_timer *timer) {
+  if (!g_shared_mutables.initialized) {
+    /* must have already been cancelled, also the shard mutex is invalid */
+    return;
+  }
+
+  wheel_shard *shard = &g_shards[GPR_HASH_POINTER(timer, NUM_SHARDS)];
+  gpr_mu_lock(&shard->mu);
+  if (GRPC_TRACER_ON(grpc_timer_trace)) {
+    gpr_log(GPR_DEBUG, "TIMER %p: CANCEL pending=%s", timer,
+            timer->pending ? "true" : "false");
+  }
+  if (timer->pending) {
+    GRPC_CLOSURE_SCHED(exec_ctx, timer->closure, GRPC_ERROR_CANCELLED);
+    timer->pending = false;
+    slot_remove(shard, timer);
+  }
+  gpr_mu_unlock(&shard->mu);
+}
+
+static grpc_timer_check_result wheel_timer_check(grpc_exec_ctx *exec_ctx,
+                                                 gpr_timespec now,
+                                                 gpr_timespec *next) {
+  GPR_ASSERT(now.clock_type == g_clock_type);
+  gpr_atm now_atm = timespec_to_atm_round_down(now);
+
+  gpr_atm min_timer = gpr_atm_no_barrier_load(&g_shared_mutables.min_timer);
+  if (now_atm < min_timer) {
+    if (next != NULL) {
+      *next =
+          atm_to_timespec(GPR_MIN(timespec_to_atm_round_up(*next), min_timer));
+    }
+    if (GRPC_TRACER_ON(grpc_timer_check_trace)) {
+      gpr_log(GPR_DEBUG,
+              "TIMER CHECK SKIP: now_atm=%" PRIdPTR " min_timer=%" PRIdPTR,
+              now_atm, min_timer);
+    }
+    return GRPC_TIMERS_CHECKED_AND_EMPTY;
+  }
+
+  if (!gpr_spinlock_trylock(&g_shared_mutables.checker_mu)) {
+    return GRPC_TIMERS_NOT_CHECKED;
+  }
+
+  bool shutdown = gpr_time_cmp(now, gpr_inf_future(now.clock_type)) == 0;
+  grpc_error *error =
+      shutdown
+          ? GRPC_ERROR_CREATE_FROM_STATIC_STRING("Shutting down timer system")
+          : GRPC_ERROR_NONE;
+  grpc_timer_check_result result = GRPC_TIMERS_CHECKED_AND_EMPTY;
+
+  /* timers added from here on lower min_timer themselves, whether or not
+     the sweep below still sees them */
+  gpr_atm_full_xchg(&g_shared_mutables.min_timer, GPR_ATM_MAX);
+  gpr_atm new_min_timer = GPR_ATM_MAX;
+  for (int i = 0; i < NUM_SHARDS; i++) {
+    wheel_shard *shard = &g_shards[i];
+    gpr_mu_lock(&shard->mu);
+    size_t fired = shutdown ? drain(exec_ctx, shard, error)
+                            : advance(exec_ctx, shard, now_atm, error);
+    new_min_timer = GPR_MIN(new_min_timer, next_event(shard));
+    gpr_mu_unlock(&shard->mu);
+    if (fired > 0) result = GRPC_TIMERS_FIRED;
+  }
+  min_timer = gpr_atm_no_barrier_load(&g_shared_mutables.min_timer);
+  while (new_min_timer < min_timer &&
+         !gpr_atm_full_cas(&g_shared_mutables.min_timer, min_timer,
+                           new_min_timer)) {
+    min_timer = gpr_atm_no_barrier_load(&g_shared_mutables.min_timer);
+  }
+  gpr_spinlock_unlock(&g_shared_mutables.checker_mu);
+  GRPC_ERROR_UNREF(error);
+
+  if (next != NULL) {
+    *next = atm_to_timespec(
+        GPR_MIN(timespec_to_atm_round_down(*next), new_min_timer));
+  }
+  if (GRPC_TRACER_ON(grpc_timer_check_trace)) {
+    gpr_log(GPR_DEBUG, "TIMER CHECK END: r=%d; now_atm=%" PRIdPTR
+                       " min_timer=%" PRIdPTR,
+            result, now_atm, new_min_timer);
+  }
+  return result;
+}
+
+/* Kicks do not need to invalidate anything here: min_timer is always read
+   from shared memory */
+static void wheel_timer_consume_kick(void) {}
+
+const grpc_timer_vtable grpc_timer_wheel_vtable = {
+    wheel_timer_init,    wheel_timer_cancel,  wheel_timer_check,
+    wheel_list_init,     wheel_list_shutdown, wheel_timer_consume_kick};
+
+#endif /* GRPC_TIMER_USE_GENERIC */
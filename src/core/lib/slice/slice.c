@@ -224,6 +224,10 @@ static const grpc_slice_refcount_vtable malloc_vtable = {
 grpc_slice grpc_slice_malloc_large(size_t length) {
   grpc_slice slice;
 
+  if (grpc_slice_pool_malloc(length, &slice)) {
+    return slice;
+  }
+
   /* Memory layout used by the slice created here:
 
      +-----------+----------------------------------------------------------+
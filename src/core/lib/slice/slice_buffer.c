@@ -30,30 +30,47 @@
 /* grow a buffer; requires GRPC_SLICE_BUFFER_INLINE_ELEMENTS > 1 */
 #define GROW(x) (3 * (x) / 2)
 
+/* The live slices are sb->slices[0, count): take_first advances sb->slices,
+   leaving a gap at the front of sb->base_slices that undo_take_first can
+   step back into. When the end of the array is reached the gap is only
+   reclaimed by moving the live slices down if it is at least as large as
+   they are, so each take_first pays for at most one slice moved; otherwise
+   the array grows (dropping the gap as it is copied). Together these keep
+   add, take_first and undo_take_first amortized O(1) under any mix of
+   pushes and pops, while slices stay contiguous for callers that index
+   sb->slices directly. */
 static void maybe_embiggen(grpc_slice_buffer *sb) {
+  if (sb->count == 0) {
+    /* nothing live: start again from the front for free */
+    sb->slices = sb->base_slices;
+    return;
+  }
+
   /* How far away from sb->base_slices is sb->slices pointer */
   size_t slice_offset = (size_t)(sb->slices - sb->base_slices);
   size_t slice_count = sb->count + slice_offset;
 
   if (slice_count == sb->capacity) {
-    if (sb->base_slices != sb->slices) {
-      /* Make room by moving elements if there's still space unused */
-      memmove(sb->base_slices, sb->slices, sb->count * sizeof(grpc_slice));
+    if (slice_offset >= sb->count) {
+      /* Make room by moving elements if enough space is unused */
+      memcpy(sb->base_slices, sb->slices, sb->count * sizeof(grpc_slice));
       sb->slices = sb->base_slices;
     } else {
       /* Allocate more memory if no more space is available */
       sb->capacity = GROW(sb->capacity);
       GPR_ASSERT(sb->capacity > slice_count);
-      if (sb->base_slices == sb->inlined) {
-        sb->base_slices =
+      if (sb->base_slices == sb->inlined || slice_offset != 0) {
+        grpc_slice *base_slices =
             (grpc_slice *)gpr_malloc(sb->capacity * sizeof(grpc_slice));
-        memcpy(sb->base_slices, sb->inlined, slice_count * sizeof(grpc_slice));
+        memcpy(base_slices, sb->slices, sb->count * sizeof(grpc_slice));
+        if (sb->base_slices != sb->inlined) gpr_free(sb->base_slices);
+        sb->base_slices = base_slices;
       } else {
         sb->base_slices = (grpc_slice *)gpr_realloc(
             sb->base_slices, sb->capacity * sizeof(grpc_slice));
       }
 
-      sb->slices = sb->base_slices + slice_offset;
+      sb->slices = sb->base_slices;
     }
   }
 }
@@ -170,6 +187,7 @@ void grpc_slice_buffer_reset_and_unref_internal(grpc_exec_ctx *exec_ctx,
     grpc_slice_unref_internal(exec_ctx, sb->slices[i]);
   }
 
+  sb->slices = sb->base_slices;
   sb->count = 0;
   sb->length = 0;
 }
@@ -235,6 +253,7 @@ void grpc_slice_buffer_move_into(grpc_slice_buffer *src,
   }
   /* both buffers have data - copy, and reset src */
   grpc_slice_buffer_addn(dst, src->slices, src->count);
+  src->slices = src->base_slices;
   src->count = 0;
   src->length = 0;
 }
@@ -353,6 +372,12 @@ grpc_slice grpc_slice_buffer_take_first(grpc_slice_buffer *sb) {
 
 void grpc_slice_buffer_undo_take_first(grpc_slice_buffer *sb,
                                        grpc_slice slice) {
+  if (sb->slices == sb->base_slices) {
+    /* the gap take_first left has been reclaimed since: open a new one */
+    maybe_embiggen(sb);
+    memmove(sb->slices + 1, sb->slices, sb->count * sizeof(grpc_slice));
+    sb->slices++;
+  }
   sb->slices--;
   sb->slices[0] = slice;
   sb->count++;
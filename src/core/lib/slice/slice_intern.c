@@ -26,6 +26,7 @@
 #include "src/core/lib/iomgr/iomgr_internal.h" /* for iomgr_abort_on_leaks() */
 #include "src/core/lib/profiling/timers.h"
 #include "src/core/lib/slice/slice_string_helpers.h"
+#include "src/core/lib/support/epoch.h"
 #include "src/core/lib/support/murmur_hash.h"
 #include "src/core/lib/transport/static_metadata.h"
 
@@ -42,14 +43,25 @@ typedef struct interned_slice_refcount {
   size_t length;
   gpr_atm refcnt;
   uint32_t hash;
-  struct interned_slice_refcount *bucket_next;
+  /* interned_slice_refcount*: the next string in the bucket */
+  gpr_atm bucket_next;
 } interned_slice_refcount;
 
+typedef struct slice_table {
+  size_t capacity;
+  /* interned_slice_refcount*: bucket heads */
+  gpr_atm strs[];
+} slice_table;
+
+/* Lookups walk a shard's table without its lock (see gpr_epoch_enter), so
+   writers publish with release stores and retire, rather than free, strings
+   and tables they unlink. */
 typedef struct slice_shard {
   gpr_mu mu;
-  interned_slice_refcount **strs;
+  /* slice_table*, replaced as the shard grows */
+  gpr_atm table;
   size_t count;
-  size_t capacity;
+  gpr_epoch_limbo limbo;
 } slice_shard;
 
 /* hash seed: decided at initialization time */
@@ -73,19 +85,38 @@ static void interned_slice_ref(void *p) {
   GPR_ASSERT(gpr_atm_no_barrier_fetch_add(&s->refcnt, 1) > 0);
 }
 
+/* take a ref unless the count already dropped to zero: once it has, the
+   string is being destroyed and must not be handed out again */
+static bool ref_if_nonzero(interned_slice_refcount *s) {
+  for (;;) {
+    gpr_atm count = gpr_atm_no_barrier_load(&s->refcnt);
+    if (count == 0) return false;
+    if (gpr_atm_no_barrier_cas(&s->refcnt, count, count + 1)) return true;
+  }
+}
+
+static slice_table *get_table(slice_shard *shard) {
+  return (slice_table *)gpr_atm_acq_load(&shard->table);
+}
+
+static interned_slice_refcount *next_str(gpr_atm *link) {
+  return (interned_slice_refcount *)gpr_atm_acq_load(link);
+}
+
 static void interned_slice_destroy(interned_slice_refcount *s) {
   slice_shard *shard = &g_shards[SHARD_IDX(s->hash)];
   gpr_mu_lock(&shard->mu);
   GPR_ASSERT(0 == gpr_atm_no_barrier_load(&s->refcnt));
-  interned_slice_refcount **prev_next;
+  slice_table *table = get_table(shard);
+  gpr_atm *prev_next;
   interned_slice_refcount *cur;
-  for (prev_next = &shard->strs[TABLE_IDX(s->hash, shard->capacity)],
-      cur = *prev_next;
-       cur != s; prev_next = &cur->bucket_next, cur = cur->bucket_next)
+  for (prev_next = &table->strs[TABLE_IDX(s->hash, table->capacity)],
+      cur = next_str(prev_next);
+       cur != s; prev_next = &cur->bucket_next, cur = next_str(prev_next))
     ;
-  *prev_next = cur->bucket_next;
+  gpr_atm_rel_store(prev_next, gpr_atm_no_barrier_load(&cur->bucket_next));
   shard->count--;
-  gpr_free(s);
+  gpr_epoch_retire(&shard->limbo, s);
   gpr_mu_unlock(&shard->mu);
 }
 
@@ -121,29 +152,35 @@ static const grpc_slice_refcount_vtable interned_slice_sub_vtable = {
     interned_slice_sub_ref, interned_slice_sub_unref,
     grpc_slice_default_eq_impl, grpc_slice_default_hash_impl};
 
+static slice_table *new_table(size_t capacity) {
+  slice_table *table = (slice_table *)gpr_zalloc(sizeof(slice_table) +
+                                                 sizeof(gpr_atm) * capacity);
+  table->capacity = capacity;
+  return table;
+}
+
 static void grow_shard(slice_shard *shard) {
-  size_t capacity = shard->capacity * 2;
+  slice_table *old_table = get_table(shard);
+  slice_table *table = new_table(old_table->capacity * 2);
   size_t i;
-  interned_slice_refcount **strtab;
   interned_slice_refcount *s, *next;
 
   GPR_TIMER_BEGIN("grow_strtab", 0);
 
-  strtab = (interned_slice_refcount **)gpr_zalloc(
-      sizeof(interned_slice_refcount *) * capacity);
-
-  for (i = 0; i < shard->capacity; i++) {
-    for (s = shard->strs[i]; s; s = next) {
-      size_t idx = TABLE_IDX(s->hash, capacity);
-      next = s->bucket_next;
-      s->bucket_next = strtab[idx];
-      strtab[idx] = s;
+  /* a concurrent lookup still on the old table may be led into a bucket of
+     the new one: it can miss, and take the locked path, but never loops */
+  for (i = 0; i < old_table->capacity; i++) {
+    for (s = next_str(&old_table->strs[i]); s; s = next) {
+      size_t idx = TABLE_IDX(s->hash, table->capacity);
+      next = next_str(&s->bucket_next);
+      gpr_atm_rel_store(&s->bucket_next,
+                        gpr_atm_no_barrier_load(&table->strs[idx]));
+      gpr_atm_no_barrier_store(&table->strs[idx], (gpr_atm)s);
     }
   }
 
-  gpr_free(shard->strs);
-  shard->strs = strtab;
-  shard->capacity = capacity;
+  gpr_atm_rel_store(&shard->table, (gpr_atm)table);
+  gpr_epoch_retire(&shard->limbo, old_table);
 
   GPR_TIMER_END("grow_strtab", 0);
 }
@@ -199,6 +236,22 @@ bool grpc_slice_is_interned(grpc_slice slice) {
          GRPC_IS_STATIC_METADATA_STRING(slice);
 }
 
+/* find a live interned copy of \a slice and take a ref on it: callers either
+   hold the shard lock or are in an epoch critical section */
+static interned_slice_refcount *find_and_ref(slice_shard *shard,
+                                             grpc_slice slice, uint32_t hash) {
+  slice_table *table = get_table(shard);
+  for (interned_slice_refcount *s =
+           next_str(&table->strs[TABLE_IDX(hash, table->capacity)]);
+       s != NULL; s = next_str(&s->bucket_next)) {
+    if (s->hash == hash && grpc_slice_eq(slice, materialize(s)) &&
+        ref_if_nonzero(s)) {
+      return s;
+    }
+  }
+  return NULL;
+}
+
 grpc_slice grpc_slice_intern(grpc_slice slice) {
   GPR_TIMER_BEGIN("grpc_slice_intern", 0);
   if (GRPC_IS_STATIC_METADATA_STRING(slice)) {
@@ -220,25 +273,24 @@ grpc_slice grpc_slice_intern(grpc_slice slice) {
   interned_slice_refcount *s;
   slice_shard *shard = &g_shards[SHARD_IDX(hash)];
 
+  /* strings are usually already interned: look without the lock first */
+  if (gpr_epoch_enter()) {
+    s = find_and_ref(shard, slice, hash);
+    gpr_epoch_exit();
+    if (s != NULL) {
+      GPR_TIMER_END("grpc_slice_intern", 0);
+      return materialize(s);
+    }
+  }
+
   gpr_mu_lock(&shard->mu);
 
-  /* search for an existing string */
-  size_t idx = TABLE_IDX(hash, shard->capacity);
-  for (s = shard->strs[idx]; s; s = s->bucket_next) {
-    if (s->hash == hash && grpc_slice_eq(slice, materialize(s))) {
-      if (gpr_atm_no_barrier_fetch_add(&s->refcnt, 1) == 0) {
-        /* If we get here, we've added a ref to something that was about to
-         * die - drop it immediately.
-         * The *only* possible path here (given the shard mutex) should be to
-         * drop from one ref back to zero - assert that with a CAS */
-        GPR_ASSERT(gpr_atm_rel_cas(&s->refcnt, 1, 0));
-        /* and treat this as if we were never here... sshhh */
-      } else {
-        gpr_mu_unlock(&shard->mu);
-        GPR_TIMER_END("grpc_slice_intern", 0);
-        return materialize(s);
-      }
-    }
+  /* search again: the string may have been added since */
+  s = find_and_ref(shard, slice, hash);
+  if (s != NULL) {
+    gpr_mu_unlock(&shard->mu);
+    GPR_TIMER_END("grpc_slice_intern", 0);
+    return materialize(s);
   }
 
   /* not found: create a new string */
@@ -252,13 +304,16 @@ grpc_slice grpc_slice_intern(grpc_slice slice) {
   s->base.sub_refcount = &s->sub;
   s->sub.vtable = &interned_slice_sub_vtable;
   s->sub.sub_refcount = &s->sub;
-  s->bucket_next = shard->strs[idx];
-  shard->strs[idx] = s;
   memcpy(s + 1, GRPC_SLICE_START_PTR(slice), GRPC_SLICE_LENGTH(slice));
+  slice_table *table = get_table(shard);
+  size_t idx = TABLE_IDX(hash, table->capacity);
+  gpr_atm_no_barrier_store(&s->bucket_next,
+                           gpr_atm_no_barrier_load(&table->strs[idx]));
+  gpr_atm_rel_store(&table->strs[idx], (gpr_atm)s);
 
   shard->count++;
 
-  if (shard->count > shard->capacity * 2) {
+  if (shard->count > table->capacity * 2) {
     grow_shard(shard);
   }
 
@@ -281,9 +336,9 @@ void grpc_slice_intern_init(void) {
     slice_shard *shard = &g_shards[i];
     gpr_mu_init(&shard->mu);
     shard->count = 0;
-    shard->capacity = INITIAL_SHARD_CAPACITY;
-    shard->strs = (interned_slice_refcount **)gpr_zalloc(sizeof(*shard->strs) *
-                                                         shard->capacity);
+    gpr_atm_no_barrier_store(&shard->table,
+                             (gpr_atm)new_table(INITIAL_SHARD_CAPACITY));
+    gpr_epoch_limbo_init(&shard->limbo);
   }
   for (size_t i = 0; i < GPR_ARRAY_SIZE(static_metadata_hash); i++) {
     static_metadata_hash[i].hash = 0;
@@ -316,9 +371,10 @@ void grpc_slice_intern_shutdown(void) {
     if (shard->count != 0) {
       gpr_log(GPR_DEBUG, "WARNING: %" PRIuPTR " metadata strings were leaked",
               shard->count);
-      for (size_t j = 0; j < shard->capacity; j++) {
-        for (interned_slice_refcount *s = shard->strs[j]; s;
-             s = s->bucket_next) {
+      slice_table *table = get_table(shard);
+      for (size_t j = 0; j < table->capacity; j++) {
+        for (interned_slice_refcount *s = next_str(&table->strs[j]); s;
+             s = next_str(&s->bucket_next)) {
           char *text =
               grpc_dump_slice(materialize(s), GPR_DUMP_HEX | GPR_DUMP_ASCII);
           gpr_log(GPR_DEBUG, "LEAKED: %s", text);
@@ -329,6 +385,7 @@ void grpc_slice_intern_shutdown(void) {
         abort();
       }
     }
-    gpr_free(shard->strs);
+    gpr_free(get_table(shard));
+    gpr_epoch_limbo_destroy(&shard->limbo);
   }
 }
@@ -36,6 +36,16 @@ bool grpc_slice_is_interned(grpc_slice slice);
 
 void grpc_slice_intern_init(void);
 void grpc_slice_intern_shutdown(void);
+
+/* Recycling of small slice allocations: see slice_pool.c. The pool caches
+   between grpc_slice_pool_init and grpc_slice_pool_shutdown only. */
+void grpc_slice_pool_init(void);
+void grpc_slice_pool_shutdown(void);
+/* Allocate a refcounted slice of length bytes into *slice from the pool, or
+   return false if length is too large to be pooled */
+bool grpc_slice_pool_malloc(size_t length, grpc_slice *slice);
+/* Bytes held in the pool's global depot and the calling thread's cache */
+size_t grpc_slice_pool_cached_bytes(void);
 void grpc_test_only_set_slice_hash_seed(uint32_t key);
 // if slice matches a static slice, returns the static slice
 // otherwise returns the passed in slice (without reffing it)
@@ -0,0 +1,100 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/slice.h>
+#include <grpc/support/log.h>
+#include <grpc/support/port_platform.h>
+
+#ifndef GPR_WINDOWS
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/sync.h>
+
+#include "src/core/lib/slice/slice_internal.h"
+
+/* one mapping, shared by every slice referencing part of it */
+typedef struct {
+  grpc_slice_refcount base;
+  gpr_refcount refs;
+  void *map;
+  size_t map_length;
+} mapped_refcount;
+
+static void mapped_ref(void *p) {
+  mapped_refcount *r = (mapped_refcount *)p;
+  gpr_ref(&r->refs);
+}
+
+static void mapped_unref(grpc_exec_ctx *exec_ctx, void *p) {
+  mapped_refcount *r = (mapped_refcount *)p;
+  if (gpr_unref(&r->refs)) {
+    GPR_ASSERT(munmap(r->map, r->map_length) == 0);
+    gpr_free(r);
+  }
+}
+
+static const grpc_slice_refcount_vtable mapped_vtable = {
+    mapped_ref, mapped_unref, grpc_slice_default_eq_impl,
+    grpc_slice_default_hash_impl};
+
+int grpc_slice_map_file(int fd, uint64_t offset, size_t length,
+                        grpc_slice *slice) {
+  if (length == 0) {
+    *slice = grpc_empty_slice();
+    return 1;
+  }
+  /* mappings must start on a page boundary */
+  uint64_t page_size = (uint64_t)sysconf(_SC_PAGESIZE);
+  size_t skip = (size_t)(offset % page_size);
+  off_t map_offset = (off_t)(offset - skip);
+  if (length > SIZE_MAX - skip || map_offset < 0 ||
+      (uint64_t)map_offset != offset - skip) {
+    gpr_log(GPR_ERROR, "grpc_slice_map_file: range out of bounds");
+    return 0;
+  }
+  void *map = mmap(NULL, length + skip, PROT_READ, MAP_SHARED, fd, map_offset);
+  if (map == MAP_FAILED) {
+    gpr_log(GPR_ERROR, "grpc_slice_map_file: mmap: %s", strerror(errno));
+    return 0;
+  }
+  mapped_refcount *r = (mapped_refcount *)gpr_malloc(sizeof(*r));
+  gpr_ref_init(&r->refs, 1);
+  r->base.vtable = &mapped_vtable;
+  r->base.sub_refcount = &r->base;
+  r->map = map;
+  r->map_length = length + skip;
+  slice->refcount = &r->base;
+  slice->data.refcounted.bytes = (uint8_t *)map + skip;
+  slice->data.refcounted.length = length;
+  return 1;
+}
+
+#else /* GPR_WINDOWS */
+
+int grpc_slice_map_file(int fd, uint64_t offset, size_t length,
+                        grpc_slice *slice) {
+  gpr_log(GPR_ERROR, "grpc_slice_map_file: not supported on this platform");
+  return 0;
+}
+
+#endif /* GPR_WINDOWS */
@@ -0,0 +1,327 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/lib/slice/slice_internal.h"
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/atm.h>
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+#include <grpc/support/tls.h>
+
+#include "src/core/lib/debug/stats.h"
+
+/* The memory for small refcounted slices (refcount and bytes in a single
+   block) is recycled through size classed free lists rather than going back
+   to the allocator on every unref.
+
+   Each thread keeps one free list per size class. When a list grows to two
+   batches, one batch is handed to a global depot; an empty list refills with
+   a batch from the depot before falling back to gpr_malloc. Batches keep the
+   depot mutex off the per-slice path.
+
+   The pool only caches between grpc_init and grpc_shutdown: shutdown hands
+   everything cached back to gpr_free, so allocators that check for leaks
+   (see test/core/util/memory_counters.c) see a clean heap. Thread caches
+   need a hook to release them when their thread exits, which is only
+   available with pthreads; elsewhere the pool passes straight through to
+   gpr_malloc. */
+
+#ifdef GPR_POSIX_SYNC
+
+#include <pthread.h>
+
+/* size classes are powers of two from 64 to 4096 bytes */
+#define MIN_BLOCK_SHIFT 6
+#define NUM_SIZE_CLASSES 7
+/* bytes moved between a thread cache and the depot at a time */
+#define BATCH_BYTES 8192
+/* batches kept by the depot per size class before freeing */
+#define MAX_DEPOT_BATCHES 16
+
+typedef enum { BLOCK_UNPOOLED, BLOCK_MISS, BLOCK_HIT } block_origin;
+
+typedef struct {
+  grpc_slice_refcount base;
+  gpr_refcount refs;
+  uint8_t size_class;
+  uint8_t origin;
+} pooled_refcount;
+
+/* a free block: overlays its pooled_refcount */
+typedef struct free_block {
+  struct free_block *next;
+  /* on the first block of each batch in the depot: the next batch */
+  struct free_block *next_batch;
+} free_block;
+
+typedef struct {
+  free_block *head;
+  size_t count;
+} free_list;
+
+typedef struct {
+  /* the pool generation the cached blocks belong to */
+  gpr_atm generation;
+  free_list lists[NUM_SIZE_CLASSES];
+} thread_cache;
+
+typedef struct {
+  gpr_mu mu;
+  free_block *batches;
+  size_t num_batches;
+} depot;
+
+static gpr_once g_once = GPR_ONCE_INIT;
+/* bumped by grpc_slice_pool_init and grpc_slice_pool_shutdown: odd while the
+   pool is caching */
+static gpr_atm g_generation;
+static depot g_depots[NUM_SIZE_CLASSES];
+GPR_TLS_DECL(g_thread_cache);
+static pthread_key_t g_thread_cache_key;
+
+static size_t block_size(int size_class) {
+  return (size_t)1 << (MIN_BLOCK_SHIFT + size_class);
+}
+
+static size_t batch_blocks(int size_class) {
+  return BATCH_BYTES / block_size(size_class);
+}
+
+static bool is_caching(gpr_atm generation) { return (generation & 1) != 0; }
+
+static void free_blocks(free_block *b) {
+  while (b != NULL) {
+    free_block *next = b->next;
+    gpr_free(b);
+    b = next;
+  }
+}
+
+/* hand a batch to the depot, freeing it instead if the depot is full or the
+   pool has been shut down since the batch was cached */
+static void depot_put(int size_class, free_block *batch, gpr_atm generation) {
+  depot *d = &g_depots[size_class];
+  gpr_mu_lock(&d->mu);
+  if (generation == gpr_atm_no_barrier_load(&g_generation) &&
+      d->num_batches < MAX_DEPOT_BATCHES) {
+    batch->next_batch = d->batches;
+    d->batches = batch;
+    d->num_batches++;
+    batch = NULL;
+  }
+  gpr_mu_unlock(&d->mu);
+  free_blocks(batch);
+}
+
+static free_block *depot_get(int size_class) {
+  depot *d = &g_depots[size_class];
+  gpr_mu_lock(&d->mu);
+  free_block *batch = d->batches;
+  if (batch != NULL) {
+    d->batches = batch->next_batch;
+    d->num_batches--;
+  }
+  gpr_mu_unlock(&d->mu);
+  return batch;
+}
+
+static void flush_thread_cache(thread_cache *tc) {
+  for (int i = 0; i < NUM_SIZE_CLASSES; i++) {
+    free_blocks(tc->lists[i].head);
+    tc->lists[i].head = NULL;
+    tc->lists[i].count = 0;
+  }
+}
+
+static void destroy_thread_cache(void *arg) {
+  thread_cache *tc = (thread_cache *)arg;
+  flush_thread_cache(tc);
+  gpr_free(tc);
+}
+
+/* the calling thread's cache, emptied first if it holds blocks from an
+   earlier generation of the pool */
+static thread_cache *get_thread_cache(gpr_atm generation) {
+  thread_cache *tc = (thread_cache *)gpr_tls_get(&g_thread_cache);
+  if (tc == NULL) {
+    tc = (thread_cache *)gpr_zalloc(sizeof(*tc));
+    tc->generation = generation;
+    gpr_tls_set(&g_thread_cache, (intptr_t)tc);
+    GPR_ASSERT(pthread_setspecific(g_thread_cache_key, tc) == 0);
+  } else if (tc->generation != generation) {
+    flush_thread_cache(tc);
+    tc->generation = generation;
+  }
+  return tc;
+}
+
+static void do_init(void) {
+  for (int i = 0; i < NUM_SIZE_CLASSES; i++) {
+    gpr_mu_init(&g_depots[i].mu);
+  }
+  gpr_tls_init(&g_thread_cache);
+  GPR_ASSERT(pthread_key_create(&g_thread_cache_key, destroy_thread_cache) ==
+             0);
+}
+
+void grpc_slice_pool_init(void) {
+  gpr_once_init(&g_once, do_init);
+  GPR_ASSERT(is_caching(gpr_atm_full_fetch_add(&g_generation, 1) + 1));
+}
+
+void grpc_slice_pool_shutdown(void) {
+  GPR_ASSERT(!is_caching(gpr_atm_full_fetch_add(&g_generation, 1) + 1));
+  for (int i = 0; i < NUM_SIZE_CLASSES; i++) {
+    depot *d = &g_depots[i];
+    gpr_mu_lock(&d->mu);
+    free_block *batches = d->batches;
+    d->batches = NULL;
+    d->num_batches = 0;
+    gpr_mu_unlock(&d->mu);
+    while (batches != NULL) {
+      free_block *next = batches->next_batch;
+      free_blocks(batches);
+      batches = next;
+    }
+  }
+  thread_cache *tc = (thread_cache *)gpr_tls_get(&g_thread_cache);
+  if (tc != NULL) {
+    gpr_tls_set(&g_thread_cache, 0);
+    GPR_ASSERT(pthread_setspecific(g_thread_cache_key, NULL) == 0);
+    destroy_thread_cache(tc);
+  }
+}
+
+size_t grpc_slice_pool_cached_bytes(void) {
+  gpr_once_init(&g_once, do_init);
+  size_t bytes = 0;
+  for (int i = 0; i < NUM_SIZE_CLASSES; i++) {
+    gpr_mu_lock(&g_depots[i].mu);
+    bytes += g_depots[i].num_batches * BATCH_BYTES;
+    gpr_mu_unlock(&g_depots[i].mu);
+  }
+  if (is_caching(gpr_atm_acq_load(&g_generation))) {
+    thread_cache *tc = (thread_cache *)gpr_tls_get(&g_thread_cache);
+    for (int i = 0; tc != NULL && i < NUM_SIZE_CLASSES; i++) {
+      bytes += tc->lists[i].count * block_size(i);
+    }
+  }
+  return bytes;
+}
+
+static void pooled_ref(void *p) {
+  pooled_refcount *r = (pooled_refcount *)p;
+  gpr_ref(&r->refs);
+}
+
+static void pooled_unref(grpc_exec_ctx *exec_ctx, void *p) {
+  pooled_refcount *r = (pooled_refcount *)p;
+  if (!gpr_unref(&r->refs)) return;
+  gpr_atm generation = gpr_atm_acq_load(&g_generation);
+  if (is_caching(generation)) {
+    /* counted on release since allocation has no exec_ctx (and the stats
+       only exist while grpc is initialized) */
+    switch ((block_origin)r->origin) {
+      case BLOCK_HIT:
+        GRPC_STATS_INC_SLICE_POOL_HITS(exec_ctx);
+        break;
+      case BLOCK_MISS:
+        GRPC_STATS_INC_SLICE_POOL_MISSES(exec_ctx);
+        break;
+      case BLOCK_UNPOOLED:
+        break;
+    }
+    int size_class = r->size_class;
+    free_list *l = &get_thread_cache(generation)->lists[size_class];
+    free_block *b = (free_block *)r;
+    b->next = l->head;
+    l->head = b;
+    if (++l->count == 2 * batch_blocks(size_class)) {
+      /* keep the most recently freed (cache hot) batch, and hand the older
+         one to the depot */
+      free_block *last_kept = l->head;
+      for (size_t i = 1; i < batch_blocks(size_class); i++) {
+        last_kept = last_kept->next;
+      }
+      free_block *batch = last_kept->next;
+      last_kept->next = NULL;
+      l->count -= batch_blocks(size_class);
+      GRPC_STATS_INC_SLICE_POOL_DEPOT_PUTS(exec_ctx);
+      depot_put(size_class, batch, generation);
+    }
+    return;
+  }
+  gpr_free(r);
+}
+
+static const grpc_slice_refcount_vtable pooled_vtable = {
+    pooled_ref, pooled_unref, grpc_slice_default_eq_impl,
+    grpc_slice_default_hash_impl};
+
+bool grpc_slice_pool_malloc(size_t length, grpc_slice *slice) {
+  if (length > block_size(NUM_SIZE_CLASSES - 1) - sizeof(pooled_refcount)) {
+    return false;
+  }
+  int size_class = 0;
+  while (block_size(size_class) < sizeof(pooled_refcount) + length) {
+    size_class++;
+  }
+  pooled_refcount *r = NULL;
+  block_origin origin = BLOCK_UNPOOLED;
+  gpr_atm generation = gpr_atm_acq_load(&g_generation);
+  if (is_caching(generation)) {
+    free_list *l = &get_thread_cache(generation)->lists[size_class];
+    if (l->head == NULL) {
+      l->head = depot_get(size_class);
+      l->count = l->head == NULL ? 0 : batch_blocks(size_class);
+    }
+    if (l->head != NULL) {
+      r = (pooled_refcount *)l->head;
+      l->head = l->head->next;
+      l->count--;
+      origin = BLOCK_HIT;
+    } else {
+      origin = BLOCK_MISS;
+    }
+  }
+  if (r == NULL) {
+    r = (pooled_refcount *)gpr_malloc(block_size(size_class));
+  }
+  gpr_ref_init(&r->refs, 1);
+  r->base.vtable = &pooled_vtable;
+  r->base.sub_refcount = &r->base;
+  r->size_class = (uint8_t)size_class;
+  r->origin = (uint8_t)origin;
+  slice->refcount = &r->base;
+  slice->data.refcounted.bytes = (uint8_t *)(r + 1);
+  slice->data.refcounted.length = length;
+  return true;
+}
+
+#else /* GPR_POSIX_SYNC */
+
+void grpc_slice_pool_init(void) {}
+
+void grpc_slice_pool_shutdown(void) {}
+
+size_t grpc_slice_pool_cached_bytes(void) { return 0; }
+
+bool grpc_slice_pool_malloc(size_t length, grpc_slice *slice) { return false; }
+
+#endif /* GPR_POSIX_SYNC */
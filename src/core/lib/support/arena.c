@@ -21,6 +21,7 @@
 #include <grpc/support/atm.h>
 #include <grpc/support/log.h>
 #include <grpc/support/useful.h>
+#include <string.h>
 
 #define ROUND_UP_TO_ALIGNMENT_SIZE(x) \
   (((x) + GPR_MAX_ALIGNMENT - 1u) & ~(GPR_MAX_ALIGNMENT - 1u))
@@ -55,6 +56,26 @@ size_t gpr_arena_destroy(gpr_arena *arena) {
   return (size_t)size;
 }
 
+size_t gpr_arena_reset(gpr_arena *arena) {
+  size_t size = (size_t)gpr_atm_no_barrier_load(&arena->size_so_far);
+  zone *z = (zone *)gpr_atm_no_barrier_load(&arena->initial_zone.next_atm);
+  while (z) {
+    zone *next_z = (zone *)gpr_atm_no_barrier_load(&z->next_atm);
+    gpr_free(z);
+    z = next_z;
+  }
+  /* memory is handed out zeroed: only what was handed out needs clearing */
+  memset(&arena->initial_zone + 1, 0,
+         GPR_MIN(size, arena->initial_zone.size_end));
+  gpr_atm_no_barrier_store(&arena->size_so_far, 0);
+  gpr_atm_no_barrier_store(&arena->initial_zone.next_atm, (gpr_atm)NULL);
+  return size;
+}
+
+size_t gpr_arena_initial_size(gpr_arena *arena) {
+  return arena->initial_zone.size_end;
+}
+
 void *gpr_arena_alloc(gpr_arena *arena, size_t size) {
   size = ROUND_UP_TO_ALIGNMENT_SIZE(size);
   size_t start =
@@ -35,5 +35,10 @@ gpr_arena *gpr_arena_create(size_t initial_size);
 void *gpr_arena_alloc(gpr_arena *arena, size_t size);
 // Destroy an arena, returning the total number of bytes allocated
 size_t gpr_arena_destroy(gpr_arena *arena);
+// Empty an arena so that it can be used again as if newly created: every
+// buffer but the first is freed. Returns the total number of bytes allocated
+size_t gpr_arena_reset(gpr_arena *arena);
+// The number of bytes in the first allocated buffer of an arena
+size_t gpr_arena_initial_size(gpr_arena *arena);
 
 #endif /* GRPC_CORE_LIB_SUPPORT_ARENA_H */
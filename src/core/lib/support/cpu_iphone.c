@@ -31,4 +31,6 @@ unsigned gpr_cpu_num_cores(void) { return 1; }
    and some code might be relying on it. */
 unsigned gpr_cpu_current_cpu(void) { return 0; }
 
+int gpr_cpu_set_affinity(unsigned cpu) { return 0; }
+
 #endif /* GPR_CPU_IPHONE */
@@ -65,4 +65,16 @@ unsigned gpr_cpu_current_cpu(void) {
 #endif
 }
 
+int gpr_cpu_set_affinity(unsigned cpu) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+    gpr_log(GPR_ERROR, "Error binding thread to CPU %u: %s", cpu,
+            strerror(errno));
+    return 0;
+  }
+  return 1;
+}
+
 #endif /* GPR_CPU_LINUX */
@@ -54,4 +54,6 @@ unsigned gpr_cpu_current_cpu(void) {
   return (unsigned)GPR_HASH_POINTER(&magic_thread_local, gpr_cpu_num_cores());
 }
 
+int gpr_cpu_set_affinity(unsigned cpu) { return 0; }
+
 #endif /* GPR_CPU_POSIX */
@@ -29,4 +29,9 @@ unsigned gpr_cpu_num_cores(void) {
 
 unsigned gpr_cpu_current_cpu(void) { return GetCurrentProcessorNumber(); }
 
+int gpr_cpu_set_affinity(unsigned cpu) {
+  if (cpu >= sizeof(DWORD_PTR) * 8) return 0;
+  return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) != 0;
+}
+
 #endif /* GPR_WINDOWS */
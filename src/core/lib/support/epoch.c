@@ -0,0 +1,179 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/lib/support/epoch.h"
+
+#include <string.h>
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+#include <grpc/support/tls.h>
+#include <grpc/support/useful.h>
+
+/* A global epoch counter only advances once every thread inside a critical
+   section has observed its current value. Something retired while the
+   counter read e can still be seen by readers that entered during e - 1 or
+   e, so it is freed once the counter reaches e + 2.
+
+   Each thread announces the epoch it read in a slot of its own; a thread
+   claims a slot the first time it enters and gives it back when it exits,
+   which needs pthreads. */
+
+/* readers tracked at once: threads beyond this take the locked path */
+#define MAX_SLOTS 256
+/* objects retired into a limbo between its attempts to advance the epoch */
+#define RECLAIM_THRESHOLD 8
+
+typedef struct {
+  gpr_atm in_use;
+  /* epoch observed by the thread in its critical section, or 0 outside */
+  gpr_atm epoch;
+  char padding[GPR_CACHELINE_SIZE - 2 * sizeof(gpr_atm)];
+} slot;
+
+static gpr_atm g_epoch = 1;
+static slot g_slots[MAX_SLOTS];
+/* slots ever claimed: the rest never need to be scanned */
+static gpr_atm g_num_slots;
+
+#ifdef GPR_POSIX_SYNC
+
+#include <pthread.h>
+
+static gpr_once g_once = GPR_ONCE_INIT;
+/* index of the calling thread's slot, plus one */
+GPR_TLS_DECL(g_slot_idx);
+static pthread_key_t g_slot_key;
+
+static void release_slot(void *arg) {
+  slot *s = &g_slots[(intptr_t)arg - 1];
+  gpr_atm_rel_store(&s->epoch, 0);
+  gpr_atm_rel_store(&s->in_use, 0);
+}
+
+static void do_init(void) {
+  gpr_tls_init(&g_slot_idx);
+  GPR_ASSERT(pthread_key_create(&g_slot_key, release_slot) == 0);
+}
+
+static intptr_t claim_slot(void) {
+  for (intptr_t i = 0; i < MAX_SLOTS; i++) {
+    slot *s = &g_slots[i];
+    if (gpr_atm_no_barrier_load(&s->in_use) == 0 &&
+        gpr_atm_acq_cas(&s->in_use, 0, 1)) {
+      gpr_atm n = gpr_atm_no_barrier_load(&g_num_slots);
+      while (n <= i && !gpr_atm_rel_cas(&g_num_slots, n, i + 1)) {
+        n = gpr_atm_no_barrier_load(&g_num_slots);
+      }
+      gpr_tls_set(&g_slot_idx, i + 1);
+      GPR_ASSERT(pthread_setspecific(g_slot_key, (void *)(i + 1)) == 0);
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+bool gpr_epoch_enter(void) {
+  gpr_once_init(&g_once, do_init);
+  intptr_t idx = gpr_tls_get(&g_slot_idx);
+  if (idx == 0) {
+    idx = claim_slot();
+    if (idx == 0) return false;
+  }
+  slot *s = &g_slots[idx - 1];
+  gpr_atm epoch = gpr_atm_acq_load(&g_epoch);
+  for (;;) {
+    /* the announcement must be visible before anything the critical section
+       reads, and before we confirm the epoch it names is still current */
+    gpr_atm_full_xchg(&s->epoch, epoch);
+    gpr_atm current = gpr_atm_acq_load(&g_epoch);
+    if (current == epoch) return true;
+    epoch = current;
+  }
+}
+
+void gpr_epoch_exit(void) {
+  slot *s = &g_slots[gpr_tls_get(&g_slot_idx) - 1];
+  gpr_atm_rel_store(&s->epoch, 0);
+}
+
+#else /* GPR_POSIX_SYNC */
+
+bool gpr_epoch_enter(void) { return false; }
+
+void gpr_epoch_exit(void) {}
+
+#endif /* GPR_POSIX_SYNC */
+
+/* advance the global epoch if every reader has caught up with it; returns
+   the (possibly new) current epoch */
+static gpr_atm try_advance(void) {
+  gpr_atm epoch = gpr_atm_acq_load(&g_epoch);
+  gpr_atm num_slots = gpr_atm_acq_load(&g_num_slots);
+  for (gpr_atm i = 0; i < num_slots; i++) {
+    gpr_atm e = gpr_atm_acq_load(&g_slots[i].epoch);
+    if (e != 0 && e != epoch) return epoch;
+  }
+  if (gpr_atm_full_cas(&g_epoch, epoch, epoch + 1)) return epoch + 1;
+  return gpr_atm_acq_load(&g_epoch);
+}
+
+static void free_list(gpr_epoch_limbo *limbo, size_t i) {
+  for (size_t j = 0; j < limbo->lists[i].count; j++) {
+    gpr_free(limbo->lists[i].ptrs[j]);
+  }
+  limbo->lists[i].count = 0;
+}
+
+void gpr_epoch_limbo_init(gpr_epoch_limbo *limbo) {
+  memset(limbo, 0, sizeof(*limbo));
+}
+
+void gpr_epoch_retire(gpr_epoch_limbo *limbo, void *p) {
+  /* order the caller's unlinking of p before reading the epoch */
+  gpr_atm_full_barrier();
+  gpr_atm epoch = gpr_atm_acq_load(&g_epoch);
+  if (++limbo->retired_since_advance == RECLAIM_THRESHOLD) {
+    limbo->retired_since_advance = 0;
+    epoch = try_advance();
+    for (size_t i = 0; i < GPR_ARRAY_SIZE(limbo->lists); i++) {
+      if (limbo->lists[i].epoch + 2 <= epoch) free_list(limbo, i);
+    }
+  }
+  size_t i = (size_t)epoch % GPR_ARRAY_SIZE(limbo->lists);
+  if (limbo->lists[i].epoch != epoch) {
+    /* the list holds objects retired at least three epochs ago */
+    free_list(limbo, i);
+    limbo->lists[i].epoch = epoch;
+  }
+  if (limbo->lists[i].count == limbo->lists[i].capacity) {
+    limbo->lists[i].capacity =
+        GPR_MAX(2 * limbo->lists[i].capacity, RECLAIM_THRESHOLD);
+    limbo->lists[i].ptrs = (void **)gpr_realloc(
+        limbo->lists[i].ptrs, limbo->lists[i].capacity * sizeof(void *));
+  }
+  limbo->lists[i].ptrs[limbo->lists[i].count++] = p;
+}
+
+void gpr_epoch_limbo_destroy(gpr_epoch_limbo *limbo) {
+  for (size_t i = 0; i < GPR_ARRAY_SIZE(limbo->lists); i++) {
+    free_list(limbo, i);
+    gpr_free(limbo->lists[i].ptrs);
+  }
+}
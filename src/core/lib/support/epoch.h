@@ -0,0 +1,58 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_LIB_SUPPORT_EPOCH_H
+#define GRPC_CORE_LIB_SUPPORT_EPOCH_H
+
+#include <grpc/support/atm.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Epoch based reclamation: lets readers walk a shared structure without taking
+// its lock, while writers (which still synchronize among themselves) defer
+// freeing what they unlink until no reader can still be looking at it.
+
+// Objects retired by writers, waiting to be freed. Not thread safe: the
+// caller must protect each limbo with the lock its writers already hold.
+typedef struct gpr_epoch_limbo {
+  struct {
+    gpr_atm epoch;
+    void **ptrs;
+    size_t count;
+    size_t capacity;
+  } lists[3];
+  size_t retired_since_advance;
+} gpr_epoch_limbo;
+
+// Begin a read side critical section on the calling thread. Returns false if
+// lock free reads are unavailable (unsupported platform, or too many threads)
+// in which case the caller must take its locked path instead. Critical
+// sections do not nest, and should be short: they hold up reclamation for
+// every limbo in the process.
+bool gpr_epoch_enter(void);
+// End the critical section begun by a successful gpr_epoch_enter
+void gpr_epoch_exit(void);
+
+void gpr_epoch_limbo_init(gpr_epoch_limbo *limbo);
+// Hand \a p, already unreachable for new readers, to the limbo: it is
+// gpr_free'd once every reader that might have seen it has left
+void gpr_epoch_retire(gpr_epoch_limbo *limbo, void *p);
+// Free everything in the limbo: there must be no concurrent readers
+void gpr_epoch_limbo_destroy(gpr_epoch_limbo *limbo);
+
+#endif /* GRPC_CORE_LIB_SUPPORT_EPOCH_H */
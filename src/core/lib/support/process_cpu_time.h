@@ -0,0 +1,31 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_LIB_SUPPORT_PROCESS_CPU_TIME_H
+#define GRPC_CORE_LIB_SUPPORT_PROCESS_CPU_TIME_H
+
+#include <stdbool.h>
+
+#include <grpc/support/time.h>
+
+/** Stores in \a cpu_time the user plus system CPU time used so far by all the
+ * threads of the process, as a GPR_TIMESPAN. Returns false if the platform
+ * can't tell. */
+bool gpr_process_cpu_time(gpr_timespec *cpu_time);
+
+#endif /* GRPC_CORE_LIB_SUPPORT_PROCESS_CPU_TIME_H */
@@ -17,11 +17,13 @@
  */
 
 #include <grpc/support/port_platform.h>
+#include "src/core/lib/support/process_cpu_time.h"
 #include "src/core/lib/support/time_precise.h"
 
 #ifdef GPR_POSIX_TIME
 
 #include <stdlib.h>
+#include <sys/resource.h>
 #include <time.h>
 #include <unistd.h>
 #ifdef __linux__
@@ -166,4 +168,19 @@ void gpr_sleep_until(gpr_timespec until) {
   }
 }
 
+bool gpr_process_cpu_time(gpr_timespec *cpu_time) {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return false;
+  *cpu_time = gpr_time_add(
+      gpr_time_from_micros(
+          (int64_t)usage.ru_utime.tv_sec * GPR_US_PER_SEC +
+              usage.ru_utime.tv_usec,
+          GPR_TIMESPAN),
+      gpr_time_from_micros(
+          (int64_t)usage.ru_stime.tv_sec * GPR_US_PER_SEC +
+              usage.ru_stime.tv_usec,
+          GPR_TIMESPAN));
+  return true;
+}
+
 #endif /* GPR_POSIX_TIME */
@@ -29,6 +29,7 @@
 #include <sys/timeb.h>
 
 #include "src/core/lib/support/block_annotate.h"
+#include "src/core/lib/support/process_cpu_time.h"
 #include "src/core/lib/support/time_precise.h"
 
 static LARGE_INTEGER g_start_time;
@@ -98,4 +99,24 @@ void gpr_sleep_until(gpr_timespec until) {
   }
 }
 
+/* FILETIMEs count 100 nanosecond intervals. */
+static int64_t filetime_to_nanos(const FILETIME *ft) {
+  ULARGE_INTEGER value;
+  value.LowPart = ft->dwLowDateTime;
+  value.HighPart = ft->dwHighDateTime;
+  return (int64_t)value.QuadPart * 100;
+}
+
+bool gpr_process_cpu_time(gpr_timespec *cpu_time) {
+  FILETIME creation_time, exit_time, kernel_time, user_time;
+  if (!GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time,
+                       &kernel_time, &user_time)) {
+    return false;
+  }
+  *cpu_time = gpr_time_from_nanos(
+      filetime_to_nanos(&kernel_time) + filetime_to_nanos(&user_time),
+      GPR_TIMESPAN);
+  return true;
+}
+
 #endif /* GPR_WINDOWS_TIME */
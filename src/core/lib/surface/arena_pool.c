@@ -0,0 +1,287 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/lib/surface/arena_pool.h"
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/atm.h>
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+#include <grpc/support/tls.h>
+
+#include "src/core/lib/debug/stats.h"
+
+/* Each thread keeps a few reset arenas per size class (powers of two from
+   1KB to 64KB); a call created on the thread takes the smallest cached arena
+   that fits its size estimate, and the arena goes back to the cache of the
+   thread that releases the call. Arenas outside the size classes, or
+   released to a full cache, are freed.
+
+   Cached memory is charged to a process wide resource quota, whose size
+   bounds what all the thread caches retain together. Each thread reserves
+   quota in chunks as its cache grows and returns it as the cache shrinks,
+   so the quota is not touched on every call.
+
+   As with the slice pool, thread caches are released by a pthread key
+   destructor; elsewhere the pool passes straight through to gpr_arena. */
+
+#ifdef GPR_POSIX_SYNC
+
+#include <pthread.h>
+
+/* size classes are powers of two from 1KB to 64KB */
+#define MIN_ARENA_SHIFT 10
+#define NUM_SIZE_CLASSES 7
+/* arenas cached per size class by each thread */
+#define MAX_CACHED_ARENAS 4
+/* quota reserved or returned by a thread at a time: fits any cached arena */
+#define RESERVATION_BYTES (64 * 1024)
+/* initial size of the pool's quota */
+#define DEFAULT_MAX_RETAINED_BYTES (4 * 1024 * 1024)
+
+typedef struct {
+  gpr_arena *arenas[MAX_CACHED_ARENAS];
+  size_t count;
+} arena_list;
+
+typedef struct {
+  /* the pool generation the cache belongs to */
+  gpr_atm generation;
+  arena_list lists[NUM_SIZE_CLASSES];
+  size_t cached_bytes;
+  /* quota reserved on this thread's behalf: at least cached_bytes */
+  size_t reserved_bytes;
+} thread_cache;
+
+static gpr_once g_once = GPR_ONCE_INIT;
+/* bumped by grpc_arena_pool_init and grpc_arena_pool_shutdown: odd while the
+   pool is caching */
+static gpr_atm g_generation;
+GPR_TLS_DECL(g_thread_cache);
+static pthread_key_t g_thread_cache_key;
+/* guards the quota, and generation changes */
+static gpr_mu g_mu;
+static grpc_resource_quota *g_resource_quota;
+static grpc_resource_user *g_resource_user;
+/* total quota reserved by all threads */
+static size_t g_reserved_bytes;
+
+static size_t arena_size(int size_class) {
+  return (size_t)1 << (MIN_ARENA_SHIFT + size_class);
+}
+
+static bool is_caching(gpr_atm generation) { return (generation & 1) != 0; }
+
+/* reserve quota for RESERVATION_BYTES more cached bytes, unless that would
+   exceed the quota or the pool has been shut down */
+static bool reserve(grpc_exec_ctx *exec_ctx, thread_cache *tc) {
+  bool reserved = false;
+  gpr_mu_lock(&g_mu);
+  if (tc->generation == gpr_atm_no_barrier_load(&g_generation) &&
+      g_reserved_bytes + RESERVATION_BYTES <=
+          grpc_resource_quota_peek_size(g_resource_quota)) {
+    g_reserved_bytes += RESERVATION_BYTES;
+    grpc_resource_user_alloc(exec_ctx, g_resource_user, RESERVATION_BYTES,
+                             NULL);
+    tc->reserved_bytes += RESERVATION_BYTES;
+    reserved = true;
+  }
+  gpr_mu_unlock(&g_mu);
+  return reserved;
+}
+
+static void unreserve(grpc_exec_ctx *exec_ctx, thread_cache *tc,
+                      size_t bytes) {
+  gpr_mu_lock(&g_mu);
+  /* after shutdown the reservation went away with the quota */
+  if (tc->generation == gpr_atm_no_barrier_load(&g_generation)) {
+    g_reserved_bytes -= bytes;
+    grpc_resource_user_free(exec_ctx, g_resource_user, bytes);
+  }
+  gpr_mu_unlock(&g_mu);
+  tc->reserved_bytes -= bytes;
+}
+
+static void flush_thread_cache(thread_cache *tc) {
+  for (int i = 0; i < NUM_SIZE_CLASSES; i++) {
+    for (size_t j = 0; j < tc->lists[i].count; j++) {
+      gpr_arena_destroy(tc->lists[i].arenas[j]);
+    }
+    tc->lists[i].count = 0;
+  }
+  tc->cached_bytes = 0;
+}
+
+static void destroy_thread_cache(void *arg) {
+  thread_cache *tc = (thread_cache *)arg;
+  flush_thread_cache(tc);
+  if (tc->reserved_bytes > 0) {
+    grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+    unreserve(&exec_ctx, tc, tc->reserved_bytes);
+    grpc_exec_ctx_finish(&exec_ctx);
+  }
+  gpr_free(tc);
+}
+
+/* the calling thread's cache, emptied first if it belongs to an earlier
+   generation of the pool */
+static thread_cache *get_thread_cache(gpr_atm generation) {
+  thread_cache *tc = (thread_cache *)gpr_tls_get(&g_thread_cache);
+  if (tc == NULL) {
+    tc = (thread_cache *)gpr_zalloc(sizeof(*tc));
+    tc->generation = generation;
+    gpr_tls_set(&g_thread_cache, (intptr_t)tc);
+    GPR_ASSERT(pthread_setspecific(g_thread_cache_key, tc) == 0);
+  } else if (tc->generation != generation) {
+    flush_thread_cache(tc);
+    tc->reserved_bytes = 0;
+    tc->generation = generation;
+  }
+  return tc;
+}
+
+static void do_init(void) {
+  gpr_mu_init(&g_mu);
+  gpr_tls_init(&g_thread_cache);
+  GPR_ASSERT(pthread_key_create(&g_thread_cache_key, destroy_thread_cache) ==
+             0);
+}
+
+void grpc_arena_pool_init(void) {
+  gpr_once_init(&g_once, do_init);
+  gpr_mu_lock(&g_mu);
+  g_resource_quota = grpc_resource_quota_create("call_arena_pool");
+  grpc_resource_quota_resize(g_resource_quota, DEFAULT_MAX_RETAINED_BYTES);
+  g_resource_user = grpc_resource_user_create(g_resource_quota, "cached");
+  GPR_ASSERT(is_caching(gpr_atm_full_fetch_add(&g_generation, 1) + 1));
+  gpr_mu_unlock(&g_mu);
+}
+
+void grpc_arena_pool_shutdown(grpc_exec_ctx *exec_ctx) {
+  gpr_mu_lock(&g_mu);
+  GPR_ASSERT(!is_caching(gpr_atm_full_fetch_add(&g_generation, 1) + 1));
+  if (g_reserved_bytes > 0) {
+    grpc_resource_user_free(exec_ctx, g_resource_user, g_reserved_bytes);
+    g_reserved_bytes = 0;
+  }
+  grpc_resource_user_shutdown(exec_ctx, g_resource_user);
+  grpc_resource_user_unref(exec_ctx, g_resource_user);
+  grpc_resource_quota_unref_internal(exec_ctx, g_resource_quota);
+  g_resource_user = NULL;
+  g_resource_quota = NULL;
+  gpr_mu_unlock(&g_mu);
+  thread_cache *tc = (thread_cache *)gpr_tls_get(&g_thread_cache);
+  if (tc != NULL) {
+    gpr_tls_set(&g_thread_cache, 0);
+    GPR_ASSERT(pthread_setspecific(g_thread_cache_key, NULL) == 0);
+    destroy_thread_cache(tc);
+  }
+}
+
+size_t grpc_arena_pool_cached_bytes(void) {
+  gpr_once_init(&g_once, do_init);
+  thread_cache *tc = (thread_cache *)gpr_tls_get(&g_thread_cache);
+  if (tc == NULL || tc->generation != gpr_atm_acq_load(&g_generation)) {
+    return 0;
+  }
+  return tc->cached_bytes;
+}
+
+grpc_resource_quota *grpc_arena_pool_resource_quota(void) {
+  gpr_once_init(&g_once, do_init);
+  gpr_mu_lock(&g_mu);
+  grpc_resource_quota *resource_quota = g_resource_quota;
+  gpr_mu_unlock(&g_mu);
+  return resource_quota;
+}
+
+gpr_arena *grpc_arena_pool_create(grpc_exec_ctx *exec_ctx,
+                                  size_t initial_size) {
+  if (initial_size > arena_size(NUM_SIZE_CLASSES - 1)) {
+    return gpr_arena_create(initial_size);
+  }
+  int size_class = 0;
+  while (arena_size(size_class) < initial_size) {
+    size_class++;
+  }
+  gpr_atm generation = gpr_atm_acq_load(&g_generation);
+  if (is_caching(generation)) {
+    thread_cache *tc = get_thread_cache(generation);
+    /* a larger arena beats a fresh allocation */
+    for (int i = size_class; i < NUM_SIZE_CLASSES; i++) {
+      arena_list *l = &tc->lists[i];
+      if (l->count > 0) {
+        GRPC_STATS_INC_CALL_ARENA_POOL_HITS(exec_ctx);
+        tc->cached_bytes -= arena_size(i);
+        /* hold on to one chunk of slack so that a thread alternating
+           between creating and releasing calls keeps its reservation */
+        if (tc->reserved_bytes - tc->cached_bytes >= 2 * RESERVATION_BYTES) {
+          unreserve(exec_ctx, tc, RESERVATION_BYTES);
+        }
+        return l->arenas[--l->count];
+      }
+    }
+    GRPC_STATS_INC_CALL_ARENA_POOL_MISSES(exec_ctx);
+  }
+  return gpr_arena_create(arena_size(size_class));
+}
+
+size_t grpc_arena_pool_destroy(grpc_exec_ctx *exec_ctx, gpr_arena *arena) {
+  gpr_atm generation = gpr_atm_acq_load(&g_generation);
+  if (is_caching(generation)) {
+    size_t size = gpr_arena_initial_size(arena);
+    int size_class = 0;
+    while (size_class < NUM_SIZE_CLASSES && arena_size(size_class) < size) {
+      size_class++;
+    }
+    if (size_class < NUM_SIZE_CLASSES && arena_size(size_class) == size) {
+      thread_cache *tc = get_thread_cache(generation);
+      arena_list *l = &tc->lists[size_class];
+      if (l->count < MAX_CACHED_ARENAS &&
+          (tc->cached_bytes + size <= tc->reserved_bytes ||
+           reserve(exec_ctx, tc))) {
+        size_t allocated = gpr_arena_reset(arena);
+        l->arenas[l->count++] = arena;
+        tc->cached_bytes += size;
+        return allocated;
+      }
+    }
+  }
+  return gpr_arena_destroy(arena);
+}
+
+#else /* GPR_POSIX_SYNC */
+
+void grpc_arena_pool_init(void) {}
+
+void grpc_arena_pool_shutdown(grpc_exec_ctx *exec_ctx) {}
+
+size_t grpc_arena_pool_cached_bytes(void) { return 0; }
+
+grpc_resource_quota *grpc_arena_pool_resource_quota(void) { return NULL; }
+
+gpr_arena *grpc_arena_pool_create(grpc_exec_ctx *exec_ctx,
+                                  size_t initial_size) {
+  return gpr_arena_create(initial_size);
+}
+
+size_t grpc_arena_pool_destroy(grpc_exec_ctx *exec_ctx, gpr_arena *arena) {
+  return gpr_arena_destroy(arena);
+}
+
+#endif /* GPR_POSIX_SYNC */
@@ -0,0 +1,48 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_LIB_SURFACE_ARENA_POOL_H
+#define GRPC_CORE_LIB_SURFACE_ARENA_POOL_H
+
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/iomgr/resource_quota.h"
+#include "src/core/lib/support/arena.h"
+
+/** Recycles call arenas: arenas released to the pool are reset and kept by
+    the releasing thread for the next call it creates, instead of being
+    freed. */
+
+void grpc_arena_pool_init(void);
+void grpc_arena_pool_shutdown(grpc_exec_ctx *exec_ctx);
+
+/** Create an arena of at least \a initial_size bytes, reusing a cached one
+    if possible */
+gpr_arena *grpc_arena_pool_create(grpc_exec_ctx *exec_ctx,
+                                  size_t initial_size);
+/** Release an arena to the pool, returning the total number of bytes that
+    were allocated from it (as gpr_arena_destroy does) */
+size_t grpc_arena_pool_destroy(grpc_exec_ctx *exec_ctx, gpr_arena *arena);
+
+/** Bytes cached by the calling thread; for tests */
+size_t grpc_arena_pool_cached_bytes(void);
+/** The quota the pool's cached memory is charged to. Its size bounds the
+    memory the pool retains across all threads; NULL if grpc is not
+    initialized */
+grpc_resource_quota *grpc_arena_pool_resource_quota(void);
+
+#endif /* GRPC_CORE_LIB_SURFACE_ARENA_POOL_H */
@@ -40,6 +40,7 @@
 #include "src/core/lib/support/arena.h"
 #include "src/core/lib/support/string.h"
 #include "src/core/lib/surface/api_trace.h"
+#include "src/core/lib/surface/arena_pool.h"
 #include "src/core/lib/surface/call.h"
 #include "src/core/lib/surface/channel.h"
 #include "src/core/lib/surface/completion_queue.h"
@@ -332,7 +333,7 @@ grpc_error *grpc_call_create(grpc_exec_ctx *exec_ctx,
   GPR_TIMER_BEGIN("grpc_call_create", 0);
   size_t initial_size = grpc_channel_get_call_size_estimate(args->channel);
   GRPC_STATS_INC_CALL_INITIAL_SIZE(exec_ctx, initial_size);
-  gpr_arena *arena = gpr_arena_create(initial_size);
+  gpr_arena *arena = grpc_arena_pool_create(exec_ctx, initial_size);
   call = (grpc_call *)gpr_arena_alloc(
       arena, sizeof(grpc_call) + channel_stack->call_stack_size);
   gpr_ref_init(&call->ext_ref, 1);
@@ -516,7 +517,8 @@ static void release_call(grpc_exec_ctx *exec_ctx, void *call,
   grpc_channel *channel = c->channel;
   grpc_call_combiner_destroy(&c->call_combiner);
   gpr_free((char *)c->peer_string);
-  grpc_channel_update_call_size_estimate(channel, gpr_arena_destroy(c->arena));
+  grpc_channel_update_call_size_estimate(
+      channel, grpc_arena_pool_destroy(exec_ctx, c->arena));
   GRPC_CHANNEL_INTERNAL_UNREF(exec_ctx, channel, "call");
 }
 
@@ -18,6 +18,7 @@
 
 #include "src/core/lib/surface/channel.h"
 
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -34,6 +35,7 @@
 #include "src/core/lib/surface/api_trace.h"
 #include "src/core/lib/surface/call.h"
 #include "src/core/lib/surface/channel_init.h"
+#include "src/core/lib/surface/completion_queue.h"
 #include "src/core/lib/transport/static_metadata.h"
 
 /** Cache grpc-status: X mdelems for X = 0..NUM_CACHED_STATUS_ELEMS.
@@ -56,6 +58,9 @@ struct grpc_channel {
 
   gpr_atm call_size_estimate;
 
+  /* GRPC_ARG_BUSY_POLL_US, applied to the completion queues of our calls */
+  int busy_poll_us;
+
   gpr_mu registered_call_mu;
   registered_call *registered_calls;
 
@@ -190,6 +195,9 @@ grpc_channel *grpc_channel_create_with_builder(
           .enabled_stream_compression_algorithms_bitset =
           (uint32_t)args->args[i].value.integer |
           0x1; /* always support no compression */
+    } else if (0 == strcmp(args->args[i].key, GRPC_ARG_BUSY_POLL_US)) {
+      channel->busy_poll_us = grpc_channel_arg_get_integer(
+          &args->args[i], (grpc_integer_options){0, 0, INT_MAX});
     }
   }
 
@@ -272,6 +280,10 @@ static grpc_call *grpc_channel_create_call_internal(
   GPR_ASSERT(channel->is_client);
   GPR_ASSERT(!(cq != NULL && pollset_set_alternative != NULL));
 
+  if (cq != NULL && channel->busy_poll_us > 0) {
+    grpc_cq_enable_busy_poll(cq, channel->busy_poll_us);
+  }
+
   send_metadata[num_metadata++] = path_mdelem;
   if (!GRPC_MDISNULL(authority_mdelem)) {
     send_metadata[num_metadata++] = authority_mdelem;
@@ -24,9 +24,11 @@
 #include <grpc/support/atm.h>
 #include <grpc/support/log.h>
 #include <grpc/support/string_util.h>
+#include <grpc/support/thd.h>
 #include <grpc/support/time.h>
 
 #include "src/core/lib/debug/stats.h"
+#include "src/core/lib/iomgr/executor.h"
 #include "src/core/lib/iomgr/pollset.h"
 #include "src/core/lib/iomgr/timer.h"
 #include "src/core/lib/profiling/timers.h"
@@ -195,7 +197,8 @@ static const cq_poller_vtable g_poller_vtable_by_poller_type[] = {
 typedef struct cq_vtable {
   grpc_cq_completion_type cq_completion_type;
   size_t data_size;
-  void (*init)(void *data);
+  void (*init)(void *data,
+               grpc_experimental_completion_queue_functor *shutdown_callback);
   void (*shutdown)(grpc_exec_ctx *exec_ctx, grpc_completion_queue *cq);
   void (*destroy)(void *data);
   bool (*begin_op)(grpc_completion_queue *cq, void *tag);
@@ -204,21 +207,44 @@ typedef struct cq_vtable {
                  void (*done)(grpc_exec_ctx *exec_ctx, void *done_arg,
                               grpc_cq_completion *storage),
                  void *done_arg, grpc_cq_completion *storage);
-  grpc_event (*next)(grpc_completion_queue *cq, gpr_timespec deadline,
-                     void *reserved);
+  size_t (*next)(grpc_completion_queue *cq, grpc_event *events,
+                 size_t max_events, gpr_timespec deadline);
   grpc_event (*pluck)(grpc_completion_queue *cq, void *tag,
                       gpr_timespec deadline, void *reserved);
 } cq_vtable;
 
-/* Queue that holds the cq_completion_events. Internally uses gpr_mpscq queue
- * (a lockfree multiproducer single consumer queue). It uses a queue_lock
- * to support multiple consumers.
+/* Number of slots in the event queue's ring (must be a power of two) */
+#define CQ_EVENT_RING_SIZE 512
+
+typedef struct cq_event_cell {
+  /* Which lap of the ring this cell is on, and whether it is full: pos when
+     empty and awaiting the push of position pos, pos + 1 once that push has
+     been published */
+  gpr_atm sequence;
+  grpc_cq_completion *completion;
+} cq_event_cell;
+
+/* Queue that holds the cq_completion_events. It is a lockfree multiproducer
+ * multiconsumer queue: a bounded ring of cells with sequence numbers (from
+ * Dmitry Vyukov's bounded MPMC queue), so that concurrent Next() callers
+ * never serialize on a lock. Should the ring fill up, completions spill into
+ * an unbounded gpr_mpscq overflow list whose consumers are serialized by a
+ * spinlock; producers keep using the overflow list until it drains so that
+ * events are (approximately) dequeued in the order they were queued.
  * Only used in completion queues whose completion_type is GRPC_CQ_NEXT */
 typedef struct grpc_cq_event_queue {
-  /* Spinlock to serialize consumers i.e pop() operations */
-  gpr_spinlock queue_lock;
+  gpr_atm enqueue_pos;
+  char padding_enqueue[GPR_CACHELINE_SIZE];
+  gpr_atm dequeue_pos;
+  char padding_dequeue[GPR_CACHELINE_SIZE];
 
-  gpr_mpscq queue;
+  cq_event_cell ring[CQ_EVENT_RING_SIZE];
+
+  /* Number of completions pushed onto the overflow list and not yet popped */
+  gpr_atm num_overflow_items;
+  /* Spinlock to serialize overflow consumers i.e gpr_mpscq_pop() calls */
+  gpr_spinlock overflow_lock;
+  gpr_mpscq overflow;
 
   /* A lazy counter of number of items in the queue. This is NOT atomically
      incremented/decremented along with push/pop operations and hence is only
@@ -237,6 +263,11 @@ typedef struct cq_next_data {
   /* Number of outstanding events (+1 if not shut down) */
   gpr_atm pending_events;
 
+  /** Number of threads blocked (or about to block) in the pollset on behalf of
+      grpc_completion_queue_next. Producers only kick the pollset when this is
+      non-zero */
+  gpr_atm num_waiters;
+
   /** 0 initially. 1 once we initiated shutdown */
   bool shutdown_called;
 } cq_next_data;
@@ -266,6 +297,21 @@ typedef struct cq_pluck_data {
   plucker pluckers[GRPC_MAX_COMPLETION_QUEUE_PLUCKERS];
 } cq_pluck_data;
 
+typedef struct cq_callback_data {
+  /** Number of pending events (+1 if we're not shutdown) */
+  gpr_atm pending_events;
+
+  /** 0 initially. 1 once we initiated shutdown */
+  bool shutdown_called;
+
+  /** Set (under the cq lock) once shutdown has finished, to stop the poller
+      thread */
+  bool poller_done;
+
+  /** Invoked by the poller thread as it exits (may be NULL) */
+  grpc_experimental_completion_queue_functor *shutdown_callback;
+} cq_callback_data;
+
 /* Completion queue structure */
 struct grpc_completion_queue {
   /** Once owning_refs drops to zero, we will destroy the cq */
@@ -284,6 +330,12 @@ struct grpc_completion_queue {
 
   grpc_closure pollset_shutdown_done;
   int num_polls;
+
+  /** Upper bound (in microseconds) of the time grpc_completion_queue_next
+      spins on zero-timeout polls before blocking. 0 disables busy polling */
+  gpr_atm busy_poll_max_us;
+  /** The self-tuned spin window (in microseconds), at most busy_poll_max_us */
+  gpr_atm busy_poll_window_us;
 };
 
 /* Forward declarations */
@@ -295,9 +347,14 @@ static void cq_shutdown_next(grpc_exec_ctx *exec_ctx,
                              grpc_completion_queue *cq);
 static void cq_shutdown_pluck(grpc_exec_ctx *exec_ctx,
                               grpc_completion_queue *cq);
+static void cq_finish_shutdown_callback(grpc_exec_ctx *exec_ctx,
+                                        grpc_completion_queue *cq);
+static void cq_shutdown_callback(grpc_exec_ctx *exec_ctx,
+                                 grpc_completion_queue *cq);
 
 static bool cq_begin_op_for_next(grpc_completion_queue *cq, void *tag);
 static bool cq_begin_op_for_pluck(grpc_completion_queue *cq, void *tag);
+static bool cq_begin_op_for_callback(grpc_completion_queue *cq, void *tag);
 
 static void cq_end_op_for_next(grpc_exec_ctx *exec_ctx,
                                grpc_completion_queue *cq, void *tag,
@@ -315,16 +372,28 @@ static void cq_end_op_for_pluck(grpc_exec_ctx *exec_ctx,
                                              grpc_cq_completion *storage),
                                 void *done_arg, grpc_cq_completion *storage);
 
-static grpc_event cq_next(grpc_completion_queue *cq, gpr_timespec deadline,
-                          void *reserved);
+static void cq_end_op_for_callback(
+    grpc_exec_ctx *exec_ctx, grpc_completion_queue *cq, void *tag,
+    grpc_error *error,
+    void (*done)(grpc_exec_ctx *exec_ctx, void *done_arg,
+                 grpc_cq_completion *storage),
+    void *done_arg, grpc_cq_completion *storage);
+
+static size_t cq_next(grpc_completion_queue *cq, grpc_event *events,
+                      size_t max_events, gpr_timespec deadline);
 
 static grpc_event cq_pluck(grpc_completion_queue *cq, void *tag,
                            gpr_timespec deadline, void *reserved);
 
-static void cq_init_next(void *data);
-static void cq_init_pluck(void *data);
+static void cq_init_next(
+    void *data, grpc_experimental_completion_queue_functor *shutdown_callback);
+static void cq_init_pluck(
+    void *data, grpc_experimental_completion_queue_functor *shutdown_callback);
+static void cq_init_callback(
+    void *data, grpc_experimental_completion_queue_functor *shutdown_callback);
 static void cq_destroy_next(void *data);
 static void cq_destroy_pluck(void *data);
+static void cq_destroy_callback(void *data);
 
 /* Completion queue vtables based on the completion-type */
 static const cq_vtable g_cq_vtable[] = {
@@ -335,6 +404,10 @@ static const cq_vtable g_cq_vtable[] = {
     {GRPC_CQ_PLUCK, sizeof(cq_pluck_data), cq_init_pluck, cq_shutdown_pluck,
      cq_destroy_pluck, cq_begin_op_for_pluck, cq_end_op_for_pluck, NULL,
      cq_pluck},
+    /* GRPC_CQ_CALLBACK */
+    {GRPC_CQ_CALLBACK, sizeof(cq_callback_data), cq_init_callback,
+     cq_shutdown_callback, cq_destroy_callback, cq_begin_op_for_callback,
+     cq_end_op_for_callback, NULL, NULL},
 };
 
 #define DATA_FROM_CQ(cq) ((void *)(cq + 1))
@@ -359,25 +432,112 @@ static void on_pollset_shutdown_done(grpc_exec_ctx *exec_ctx, void *cq,
                                      grpc_error *error);
 
 static void cq_event_queue_init(grpc_cq_event_queue *q) {
-  gpr_mpscq_init(&q->queue);
-  q->queue_lock = GPR_SPINLOCK_INITIALIZER;
+  gpr_atm_no_barrier_store(&q->enqueue_pos, 0);
+  gpr_atm_no_barrier_store(&q->dequeue_pos, 0);
+  for (size_t i = 0; i < CQ_EVENT_RING_SIZE; i++) {
+    gpr_atm_no_barrier_store(&q->ring[i].sequence, (gpr_atm)i);
+    q->ring[i].completion = NULL;
+  }
+  gpr_atm_no_barrier_store(&q->num_overflow_items, 0);
+  q->overflow_lock = GPR_SPINLOCK_INITIALIZER;
+  gpr_mpscq_init(&q->overflow);
   gpr_atm_no_barrier_store(&q->num_queue_items, 0);
 }
 
 static void cq_event_queue_destroy(grpc_cq_event_queue *q) {
-  gpr_mpscq_destroy(&q->queue);
+  gpr_mpscq_destroy(&q->overflow);
 }
 
-static bool cq_event_queue_push(grpc_cq_event_queue *q, grpc_cq_completion *c) {
-  gpr_mpscq_push(&q->queue, (gpr_mpscq_node *)c);
-  return gpr_atm_no_barrier_fetch_add(&q->num_queue_items, 1) == 0;
+/* Wraparound-safe difference between two ring positions */
+static gpr_atm cq_event_ring_diff(gpr_atm a, gpr_atm b) {
+  return (gpr_atm)((uintptr_t)a - (uintptr_t)b);
+}
+
+/* Returns false if the ring is full */
+static bool cq_event_ring_push(grpc_cq_event_queue *q, grpc_cq_completion *c) {
+  gpr_atm pos = gpr_atm_no_barrier_load(&q->enqueue_pos);
+  cq_event_cell *cell;
+  for (;;) {
+    cell = &q->ring[(uintptr_t)pos & (CQ_EVENT_RING_SIZE - 1)];
+    gpr_atm dif = cq_event_ring_diff(gpr_atm_acq_load(&cell->sequence), pos);
+    if (dif == 0) {
+      if (gpr_atm_no_barrier_cas(&q->enqueue_pos, pos, pos + 1)) break;
+    } else if (dif < 0) {
+      return false;
+    }
+    pos = gpr_atm_no_barrier_load(&q->enqueue_pos);
+  }
+  cell->completion = c;
+  gpr_atm_rel_store(&cell->sequence, pos + 1);
+  return true;
+}
+
+/* Pops up to max completions that are published in consecutive cells, claiming
+   them all with a single CAS. Returns 0 if the ring is empty, or if the oldest
+   push into it has claimed its cell but not yet published the completion */
+static size_t cq_event_ring_pop(grpc_cq_event_queue *q,
+                                grpc_cq_completion **out, size_t max) {
+  gpr_atm pos = gpr_atm_no_barrier_load(&q->dequeue_pos);
+  size_t n;
+  for (;;) {
+    n = 0;
+    while (n < max) {
+      cq_event_cell *cell =
+          &q->ring[((uintptr_t)pos + n) & (CQ_EVENT_RING_SIZE - 1)];
+      gpr_atm dif = cq_event_ring_diff(gpr_atm_acq_load(&cell->sequence),
+                                       pos + (gpr_atm)n + 1);
+      if (dif != 0) break;
+      n++;
+    }
+    if (n == 0) {
+      gpr_atm dif = cq_event_ring_diff(
+          gpr_atm_acq_load(
+              &q->ring[(uintptr_t)pos & (CQ_EVENT_RING_SIZE - 1)].sequence),
+          pos + 1);
+      /* Either empty, or another consumer got here first */
+      if (dif < 0) return 0;
+    } else if (gpr_atm_no_barrier_cas(&q->dequeue_pos, pos,
+                                      pos + (gpr_atm)n)) {
+      break;
+    }
+    pos = gpr_atm_no_barrier_load(&q->dequeue_pos);
+  }
+  /* The cells are ours now: no other consumer can claim them, and producers
+     will not reuse them until we bump their sequence numbers to the next lap
+     */
+  for (size_t i = 0; i < n; i++) {
+    cq_event_cell *cell =
+        &q->ring[((uintptr_t)pos + i) & (CQ_EVENT_RING_SIZE - 1)];
+    out[i] = cell->completion;
+    gpr_atm_rel_store(&cell->sequence,
+                      pos + (gpr_atm)i + CQ_EVENT_RING_SIZE);
+  }
+  return n;
+}
+
+/* Returns the number of items in the queue including this one. The increment
+   of num_queue_items is a full barrier, ordering it before the caller's check
+   for waiting consumers */
+static gpr_atm cq_event_queue_push(grpc_cq_event_queue *q,
+                                   grpc_cq_completion *c) {
+  if (gpr_atm_acq_load(&q->num_overflow_items) > 0 ||
+      !cq_event_ring_push(q, c)) {
+    gpr_atm_no_barrier_fetch_add(&q->num_overflow_items, 1);
+    gpr_mpscq_push(&q->overflow, (gpr_mpscq_node *)c);
+  }
+  return gpr_atm_full_fetch_add(&q->num_queue_items, 1) + 1;
 }
 
 static grpc_cq_completion *cq_event_queue_pop(grpc_cq_event_queue *q) {
   grpc_cq_completion *c = NULL;
-  if (gpr_spinlock_trylock(&q->queue_lock)) {
-    c = (grpc_cq_completion *)gpr_mpscq_pop(&q->queue);
-    gpr_spinlock_unlock(&q->queue_lock);
+  if (cq_event_ring_pop(q, &c, 1) == 0 &&
+      gpr_atm_acq_load(&q->num_overflow_items) > 0 &&
+      gpr_spinlock_trylock(&q->overflow_lock)) {
+    c = (grpc_cq_completion *)gpr_mpscq_pop(&q->overflow);
+    gpr_spinlock_unlock(&q->overflow_lock);
+    if (c != NULL) {
+      gpr_atm_no_barrier_fetch_add(&q->num_overflow_items, -1);
+    }
   }
 
   if (c) {
@@ -387,15 +547,43 @@ static grpc_cq_completion *cq_event_queue_pop(grpc_cq_event_queue *q) {
   return c;
 }
 
+/* Pops up to max completions into out. Like cq_event_queue_pop, may come back
+   empty handed even if the queue is not empty */
+static size_t cq_event_queue_pop_batch(grpc_cq_event_queue *q,
+                                       grpc_cq_completion **out, size_t max) {
+  size_t n = cq_event_ring_pop(q, out, max);
+  if (n < max && gpr_atm_acq_load(&q->num_overflow_items) > 0 &&
+      gpr_spinlock_trylock(&q->overflow_lock)) {
+    size_t popped = 0;
+    while (n < max && (out[n] = (grpc_cq_completion *)gpr_mpscq_pop(
+                           &q->overflow)) != NULL) {
+      n++;
+      popped++;
+    }
+    gpr_spinlock_unlock(&q->overflow_lock);
+    if (popped > 0) {
+      gpr_atm_no_barrier_fetch_add(&q->num_overflow_items, -(gpr_atm)popped);
+    }
+  }
+
+  if (n > 0) {
+    gpr_atm_no_barrier_fetch_add(&q->num_queue_items, -(gpr_atm)n);
+  }
+
+  return n;
+}
+
 /* Note: The counter is not incremented/decremented atomically with push/pop.
  * The count is only eventually consistent */
 static long cq_event_queue_num_items(grpc_cq_event_queue *q) {
   return (long)gpr_atm_no_barrier_load(&q->num_queue_items);
 }
 
+static void cq_start_callback_poller(grpc_completion_queue *cq);
+
 grpc_completion_queue *grpc_completion_queue_create_internal(
-    grpc_cq_completion_type completion_type,
-    grpc_cq_polling_type polling_type) {
+    grpc_cq_completion_type completion_type, grpc_cq_polling_type polling_type,
+    grpc_experimental_completion_queue_functor *shutdown_callback) {
   grpc_completion_queue *cq;
 
   GPR_TIMER_BEGIN("grpc_completion_queue_create_internal", 0);
@@ -424,22 +612,28 @@ grpc_completion_queue *grpc_completion_queue_create_internal(
   gpr_ref_init(&cq->owning_refs, 2);
 
   poller_vtable->init(POLLSET_FROM_CQ(cq), &cq->mu);
-  vtable->init(DATA_FROM_CQ(cq));
+  vtable->init(DATA_FROM_CQ(cq), shutdown_callback);
 
   GRPC_CLOSURE_INIT(&cq->pollset_shutdown_done, on_pollset_shutdown_done, cq,
                     grpc_schedule_on_exec_ctx);
 
+  if (completion_type == GRPC_CQ_CALLBACK) {
+    cq_start_callback_poller(cq);
+  }
+
   GPR_TIMER_END("grpc_completion_queue_create_internal", 0);
 
   return cq;
 }
 
-static void cq_init_next(void *ptr) {
+static void cq_init_next(
+    void *ptr, grpc_experimental_completion_queue_functor *shutdown_callback) {
   cq_next_data *cqd = (cq_next_data *)ptr;
   /* Initial count is dropped by grpc_completion_queue_shutdown */
   gpr_atm_no_barrier_store(&cqd->pending_events, 1);
   cqd->shutdown_called = false;
   gpr_atm_no_barrier_store(&cqd->things_queued_ever, 0);
+  gpr_atm_no_barrier_store(&cqd->num_waiters, 0);
   cq_event_queue_init(&cqd->queue);
 }
 
@@ -449,7 +643,8 @@ static void cq_destroy_next(void *ptr) {
   cq_event_queue_destroy(&cqd->queue);
 }
 
-static void cq_init_pluck(void *ptr) {
+static void cq_init_pluck(
+    void *ptr, grpc_experimental_completion_queue_functor *shutdown_callback) {
   cq_pluck_data *cqd = (cq_pluck_data *)ptr;
   /* Initial count is dropped by grpc_completion_queue_shutdown */
   gpr_atm_no_barrier_store(&cqd->pending_events, 1);
@@ -466,10 +661,77 @@ static void cq_destroy_pluck(void *ptr) {
   GPR_ASSERT(cqd->completed_head.next == (uintptr_t)&cqd->completed_head);
 }
 
+static void cq_init_callback(
+    void *ptr, grpc_experimental_completion_queue_functor *shutdown_callback) {
+  cq_callback_data *cqd = (cq_callback_data *)ptr;
+  /* Initial count is dropped by grpc_completion_queue_shutdown */
+  gpr_atm_no_barrier_store(&cqd->pending_events, 1);
+  cqd->shutdown_called = false;
+  cqd->poller_done = false;
+  cqd->shutdown_callback = shutdown_callback;
+}
+
+static void cq_destroy_callback(void *ptr) {}
+
+/* Nobody calls grpc_completion_queue_next on a callback completion queue, so
+   it polls its own pollset to make I/O progress on the calls bound to it.
+   Operations completed by this thread run their functors inline on it. This
+   is the thread an application would otherwise dedicate to calling next on
+   the queue: a worker blocks in a single pollset, so queues cannot share it */
+static void cq_callback_poller(void *arg) {
+  grpc_completion_queue *cq = (grpc_completion_queue *)arg;
+  cq_callback_data *cqd = (cq_callback_data *)DATA_FROM_CQ(cq);
+  grpc_experimental_completion_queue_functor *shutdown_callback =
+      cqd->shutdown_callback;
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+
+  gpr_mu_lock(cq->mu);
+  while (!cqd->poller_done) {
+    cq->num_polls++;
+    grpc_error *err = cq->poller_vtable->work(
+        &exec_ctx, POLLSET_FROM_CQ(cq), NULL, gpr_now(GPR_CLOCK_MONOTONIC),
+        gpr_inf_future(GPR_CLOCK_MONOTONIC));
+    if (err != GRPC_ERROR_NONE) {
+      const char *msg = grpc_error_string(err);
+      gpr_log(GPR_ERROR, "Completion queue callback poller failed: %s", msg);
+      GRPC_ERROR_UNREF(err);
+    }
+    gpr_mu_unlock(cq->mu);
+    grpc_exec_ctx_flush(&exec_ctx);
+    gpr_mu_lock(cq->mu);
+  }
+  gpr_mu_unlock(cq->mu);
+
+  GRPC_CQ_INTERNAL_UNREF(&exec_ctx, cq, "callback_poller");
+  grpc_exec_ctx_finish(&exec_ctx);
+
+  /* Last, so that the application may tear down gRPC as soon as it is told
+     that the queue has shut down */
+  if (shutdown_callback != NULL) {
+    shutdown_callback->functor_run(shutdown_callback, 1);
+  }
+}
+
+static void cq_start_callback_poller(grpc_completion_queue *cq) {
+  gpr_thd_id id;
+  gpr_thd_options opt = gpr_thd_options_default();
+  GRPC_CQ_INTERNAL_REF(cq, "callback_poller");
+  GPR_ASSERT(gpr_thd_new(&id, cq_callback_poller, cq, &opt));
+}
+
 grpc_cq_completion_type grpc_get_cq_completion_type(grpc_completion_queue *cq) {
   return cq->vtable->cq_completion_type;
 }
 
+void grpc_cq_enable_busy_poll(grpc_completion_queue *cq, int max_us) {
+  if (max_us <= 0 ||
+      gpr_atm_no_barrier_load(&cq->busy_poll_max_us) == (gpr_atm)max_us) {
+    return;
+  }
+  gpr_atm_no_barrier_store(&cq->busy_poll_window_us, (gpr_atm)max_us);
+  gpr_atm_no_barrier_store(&cq->busy_poll_max_us, (gpr_atm)max_us);
+}
+
 int grpc_get_cq_poll_num(grpc_completion_queue *cq) {
   int cur_num_polls;
   gpr_mu_lock(cq->mu);
@@ -577,6 +839,11 @@ static bool cq_begin_op_for_pluck(grpc_completion_queue *cq, void *tag) {
   return atm_inc_if_nonzero(&cqd->pending_events);
 }
 
+static bool cq_begin_op_for_callback(grpc_completion_queue *cq, void *tag) {
+  cq_callback_data *cqd = (cq_callback_data *)DATA_FROM_CQ(cq);
+  return atm_inc_if_nonzero(&cqd->pending_events);
+}
+
 bool grpc_cq_begin_op(grpc_completion_queue *cq, void *tag) {
 #ifndef NDEBUG
   gpr_mu_lock(cq->mu);
@@ -629,7 +896,7 @@ static void cq_end_op_for_next(grpc_exec_ctx *exec_ctx,
   cq_check_tag(cq, tag, true); /* Used in debug builds only */
 
   /* Add the completion to the queue */
-  bool is_first = cq_event_queue_push(&cqd->queue, storage);
+  gpr_atm num_items = cq_event_queue_push(&cqd->queue, storage);
   gpr_atm_no_barrier_fetch_add(&cqd->things_queued_ever, 1);
 
   /* Since we do not hold the cq lock here, it is important to do an 'acquire'
@@ -639,8 +906,16 @@ static void cq_end_op_for_next(grpc_exec_ctx *exec_ctx,
   bool will_definitely_shutdown = gpr_atm_acq_load(&cqd->pending_events) == 1;
 
   if (!will_definitely_shutdown) {
-    /* Only kick if this is the first item queued */
-    if (is_first) {
+    /* Wake one consumer blocked in the pollset per queued event, rather than
+       only on the first event. If there are more events than waiters, every
+       waiter already has an event to pick up (and kicks on the rest when it
+       is done, at the end of cq_next), and consumers that are not blocked will
+       find the event when they next pop, so there is no need to take the cq
+       lock. This load is ordered after the full barrier increment of
+       num_queue_items in cq_event_queue_push, pairing with the num_waiters
+       increment and num_queue_items load in cq_next: either the waiter sees
+       the event, or we see the waiter */
+    if (num_items <= gpr_atm_acq_load(&cqd->num_waiters)) {
       gpr_mu_lock(cq->mu);
       grpc_error *kick_error =
           cq->poller_vtable->kick(exec_ctx, POLLSET_FROM_CQ(cq), NULL);
@@ -746,6 +1021,78 @@ static void cq_end_op_for_pluck(grpc_exec_ctx *exec_ctx,
   GRPC_ERROR_UNREF(error);
 }
 
+static void cq_run_callback(grpc_exec_ctx *exec_ctx, void *arg,
+                            grpc_error *error) {
+  grpc_cq_completion *storage = (grpc_cq_completion *)arg;
+  grpc_completion_queue *cq = (grpc_completion_queue *)storage->next;
+  cq_callback_data *cqd = (cq_callback_data *)DATA_FROM_CQ(cq);
+  grpc_experimental_completion_queue_functor *functor =
+      (grpc_experimental_completion_queue_functor *)storage->tag;
+
+  /* The closure is no longer needed once it runs, so the storage can be
+     released before the functor (which may start the next operation) */
+  storage->done(exec_ctx, storage->done_arg, storage);
+
+  functor->functor_run(functor, error == GRPC_ERROR_NONE);
+
+  /* The operation only counts as done once its functor has returned, so that
+     the shutdown callback runs after all of them */
+  if (gpr_atm_full_fetch_add(&cqd->pending_events, -1) == 1) {
+    GRPC_CQ_INTERNAL_REF(cq, "shutting_down");
+    gpr_mu_lock(cq->mu);
+    cq_finish_shutdown_callback(exec_ctx, cq);
+    gpr_mu_unlock(cq->mu);
+    GRPC_CQ_INTERNAL_UNREF(exec_ctx, cq, "shutting_down");
+  }
+}
+
+/* Complete an event on a completion queue of type GRPC_CQ_CALLBACK: rather
+   than being queued, the tag (a functor) is invoked. Inlineable functors are
+   deferred only until the current exec_ctx is flushed, which happens on this
+   same thread once it no longer holds any locks; the others are handed to the
+   executor */
+static void cq_end_op_for_callback(
+    grpc_exec_ctx *exec_ctx, grpc_completion_queue *cq, void *tag,
+    grpc_error *error,
+    void (*done)(grpc_exec_ctx *exec_ctx, void *done_arg,
+                 grpc_cq_completion *storage),
+    void *done_arg, grpc_cq_completion *storage) {
+  GPR_TIMER_BEGIN("cq_end_op_for_callback", 0);
+
+  if (GRPC_TRACER_ON(grpc_api_trace) ||
+      (GRPC_TRACER_ON(grpc_trace_operation_failures) &&
+       error != GRPC_ERROR_NONE)) {
+    const char *errmsg = grpc_error_string(error);
+    GRPC_API_TRACE(
+        "cq_end_op_for_callback(exec_ctx=%p, cq=%p, tag=%p, error=%s, "
+        "done=%p, done_arg=%p, storage=%p)",
+        7, (exec_ctx, cq, tag, errmsg, done, done_arg, storage));
+    if (GRPC_TRACER_ON(grpc_trace_operation_failures) &&
+        error != GRPC_ERROR_NONE) {
+      gpr_log(GPR_ERROR, "Operation failed: tag=%p, error=%s", tag, errmsg);
+    }
+  }
+
+  cq_check_tag(cq, tag, true); /* Used in debug builds only */
+
+  /* Nothing is queued, so the storage carries the closure that runs the
+     functor and is released once it starts */
+  grpc_experimental_completion_queue_functor *functor =
+      (grpc_experimental_completion_queue_functor *)tag;
+  storage->tag = tag;
+  storage->done = done;
+  storage->done_arg = done_arg;
+  storage->next = (uintptr_t)cq;
+  GRPC_CLOSURE_INIT(&storage->callback, cq_run_callback, storage,
+                    functor->inlineable
+                        ? grpc_schedule_on_exec_ctx
+                        : grpc_executor_scheduler(GRPC_EXECUTOR_SHORT));
+  /* The closure takes over our ref to error */
+  GRPC_CLOSURE_SCHED(exec_ctx, &storage->callback, error);
+
+  GPR_TIMER_END("cq_end_op_for_callback", 0);
+}
+
 void grpc_cq_end_op(grpc_exec_ctx *exec_ctx, grpc_completion_queue *cq,
                     void *tag, grpc_error *error,
                     void (*done)(grpc_exec_ctx *exec_ctx, void *done_arg,
@@ -813,24 +1160,125 @@ static void dump_pending_tags(grpc_completion_queue *cq) {
 static void dump_pending_tags(grpc_completion_queue *cq) {}
 #endif
 
-static grpc_event cq_next(grpc_completion_queue *cq, gpr_timespec deadline,
-                          void *reserved) {
-  grpc_event ret;
+/* Busy polling: instead of blocking in grpc_pollset_work right away, a
+   grpc_completion_queue_next caller first spins on zero-timeout polls for up
+   to busy_poll_window_us. The window is tuned the same way as KVM's halt
+   polling: it grows when a blocking poll found an event soon enough that a
+   longer spin would have caught it, and shrinks when blocking polls outlast
+   busy_poll_max_us (spinning that long would have been wasted). */
+#define BUSY_POLL_WINDOW_GROW_START_DIVISOR 8
+
+typedef struct cq_busy_poll {
+  gpr_atm max_us;
+  gpr_timespec start;
+  gpr_timespec spin_until;
+  bool spinning;
+  /** whether a zero-timeout poll was made; an event that was already queued
+      before the first one is not a busy-poll hit */
+  bool spun;
+} cq_busy_poll;
+
+static void cq_busy_poll_begin(grpc_completion_queue *cq, cq_busy_poll *bp) {
+  bp->max_us = gpr_atm_no_barrier_load(&cq->busy_poll_max_us);
+  bp->spinning = false;
+  bp->spun = false;
+  if (bp->max_us == 0) return;
+  gpr_atm window_us = gpr_atm_no_barrier_load(&cq->busy_poll_window_us);
+  bp->start = gpr_now(GPR_CLOCK_MONOTONIC);
+  bp->spin_until = gpr_time_add(
+      bp->start, gpr_time_from_micros((int64_t)window_us, GPR_TIMESPAN));
+  bp->spinning = window_us > 0;
+}
+
+/* Returns the deadline to poll with this iteration */
+static gpr_timespec cq_busy_poll_iteration_deadline(grpc_exec_ctx *exec_ctx,
+                                                    cq_busy_poll *bp,
+                                                    gpr_timespec now,
+                                                    gpr_timespec deadline) {
+  if (!bp->spinning) return deadline;
+  if (gpr_time_cmp(now, bp->spin_until) < 0) {
+    GRPC_STATS_INC_CQ_BUSY_POLL_SPINS(exec_ctx);
+    bp->spun = true;
+    return gpr_time_0(GPR_CLOCK_MONOTONIC);
+  }
+  GRPC_STATS_INC_CQ_BUSY_POLL_MISSES(exec_ctx);
+  GRPC_STATS_INC_CQ_BUSY_POLL_SPIN_US(
+      exec_ctx, gpr_timespec_to_micros(gpr_time_sub(now, bp->start)));
+  bp->spinning = false;
+  return deadline;
+}
+
+static void cq_busy_poll_end(grpc_exec_ctx *exec_ctx,
+                             grpc_completion_queue *cq, cq_busy_poll *bp,
+                             bool got_event) {
+  if (bp->max_us == 0) return;
+  gpr_timespec waited =
+      gpr_time_sub(gpr_now(GPR_CLOCK_MONOTONIC), bp->start);
+  if (got_event) {
+    GRPC_STATS_INC_CQ_BUSY_POLL_WORK_US(exec_ctx,
+                                        gpr_timespec_to_micros(waited));
+  }
+  if (bp->spinning) {
+    GRPC_STATS_INC_CQ_BUSY_POLL_SPIN_US(exec_ctx,
+                                        gpr_timespec_to_micros(waited));
+    if (got_event && bp->spun) GRPC_STATS_INC_CQ_BUSY_POLL_HITS(exec_ctx);
+    return;
+  }
+  gpr_atm window_us = gpr_atm_no_barrier_load(&cq->busy_poll_window_us);
+  if (got_event && gpr_time_cmp(waited, gpr_time_from_micros(
+                                            (int64_t)bp->max_us,
+                                            GPR_TIMESPAN)) <= 0) {
+    window_us = window_us == 0
+                    ? GPR_MAX(bp->max_us / BUSY_POLL_WINDOW_GROW_START_DIVISOR,
+                              1)
+                    : GPR_MIN(window_us * 2, bp->max_us);
+  } else {
+    window_us /= 2;
+    if (window_us < bp->max_us / BUSY_POLL_WINDOW_GROW_START_DIVISOR) {
+      window_us = 0;
+    }
+  }
+  gpr_atm_no_barrier_store(&cq->busy_poll_window_us, window_us);
+}
+
+/* Number of completions popped from the event queue at a time */
+#define CQ_POP_BATCH_SIZE 16
+
+static void cq_event_from_completion(grpc_exec_ctx *exec_ctx,
+                                     grpc_cq_completion *c, grpc_event *ev) {
+  ev->type = GRPC_OP_COMPLETE;
+  ev->success = c->next & 1u;
+  ev->tag = c->tag;
+  c->done(exec_ctx, c->done_arg, c);
+}
+
+/* Turns up to max_events completions that are ready into events */
+static size_t cq_pop_events(grpc_exec_ctx *exec_ctx, cq_next_data *cqd,
+                            grpc_event *events, size_t max_events) {
+  grpc_cq_completion *batch[CQ_POP_BATCH_SIZE];
+  size_t num_events = 0;
+  while (num_events < max_events) {
+    size_t want = GPR_MIN(max_events - num_events, CQ_POP_BATCH_SIZE);
+    size_t got = cq_event_queue_pop_batch(&cqd->queue, batch, want);
+    for (size_t i = 0; i < got; i++) {
+      cq_event_from_completion(exec_ctx, batch[i], &events[num_events++]);
+    }
+    if (got < want) break;
+  }
+  return num_events;
+}
+
+/* Blocks until at least one event is ready (or shutdown, or the deadline),
+   then returns up to max_events of them without polling again. Timeouts and
+   shutdown are reported as a single event. */
+static size_t cq_next(grpc_completion_queue *cq, grpc_event *events,
+                      size_t max_events, gpr_timespec deadline) {
+  size_t num_events = 0;
   gpr_timespec now;
   cq_next_data *cqd = (cq_next_data *)DATA_FROM_CQ(cq);
 
   GPR_TIMER_BEGIN("grpc_completion_queue_next", 0);
 
-  GRPC_API_TRACE(
-      "grpc_completion_queue_next("
-      "cq=%p, "
-      "deadline=gpr_timespec { tv_sec: %" PRId64
-      ", tv_nsec: %d, clock_type: %d }, "
-      "reserved=%p)",
-      5, (cq, deadline.tv_sec, deadline.tv_nsec, (int)deadline.clock_type,
-          reserved));
-  GPR_ASSERT(!reserved);
-
   dump_pending_tags(cq);
 
   deadline = gpr_convert_clock_type(deadline, GPR_CLOCK_MONOTONIC);
@@ -847,6 +1295,8 @@ static grpc_event cq_next(grpc_completion_queue *cq, gpr_timespec deadline,
       .first_loop = true};
   grpc_exec_ctx exec_ctx =
       GRPC_EXEC_CTX_INITIALIZER(0, cq_is_next_finished, &is_finished_arg);
+  cq_busy_poll busy_poll;
+  cq_busy_poll_begin(cq, &busy_poll);
 
   for (;;) {
     gpr_timespec iteration_deadline = deadline;
@@ -854,27 +1304,22 @@ static grpc_event cq_next(grpc_completion_queue *cq, gpr_timespec deadline,
     if (is_finished_arg.stolen_completion != NULL) {
       grpc_cq_completion *c = is_finished_arg.stolen_completion;
       is_finished_arg.stolen_completion = NULL;
-      ret.type = GRPC_OP_COMPLETE;
-      ret.success = c->next & 1u;
-      ret.tag = c->tag;
-      c->done(&exec_ctx, c->done_arg, c);
+      cq_event_from_completion(&exec_ctx, c, &events[0]);
+      num_events =
+          1 + cq_pop_events(&exec_ctx, cqd, events + 1, max_events - 1);
       break;
     }
 
-    grpc_cq_completion *c = cq_event_queue_pop(&cqd->queue);
+    num_events = cq_pop_events(&exec_ctx, cqd, events, max_events);
 
-    if (c != NULL) {
-      ret.type = GRPC_OP_COMPLETE;
-      ret.success = c->next & 1u;
-      ret.tag = c->tag;
-      c->done(&exec_ctx, c->done_arg, c);
+    if (num_events > 0) {
       break;
     } else {
-      /* If c == NULL it means either the queue is empty OR in an transient
-         inconsistent state. If it is the latter, we shold do a 0-timeout poll
-         so that the thread comes back quickly from poll to make a second
-         attempt at popping. Not doing this can potentially deadlock this
-         thread forever (if the deadline is infinity) */
+      /* If nothing was popped it means either the queue is empty OR in an
+         transient inconsistent state. If it is the latter, we shold do a
+         0-timeout poll so that the thread comes back quickly from poll to make
+         a second attempt at popping. Not doing this can potentially deadlock
+         this thread forever (if the deadline is infinity) */
       if (cq_event_queue_num_items(&cqd->queue) > 0) {
         iteration_deadline = gpr_time_0(GPR_CLOCK_MONOTONIC);
       }
@@ -892,24 +1337,37 @@ static grpc_event cq_next(grpc_completion_queue *cq, gpr_timespec deadline,
         continue;
       }
 
-      memset(&ret, 0, sizeof(ret));
-      ret.type = GRPC_QUEUE_SHUTDOWN;
+      memset(&events[0], 0, sizeof(events[0]));
+      events[0].type = GRPC_QUEUE_SHUTDOWN;
+      num_events = 1;
       break;
     }
 
     now = gpr_now(GPR_CLOCK_MONOTONIC);
     if (!is_finished_arg.first_loop && gpr_time_cmp(now, deadline) >= 0) {
-      memset(&ret, 0, sizeof(ret));
-      ret.type = GRPC_QUEUE_TIMEOUT;
+      memset(&events[0], 0, sizeof(events[0]));
+      events[0].type = GRPC_QUEUE_TIMEOUT;
+      num_events = 1;
       dump_pending_tags(cq);
       break;
     }
 
+    iteration_deadline = cq_busy_poll_iteration_deadline(
+        &exec_ctx, &busy_poll, now, iteration_deadline);
+
     /* The main polling work happens in grpc_pollset_work */
     gpr_mu_lock(cq->mu);
     cq->num_polls++;
+    /* Producers only kick when they see a waiter (see cq_end_op_for_next), so
+       register as one before the final check for events that were queued
+       since we last looked */
+    gpr_atm_full_fetch_add(&cqd->num_waiters, 1);
+    if (gpr_atm_acq_load(&cqd->queue.num_queue_items) > 0) {
+      iteration_deadline = gpr_time_0(GPR_CLOCK_MONOTONIC);
+    }
     grpc_error *err = cq->poller_vtable->work(&exec_ctx, POLLSET_FROM_CQ(cq),
                                               NULL, now, iteration_deadline);
+    gpr_atm_no_barrier_fetch_add(&cqd->num_waiters, -1);
     gpr_mu_unlock(cq->mu);
 
     if (err != GRPC_ERROR_NONE) {
@@ -917,29 +1375,36 @@ static grpc_event cq_next(grpc_completion_queue *cq, gpr_timespec deadline,
       gpr_log(GPR_ERROR, "Completion queue next failed: %s", msg);
 
       GRPC_ERROR_UNREF(err);
-      memset(&ret, 0, sizeof(ret));
-      ret.type = GRPC_QUEUE_TIMEOUT;
+      memset(&events[0], 0, sizeof(events[0]));
+      events[0].type = GRPC_QUEUE_TIMEOUT;
+      num_events = 1;
       dump_pending_tags(cq);
       break;
     }
     is_finished_arg.first_loop = false;
   }
 
+  cq_busy_poll_end(&exec_ctx, cq, &busy_poll,
+                   events[0].type == GRPC_OP_COMPLETE);
+
   if (cq_event_queue_num_items(&cqd->queue) > 0 &&
-      gpr_atm_acq_load(&cqd->pending_events) > 0) {
+      gpr_atm_acq_load(&cqd->pending_events) > 0 &&
+      gpr_atm_acq_load(&cqd->num_waiters) > 0) {
     gpr_mu_lock(cq->mu);
     cq->poller_vtable->kick(&exec_ctx, POLLSET_FROM_CQ(cq), NULL);
     gpr_mu_unlock(cq->mu);
   }
 
-  GRPC_SURFACE_TRACE_RETURNED_EVENT(cq, &ret);
+  for (size_t i = 0; i < num_events; i++) {
+    GRPC_SURFACE_TRACE_RETURNED_EVENT(cq, &events[i]);
+  }
   GRPC_CQ_INTERNAL_UNREF(&exec_ctx, cq, "next");
   grpc_exec_ctx_finish(&exec_ctx);
   GPR_ASSERT(is_finished_arg.stolen_completion == NULL);
 
   GPR_TIMER_END("grpc_completion_queue_next", 0);
 
-  return ret;
+  return num_events;
 }
 
 /* Finishes the completion queue shutdown. This means that there are no more
@@ -989,7 +1454,38 @@ static void cq_shutdown_next(grpc_exec_ctx *exec_ctx,
 
 grpc_event grpc_completion_queue_next(grpc_completion_queue *cq,
                                       gpr_timespec deadline, void *reserved) {
-  return cq->vtable->next(cq, deadline, reserved);
+  GRPC_API_TRACE(
+      "grpc_completion_queue_next("
+      "cq=%p, "
+      "deadline=gpr_timespec { tv_sec: %" PRId64
+      ", tv_nsec: %d, clock_type: %d }, "
+      "reserved=%p)",
+      5, (cq, deadline.tv_sec, deadline.tv_nsec, (int)deadline.clock_type,
+          reserved));
+  GPR_ASSERT(!reserved);
+
+  grpc_event ev;
+  cq->vtable->next(cq, &ev, 1, deadline);
+  return ev;
+}
+
+size_t grpc_completion_queue_next_batch(grpc_completion_queue *cq,
+                                        grpc_event *events, size_t max_events,
+                                        gpr_timespec deadline,
+                                        void *reserved) {
+  GRPC_API_TRACE(
+      "grpc_completion_queue_next_batch("
+      "cq=%p, events=%p, max_events=%" PRIuPTR
+      ", "
+      "deadline=gpr_timespec { tv_sec: %" PRId64
+      ", tv_nsec: %d, clock_type: %d }, "
+      "reserved=%p)",
+      7, (cq, events, max_events, deadline.tv_sec, deadline.tv_nsec,
+          (int)deadline.clock_type, reserved));
+  GPR_ASSERT(!reserved);
+  GPR_ASSERT(max_events > 0);
+
+  return cq->vtable->next(cq, events, max_events, deadline);
 }
 
 static int add_plucker(grpc_completion_queue *cq, void *tag,
@@ -1218,6 +1714,48 @@ static void cq_shutdown_pluck(grpc_exec_ctx *exec_ctx,
   GRPC_CQ_INTERNAL_UNREF(exec_ctx, cq, "shutting_down (pluck cq)");
 }
 
+static void cq_finish_shutdown_callback(grpc_exec_ctx *exec_ctx,
+                                        grpc_completion_queue *cq) {
+  cq_callback_data *cqd = (cq_callback_data *)DATA_FROM_CQ(cq);
+
+  GPR_ASSERT(cqd->shutdown_called);
+  GPR_ASSERT(gpr_atm_no_barrier_load(&cqd->pending_events) == 0);
+
+  /* Stop the poller thread, which runs the shutdown callback on its way out */
+  cqd->poller_done = true;
+  grpc_error *kick_error =
+      cq->poller_vtable->kick(exec_ctx, POLLSET_FROM_CQ(cq), NULL);
+  if (kick_error != GRPC_ERROR_NONE) {
+    const char *msg = grpc_error_string(kick_error);
+    gpr_log(GPR_ERROR, "Kick failed: %s", msg);
+    GRPC_ERROR_UNREF(kick_error);
+  }
+
+  cq->poller_vtable->shutdown(exec_ctx, POLLSET_FROM_CQ(cq),
+                              &cq->pollset_shutdown_done);
+}
+
+static void cq_shutdown_callback(grpc_exec_ctx *exec_ctx,
+                                 grpc_completion_queue *cq) {
+  cq_callback_data *cqd = (cq_callback_data *)DATA_FROM_CQ(cq);
+
+  /* Need an extra ref for cq here because pollset shutdown may drop the last
+     ref (see cq_shutdown_next) */
+  GRPC_CQ_INTERNAL_REF(cq, "shutting_down (callback cq)");
+  gpr_mu_lock(cq->mu);
+  if (cqd->shutdown_called) {
+    gpr_mu_unlock(cq->mu);
+    GRPC_CQ_INTERNAL_UNREF(exec_ctx, cq, "shutting_down (callback cq)");
+    return;
+  }
+  cqd->shutdown_called = true;
+  if (gpr_atm_full_fetch_add(&cqd->pending_events, -1) == 1) {
+    cq_finish_shutdown_callback(exec_ctx, cq);
+  }
+  gpr_mu_unlock(cq->mu);
+  GRPC_CQ_INTERNAL_UNREF(exec_ctx, cq, "shutting_down (callback cq)");
+}
+
 /* Shutdown simply drops a ref that we reserved at creation time; if we drop
    to zero here, then enter shutdown mode and wake up any waiters */
 void grpc_completion_queue_shutdown(grpc_completion_queue *cq) {
@@ -50,8 +50,11 @@ typedef struct grpc_cq_completion {
   void (*done)(grpc_exec_ctx *exec_ctx, void *done_arg,
                struct grpc_cq_completion *c);
   void *done_arg;
-  /** next pointer; low bit is used to indicate success or not */
+  /** next pointer; low bit is used to indicate success or not. Completion
+      queues of type GRPC_CQ_CALLBACK keep their own pointer here instead */
   uintptr_t next;
+  /** runs the tag of a GRPC_CQ_CALLBACK completion queue */
+  grpc_closure callback;
 } grpc_cq_completion;
 
 #ifndef NDEBUG
@@ -92,8 +95,13 @@ grpc_cq_completion_type grpc_get_cq_completion_type(grpc_completion_queue *cc);
 
 int grpc_get_cq_poll_num(grpc_completion_queue *cc);
 
+/* Make grpc_completion_queue_next busy poll \a cc for up to \a max_us
+   microseconds before blocking (see GRPC_ARG_BUSY_POLL_US) */
+void grpc_cq_enable_busy_poll(grpc_completion_queue *cc, int max_us);
+
 grpc_completion_queue *grpc_completion_queue_create_internal(
-    grpc_cq_completion_type completion_type, grpc_cq_polling_type polling_type);
+    grpc_cq_completion_type completion_type, grpc_cq_polling_type polling_type,
+    grpc_experimental_completion_queue_functor *shutdown_callback);
 
 #ifdef __cplusplus
 }
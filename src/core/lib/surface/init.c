@@ -41,6 +41,7 @@
 #include "src/core/lib/slice/slice_internal.h"
 #include "src/core/lib/surface/alarm_internal.h"
 #include "src/core/lib/surface/api_trace.h"
+#include "src/core/lib/surface/arena_pool.h"
 #include "src/core/lib/surface/call.h"
 #include "src/core/lib/surface/channel_init.h"
 #include "src/core/lib/surface/completion_queue.h"
@@ -123,6 +124,7 @@ void grpc_init(void) {
     gpr_time_init();
     grpc_stats_init();
     grpc_slice_intern_init();
+    grpc_slice_pool_init();
     grpc_mdctx_global_init();
     grpc_channel_init_init();
     grpc_register_tracer(&grpc_api_trace);
@@ -151,6 +153,7 @@ void grpc_init(void) {
 #endif
     grpc_security_pre_init();
     grpc_iomgr_init(&exec_ctx);
+    grpc_arena_pool_init();
     gpr_timers_global_init();
     grpc_handshaker_factory_registry_init();
     grpc_security_init();
@@ -187,12 +190,14 @@ void grpc_shutdown(void) {
         g_all_of_the_plugins[i].destroy();
       }
     }
+    grpc_arena_pool_shutdown(&exec_ctx);
     grpc_iomgr_shutdown(&exec_ctx);
     gpr_timers_global_destroy();
     grpc_tracer_shutdown();
     grpc_mdctx_global_shutdown(&exec_ctx);
     grpc_handshaker_factory_registry_shutdown(&exec_ctx);
     grpc_slice_intern_shutdown();
+    grpc_slice_pool_shutdown();
     grpc_stats_shutdown();
   }
   gpr_mu_unlock(&g_init_mu);
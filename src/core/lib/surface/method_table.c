@@ -0,0 +1,262 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/lib/surface/method_table.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/useful.h>
+
+#include "src/core/lib/slice/slice_internal.h"
+
+/* Keys of the perfect hash are the distinct hashes of the registered paths:
+   every path hashes to one key, and each key owns one slot. Keys are
+   spread over buckets by their hash, and each bucket gets a displacement
+   chosen so that its keys land on free slots (see "Hash, displace, and
+   compress", Belazzougui et al.).
+
+   A slot lists the entries of its key, those for a specific host ahead of
+   those for any host. Paths whose hashes collide share a key, so a lookup
+   still compares the path. */
+
+/* average keys per bucket */
+#define KEYS_PER_BUCKET 4
+/* displacements tried for one bucket before the table is made larger */
+#define MAX_DISPLACEMENT (1u << 16)
+
+typedef struct {
+  grpc_slice path;
+  grpc_slice host;
+  bool has_host;
+  uint32_t hash;
+  uint32_t flags;
+  void *value;
+} method_entry;
+
+typedef struct {
+  uint32_t first_entry;
+  uint32_t num_entries;
+} method_slot;
+
+struct grpc_method_table {
+  uint32_t num_buckets;
+  uint32_t *displacements;
+  uint32_t num_slots;
+  method_slot *slots;
+  size_t num_entries;
+  method_entry *entries;
+};
+
+static uint32_t displace(uint32_t hash, uint32_t displacement) {
+  /* murmur3's finalizer: a different mixing of the hash per displacement */
+  uint32_t h = hash ^ (displacement * 0x9e3779b9u);
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  h ^= h >> 16;
+  return h;
+}
+
+static uint32_t slot_index(uint32_t hash, uint32_t displacement,
+                           uint32_t num_slots) {
+  return displace(hash, displacement) % num_slots;
+}
+
+static int cmp_entries(const void *a, const void *b) {
+  const method_entry *ea = (const method_entry *)a;
+  const method_entry *eb = (const method_entry *)b;
+  if (ea->hash != eb->hash) return ea->hash < eb->hash ? -1 : 1;
+  /* entries for a specific host first */
+  return (int)eb->has_host - (int)ea->has_host;
+}
+
+typedef struct {
+  uint32_t hash;
+  uint32_t first_entry;
+  uint32_t num_entries;
+  uint32_t bucket;
+} key;
+
+typedef struct {
+  uint32_t *keys;
+  uint32_t num_keys;
+} bucket;
+
+static int cmp_buckets_by_size(const void *a, const void *b) {
+  const bucket *ba = (const bucket *)a;
+  const bucket *bb = (const bucket *)b;
+  return (int)bb->num_keys - (int)ba->num_keys;
+}
+
+/* find a displacement for every bucket, filling table->displacements and
+   key_slots; false if some bucket could not be placed */
+static bool place_keys(grpc_method_table *table, key *keys, uint32_t num_keys,
+                       uint32_t *key_slots) {
+  bucket *buckets =
+      (bucket *)gpr_zalloc(sizeof(*buckets) * table->num_buckets);
+  uint32_t *bucket_keys = (uint32_t *)gpr_malloc(sizeof(*bucket_keys) *
+                                                 GPR_MAX(num_keys, 1));
+  bool *taken = (bool *)gpr_zalloc(sizeof(*taken) * table->num_slots);
+  bool placed = true;
+
+  for (uint32_t i = 0; i < num_keys; i++) {
+    keys[i].bucket = keys[i].hash % table->num_buckets;
+    buckets[keys[i].bucket].num_keys++;
+  }
+  uint32_t next = 0;
+  for (uint32_t i = 0; i < table->num_buckets; i++) {
+    buckets[i].keys = bucket_keys + next;
+    next += buckets[i].num_keys;
+    buckets[i].num_keys = 0;
+  }
+  for (uint32_t i = 0; i < num_keys; i++) {
+    bucket *b = &buckets[keys[i].bucket];
+    b->keys[b->num_keys++] = i;
+  }
+  /* place the fullest buckets while there is most room */
+  bucket *sorted = (bucket *)gpr_malloc(sizeof(*sorted) * table->num_buckets);
+  memcpy(sorted, buckets, sizeof(*sorted) * table->num_buckets);
+  qsort(sorted, table->num_buckets, sizeof(*sorted), cmp_buckets_by_size);
+
+  for (uint32_t i = 0; placed && i < table->num_buckets; i++) {
+    bucket *b = &sorted[i];
+    if (b->num_keys == 0) break;
+    uint32_t id = keys[b->keys[0]].bucket;
+    uint32_t d;
+    for (d = 0; d < MAX_DISPLACEMENT; d++) {
+      uint32_t j;
+      for (j = 0; j < b->num_keys; j++) {
+        uint32_t s = slot_index(keys[b->keys[j]].hash, d, table->num_slots);
+        if (taken[s]) break;
+        taken[s] = true;
+        key_slots[b->keys[j]] = s;
+      }
+      if (j == b->num_keys) break;
+      /* undo this attempt */
+      while (j-- > 0) {
+        taken[key_slots[b->keys[j]]] = false;
+      }
+    }
+    if (d == MAX_DISPLACEMENT) {
+      placed = false;
+    } else {
+      table->displacements[id] = d;
+    }
+  }
+
+  gpr_free(sorted);
+  gpr_free(taken);
+  gpr_free(bucket_keys);
+  gpr_free(buckets);
+  return placed;
+}
+
+grpc_method_table *grpc_method_table_create(
+    const grpc_method_table_entry *entries, size_t num_entries) {
+  GPR_ASSERT(num_entries <= UINT32_MAX);
+  grpc_method_table *table = (grpc_method_table *)gpr_zalloc(sizeof(*table));
+  table->num_entries = num_entries;
+  table->entries = (method_entry *)gpr_malloc(sizeof(*table->entries) *
+                                              GPR_MAX(num_entries, 1));
+  for (size_t i = 0; i < num_entries; i++) {
+    method_entry *e = &table->entries[i];
+    GPR_ASSERT(entries[i].value != NULL);
+    e->path =
+        grpc_slice_intern(grpc_slice_from_static_string(entries[i].method));
+    e->has_host = entries[i].host != NULL;
+    if (e->has_host) {
+      e->host =
+          grpc_slice_intern(grpc_slice_from_static_string(entries[i].host));
+    }
+    e->hash = grpc_slice_hash(e->path);
+    e->flags = entries[i].flags;
+    e->value = entries[i].value;
+  }
+  qsort(table->entries, num_entries, sizeof(*table->entries), cmp_entries);
+
+  key *keys = (key *)gpr_malloc(sizeof(*keys) * GPR_MAX(num_entries, 1));
+  uint32_t num_keys = 0;
+  for (uint32_t i = 0; i < num_entries; i++) {
+    if (num_keys == 0 || keys[num_keys - 1].hash != table->entries[i].hash) {
+      keys[num_keys].hash = table->entries[i].hash;
+      keys[num_keys].first_entry = i;
+      keys[num_keys].num_entries = 0;
+      num_keys++;
+    }
+    keys[num_keys - 1].num_entries++;
+  }
+
+  uint32_t *key_slots =
+      (uint32_t *)gpr_malloc(sizeof(*key_slots) * GPR_MAX(num_keys, 1));
+  table->num_slots = GPR_MAX(num_keys, 1);
+  table->num_buckets = GPR_MAX(num_keys / KEYS_PER_BUCKET, 1);
+  table->displacements = (uint32_t *)gpr_zalloc(
+      sizeof(*table->displacements) * table->num_buckets);
+  while (!place_keys(table, keys, num_keys, key_slots)) {
+    /* unlucky: trade minimality for some slack and start over */
+    table->num_slots += table->num_slots / 8 + 1;
+    memset(table->displacements, 0,
+           sizeof(*table->displacements) * table->num_buckets);
+  }
+
+  table->slots =
+      (method_slot *)gpr_zalloc(sizeof(*table->slots) * table->num_slots);
+  for (uint32_t i = 0; i < num_keys; i++) {
+    method_slot *s = &table->slots[key_slots[i]];
+    s->first_entry = keys[i].first_entry;
+    s->num_entries = keys[i].num_entries;
+  }
+  gpr_free(key_slots);
+  gpr_free(keys);
+  return table;
+}
+
+void grpc_method_table_destroy(grpc_exec_ctx *exec_ctx,
+                               grpc_method_table *table) {
+  for (size_t i = 0; i < table->num_entries; i++) {
+    grpc_slice_unref_internal(exec_ctx, table->entries[i].path);
+    if (table->entries[i].has_host) {
+      grpc_slice_unref_internal(exec_ctx, table->entries[i].host);
+    }
+  }
+  gpr_free(table->entries);
+  gpr_free(table->slots);
+  gpr_free(table->displacements);
+  gpr_free(table);
+}
+
+void *grpc_method_table_lookup(const grpc_method_table *table, grpc_slice path,
+                               grpc_slice host, uint32_t call_flags) {
+  uint32_t hash = grpc_slice_hash(path);
+  uint32_t displacement = table->displacements[hash % table->num_buckets];
+  const method_slot *s =
+      &table->slots[slot_index(hash, displacement, table->num_slots)];
+  const method_entry *e = table->entries + s->first_entry;
+  for (uint32_t i = 0; i < s->num_entries; i++, e++) {
+    if (!grpc_slice_eq(e->path, path)) continue;
+    if (e->has_host && !grpc_slice_eq(e->host, host)) continue;
+    if ((e->flags & ~call_flags) != 0) continue;
+    return e->value;
+  }
+  return NULL;
+}
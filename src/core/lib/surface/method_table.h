@@ -0,0 +1,59 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_LIB_SURFACE_METHOD_TABLE_H
+#define GRPC_CORE_LIB_SURFACE_METHOD_TABLE_H
+
+#include <grpc/slice.h>
+
+#include "src/core/lib/iomgr/exec_ctx.h"
+
+/** Immutable table of a server's registered methods, mapping the :path and
+    :authority of an incoming call to the method registered for it.
+
+    The table is built once, when the server starts, and shared by all of its
+    channels. Paths are placed with a minimal perfect hash (hash and
+    displace), so a lookup hashes the path, reads one slot, and compares the
+    few entries registered for that path. */
+
+typedef struct grpc_method_table grpc_method_table;
+
+typedef struct {
+  const char *method;
+  /** NULL to match any host */
+  const char *host;
+  /** GRPC_INITIAL_METADATA_* flags a call must carry to match */
+  uint32_t flags;
+  /** Returned by lookups; must not be NULL */
+  void *value;
+} grpc_method_table_entry;
+
+/** Create a table of \a num_entries \a entries, which must not contain
+    duplicate (method, host) pairs */
+grpc_method_table *grpc_method_table_create(
+    const grpc_method_table_entry *entries, size_t num_entries);
+void grpc_method_table_destroy(grpc_exec_ctx *exec_ctx,
+                               grpc_method_table *table);
+
+/** Find the value registered for \a path and \a host, preferring an entry for
+    that exact host over one for any host. Entries whose flags are not all
+    set in \a call_flags do not match. Returns NULL if nothing matches. */
+void *grpc_method_table_lookup(const grpc_method_table *table, grpc_slice path,
+                               grpc_slice host, uint32_t call_flags);
+
+#endif /* GRPC_CORE_LIB_SURFACE_METHOD_TABLE_H */
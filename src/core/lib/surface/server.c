@@ -40,6 +40,7 @@
 #include "src/core/lib/surface/channel.h"
 #include "src/core/lib/surface/completion_queue.h"
 #include "src/core/lib/surface/init.h"
+#include "src/core/lib/surface/method_table.h"
 #include "src/core/lib/transport/metadata.h"
 #include "src/core/lib/transport/static_metadata.h"
 
@@ -83,14 +84,6 @@ typedef struct requested_call {
   } data;
 } requested_call;
 
-typedef struct channel_registered_method {
-  registered_method *server_registered_method;
-  uint32_t flags;
-  bool has_host;
-  grpc_slice method;
-  grpc_slice host;
-} channel_registered_method;
-
 struct channel_data {
   grpc_server *server;
   grpc_connectivity_state connectivity_state;
@@ -99,9 +92,6 @@ struct channel_data {
   /* linked list of all channels on a server */
   channel_data *next;
   channel_data *prev;
-  channel_registered_method *registered_methods;
-  uint32_t registered_method_slots;
-  uint32_t registered_method_max_probes;
   grpc_closure finish_destroy_channel_closure;
   grpc_closure channel_connectivity_changed;
 };
@@ -205,6 +195,9 @@ struct grpc_server {
   gpr_cv starting_cv;
 
   registered_method *registered_methods;
+  /** lookup table for registered_methods, built at start and shared by all
+      channels; NULL if there are none */
+  grpc_method_table *method_table;
   /** one request matcher for unregistered methods */
   request_matcher unregistered_request_matcher;
   /** free list of available requested_calls_per_cq indices */
@@ -281,11 +274,7 @@ static void send_shutdown(grpc_exec_ctx *exec_ctx, grpc_channel *channel,
   grpc_transport_op *op = grpc_make_transport_op(&sc->closure);
   grpc_channel_element *elem;
 
-  op->goaway_error =
-      send_goaway ? grpc_error_set_int(
-                        GRPC_ERROR_CREATE_FROM_STATIC_STRING("Server shutdown"),
-                        GRPC_ERROR_INT_GRPC_STATUS, GRPC_STATUS_OK)
-                  : GRPC_ERROR_NONE;
+  op->goaway_error = send_goaway ? GRPC_ERROR_SERVER_GOAWAY : GRPC_ERROR_NONE;
   op->set_accept_stream = true;
   sc->slice = grpc_slice_from_copied_string("Server shutdown");
   op->disconnect_with_error = send_disconnect;
@@ -384,6 +373,9 @@ static void server_delete(grpc_exec_ctx *exec_ctx, grpc_server *server) {
   gpr_mu_destroy(&server->mu_global);
   gpr_mu_destroy(&server->mu_call);
   gpr_cv_destroy(&server->starting_cv);
+  if (server->method_table != NULL) {
+    grpc_method_table_destroy(exec_ctx, server->method_table);
+  }
   while ((rm = server->registered_methods) != NULL) {
     server->registered_methods = rm->next;
     if (server->started) {
@@ -607,48 +599,14 @@ static void start_new_rpc(grpc_exec_ctx *exec_ctx, grpc_call_element *elem) {
   channel_data *chand = (channel_data *)elem->channel_data;
   call_data *calld = (call_data *)elem->call_data;
   grpc_server *server = chand->server;
-  uint32_t i;
-  uint32_t hash;
-  channel_registered_method *rm;
-
-  if (chand->registered_methods && calld->path_set && calld->host_set) {
-    /* TODO(ctiller): unify these two searches */
-    /* check for an exact match with host */
-    hash = GRPC_MDSTR_KV_HASH(grpc_slice_hash(calld->host),
-                              grpc_slice_hash(calld->path));
-    for (i = 0; i <= chand->registered_method_max_probes; i++) {
-      rm = &chand->registered_methods[(hash + i) %
-                                      chand->registered_method_slots];
-      if (!rm) break;
-      if (!rm->has_host) continue;
-      if (!grpc_slice_eq(rm->host, calld->host)) continue;
-      if (!grpc_slice_eq(rm->method, calld->path)) continue;
-      if ((rm->flags & GRPC_INITIAL_METADATA_IDEMPOTENT_REQUEST) &&
-          0 == (calld->recv_initial_metadata_flags &
-                GRPC_INITIAL_METADATA_IDEMPOTENT_REQUEST)) {
-        continue;
-      }
-      finish_start_new_rpc(exec_ctx, server, elem,
-                           &rm->server_registered_method->matcher,
-                           rm->server_registered_method->payload_handling);
-      return;
-    }
-    /* check for a wildcard method definition (no host set) */
-    hash = GRPC_MDSTR_KV_HASH(0, grpc_slice_hash(calld->path));
-    for (i = 0; i <= chand->registered_method_max_probes; i++) {
-      rm = &chand->registered_methods[(hash + i) %
-                                      chand->registered_method_slots];
-      if (!rm) break;
-      if (rm->has_host) continue;
-      if (!grpc_slice_eq(rm->method, calld->path)) continue;
-      if ((rm->flags & GRPC_INITIAL_METADATA_IDEMPOTENT_REQUEST) &&
-          0 == (calld->recv_initial_metadata_flags &
-                GRPC_INITIAL_METADATA_IDEMPOTENT_REQUEST)) {
-        continue;
-      }
-      finish_start_new_rpc(exec_ctx, server, elem,
-                           &rm->server_registered_method->matcher,
-                           rm->server_registered_method->payload_handling);
+
+  if (server->method_table != NULL && calld->path_set && calld->host_set) {
+    registered_method *rm = (registered_method *)grpc_method_table_lookup(
+        server->method_table, calld->path, calld->host,
+        calld->recv_initial_metadata_flags);
+    if (rm != NULL) {
+      finish_start_new_rpc(exec_ctx, server, elem, &rm->matcher,
+                           rm->payload_handling);
       return;
     }
   }
@@ -706,9 +664,7 @@ static void maybe_finish_shutdown(grpc_exec_ctx *exec_ctx,
     return;
   }
 
-  kill_pending_work_locked(
-      exec_ctx, server,
-      GRPC_ERROR_CREATE_FROM_STATIC_STRING("Server Shutdown"));
+  kill_pending_work_locked(exec_ctx, server, GRPC_ERROR_SERVER_SHUTDOWN);
 
   if (server->root_channel_data.next != &server->root_channel_data ||
       server->listeners_destroyed < num_listeners(server)) {
@@ -924,7 +880,6 @@ static grpc_error *init_channel_elem(grpc_exec_ctx *exec_ctx,
   chand->server = NULL;
   chand->channel = NULL;
   chand->next = chand->prev = chand;
-  chand->registered_methods = NULL;
   chand->connectivity_state = GRPC_CHANNEL_IDLE;
   GRPC_CLOSURE_INIT(&chand->channel_connectivity_changed,
                     channel_connectivity_changed, chand,
@@ -934,17 +889,7 @@ static grpc_error *init_channel_elem(grpc_exec_ctx *exec_ctx,
 
 static void destroy_channel_elem(grpc_exec_ctx *exec_ctx,
                                  grpc_channel_element *elem) {
-  size_t i;
   channel_data *chand = (channel_data *)elem->channel_data;
-  if (chand->registered_methods) {
-    for (i = 0; i < chand->registered_method_slots; i++) {
-      grpc_slice_unref_internal(exec_ctx, chand->registered_methods[i].method);
-      if (chand->registered_methods[i].has_host) {
-        grpc_slice_unref_internal(exec_ctx, chand->registered_methods[i].host);
-      }
-    }
-    gpr_free(chand->registered_methods);
-  }
   if (chand->server) {
     gpr_mu_lock(&chand->server->mu_global);
     chand->next->prev = chand->prev;
@@ -993,10 +938,12 @@ void grpc_server_register_completion_queue(grpc_server *server,
       "grpc_server_register_completion_queue(server=%p, cq=%p, reserved=%p)", 3,
       (server, cq, reserved));
 
-  if (grpc_get_cq_completion_type(cq) != GRPC_CQ_NEXT) {
+  grpc_cq_completion_type cq_type = grpc_get_cq_completion_type(cq);
+  if (cq_type != GRPC_CQ_NEXT && cq_type != GRPC_CQ_CALLBACK) {
     gpr_log(GPR_INFO,
-            "Completion queue which is not of type GRPC_CQ_NEXT is being "
-            "registered as a server-completion-queue");
+            "Completion queue which is not of type GRPC_CQ_NEXT or "
+            "GRPC_CQ_CALLBACK is being registered as a "
+            "server-completion-queue");
     /* Ideally we should log an error and abort but ruby-wrapped-language API
        calls grpc_completion_queue_pluck() on server completion queues */
   }
@@ -1097,7 +1044,11 @@ void grpc_server_start(grpc_server *server) {
       sizeof(*server->request_freelist_per_cq) * server->cq_count);
   server->requested_calls_per_cq = (requested_call **)gpr_malloc(
       sizeof(*server->requested_calls_per_cq) * server->cq_count);
+  int busy_poll_us = grpc_channel_arg_get_integer(
+      grpc_channel_args_find(server->channel_args, GRPC_ARG_BUSY_POLL_US),
+      (grpc_integer_options){0, 0, INT_MAX});
   for (i = 0; i < server->cq_count; i++) {
+    grpc_cq_enable_busy_poll(server->cqs[i], busy_poll_us);
     if (grpc_cq_can_listen(server->cqs[i])) {
       server->pollsets[server->pollset_count++] =
           grpc_cq_pollset(server->cqs[i]);
@@ -1113,9 +1064,29 @@ void grpc_server_start(grpc_server *server) {
   }
   request_matcher_init(&server->unregistered_request_matcher,
                        (size_t)server->max_requested_calls_per_cq, server);
+  size_t num_registered_methods = 0;
   for (registered_method *rm = server->registered_methods; rm; rm = rm->next) {
     request_matcher_init(&rm->matcher,
                          (size_t)server->max_requested_calls_per_cq, server);
+    num_registered_methods++;
+  }
+  if (num_registered_methods > 0) {
+    grpc_method_table_entry *entries = (grpc_method_table_entry *)gpr_malloc(
+        sizeof(*entries) * num_registered_methods);
+    i = 0;
+    for (registered_method *rm = server->registered_methods; rm;
+         rm = rm->next) {
+      entries[i].method = rm->method;
+      entries[i].host = rm->host;
+      /* of the flags a method is registered with, only idempotency needs
+         to be matched by the call */
+      entries[i].flags = rm->flags & GRPC_INITIAL_METADATA_IDEMPOTENT_REQUEST;
+      entries[i].value = rm;
+      i++;
+    }
+    server->method_table =
+        grpc_method_table_create(entries, num_registered_methods);
+    gpr_free(entries);
   }
 
   server_ref(server);
@@ -1139,16 +1110,8 @@ void grpc_server_setup_transport(grpc_exec_ctx *exec_ctx, grpc_server *s,
                                  grpc_transport *transport,
                                  grpc_pollset *accepting_pollset,
                                  const grpc_channel_args *args) {
-  size_t num_registered_methods;
-  size_t alloc;
-  registered_method *rm;
-  channel_registered_method *crm;
   grpc_channel *channel;
   channel_data *chand;
-  uint32_t hash;
-  size_t slots;
-  uint32_t probes;
-  uint32_t max_probes = 0;
   grpc_transport_op *op = NULL;
 
   channel =
@@ -1170,48 +1133,6 @@ void grpc_server_setup_transport(grpc_exec_ctx *exec_ctx, grpc_server *s,
   }
   chand->cq_idx = cq_idx;
 
-  num_registered_methods = 0;
-  for (rm = s->registered_methods; rm; rm = rm->next) {
-    num_registered_methods++;
-  }
-  /* build a lookup table phrased in terms of mdstr's in this channels context
-     to quickly find registered methods */
-  if (num_registered_methods > 0) {
-    slots = 2 * num_registered_methods;
-    alloc = sizeof(channel_registered_method) * slots;
-    chand->registered_methods = (channel_registered_method *)gpr_zalloc(alloc);
-    for (rm = s->registered_methods; rm; rm = rm->next) {
-      grpc_slice host;
-      bool has_host;
-      grpc_slice method;
-      if (rm->host != NULL) {
-        host = grpc_slice_intern(grpc_slice_from_static_string(rm->host));
-        has_host = true;
-      } else {
-        has_host = false;
-      }
-      method = grpc_slice_intern(grpc_slice_from_static_string(rm->method));
-      hash = GRPC_MDSTR_KV_HASH(has_host ? grpc_slice_hash(host) : 0,
-                                grpc_slice_hash(method));
-      for (probes = 0; chand->registered_methods[(hash + probes) % slots]
-                           .server_registered_method != NULL;
-           probes++)
-        ;
-      if (probes > max_probes) max_probes = probes;
-      crm = &chand->registered_methods[(hash + probes) % slots];
-      crm->server_registered_method = rm;
-      crm->flags = rm->flags;
-      crm->has_host = has_host;
-      if (has_host) {
-        crm->host = host;
-      }
-      crm->method = method;
-    }
-    GPR_ASSERT(slots <= UINT32_MAX);
-    chand->registered_method_slots = (uint32_t)slots;
-    chand->registered_method_max_probes = max_probes;
-  }
-
   gpr_mu_lock(&s->mu_global);
   chand->next = &s->root_channel_data;
   chand->prev = chand->next->prev;
@@ -1226,8 +1147,7 @@ void grpc_server_setup_transport(grpc_exec_ctx *exec_ctx, grpc_server *s,
   op->on_connectivity_state_change = &chand->channel_connectivity_changed;
   op->connectivity_state = &chand->connectivity_state;
   if (gpr_atm_acq_load(&s->shutdown_flag) != 0) {
-    op->disconnect_with_error =
-        GRPC_ERROR_CREATE_FROM_STATIC_STRING("Server shutdown");
+    op->disconnect_with_error = GRPC_ERROR_SERVER_SHUTDOWN;
   }
   grpc_transport_perform_op(exec_ctx, transport, op);
 }
@@ -1292,9 +1212,7 @@ void grpc_server_shutdown_and_notify(grpc_server *server,
 
   /* collect all unregistered then registered calls */
   gpr_mu_lock(&server->mu_call);
-  kill_pending_work_locked(
-      &exec_ctx, server,
-      GRPC_ERROR_CREATE_FROM_STATIC_STRING("Server Shutdown"));
+  kill_pending_work_locked(&exec_ctx, server, GRPC_ERROR_SERVER_SHUTDOWN);
   gpr_mu_unlock(&server->mu_call);
 
   maybe_finish_shutdown(&exec_ctx, server);
@@ -1373,8 +1291,7 @@ static grpc_call_error queue_call_request(grpc_exec_ctx *exec_ctx,
   request_matcher *rm = NULL;
   int request_id;
   if (gpr_atm_acq_load(&server->shutdown_flag)) {
-    fail_call(exec_ctx, server, cq_idx, rc,
-              GRPC_ERROR_CREATE_FROM_STATIC_STRING("Server Shutdown"));
+    fail_call(exec_ctx, server, cq_idx, rc, GRPC_ERROR_SERVER_SHUTDOWN);
     return GRPC_CALL_OK;
   }
   request_id = gpr_stack_lockfree_pop(server->request_freelist_per_cq[cq_idx]);
@@ -0,0 +1,58 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/lib/transport/load_report_encoding.h"
+
+#include <string.h>
+
+void grpc_load_report_encode(const grpc_load_report *report, char *buffer) {
+  char *p = buffer;
+  memcpy(p, "u=", 2);
+  p += 2;
+  p += int64_ttoa(report->utilization_permille, p);
+  memcpy(p, ",q=", 3);
+  p += 3;
+  p += int64_ttoa(report->qps, p);
+  *p = 0;
+}
+
+bool grpc_load_report_decode(grpc_slice text, grpc_load_report *report) {
+  const char *p = (const char *)GRPC_SLICE_START_PTR(text);
+  const char *end = (const char *)GRPC_SLICE_END_PTR(text);
+  bool have_utilization = false;
+  bool have_qps = false;
+  while (p != end) {
+    const char *field_end = (const char *)memchr(p, ',', (size_t)(end - p));
+    if (field_end == NULL) field_end = end;
+    const size_t len = (size_t)(field_end - p);
+    if (len > 2 && p[0] == 'u' && p[1] == '=') {
+      if (!gpr_parse_bytes_to_uint32(p + 2, len - 2,
+                                     &report->utilization_permille)) {
+        return false;
+      }
+      have_utilization = true;
+    } else if (len > 2 && p[0] == 'q' && p[1] == '=') {
+      if (!gpr_parse_bytes_to_uint32(p + 2, len - 2, &report->qps)) {
+        return false;
+      }
+      have_qps = true;
+    }
+    p = field_end == end ? end : field_end + 1;
+  }
+  return have_utilization && have_qps;
+}
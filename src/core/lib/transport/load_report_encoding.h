@@ -0,0 +1,47 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_LIB_TRANSPORT_LOAD_REPORT_ENCODING_H
+#define GRPC_CORE_LIB_TRANSPORT_LOAD_REPORT_ENCODING_H
+
+#include <stdbool.h>
+
+#include <grpc/slice.h>
+
+#include "src/core/lib/support/string.h"
+
+/* Trailing metadata key under which servers report their load */
+#define GRPC_LOAD_REPORT_KEY "lb-load-report"
+
+#define GRPC_LOAD_REPORT_ENCODE_MIN_BUFSIZE (2 * GPR_INT64TOA_MIN_BUFSIZE + 6)
+
+/* Load of a server, as reported to its clients */
+typedef struct {
+  /* CPU utilization in thousandths: 0 when idle, 1000 when all cores are
+     busy */
+  uint32_t utilization_permille;
+  /* calls completed per second */
+  uint32_t qps;
+} grpc_load_report;
+
+/* Encode/decode load reports as "u=<utilization_permille>,q=<qps>". Decoding
+   ignores unknown fields, and fails unless both are present */
+void grpc_load_report_encode(const grpc_load_report *report, char *buffer);
+bool grpc_load_report_decode(grpc_slice text, grpc_load_report *report);
+
+#endif /* GRPC_CORE_LIB_TRANSPORT_LOAD_REPORT_ENCODING_H */
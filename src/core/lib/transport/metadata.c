@@ -34,6 +34,7 @@
 #include "src/core/lib/profiling/timers.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "src/core/lib/slice/slice_string_helpers.h"
+#include "src/core/lib/support/epoch.h"
 #include "src/core/lib/support/murmur_hash.h"
 #include "src/core/lib/support/string.h"
 #include "src/core/lib/transport/static_metadata.h"
@@ -81,7 +82,8 @@ typedef struct interned_metadata {
   gpr_atm destroy_user_data;
   gpr_atm user_data;
 
-  struct interned_metadata *bucket_next;
+  /* interned_metadata*: the next element in the bucket */
+  gpr_atm bucket_next;
 } interned_metadata;
 
 /* Shadow structure for grpc_mdelem_data for allocated elements */
@@ -94,21 +96,46 @@ typedef struct allocated_metadata {
   gpr_atm refcnt;
 } allocated_metadata;
 
+typedef struct mdtab {
+  size_t capacity;
+  /* interned_metadata*: bucket heads */
+  gpr_atm elems[];
+} mdtab;
+
+/* Lookups of referenced elements walk a shard's table without its lock (see
+   gpr_epoch_enter), so writers publish with release stores and retire,
+   rather than free, elements and tables they unlink. */
 typedef struct mdtab_shard {
   gpr_mu mu;
-  interned_metadata **elems;
+  /* mdtab*, replaced as the shard grows */
+  gpr_atm table;
   size_t count;
-  size_t capacity;
   /** Estimate of the number of unreferenced mdelems in the hash table.
       This will eventually converge to the exact number, but it's instantaneous
       accuracy is not guaranteed */
   gpr_atm free_estimate;
+  gpr_epoch_limbo limbo;
 } mdtab_shard;
 
 static mdtab_shard g_shards[SHARD_COUNT];
 
 static void gc_mdtab(grpc_exec_ctx *exec_ctx, mdtab_shard *shard);
 
+static mdtab *new_mdtab(size_t capacity) {
+  mdtab *table =
+      (mdtab *)gpr_zalloc(sizeof(mdtab) + sizeof(gpr_atm) * capacity);
+  table->capacity = capacity;
+  return table;
+}
+
+static mdtab *get_mdtab(mdtab_shard *shard) {
+  return (mdtab *)gpr_atm_acq_load(&shard->table);
+}
+
+static interned_metadata *next_md(gpr_atm *link) {
+  return (interned_metadata *)gpr_atm_acq_load(link);
+}
+
 void grpc_mdctx_global_init(void) {
   /* initialize shards */
   for (size_t i = 0; i < SHARD_COUNT; i++) {
@@ -116,9 +143,9 @@ void grpc_mdctx_global_init(void) {
     gpr_mu_init(&shard->mu);
     shard->count = 0;
     gpr_atm_no_barrier_store(&shard->free_estimate, 0);
-    shard->capacity = INITIAL_SHARD_CAPACITY;
-    shard->elems = (interned_metadata **)gpr_zalloc(sizeof(*shard->elems) *
-                                                    shard->capacity);
+    gpr_atm_no_barrier_store(&shard->table,
+                             (gpr_atm)new_mdtab(INITIAL_SHARD_CAPACITY));
+    gpr_epoch_limbo_init(&shard->limbo);
   }
 }
 
@@ -135,7 +162,8 @@ void grpc_mdctx_global_shutdown(grpc_exec_ctx *exec_ctx) {
         abort();
       }
     }
-    gpr_free(shard->elems);
+    gpr_free(get_mdtab(shard));
+    gpr_epoch_limbo_destroy(&shard->limbo);
   }
 }
 
@@ -164,27 +192,71 @@ static void ref_md_locked(mdtab_shard *shard,
   }
 }
 
+/* find the element for an (interned) key and value pair and take a ref on
+   it. Safe without the shard lock inside an epoch critical section: an
+   element gc_mdtab has claimed (refcount -1) is never revived */
+static interned_metadata *find_and_ref_md(mdtab_shard *shard, grpc_slice key,
+                                          grpc_slice value, uint32_t hash) {
+  mdtab *table = get_mdtab(shard);
+  for (interned_metadata *md =
+           next_md(&table->elems[TABLE_IDX(hash, table->capacity)]);
+       md != NULL; md = next_md(&md->bucket_next)) {
+    /* interned slices are equal exactly when their refcounts are */
+    if (key.refcount != md->key.refcount ||
+        value.refcount != md->value.refcount) {
+      continue;
+    }
+    for (;;) {
+      gpr_atm count = gpr_atm_no_barrier_load(&md->refcnt);
+      if (count < 0) return NULL;
+      if (gpr_atm_no_barrier_cas(&md->refcnt, count, count + 1)) {
+        if (count == 0) {
+          gpr_atm_no_barrier_fetch_add(&shard->free_estimate, -1);
+        }
+        break;
+      }
+    }
+#ifndef NDEBUG
+    if (GRPC_TRACER_ON(grpc_trace_metadata)) {
+      char *key_str = grpc_slice_to_c_string(md->key);
+      char *value_str = grpc_slice_to_c_string(md->value);
+      gpr_log(GPR_DEBUG, "ELM   REF:%p:%" PRIdPTR ": '%s' = '%s'", (void *)md,
+              gpr_atm_no_barrier_load(&md->refcnt), key_str, value_str);
+      gpr_free(key_str);
+      gpr_free(value_str);
+    }
+#endif
+    return md;
+  }
+  return NULL;
+}
+
 static void gc_mdtab(grpc_exec_ctx *exec_ctx, mdtab_shard *shard) {
   size_t i;
-  interned_metadata **prev_next;
+  mdtab *table = get_mdtab(shard);
+  gpr_atm *prev_next;
   interned_metadata *md, *next;
   gpr_atm num_freed = 0;
 
   GPR_TIMER_BEGIN("gc_mdtab", 0);
-  for (i = 0; i < shard->capacity; i++) {
-    prev_next = &shard->elems[i];
-    for (md = shard->elems[i]; md; md = next) {
+  for (i = 0; i < table->capacity; i++) {
+    prev_next = &table->elems[i];
+    for (md = next_md(prev_next); md; md = next) {
       void *user_data = (void *)gpr_atm_no_barrier_load(&md->user_data);
-      next = md->bucket_next;
-      if (gpr_atm_acq_load(&md->refcnt) == 0) {
+      next = next_md(&md->bucket_next);
+      /* claim unreferenced elements so that lock free lookups cannot revive
+         them */
+      if (gpr_atm_acq_cas(&md->refcnt, 0, -1)) {
+        /* lock free lookups only compare the key and value refcount
+           pointers, so the slices can go now; md itself must wait */
         grpc_slice_unref_internal(exec_ctx, md->key);
         grpc_slice_unref_internal(exec_ctx, md->value);
         if (md->user_data) {
           ((destroy_user_data_func)gpr_atm_no_barrier_load(
               &md->destroy_user_data))(user_data);
         }
-        gpr_free(md);
-        *prev_next = next;
+        gpr_atm_rel_store(prev_next, (gpr_atm)next);
+        gpr_epoch_retire(&shard->limbo, md);
         num_freed++;
         shard->count--;
       } else {
@@ -197,39 +269,38 @@ static void gc_mdtab(grpc_exec_ctx *exec_ctx, mdtab_shard *shard) {
 }
 
 static void grow_mdtab(mdtab_shard *shard) {
-  size_t capacity = shard->capacity * 2;
+  mdtab *old_table = get_mdtab(shard);
+  mdtab *table = new_mdtab(old_table->capacity * 2);
   size_t i;
-  interned_metadata **mdtab;
   interned_metadata *md, *next;
   uint32_t hash;
 
   GPR_TIMER_BEGIN("grow_mdtab", 0);
 
-  mdtab =
-      (interned_metadata **)gpr_zalloc(sizeof(interned_metadata *) * capacity);
-
-  for (i = 0; i < shard->capacity; i++) {
-    for (md = shard->elems[i]; md; md = next) {
+  /* a concurrent lookup still on the old table may be led into a bucket of
+     the new one: it can miss, and take the locked path, but never loops */
+  for (i = 0; i < old_table->capacity; i++) {
+    for (md = next_md(&old_table->elems[i]); md; md = next) {
       size_t idx;
       hash = GRPC_MDSTR_KV_HASH(grpc_slice_hash(md->key),
                                 grpc_slice_hash(md->value));
-      next = md->bucket_next;
-      idx = TABLE_IDX(hash, capacity);
-      md->bucket_next = mdtab[idx];
-      mdtab[idx] = md;
+      next = next_md(&md->bucket_next);
+      idx = TABLE_IDX(hash, table->capacity);
+      gpr_atm_rel_store(&md->bucket_next,
+                        gpr_atm_no_barrier_load(&table->elems[idx]));
+      gpr_atm_no_barrier_store(&table->elems[idx], (gpr_atm)md);
     }
   }
 
-  gpr_free(shard->elems);
-  shard->elems = mdtab;
-  shard->capacity = capacity;
+  gpr_atm_rel_store(&shard->table, (gpr_atm)table);
+  gpr_epoch_retire(&shard->limbo, old_table);
 
   GPR_TIMER_END("grow_mdtab", 0);
 }
 
 static void rehash_mdtab(grpc_exec_ctx *exec_ctx, mdtab_shard *shard) {
   if (gpr_atm_no_barrier_load(&shard->free_estimate) >
-      (gpr_atm)(shard->capacity / 4)) {
+      (gpr_atm)(get_mdtab(shard)->capacity / 4)) {
     gc_mdtab(exec_ctx, shard);
   } else {
     grow_mdtab(shard);
@@ -277,15 +348,28 @@ grpc_mdelem grpc_mdelem_create(
       GRPC_MDSTR_KV_HASH(grpc_slice_hash(key), grpc_slice_hash(value));
   interned_metadata *md;
   mdtab_shard *shard = &g_shards[SHARD_IDX(hash)];
+  mdtab *table;
   size_t idx;
 
   GPR_TIMER_BEGIN("grpc_mdelem_from_metadata_strings", 0);
 
+  /* elements are usually already interned: look for them without the lock
+     first */
+  if (gpr_epoch_enter()) {
+    md = find_and_ref_md(shard, key, value, hash);
+    gpr_epoch_exit();
+    if (md != NULL) {
+      GPR_TIMER_END("grpc_mdelem_from_metadata_strings", 0);
+      return GRPC_MAKE_MDELEM(md, GRPC_MDELEM_STORAGE_INTERNED);
+    }
+  }
+
   gpr_mu_lock(&shard->mu);
 
-  idx = TABLE_IDX(hash, shard->capacity);
+  table = get_mdtab(shard);
+  idx = TABLE_IDX(hash, table->capacity);
   /* search for an existing pair */
-  for (md = shard->elems[idx]; md; md = md->bucket_next) {
+  for (md = next_md(&table->elems[idx]); md; md = next_md(&md->bucket_next)) {
     if (grpc_slice_eq(key, md->key) && grpc_slice_eq(value, md->value)) {
       REF_MD_LOCKED(shard, md);
       gpr_mu_unlock(&shard->mu);
@@ -301,8 +385,6 @@ grpc_mdelem grpc_mdelem_create(
   md->value = grpc_slice_ref_internal(value);
   md->user_data = 0;
   md->destroy_user_data = 0;
-  md->bucket_next = shard->elems[idx];
-  shard->elems[idx] = md;
   gpr_mu_init(&md->mu_user_data);
 #ifndef NDEBUG
   if (GRPC_TRACER_ON(grpc_trace_metadata)) {
@@ -314,9 +396,12 @@ grpc_mdelem grpc_mdelem_create(
     gpr_free(value_str);
   }
 #endif
+  gpr_atm_no_barrier_store(&md->bucket_next,
+                           gpr_atm_no_barrier_load(&table->elems[idx]));
+  gpr_atm_rel_store(&table->elems[idx], (gpr_atm)md);
   shard->count++;
 
-  if (shard->count > shard->capacity * 2) {
+  if (shard->count > table->capacity * 2) {
     rehash_mdtab(exec_ctx, shard);
   }
 
@@ -225,6 +225,9 @@ Channel::~Channel() {
   const bool stop_watching =
       grpc_channel_support_connectivity_watcher(c_channel_);
   grpc_channel_destroy(c_channel_);
+  if (callback_cq_ != nullptr) {
+    callback_cq_->Shutdown();
+  }
   if (stop_watching) {
     ChannelConnectivityWatcher::StopWatching();
   }
@@ -301,7 +304,8 @@ void Channel::PerformOpsOnCall(CallOpSetInterface* ops, Call* call) {
   grpc_op cops[MAX_OPS];
   ops->FillOps(call->call(), cops, &nops);
   GPR_ASSERT(GRPC_CALL_OK ==
-             grpc_call_start_batch(call->call(), cops, nops, ops, nullptr));
+             grpc_call_start_batch(call->call(), cops, nops,
+                                   call->cq()->CoreCqTag(ops), nullptr));
 }
 
 void* Channel::RegisterMethod(const char* method) {
@@ -318,7 +322,17 @@ void Channel::NotifyOnStateChangeImpl(grpc_connectivity_state last_observed,
                                       CompletionQueue* cq, void* tag) {
   TagSaver* tag_saver = new TagSaver(tag);
   grpc_channel_watch_connectivity_state(c_channel_, last_observed, deadline,
-                                        cq->cq(), tag_saver);
+                                        cq->cq(), cq->CoreCqTag(tag_saver));
+}
+
+CompletionQueue* Channel::CallbackCQ() {
+  std::lock_guard<std::mutex> lock(callback_cq_mu_);
+  if (callback_cq_ == nullptr) {
+    callback_cq_.reset(new CompletionQueue(grpc_completion_queue_attributes{
+        GRPC_CQ_CURRENT_VERSION, GRPC_CQ_CALLBACK, GRPC_CQ_DEFAULT_POLLING,
+        nullptr}));
+  }
+  return callback_cq_.get();
 }
 
 bool Channel::WaitForStateChangeImpl(grpc_connectivity_state last_observed,
@@ -17,6 +17,7 @@
 
 #include <grpc++/completion_queue.h>
 
+#include <algorithm>
 #include <memory>
 
 #include <grpc++/impl/grpc_library.h>
@@ -24,10 +25,42 @@
 #include <grpc/grpc.h>
 #include <grpc/support/log.h>
 
+#include "src/core/lib/surface/completion_queue.h"
+
 namespace grpc {
 
 static internal::GrpcLibraryInitializer g_gli_initializer;
 
+namespace {
+
+// The core tag of an operation on a callback completion queue: finalizes the
+// CompletionQueueTag the way Next would and runs the resulting user tag
+class CallbackCompletionTag final
+    : public grpc_experimental_completion_queue_functor {
+ public:
+  explicit CallbackCompletionTag(CompletionQueueTag* tag) : tag_(tag) {
+    functor_run = &CallbackCompletionTag::Run;
+    inlineable = 1;
+  }
+
+ private:
+  static void Run(grpc_experimental_completion_queue_functor* functor,
+                  int success) {
+    auto* self = static_cast<CallbackCompletionTag*>(functor);
+    void* tag = self->tag_;
+    bool ok = success != 0;
+    bool surfaced = self->tag_->FinalizeResult(&tag, &ok);
+    delete self;
+    if (surfaced) {
+      static_cast<experimental::CompletionCallback*>(tag)->Run(ok);
+    }
+  }
+
+  CompletionQueueTag* const tag_;
+};
+
+}  // namespace
+
 // 'CompletionQueue' constructor can safely call GrpcLibraryCodegen(false) here
 // i.e not have GrpcLibraryCodegen call grpc_init(). This is because, to create
 // a 'grpc_completion_queue' instance (which is being passed as the input to
@@ -50,6 +83,13 @@ void CompletionQueue::CompleteAvalanching() {
   }
 }
 
+void* CompletionQueue::CoreCqTag(CompletionQueueTag* tag) {
+  if (grpc_get_cq_completion_type(cq_) != GRPC_CQ_CALLBACK) {
+    return tag;
+  }
+  return new CallbackCompletionTag(tag);
+}
+
 CompletionQueue::NextStatus CompletionQueue::AsyncNextInternal(
     void** tag, bool* ok, gpr_timespec deadline) {
   for (;;) {
@@ -71,4 +111,36 @@ CompletionQueue::NextStatus CompletionQueue::AsyncNextInternal(
   }
 }
 
+size_t CompletionQueue::NextBatchInternal(void** tags, bool* oks,
+                                          size_t max_events,
+                                          gpr_timespec deadline) {
+  // Events whose tags swallow them in FinalizeResult don't count towards
+  // max_events, so keep reading until at least one is surfaced
+  static const size_t kMaxEventsPerRead = 32;
+  grpc_event events[kMaxEventsPerRead];
+  GPR_ASSERT(max_events > 0);
+  for (;;) {
+    size_t n = grpc_completion_queue_next_batch(
+        cq_, events, std::min(max_events, kMaxEventsPerRead), deadline,
+        nullptr);
+    if (events[0].type != GRPC_OP_COMPLETE) {
+      return 0;
+    }
+    size_t out = 0;
+    for (size_t i = 0; i < n; i++) {
+      auto cq_tag = static_cast<CompletionQueueTag*>(events[i].tag);
+      void* tag = cq_tag;
+      bool ok = events[i].success != 0;
+      if (cq_tag->FinalizeResult(&tag, &ok)) {
+        tags[out] = tag;
+        oks[out] = ok;
+        out++;
+      }
+    }
+    if (out > 0) {
+      return out;
+    }
+  }
+}
+
 }  // namespace grpc
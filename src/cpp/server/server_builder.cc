@@ -42,6 +42,7 @@ ServerBuilder::ServerBuilder()
     : max_receive_message_size_(-1),
       max_send_message_size_(-1),
       sync_server_settings_(SyncServerSettings()),
+      per_core_listeners_(false),
       resource_quota_(nullptr),
       generic_service_(nullptr) {
   gpr_once_init(&once_init_plugin_list, do_plugin_list_init);
@@ -74,6 +75,14 @@ std::unique_ptr<ServerCompletionQueue> ServerBuilder::AddCompletionQueue(
   return std::unique_ptr<ServerCompletionQueue>(cq);
 }
 
+std::unique_ptr<ServerCompletionQueue>
+ServerBuilder::AddCallbackCompletionQueue() {
+  ServerCompletionQueue* cq =
+      new ServerCompletionQueue(GRPC_CQ_CALLBACK, GRPC_CQ_DEFAULT_POLLING);
+  cqs_.push_back(cq);
+  return std::unique_ptr<ServerCompletionQueue>(cq);
+}
+
 ServerBuilder& ServerBuilder::RegisterService(Service* service) {
   services_.emplace_back(new NamedService(service));
   return *this;
@@ -123,6 +132,11 @@ ServerBuilder& ServerBuilder::SetSyncServerOption(
   return *this;
 }
 
+ServerBuilder& ServerBuilder::SetPerCoreListeners(bool enabled) {
+  per_core_listeners_ = enabled;
+  return *this;
+}
+
 ServerBuilder& ServerBuilder::SetCompressionAlgorithmSupportStatus(
     grpc_compression_algorithm algorithm, bool enabled) {
   if (enabled) {
@@ -210,6 +224,12 @@ std::unique_ptr<Server> ServerBuilder::BuildAndStart() {
                               grpc_resource_quota_arg_vtable());
   }
 
+  if (per_core_listeners_) {
+    args.SetInt(GRPC_ARG_PER_CORE_LISTENERS, 1);
+    sync_server_settings_.num_cqs =
+        GPR_MAX(1, static_cast<int>(gpr_cpu_num_cores()));
+  }
+
   // == Determine if the server has any syncrhonous methods ==
   bool has_sync_methods = false;
   for (auto it = services_.begin(); it != services_.end(); ++it) {
@@ -35,8 +35,12 @@
 #include <grpc++/support/time.h>
 #include <grpc/grpc.h>
 #include <grpc/support/alloc.h>
+#include <grpc/support/cpu.h>
 #include <grpc/support/log.h>
 
+extern "C" {
+#include "src/core/lib/channel/channel_args.h"
+}
 #include "src/core/ext/transport/inproc/inproc_transport.h"
 #include "src/core/lib/profiling/timers.h"
 #include "src/core/lib/surface/call.h"
@@ -377,16 +381,26 @@ Server::Server(
   global_callbacks_ = g_callbacks;
   global_callbacks_->UpdateArguments(args);
 
+  grpc_channel_args channel_args;
+  args->SetChannelArgs(&channel_args);
+
+  // In per-core mode the i-th listening completion queue receives the
+  // connections of CPU i: keep the threads serving it on that CPU as well
+  const bool per_core = grpc_channel_arg_get_integer(
+      grpc_channel_args_find(&channel_args, GRPC_ARG_PER_CORE_LISTENERS),
+      {0, 0, 1});
+  const unsigned num_cores = gpr_cpu_num_cores();
   for (auto it = sync_server_cqs_->begin(); it != sync_server_cqs_->end();
        it++) {
     sync_req_mgrs_.emplace_back(new SyncRequestThreadManager(
         this, (*it).get(), global_callbacks_, min_pollers, max_pollers,
         sync_cq_timeout_msec));
+    if (per_core && num_cores > 0) {
+      sync_req_mgrs_.back()->BindToCpu(
+          static_cast<unsigned>(sync_req_mgrs_.size() - 1) % num_cores);
+    }
   }
 
-  grpc_channel_args channel_args;
-  args->SetChannelArgs(&channel_args);
-
   for (size_t i = 0; i < channel_args.num_args; i++) {
     if (0 ==
         strcmp(channel_args.args[i].key, kHealthCheckServiceInterfaceArg)) {
@@ -608,7 +622,8 @@ void Server::PerformOpsOnCall(CallOpSetInterface* ops, Call* call) {
   size_t nops = 0;
   grpc_op cops[MAX_OPS];
   ops->FillOps(call->call(), cops, &nops);
-  auto result = grpc_call_start_batch(call->call(), cops, nops, ops, nullptr);
+  auto result = grpc_call_start_batch(call->call(), cops, nops,
+                                      call->cq()->CoreCqTag(ops), nullptr);
   if (result != GRPC_CALL_OK) {
     gpr_log(GPR_ERROR, "Fatal: grpc_call_start_batch returned %d", result);
     grpc_call_log_batch(__FILE__, __LINE__, GPR_LOG_SEVERITY_ERROR,
@@ -667,7 +682,8 @@ void ServerInterface::RegisteredAsyncRequest::IssueRequest(
                                  server_->server(), registered_method, &call_,
                                  &context_->deadline_,
                                  context_->client_metadata_.arr(), payload,
-                                 call_cq_->cq(), notification_cq->cq(), this));
+                                 call_cq_->cq(), notification_cq->cq(),
+                                 notification_cq->CoreCqTag(this)));
 }
 
 ServerInterface::GenericAsyncRequest::GenericAsyncRequest(
@@ -682,7 +698,8 @@ ServerInterface::GenericAsyncRequest::GenericAsyncRequest(
   GPR_ASSERT(GRPC_CALL_OK == grpc_server_request_call(
                                  server->server(), &call_, &call_details_,
                                  context->client_metadata_.arr(), call_cq->cq(),
-                                 notification_cq->cq(), this));
+                                 notification_cq->cq(),
+                                 notification_cq->CoreCqTag(this)));
 }
 
 bool ServerInterface::GenericAsyncRequest::FinalizeResult(void** tag,
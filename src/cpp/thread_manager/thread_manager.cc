@@ -22,6 +22,7 @@
 #include <mutex>
 #include <thread>
 
+#include <grpc/support/cpu.h>
 #include <grpc/support/log.h>
 
 namespace grpc {
@@ -35,6 +36,9 @@ ThreadManager::WorkerThread::WorkerThread(ThreadManager* thd_mgr)
 }
 
 void ThreadManager::WorkerThread::Run() {
+  if (thd_mgr_->cpu_ >= 0) {
+    gpr_cpu_set_affinity(static_cast<unsigned>(thd_mgr_->cpu_));
+  }
   thd_mgr_->MainWorkLoop();
   thd_mgr_->MarkAsCompleted(this);
 }
@@ -50,6 +54,7 @@ ThreadManager::ThreadManager(int min_pollers, int max_pollers)
       num_pollers_(0),
       min_pollers_(min_pollers),
       max_pollers_(max_pollers == -1 ? INT_MAX : max_pollers),
+      cpu_(-1),
       num_threads_(0) {}
 
 ThreadManager::~ThreadManager() {
@@ -61,6 +66,10 @@ ThreadManager::~ThreadManager() {
   CleanupCompletedThreads();
 }
 
+void ThreadManager::BindToCpu(unsigned cpu) {
+  cpu_ = static_cast<int>(cpu);
+}
+
 void ThreadManager::Wait() {
   std::unique_lock<std::mutex> lock(mu_);
   while (num_threads_ != 0) {
@@ -37,6 +37,10 @@ class ThreadManager {
   // Initializes and Starts the Rpc Manager threads
   void Initialize();
 
+  // Binds every thread started from now on to the given CPU. Must be called
+  // before Initialize()
+  void BindToCpu(unsigned cpu);
+
   // The return type of PollForWork() function
   enum WorkStatus { WORK_FOUND, SHUTDOWN, TIMEOUT };
 
@@ -125,6 +129,9 @@ class ThreadManager {
   int min_pollers_;
   int max_pollers_;
 
+  // The CPU to bind worker threads to, or -1 to leave them unbound
+  int cpu_;
+
   // The total number of threads (includes threads includes the threads that are
   // currently polling i.e num_pollers_)
   int num_threads_;
@@ -52,4 +52,13 @@ Slice::Slice(void* buf, size_t len, void (*destroy)(void*, size_t))
 
 grpc_slice Slice::c_slice() const { return grpc_slice_ref(slice_); }
 
+Status MapFileSlice(int fd, uint64_t offset, size_t length, Slice* slice) {
+  grpc_slice mapped;
+  if (!grpc_slice_map_file(fd, offset, length, &mapped)) {
+    return Status(StatusCode::INVALID_ARGUMENT, "Failed to map file range");
+  }
+  *slice = Slice(mapped, Slice::STEAL_REF);
+  return Status::OK;
+}
+
 }  // namespace grpc
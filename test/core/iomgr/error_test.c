@@ -199,6 +199,49 @@ static void test_special() {
   GRPC_ERROR_UNREF(error);
 }
 
+static void test_static() {
+  grpc_error* error = GRPC_ERROR_DEADLINE_EXCEEDED;
+  GPR_ASSERT(error == GRPC_ERROR_DEADLINE_EXCEEDED);
+  intptr_t i;
+  GPR_ASSERT(grpc_error_get_int(error, GRPC_ERROR_INT_GRPC_STATUS, &i));
+  GPR_ASSERT(i == GRPC_STATUS_DEADLINE_EXCEEDED);
+  grpc_slice str;
+  GPR_ASSERT(grpc_error_get_str(error, GRPC_ERROR_STR_DESCRIPTION, &str));
+  GPR_ASSERT(!strncmp((char*)GRPC_SLICE_START_PTR(str), "Deadline Exceeded",
+                      GRPC_SLICE_LENGTH(str)));
+  const char* s = grpc_error_string(error);
+  GPR_ASSERT(strstr(s, "Deadline Exceeded") != NULL);
+  GPR_ASSERT(grpc_error_string(error) == s);
+
+  // refs are free, and never release the error
+  for (int j = 0; j < 3; j++) GRPC_ERROR_UNREF(GRPC_ERROR_REF(error));
+  GRPC_ERROR_UNREF(error);
+  GPR_ASSERT(grpc_error_string(error) == s);
+
+  // modifying it copies it, even from a single ref
+  grpc_error* copy = grpc_error_set_str(
+      error, GRPC_ERROR_STR_GRPC_MESSAGE, grpc_slice_from_static_string("m"));
+  GPR_ASSERT(copy != error);
+  GPR_ASSERT(grpc_error_get_int(copy, GRPC_ERROR_INT_GRPC_STATUS, &i));
+  GPR_ASSERT(i == GRPC_STATUS_DEADLINE_EXCEEDED);
+  GPR_ASSERT(grpc_error_get_str(copy, GRPC_ERROR_STR_GRPC_MESSAGE, &str));
+  GPR_ASSERT(!grpc_error_get_str(error, GRPC_ERROR_STR_GRPC_MESSAGE, &str));
+  GPR_ASSERT(grpc_error_string(error) == s);
+  GRPC_ERROR_UNREF(copy);
+
+  error = grpc_error_add_child(GRPC_ERROR_SERVER_SHUTDOWN,
+                               GRPC_ERROR_CREATE_FROM_STATIC_STRING("child"));
+  GPR_ASSERT(error != GRPC_ERROR_SERVER_SHUTDOWN);
+  GPR_ASSERT(!grpc_error_get_int(GRPC_ERROR_SERVER_SHUTDOWN,
+                                 GRPC_ERROR_INT_GRPC_STATUS, NULL));
+  GRPC_ERROR_UNREF(error);
+
+  // a shutting down server's GOAWAY maps to NO_ERROR
+  GPR_ASSERT(grpc_error_get_int(GRPC_ERROR_SERVER_GOAWAY,
+                                GRPC_ERROR_INT_GRPC_STATUS, &i));
+  GPR_ASSERT(i == GRPC_STATUS_OK);
+}
+
 static void test_overflow() {
   grpc_error* error = GRPC_ERROR_CREATE_FROM_STATIC_STRING("Overflow");
 
@@ -238,6 +281,7 @@ int main(int argc, char** argv) {
   test_create_referencing();
   test_create_referencing_many();
   test_special();
+  test_static();
   test_overflow();
   grpc_shutdown();
 
@@ -0,0 +1,246 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include "src/core/lib/iomgr/port.h"
+
+/* This test only relevant on linux systems where io_uring is available */
+#ifdef GRPC_LINUX_IO_URING
+#include "src/core/lib/iomgr/ev_posix.h"
+#include "src/core/lib/iomgr/ev_uring_linux.h"
+
+#include <string.h>
+#include <unistd.h>
+
+#include <grpc/grpc.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/thd.h>
+#include <grpc/support/useful.h>
+
+#include "src/core/lib/iomgr/iomgr.h"
+#include "test/core/util/test_config.h"
+
+#define LOG_TEST(x) gpr_log(GPR_INFO, "%s", x)
+
+static grpc_pollset *g_pollset;
+static gpr_mu *g_mu;
+
+typedef struct notification {
+  grpc_closure closure;
+  bool done;
+  bool ok;
+} notification;
+
+static void on_notify(grpc_exec_ctx *exec_ctx, void *arg, grpc_error *error) {
+  notification *n = (notification *)arg;
+  gpr_mu_lock(g_mu);
+  n->done = true;
+  n->ok = error == GRPC_ERROR_NONE;
+  GPR_ASSERT(GRPC_LOG_IF_ERROR("kick",
+                               grpc_pollset_kick(exec_ctx, g_pollset, NULL)));
+  gpr_mu_unlock(g_mu);
+}
+
+static grpc_closure *notification_init(notification *n) {
+  n->done = false;
+  n->ok = false;
+  return GRPC_CLOSURE_INIT(&n->closure, on_notify, n,
+                           grpc_schedule_on_exec_ctx);
+}
+
+/* Polls until n has run or timeout_ms have passed; returns whether it ran */
+static bool poll_for(notification *n, int timeout_ms) {
+  gpr_timespec deadline = grpc_timeout_milliseconds_to_deadline(timeout_ms);
+  gpr_mu_lock(g_mu);
+  while (!n->done &&
+         gpr_time_cmp(gpr_now(deadline.clock_type), deadline) < 0) {
+    grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+    grpc_pollset_worker *worker = NULL;
+    GPR_ASSERT(GRPC_LOG_IF_ERROR(
+        "pollset_work",
+        grpc_pollset_work(&exec_ctx, g_pollset, &worker,
+                          gpr_now(GPR_CLOCK_MONOTONIC),
+                          gpr_convert_clock_type(deadline,
+                                                 GPR_CLOCK_MONOTONIC))));
+    gpr_mu_unlock(g_mu);
+    grpc_exec_ctx_finish(&exec_ctx);
+    gpr_mu_lock(g_mu);
+  }
+  bool done = n->done;
+  gpr_mu_unlock(g_mu);
+  return done;
+}
+
+static void orphan_fd(grpc_fd *fd, const char *reason) {
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  grpc_fd_orphan(&exec_ctx, fd, NULL, NULL, false /* already_closed */,
+                 reason);
+  grpc_exec_ctx_finish(&exec_ctx);
+}
+
+/* Readability and writability are reported through the multishot polls */
+static void test_readiness(void) {
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  notification readable, writable;
+  int p[2];
+
+  LOG_TEST("test_readiness");
+
+  GPR_ASSERT(pipe(p) == 0);
+  grpc_fd *rfd = grpc_fd_create(p[0], "test_readiness_r");
+  grpc_fd *wfd = grpc_fd_create(p[1], "test_readiness_w");
+  grpc_pollset_add_fd(&exec_ctx, g_pollset, rfd);
+  grpc_pollset_add_fd(&exec_ctx, g_pollset, wfd);
+  grpc_fd_notify_on_read(&exec_ctx, rfd, notification_init(&readable));
+  grpc_fd_notify_on_write(&exec_ctx, wfd, notification_init(&writable));
+  grpc_exec_ctx_finish(&exec_ctx);
+
+  GPR_ASSERT(poll_for(&writable, 5000));
+  GPR_ASSERT(writable.ok);
+  GPR_ASSERT(!poll_for(&readable, 50));
+  GPR_ASSERT(write(p[1], "x", 1) == 1);
+  GPR_ASSERT(poll_for(&readable, 5000));
+  GPR_ASSERT(readable.ok);
+
+  orphan_fd(rfd, "test_readiness_r");
+  orphan_fd(wfd, "test_readiness_w");
+}
+
+/* A grpc_fd orphaned while its poll still has a completion in flight goes
+   back to the freelist and is handed out again straight away. Those stale
+   completions must not be delivered to the next user, across more re-arms
+   than a narrow generation counter could tell apart. */
+#define NUM_REUSES 100
+
+static void test_stale_completions(void) {
+  notification n;
+
+  LOG_TEST("test_stale_completions");
+
+  for (int i = 0; i < NUM_REUSES; i++) {
+    grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+    int busy[2], idle[2];
+    GPR_ASSERT(pipe(busy) == 0);
+    GPR_ASSERT(pipe(idle) == 0);
+    GPR_ASSERT(write(busy[1], "x", 1) == 1);
+
+    grpc_fd *fd = grpc_fd_create(busy[0], "test_stale_busy");
+    grpc_exec_ctx_finish(&exec_ctx);
+    orphan_fd(fd, "test_stale_busy");
+
+    fd = grpc_fd_create(idle[0], "test_stale_idle");
+    grpc_fd_notify_on_read(&exec_ctx, fd, notification_init(&n));
+    grpc_exec_ctx_finish(&exec_ctx);
+    GPR_ASSERT(!poll_for(&n, 10));
+
+    grpc_fd_shutdown(&exec_ctx, fd,
+                     GRPC_ERROR_CREATE_FROM_STATIC_STRING("test_stale"));
+    grpc_exec_ctx_finish(&exec_ctx);
+    GPR_ASSERT(poll_for(&n, 5000));
+    GPR_ASSERT(!n.ok);
+    orphan_fd(fd, "test_stale_idle");
+
+    close(busy[1]);
+    close(idle[1]);
+  }
+}
+
+/* A worker blocked without a deadline is woken up by a kick */
+typedef struct kick_worker {
+  gpr_event started;
+  gpr_event finished;
+} kick_worker;
+
+static void kick_worker_thread(void *arg) {
+  kick_worker *w = (kick_worker *)arg;
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  grpc_pollset_worker *worker = NULL;
+  gpr_mu_lock(g_mu);
+  gpr_event_set(&w->started, (void *)1);
+  GPR_ASSERT(GRPC_LOG_IF_ERROR(
+      "pollset_work",
+      grpc_pollset_work(&exec_ctx, g_pollset, &worker,
+                        gpr_now(GPR_CLOCK_MONOTONIC),
+                        gpr_inf_future(GPR_CLOCK_MONOTONIC))));
+  gpr_mu_unlock(g_mu);
+  grpc_exec_ctx_finish(&exec_ctx);
+  gpr_event_set(&w->finished, (void *)1);
+}
+
+static void test_kick(void) {
+  kick_worker w;
+  gpr_thd_id id;
+  gpr_thd_options opt = gpr_thd_options_default();
+
+  LOG_TEST("test_kick");
+
+  gpr_event_init(&w.started);
+  gpr_event_init(&w.finished);
+  gpr_thd_options_set_joinable(&opt);
+  GPR_ASSERT(gpr_thd_new(&id, kick_worker_thread, &w, &opt));
+  GPR_ASSERT(gpr_event_wait(&w.started, grpc_timeout_seconds_to_deadline(5)));
+  /* let the worker block in io_uring_enter() */
+  gpr_sleep_until(grpc_timeout_milliseconds_to_deadline(20));
+
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  gpr_mu_lock(g_mu);
+  GPR_ASSERT(GRPC_LOG_IF_ERROR("kick",
+                               grpc_pollset_kick(&exec_ctx, g_pollset, NULL)));
+  gpr_mu_unlock(g_mu);
+  grpc_exec_ctx_finish(&exec_ctx);
+  GPR_ASSERT(gpr_event_wait(&w.finished, grpc_timeout_seconds_to_deadline(5)));
+  gpr_thd_join(id);
+}
+
+static void destroy_pollset(grpc_exec_ctx *exec_ctx, void *p,
+                            grpc_error *error) {
+  grpc_pollset_destroy(exec_ctx, (grpc_pollset *)p);
+}
+
+int main(int argc, char **argv) {
+  const char *poll_strategy = NULL;
+  grpc_closure destroyed;
+  grpc_test_init(argc, argv);
+  grpc_init();
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+
+  poll_strategy = grpc_get_poll_strategy_name();
+  if (poll_strategy != NULL && strcmp(poll_strategy, "uring") == 0) {
+    g_pollset = (grpc_pollset *)gpr_zalloc(grpc_pollset_size());
+    grpc_pollset_init(g_pollset, &g_mu);
+    test_readiness();
+    test_stale_completions();
+    test_kick();
+    GRPC_CLOSURE_INIT(&destroyed, destroy_pollset, g_pollset,
+                      grpc_schedule_on_exec_ctx);
+    grpc_pollset_shutdown(&exec_ctx, g_pollset, &destroyed);
+    grpc_exec_ctx_flush(&exec_ctx);
+    gpr_free(g_pollset);
+  } else {
+    gpr_log(GPR_INFO,
+            "Skipping the test. The test is only relevant for 'uring' "
+            "strategy. and the current strategy is: '%s'",
+            poll_strategy);
+  }
+
+  grpc_exec_ctx_finish(&exec_ctx);
+  grpc_shutdown();
+  return 0;
+}
+#else /* defined(GRPC_LINUX_IO_URING) */
+int main(int argc, char **argv) { return 0; }
+#endif /* !defined(GRPC_LINUX_IO_URING) */
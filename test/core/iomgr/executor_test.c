@@ -0,0 +1,184 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/lib/iomgr/executor.h"
+
+#include <grpc/grpc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+#include <grpc/support/thd.h>
+#include <grpc/support/time.h>
+#include <grpc/support/useful.h>
+
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "test/core/util/test_config.h"
+
+#define LOG_TEST(x) gpr_log(GPR_INFO, "%s", x)
+
+static gpr_atm g_run;
+
+static void wait_for_count(gpr_atm *count, gpr_atm want) {
+  gpr_timespec deadline = grpc_timeout_seconds_to_deadline(60);
+  while (gpr_atm_acq_load(count) != want) {
+    GPR_ASSERT(gpr_time_cmp(gpr_now(deadline.clock_type), deadline) < 0);
+    gpr_sleep_until(grpc_timeout_milliseconds_to_deadline(1));
+  }
+}
+
+static void count_run(grpc_exec_ctx *exec_ctx, void *arg, grpc_error *error) {
+  gpr_atm_full_fetch_add(&g_run, 1);
+}
+
+/* A job scheduled from an executor thread lands in that thread's own deque
+   (or the injector once the deque is full); fanning out from a few roots
+   leaves the other threads to steal */
+#define FAN_OUT_ROOTS 8
+#define FAN_OUT_CHILDREN 1000
+
+static void fan_out(grpc_exec_ctx *exec_ctx, void *arg, grpc_error *error) {
+  for (int i = 0; i < FAN_OUT_CHILDREN; i++) {
+    GRPC_CLOSURE_SCHED(exec_ctx,
+                       GRPC_CLOSURE_CREATE(count_run, NULL,
+                                           grpc_executor_scheduler(
+                                               GRPC_EXECUTOR_SHORT)),
+                       GRPC_ERROR_NONE);
+  }
+  gpr_atm_full_fetch_add(&g_run, 1);
+}
+
+static void test_steal(void) {
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+
+  LOG_TEST("test_steal");
+
+  gpr_atm_no_barrier_store(&g_run, 0);
+  for (int i = 0; i < FAN_OUT_ROOTS; i++) {
+    GRPC_CLOSURE_SCHED(&exec_ctx,
+                       GRPC_CLOSURE_CREATE(fan_out, NULL,
+                                           grpc_executor_scheduler(
+                                               GRPC_EXECUTOR_SHORT)),
+                       GRPC_ERROR_NONE);
+  }
+  grpc_exec_ctx_finish(&exec_ctx);
+  wait_for_count(&g_run, FAN_OUT_ROOTS * (FAN_OUT_CHILDREN + 1));
+}
+
+/* A long job that never returns its thread must not hold up short jobs,
+   including ones scheduled from the blocked job itself */
+#define SHORT_JOBS 100
+
+static gpr_event g_release_long_job;
+
+static void long_job(grpc_exec_ctx *exec_ctx, void *arg, grpc_error *error) {
+  for (int i = 0; i < SHORT_JOBS; i++) {
+    GRPC_CLOSURE_SCHED(exec_ctx,
+                       GRPC_CLOSURE_CREATE(count_run, NULL,
+                                           grpc_executor_scheduler(
+                                               GRPC_EXECUTOR_SHORT)),
+                       GRPC_ERROR_NONE);
+  }
+  grpc_exec_ctx_flush(exec_ctx);
+  GPR_ASSERT(gpr_event_wait(&g_release_long_job,
+                            grpc_timeout_seconds_to_deadline(60)));
+  gpr_atm_full_fetch_add(&g_run, 1);
+}
+
+static void test_long_job(void) {
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+
+  LOG_TEST("test_long_job");
+
+  gpr_atm_no_barrier_store(&g_run, 0);
+  gpr_event_init(&g_release_long_job);
+  GRPC_CLOSURE_SCHED(
+      &exec_ctx,
+      GRPC_CLOSURE_CREATE(long_job, NULL,
+                          grpc_executor_scheduler(GRPC_EXECUTOR_LONG)),
+      GRPC_ERROR_NONE);
+  for (int i = 0; i < SHORT_JOBS; i++) {
+    GRPC_CLOSURE_SCHED(&exec_ctx,
+                       GRPC_CLOSURE_CREATE(count_run, NULL,
+                                           grpc_executor_scheduler(
+                                               GRPC_EXECUTOR_SHORT)),
+                       GRPC_ERROR_NONE);
+  }
+  grpc_exec_ctx_finish(&exec_ctx);
+  wait_for_count(&g_run, 2 * SHORT_JOBS);
+  gpr_event_set(&g_release_long_job, (void *)1);
+  wait_for_count(&g_run, 2 * SHORT_JOBS + 1);
+}
+
+/* Jobs pushed from other threads while the executor shuts down are either
+   drained by the shutdown or run inline; none are lost or left queued */
+#define NUM_PUSHERS 4
+
+static gpr_atm g_pushed;
+static gpr_atm g_stop_pushing;
+
+static void pusher_thread(void *arg) {
+  while (!gpr_atm_acq_load(&g_stop_pushing)) {
+    grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+    grpc_executor_job_length length =
+        gpr_atm_no_barrier_load(&g_pushed) % 8 == 0 ? GRPC_EXECUTOR_LONG
+                                                     : GRPC_EXECUTOR_SHORT;
+    gpr_atm_full_fetch_add(&g_pushed, 1);
+    GRPC_CLOSURE_SCHED(
+        &exec_ctx,
+        GRPC_CLOSURE_CREATE(count_run, NULL, grpc_executor_scheduler(length)),
+        GRPC_ERROR_NONE);
+    grpc_exec_ctx_finish(&exec_ctx);
+  }
+}
+
+static void test_shutdown_while_pushing(void) {
+  gpr_thd_id thds[NUM_PUSHERS];
+
+  LOG_TEST("test_shutdown_while_pushing");
+
+  for (int round = 0; round < 10; round++) {
+    grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+    gpr_atm_no_barrier_store(&g_run, 0);
+    gpr_atm_no_barrier_store(&g_pushed, 0);
+    gpr_atm_no_barrier_store(&g_stop_pushing, 0);
+    for (size_t i = 0; i < GPR_ARRAY_SIZE(thds); i++) {
+      gpr_thd_options opt = gpr_thd_options_default();
+      gpr_thd_options_set_joinable(&opt);
+      GPR_ASSERT(gpr_thd_new(&thds[i], pusher_thread, NULL, &opt));
+    }
+    gpr_sleep_until(grpc_timeout_milliseconds_to_deadline(5));
+    grpc_executor_set_threading(&exec_ctx, false);
+    gpr_atm_rel_store(&g_stop_pushing, 1);
+    for (size_t i = 0; i < GPR_ARRAY_SIZE(thds); i++) {
+      gpr_thd_join(thds[i]);
+    }
+    grpc_exec_ctx_flush(&exec_ctx);
+    GPR_ASSERT(gpr_atm_acq_load(&g_run) == gpr_atm_acq_load(&g_pushed));
+    grpc_executor_set_threading(&exec_ctx, true);
+    grpc_exec_ctx_finish(&exec_ctx);
+  }
+}
+
+int main(int argc, char **argv) {
+  grpc_test_init(argc, argv);
+  grpc_init();
+  test_steal();
+  test_long_job();
+  test_shutdown_while_pushing();
+  grpc_shutdown();
+  return 0;
+}
@@ -25,17 +25,23 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <netinet/in.h>
 #include <string.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#ifdef GRPC_LINUX_ERRQUEUE
+#include <linux/errqueue.h>
+#endif
+
 #include <grpc/grpc.h>
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 #include <grpc/support/time.h>
 #include <grpc/support/useful.h>
 
+#include "src/core/lib/debug/stats.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "test/core/iomgr/endpoint_tests.h"
 #include "test/core/util/test_config.h"
@@ -68,6 +74,44 @@ static void create_sockets(int sv[2]) {
   GPR_ASSERT(fcntl(sv[1], F_SETFL, flags | O_NONBLOCK) == 0);
 }
 
+/* MSG_ZEROCOPY is only supported on inet sockets, so zerocopy tests need a
+   connected loopback TCP pair rather than a socketpair */
+static void create_inet_sockets(int sv[2]) {
+  struct sockaddr_in addr;
+  socklen_t len = sizeof(addr);
+  int flags;
+  int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+  GPR_ASSERT(listen_fd >= 0);
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  GPR_ASSERT(bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+  GPR_ASSERT(listen(listen_fd, 1) == 0);
+  GPR_ASSERT(getsockname(listen_fd, (struct sockaddr *)&addr, &len) == 0);
+  sv[0] = socket(AF_INET, SOCK_STREAM, 0);
+  GPR_ASSERT(sv[0] >= 0);
+  GPR_ASSERT(connect(sv[0], (struct sockaddr *)&addr, len) == 0);
+  sv[1] = accept(listen_fd, NULL, NULL);
+  GPR_ASSERT(sv[1] >= 0);
+  close(listen_fd);
+  flags = fcntl(sv[0], F_GETFL, 0);
+  GPR_ASSERT(fcntl(sv[0], F_SETFL, flags | O_NONBLOCK) == 0);
+  flags = fcntl(sv[1], F_GETFL, 0);
+  GPR_ASSERT(fcntl(sv[1], F_SETFL, flags | O_NONBLOCK) == 0);
+}
+
+/* Whether grpc_tcp can send with MSG_ZEROCOPY on fd: it needs the same
+   headers as tcp_posix.c and a kernel that accepts SO_ZEROCOPY */
+static bool zerocopy_supported(int fd) {
+#if defined(GRPC_LINUX_ERRQUEUE) && defined(SO_ZEROCOPY) && \
+    defined(SO_EE_ORIGIN_ZEROCOPY)
+  const int enable = 1;
+  return setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)) == 0;
+#else
+  return false;
+#endif
+}
+
 static ssize_t fill_socket(int fd) {
   ssize_t write_bytes;
   ssize_t total_bytes = 0;
@@ -343,8 +387,9 @@ void drain_socket_blocking(int fd, size_t num_bytes, size_t read_size) {
 
 /* Write to a socket using the grpc_tcp API, then drain it directly.
    Note that if the write does not complete immediately we need to drain the
-   socket in parallel with the read. */
-static void write_test(size_t num_bytes, size_t slice_size) {
+   socket in parallel with the read. If zerocopy is set, every write is
+   offered to the kernel with MSG_ZEROCOPY. */
+static void write_test(size_t num_bytes, size_t slice_size, bool zerocopy) {
   int sv[2];
   grpc_endpoint *ep;
   struct write_socket_state state;
@@ -355,16 +400,33 @@ static void write_test(size_t num_bytes, size_t slice_size) {
   grpc_closure write_done_closure;
   gpr_timespec deadline = grpc_timeout_seconds_to_deadline(20);
   grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  grpc_stats_data stats_begin, stats_end, stats;
+  bool expect_zerocopy = false;
 
   gpr_log(GPR_INFO,
-          "Start write test with %" PRIuPTR " bytes, slice size %" PRIuPTR,
-          num_bytes, slice_size);
-
-  create_sockets(sv);
+          "Start write test with %" PRIuPTR " bytes, slice size %" PRIuPTR
+          ", zerocopy %d",
+          num_bytes, slice_size, zerocopy);
+
+  if (zerocopy) {
+    create_inet_sockets(sv);
+    expect_zerocopy = zerocopy_supported(sv[1]);
+    if (!expect_zerocopy) {
+      gpr_log(GPR_INFO, "SO_ZEROCOPY unsupported, not checking zerocopy stats");
+    }
+  } else {
+    create_sockets(sv);
+  }
 
   grpc_arg a[] = {{.key = GRPC_ARG_TCP_READ_CHUNK_SIZE,
                    .type = GRPC_ARG_INTEGER,
-                   .value.integer = (int)slice_size}};
+                   .value.integer = (int)slice_size},
+                  {.key = GRPC_ARG_TCP_TX_ZEROCOPY_ENABLED,
+                   .type = GRPC_ARG_INTEGER,
+                   .value.integer = zerocopy},
+                  {.key = GRPC_ARG_TCP_TX_ZEROCOPY_SEND_BYTES_THRESHOLD,
+                   .type = GRPC_ARG_INTEGER,
+                   .value.integer = 0}};
   grpc_channel_args args = {.num_args = GPR_ARRAY_SIZE(a), .args = a};
   ep = grpc_tcp_create(&exec_ctx, grpc_fd_create(sv[1], "write_test"), &args,
                        "test");
@@ -380,7 +442,11 @@ static void write_test(size_t num_bytes, size_t slice_size) {
   GRPC_CLOSURE_INIT(&write_done_closure, write_done, &state,
                     grpc_schedule_on_exec_ctx);
 
+  grpc_stats_collect(&stats_begin);
   grpc_endpoint_write(&exec_ctx, ep, &outgoing, &write_done_closure);
+  /* run write_done now if the write completed inline: nothing else would wake
+     up the pollset for it on a loopback TCP socket */
+  grpc_exec_ctx_flush(&exec_ctx);
   drain_socket_blocking(sv[0], num_bytes, num_bytes);
   gpr_mu_lock(g_mu);
   for (;;) {
@@ -398,12 +464,180 @@ static void write_test(size_t num_bytes, size_t slice_size) {
   }
   gpr_mu_unlock(g_mu);
 
+  grpc_stats_collect(&stats_end);
+  grpc_stats_diff(&stats_end, &stats_begin, &stats);
+  if (expect_zerocopy) {
+    GPR_ASSERT(stats.counters[GRPC_STATS_COUNTER_TCP_WRITE_ZEROCOPY] > 0);
+  }
+
   grpc_slice_buffer_destroy_internal(&exec_ctx, &outgoing);
   grpc_endpoint_destroy(&exec_ctx, ep);
   gpr_free(slices);
   grpc_exec_ctx_finish(&exec_ctx);
 }
 
+/* Write num_bytes (continuing the pattern from *current_data) through ep and
+   wait for the write to complete, optionally announcing another write first */
+static void coalescing_write(grpc_endpoint *ep, size_t num_bytes,
+                             uint8_t *current_data, bool hint_more) {
+  struct write_socket_state state;
+  size_t num_blocks;
+  grpc_slice *slices;
+  grpc_slice_buffer outgoing;
+  grpc_closure write_done_closure;
+  gpr_timespec deadline = grpc_timeout_seconds_to_deadline(20);
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+
+  state.ep = ep;
+  state.write_done = 0;
+  slices = allocate_blocks(num_bytes, num_bytes, &num_blocks, current_data);
+  grpc_slice_buffer_init(&outgoing);
+  grpc_slice_buffer_addn(&outgoing, slices, num_blocks);
+  GRPC_CLOSURE_INIT(&write_done_closure, write_done, &state,
+                    grpc_schedule_on_exec_ctx);
+  if (hint_more) {
+    grpc_endpoint_hint_write_more(ep);
+  }
+  grpc_endpoint_write(&exec_ctx, ep, &outgoing, &write_done_closure);
+  grpc_exec_ctx_flush(&exec_ctx);
+  gpr_mu_lock(g_mu);
+  while (!state.write_done) {
+    grpc_pollset_worker *worker = NULL;
+    GPR_ASSERT(GRPC_LOG_IF_ERROR(
+        "pollset_work",
+        grpc_pollset_work(&exec_ctx, g_pollset, &worker,
+                          gpr_now(GPR_CLOCK_MONOTONIC), deadline)));
+    gpr_mu_unlock(g_mu);
+    grpc_exec_ctx_finish(&exec_ctx);
+    gpr_mu_lock(g_mu);
+  }
+  gpr_mu_unlock(g_mu);
+  grpc_slice_buffer_destroy_internal(&exec_ctx, &outgoing);
+  gpr_free(slices);
+  grpc_exec_ctx_finish(&exec_ctx);
+}
+
+/* A write announced to be followed by another is sent with MSG_MORE: check
+   that the following write, or else the coalescing budget, releases it */
+static void write_coalescing_test(void) {
+  int sv[2];
+  grpc_endpoint *ep;
+  uint8_t current_data = 0;
+  grpc_stats_data stats_begin, stats_end, stats;
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+
+  gpr_log(GPR_INFO, "Start write coalescing test");
+
+  create_inet_sockets(sv);
+
+  grpc_arg a[] = {{.key = GRPC_ARG_TCP_WRITE_COALESCING,
+                   .type = GRPC_ARG_INTEGER,
+                   .value.integer = 1},
+                  {.key = GRPC_ARG_TCP_WRITE_COALESCING_BUDGET_US,
+                   .type = GRPC_ARG_INTEGER,
+                   .value.integer = 1000}};
+  grpc_channel_args args = {.num_args = GPR_ARRAY_SIZE(a), .args = a};
+  ep = grpc_tcp_create(&exec_ctx, grpc_fd_create(sv[1], "write_coalescing"),
+                       &args, "test");
+  grpc_endpoint_add_to_pollset(&exec_ctx, ep, g_pollset);
+  grpc_exec_ctx_finish(&exec_ctx);
+
+  /* the announced write pushes out the corked one */
+  grpc_stats_collect(&stats_begin);
+  coalescing_write(ep, 100, &current_data, true);
+  coalescing_write(ep, 100, &current_data, false);
+  drain_socket_blocking(sv[0], 200, 200);
+  grpc_stats_collect(&stats_end);
+  grpc_stats_diff(&stats_end, &stats_begin, &stats);
+  GPR_ASSERT(stats.counters[GRPC_STATS_COUNTER_TCP_WRITE_CORKED] == 1);
+
+  /* with no write following, the budget timer pushes it out */
+  current_data = 0;
+  grpc_stats_collect(&stats_begin);
+  coalescing_write(ep, 100, &current_data, true);
+  drain_socket_blocking(sv[0], 100, 100);
+  grpc_stats_collect(&stats_end);
+  grpc_stats_diff(&stats_end, &stats_begin, &stats);
+  GPR_ASSERT(stats.counters[GRPC_STATS_COUNTER_TCP_WRITE_CORKED] == 1);
+  GPR_ASSERT(stats.counters[GRPC_STATS_COUNTER_TCP_WRITE_CORK_TIMEOUTS] == 1);
+
+  grpc_endpoint_destroy(&exec_ctx, ep);
+  grpc_exec_ctx_finish(&exec_ctx);
+  close(sv[0]);
+}
+
+/* Polls until state has read its target, or for timeout_ms if it never does */
+static void poll_read_state(struct read_socket_state *state, int timeout_ms) {
+  gpr_timespec deadline = grpc_timeout_milliseconds_to_deadline(timeout_ms);
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  gpr_mu_lock(g_mu);
+  while (state->read_bytes < state->target_read_bytes &&
+         gpr_time_cmp(gpr_now(deadline.clock_type), deadline) < 0) {
+    grpc_pollset_worker *worker = NULL;
+    GPR_ASSERT(GRPC_LOG_IF_ERROR(
+        "pollset_work",
+        grpc_pollset_work(&exec_ctx, g_pollset, &worker,
+                          gpr_now(GPR_CLOCK_MONOTONIC), deadline)));
+    gpr_mu_unlock(g_mu);
+    grpc_exec_ctx_finish(&exec_ctx);
+    gpr_mu_lock(g_mu);
+  }
+  gpr_mu_unlock(g_mu);
+  grpc_exec_ctx_finish(&exec_ctx);
+}
+
+/* With GRPC_ARG_IDLE_CONNECTION_MEMORY_RELEASE_MS, a read waiting for data
+   keeps its buffer until it has waited that long, then drops it */
+static void idle_read_release_test(void) {
+  int sv[2];
+  grpc_endpoint *ep;
+  struct read_socket_state state;
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+
+  gpr_log(GPR_INFO, "Start idle read release test");
+
+  create_sockets(sv);
+
+  grpc_arg a[] = {{.key = GRPC_ARG_IDLE_CONNECTION_MEMORY_RELEASE_MS,
+                   .type = GRPC_ARG_INTEGER,
+                   .value.integer = 200}};
+  grpc_channel_args args = {.num_args = GPR_ARRAY_SIZE(a), .args = a};
+  ep = grpc_tcp_create(&exec_ctx, grpc_fd_create(sv[1], "idle_read_release"),
+                       &args, "test");
+  grpc_endpoint_add_to_pollset(&exec_ctx, ep, g_pollset);
+
+  state.ep = ep;
+  state.read_bytes = 0;
+  /* a multiple of 256 bytes, so that the next write continues the pattern */
+  state.target_read_bytes = fill_socket_partial(sv[0], 256);
+  grpc_slice_buffer_init(&state.incoming);
+  GRPC_CLOSURE_INIT(&state.read_cb, read_cb, &state, grpc_schedule_on_exec_ctx);
+  grpc_endpoint_read(&exec_ctx, ep, &state.incoming, &state.read_cb);
+  grpc_exec_ctx_finish(&exec_ctx);
+  poll_read_state(&state, 20000);
+  GPR_ASSERT(state.read_bytes == state.target_read_bytes);
+
+  /* the next read allocates a buffer, finds no data and waits */
+  state.target_read_bytes += 100;
+  grpc_endpoint_read(&exec_ctx, ep, &state.incoming, &state.read_cb);
+  grpc_exec_ctx_finish(&exec_ctx);
+  poll_read_state(&state, 20);
+  GPR_ASSERT(state.incoming.count > 0);
+
+  poll_read_state(&state, 1000);
+  GPR_ASSERT(state.incoming.count == 0);
+
+  /* data arriving afterwards is read into a new buffer */
+  GPR_ASSERT(fill_socket_partial(sv[0], 100) == 100);
+  poll_read_state(&state, 20000);
+  GPR_ASSERT(state.read_bytes == state.target_read_bytes);
+
+  grpc_slice_buffer_destroy_internal(&exec_ctx, &state.incoming);
+  grpc_endpoint_destroy(&exec_ctx, ep);
+  grpc_exec_ctx_finish(&exec_ctx);
+  close(sv[0]);
+}
+
 void on_fd_released(grpc_exec_ctx *exec_ctx, void *arg, grpc_error *errors) {
   int *done = (int *)arg;
   *done = 1;
@@ -502,16 +736,28 @@ void run_tests(void) {
   large_read_test(8192);
   large_read_test(1);
 
-  write_test(100, 8192);
-  write_test(100, 1);
-  write_test(100000, 8192);
-  write_test(100000, 1);
-  write_test(100000, 137);
+  write_test(100, 8192, false);
+  write_test(100, 1, false);
+  write_test(100000, 8192, false);
+  write_test(100000, 1, false);
+  write_test(100000, 137, false);
 
   for (i = 1; i < 1000; i = GPR_MAX(i + 1, i * 5 / 4)) {
-    write_test(40320, i);
+    write_test(40320, i, false);
   }
 
+  write_test(100, 8192, true);
+  write_test(100, 1, true);
+  write_test(100000, 8192, true);
+  write_test(100000, 1, true);
+  write_test(100000, 137, true);
+
+#ifdef MSG_MORE
+  write_coalescing_test();
+#endif
+
+  idle_read_release_test();
+
   release_fd_test(100, 8192);
 }
 
@@ -50,6 +50,7 @@
 static gpr_mu *g_mu;
 static grpc_pollset *g_pollset;
 static int g_nconnects = 0;
+static grpc_pollset *g_accepting_pollset;
 
 typedef struct {
   /* Owns a ref to server. */
@@ -158,6 +159,7 @@ static void on_connect(grpc_exec_ctx *exec_ctx, void *arg, grpc_endpoint *tcp,
 
   gpr_mu_lock(g_mu);
   g_result = temp_result;
+  g_accepting_pollset = pollset;
   g_nconnects++;
   GPR_ASSERT(GRPC_LOG_IF_ERROR("pollset_kick",
                                grpc_pollset_kick(exec_ctx, g_pollset, NULL)));
@@ -432,6 +434,91 @@ static void destroy_pollset(grpc_exec_ctx *exec_ctx, void *p,
   grpc_pollset_destroy(exec_ctx, p);
 }
 
+/* With GRPC_ARG_PER_CORE_LISTENERS, each pollset gets its own listener for a
+   port, and connections accepted on a listener are bound to its pollset. */
+static void test_per_core_listeners(void) {
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  grpc_arg arg = {
+      GRPC_ARG_INTEGER, GRPC_ARG_PER_CORE_LISTENERS, {.integer = 1}};
+  const grpc_channel_args channel_args = {1, &arg};
+  grpc_resolved_address resolved_addr;
+  struct sockaddr_in *addr = (struct sockaddr_in *)resolved_addr.addr;
+  grpc_pollset *pollsets[2];
+  gpr_mu *mus[2];
+  grpc_closure destroyed;
+  grpc_tcp_server *s;
+  int port;
+  LOG_TEST("test_per_core_listeners");
+
+  pollsets[0] = g_pollset;
+  mus[0] = g_mu;
+  pollsets[1] = gpr_zalloc(grpc_pollset_size());
+  grpc_pollset_init(pollsets[1], &mus[1]);
+  GPR_ASSERT(GRPC_ERROR_NONE ==
+             grpc_tcp_server_create(&exec_ctx, NULL, &channel_args, &s));
+  memset(&resolved_addr, 0, sizeof(resolved_addr));
+  resolved_addr.len = sizeof(struct sockaddr_in);
+  addr->sin_family = AF_INET;
+  addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  GPR_ASSERT(GRPC_LOG_IF_ERROR(
+      "grpc_tcp_server_add_port",
+      grpc_tcp_server_add_port(s, &resolved_addr, &port)));
+  grpc_tcp_server_start(&exec_ctx, s, pollsets, 2, on_connect, NULL);
+
+  /* A single listener if SO_REUSEPORT is unavailable */
+  const unsigned num_fds = grpc_tcp_server_port_fd_count(s, 0);
+  GPR_ASSERT(num_fds == 1 || num_fds == 2);
+  grpc_sockaddr_set_port(&resolved_addr, port);
+  for (int i = 0; i < 10; i++) {
+    gpr_timespec deadline = grpc_timeout_seconds_to_deadline(10);
+    gpr_mu_lock(g_mu);
+    int nconnects_before = g_nconnects;
+    gpr_mu_unlock(g_mu);
+    int clifd = socket(AF_INET, SOCK_STREAM, 0);
+    GPR_ASSERT(clifd >= 0);
+    GPR_ASSERT(connect(clifd, (struct sockaddr *)resolved_addr.addr,
+                       (socklen_t)resolved_addr.len) == 0);
+    /* The connection may land on either listener: poll both pollsets */
+    bool connected = false;
+    while (!connected &&
+           gpr_time_cmp(deadline, gpr_now(deadline.clock_type)) > 0) {
+      for (size_t j = 0; j < 2; j++) {
+        grpc_pollset_worker *worker = NULL;
+        gpr_mu_lock(mus[j]);
+        GPR_ASSERT(GRPC_LOG_IF_ERROR(
+            "pollset_work",
+            grpc_pollset_work(&exec_ctx, pollsets[j], &worker,
+                              gpr_now(GPR_CLOCK_MONOTONIC),
+                              grpc_timeout_milliseconds_to_deadline(10))));
+        gpr_mu_unlock(mus[j]);
+        grpc_exec_ctx_finish(&exec_ctx);
+      }
+      gpr_mu_lock(g_mu);
+      connected = g_nconnects != nconnects_before;
+      gpr_mu_unlock(g_mu);
+    }
+    close(clifd);
+    GPR_ASSERT(connected);
+    gpr_mu_lock(g_mu);
+    on_connect_result result = g_result;
+    grpc_pollset *accepting_pollset = g_accepting_pollset;
+    gpr_mu_unlock(g_mu);
+    gpr_log(GPR_INFO, "Accepted on fd_index %d", result.fd_index);
+    if (num_fds == 2) {
+      /* fd_index 1 is the clone, which joined the reuseport group second */
+      GPR_ASSERT(accepting_pollset == pollsets[result.fd_index]);
+    }
+    grpc_tcp_server_unref(&exec_ctx, result.server);
+  }
+
+  grpc_tcp_server_unref(&exec_ctx, s);
+  GRPC_CLOSURE_INIT(&destroyed, destroy_pollset, pollsets[1],
+                    grpc_schedule_on_exec_ctx);
+  grpc_pollset_shutdown(&exec_ctx, pollsets[1], &destroyed);
+  grpc_exec_ctx_finish(&exec_ctx);
+  gpr_free(pollsets[1]);
+}
+
 int main(int argc, char **argv) {
   grpc_closure destroyed;
   grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
@@ -492,6 +579,8 @@ int main(int argc, char **argv) {
   /* Test connect(2) with dst_addrs. */
   test_connect(10, &channel_args, dst_addrs, false);
 
+  test_per_core_listeners();
+
   GRPC_CLOSURE_INIT(&destroyed, destroy_pollset, g_pollset,
                     grpc_schedule_on_exec_ctx);
   grpc_pollset_shutdown(&exec_ctx, g_pollset, &destroyed);
@@ -26,6 +26,7 @@
 #include <string.h>
 
 #include <grpc/support/log.h>
+#include <grpc/support/useful.h>
 #include "src/core/lib/debug/trace.h"
 #include "test/core/util/test_config.h"
 
@@ -167,11 +168,76 @@ void destruction_test(void) {
   GPR_ASSERT(1 == cb_called[2][0]);
 }
 
+/* Timers far apart, so that the timing wheel has to move them down through
+   its levels before they fire. None may fire early. The deadlines are spaced
+   out because rounding to milliseconds can push large ones back by one. */
+void cascade_test(void) {
+  static const int64_t deadlines_ms[] = {
+      1,        62,        65,         4093,       4096,     4099,
+      262141,   262144,    300000,     16777216,   86400000, 1073741821,
+      1073741824, 3456000000};
+  const int n = (int)GPR_ARRAY_SIZE(deadlines_ms);
+  grpc_timer timers[GPR_ARRAY_SIZE(deadlines_ms)];
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  int i;
+  int j;
+
+  gpr_log(GPR_INFO, "cascade_test");
+
+  grpc_timer_list_init(gpr_time_0(GPR_CLOCK_REALTIME));
+  grpc_timer_trace.value = 0;
+  grpc_timer_check_trace.value = 0;
+  memset(cb_called, 0, sizeof(cb_called));
+
+  for (i = 0; i < n; i++) {
+    grpc_timer_init(
+        &exec_ctx, &timers[i],
+        gpr_time_from_millis(deadlines_ms[i], GPR_CLOCK_REALTIME),
+        GRPC_CLOSURE_CREATE(cb, (void *)(intptr_t)i, grpc_schedule_on_exec_ctx),
+        gpr_time_0(GPR_CLOCK_REALTIME));
+  }
+  /* cancel one of them while it is still parked in a high level */
+  grpc_timer_cancel(&exec_ctx, &timers[n - 4]);
+  grpc_exec_ctx_finish(&exec_ctx);
+  GPR_ASSERT(1 == cb_called[n - 4][0]);
+
+  for (i = 0; i < n; i++) {
+    grpc_timer_check(
+        &exec_ctx,
+        gpr_time_from_millis(deadlines_ms[i] - 1, GPR_CLOCK_REALTIME), NULL);
+    grpc_exec_ctx_finish(&exec_ctx);
+    for (j = 0; j < n; j++) {
+      GPR_ASSERT(cb_called[j][1] == (j < i && j != n - 4));
+    }
+    grpc_timer_check(
+        &exec_ctx,
+        gpr_time_from_millis(deadlines_ms[i] + 1, GPR_CLOCK_REALTIME), NULL);
+    grpc_exec_ctx_finish(&exec_ctx);
+    for (j = 0; j < n; j++) {
+      GPR_ASSERT(cb_called[j][1] == (j <= i && j != n - 4));
+    }
+  }
+
+  grpc_timer_list_shutdown(&exec_ctx);
+  grpc_exec_ctx_finish(&exec_ctx);
+  for (j = 0; j < n; j++) {
+    GPR_ASSERT(cb_called[j][0] == (j == n - 4));
+  }
+}
+
 int main(int argc, char **argv) {
   grpc_test_init(argc, argv);
   gpr_set_log_verbosity(GPR_LOG_SEVERITY_DEBUG);
+  gpr_log(GPR_INFO, "timer heap");
+  grpc_timer_set_impl(&grpc_timer_heap_vtable);
+  add_test();
+  destruction_test();
+  cascade_test();
+  gpr_log(GPR_INFO, "timer wheel");
+  grpc_timer_set_impl(&grpc_timer_wheel_vtable);
   add_test();
   destruction_test();
+  cascade_test();
   return 0;
 }
 
@@ -178,6 +178,40 @@ static struct grpc_memory_counters send_snapshot_request(int call_idx,
   return snapshot;
 }
 
+// Create a channel of its own connection (the index arg keeps subchannels
+// from being shared) and wait until it is connected.
+static grpc_channel *create_idle_channel(const char *target, int index,
+                                         int idle_memory_release_ms) {
+  grpc_arg args[] = {{.type = GRPC_ARG_INTEGER,
+                      .key = GRPC_ARG_IDLE_CONNECTION_MEMORY_RELEASE_MS,
+                      .value.integer = idle_memory_release_ms},
+                     {.type = GRPC_ARG_INTEGER,
+                      .key = "grpc.memory_usage.idle_channel_index",
+                      .value.integer = index}};
+  grpc_channel_args channel_args = {GPR_ARRAY_SIZE(args), args};
+  grpc_channel *idle_channel =
+      grpc_insecure_channel_create(target, &channel_args, NULL);
+  grpc_connectivity_state state =
+      grpc_channel_check_connectivity_state(idle_channel, 1);
+  while (state != GRPC_CHANNEL_READY) {
+    grpc_channel_watch_connectivity_state(
+        idle_channel, state, gpr_inf_future(GPR_CLOCK_REALTIME), cq, tag(0));
+    grpc_completion_queue_next(cq, gpr_inf_future(GPR_CLOCK_REALTIME), NULL);
+    state = grpc_channel_check_connectivity_state(idle_channel, 1);
+  }
+  return idle_channel;
+}
+
+// Poll for ms milliseconds so that timers get to run.
+static void poll_for(int ms) {
+  gpr_timespec deadline =
+      gpr_time_add(gpr_now(GPR_CLOCK_REALTIME),
+                   gpr_time_from_millis(ms, GPR_TIMESPAN));
+  while (gpr_time_cmp(gpr_now(GPR_CLOCK_REALTIME), deadline) < 0) {
+    grpc_completion_queue_next(cq, deadline, NULL);
+  }
+}
+
 int main(int argc, char **argv) {
   grpc_memory_counters_init();
   grpc_slice slice = grpc_slice_from_copied_string("x");
@@ -195,12 +229,19 @@ int main(int argc, char **argv) {
 
   int warmup_iterations = 100;
   int benchmark_iterations = 1000;
+  int idle_connections = 0;
+  int idle_memory_release_ms = 0;
 
   cl = gpr_cmdline_create("memory profiling client");
   gpr_cmdline_add_string(cl, "target", "Target host:port", &target);
   gpr_cmdline_add_int(cl, "warmup", "Warmup iterations", &warmup_iterations);
   gpr_cmdline_add_int(cl, "benchmark", "Benchmark iterations",
                       &benchmark_iterations);
+  gpr_cmdline_add_int(cl, "idle_connections", "Idle connections to measure",
+                      &idle_connections);
+  gpr_cmdline_add_int(cl, "idle_memory_release_ms",
+                      "Release idle connection memory after this many ms",
+                      &idle_memory_release_ms);
   gpr_cmdline_parse(cl, argc, argv);
   gpr_cmdline_destroy(cl);
 
@@ -268,6 +309,35 @@ int main(int argc, char **argv) {
   struct grpc_memory_counters client_channel_end =
       grpc_memory_counters_snapshot();
 
+  // idle connections: measured once connected, and again once they have been
+  // idle for longer than the release period
+  struct grpc_memory_counters client_idle_start = client_channel_end;
+  struct grpc_memory_counters client_idle_connected = client_channel_end;
+  struct grpc_memory_counters client_idle_end = client_channel_end;
+  struct grpc_memory_counters server_idle_start = server_calls_end;
+  struct grpc_memory_counters server_idle_connected = server_calls_end;
+  struct grpc_memory_counters server_idle_end = server_calls_end;
+  if (idle_connections > 0) {
+    grpc_channel **idle_channels = (grpc_channel **)gpr_malloc(
+        sizeof(*idle_channels) * (size_t)idle_connections);
+    client_idle_start = grpc_memory_counters_snapshot();
+    for (int i = 0; i < idle_connections; i++) {
+      idle_channels[i] =
+          create_idle_channel(target, i, idle_memory_release_ms);
+    }
+    client_idle_connected = grpc_memory_counters_snapshot();
+    server_idle_connected = send_snapshot_request(
+        0, grpc_slice_from_static_string("Reflector/SimpleSnapshot"));
+    poll_for(2 * idle_memory_release_ms + 1000);
+    client_idle_end = grpc_memory_counters_snapshot();
+    server_idle_end = send_snapshot_request(
+        0, grpc_slice_from_static_string("Reflector/SimpleSnapshot"));
+    for (int i = 0; i < idle_connections; i++) {
+      grpc_channel_destroy(idle_channels[i]);
+    }
+    gpr_free(idle_channels);
+  }
+
   grpc_channel_destroy(channel);
   grpc_completion_queue_shutdown(cq);
 
@@ -289,6 +359,19 @@ int main(int argc, char **argv) {
           client_channel_end.total_size_relative -
               client_channel_start.total_size_relative);
 
+  if (idle_connections > 0) {
+    gpr_log(GPR_INFO,
+            "client idle connection memory usage: %f bytes per connection "
+            "once connected, %f bytes after %d ms idle",
+            (double)(client_idle_connected.total_size_relative -
+                     client_idle_start.total_size_relative) /
+                idle_connections,
+            (double)(client_idle_end.total_size_relative -
+                     client_idle_start.total_size_relative) /
+                idle_connections,
+            2 * idle_memory_release_ms + 1000);
+  }
+
   gpr_log(GPR_INFO, "---------server stats--------");
   gpr_log(GPR_INFO, "server create: %zi bytes",
           after_server_create.total_size_relative -
@@ -300,6 +383,18 @@ int main(int argc, char **argv) {
   gpr_log(GPR_INFO, "server channel memory usage %zi bytes",
           server_calls_end.total_size_relative -
               after_server_create.total_size_relative);
+  if (idle_connections > 0) {
+    gpr_log(GPR_INFO,
+            "server idle connection memory usage: %f bytes per connection "
+            "once connected, %f bytes after %d ms idle",
+            (double)(server_idle_connected.total_size_relative -
+                     server_idle_start.total_size_relative) /
+                idle_connections,
+            (double)(server_idle_end.total_size_relative -
+                     server_idle_start.total_size_relative) /
+                idle_connections,
+            2 * idle_memory_release_ms + 1000);
+  }
 
   const char *csv_file = "memory_usage.csv";
   FILE *csv = fopen(csv_file, "w");
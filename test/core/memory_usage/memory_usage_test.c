@@ -47,7 +47,8 @@ int main(int argc, char **argv) {
   args[1] = "--bind";
   gpr_join_host_port(&args[2], "::", port);
   args[3] = "--no-secure";
-  svr = gpr_subprocess_create(4, (const char **)args);
+  args[4] = "--idle_memory_release_ms=500";
+  svr = gpr_subprocess_create(5, (const char **)args);
   gpr_free(args[0]);
   gpr_free(args[2]);
 
@@ -58,7 +59,9 @@ int main(int argc, char **argv) {
   gpr_join_host_port(&args[2], "127.0.0.1", port);
   args[3] = "--warmup=1000";
   args[4] = "--benchmark=9000";
-  cli = gpr_subprocess_create(5, (const char **)args);
+  args[5] = "--idle_connections=100";
+  args[6] = "--idle_memory_release_ms=500";
+  cli = gpr_subprocess_create(7, (const char **)args);
   gpr_free(args[0]);
   gpr_free(args[2]);
 
@@ -152,6 +152,7 @@ int main(int argc, char **argv) {
 
   int secure = 0;
   char *addr = NULL;
+  int idle_memory_release_ms = 0;
 
   char *fake_argv[1];
 
@@ -165,6 +166,9 @@ int main(int argc, char **argv) {
   cl = gpr_cmdline_create("fling server");
   gpr_cmdline_add_string(cl, "bind", "Bind host:port", &addr);
   gpr_cmdline_add_flag(cl, "secure", "Run with security?", &secure);
+  gpr_cmdline_add_int(cl, "idle_memory_release_ms",
+                      "Release idle connection memory after this many ms",
+                      &idle_memory_release_ms);
   gpr_cmdline_parse(cl, argc, argv);
   gpr_cmdline_destroy(cl);
 
@@ -176,6 +180,11 @@ int main(int argc, char **argv) {
 
   cq = grpc_completion_queue_create_for_next(NULL);
 
+  grpc_arg arg = {.type = GRPC_ARG_INTEGER,
+                  .key = GRPC_ARG_IDLE_CONNECTION_MEMORY_RELEASE_MS,
+                  .value.integer = idle_memory_release_ms};
+  grpc_channel_args args = {1, &arg};
+
   struct grpc_memory_counters before_server_create =
       grpc_memory_counters_snapshot();
   if (secure) {
@@ -183,11 +192,11 @@ int main(int argc, char **argv) {
                                                     test_server1_cert};
     grpc_server_credentials *ssl_creds = grpc_ssl_server_credentials_create(
         NULL, &pem_key_cert_pair, 1, 0, NULL);
-    server = grpc_server_create(NULL, NULL);
+    server = grpc_server_create(&args, NULL);
     GPR_ASSERT(grpc_server_add_secure_http2_port(server, addr, ssl_creds));
     grpc_server_credentials_release(ssl_creds);
   } else {
-    server = grpc_server_create(NULL, NULL);
+    server = grpc_server_create(&args, NULL);
     GPR_ASSERT(grpc_server_add_insecure_http2_port(server, addr));
   }
 
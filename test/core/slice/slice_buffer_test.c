@@ -16,6 +16,8 @@
  *
  */
 
+#include <string.h>
+
 #include <grpc/slice_buffer.h>
 #include <grpc/support/log.h>
 #include "test/core/util/test_config.h"
@@ -104,11 +106,74 @@ void test_slice_buffer_move_first() {
   GPR_ASSERT(dst.length == dst_len);
 }
 
+static grpc_slice numbered_slice(uint32_t n) {
+  return grpc_slice_from_copied_buffer((const char *)&n, sizeof(n));
+}
+
+static uint32_t slice_number(grpc_slice slice) {
+  uint32_t n;
+  GPR_ASSERT(GRPC_SLICE_LENGTH(slice) == sizeof(n));
+  memcpy(&n, GRPC_SLICE_START_PTR(slice), sizeof(n));
+  return n;
+}
+
+void test_slice_buffer_fifo() {
+  grpc_slice_buffer buf;
+  uint32_t next_in = 0;
+  uint32_t next_out = 0;
+  size_t resident;
+
+  grpc_slice_buffer_init(&buf);
+  for (resident = 1; resident <= 100; resident += 33) {
+    while (buf.count < resident) {
+      grpc_slice_buffer_add_indexed(&buf, numbered_slice(next_in++));
+    }
+    for (int i = 0; i < 1000; i++) {
+      grpc_slice slice = grpc_slice_buffer_take_first(&buf);
+      GPR_ASSERT(slice_number(slice) == next_out);
+      if (i % 3 == 0) {
+        grpc_slice_buffer_undo_take_first(&buf, slice);
+      } else {
+        grpc_slice_unref(slice);
+        next_out++;
+        grpc_slice_buffer_add_indexed(&buf, numbered_slice(next_in++));
+      }
+      GPR_ASSERT(buf.count == resident);
+      GPR_ASSERT(buf.length == resident * sizeof(uint32_t));
+    }
+    /* the space consumed from the front is reused rather than grown into */
+    GPR_ASSERT(buf.capacity <=
+               3 * resident + GRPC_SLICE_BUFFER_INLINE_ELEMENTS);
+  }
+  for (size_t i = 0; i < buf.count; i++) {
+    GPR_ASSERT(slice_number(buf.slices[i]) == next_out + i);
+  }
+  grpc_slice_buffer_destroy(&buf);
+}
+
+void test_slice_buffer_undo_take_first_after_reset() {
+  grpc_slice_buffer buf;
+  grpc_slice_buffer_init(&buf);
+  for (uint32_t i = 0; i < 20; i++) {
+    grpc_slice_buffer_add_indexed(&buf, numbered_slice(i));
+  }
+  grpc_slice first = grpc_slice_buffer_take_first(&buf);
+  grpc_slice_buffer_reset_and_unref(&buf);
+  grpc_slice_buffer_add_indexed(&buf, numbered_slice(1));
+  grpc_slice_buffer_undo_take_first(&buf, first);
+  GPR_ASSERT(buf.count == 2);
+  GPR_ASSERT(slice_number(buf.slices[0]) == 0);
+  GPR_ASSERT(slice_number(buf.slices[1]) == 1);
+  grpc_slice_buffer_destroy(&buf);
+}
+
 int main(int argc, char **argv) {
   grpc_test_init(argc, argv);
 
   test_slice_buffer_add();
   test_slice_buffer_move_first();
+  test_slice_buffer_fifo();
+  test_slice_buffer_undo_take_first_after_reset();
 
   return 0;
 }
@@ -0,0 +1,127 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <grpc/slice.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/useful.h>
+
+#include "src/core/lib/support/tmpfile.h"
+#include "test/core/util/test_config.h"
+
+#define LOG_TEST_NAME(x) gpr_log(GPR_INFO, "%s", x)
+
+/* spans a few pages, whatever the page size */
+#define FILE_SIZE (3 * 65536 + 123)
+
+static const char prefix[] = "slice_mmap_test";
+
+static uint8_t byte_at(size_t offset) { return (uint8_t)(offset * 7 + 3); }
+
+/* returns a read-only descriptor for a freshly written file of FILE_SIZE */
+static int create_file(char **name) {
+  FILE *f = gpr_tmpfile(prefix, name);
+  GPR_ASSERT(f != NULL);
+  for (size_t i = 0; i < FILE_SIZE; i++) {
+    GPR_ASSERT(fputc(byte_at(i), f) != EOF);
+  }
+  GPR_ASSERT(fclose(f) == 0);
+  int fd = open(*name, O_RDONLY);
+  GPR_ASSERT(fd >= 0);
+  return fd;
+}
+
+static void check_range(grpc_slice slice, size_t offset, size_t length) {
+  GPR_ASSERT(GRPC_SLICE_LENGTH(slice) == length);
+  for (size_t i = 0; i < length; i++) {
+    GPR_ASSERT(GRPC_SLICE_START_PTR(slice)[i] == byte_at(offset + i));
+  }
+}
+
+static void test_map_ranges(void) {
+  static const size_t ranges[][2] = {
+      {0, FILE_SIZE}, {0, 1}, {1, 100}, {4095, 2}, {65536 + 17, 70000},
+      {FILE_SIZE - 1, 1}};
+  char *name;
+
+  LOG_TEST_NAME("test_map_ranges");
+
+  int fd = create_file(&name);
+  for (size_t i = 0; i < GPR_ARRAY_SIZE(ranges); i++) {
+    grpc_slice slice;
+    GPR_ASSERT(
+        grpc_slice_map_file(fd, ranges[i][0], ranges[i][1], &slice));
+    check_range(slice, ranges[i][0], ranges[i][1]);
+    grpc_slice_unref(slice);
+  }
+  close(fd);
+  remove(name);
+  gpr_free(name);
+}
+
+static void test_outlives_file(void) {
+  char *name;
+  grpc_slice slice;
+
+  LOG_TEST_NAME("test_outlives_file");
+
+  int fd = create_file(&name);
+  GPR_ASSERT(grpc_slice_map_file(fd, 1000, 100000, &slice));
+  close(fd);
+  remove(name);
+  gpr_free(name);
+
+  /* pieces keep the mapping alive after the original is gone */
+  grpc_slice tail = grpc_slice_split_tail(&slice, 50000);
+  grpc_slice middle = grpc_slice_sub(slice, 10, 20000);
+  grpc_slice_unref(slice);
+  check_range(tail, 51000, 50000);
+  grpc_slice_unref(tail);
+  check_range(middle, 1010, 19990);
+  grpc_slice_unref(middle);
+}
+
+static void test_empty_and_failure(void) {
+  char *name;
+  grpc_slice slice;
+
+  LOG_TEST_NAME("test_empty_and_failure");
+
+  int fd = create_file(&name);
+  GPR_ASSERT(grpc_slice_map_file(fd, 10, 0, &slice));
+  GPR_ASSERT(GRPC_SLICE_LENGTH(slice) == 0);
+  grpc_slice_unref(slice);
+  close(fd);
+  remove(name);
+  gpr_free(name);
+
+  GPR_ASSERT(!grpc_slice_map_file(-1, 0, 100, &slice));
+}
+
+int main(int argc, char **argv) {
+  grpc_test_init(argc, argv);
+  test_map_ranges();
+  test_outlives_file();
+  test_empty_and_failure();
+  return 0;
+}
@@ -0,0 +1,124 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/lib/slice/slice_internal.h"
+
+#include <string.h>
+
+#include <grpc/grpc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/thd.h>
+
+#include "src/core/lib/debug/stats.h"
+#include "test/core/util/memory_counters.h"
+#include "test/core/util/test_config.h"
+
+#define NUM_SLICES 1000
+#define NUM_THREADS 4
+/* few enough to fit in the thread cache and depot */
+#define NUM_RECYCLED_SLICES 256
+
+static void fill_and_unref(grpc_slice *slices, size_t n, size_t length) {
+  for (size_t i = 0; i < n; i++) {
+    slices[i] = grpc_slice_malloc(length);
+    GPR_ASSERT(GRPC_SLICE_LENGTH(slices[i]) == length);
+    memset(GRPC_SLICE_START_PTR(slices[i]), (int)i, length);
+  }
+  for (size_t i = 0; i < n; i++) {
+    GPR_ASSERT(GRPC_SLICE_START_PTR(slices[i])[length - 1] == (uint8_t)i);
+    grpc_slice_unref(slices[i]);
+  }
+}
+
+static void test_no_caching_before_init(void) {
+  gpr_log(GPR_INFO, "test_no_caching_before_init");
+  grpc_slice slices[NUM_SLICES];
+  fill_and_unref(slices, NUM_SLICES, 100);
+  GPR_ASSERT(grpc_slice_pool_cached_bytes() == 0);
+}
+
+static void test_recycles(void) {
+  gpr_log(GPR_INFO, "test_recycles");
+  grpc_slice slices[NUM_SLICES];
+  grpc_stats_data before;
+  grpc_stats_data after;
+  grpc_init();
+  fill_and_unref(slices, NUM_RECYCLED_SLICES, 100);
+  GPR_ASSERT(grpc_slice_pool_cached_bytes() > 0);
+  grpc_stats_collect(&before);
+  fill_and_unref(slices, NUM_RECYCLED_SLICES, 100);
+  grpc_stats_collect(&after);
+  /* every block comes back from the thread cache or the depot */
+  GPR_ASSERT(after.counters[GRPC_STATS_COUNTER_SLICE_POOL_HITS] -
+                 before.counters[GRPC_STATS_COUNTER_SLICE_POOL_HITS] ==
+             NUM_RECYCLED_SLICES);
+  GPR_ASSERT(after.counters[GRPC_STATS_COUNTER_SLICE_POOL_MISSES] ==
+             before.counters[GRPC_STATS_COUNTER_SLICE_POOL_MISSES]);
+  GPR_ASSERT(after.counters[GRPC_STATS_COUNTER_SLICE_POOL_DEPOT_PUTS] >
+             before.counters[GRPC_STATS_COUNTER_SLICE_POOL_DEPOT_PUTS]);
+  /* too large to pool: still works */
+  fill_and_unref(slices, 10, 65536);
+  grpc_shutdown();
+}
+
+static void thread_body(void *arg) {
+  grpc_slice *slices = (grpc_slice *)arg;
+  /* free what the main thread allocated, then churn through this thread's
+     own cache */
+  for (size_t i = 0; i < NUM_SLICES; i++) {
+    grpc_slice_unref(slices[i]);
+  }
+  for (int i = 0; i < 10; i++) {
+    fill_and_unref(slices, NUM_SLICES, (size_t)(50 + 300 * i));
+  }
+}
+
+static void test_shutdown_releases_everything(void) {
+  gpr_log(GPR_INFO, "test_shutdown_releases_everything");
+  static grpc_slice slices[NUM_THREADS][NUM_SLICES];
+  gpr_thd_id threads[NUM_THREADS];
+  grpc_memory_counters_init();
+  grpc_init();
+  for (int t = 0; t < NUM_THREADS; t++) {
+    for (size_t i = 0; i < NUM_SLICES; i++) {
+      slices[t][i] = grpc_slice_malloc(200);
+    }
+  }
+  for (int t = 0; t < NUM_THREADS; t++) {
+    gpr_thd_options options = gpr_thd_options_default();
+    gpr_thd_options_set_joinable(&options);
+    GPR_ASSERT(gpr_thd_new(&threads[t], thread_body, slices[t], &options));
+  }
+  for (int t = 0; t < NUM_THREADS; t++) {
+    gpr_thd_join(threads[t]);
+  }
+  fill_and_unref(slices[0], NUM_SLICES, 1000);
+  grpc_shutdown();
+  GPR_ASSERT(grpc_slice_pool_cached_bytes() == 0);
+  struct grpc_memory_counters counters = grpc_memory_counters_snapshot();
+  grpc_memory_counters_destroy();
+  GPR_ASSERT(counters.total_size_relative == 0);
+}
+
+int main(int argc, char **argv) {
+  grpc_test_init(argc, argv);
+  test_no_caching_before_init();
+  test_recycles();
+  test_shutdown_releases_everything();
+  return 0;
+}
@@ -0,0 +1,145 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/lib/surface/arena_pool.h"
+
+#include <string.h>
+
+#include <grpc/grpc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/thd.h>
+#include <grpc/support/useful.h>
+
+#include "src/core/lib/debug/stats.h"
+#include "test/core/util/test_config.h"
+
+#define NUM_THREADS 4
+
+/* create an arena of initial_size, fill allocated bytes of it and release
+   it, returning the arena (for identity checks only); allocated must be a
+   multiple of the alignment */
+static gpr_arena *use_arena(size_t initial_size, size_t allocated) {
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  gpr_arena *arena = grpc_arena_pool_create(&exec_ctx, initial_size);
+  uint8_t *p = (uint8_t *)gpr_arena_alloc(arena, allocated);
+  for (size_t i = 0; i < allocated; i++) {
+    /* memory is zeroed, recycled or not */
+    GPR_ASSERT(p[i] == 0);
+  }
+  memset(p, 0xff, allocated);
+  GPR_ASSERT(grpc_arena_pool_destroy(&exec_ctx, arena) >= allocated);
+  grpc_exec_ctx_finish(&exec_ctx);
+  return arena;
+}
+
+static void test_no_caching_before_init(void) {
+  gpr_log(GPR_INFO, "test_no_caching_before_init");
+  use_arena(1000, 96);
+  GPR_ASSERT(grpc_arena_pool_cached_bytes() == 0);
+  GPR_ASSERT(grpc_arena_pool_resource_quota() == NULL);
+}
+
+static void test_recycles(void) {
+  gpr_log(GPR_INFO, "test_recycles");
+  grpc_stats_data before;
+  grpc_stats_data after;
+  grpc_init();
+  grpc_stats_collect(&before);
+  gpr_arena *arena = use_arena(3000, 3008);
+  GPR_ASSERT(grpc_arena_pool_cached_bytes() == 4096);
+  /* a smaller arena is served from the same size class or a larger one */
+  GPR_ASSERT(use_arena(2000, 4000) == arena);
+  GPR_ASSERT(use_arena(100, 4096) == arena);
+  /* outgrowing the first buffer does not stop the arena being recycled */
+  GPR_ASSERT(use_arena(4096, 20000) == arena);
+  GPR_ASSERT(grpc_arena_pool_cached_bytes() == 4096);
+  grpc_stats_collect(&after);
+  GPR_ASSERT(after.counters[GRPC_STATS_COUNTER_CALL_ARENA_POOL_HITS] -
+                 before.counters[GRPC_STATS_COUNTER_CALL_ARENA_POOL_HITS] ==
+             3);
+  GPR_ASSERT(after.counters[GRPC_STATS_COUNTER_CALL_ARENA_POOL_MISSES] -
+                 before.counters[GRPC_STATS_COUNTER_CALL_ARENA_POOL_MISSES] ==
+             1);
+  /* too large to pool: still works */
+  use_arena(1024 * 1024, 96);
+  GPR_ASSERT(grpc_arena_pool_cached_bytes() == 4096);
+  grpc_shutdown();
+  GPR_ASSERT(grpc_arena_pool_cached_bytes() == 0);
+}
+
+/* create n arenas of size bytes before releasing any of them */
+static void use_arenas(size_t n, size_t size) {
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  gpr_arena *arenas[8];
+  GPR_ASSERT(n <= GPR_ARRAY_SIZE(arenas));
+  for (size_t i = 0; i < n; i++) {
+    arenas[i] = grpc_arena_pool_create(&exec_ctx, size);
+  }
+  for (size_t i = 0; i < n; i++) {
+    grpc_arena_pool_destroy(&exec_ctx, arenas[i]);
+  }
+  grpc_exec_ctx_finish(&exec_ctx);
+}
+
+static void test_retention_bound(void) {
+  gpr_log(GPR_INFO, "test_retention_bound");
+  grpc_init();
+  grpc_resource_quota *resource_quota = grpc_arena_pool_resource_quota();
+  GPR_ASSERT(grpc_resource_quota_get_memory_pressure(resource_quota) == 0);
+  grpc_resource_quota_resize(resource_quota, 128 * 1024);
+  use_arenas(4, 64 * 1024);
+  GPR_ASSERT(grpc_arena_pool_cached_bytes() == 128 * 1024);
+  /* the cached memory is charged to the quota */
+  GPR_ASSERT(grpc_resource_quota_get_memory_pressure(resource_quota) > 0);
+  use_arenas(8, 1024);
+  GPR_ASSERT(grpc_arena_pool_cached_bytes() <= 128 * 1024);
+  grpc_shutdown();
+}
+
+static void thread_body(void *arg) { use_arenas(1, 64 * 1024); }
+
+static void test_thread_exit_returns_quota(void) {
+  gpr_log(GPR_INFO, "test_thread_exit_returns_quota");
+  grpc_init();
+  grpc_resource_quota_resize(grpc_arena_pool_resource_quota(),
+                             NUM_THREADS * 64 * 1024);
+  gpr_thd_id threads[NUM_THREADS];
+  for (int i = 0; i < NUM_THREADS; i++) {
+    gpr_thd_options opt = gpr_thd_options_default();
+    gpr_thd_options_set_joinable(&opt);
+    GPR_ASSERT(gpr_thd_new(&threads[i], thread_body, NULL, &opt));
+  }
+  for (int i = 0; i < NUM_THREADS; i++) {
+    gpr_thd_join(threads[i]);
+  }
+  /* every thread's reservation came back when it exited */
+  use_arenas(4, 64 * 1024);
+  GPR_ASSERT(grpc_arena_pool_cached_bytes() == NUM_THREADS * 64 * 1024);
+  grpc_shutdown();
+}
+
+int main(int argc, char **argv) {
+  grpc_test_init(argc, argv);
+  test_no_caching_before_init();
+  test_recycles();
+  test_retention_bound();
+  test_thread_exit_returns_quota();
+  /* caching resumes after a restart */
+  test_recycles();
+  return 0;
+}
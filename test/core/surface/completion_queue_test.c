@@ -20,8 +20,11 @@
 
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+#include <grpc/support/thd.h>
 #include <grpc/support/time.h>
 #include <grpc/support/useful.h>
+#include "src/core/lib/debug/stats.h"
 #include "src/core/lib/iomgr/iomgr.h"
 #include "test/core/util/test_config.h"
 
@@ -158,6 +161,143 @@ static void test_cq_end_op(void) {
   }
 }
 
+static void test_next_batch(void) {
+  grpc_event events[16];
+  grpc_completion_queue *cc;
+  grpc_cq_completion completions[40];
+  void *tags[GPR_ARRAY_SIZE(completions)];
+  grpc_completion_queue_attributes attr;
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  size_t num_events;
+  size_t next = 0;
+
+  LOG_TEST("test_next_batch");
+
+  attr.version = 1;
+  attr.cq_completion_type = GRPC_CQ_NEXT;
+  attr.cq_polling_type = GRPC_CQ_DEFAULT_POLLING;
+  cc = grpc_completion_queue_create(grpc_completion_queue_factory_lookup(&attr),
+                                    &attr, NULL);
+
+  for (size_t i = 0; i < GPR_ARRAY_SIZE(completions); i++) {
+    tags[i] = create_test_tag();
+    GPR_ASSERT(grpc_cq_begin_op(cc, tags[i]));
+    grpc_cq_end_op(&exec_ctx, cc, tags[i],
+                   (i % 2) == 0 ? GRPC_ERROR_NONE : GRPC_ERROR_CANCELLED,
+                   do_nothing_end_completion, NULL, &completions[i]);
+  }
+
+  /* Events come back in order, at most GPR_ARRAY_SIZE(events) at a time */
+  while (next < GPR_ARRAY_SIZE(completions)) {
+    num_events = grpc_completion_queue_next_batch(
+        cc, events, GPR_ARRAY_SIZE(events), gpr_inf_past(GPR_CLOCK_REALTIME),
+        NULL);
+    GPR_ASSERT(num_events ==
+               GPR_MIN(GPR_ARRAY_SIZE(events),
+                       GPR_ARRAY_SIZE(completions) - next));
+    for (size_t i = 0; i < num_events; i++, next++) {
+      GPR_ASSERT(events[i].type == GRPC_OP_COMPLETE);
+      GPR_ASSERT(events[i].tag == tags[next]);
+      GPR_ASSERT(events[i].success == ((next % 2) == 0));
+    }
+  }
+
+  num_events = grpc_completion_queue_next_batch(
+      cc, events, GPR_ARRAY_SIZE(events), gpr_inf_past(GPR_CLOCK_REALTIME),
+      NULL);
+  GPR_ASSERT(num_events == 1);
+  GPR_ASSERT(events[0].type == GRPC_QUEUE_TIMEOUT);
+
+  grpc_completion_queue_shutdown(cc);
+  num_events = grpc_completion_queue_next_batch(
+      cc, events, GPR_ARRAY_SIZE(events), gpr_inf_past(GPR_CLOCK_REALTIME),
+      NULL);
+  GPR_ASSERT(num_events == 1);
+  GPR_ASSERT(events[0].type == GRPC_QUEUE_SHUTDOWN);
+  grpc_completion_queue_destroy(cc);
+  grpc_exec_ctx_finish(&exec_ctx);
+}
+
+/* Queue more events than fit in the event queue's ring, so that some spill
+   over, and check they are all returned in order */
+static void test_many_events(void) {
+  grpc_event ev;
+  grpc_completion_queue *cc;
+  static grpc_cq_completion completions[2000];
+  static void *tags[GPR_ARRAY_SIZE(completions)];
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+
+  LOG_TEST("test_many_events");
+
+  cc = grpc_completion_queue_create_for_next(NULL);
+
+  for (int round = 0; round < 2; round++) {
+    for (size_t i = 0; i < GPR_ARRAY_SIZE(completions); i++) {
+      tags[i] = create_test_tag();
+      GPR_ASSERT(grpc_cq_begin_op(cc, tags[i]));
+      grpc_cq_end_op(&exec_ctx, cc, tags[i], GRPC_ERROR_NONE,
+                     do_nothing_end_completion, NULL, &completions[i]);
+    }
+    for (size_t i = 0; i < GPR_ARRAY_SIZE(completions); i++) {
+      ev = grpc_completion_queue_next(cc, gpr_inf_past(GPR_CLOCK_REALTIME),
+                                      NULL);
+      GPR_ASSERT(ev.type == GRPC_OP_COMPLETE);
+      GPR_ASSERT(ev.tag == tags[i]);
+    }
+    ev = grpc_completion_queue_next(cc, gpr_inf_past(GPR_CLOCK_REALTIME), NULL);
+    GPR_ASSERT(ev.type == GRPC_QUEUE_TIMEOUT);
+  }
+
+  shutdown_and_destroy(cc);
+  grpc_exec_ctx_finish(&exec_ctx);
+}
+
+static void test_busy_poll(void) {
+  grpc_event ev;
+  grpc_completion_queue *cc;
+  grpc_cq_completion completion;
+  grpc_stats_data stats_begin, stats_end, stats;
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  void *tag = create_test_tag();
+
+  LOG_TEST("test_busy_poll");
+
+  cc = grpc_completion_queue_create_for_next(NULL);
+  grpc_cq_enable_busy_poll(cc, 1000);
+
+  /* Nothing to find: spin through the window, then block until the deadline */
+  grpc_stats_collect(&stats_begin);
+  ev = grpc_completion_queue_next(
+      cc, grpc_timeout_milliseconds_to_deadline(20), NULL);
+  GPR_ASSERT(ev.type == GRPC_QUEUE_TIMEOUT);
+  grpc_stats_collect(&stats_end);
+  grpc_stats_diff(&stats_end, &stats_begin, &stats);
+  GPR_ASSERT(stats.counters[GRPC_STATS_COUNTER_CQ_BUSY_POLL_SPINS] > 0);
+  GPR_ASSERT(stats.counters[GRPC_STATS_COUNTER_CQ_BUSY_POLL_MISSES] == 1);
+  GPR_ASSERT(grpc_stats_histo_count(
+                 &stats, GRPC_STATS_HISTOGRAM_CQ_BUSY_POLL_SPIN_US) == 1);
+  GPR_ASSERT(grpc_stats_histo_count(
+                 &stats, GRPC_STATS_HISTOGRAM_CQ_BUSY_POLL_WORK_US) == 0);
+
+  /* Events are still returned straight away, and one that was queued before
+     any spinning does not count as a hit */
+  GPR_ASSERT(grpc_cq_begin_op(cc, tag));
+  grpc_cq_end_op(&exec_ctx, cc, tag, GRPC_ERROR_NONE,
+                 do_nothing_end_completion, NULL, &completion);
+  grpc_stats_collect(&stats_begin);
+  ev = grpc_completion_queue_next(cc, gpr_inf_future(GPR_CLOCK_REALTIME), NULL);
+  GPR_ASSERT(ev.type == GRPC_OP_COMPLETE);
+  GPR_ASSERT(ev.tag == tag);
+  grpc_stats_collect(&stats_end);
+  grpc_stats_diff(&stats_end, &stats_begin, &stats);
+  GPR_ASSERT(stats.counters[GRPC_STATS_COUNTER_CQ_BUSY_POLL_HITS] == 0);
+  GPR_ASSERT(grpc_stats_histo_count(
+                 &stats, GRPC_STATS_HISTOGRAM_CQ_BUSY_POLL_WORK_US) == 1);
+
+  shutdown_and_destroy(cc);
+  grpc_exec_ctx_finish(&exec_ctx);
+}
+
 static void test_shutdown_then_next_polling(void) {
   grpc_cq_polling_type polling_types[] = {
       GRPC_CQ_DEFAULT_POLLING, GRPC_CQ_NON_LISTENING, GRPC_CQ_NON_POLLING};
@@ -289,6 +429,76 @@ struct thread_state {
   void *tag;
 };
 
+typedef struct test_functor {
+  grpc_experimental_completion_queue_functor functor;
+  gpr_thd_id run_on;
+  int success;
+  gpr_event done;
+} test_functor;
+
+static void test_functor_run(grpc_experimental_completion_queue_functor *f,
+                             int success) {
+  test_functor *t = (test_functor *)f;
+  t->run_on = gpr_thd_currentid();
+  t->success = success;
+  gpr_event_set(&t->done, (void *)1);
+}
+
+static void test_functor_init(test_functor *t, int inlineable) {
+  t->functor.functor_run = test_functor_run;
+  t->functor.inlineable = inlineable;
+  gpr_event_init(&t->done);
+}
+
+static void test_callback(void) {
+  grpc_completion_queue *cc;
+  grpc_cq_completion completions[2];
+  test_functor functors[GPR_ARRAY_SIZE(completions)];
+  test_functor shutdown;
+
+  LOG_TEST("test_callback");
+
+  test_functor_init(&shutdown, 0);
+  cc = grpc_completion_queue_create_for_callback(&shutdown.functor, NULL);
+  GPR_ASSERT(grpc_get_cq_completion_type(cc) == GRPC_CQ_CALLBACK);
+
+  /* An inlineable functor runs on the thread that completes its operation,
+     once its exec_ctx is flushed; the other one on the executor */
+  for (size_t i = 0; i < GPR_ARRAY_SIZE(completions); i++) {
+    grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+    test_functor_init(&functors[i], i == 0);
+    GPR_ASSERT(grpc_cq_begin_op(cc, &functors[i].functor));
+    grpc_cq_end_op(&exec_ctx, cc, &functors[i].functor,
+                   i == 0 ? GRPC_ERROR_NONE : GRPC_ERROR_CANCELLED,
+                   do_nothing_end_completion, NULL, &completions[i]);
+    if (i == 0) GPR_ASSERT(gpr_event_get(&functors[i].done) == NULL);
+    grpc_exec_ctx_finish(&exec_ctx);
+    GPR_ASSERT(gpr_event_wait(&functors[i].done,
+                              grpc_timeout_seconds_to_deadline(5)) != NULL);
+    GPR_ASSERT(functors[i].success == (i == 0));
+    if (i == 0) GPR_ASSERT(functors[i].run_on == gpr_thd_currentid());
+  }
+
+  /* The shutdown callback only runs once every pending operation is done */
+  grpc_cq_completion completion;
+  test_functor last;
+  test_functor_init(&last, 1);
+  GPR_ASSERT(grpc_cq_begin_op(cc, &last.functor));
+  grpc_completion_queue_shutdown(cc);
+  GPR_ASSERT(gpr_event_wait(&shutdown.done,
+                            grpc_timeout_milliseconds_to_deadline(100)) ==
+             NULL);
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  grpc_cq_end_op(&exec_ctx, cc, &last.functor, GRPC_ERROR_NONE,
+                 do_nothing_end_completion, NULL, &completion);
+  grpc_exec_ctx_finish(&exec_ctx);
+  GPR_ASSERT(gpr_event_get(&last.done) != NULL);
+  GPR_ASSERT(gpr_event_wait(&shutdown.done,
+                            grpc_timeout_seconds_to_deadline(5)) != NULL);
+  GPR_ASSERT(shutdown.success);
+  grpc_completion_queue_destroy(cc);
+}
+
 int main(int argc, char **argv) {
   grpc_test_init(argc, argv);
   grpc_init();
@@ -298,8 +508,12 @@ int main(int argc, char **argv) {
   test_shutdown_then_next_polling();
   test_shutdown_then_next_with_timeout();
   test_cq_end_op();
+  test_next_batch();
+  test_many_events();
+  test_busy_poll();
   test_pluck();
   test_pluck_after_shutdown();
+  test_callback();
   grpc_shutdown();
   return 0;
 }
@@ -0,0 +1,115 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/lib/surface/method_table.h"
+
+#include <grpc/grpc.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/string_util.h>
+#include <grpc/support/useful.h>
+
+#include "test/core/util/test_config.h"
+
+static void *lookup(grpc_method_table *table, const char *path,
+                    const char *host, uint32_t flags) {
+  /* non-interned slices, as a call's metadata may be */
+  grpc_slice path_slice = grpc_slice_from_copied_string(path);
+  grpc_slice host_slice = grpc_slice_from_copied_string(host);
+  void *value = grpc_method_table_lookup(table, path_slice, host_slice, flags);
+  grpc_slice_unref(path_slice);
+  grpc_slice_unref(host_slice);
+  return value;
+}
+
+static void test_empty(void) {
+  gpr_log(GPR_INFO, "test_empty");
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  grpc_method_table *table = grpc_method_table_create(NULL, 0);
+  GPR_ASSERT(lookup(table, "/a/b", "host", 0) == NULL);
+  grpc_method_table_destroy(&exec_ctx, table);
+  grpc_exec_ctx_finish(&exec_ctx);
+}
+
+static void test_hosts_and_flags(void) {
+  gpr_log(GPR_INFO, "test_hosts_and_flags");
+  int values[5];
+  const grpc_method_table_entry entries[] = {
+      {"/svc/Any", NULL, 0, &values[0]},
+      {"/svc/Both", NULL, 0, &values[1]},
+      {"/svc/Both", "foo.test", 0, &values[2]},
+      {"/svc/Idempotent", NULL, GRPC_INITIAL_METADATA_IDEMPOTENT_REQUEST,
+       &values[3]},
+      {"/svc/HostOnly", "foo.test", 0, &values[4]},
+  };
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  grpc_method_table *table =
+      grpc_method_table_create(entries, GPR_ARRAY_SIZE(entries));
+  GPR_ASSERT(lookup(table, "/svc/Any", "foo.test", 0) == &values[0]);
+  GPR_ASSERT(lookup(table, "/svc/Any", "bar.test", 0) == &values[0]);
+  /* an exact host match wins over any host */
+  GPR_ASSERT(lookup(table, "/svc/Both", "foo.test", 0) == &values[2]);
+  GPR_ASSERT(lookup(table, "/svc/Both", "bar.test", 0) == &values[1]);
+  GPR_ASSERT(lookup(table, "/svc/HostOnly", "foo.test", 0) == &values[4]);
+  GPR_ASSERT(lookup(table, "/svc/HostOnly", "bar.test", 0) == NULL);
+  GPR_ASSERT(lookup(table, "/svc/Idempotent", "foo.test", 0) == NULL);
+  GPR_ASSERT(lookup(table, "/svc/Idempotent", "foo.test",
+                    GRPC_INITIAL_METADATA_IDEMPOTENT_REQUEST) == &values[3]);
+  GPR_ASSERT(lookup(table, "/svc/Missing", "foo.test", 0) == NULL);
+  grpc_method_table_destroy(&exec_ctx, table);
+  grpc_exec_ctx_finish(&exec_ctx);
+}
+
+static void test_many(size_t n) {
+  gpr_log(GPR_INFO, "test_many: %" PRIuPTR, n);
+  grpc_method_table_entry *entries =
+      (grpc_method_table_entry *)gpr_malloc(sizeof(*entries) * n);
+  char **paths = (char **)gpr_malloc(sizeof(*paths) * n);
+  for (size_t i = 0; i < n; i++) {
+    gpr_asprintf(&paths[i], "/pkg.Service%" PRIuPTR "/Method", i);
+    entries[i].method = paths[i];
+    entries[i].host = NULL;
+    entries[i].flags = 0;
+    entries[i].value = &paths[i];
+  }
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  grpc_method_table *table = grpc_method_table_create(entries, n);
+  for (size_t i = 0; i < n; i++) {
+    GPR_ASSERT(lookup(table, paths[i], "host", 0) == &paths[i]);
+  }
+  GPR_ASSERT(lookup(table, "/pkg.Service/Method", "host", 0) == NULL);
+  grpc_method_table_destroy(&exec_ctx, table);
+  grpc_exec_ctx_finish(&exec_ctx);
+  for (size_t i = 0; i < n; i++) {
+    gpr_free(paths[i]);
+  }
+  gpr_free(paths);
+  gpr_free(entries);
+}
+
+int main(int argc, char **argv) {
+  grpc_test_init(argc, argv);
+  grpc_init();
+  test_empty();
+  test_hosts_and_flags();
+  for (size_t n = 1; n <= 4096; n *= 4) {
+    test_many(n);
+  }
+  grpc_shutdown();
+  return 0;
+}
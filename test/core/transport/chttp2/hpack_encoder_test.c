@@ -26,6 +26,7 @@
 #include <grpc/support/string_util.h>
 
 #include "src/core/ext/transport/chttp2/transport/hpack_parser.h"
+#include "src/core/lib/debug/stats.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "src/core/lib/slice/slice_string_helpers.h"
 #include "src/core/lib/support/string.h"
@@ -143,6 +144,52 @@ static void test_basic_headers(grpc_exec_ctx *exec_ctx) {
          "a", "v");
 }
 
+static int64_t cached_blocks_sent(void) {
+  grpc_stats_data stats;
+  grpc_stats_collect(&stats);
+  return stats.counters[GRPC_STATS_COUNTER_HPACK_SEND_CACHED_BLOCK];
+}
+
+static void test_cached_blocks(grpc_exec_ctx *exec_ctx) {
+  verify(exec_ctx, 0, false, false, 0, "000005 0104 deadbeef 40 0161 0161", 1,
+         "a", "a");
+  /* all indexed: this encoding gets cached... */
+  verify(exec_ctx, 0, false, false, 0, "000001 0104 deadbeef be", 1, "a", "a");
+  int64_t start = cached_blocks_sent();
+  /* ... and replayed, with the frame flags of each call */
+  verify(exec_ctx, 0, false, false, 0, "000001 0104 deadbeef be", 1, "a", "a");
+  verify(exec_ctx, 0, true, false, 0, "000001 0105 deadbeef be", 1, "a", "a");
+  GPR_ASSERT(cached_blocks_sent() - start == 2);
+  /* adding to the decoder table moves "a: a", so the cached encoding must
+     not be used again */
+  verify(exec_ctx, 0, false, false, 0, "000005 0104 deadbeef 40 0162 0162", 1,
+         "b", "b");
+  verify(exec_ctx, 0, false, false, 0, "000001 0104 deadbeef bf", 1, "a", "a");
+  GPR_ASSERT(cached_blocks_sent() - start == 2);
+  verify(exec_ctx, 0, false, false, 0, "000001 0104 deadbeef bf", 1, "a", "a");
+  GPR_ASSERT(cached_blocks_sent() - start == 3);
+}
+
+static void test_release_memory(grpc_exec_ctx *exec_ctx) {
+  verify(exec_ctx, 0, false, false, 0, "000005 0104 deadbeef 40 0161 0161", 1,
+         "a", "a");
+  verify(exec_ctx, 0, false, false, 0, "000001 0104 deadbeef be", 1, "a", "a");
+  /* sized for the whole decoder table until released */
+  GPR_ASSERT(g_compressor.cap_table_elems == g_compressor.max_table_elems);
+  grpc_chttp2_hpack_compressor_release_memory(exec_ctx, &g_compressor);
+  GPR_ASSERT(g_compressor.tables == NULL);
+  GPR_ASSERT(g_compressor.cap_table_elems == 1);
+  /* the compressor forgot what it sent, so "a: a" is added again... */
+  verify(exec_ctx, 0, false, false, 0, "000005 0104 deadbeef 40 0161 0161", 1,
+         "a", "a");
+  verify(exec_ctx, 0, false, false, 0, "000001 0104 deadbeef be", 1, "a", "a");
+  /* ... but it still accounts for the decoder's copy of the first one */
+  verify(exec_ctx, 0, false, false, 0, "000005 0104 deadbeef 40 0162 0162", 1,
+         "b", "b");
+  verify(exec_ctx, 0, false, false, 0, "000001 0104 deadbeef bf", 1, "a", "a");
+  GPR_ASSERT(g_compressor.table_elems == 3);
+}
+
 static void encode_int_to_str(int i, char *p) {
   p[0] = (char)('a' + i % 26);
   i /= 26;
@@ -245,6 +292,8 @@ int main(int argc, char **argv) {
   TEST(test_basic_headers);
   TEST(test_decode_table_overflow);
   TEST(test_encode_header_size);
+  TEST(test_cached_blocks);
+  TEST(test_release_memory);
   grpc_shutdown();
   for (i = 0; i < num_to_delete; i++) {
     gpr_free(to_delete[i]);
@@ -46,6 +46,19 @@ int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
       &exec_ctx, &parser, grpc_slice_from_static_buffer(data, size)));
   grpc_chttp2_hpack_parser_destroy(&exec_ctx, &parser);
   grpc_exec_ctx_finish(&exec_ctx);
+  /* also cross check the huffman decoder against its reference */
+  uint8_t *fast = gpr_malloc(2 * size + 2);
+  uint8_t *ref = gpr_malloc(2 * size + 2);
+  int16_t fast_state = 0;
+  int16_t ref_state = 0;
+  size_t fast_len = grpc_chttp2_hpack_huff_decode(&fast_state, data, size, fast);
+  size_t ref_len =
+      grpc_chttp2_hpack_huff_decode_nibbles(&ref_state, data, size, ref);
+  GPR_ASSERT(fast_state == ref_state);
+  GPR_ASSERT(fast_len == ref_len);
+  GPR_ASSERT(0 == memcmp(fast, ref, ref_len));
+  gpr_free(fast);
+  gpr_free(ref);
   grpc_shutdown();
   return 0;
 }
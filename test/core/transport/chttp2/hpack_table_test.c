@@ -152,6 +152,70 @@ static void test_many_additions(void) {
   grpc_exec_ctx_finish(&exec_ctx);
 }
 
+static void add_simple(grpc_exec_ctx *exec_ctx, grpc_chttp2_hptbl *tbl,
+                       int i) {
+  char *key;
+  char *value;
+  gpr_asprintf(&key, "K:%d", i);
+  gpr_asprintf(&value, "VALUE:%d", i);
+  grpc_mdelem elem =
+      grpc_mdelem_from_slices(exec_ctx, grpc_slice_from_copied_string(key),
+                              grpc_slice_from_copied_string(value));
+  GPR_ASSERT(grpc_chttp2_hptbl_add(exec_ctx, tbl, elem) == GRPC_ERROR_NONE);
+  GRPC_MDELEM_UNREF(exec_ctx, elem);
+  gpr_free(key);
+  gpr_free(value);
+}
+
+static void assert_index_simple(grpc_chttp2_hptbl *tbl, uint32_t idx, int i) {
+  char *key;
+  char *value;
+  gpr_asprintf(&key, "K:%d", i);
+  gpr_asprintf(&value, "VALUE:%d", i);
+  assert_index(tbl, idx, key, value);
+  gpr_free(key);
+  gpr_free(value);
+}
+
+static void test_shrink_to_fit(void) {
+  grpc_chttp2_hptbl tbl;
+  int i;
+
+  LOG_TEST("test_shrink_to_fit");
+
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  grpc_chttp2_hptbl_init(&exec_ctx, &tbl);
+  /* sized for the table up front, until shrunk */
+  GPR_ASSERT(tbl.cap_entries == tbl.max_entries);
+  grpc_chttp2_hptbl_shrink_to_fit(&tbl);
+  GPR_ASSERT(tbl.cap_entries == 0);
+  GPR_ASSERT(tbl.ents == NULL);
+
+  /* wrap the ring buffer before shrinking it */
+  for (i = 0; i < 300; i++) {
+    add_simple(&exec_ctx, &tbl, i);
+  }
+  GPR_ASSERT(tbl.cap_entries <= tbl.max_entries);
+  uint32_t num_ents = tbl.num_ents;
+  grpc_chttp2_hptbl_shrink_to_fit(&tbl);
+  GPR_ASSERT(tbl.cap_entries == num_ents);
+  for (i = 0; i < (int)num_ents; i++) {
+    assert_index_simple(&tbl, 1 + GRPC_CHTTP2_LAST_STATIC_ENTRY + (uint32_t)i,
+                        299 - i);
+  }
+
+  /* and it grows back */
+  for (i = 300; i < 600; i++) {
+    add_simple(&exec_ctx, &tbl, i);
+    assert_index_simple(&tbl, 1 + GRPC_CHTTP2_LAST_STATIC_ENTRY, i);
+    assert_index_simple(&tbl, 2 + GRPC_CHTTP2_LAST_STATIC_ENTRY, i - 1);
+  }
+  GPR_ASSERT(tbl.num_ents == num_ents);
+
+  grpc_chttp2_hptbl_destroy(&exec_ctx, &tbl);
+  grpc_exec_ctx_finish(&exec_ctx);
+}
+
 static grpc_chttp2_hptbl_find_result find_simple(grpc_chttp2_hptbl *tbl,
                                                  const char *key,
                                                  const char *value) {
@@ -279,6 +343,7 @@ int main(int argc, char **argv) {
   grpc_init();
   test_static_lookup();
   test_many_additions();
+  test_shrink_to_fit();
   test_find();
   grpc_shutdown();
   return 0;
@@ -189,6 +189,38 @@ static void test_periodic_compaction(uint32_t n) {
   grpc_chttp2_stream_map_destroy(&map);
 }
 
+/* release the storage of an emptied map, and check that it is reallocated */
+static void test_release_memory(uint32_t n) {
+  grpc_chttp2_stream_map map;
+  uint32_t i;
+
+  LOG_TEST("test_release_memory");
+  gpr_log(GPR_INFO, "n = %d", n);
+
+  grpc_chttp2_stream_map_init(&map, 8);
+  for (i = 1; i <= n; i++) {
+    grpc_chttp2_stream_map_add(&map, i, (void *)(uintptr_t)i);
+  }
+  /* not empty: nothing to release */
+  grpc_chttp2_stream_map_release_memory(&map);
+  GPR_ASSERT(map.capacity >= n);
+  for (i = 1; i <= n; i++) {
+    GPR_ASSERT((void *)(uintptr_t)i == grpc_chttp2_stream_map_delete(&map, i));
+  }
+  grpc_chttp2_stream_map_release_memory(&map);
+  GPR_ASSERT(map.capacity == 0);
+  GPR_ASSERT(NULL == grpc_chttp2_stream_map_find(&map, 1));
+  GPR_ASSERT(NULL == grpc_chttp2_stream_map_rand(&map));
+  for (i = n + 1; i <= 2 * n; i++) {
+    grpc_chttp2_stream_map_add(&map, i, (void *)(uintptr_t)i);
+  }
+  for (i = n + 1; i <= 2 * n; i++) {
+    GPR_ASSERT((void *)(uintptr_t)i == grpc_chttp2_stream_map_find(&map, i));
+  }
+  GPR_ASSERT(n == grpc_chttp2_stream_map_size(&map));
+  grpc_chttp2_stream_map_destroy(&map);
+}
+
 int main(int argc, char **argv) {
   uint32_t n = 1;
   uint32_t prev = 1;
@@ -205,6 +237,7 @@ int main(int argc, char **argv) {
     test_delete_evens_sweep(n);
     test_delete_evens_incremental(n);
     test_periodic_compaction(n);
+    test_release_memory(n);
 
     tmp = n;
     n += prev;
@@ -0,0 +1,89 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/lib/transport/load_report_encoding.h"
+
+#include <string.h>
+
+#include <grpc/support/log.h>
+#include "test/core/util/test_config.h"
+
+#define LOG_TEST(x) gpr_log(GPR_INFO, "%s", x)
+
+static void assert_encodes_as(uint32_t utilization_permille, uint32_t qps,
+                              const char *s) {
+  char buffer[GRPC_LOAD_REPORT_ENCODE_MIN_BUFSIZE];
+  const grpc_load_report report = {utilization_permille, qps};
+  grpc_load_report_encode(&report, buffer);
+  gpr_log(GPR_INFO, "check '%s' == '%s'", buffer, s);
+  GPR_ASSERT(0 == strcmp(buffer, s));
+}
+
+static void test_encoding(void) {
+  LOG_TEST("test_encoding");
+  assert_encodes_as(0, 0, "u=0,q=0");
+  assert_encodes_as(531, 1200, "u=531,q=1200");
+  assert_encodes_as(UINT32_MAX, UINT32_MAX, "u=4294967295,q=4294967295");
+}
+
+static void assert_decodes_as(const char *s, uint32_t utilization_permille,
+                              uint32_t qps) {
+  grpc_load_report report;
+  gpr_log(GPR_INFO, "check decoding '%s'", s);
+  GPR_ASSERT(grpc_load_report_decode(grpc_slice_from_static_string(s),
+                                     &report));
+  GPR_ASSERT(report.utilization_permille == utilization_permille);
+  GPR_ASSERT(report.qps == qps);
+}
+
+static void assert_decoding_fails(const char *s) {
+  grpc_load_report report;
+  gpr_log(GPR_INFO, "check decoding '%s' fails", s);
+  GPR_ASSERT(
+      !grpc_load_report_decode(grpc_slice_from_static_string(s), &report));
+}
+
+static void test_decoding(void) {
+  LOG_TEST("test_decoding");
+  assert_decodes_as("u=531,q=1200", 531, 1200);
+  assert_decodes_as("q=1200,u=531", 531, 1200);
+  assert_decodes_as("u=0,q=0", 0, 0);
+  assert_decodes_as("u=4294967295,q=4294967295", UINT32_MAX, UINT32_MAX);
+  /* unknown fields are for future extensions */
+  assert_decodes_as("u=531,mem=20,q=1200", 531, 1200);
+  assert_decodes_as("u=531,q=1200,", 531, 1200);
+}
+
+static void test_decoding_fails(void) {
+  LOG_TEST("test_decoding_fails");
+  assert_decoding_fails("");
+  assert_decoding_fails("u=531");
+  assert_decoding_fails("q=1200");
+  assert_decoding_fails("u=,q=1200");
+  assert_decoding_fails("u=0.5,q=1200");
+  assert_decoding_fails("u=-1,q=1200");
+  assert_decoding_fails("u=531,q=4294967296");
+}
+
+int main(int argc, char **argv) {
+  grpc_test_init(argc, argv);
+  test_encoding();
+  test_decoding();
+  test_decoding_fails();
+  return 0;
+}
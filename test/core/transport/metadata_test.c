@@ -25,6 +25,7 @@
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 #include <grpc/support/string_util.h>
+#include <grpc/support/thd.h>
 
 #include "src/core/ext/transport/chttp2/transport/bin_encoder.h"
 #include "src/core/lib/slice/slice_internal.h"
@@ -382,6 +383,67 @@ static void test_copied_static_metadata(bool dup_key, bool dup_value) {
   grpc_shutdown();
 }
 
+#define CONCURRENT_THREADS 8
+#define CONCURRENT_ITERATIONS 20000
+#define CONCURRENT_DISTINCT 64
+#define CONCURRENT_HELD 16
+
+/* interns and creates overlapping sets of metadata from several threads,
+   dropping refs as it goes so that lookups race with gc_mdtab, with the
+   tables growing, and with interned strings being destroyed */
+static void concurrent_create_body(void *arg) {
+  uint32_t rnd = (uint32_t)(uintptr_t)arg;
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  grpc_mdelem held[CONCURRENT_HELD];
+  for (size_t i = 0; i < CONCURRENT_HELD; i++) held[i] = GRPC_MDNULL;
+  for (size_t i = 0; i < CONCURRENT_ITERATIONS; i++) {
+    char key[32];
+    char value[32];
+    rnd = rnd * 1103515245 + 12345;
+    uint32_t k = (rnd >> 8) % CONCURRENT_DISTINCT;
+    uint32_t v = (rnd >> 16) % CONCURRENT_DISTINCT;
+    /* distinct strings only some of the time, to also grow the tables */
+    if (i % 8 == 0) {
+      v += (uint32_t)((uintptr_t)arg * CONCURRENT_ITERATIONS + i);
+    }
+    sprintf(key, "key-%u", k);
+    sprintf(value, "value-%u", v);
+    grpc_mdelem md = grpc_mdelem_from_slices(
+        &exec_ctx, grpc_slice_intern(grpc_slice_from_static_string(key)),
+        grpc_slice_intern(grpc_slice_from_static_string(value)));
+    GPR_ASSERT(grpc_slice_str_cmp(GRPC_MDKEY(md), key) == 0);
+    GPR_ASSERT(grpc_slice_str_cmp(GRPC_MDVALUE(md), value) == 0);
+    grpc_mdelem again = grpc_mdelem_from_slices(
+        &exec_ctx, grpc_slice_intern(grpc_slice_from_static_string(key)),
+        grpc_slice_intern(grpc_slice_from_static_string(value)));
+    GPR_ASSERT(again.payload == md.payload);
+    GRPC_MDELEM_UNREF(&exec_ctx, again);
+    GRPC_MDELEM_UNREF(&exec_ctx, held[i % CONCURRENT_HELD]);
+    held[i % CONCURRENT_HELD] = md;
+    grpc_exec_ctx_flush(&exec_ctx);
+  }
+  for (size_t i = 0; i < CONCURRENT_HELD; i++) {
+    GRPC_MDELEM_UNREF(&exec_ctx, held[i]);
+  }
+  grpc_exec_ctx_finish(&exec_ctx);
+}
+
+static void test_concurrent_create(void) {
+  gpr_log(GPR_INFO, "test_concurrent_create");
+  grpc_init();
+  gpr_thd_id threads[CONCURRENT_THREADS];
+  for (uintptr_t i = 0; i < CONCURRENT_THREADS; i++) {
+    gpr_thd_options options = gpr_thd_options_default();
+    gpr_thd_options_set_joinable(&options);
+    GPR_ASSERT(gpr_thd_new(&threads[i], concurrent_create_body,
+                           (void *)(i + 1), &options));
+  }
+  for (size_t i = 0; i < CONCURRENT_THREADS; i++) {
+    gpr_thd_join(threads[i]);
+  }
+  grpc_shutdown();
+}
+
 int main(int argc, char **argv) {
   grpc_test_init(argc, argv);
   test_no_op();
@@ -398,5 +460,6 @@ int main(int argc, char **argv) {
   test_create_many_persistant_metadata();
   test_things_stick_around();
   test_user_data_works();
+  test_concurrent_create();
   return 0;
 }
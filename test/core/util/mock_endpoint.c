@@ -102,10 +102,12 @@ static grpc_resource_user *me_get_resource_user(grpc_endpoint *ep) {
 
 static int me_get_fd(grpc_endpoint *ep) { return -1; }
 
+static void me_hint_write_more(grpc_endpoint *ep) {}
+
 static const grpc_endpoint_vtable vtable = {
     me_read,     me_write,   me_add_to_pollset,    me_add_to_pollset_set,
     me_shutdown, me_destroy, me_get_resource_user, me_get_peer,
-    me_get_fd,
+    me_get_fd,   me_hint_write_more,
 };
 
 grpc_endpoint *grpc_mock_endpoint_create(void (*on_write)(grpc_slice slice),
@@ -126,6 +126,8 @@ static int te_get_fd(grpc_endpoint *ep) {
   return grpc_endpoint_get_fd(te->wrapped);
 }
 
+static void te_hint_write_more(grpc_endpoint *ep) {}
+
 static void te_finish_write(grpc_exec_ctx *exec_ctx, void *arg,
                             grpc_error *error) {
   trickle_endpoint *te = (trickle_endpoint *)arg;
@@ -138,7 +140,7 @@ static void te_finish_write(grpc_exec_ctx *exec_ctx, void *arg,
 static const grpc_endpoint_vtable vtable = {
     te_read,     te_write,   te_add_to_pollset,    te_add_to_pollset_set,
     te_shutdown, te_destroy, te_get_resource_user, te_get_peer,
-    te_get_fd};
+    te_get_fd,   te_hint_write_more};
 
 grpc_endpoint *grpc_trickle_endpoint_create(grpc_endpoint *wrap,
                                             double bytes_per_second) {
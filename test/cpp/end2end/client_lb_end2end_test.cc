@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <memory>
 #include <mutex>
+#include <set>
 #include <thread>
 
 #include <grpc++/channel.h>
@@ -36,6 +37,7 @@
 extern "C" {
 #include "src/core/ext/filters/client_channel/resolver/fake/fake_resolver.h"
 #include "src/core/ext/filters/client_channel/subchannel_index.h"
+#include "src/core/lib/transport/load_report_encoding.h"
 }
 
 #include "src/proto/grpc/testing/echo.grpc.pb.h"
@@ -53,34 +55,69 @@ namespace grpc {
 namespace testing {
 namespace {
 
-// Subclass of TestServiceImpl that increments a request counter for
-// every call to the Echo RPC.
+// Subclass of TestServiceImpl that increments a request counter and records
+// the client's address for every call to the Echo RPC, and can be made to
+// answer slowly.
 class MyTestServiceImpl : public TestServiceImpl {
  public:
-  MyTestServiceImpl() : request_count_(0) {}
+  MyTestServiceImpl() : request_count_(0), delay_ms_(0) {}
 
   Status Echo(ServerContext* context, const EchoRequest* request,
               EchoResponse* response) override {
+    int delay_ms;
+    grpc::string load_report;
     {
       std::unique_lock<std::mutex> lock(mu_);
       ++request_count_;
+      peers_.insert(context->peer());
+      delay_ms = delay_ms_;
+      load_report = load_report_;
+    }
+    if (delay_ms > 0) {
+      gpr_sleep_until(
+          gpr_time_add(gpr_now(GPR_CLOCK_MONOTONIC),
+                       gpr_time_from_millis(delay_ms, GPR_TIMESPAN)));
+    }
+    if (!load_report.empty()) {
+      context->AddTrailingMetadata(GRPC_LOAD_REPORT_KEY, load_report);
     }
     return TestServiceImpl::Echo(context, request, response);
   }
 
+  void set_delay_ms(int delay_ms) {
+    std::unique_lock<std::mutex> lock(mu_);
+    delay_ms_ = delay_ms;
+  }
+
+  // Load report to send in the trailing metadata, if not empty.
+  void set_load_report(const grpc::string& load_report) {
+    std::unique_lock<std::mutex> lock(mu_);
+    load_report_ = load_report;
+  }
+
   int request_count() {
     std::unique_lock<std::mutex> lock(mu_);
     return request_count_;
   }
 
+  // Number of distinct client addresses, i.e. connections, seen.
+  size_t peer_count() {
+    std::unique_lock<std::mutex> lock(mu_);
+    return peers_.size();
+  }
+
   void ResetCounters() {
     std::unique_lock<std::mutex> lock(mu_);
     request_count_ = 0;
+    peers_.clear();
   }
 
  private:
   std::mutex mu_;
   int request_count_;
+  int delay_ms_;
+  grpc::string load_report_;
+  std::set<grpc::string> peers_;
 };
 
 class ClientLbEnd2endTest : public ::testing::Test {
@@ -133,8 +170,8 @@ class ClientLbEnd2endTest : public ::testing::Test {
     grpc_exec_ctx_finish(&exec_ctx);
   }
 
-  void ResetStub(const grpc::string& lb_policy_name = "") {
-    ChannelArguments args;
+  void ResetStub(const grpc::string& lb_policy_name = "",
+                 ChannelArguments args = ChannelArguments()) {
     if (lb_policy_name.size() > 0) {
       args.SetLoadBalancingPolicyName(lb_policy_name);
     }  // else, default to pick first
@@ -170,6 +207,27 @@ class ClientLbEnd2endTest : public ::testing::Test {
     EXPECT_EQ(response.message(), kRequestMessage_);
   }
 
+  // Returns the index of the server that served an RPC carrying \a key in its
+  // "x-key" header, or -1 if the RPC failed.
+  int ServerForKey(const grpc::string& key) {
+    std::vector<int> counts;
+    for (const auto& server : servers_) {
+      counts.push_back(server->service_.request_count());
+    }
+    EchoRequest request;
+    EchoResponse response;
+    request.set_message(kRequestMessage_);
+    ClientContext context;
+    context.AddMetadata("x-key", key);
+    if (!stub_->Echo(&context, request, &response).ok()) return -1;
+    for (size_t i = 0; i < servers_.size(); ++i) {
+      if (servers_[i]->service_.request_count() != counts[i]) {
+        return static_cast<int>(i);
+      }
+    }
+    GPR_UNREACHABLE_CODE(return -1);
+  }
+
   void CheckRpcSendFailure() {
     const Status status = SendRpc();
     EXPECT_FALSE(status.ok());
@@ -251,6 +309,17 @@ class ClientLbEnd2endTest : public ::testing::Test {
     }
   }
 
+  // Sends \a rpcs_per_thread RPCs from each of \a num_threads threads at once.
+  void SendConcurrentRpcs(int num_threads, int rpcs_per_thread) {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+      threads.emplace_back([this, rpcs_per_thread] {
+        for (int j = 0; j < rpcs_per_thread; ++j) CheckRpcSendOk();
+      });
+    }
+    for (auto& thread : threads) thread.join();
+  }
+
   const grpc::string server_host_;
   std::shared_ptr<Channel> channel_;
   std::unique_ptr<grpc::testing::EchoTestService::Stub> stub_;
@@ -580,6 +649,259 @@ TEST_F(ClientLbEnd2endTest, RoundRobinReresolve) {
   CheckRpcSendOk();
 }
 
+TEST_F(ClientLbEnd2endTest, LeastRequest) {
+  // Start servers and send RPCs until all of them have seen one.
+  const int kNumServers = 3;
+  StartServers(kNumServers);
+  ResetStub("least_request");
+  std::vector<int> ports;
+  for (const auto& server : servers_) {
+    ports.emplace_back(server->port_);
+  }
+  SetNextResolution(ports);
+  do {
+    CheckRpcSendOk();
+  } while (!SeenAllServers());
+  // Check LB policy name for the channel.
+  EXPECT_EQ("least_request", channel_->GetLoadBalancingPolicyName());
+}
+
+TEST_F(ClientLbEnd2endTest, LeastRequestUpdates) {
+  const int kNumServers = 3;
+  StartServers(kNumServers);
+  ResetStub("least_request");
+  std::vector<int> ports;
+
+  // Start with a single server.
+  ports.emplace_back(servers_[0]->port_);
+  SetNextResolution(ports);
+  WaitForServer(0);
+  for (size_t i = 0; i < 10; ++i) CheckRpcSendOk();
+  EXPECT_EQ(10, servers_[0]->service_.request_count());
+  servers_[0]->service_.ResetCounters();
+
+  // Move on to the other two.
+  ports.clear();
+  ports.emplace_back(servers_[1]->port_);
+  ports.emplace_back(servers_[2]->port_);
+  SetNextResolution(ports);
+  WaitForServer(1);
+  WaitForServer(2);
+  for (size_t i = 0; i < 10; ++i) CheckRpcSendOk();
+  EXPECT_EQ(0, servers_[0]->service_.request_count());
+  EXPECT_EQ(10, servers_[1]->service_.request_count() +
+                    servers_[2]->service_.request_count());
+
+  // An empty update will result in the channel going into TRANSIENT_FAILURE.
+  ports.clear();
+  SetNextResolution(ports);
+  grpc_connectivity_state channel_state = GRPC_CHANNEL_INIT;
+  do {
+    channel_state = channel_->GetState(true /* try to connect */);
+  } while (channel_state == GRPC_CHANNEL_READY);
+  GPR_ASSERT(channel_state != GRPC_CHANNEL_READY);
+
+  // Next update introduces servers_[0], making the channel recover.
+  ports.emplace_back(servers_[0]->port_);
+  SetNextResolution(ports);
+  WaitForServer(0);
+}
+
+TEST_F(ClientLbEnd2endTest, LeastRequestAvoidsSlowBackend) {
+  // One of three backends takes kSlowMs for every RPC. Round robin sends it a
+  // third of the RPCs; least request sends it one only when the others are
+  // busy too.
+  const int kNumServers = 3;
+  const int kSlowMs = 50;
+  const int kNumThreads = 4;
+  const int kRpcsPerThread = 50;
+  StartServers(kNumServers);
+  std::vector<int> ports;
+  for (const auto& server : servers_) {
+    ports.emplace_back(server->port_);
+  }
+  int slow_requests[2];
+  const char* policies[2] = {"round_robin", "least_request"};
+  for (size_t i = 0; i < 2; ++i) {
+    ResetStub(policies[i]);
+    SetNextResolution(ports);
+    do {
+      CheckRpcSendOk();
+    } while (!SeenAllServers());
+    ResetCounters();
+    servers_[0]->service_.set_delay_ms(kSlowMs);
+    SendConcurrentRpcs(kNumThreads, kRpcsPerThread);
+    servers_[0]->service_.set_delay_ms(0);
+    slow_requests[i] = servers_[0]->service_.request_count();
+    gpr_log(GPR_INFO, "%s: %d of %d RPCs to the slow backend", policies[i],
+            slow_requests[i], kNumThreads * kRpcsPerThread);
+  }
+  EXPECT_LT(slow_requests[1], slow_requests[0] / 2);
+}
+
+TEST_F(ClientLbEnd2endTest, RingHash) {
+  const int kNumServers = 4;
+  const int kNumKeys = 100;
+  StartServers(kNumServers);
+  ChannelArguments args;
+  args.SetString(GRPC_ARG_RING_HASH_HEADER, "x-key");
+  ResetStub("ring_hash", args);
+  std::vector<int> ports;
+  for (const auto& server : servers_) {
+    ports.emplace_back(server->port_);
+  }
+  SetNextResolution(ports);
+  do {
+    CheckRpcSendOk();
+  } while (!SeenAllServers());
+  // Each key keeps going to the same server.
+  std::vector<int> key_servers;
+  for (int i = 0; i < kNumKeys; ++i) {
+    key_servers.push_back(ServerForKey(std::to_string(i)));
+    EXPECT_GE(key_servers[i], 0);
+  }
+  for (int i = 0; i < kNumKeys; ++i) {
+    EXPECT_EQ(key_servers[i], ServerForKey(std::to_string(i)));
+  }
+  // Removing the last server only moves the keys that went to it. Wait for
+  // the update by sending one of its keys until it goes elsewhere.
+  const int removed = kNumServers - 1;
+  ports.pop_back();
+  SetNextResolution(ports);
+  const auto removed_key =
+      std::find(key_servers.begin(), key_servers.end(), removed);
+  ASSERT_NE(key_servers.end(), removed_key);
+  while (ServerForKey(std::to_string(removed_key - key_servers.begin())) ==
+         removed) {
+  }
+  for (int i = 0; i < kNumKeys; ++i) {
+    const int server = ServerForKey(std::to_string(i));
+    if (key_servers[i] == removed) {
+      EXPECT_NE(removed, server);
+    } else {
+      EXPECT_EQ(key_servers[i], server);
+    }
+  }
+  // Keys of a server that goes down fall through to the others. Wait for the
+  // channel to see it go down by sending one of its keys until it succeeds.
+  servers_[0]->Shutdown(false);
+  const auto down_key = std::find(key_servers.begin(), key_servers.end(), 0);
+  ASSERT_NE(key_servers.end(), down_key);
+  while (ServerForKey(std::to_string(down_key - key_servers.begin())) < 0) {
+  }
+  for (int i = 0; i < kNumKeys; ++i) {
+    const int server = ServerForKey(std::to_string(i));
+    EXPECT_GT(server, 0);
+    if (key_servers[i] != 0 && key_servers[i] != removed) {
+      EXPECT_EQ(key_servers[i], server);
+    }
+  }
+  // Check LB policy name for the channel.
+  EXPECT_EQ("ring_hash", channel_->GetLoadBalancingPolicyName());
+}
+
+TEST_F(ClientLbEnd2endTest, WeightedRoundRobin) {
+  // Servers serving the same QPS at the same utilization get the same share
+  // of the RPCs, and one serving three times the QPS gets three times that.
+  const int kNumServers = 3;
+  const int kNumRpcs = 500;
+  const int kWeightExpirationMs = 1000;
+  StartServers(kNumServers);
+  servers_[0]->service_.set_load_report("u=500,q=100");
+  servers_[1]->service_.set_load_report("u=500,q=100");
+  servers_[2]->service_.set_load_report("u=500,q=300");
+  ChannelArguments args;
+  args.SetInt(GRPC_ARG_WEIGHTED_ROUND_ROBIN_WEIGHT_EXPIRATION_MS,
+              kWeightExpirationMs);
+  ResetStub("weighted_round_robin", args);
+  std::vector<int> ports;
+  for (const auto& server : servers_) {
+    ports.emplace_back(server->port_);
+  }
+  SetNextResolution(ports);
+  do {
+    CheckRpcSendOk();
+  } while (!SeenAllServers());
+  // The schedule picks up new weights every second.
+  gpr_sleep_until(grpc_timeout_milliseconds_to_deadline(1100));
+  ResetCounters();
+  for (int i = 0; i < kNumRpcs; ++i) CheckRpcSendOk();
+  EXPECT_NEAR(kNumRpcs / 5, servers_[0]->service_.request_count(), 5);
+  EXPECT_NEAR(kNumRpcs / 5, servers_[1]->service_.request_count(), 5);
+  EXPECT_NEAR(kNumRpcs * 3 / 5, servers_[2]->service_.request_count(), 5);
+  // Once the reports stop and the weights expire, it is plain round robin.
+  for (const auto& server : servers_) server->service_.set_load_report("");
+  gpr_sleep_until(
+      grpc_timeout_milliseconds_to_deadline(kWeightExpirationMs + 1100));
+  ResetCounters();
+  for (int i = 0; i < kNumServers * 100; ++i) CheckRpcSendOk();
+  for (const auto& server : servers_) {
+    EXPECT_NEAR(100, server->service_.request_count(), 5);
+  }
+  // Check LB policy name for the channel.
+  EXPECT_EQ("weighted_round_robin", channel_->GetLoadBalancingPolicyName());
+}
+
+TEST_F(ClientLbEnd2endTest, MultipleConnectionsPerSubchannel) {
+  // Concurrent RPCs to a single backend share one connection by default.
+  // Allowing more connections, each with a stream limit below the
+  // concurrency, spreads them over as many as are allowed.
+  const int kMaxConnections = 4;
+  const int kStreamLimit = 2;
+  const int kNumThreads = kMaxConnections * kStreamLimit;
+  const int kRpcsPerThread = 10;
+  StartServers(1);
+  servers_[0]->service_.set_delay_ms(50);
+  for (int max_connections : {1, kMaxConnections}) {
+    ChannelArguments args;
+    args.SetInt(GRPC_ARG_MAX_CONNECTIONS_PER_SUBCHANNEL, max_connections);
+    args.SetInt(GRPC_ARG_SUBCHANNEL_CONNECTION_STREAM_LIMIT, kStreamLimit);
+    ResetStub("", args);
+    SetNextResolution({servers_[0]->port_});
+    CheckRpcSendOk();
+    ResetCounters();
+    SendConcurrentRpcs(kNumThreads, kRpcsPerThread);
+    EXPECT_EQ(kNumThreads * kRpcsPerThread,
+              servers_[0]->service_.request_count());
+    EXPECT_EQ(static_cast<size_t>(max_connections),
+              servers_[0]->service_.peer_count());
+  }
+}
+
+TEST_F(ClientLbEnd2endTest, MultipleConnectionsPrimaryFailsDuringExtraConnect) {
+  // The first connection of a subchannel goes away while the subchannel is
+  // opening a second one. Once the backend is back, the channel reconnects
+  // and opens both connections again.
+  std::vector<int> ports = {grpc_pick_unused_port_or_die()};
+  StartServers(1, ports);
+  ChannelArguments args;
+  args.SetInt(GRPC_ARG_MAX_CONNECTIONS_PER_SUBCHANNEL, 2);
+  args.SetInt(GRPC_ARG_SUBCHANNEL_CONNECTION_STREAM_LIMIT, 1);
+  ResetStub("round_robin", args);
+  SetNextResolution(ports);
+  CheckRpcSendOk();
+  // A slow RPC fills the first connection, so the next one starts the extra
+  // connect. Kill the backend, cancelling the slow RPC, right after.
+  servers_[0]->service_.set_delay_ms(1000);
+  std::thread slow_rpc([this] { SendRpc(); });
+  while (servers_[0]->service_.request_count() < 2) {
+    gpr_sleep_until(grpc_timeout_milliseconds_to_deadline(1));
+  }
+  std::thread extra_rpc([this] { SendRpc(); });
+  servers_[0]->server_->Shutdown(grpc_timeout_milliseconds_to_deadline(0));
+  slow_rpc.join();
+  extra_rpc.join();
+  // Bring the server back up on the same port.
+  StartServers(1, ports);
+  servers_[1]->service_.set_delay_ms(50);
+  while (!SendRpc().ok()) {
+  }
+  ResetCounters();
+  SendConcurrentRpcs(4, 10);
+  EXPECT_EQ(40, servers_[1]->service_.request_count());
+  EXPECT_EQ(2u, servers_[1]->service_.peer_count());
+}
+
 }  // namespace
 }  // namespace testing
 }  // namespace grpc
@@ -16,7 +16,9 @@
  *
  */
 
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 
 #include <grpc++/channel.h>
 #include <grpc++/client_context.h>
@@ -325,6 +327,83 @@ TEST_F(GenericEnd2endTest, Deadline) {
                                 gpr_time_from_seconds(10, GPR_TIMESPAN)));
 }
 
+// Echoes one generic call on a callback completion queue, then frees itself
+class CallbackEchoHandler final : public experimental::CompletionCallback {
+ public:
+  CallbackEchoHandler(AsyncGenericService* service, ServerCompletionQueue* cq)
+      : service_(service), cq_(cq), stream_(&ctx_) {
+    service_->RequestCall(&ctx_, &stream_, cq_, cq_, tag());
+  }
+
+  void Run(bool ok) override {
+    if (!ok) {
+      delete this;
+      return;
+    }
+    switch (state_++) {
+      case 0:
+        new CallbackEchoHandler(service_, cq_);
+        stream_.Read(&buffer_, tag());
+        break;
+      case 1:
+        stream_.WriteAndFinish(buffer_, WriteOptions(), Status::OK, tag());
+        break;
+      default:
+        delete this;
+    }
+  }
+
+ private:
+  void* tag() { return static_cast<experimental::CompletionCallback*>(this); }
+
+  AsyncGenericService* const service_;
+  ServerCompletionQueue* const cq_;
+  GenericServerContext ctx_;
+  GenericServerAsyncReaderWriter stream_;
+  ByteBuffer buffer_;
+  int state_ = 0;
+};
+
+TEST(GenericCallbackEnd2endTest, UnaryRpcs) {
+  std::ostringstream server_address;
+  server_address << "localhost:" << grpc_pick_unused_port_or_die();
+  AsyncGenericService generic_service;
+  ServerBuilder builder;
+  builder.AddListeningPort(server_address.str(), InsecureServerCredentials());
+  builder.RegisterAsyncGenericService(&generic_service);
+  std::unique_ptr<ServerCompletionQueue> cq =
+      builder.AddCallbackCompletionQueue();
+  std::unique_ptr<Server> server = builder.BuildAndStart();
+  new CallbackEchoHandler(&generic_service, cq.get());
+
+  std::unique_ptr<EchoTestService::Stub> stub(EchoTestService::NewStub(
+      CreateChannel(server_address.str(), InsecureChannelCredentials())));
+  for (int i = 0; i < 10; i++) {
+    EchoRequest request;
+    EchoResponse response;
+    ClientContext cli_ctx;
+    request.set_message("Hello callback " + std::to_string(i));
+    std::mutex mu;
+    std::condition_variable cv;
+    bool done = false;
+    stub->experimental_async()->Echo(
+        &cli_ctx, &request, &response, [&](Status status) {
+          EXPECT_TRUE(status.ok());
+          std::lock_guard<std::mutex> lock(mu);
+          done = true;
+          cv.notify_one();
+        });
+    std::unique_lock<std::mutex> lock(mu);
+    while (!done) {
+      cv.wait(lock);
+    }
+    EXPECT_EQ(request.message(), response.message());
+  }
+
+  server->Shutdown();
+  cq->Shutdown();
+}
+
 }  // namespace
 }  // namespace testing
 }  // namespace grpc
@@ -20,10 +20,14 @@
 
 extern "C" {
 #include "src/core/lib/support/arena.h"
+#include "src/core/lib/surface/arena_pool.h"
 }
 #include "test/cpp/microbenchmarks/helpers.h"
 #include "third_party/benchmark/include/benchmark/benchmark.h"
 
+// the arena pool only caches while grpc is initialized
+auto& force_library_initialization = Library::get();
+
 static void BM_Arena_NoOp(benchmark::State& state) {
   while (state.KeepRunning()) {
     gpr_arena_destroy(gpr_arena_create(state.range(0)));
@@ -58,4 +62,31 @@ static void BM_Arena_Batch(benchmark::State& state) {
 }
 BENCHMARK(BM_Arena_Batch)->Ranges({{1, 64 * 1024}, {1, 64}, {1, 1024}});
 
+// As BM_Arena_NoOp and BM_Arena_Batch, with arenas recycled by the call
+// arena pool
+static void BM_ArenaPool_NoOp(benchmark::State& state) {
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  while (state.KeepRunning()) {
+    grpc_arena_pool_destroy(&exec_ctx,
+                            grpc_arena_pool_create(&exec_ctx, state.range(0)));
+    grpc_exec_ctx_flush(&exec_ctx);
+  }
+  grpc_exec_ctx_finish(&exec_ctx);
+}
+BENCHMARK(BM_ArenaPool_NoOp)->Range(1, 1024 * 1024);
+
+static void BM_ArenaPool_Batch(benchmark::State& state) {
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  while (state.KeepRunning()) {
+    gpr_arena* a = grpc_arena_pool_create(&exec_ctx, state.range(0));
+    for (int i = 0; i < state.range(1); i++) {
+      gpr_arena_alloc(a, state.range(2));
+    }
+    grpc_arena_pool_destroy(&exec_ctx, a);
+    grpc_exec_ctx_flush(&exec_ctx);
+  }
+  grpc_exec_ctx_finish(&exec_ctx);
+}
+BENCHMARK(BM_ArenaPool_Batch)->Ranges({{1, 64 * 1024}, {1, 64}, {1, 1024}});
+
 BENCHMARK_MAIN();
@@ -25,6 +25,7 @@
 extern "C" {
 #include "src/core/ext/transport/chttp2/transport/hpack_encoder.h"
 #include "src/core/ext/transport/chttp2/transport/hpack_parser.h"
+#include "src/core/ext/transport/chttp2/transport/huffsyms.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "src/core/lib/slice/slice_string_helpers.h"
 #include "src/core/lib/transport/static_metadata.h"
@@ -323,6 +324,88 @@ BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader,
                    RepresentativeServerTrailingMetadata)
     ->Args({1, 16384});
 
+// A server response: initial metadata followed by trailing metadata (with
+// eof) on a stream, repeated for every call on the connection
+template <class InitialMetadata, class TrailingMetadata>
+static void BM_HpackEncoderEncodeResponse(benchmark::State &state) {
+  TrackCounters track_counters;
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+
+  grpc_metadata_batch initial;
+  grpc_metadata_batch trailing;
+  grpc_metadata_batch_init(&initial);
+  grpc_metadata_batch_init(&trailing);
+  std::vector<grpc_mdelem> initial_elems =
+      InitialMetadata::GetElems(&exec_ctx);
+  std::vector<grpc_mdelem> trailing_elems =
+      TrailingMetadata::GetElems(&exec_ctx);
+  std::vector<grpc_linked_mdelem> storage(initial_elems.size() +
+                                          trailing_elems.size());
+  size_t n = 0;
+  for (auto md : initial_elems) {
+    GPR_ASSERT(GRPC_LOG_IF_ERROR(
+        "addmd",
+        grpc_metadata_batch_add_tail(&exec_ctx, &initial, &storage[n++], md)));
+  }
+  for (auto md : trailing_elems) {
+    GPR_ASSERT(GRPC_LOG_IF_ERROR(
+        "addmd",
+        grpc_metadata_batch_add_tail(&exec_ctx, &trailing, &storage[n++], md)));
+  }
+
+  grpc_chttp2_hpack_compressor c;
+  grpc_chttp2_hpack_compressor_init(&c);
+  grpc_transport_one_way_stats stats;
+  memset(&stats, 0, sizeof(stats));
+  grpc_slice_buffer outbuf;
+  grpc_slice_buffer_init(&outbuf);
+  while (state.KeepRunning()) {
+    uint32_t stream_id = 2 * static_cast<uint32_t>(state.iterations()) + 1;
+    grpc_encode_header_options initial_opt = {stream_id, false, true, 16384,
+                                              &stats};
+    grpc_encode_header_options trailing_opt = {stream_id, true, true, 16384,
+                                               &stats};
+    grpc_chttp2_encode_header(&exec_ctx, &c, NULL, 0, &initial, &initial_opt,
+                              &outbuf);
+    grpc_chttp2_encode_header(&exec_ctx, &c, NULL, 0, &trailing,
+                              &trailing_opt, &outbuf);
+    grpc_slice_buffer_reset_and_unref_internal(&exec_ctx, &outbuf);
+    grpc_exec_ctx_flush(&exec_ctx);
+  }
+  grpc_metadata_batch_destroy(&exec_ctx, &initial);
+  grpc_metadata_batch_destroy(&exec_ctx, &trailing);
+  grpc_chttp2_hpack_compressor_destroy(&exec_ctx, &c);
+  grpc_slice_buffer_destroy_internal(&exec_ctx, &outbuf);
+  grpc_exec_ctx_finish(&exec_ctx);
+  track_counters.Finish(state);
+}
+
+class ServerInitialMetadataWithInternedElems {
+ public:
+  static constexpr bool kEnableTrueBinary = true;
+  static std::vector<grpc_mdelem> GetElems(grpc_exec_ctx *exec_ctx) {
+    return {GRPC_MDELEM_STATUS_200,
+            GRPC_MDELEM_CONTENT_TYPE_APPLICATION_SLASH_GRPC,
+            GRPC_MDELEM_GRPC_ACCEPT_ENCODING_IDENTITY_COMMA_DEFLATE_COMMA_GZIP,
+            grpc_mdelem_from_slices(
+                exec_ctx, grpc_slice_intern(grpc_slice_from_static_string(
+                              "x-served-by")),
+                grpc_slice_intern(
+                    grpc_slice_from_static_string("echo-backend-7"))),
+            grpc_mdelem_from_slices(
+                exec_ctx, grpc_slice_intern(
+                              grpc_slice_from_static_string("cache-control")),
+                grpc_slice_intern(grpc_slice_from_static_string("no-cache")))};
+  }
+};
+
+BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeResponse,
+                   RepresentativeServerInitialMetadata,
+                   RepresentativeServerTrailingMetadata);
+BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeResponse,
+                   ServerInitialMetadataWithInternedElems,
+                   RepresentativeServerTrailingMetadata);
+
 }  // namespace hpack_encoder_fixtures
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -625,6 +708,105 @@ class RepresentativeServerTrailingMetadata {
   }
 };
 
+// Literal header fields as peers that Huffman code every string (as most
+// HTTP/2 implementations do by default) send them
+static void AppendLength(std::vector<uint8_t> *out, uint8_t flags,
+                         size_t length) {
+  if (length < 127) {
+    out->push_back(static_cast<uint8_t>(flags | length));
+    return;
+  }
+  out->push_back(static_cast<uint8_t>(flags | 127));
+  length -= 127;
+  while (length >= 128) {
+    out->push_back(static_cast<uint8_t>(0x80 | (length & 0x7f)));
+    length >>= 7;
+  }
+  out->push_back(static_cast<uint8_t>(length));
+}
+
+static void AppendHuffmanString(std::vector<uint8_t> *out,
+                                const std::string &str) {
+  std::vector<uint8_t> encoded;
+  uint64_t bits = 0;
+  unsigned nbits = 0;
+  for (unsigned char c : str) {
+    const grpc_chttp2_huffsym &sym = grpc_chttp2_huffsyms[c];
+    bits = (bits << sym.length) | sym.bits;
+    nbits += sym.length;
+    while (nbits >= 8) {
+      nbits -= 8;
+      encoded.push_back(static_cast<uint8_t>(bits >> nbits));
+    }
+  }
+  if (nbits > 0) {
+    // pad with the most significant bits of EOS (all ones)
+    encoded.push_back(
+        static_cast<uint8_t>((bits << (8 - nbits)) | (0xff >> nbits)));
+  }
+  AppendLength(out, 0x80, encoded.size());
+  out->insert(out->end(), encoded.begin(), encoded.end());
+}
+
+static std::vector<uint8_t> HuffmanHeaders(
+    const std::vector<std::pair<std::string, std::string>> &headers) {
+  std::vector<uint8_t> out;
+  for (const auto &header : headers) {
+    out.push_back(0x00);  // literal header field without indexing, new name
+    AppendHuffmanString(&out, header.first);
+    AppendHuffmanString(&out, header.second);
+  }
+  return out;
+}
+
+template <int kLength>
+class NonIndexedHuffmanElem {
+ public:
+  static std::vector<grpc_slice> GetInitSlices() { return {}; }
+  static std::vector<grpc_slice> GetBenchmarkSlices() {
+    static const char kText[] = "grpc-c++/1.7.0 (linux; chttp2; gRPC) ";
+    std::string value;
+    for (int i = 0; i < kLength; i++) {
+      value.push_back(kText[i % (sizeof(kText) - 1)]);
+    }
+    return {MakeSlice(HuffmanHeaders({{"abc", value}}))};
+  }
+};
+
+class RepresentativeClientHuffmanMetadata {
+ public:
+  static std::vector<grpc_slice> GetInitSlices() { return {}; }
+  static std::vector<grpc_slice> GetBenchmarkSlices() {
+    return {MakeSlice(HuffmanHeaders({
+        {":path", "/grpc.testing.EchoTestService/Echo"},
+        {":scheme", "https"},
+        {":method", "POST"},
+        {":authority", "echo-service.prod.example.com:443"},
+        {"content-type", "application/grpc"},
+        {"te", "trailers"},
+        {"grpc-timeout", "9993m"},
+        {"grpc-accept-encoding", "identity,deflate,gzip"},
+        {"user-agent", "grpc-c++/1.7.0 grpc-c/4.0.0 (linux; chttp2; gambit)"},
+        {"authorization",
+         "Bearer ya29.GlvcBIrc0JkYz5ntXU2mCFEdiqWiKmMY0Rqgh8SdxJR0Qkq4Vu-"
+         "hIc1PXbPoVTxA6EeIh2ZK4CSDlZ0m9n8uBuRcKtBrSTRnJfPE1Qd4gbmF3tWcxQ"},
+        {"x-request-id", "5e0f2ba4-7c3a-4c57-b55a-0b3f5d2a9c11"},
+    }))};
+  }
+};
+
+class RepresentativeServerHuffmanTrailingMetadata {
+ public:
+  static std::vector<grpc_slice> GetInitSlices() { return {}; }
+  static std::vector<grpc_slice> GetBenchmarkSlices() {
+    return {MakeSlice(HuffmanHeaders({
+        {"grpc-status", "14"},
+        {"grpc-message", "Connect Failed: upstream connect error or "
+                         "disconnect/reset before headers"},
+    }))};
+  }
+};
+
 BENCHMARK_TEMPLATE(BM_HpackParserParseHeader, EmptyBatch);
 BENCHMARK_TEMPLATE(BM_HpackParserParseHeader, IndexedSingleStaticElem);
 BENCHMARK_TEMPLATE(BM_HpackParserParseHeader, AddIndexedSingleStaticElem);
@@ -649,6 +831,13 @@ BENCHMARK_TEMPLATE(BM_HpackParserParseHeader,
                    RepresentativeServerInitialMetadata);
 BENCHMARK_TEMPLATE(BM_HpackParserParseHeader,
                    RepresentativeServerTrailingMetadata);
+BENCHMARK_TEMPLATE(BM_HpackParserParseHeader, NonIndexedHuffmanElem<10>);
+BENCHMARK_TEMPLATE(BM_HpackParserParseHeader, NonIndexedHuffmanElem<100>);
+BENCHMARK_TEMPLATE(BM_HpackParserParseHeader, NonIndexedHuffmanElem<1000>);
+BENCHMARK_TEMPLATE(BM_HpackParserParseHeader,
+                   RepresentativeClientHuffmanMetadata);
+BENCHMARK_TEMPLATE(BM_HpackParserParseHeader,
+                   RepresentativeServerHuffmanTrailingMetadata);
 
 }  // namespace hpack_parser_fixtures
 
@@ -49,7 +49,7 @@ class DummyEndpoint : public grpc_endpoint {
     static const grpc_endpoint_vtable my_vtable = {
         read,     write,   add_to_pollset,    add_to_pollset_set,
         shutdown, destroy, get_resource_user, get_peer,
-        get_fd};
+        get_fd,   hint_write_more};
     grpc_endpoint::vtable = &my_vtable;
     ru_ = grpc_resource_user_create(Library::get().rq(), "dummy_endpoint");
   }
@@ -122,6 +122,7 @@ class DummyEndpoint : public grpc_endpoint {
   }
   static char *get_peer(grpc_endpoint *ep) { return gpr_strdup("test"); }
   static int get_fd(grpc_endpoint *ep) { return 0; }
+  static void hint_write_more(grpc_endpoint *ep) {}
 };
 
 class Fixture {
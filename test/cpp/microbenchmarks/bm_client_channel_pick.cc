@@ -0,0 +1,189 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Benchmark picks of a READY client_channel, with many threads starting calls
+ * on one channel */
+
+#include <benchmark/benchmark.h>
+#include <string.h>
+#include <sstream>
+
+#include <grpc/grpc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/thd.h>
+
+extern "C" {
+#include "src/core/lib/profiling/timers.h"
+#include "test/core/util/port.h"
+}
+
+#include "test/cpp/microbenchmarks/helpers.h"
+
+auto &force_library_initialization = Library::get();
+
+static void *tag(intptr_t i) { return reinterpret_cast<void *>(i); }
+
+static gpr_timespec inf_future() {
+  return gpr_inf_future(GPR_CLOCK_MONOTONIC);
+}
+
+// A server on a unix socket, and a channel to it through client_channel with
+// the given LB policy
+class ClientChannelFixture {
+ public:
+  explicit ClientChannelFixture(const char *lb_policy_name) {
+    port_ = grpc_pick_unused_port_or_die();  // just for a unique id - not a
+                                             // real port
+    std::stringstream addr;
+    addr << "unix:/tmp/bm_client_channel_pick." << port_;
+    server_cq_ = grpc_completion_queue_create_for_next(NULL);
+    server_ = grpc_server_create(NULL, NULL);
+    grpc_server_register_completion_queue(server_, server_cq_, NULL);
+    GPR_ASSERT(
+        grpc_server_add_insecure_http2_port(server_, addr.str().c_str()));
+    grpc_server_start(server_);
+    gpr_thd_options opt = gpr_thd_options_default();
+    gpr_thd_options_set_joinable(&opt);
+    GPR_ASSERT(gpr_thd_new(&server_thd_, PollServer, this, &opt));
+
+    grpc_arg arg;
+    arg.type = GRPC_ARG_STRING;
+    arg.key = const_cast<char *>(GRPC_ARG_LB_POLICY_NAME);
+    arg.value.string = const_cast<char *>(lb_policy_name);
+    grpc_channel_args args = {1, &arg};
+    channel_ = grpc_insecure_channel_create(addr.str().c_str(), &args, NULL);
+    method_ = grpc_channel_register_call(channel_, "/foo/bar", NULL, NULL);
+    WaitForReady();
+  }
+
+  ~ClientChannelFixture() {
+    grpc_channel_destroy(channel_);
+    grpc_server_shutdown_and_notify(server_, server_cq_, tag(1));
+    grpc_server_cancel_all_calls(server_);
+    gpr_thd_join(server_thd_);
+    grpc_server_destroy(server_);
+    grpc_completion_queue_shutdown(server_cq_);
+    while (grpc_completion_queue_next(server_cq_, inf_future(), NULL).type !=
+           GRPC_QUEUE_SHUTDOWN) {
+    }
+    grpc_completion_queue_destroy(server_cq_);
+    grpc_recycle_unused_port(port_);
+  }
+
+  grpc_channel *channel() const { return channel_; }
+  void *method() const { return method_; }
+
+ private:
+  // Calls are never requested: polling just drives the server's transports
+  // until shutdown completes
+  static void PollServer(void *arg) {
+    ClientChannelFixture *self = static_cast<ClientChannelFixture *>(arg);
+    while (grpc_completion_queue_next(self->server_cq_, inf_future(), NULL)
+               .tag != tag(1)) {
+    }
+  }
+
+  void WaitForReady() {
+    grpc_completion_queue *cq = grpc_completion_queue_create_for_next(NULL);
+    grpc_connectivity_state state;
+    while ((state = grpc_channel_check_connectivity_state(channel_, 1)) !=
+           GRPC_CHANNEL_READY) {
+      grpc_channel_watch_connectivity_state(channel_, state, inf_future(), cq,
+                                            tag(0));
+      GPR_ASSERT(grpc_completion_queue_next(cq, inf_future(), NULL).type ==
+                 GRPC_OP_COMPLETE);
+    }
+    grpc_completion_queue_destroy(cq);
+  }
+
+  int port_;
+  grpc_completion_queue *server_cq_;
+  grpc_server *server_;
+  gpr_thd_id server_thd_;
+  grpc_channel *channel_;
+  void *method_;
+};
+
+struct PickFirst {
+  static const char *Name() { return "pick_first"; }
+};
+
+struct RoundRobin {
+  static const char *Name() { return "round_robin"; }
+};
+
+static ClientChannelFixture *g_fixture;
+
+/* Each iteration creates a call and starts its send_initial_metadata, which
+   picks a subchannel and creates the subchannel call, then cancels it. All
+   threads pick from the one channel (see bm_cq_multiple_threads.cc for why
+   setup and teardown in thread 0 are safe) */
+template <class LbPolicy>
+static void BM_ClientChannelPick(benchmark::State &state) {
+  TrackCounters track_counters;
+  if (state.thread_index == 0) {
+    g_fixture = new ClientChannelFixture(LbPolicy::Name());
+  }
+  grpc_completion_queue *cq = grpc_completion_queue_create_for_next(NULL);
+  grpc_metadata_array trailing_metadata_recv;
+  grpc_status_code status;
+  grpc_slice details;
+  grpc_op ops[2];
+  memset(ops, 0, sizeof(ops));
+  ops[0].op = GRPC_OP_SEND_INITIAL_METADATA;
+  ops[1].op = GRPC_OP_RECV_STATUS_ON_CLIENT;
+  ops[1].data.recv_status_on_client.trailing_metadata = &trailing_metadata_recv;
+  ops[1].data.recv_status_on_client.status = &status;
+  ops[1].data.recv_status_on_client.status_details = &details;
+  while (state.KeepRunning()) {
+    GPR_TIMER_SCOPE("BenchmarkCycle", 0);
+    grpc_call *call = grpc_channel_create_registered_call(
+        g_fixture->channel(), NULL, GRPC_PROPAGATE_DEFAULTS, cq,
+        g_fixture->method(), inf_future(), NULL);
+    grpc_metadata_array_init(&trailing_metadata_recv);
+    GPR_ASSERT(GRPC_CALL_OK ==
+               grpc_call_start_batch(call, ops, 2, tag(2), NULL));
+    grpc_call_cancel(call, NULL);
+    GPR_ASSERT(grpc_completion_queue_next(cq, inf_future(), NULL).type ==
+               GRPC_OP_COMPLETE);
+    GPR_ASSERT(status == GRPC_STATUS_CANCELLED);
+    grpc_call_unref(call);
+    grpc_metadata_array_destroy(&trailing_metadata_recv);
+    grpc_slice_unref(details);
+  }
+  state.SetItemsProcessed(state.iterations());
+  grpc_completion_queue_shutdown(cq);
+  while (grpc_completion_queue_next(cq, inf_future(), NULL).type !=
+         GRPC_QUEUE_SHUTDOWN) {
+  }
+  grpc_completion_queue_destroy(cq);
+  if (state.thread_index == 0) {
+    delete g_fixture;
+    g_fixture = NULL;
+  }
+  track_counters.Finish(state);
+}
+
+BENCHMARK_TEMPLATE(BM_ClientChannelPick, PickFirst)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ClientChannelPick, RoundRobin)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -19,6 +19,7 @@
 #include <benchmark/benchmark.h>
 #include <string.h>
 #include <atomic>
+#include <vector>
 
 #include <grpc/grpc.h>
 #include <grpc/support/alloc.h>
@@ -44,6 +45,8 @@ static void* g_tag = (void*)(intptr_t)10;  // Some random number
 static grpc_completion_queue* g_cq;
 static grpc_event_engine_vtable g_vtable;
 static const grpc_event_engine_vtable* g_old_vtable;
+/* Number of completions queued by each call to pollset_work */
+static int g_events_per_poll = 1;
 
 static void pollset_shutdown(grpc_exec_ctx* exec_ctx, grpc_pollset* ps,
                              grpc_closure* closure) {
@@ -70,7 +73,7 @@ static void cq_done_cb(grpc_exec_ctx* exec_ctx, void* done_arg,
   gpr_free(cq_completion);
 }
 
-/* Queues a completion tag if deadline is > 0.
+/* Queues g_events_per_poll completion tags if deadline is > 0.
  * Does nothing if deadline is 0 (i.e gpr_time_0(GPR_CLOCK_MONOTONIC)) */
 static grpc_error* pollset_work(grpc_exec_ctx* exec_ctx, grpc_pollset* ps,
                                 grpc_pollset_worker** worker, gpr_timespec now,
@@ -81,9 +84,11 @@ static grpc_error* pollset_work(grpc_exec_ctx* exec_ctx, grpc_pollset* ps,
   }
 
   gpr_mu_unlock(&ps->mu);
-  GPR_ASSERT(grpc_cq_begin_op(g_cq, g_tag));
-  grpc_cq_end_op(exec_ctx, g_cq, g_tag, GRPC_ERROR_NONE, cq_done_cb, NULL,
-                 (grpc_cq_completion*)gpr_malloc(sizeof(grpc_cq_completion)));
+  for (int i = 0; i < g_events_per_poll; i++) {
+    GPR_ASSERT(grpc_cq_begin_op(g_cq, g_tag));
+    grpc_cq_end_op(exec_ctx, g_cq, g_tag, GRPC_ERROR_NONE, cq_done_cb, NULL,
+                   (grpc_cq_completion*)gpr_malloc(sizeof(grpc_cq_completion)));
+  }
   grpc_exec_ctx_flush(exec_ctx);
   gpr_mu_lock(&ps->mu);
   return GRPC_ERROR_NONE;
@@ -168,6 +173,44 @@ static void BM_Cq_Throughput(benchmark::State& state) {
 
 BENCHMARK(BM_Cq_Throughput)->ThreadRange(1, 16)->UseRealTime();
 
+/* Each poll queues range(0) completions, which are drained range(0) at a time
+   with grpc_completion_queue_next_batch. Items processed counts events, so the
+   per-item time is the per-event cost of dequeueing */
+static void BM_Cq_Throughput_Batch(benchmark::State& state) {
+  TrackCounters track_counters;
+  gpr_timespec deadline = gpr_inf_future(GPR_CLOCK_MONOTONIC);
+  std::vector<grpc_event> events(state.range(0));
+  size_t num_events = 0;
+
+  if (state.thread_index == 0) {
+    g_events_per_poll = (int)state.range(0);
+    setup();
+  }
+
+  while (state.KeepRunning()) {
+    size_t n = grpc_completion_queue_next_batch(g_cq, events.data(),
+                                                events.size(), deadline, NULL);
+    GPR_ASSERT(events[0].type == GRPC_OP_COMPLETE);
+    num_events += n;
+  }
+
+  state.SetItemsProcessed((int64_t)num_events);
+
+  if (state.thread_index == 0) {
+    teardown();
+    g_events_per_poll = 1;
+  }
+
+  track_counters.Finish(state);
+}
+
+BENCHMARK(BM_Cq_Throughput_Batch)
+    ->ThreadRange(1, 16)
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(64)
+    ->UseRealTime();
+
 }  // namespace testing
 }  // namespace grpc
 
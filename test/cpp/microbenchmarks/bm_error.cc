@@ -156,6 +156,53 @@ static void BM_ErrorGetPresentInt(benchmark::State& state) {
 }
 BENCHMARK(BM_ErrorGetPresentInt);
 
+// Storms: many calls failing at once for the same reason, each raising an
+// error that is passed around the stack and finally turned into a status.
+// With preallocated errors none of this should allocate (see allocs/iter in
+// GPR_LOW_LEVEL_COUNTERS builds).
+
+// How deadline expiry was raised before static errors existed
+static grpc_error* AllocatedDeadlineExceeded() {
+  return grpc_error_set_int(
+      GRPC_ERROR_CREATE_FROM_STATIC_STRING("Deadline Exceeded"),
+      GRPC_ERROR_INT_GRPC_STATUS, GRPC_STATUS_DEADLINE_EXCEEDED);
+}
+
+static grpc_error* StaticDeadlineExceeded() {
+  return GRPC_ERROR_DEADLINE_EXCEEDED;
+}
+
+// Cancellation as the transport reports it for each removed stream: wrapped,
+// or passed through as it is now
+static grpc_error* WrappedCancelled() {
+  grpc_error* cancelled = GRPC_ERROR_CANCELLED;
+  return GRPC_ERROR_CREATE_REFERENCING_FROM_STATIC_STRING("Stream removed",
+                                                          &cancelled, 1);
+}
+
+static grpc_error* Cancelled() { return GRPC_ERROR_CANCELLED; }
+
+template <grpc_error* (*RaiseError)()>
+static void BM_ErrorStorm(benchmark::State& state) {
+  TrackCounters track_counters;
+  const gpr_timespec deadline = gpr_inf_future(GPR_CLOCK_MONOTONIC);
+  while (state.KeepRunning()) {
+    grpc_error* error = RaiseError();
+    // handed to the call combiner and transport
+    GRPC_ERROR_UNREF(GRPC_ERROR_REF(error));
+    GRPC_ERROR_UNREF(GRPC_ERROR_REF(error));
+    grpc_status_code status;
+    grpc_slice slice;
+    grpc_error_get_status(error, deadline, &status, &slice, NULL);
+    GRPC_ERROR_UNREF(error);
+  }
+  track_counters.Finish(state);
+}
+BENCHMARK_TEMPLATE(BM_ErrorStorm, AllocatedDeadlineExceeded);
+BENCHMARK_TEMPLATE(BM_ErrorStorm, StaticDeadlineExceeded);
+BENCHMARK_TEMPLATE(BM_ErrorStorm, WrappedCancelled);
+BENCHMARK_TEMPLATE(BM_ErrorStorm, Cancelled);
+
 // Fixtures for tests: generate different kinds of errors
 class ErrorNone {
  public:
@@ -175,6 +222,15 @@ class ErrorCancelled {
   const gpr_timespec deadline_ = gpr_inf_future(GPR_CLOCK_MONOTONIC);
 };
 
+class ErrorDeadlineExceeded {
+ public:
+  gpr_timespec deadline() const { return deadline_; }
+  grpc_error* error() const { return GRPC_ERROR_DEADLINE_EXCEEDED; }
+
+ private:
+  const gpr_timespec deadline_ = gpr_inf_future(GPR_CLOCK_MONOTONIC);
+};
+
 class SimpleError {
  public:
   gpr_timespec deadline() const { return deadline_; }
@@ -301,6 +357,7 @@ static void BM_HasClearGrpcStatus(benchmark::State& state) {
 
 BENCHMARK_SUITE(ErrorNone);
 BENCHMARK_SUITE(ErrorCancelled);
+BENCHMARK_SUITE(ErrorDeadlineExceeded);
 BENCHMARK_SUITE(SimpleError);
 BENCHMARK_SUITE(ErrorWithGrpcStatus);
 BENCHMARK_SUITE(ErrorWithHttpError);
@@ -0,0 +1,181 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Benchmark serving a large file over a server streaming call, with the
+   file either read into freshly allocated slices or mapped into slices */
+
+#include <benchmark/benchmark.h>
+#include <grpc++/generic/async_generic_service.h>
+#include <grpc++/generic/generic_stub.h>
+#include <grpc++/support/byte_buffer.h>
+#include <grpc++/support/slice.h>
+#include <grpc/support/alloc.h>
+#include <stdio.h>
+#include <unistd.h>
+
+extern "C" {
+#include "src/core/lib/support/tmpfile.h"
+}
+
+#include "src/core/lib/profiling/timers.h"
+#include "test/cpp/microbenchmarks/fullstack_fixtures.h"
+
+namespace grpc {
+namespace testing {
+
+// force library initialization
+auto& force_library_initialization = Library::get();
+
+static const size_t kFileSize = 1024 * 1024 * 1024;
+
+static void* tag(intptr_t x) { return reinterpret_cast<void*>(x); }
+
+// The file served by every benchmark: created sparse, so its contents are
+// all zeros, and served from the page cache once the first pass has read it
+static int FileToServe() {
+  static int fd = [] {
+    char* name;
+    FILE* f = gpr_tmpfile("bm_fullstack_file_pump", &name);
+    GPR_ASSERT(f != nullptr);
+    GPR_ASSERT(ftruncate(fileno(f), kFileSize) == 0);
+    remove(name);
+    gpr_free(name);
+    return fileno(f);
+  }();
+  return fd;
+}
+
+// Registers a generic service, so that the raw file bytes can be served
+// without a message type to serialize them
+class GenericServiceConfiguration : public FixtureConfiguration {
+ public:
+  explicit GenericServiceConfiguration(AsyncGenericService* service)
+      : service_(service) {}
+
+  void ApplyCommonServerBuilderConfig(ServerBuilder* b) const override {
+    b->RegisterAsyncGenericService(service_);
+    FixtureConfiguration::ApplyCommonServerBuilderConfig(b);
+  }
+
+ private:
+  AsyncGenericService* service_;
+};
+
+static Slice ReadChunk(size_t offset, size_t length) {
+  grpc_slice slice = grpc_slice_malloc(length);
+  GPR_ASSERT(pread(FileToServe(), GRPC_SLICE_START_PTR(slice), length,
+                   static_cast<off_t>(offset)) ==
+             static_cast<ssize_t>(length));
+  return Slice(slice, Slice::STEAL_REF);
+}
+
+static Slice MapChunk(size_t offset, size_t length) {
+  Slice slice;
+  GPR_ASSERT(MapFileSlice(FileToServe(), offset, length, &slice).ok());
+  return slice;
+}
+
+// Serve the whole file every iteration, as messages of range(0) bytes
+template <class Fixture, Slice (*GetChunk)(size_t, size_t)>
+static void BM_PumpFileServerToClient(benchmark::State& state) {
+  const size_t chunk_size = static_cast<size_t>(state.range(0));
+  AsyncGenericService generic_service;
+  // nothing registered: every call goes to the generic service
+  Service service;
+  std::unique_ptr<Fixture> fixture(
+      new Fixture(&service, GenericServiceConfiguration(&generic_service)));
+  {
+    GenericServerContext svr_ctx;
+    GenericServerAsyncReaderWriter response_rw(&svr_ctx);
+    generic_service.RequestCall(&svr_ctx, &response_rw, fixture->cq(),
+                                fixture->cq(), tag(0));
+    GenericStub stub(fixture->channel());
+    ClientContext cli_ctx;
+    auto request_rw =
+        stub.Call(&cli_ctx, "/grpc.testing.FileService/Download",
+                  fixture->cq(), tag(1));
+    int need_tags = (1 << 0) | (1 << 1);
+    void* t;
+    bool ok;
+    while (need_tags) {
+      GPR_ASSERT(fixture->cq()->Next(&t, &ok));
+      GPR_ASSERT(ok);
+      int i = (int)(intptr_t)t;
+      GPR_ASSERT(need_tags & (1 << i));
+      need_tags &= ~(1 << i);
+    }
+    ByteBuffer recv_buffer;
+    request_rw->Read(&recv_buffer, tag(0));
+    while (state.KeepRunning()) {
+      GPR_TIMER_SCOPE("BenchmarkCycle", 0);
+      for (size_t offset = 0; offset < kFileSize; offset += chunk_size) {
+        Slice slice = GetChunk(offset, chunk_size);
+        ByteBuffer send_buffer(&slice, 1);
+        response_rw.Write(send_buffer, tag(1));
+        while (true) {
+          GPR_ASSERT(fixture->cq()->Next(&t, &ok));
+          if (t == tag(0)) {
+            GPR_ASSERT(recv_buffer.Length() == chunk_size);
+            request_rw->Read(&recv_buffer, tag(0));
+          } else if (t == tag(1)) {
+            break;
+          } else {
+            GPR_ASSERT(false);
+          }
+        }
+      }
+    }
+    response_rw.Finish(Status::OK, tag(1));
+    need_tags = (1 << 0) | (1 << 1);
+    while (need_tags) {
+      GPR_ASSERT(fixture->cq()->Next(&t, &ok));
+      int i = (int)(intptr_t)t;
+      GPR_ASSERT(need_tags & (1 << i));
+      need_tags &= ~(1 << i);
+    }
+  }
+  fixture->Finish(state);
+  fixture.reset();
+  state.SetBytesProcessed(kFileSize * state.iterations());
+}
+
+/*******************************************************************************
+ * CONFIGURATIONS
+ */
+
+static void ChunkSizes(benchmark::internal::Benchmark* b) {
+  b->Arg(64 * 1024)->Arg(1024 * 1024)->Arg(16 * 1024 * 1024);
+}
+
+BENCHMARK_TEMPLATE(BM_PumpFileServerToClient, TCP, ReadChunk)
+    ->Apply(ChunkSizes);
+BENCHMARK_TEMPLATE(BM_PumpFileServerToClient, TCP, MapChunk)
+    ->Apply(ChunkSizes);
+BENCHMARK_TEMPLATE(BM_PumpFileServerToClient, UDS, ReadChunk)
+    ->Apply(ChunkSizes);
+BENCHMARK_TEMPLATE(BM_PumpFileServerToClient, UDS, MapChunk)
+    ->Apply(ChunkSizes);
+BENCHMARK_TEMPLATE(BM_PumpFileServerToClient, SockPair, ReadChunk)
+    ->Apply(ChunkSizes);
+BENCHMARK_TEMPLATE(BM_PumpFileServerToClient, SockPair, MapChunk)
+    ->Apply(ChunkSizes);
+
+}  // namespace testing
+}  // namespace grpc
+
+BENCHMARK_MAIN();
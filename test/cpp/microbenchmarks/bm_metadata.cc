@@ -20,6 +20,7 @@
 
 #include <benchmark/benchmark.h>
 #include <grpc/grpc.h>
+#include <grpc/support/useful.h>
 
 extern "C" {
 #include "src/core/lib/transport/metadata.h"
@@ -299,4 +300,66 @@ static void BM_MetadataRefUnrefStatic(benchmark::State& state) {
 }
 BENCHMARK(BM_MetadataRefUnrefStatic);
 
+/* Header keys and values as a parser sees them: not yet interned, but already
+   present in the intern tables because other calls hold them */
+static const char* kHeaderStrings[] = {
+    "user-agent", "grpc-c++/1.7.0-dev grpc-c/4.0.0-dev (linux; chttp2)",
+    "x-request-id", "7f4ac1d2-3e1b-4b0a-9c5e-2d8f6a1b0c3e",
+    "x-tenant", "a-fairly-typical-tenant-name",
+    "authority-override", "backend.internal.example.com:443"};
+#define NUM_HEADER_STRINGS GPR_ARRAY_SIZE(kHeaderStrings)
+
+/* Every thread interns the same strings, as the chttp2 parsers of many
+   connections do */
+static void BM_SliceInternContended(benchmark::State& state) {
+  TrackCounters track_counters;
+  grpc_slice held[NUM_HEADER_STRINGS];
+  grpc_slice uninterned[NUM_HEADER_STRINGS];
+  for (size_t i = 0; i < NUM_HEADER_STRINGS; i++) {
+    uninterned[i] = grpc_slice_from_static_string(kHeaderStrings[i]);
+    held[i] = grpc_slice_intern(uninterned[i]);
+  }
+  size_t i = 0;
+  while (state.KeepRunning()) {
+    grpc_slice_unref(grpc_slice_intern(uninterned[i]));
+    if (++i == NUM_HEADER_STRINGS) i = 0;
+  }
+  for (size_t j = 0; j < NUM_HEADER_STRINGS; j++) {
+    grpc_slice_unref(held[j]);
+  }
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_SliceInternContended)->ThreadRange(1, 16)->UseRealTime();
+
+static void BM_MetadataFromInternedSlicesContended(benchmark::State& state) {
+  TrackCounters track_counters;
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  grpc_slice keys[NUM_HEADER_STRINGS / 2];
+  grpc_slice values[NUM_HEADER_STRINGS / 2];
+  grpc_mdelem held[NUM_HEADER_STRINGS / 2];
+  for (size_t i = 0; i < NUM_HEADER_STRINGS / 2; i++) {
+    keys[i] = grpc_slice_intern(
+        grpc_slice_from_static_string(kHeaderStrings[2 * i]));
+    values[i] = grpc_slice_intern(
+        grpc_slice_from_static_string(kHeaderStrings[2 * i + 1]));
+    held[i] = grpc_mdelem_create(&exec_ctx, keys[i], values[i], NULL);
+  }
+  size_t i = 0;
+  while (state.KeepRunning()) {
+    GRPC_MDELEM_UNREF(&exec_ctx,
+                      grpc_mdelem_create(&exec_ctx, keys[i], values[i], NULL));
+    if (++i == NUM_HEADER_STRINGS / 2) i = 0;
+  }
+  for (size_t j = 0; j < NUM_HEADER_STRINGS / 2; j++) {
+    GRPC_MDELEM_UNREF(&exec_ctx, held[j]);
+    grpc_slice_unref(keys[j]);
+    grpc_slice_unref(values[j]);
+  }
+  grpc_exec_ctx_finish(&exec_ctx);
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_MetadataFromInternedSlicesContended)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+
 BENCHMARK_MAIN();
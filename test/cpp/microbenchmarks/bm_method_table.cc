@@ -0,0 +1,135 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Benchmark the server's registered method table */
+
+#include <string>
+#include <vector>
+
+#include <grpc/support/log.h>
+
+extern "C" {
+#include "src/core/lib/slice/slice_internal.h"
+#include "src/core/lib/surface/method_table.h"
+}
+#include "test/cpp/microbenchmarks/helpers.h"
+#include "third_party/benchmark/include/benchmark/benchmark.h"
+
+auto& force_library_initialization = Library::get();
+
+static const int kMethodsPerService = 10;
+
+// Paths of n methods, named as generated services name them
+static std::vector<std::string> MethodPaths(int n) {
+  std::vector<std::string> paths;
+  for (int i = 0; i < n; i++) {
+    paths.push_back("/grpc.testing.Service" +
+                    std::to_string(i / kMethodsPerService) + "/Method" +
+                    std::to_string(i % kMethodsPerService));
+  }
+  return paths;
+}
+
+static grpc_method_table* CreateTable(const std::vector<std::string>& paths) {
+  std::vector<grpc_method_table_entry> entries;
+  for (const std::string& path : paths) {
+    entries.push_back({path.c_str(), nullptr, 0, (void*)&path});
+  }
+  return grpc_method_table_create(entries.data(), entries.size());
+}
+
+static void DestroyTable(grpc_method_table* table) {
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  grpc_method_table_destroy(&exec_ctx, table);
+  grpc_exec_ctx_finish(&exec_ctx);
+}
+
+// Interned, as incoming :path and :authority usually are
+static std::vector<grpc_slice> InternedSlices(
+    const std::vector<std::string>& strs) {
+  std::vector<grpc_slice> slices;
+  for (const std::string& s : strs) {
+    slices.push_back(
+        grpc_slice_intern(grpc_slice_from_static_string(s.c_str())));
+  }
+  return slices;
+}
+
+static void UnrefSlices(const std::vector<grpc_slice>& slices) {
+  for (grpc_slice slice : slices) {
+    grpc_slice_unref(slice);
+  }
+}
+
+// Building the table: once per server start
+static void BM_MethodTableCreate(benchmark::State& state) {
+  TrackCounters track_counters;
+  std::vector<std::string> paths = MethodPaths(state.range(0));
+  while (state.KeepRunning()) {
+    DestroyTable(CreateTable(paths));
+  }
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_MethodTableCreate)->RangeMultiplier(8)->Range(1, 4096);
+
+// Looking up a call's method: once per call
+static void BM_MethodTableLookup(benchmark::State& state) {
+  TrackCounters track_counters;
+  std::vector<std::string> paths = MethodPaths(state.range(0));
+  grpc_method_table* table = CreateTable(paths);
+  std::vector<grpc_slice> path_slices = InternedSlices(paths);
+  grpc_slice host = grpc_slice_intern(grpc_slice_from_static_string("host"));
+  size_t i = 0;
+  while (state.KeepRunning()) {
+    GPR_ASSERT(grpc_method_table_lookup(table, path_slices[i], host, 0) ==
+               &paths[i]);
+    if (++i == path_slices.size()) i = 0;
+  }
+  grpc_slice_unref(host);
+  UnrefSlices(path_slices);
+  DestroyTable(table);
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_MethodTableLookup)->RangeMultiplier(8)->Range(1, 4096);
+
+// Looking up a method that was not registered, so the call goes to the
+// generic service
+static void BM_MethodTableLookupMiss(benchmark::State& state) {
+  TrackCounters track_counters;
+  std::vector<std::string> paths = MethodPaths(state.range(0));
+  grpc_method_table* table = CreateTable(paths);
+  std::vector<std::string> unregistered;
+  for (const std::string& path : paths) {
+    unregistered.push_back(path + "Unregistered");
+  }
+  std::vector<grpc_slice> path_slices = InternedSlices(unregistered);
+  grpc_slice host = grpc_slice_intern(grpc_slice_from_static_string("host"));
+  size_t i = 0;
+  while (state.KeepRunning()) {
+    GPR_ASSERT(grpc_method_table_lookup(table, path_slices[i], host, 0) ==
+               nullptr);
+    if (++i == path_slices.size()) i = 0;
+  }
+  grpc_slice_unref(host);
+  UnrefSlices(path_slices);
+  DestroyTable(table);
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_MethodTableLookupMiss)->RangeMultiplier(8)->Range(1, 4096);
+
+BENCHMARK_MAIN();
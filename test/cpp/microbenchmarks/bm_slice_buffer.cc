@@ -0,0 +1,107 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Slice buffer churn: the push/pop patterns of the transport read and write
+   paths */
+
+#include <benchmark/benchmark.h>
+#include <grpc/grpc.h>
+#include <grpc/slice_buffer.h>
+
+#include "test/cpp/microbenchmarks/helpers.h"
+
+auto& force_library_initialization = Library::get();
+
+/* Keep range(0) slices queued; every iteration takes one from the front and
+   adds one to the back, like a stream of frames passing through a buffer */
+static void BM_SliceBufferFifo(benchmark::State& state) {
+  TrackCounters track_counters;
+  grpc_slice slice = grpc_slice_malloc(1024);
+  grpc_slice_buffer sb;
+  grpc_slice_buffer_init(&sb);
+  for (int i = 0; i < state.range(0); i++) {
+    grpc_slice_buffer_add_indexed(&sb, grpc_slice_ref(slice));
+  }
+  while (state.KeepRunning()) {
+    grpc_slice_unref(grpc_slice_buffer_take_first(&sb));
+    grpc_slice_buffer_add_indexed(&sb, grpc_slice_ref(slice));
+  }
+  grpc_slice_buffer_destroy(&sb);
+  grpc_slice_unref(slice);
+  track_counters.Finish(state);
+}
+/* 8, 135 and 1021 slices exactly fill the array as it grows: the worst case
+   for reclaiming the space consumed from the front */
+BENCHMARK(BM_SliceBufferFifo)
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(64)
+    ->Arg(135)
+    ->Arg(1000)
+    ->Arg(1021);
+
+/* Parse range(0) byte frame headers out of a buffer of 1KB slices, as the
+   chttp2 reader does: each header splits a slice and puts the rest back */
+static void BM_SliceBufferMoveFirst(benchmark::State& state) {
+  TrackCounters track_counters;
+  const size_t n = (size_t)state.range(0);
+  grpc_slice slice = grpc_slice_malloc(1024);
+  grpc_slice_buffer src;
+  grpc_slice_buffer dst;
+  grpc_slice_buffer_init(&src);
+  grpc_slice_buffer_init(&dst);
+  while (state.KeepRunning()) {
+    while (src.length < 64 * 1024) {
+      grpc_slice_buffer_add_indexed(&src, grpc_slice_ref(slice));
+    }
+    grpc_slice_buffer_move_first(&src, n, &dst);
+    grpc_slice_buffer_reset_and_unref(&dst);
+  }
+  grpc_slice_buffer_destroy(&src);
+  grpc_slice_buffer_destroy(&dst);
+  grpc_slice_unref(slice);
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_SliceBufferMoveFirst)->Arg(9)->Arg(100)->Arg(5000);
+
+/* Stream a range(0) slice message through a buffer, reading it back out a
+   slice at a time while it is still being written: the buffer never fully
+   drains until the end */
+static void BM_SliceBufferStream(benchmark::State& state) {
+  TrackCounters track_counters;
+  const int n = (int)state.range(0);
+  grpc_slice slice = grpc_slice_malloc(1024);
+  grpc_slice_buffer sb;
+  grpc_slice_buffer_init(&sb);
+  while (state.KeepRunning()) {
+    for (int i = 0; i < n; i++) {
+      grpc_slice_buffer_add_indexed(&sb, grpc_slice_ref(slice));
+      grpc_slice_buffer_add_indexed(&sb, grpc_slice_ref(slice));
+      grpc_slice_unref(grpc_slice_buffer_take_first(&sb));
+    }
+    grpc_slice_buffer_reset_and_unref(&sb);
+  }
+  grpc_slice_buffer_destroy(&sb);
+  grpc_slice_unref(slice);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_SliceBufferStream)->Range(8, 8192);
+
+BENCHMARK_MAIN();
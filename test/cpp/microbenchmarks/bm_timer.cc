@@ -0,0 +1,146 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Compare the timer implementations under a cancel-heavy workload: most
+   timers (like most call deadlines) are cancelled well before they fire */
+
+#include <benchmark/benchmark.h>
+#include <grpc/grpc.h>
+#include <vector>
+
+extern "C" {
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/iomgr/port.h"
+#include "src/core/lib/iomgr/timer.h"
+#include "src/core/lib/iomgr/timer_manager.h"
+}
+
+#include "test/cpp/microbenchmarks/helpers.h"
+
+auto& force_library_initialization = Library::get();
+
+#ifdef GRPC_TIMER_USE_GENERIC
+
+static void DoNothing(grpc_exec_ctx* exec_ctx, void* arg, grpc_error* error) {}
+
+/* Swaps the process wide timer list for a fresh one of the given
+   implementation, with the timer threads stopped so that only the benchmark
+   drives it */
+class ScopedTimerImpl {
+ public:
+  explicit ScopedTimerImpl(const grpc_timer_vtable* impl) {
+    grpc_timer_manager_set_threading(false);
+    grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+    grpc_timer_list_shutdown(&exec_ctx);
+    grpc_exec_ctx_finish(&exec_ctx);
+    grpc_timer_set_impl(impl);
+    grpc_timer_list_init(gpr_now(GPR_CLOCK_MONOTONIC));
+  }
+  ~ScopedTimerImpl() { grpc_timer_manager_set_threading(true); }
+};
+
+struct Timer {
+  grpc_timer timer;
+  grpc_closure closure;
+};
+
+/* Deadlines between 1 and spread_ms milliseconds out */
+static gpr_timespec Deadline(gpr_timespec start, uint32_t* rnd,
+                             int64_t spread_ms) {
+  *rnd = *rnd * 1103515245 + 12345;
+  return gpr_time_add(
+      start, gpr_time_from_millis(1 + (*rnd >> 8) % spread_ms, GPR_TIMESPAN));
+}
+
+/* range(0) timers outstanding, deadlines spread over range(1) ms */
+static void TimerArgs(benchmark::internal::Benchmark* b) {
+  for (int n = 64; n <= 65536; n *= 32) {
+    b->Args({n, 100});
+    b->Args({n, 60000});
+  }
+}
+
+/* Keep range(0) timers armed; every iteration cancels one and re-arms it */
+template <const grpc_timer_vtable* kImpl>
+static void BM_TimerCancelRearm(benchmark::State& state) {
+  TrackCounters track_counters;
+  ScopedTimerImpl impl(kImpl);
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  const size_t n = (size_t)state.range(0);
+  std::vector<Timer> timers(n);
+  uint32_t rnd = 1;
+  gpr_timespec start = gpr_now(GPR_CLOCK_MONOTONIC);
+  for (size_t i = 0; i < n; i++) {
+    GRPC_CLOSURE_INIT(&timers[i].closure, DoNothing, NULL,
+                      grpc_schedule_on_exec_ctx);
+    grpc_timer_init(&exec_ctx, &timers[i].timer,
+                    Deadline(start, &rnd, state.range(1)), &timers[i].closure,
+                    start);
+  }
+  size_t i = 0;
+  while (state.KeepRunning()) {
+    Timer* t = &timers[i];
+    grpc_timer_cancel(&exec_ctx, &t->timer);
+    grpc_exec_ctx_flush(&exec_ctx);
+    grpc_timer_init(&exec_ctx, &t->timer, Deadline(start, &rnd, state.range(1)),
+                    &t->closure, start);
+    if (++i == n) i = 0;
+  }
+  for (auto& t : timers) grpc_timer_cancel(&exec_ctx, &t.timer);
+  grpc_exec_ctx_finish(&exec_ctx);
+  track_counters.Finish(state);
+}
+BENCHMARK_TEMPLATE(BM_TimerCancelRearm, &grpc_timer_heap_vtable)
+    ->Apply(TimerArgs);
+BENCHMARK_TEMPLATE(BM_TimerCancelRearm, &grpc_timer_wheel_vtable)
+    ->Apply(TimerArgs);
+
+/* Arm range(0) timers, run the timer check once, then cancel them all */
+template <const grpc_timer_vtable* kImpl>
+static void BM_TimerAddCheckCancel(benchmark::State& state) {
+  TrackCounters track_counters;
+  ScopedTimerImpl impl(kImpl);
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  const size_t n = (size_t)state.range(0);
+  std::vector<Timer> timers(n);
+  for (auto& t : timers) {
+    GRPC_CLOSURE_INIT(&t.closure, DoNothing, NULL, grpc_schedule_on_exec_ctx);
+  }
+  uint32_t rnd = 1;
+  while (state.KeepRunning()) {
+    gpr_timespec start = gpr_now(GPR_CLOCK_MONOTONIC);
+    for (auto& t : timers) {
+      grpc_timer_init(&exec_ctx, &t.timer,
+                      Deadline(start, &rnd, state.range(1)), &t.closure, start);
+    }
+    grpc_timer_check(&exec_ctx, gpr_now(GPR_CLOCK_MONOTONIC), NULL);
+    for (auto& t : timers) grpc_timer_cancel(&exec_ctx, &t.timer);
+    grpc_exec_ctx_flush(&exec_ctx);
+  }
+  grpc_exec_ctx_finish(&exec_ctx);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  track_counters.Finish(state);
+}
+BENCHMARK_TEMPLATE(BM_TimerAddCheckCancel, &grpc_timer_heap_vtable)
+    ->Apply(TimerArgs);
+BENCHMARK_TEMPLATE(BM_TimerAddCheckCancel, &grpc_timer_wheel_vtable)
+    ->Apply(TimerArgs);
+
+#endif /* GRPC_TIMER_USE_GENERIC */
+
+BENCHMARK_MAIN();
@@ -300,6 +300,53 @@ typedef MinStackize<InProcess> MinInProcess;
 typedef MinStackize<SockPair> MinSockPair;
 typedef MinStackize<InProcessCHTTP2> MinInProcessCHTTP2;
 
+////////////////////////////////////////////////////////////////////////////////
+// MSG_ZEROCOPY fixtures
+
+class ZeroCopyConfiguration : public FixtureConfiguration {
+  void ApplyCommonChannelArguments(ChannelArguments* a) const override {
+    a->SetInt(GRPC_ARG_TCP_TX_ZEROCOPY_ENABLED, 1);
+    FixtureConfiguration::ApplyCommonChannelArguments(a);
+  }
+
+  void ApplyCommonServerBuilderConfig(ServerBuilder* b) const override {
+    b->AddChannelArgument(GRPC_ARG_TCP_TX_ZEROCOPY_ENABLED, 1);
+    FixtureConfiguration::ApplyCommonServerBuilderConfig(b);
+  }
+};
+
+template <class Base>
+class ZeroCopyize : public Base {
+ public:
+  ZeroCopyize(Service* service) : Base(service, ZeroCopyConfiguration()) {}
+};
+
+typedef ZeroCopyize<TCP> ZeroCopyTCP;
+
+////////////////////////////////////////////////////////////////////////////////
+// Busy polling fixtures
+
+class BusyPollConfiguration : public FixtureConfiguration {
+  void ApplyCommonChannelArguments(ChannelArguments* a) const override {
+    a->SetInt(GRPC_ARG_BUSY_POLL_US, 100);
+    FixtureConfiguration::ApplyCommonChannelArguments(a);
+  }
+
+  void ApplyCommonServerBuilderConfig(ServerBuilder* b) const override {
+    b->AddChannelArgument(GRPC_ARG_BUSY_POLL_US, 100);
+    FixtureConfiguration::ApplyCommonServerBuilderConfig(b);
+  }
+};
+
+template <class Base>
+class BusyPollize : public Base {
+ public:
+  BusyPollize(Service* service) : Base(service, BusyPollConfiguration()) {}
+};
+
+typedef BusyPollize<TCP> BusyPollTCP;
+typedef BusyPollize<UDS> BusyPollUDS;
+
 }  // namespace testing
 }  // namespace grpc
 
@@ -73,6 +73,7 @@ static void BM_UnaryPingPong(benchmark::State& state) {
       EchoTestService::NewStub(fixture->channel()));
   while (state.KeepRunning()) {
     GPR_TIMER_SCOPE("BenchmarkCycle", 0);
+    gpr_timespec start = gpr_now(GPR_CLOCK_MONOTONIC);
     recv_response.Clear();
     ClientContext cli_ctx;
     ClientContextMutator cli_ctx_mut(&cli_ctx);
@@ -96,6 +97,7 @@ static void BM_UnaryPingPong(benchmark::State& state) {
       i -= 1 << tagnum;
     }
     GPR_ASSERT(recv_status.ok());
+    fixture->AddLatency(gpr_time_sub(gpr_now(GPR_CLOCK_MONOTONIC), start));
 
     senv->~ServerEnv();
     senv = new (senv) ServerEnv();
@@ -28,6 +28,11 @@ void TrackCounters::Finish(benchmark::State &state) {
   state.SetLabel(label.c_str());
 }
 
+void TrackCounters::AddLatency(gpr_timespec latency) {
+  if (latency_ == nullptr) latency_ = gpr_histogram_create(0.01, 60e6);
+  gpr_histogram_add(latency_, gpr_timespec_to_micros(latency));
+}
+
 void TrackCounters::AddToLabel(std::ostream &out, benchmark::State &state) {
   grpc_stats_data stats_end;
   grpc_stats_collect(&stats_end);
@@ -43,6 +48,11 @@ void TrackCounters::AddToLabel(std::ostream &out, benchmark::State &state) {
         << " " << grpc_stats_histogram_name[i] << "-99p:"
         << grpc_stats_histo_percentile(&stats, (grpc_stats_histograms)i, 99.0);
   }
+  if (latency_ != nullptr) {
+    out << " latency-median-us:" << gpr_histogram_percentile(latency_, 50.0)
+        << " latency-99p-us:" << gpr_histogram_percentile(latency_, 99.0)
+        << " latency-99.9p-us:" << gpr_histogram_percentile(latency_, 99.9);
+  }
 #ifdef GPR_LOW_LEVEL_COUNTERS
   grpc_memory_counters counters_at_end = grpc_memory_counters_snapshot();
   out << " locks/iter:" << ((double)(gpr_atm_no_barrier_load(&gpr_mu_locks) -
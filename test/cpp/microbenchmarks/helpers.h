@@ -21,6 +21,8 @@
 
 #include <sstream>
 
+#include <grpc/support/histogram.h>
+
 extern "C" {
 #include <grpc/support/port_platform.h>
 #include "src/core/lib/debug/stats.h"
@@ -64,11 +66,18 @@ extern "C" gpr_atm gpr_now_call_count;
 class TrackCounters {
  public:
   TrackCounters() { grpc_stats_collect(&stats_begin_); }
+  virtual ~TrackCounters() {
+    if (latency_ != nullptr) gpr_histogram_destroy(latency_);
+  }
   virtual void Finish(benchmark::State& state);
   virtual void AddToLabel(std::ostream& out, benchmark::State& state);
+  // Record how long one iteration took; latency percentiles are then
+  // reported alongside the counters
+  void AddLatency(gpr_timespec latency);
 
  private:
   grpc_stats_data stats_begin_;
+  gpr_histogram* latency_ = nullptr;
 #ifdef GPR_LOW_LEVEL_COUNTERS
   const size_t mu_locks_at_start_ = gpr_atm_no_barrier_load(&gpr_mu_locks);
   const size_t atm_cas_at_start_ =
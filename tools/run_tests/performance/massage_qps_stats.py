@@ -34,11 +34,19 @@ def massage_qps_stats(scenario_result):
     stats["core_pollset_kick_wakeup_fd"] = massage_qps_stats_helpers.counter(core_stats, "pollset_kick_wakeup_fd")
     stats["core_pollset_kick_wakeup_cv"] = massage_qps_stats_helpers.counter(core_stats, "pollset_kick_wakeup_cv")
     stats["core_pollset_kick_own_thread"] = massage_qps_stats_helpers.counter(core_stats, "pollset_kick_own_thread")
+    stats["core_cq_busy_poll_spins"] = massage_qps_stats_helpers.counter(core_stats, "cq_busy_poll_spins")
+    stats["core_cq_busy_poll_hits"] = massage_qps_stats_helpers.counter(core_stats, "cq_busy_poll_hits")
+    stats["core_cq_busy_poll_misses"] = massage_qps_stats_helpers.counter(core_stats, "cq_busy_poll_misses")
     stats["core_histogram_slow_lookups"] = massage_qps_stats_helpers.counter(core_stats, "histogram_slow_lookups")
     stats["core_syscall_write"] = massage_qps_stats_helpers.counter(core_stats, "syscall_write")
     stats["core_syscall_read"] = massage_qps_stats_helpers.counter(core_stats, "syscall_read")
     stats["core_tcp_backup_pollers_created"] = massage_qps_stats_helpers.counter(core_stats, "tcp_backup_pollers_created")
     stats["core_tcp_backup_poller_polls"] = massage_qps_stats_helpers.counter(core_stats, "tcp_backup_poller_polls")
+    stats["core_tcp_write_zerocopy"] = massage_qps_stats_helpers.counter(core_stats, "tcp_write_zerocopy")
+    stats["core_tcp_write_zerocopy_copied"] = massage_qps_stats_helpers.counter(core_stats, "tcp_write_zerocopy_copied")
+    stats["core_tcp_write_zerocopy_fallback"] = massage_qps_stats_helpers.counter(core_stats, "tcp_write_zerocopy_fallback")
+    stats["core_tcp_write_corked"] = massage_qps_stats_helpers.counter(core_stats, "tcp_write_corked")
+    stats["core_tcp_write_cork_timeouts"] = massage_qps_stats_helpers.counter(core_stats, "tcp_write_cork_timeouts")
     stats["core_http2_op_batches"] = massage_qps_stats_helpers.counter(core_stats, "http2_op_batches")
     stats["core_http2_op_cancel"] = massage_qps_stats_helpers.counter(core_stats, "http2_op_cancel")
     stats["core_http2_op_send_initial_metadata"] = massage_qps_stats_helpers.counter(core_stats, "http2_op_send_initial_metadata")
@@ -53,6 +61,7 @@ def massage_qps_stats(scenario_result):
     stats["core_http2_writes_offloaded"] = massage_qps_stats_helpers.counter(core_stats, "http2_writes_offloaded")
     stats["core_http2_writes_continued"] = massage_qps_stats_helpers.counter(core_stats, "http2_writes_continued")
     stats["core_http2_partial_writes"] = massage_qps_stats_helpers.counter(core_stats, "http2_partial_writes")
+    stats["core_http2_idle_memory_releases"] = massage_qps_stats_helpers.counter(core_stats, "http2_idle_memory_releases")
     stats["core_http2_initiate_write_due_to_initial_write"] = massage_qps_stats_helpers.counter(core_stats, "http2_initiate_write_due_to_initial_write")
     stats["core_http2_initiate_write_due_to_start_new_stream"] = massage_qps_stats_helpers.counter(core_stats, "http2_initiate_write_due_to_start_new_stream")
     stats["core_http2_initiate_write_due_to_send_message"] = massage_qps_stats_helpers.counter(core_stats, "http2_initiate_write_due_to_send_message")
@@ -96,6 +105,12 @@ def massage_qps_stats(scenario_result):
     stats["core_hpack_send_huffman"] = massage_qps_stats_helpers.counter(core_stats, "hpack_send_huffman")
     stats["core_hpack_send_binary"] = massage_qps_stats_helpers.counter(core_stats, "hpack_send_binary")
     stats["core_hpack_send_binary_base64"] = massage_qps_stats_helpers.counter(core_stats, "hpack_send_binary_base64")
+    stats["core_hpack_send_cached_block"] = massage_qps_stats_helpers.counter(core_stats, "hpack_send_cached_block")
+    stats["core_slice_pool_hits"] = massage_qps_stats_helpers.counter(core_stats, "slice_pool_hits")
+    stats["core_slice_pool_misses"] = massage_qps_stats_helpers.counter(core_stats, "slice_pool_misses")
+    stats["core_slice_pool_depot_puts"] = massage_qps_stats_helpers.counter(core_stats, "slice_pool_depot_puts")
+    stats["core_call_arena_pool_hits"] = massage_qps_stats_helpers.counter(core_stats, "call_arena_pool_hits")
+    stats["core_call_arena_pool_misses"] = massage_qps_stats_helpers.counter(core_stats, "call_arena_pool_misses")
     stats["core_combiner_locks_initiated"] = massage_qps_stats_helpers.counter(core_stats, "combiner_locks_initiated")
     stats["core_combiner_locks_scheduled_items"] = massage_qps_stats_helpers.counter(core_stats, "combiner_locks_scheduled_items")
     stats["core_combiner_locks_scheduled_final_items"] = massage_qps_stats_helpers.counter(core_stats, "combiner_locks_scheduled_final_items")
@@ -106,6 +121,7 @@ def massage_qps_stats(scenario_result):
     stats["core_executor_wakeup_initiated"] = massage_qps_stats_helpers.counter(core_stats, "executor_wakeup_initiated")
     stats["core_executor_queue_drained"] = massage_qps_stats_helpers.counter(core_stats, "executor_queue_drained")
     stats["core_executor_push_retries"] = massage_qps_stats_helpers.counter(core_stats, "executor_push_retries")
+    stats["core_executor_jobs_stolen"] = massage_qps_stats_helpers.counter(core_stats, "executor_jobs_stolen")
     stats["core_server_requested_calls"] = massage_qps_stats_helpers.counter(core_stats, "server_requested_calls")
     stats["core_server_slowpath_requests_queued"] = massage_qps_stats_helpers.counter(core_stats, "server_slowpath_requests_queued")
     h = massage_qps_stats_helpers.histogram(core_stats, "call_initial_size")
@@ -120,6 +136,18 @@ def massage_qps_stats(scenario_result):
     stats["core_poll_events_returned_50p"] = massage_qps_stats_helpers.percentile(h.buckets, 50, h.boundaries)
     stats["core_poll_events_returned_95p"] = massage_qps_stats_helpers.percentile(h.buckets, 95, h.boundaries)
     stats["core_poll_events_returned_99p"] = massage_qps_stats_helpers.percentile(h.buckets, 99, h.boundaries)
+    h = massage_qps_stats_helpers.histogram(core_stats, "cq_busy_poll_spin_us")
+    stats["core_cq_busy_poll_spin_us"] = ",".join("%f" % x for x in h.buckets)
+    stats["core_cq_busy_poll_spin_us_bkts"] = ",".join("%f" % x for x in h.boundaries)
+    stats["core_cq_busy_poll_spin_us_50p"] = massage_qps_stats_helpers.percentile(h.buckets, 50, h.boundaries)
+    stats["core_cq_busy_poll_spin_us_95p"] = massage_qps_stats_helpers.percentile(h.buckets, 95, h.boundaries)
+    stats["core_cq_busy_poll_spin_us_99p"] = massage_qps_stats_helpers.percentile(h.buckets, 99, h.boundaries)
+    h = massage_qps_stats_helpers.histogram(core_stats, "cq_busy_poll_work_us")
+    stats["core_cq_busy_poll_work_us"] = ",".join("%f" % x for x in h.buckets)
+    stats["core_cq_busy_poll_work_us_bkts"] = ",".join("%f" % x for x in h.boundaries)
+    stats["core_cq_busy_poll_work_us_50p"] = massage_qps_stats_helpers.percentile(h.buckets, 50, h.boundaries)
+    stats["core_cq_busy_poll_work_us_95p"] = massage_qps_stats_helpers.percentile(h.buckets, 95, h.boundaries)
+    stats["core_cq_busy_poll_work_us_99p"] = massage_qps_stats_helpers.percentile(h.buckets, 99, h.boundaries)
     h = massage_qps_stats_helpers.histogram(core_stats, "tcp_write_size")
     stats["core_tcp_write_size"] = ",".join("%f" % x for x in h.buckets)
     stats["core_tcp_write_size_bkts"] = ",".join("%f" % x for x in h.boundaries)
@@ -20,6 +20,7 @@ from __future__ import print_function
 import argparse
 import ast
 import collections
+import ctypes
 import glob
 import itertools
 import json
@@ -63,7 +64,7 @@ _FORCE_ENVIRON_FOR_WRAPPERS = {
 }
 
 _POLLING_STRATEGIES = {
-  'linux': ['epollsig', 'epoll1', 'poll', 'poll-cv'],
+  'linux': ['epollsig', 'epoll1', 'poll', 'poll-cv', 'uring'],
 # TODO(ctiller, sreecha): enable epollex, epoll-thread-pool
   'mac': ['poll'],
 }
@@ -1554,6 +1555,23 @@ def _has_epollexclusive():
     return False
 
 
+def _has_io_uring():
+  # The uring engine needs multishot polls (linux 5.13), and io_uring may be
+  # compiled out or blocked by a seccomp filter
+  m = re.match(r'(\d+)\.(\d+)', platform.release())
+  if not m or (int(m.group(1)), int(m.group(2))) < (5, 13):
+    return False
+  try:
+    params = ctypes.create_string_buffer(120)  # struct io_uring_params
+    fd = ctypes.CDLL(None).syscall(425, 1, params)  # __NR_io_uring_setup
+  except (OSError, AttributeError):
+    return False
+  if fd < 0:
+    return False
+  os.close(fd)
+  return True
+
+
 # returns a list of things that failed (or an empty list on success)
 def _build_and_run(
     check_cancelled, newline_on_success, xml_report=None, build_only=False):
@@ -1575,6 +1593,10 @@ def _build_and_run(
     print('\n\nOmitting EPOLLEXCLUSIVE tests\n\n')
     _POLLING_STRATEGIES[platform_string()].remove('epollex')
 
+  if platform_string() in _POLLING_STRATEGIES and 'uring' in _POLLING_STRATEGIES[platform_string()] and not _has_io_uring():
+    print('\n\nOmitting io_uring tests\n\n')
+    _POLLING_STRATEGIES[platform_string()].remove('uring')
+
   # start antagonists
   antagonists = [subprocess.Popen(['tools/run_tests/python_utils/antagonist.py'])
                  for _ in range(0, args.antagonists)]